@@ -24,6 +24,13 @@ class OpContext;
 }  // namespace deepx_core
 
 namespace embedx {
+namespace ann {
+
+class HnswIndex;
+
+}  // namespace ann
+
+class QuantizedModel;
 
 using deepx_core::Graph;
 using deepx_core::Model;
@@ -32,6 +39,8 @@ using deepx_core::OpContext;
 using feature_t = std::pair<uint64_t, float>;
 using features_t = std::vector<feature_t>;
 using embedding_t = std::vector<float>;
+using scored_item_t = std::pair<uint64_t, float>;
+using scored_items_t = std::vector<scored_item_t>;
 
 class ModelServer {
  private:
@@ -42,6 +51,10 @@ class ModelServer {
   // 2 for user embedding
   // 3 for item embedding
   int target_type_ = 2;
+  std::unique_ptr<ann::HnswIndex> ann_index_;
+  int ann_ef_ = 64;
+  // int8 params of a quantized model file, see LoadModel
+  std::unique_ptr<QuantizedModel> quantized_model_;
 
  public:
   ModelServer();
@@ -51,11 +64,13 @@ class ModelServer {
 
  public:
   void set_target_type(int target_type) noexcept { target_type_ = target_type; }
+  void set_ann_ef(int ann_ef) noexcept { ann_ef_ = ann_ef; }
 
  public:
   bool Load(const std::string& file);
   bool LoadGraph(const std::string& file);
   bool LoadModel(const std::string& file);
+  bool LoadAnnIndex(const std::string& file);
 
  public:
   bool Predict(const features_t& features, float* prob) const;
@@ -72,6 +87,10 @@ class ModelServer {
   bool BatchGraphDeepFMPredict(const std::vector<features_t>& batch_features,
                                const std::vector<features_t>& batch_users,
                                std::vector<float>* batch_prob) const;
+  bool SearchItems(const embedding_t& embedding, int k,
+                   scored_items_t* items) const;
+  bool BatchRetrieve(const std::vector<features_t>& batch_user_features, int k,
+                     std::vector<scored_items_t>* batch_items) const;
 
  public:
   std::unique_ptr<OpContext, void (*)(OpContext*)> NewOpContext() const;
@@ -95,6 +114,12 @@ class ModelServer {
                                const std::vector<features_t>& batch_features,
                                const std::vector<features_t>& batch_users,
                                std::vector<float>* batch_prob) const;
+  bool BatchRetrieve(OpContext* op_context,
+                     const std::vector<features_t>& batch_user_features, int k,
+                     std::vector<scored_items_t>* batch_items) const;
+
+ private:
+  void Forward(OpContext* op_context) const;
 };
 
 }  // namespace embedx
@@ -0,0 +1,114 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#if defined(__AVX__) || defined(__SSE__)
+#include <immintrin.h>
+#endif
+
+namespace embedx {
+namespace ann {
+
+enum class MetricEnum : int {
+  INNER_PRODUCT = 0,  // the larger the dot product, the closer
+  L2 = 1,             // the smaller the squared euclidean distance, the closer
+};
+
+/************************************************************************/
+/* Kernels */
+/************************************************************************/
+#if defined(__AVX__)
+inline float HorizontalSum(__m256 v) noexcept {
+  __m128 lo = _mm256_castps256_ps128(v);
+  __m128 hi = _mm256_extractf128_ps(v, 1);
+  lo = _mm_add_ps(lo, hi);
+  lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+  lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x55));
+  return _mm_cvtss_f32(lo);
+}
+#elif defined(__SSE__)
+inline float HorizontalSum(__m128 v) noexcept {
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 0x55));
+  return _mm_cvtss_f32(v);
+}
+#endif
+
+inline float Dot(int n, const float* x, const float* y) noexcept {
+  int i = 0;
+  float sum = 0;
+#if defined(__AVX__)
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm256_add_ps(
+        acc0, _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(x + i + 8),
+                                             _mm256_loadu_ps(y + i + 8)));
+  }
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_add_ps(
+        acc0, _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+  }
+  sum = HorizontalSum(_mm256_add_ps(acc0, acc1));
+#elif defined(__SSE__)
+  __m128 acc = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4) {
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+  }
+  sum = HorizontalSum(acc);
+#endif
+  for (; i < n; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+inline float L2Sqr(int n, const float* x, const float* y) noexcept {
+  int i = 0;
+  float sum = 0;
+#if defined(__AVX__)
+  __m256 acc = _mm256_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    __m256 d = _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i));
+    acc = _mm256_add_ps(acc, _mm256_mul_ps(d, d));
+  }
+  sum = HorizontalSum(acc);
+#elif defined(__SSE__)
+  __m128 acc = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4) {
+    __m128 d = _mm_sub_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i));
+    acc = _mm_add_ps(acc, _mm_mul_ps(d, d));
+  }
+  sum = HorizontalSum(acc);
+#endif
+  for (; i < n; ++i) {
+    float d = x[i] - y[i];
+    sum += d * d;
+  }
+  return sum;
+}
+
+// Distance of 'metric', the smaller the closer.
+inline float Distance(MetricEnum metric, int n, const float* x,
+                      const float* y) noexcept {
+  return metric == MetricEnum::INNER_PRODUCT ? -Dot(n, x, y)
+                                             : L2Sqr(n, x, y);
+}
+
+// Score reported to users, the dot product for INNER_PRODUCT and the squared
+// distance for L2.
+inline float DistanceToScore(MetricEnum metric, float distance) noexcept {
+  return metric == MetricEnum::INNER_PRODUCT ? -distance : distance;
+}
+
+}  // namespace ann
+}  // namespace embedx
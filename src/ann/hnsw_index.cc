@@ -0,0 +1,682 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/ann/hnsw_index.h"
+
+#include <deepx_core/common/stream.h>
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::fill, std::min, std::partial_sort, std::sort
+#include <atomic>
+#include <cmath>    // std::log
+#include <cstring>  // std::memcpy
+#include <functional>  // std::greater
+#include <queue>
+#include <thread>
+
+#include "src/common/random.h"
+#include "src/io/embedding_file.h"
+#include "src/io/io_util.h"
+
+namespace embedx {
+namespace ann {
+namespace {
+
+constexpr uint64_t MAGIC = 0x31574e48584445ULL;  // "EDXHNW1"
+constexpr uint32_t VERSION = 1;
+constexpr int MAX_LEVEL = 16;
+
+size_t Align8(size_t size) noexcept { return (size + 7) / 8 * 8; }
+
+}  // namespace
+
+/************************************************************************/
+/* Layout */
+/************************************************************************/
+struct HnswIndex::Header {
+  uint64_t magic;
+  uint32_t version;
+  int32_t dim;
+  uint64_t size;
+  int32_t m;
+  int32_t metric;
+  int32_t max_level;
+  uint32_t entry_point;
+  uint64_t upper_link_size;
+  uint64_t reserved[2];
+};
+
+namespace {
+
+// byte offsets of the sections, all 8 bytes aligned
+struct Layout {
+  size_t ids;
+  size_t vectors;
+  size_t levels;
+  size_t links0;
+  size_t upper_offsets;
+  size_t upper_links;
+  size_t total;
+};
+
+template <class Header>
+Layout GetLayout(const Header& header) noexcept {
+  Layout layout;
+  size_t pos = sizeof(Header);
+  layout.ids = pos;
+  pos += Align8(header.size * sizeof(int_t));
+  layout.vectors = pos;
+  pos += Align8(header.size * header.dim * sizeof(float));
+  layout.levels = pos;
+  pos += Align8(header.size * sizeof(int32_t));
+  layout.links0 = pos;
+  pos += Align8(header.size * (1 + 2 * header.m) * sizeof(uint32_t));
+  layout.upper_offsets = pos;
+  pos += (header.size + 1) * sizeof(uint64_t);
+  layout.upper_links = pos;
+  pos += Align8(header.upper_link_size * sizeof(uint32_t));
+  layout.total = pos;
+  return layout;
+}
+
+}  // namespace
+
+/************************************************************************/
+/* VisitedList */
+/************************************************************************/
+// VisitedList marks visited nodes, Reset() is O(1) most of the time.
+class HnswIndex::VisitedList {
+ private:
+  std::vector<uint16_t> marks_;
+  uint16_t tag_ = 0;
+
+ public:
+  explicit VisitedList(size_t size) : marks_(size, 0) {}
+
+  void Reset() noexcept {
+    if (++tag_ == 0) {
+      std::fill(marks_.begin(), marks_.end(), 0);
+      tag_ = 1;
+    }
+  }
+
+  // Returns false if 'node' is visited.
+  bool Visit(uint32_t node) noexcept {
+    if (marks_[node] == tag_) {
+      return false;
+    }
+    marks_[node] = tag_;
+    return true;
+  }
+};
+
+HnswIndex::VisitedList* HnswIndex::GetVisitedList() const {
+  std::lock_guard<std::mutex> guard(visited_mtx_);
+  if (visited_pool_.empty()) {
+    return new VisitedList(size());
+  }
+  VisitedList* visited = visited_pool_.back().release();
+  visited_pool_.pop_back();
+  return visited;
+}
+
+void HnswIndex::ReleaseVisitedList(VisitedList* visited) const {
+  std::lock_guard<std::mutex> guard(visited_mtx_);
+  visited_pool_.emplace_back(visited);
+}
+
+/************************************************************************/
+/* Search */
+/************************************************************************/
+struct HnswIndex::ReadLinks {
+  const HnswIndex* index;
+
+  template <class Func>
+  void operator()(uint32_t node, int level, Func&& func) const {
+    const uint32_t* links = index->Links(node, level);
+    for (uint32_t i = 1; i <= links[0]; ++i) {
+      func(links[i]);
+    }
+  }
+};
+
+HnswIndex::~HnswIndex() = default;
+
+size_t HnswIndex::size() const noexcept { return (size_t)header_->size; }
+
+int HnswIndex::dim() const noexcept { return header_->dim; }
+
+MetricEnum HnswIndex::metric() const noexcept {
+  return (MetricEnum)header_->metric;
+}
+
+const uint32_t* HnswIndex::Links(uint32_t node, int level) const noexcept {
+  if (level == 0) {
+    return links0_ + (size_t)node * (1 + 2 * header_->m);
+  }
+  return upper_links_ + upper_offsets_[node] +
+         (size_t)(level - 1) * (1 + header_->m);
+}
+
+template <class ForEachLink>
+uint32_t HnswIndex::Descend(const float* query, uint32_t entry, int from_level,
+                            int to_level,
+                            const ForEachLink& for_each_link) const {
+  float dist = NodeDistance(query, entry);
+  for (int level = from_level; level > to_level; --level) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for_each_link(entry, level, [&](uint32_t next) {
+        float next_dist = NodeDistance(query, next);
+        if (next_dist < dist) {
+          dist = next_dist;
+          entry = next;
+          changed = true;
+        }
+      });
+    }
+  }
+  return entry;
+}
+
+template <class ForEachLink>
+void HnswIndex::SearchLayer(const float* query, uint32_t entry, int ef,
+                            int level, VisitedList* visited,
+                            const ForEachLink& for_each_link,
+                            std::vector<dist_node_t>* results) const {
+  // closest first
+  std::priority_queue<dist_node_t, std::vector<dist_node_t>,
+                      std::greater<dist_node_t>>
+      candidates;
+  // farthest first
+  std::priority_queue<dist_node_t> top;
+
+  visited->Reset();
+  visited->Visit(entry);
+  float dist = NodeDistance(query, entry);
+  candidates.emplace(dist, entry);
+  top.emplace(dist, entry);
+
+  while (!candidates.empty()) {
+    dist_node_t cur = candidates.top();
+    if (cur.first > top.top().first && (int)top.size() >= ef) {
+      break;
+    }
+    candidates.pop();
+
+    for_each_link(cur.second, level, [&](uint32_t next) {
+      if (!visited->Visit(next)) {
+        return;
+      }
+      float next_dist = NodeDistance(query, next);
+      if ((int)top.size() < ef || next_dist < top.top().first) {
+        candidates.emplace(next_dist, next);
+        top.emplace(next_dist, next);
+        if ((int)top.size() > ef) {
+          top.pop();
+        }
+      }
+    });
+  }
+
+  results->resize(top.size());
+  for (size_t i = top.size(); i > 0; --i) {
+    (*results)[i - 1] = top.top();
+    top.pop();
+  }
+}
+
+void HnswIndex::Search(const float* query, int k, int ef,
+                       std::vector<scored_node_t>* nodes) const {
+  nodes->clear();
+  if (size() == 0 || k <= 0) {
+    return;
+  }
+
+  ReadLinks read_links{this};
+  uint32_t entry =
+      Descend(query, header_->entry_point, header_->max_level, 0, read_links);
+
+  std::vector<dist_node_t> results;
+  VisitedList* visited = GetVisitedList();
+  SearchLayer(query, entry, std::max(ef, k), 0, visited, read_links, &results);
+  ReleaseVisitedList(visited);
+
+  int n = std::min(k, (int)results.size());
+  nodes->reserve(n);
+  for (int i = 0; i < n; ++i) {
+    nodes->emplace_back(ids_[results[i].second],
+                        DistanceToScore(metric(), results[i].first));
+  }
+}
+
+/************************************************************************/
+/* Build */
+/************************************************************************/
+// HnswBuilder inserts nodes concurrently, the links of a node are guarded by
+// its lock and the entry point by the global lock.
+class HnswBuilder {
+ private:
+  using dist_node_t = HnswIndex::dist_node_t;
+  using VisitedList = HnswIndex::VisitedList;
+
+  struct LockedReadLinks {
+    HnswBuilder* builder;
+
+    template <class Func>
+    void operator()(uint32_t node, int level, Func&& func) const {
+      std::lock_guard<std::mutex> guard(builder->locks_[node]);
+      const uint32_t* links = builder->index_->Links(node, level);
+      for (uint32_t i = 1; i <= links[0]; ++i) {
+        func(links[i]);
+      }
+    }
+  };
+
+  HnswIndex* index_;
+  HnswParam param_;
+  std::vector<std::mutex> locks_;
+  std::mutex global_mtx_;
+  int max_level_;
+  uint32_t entry_point_;
+
+ public:
+  HnswBuilder(HnswIndex* index, const HnswParam& param)
+      : index_(index),
+        param_(param),
+        locks_(index->size()),
+        max_level_(index->header_->max_level),
+        entry_point_(index->header_->entry_point) {}
+
+  void Run(int thread_num) {
+    std::atomic<size_t> next{1};
+    auto insert_func = [this, &next]() {
+      VisitedList visited(index_->size());
+      for (size_t node = next++; node < index_->size(); node = next++) {
+        Insert((uint32_t)node, &visited);
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_num; ++i) {
+      threads.emplace_back(insert_func);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    auto* header = const_cast<HnswIndex::Header*>(index_->header_);
+    header->max_level = max_level_;
+    header->entry_point = entry_point_;
+  }
+
+ private:
+  int MaxLinks(int level) const noexcept {
+    return level == 0 ? 2 * param_.m : param_.m;
+  }
+
+  const float* Vector(uint32_t node) const noexcept {
+    return index_->vectors_ + (size_t)node * index_->dim();
+  }
+
+  // the index owns its buffer when it is built
+  uint32_t* MutableLinks(uint32_t node, int level) const noexcept {
+    return const_cast<uint32_t*>(index_->Links(node, level));
+  }
+
+  void Insert(uint32_t node, VisitedList* visited) {
+    const float* query = Vector(node);
+    int level = index_->levels_[node];
+
+    // A node on a new top level holds the global lock until it is inserted.
+    std::unique_lock<std::mutex> global_lock(global_mtx_);
+    int max_level = max_level_;
+    uint32_t entry = entry_point_;
+    if (level <= max_level) {
+      global_lock.unlock();
+    }
+
+    LockedReadLinks read_links{this};
+    entry = index_->Descend(query, entry, max_level, level, read_links);
+
+    std::vector<dist_node_t> candidates;
+    for (int l = std::min(level, max_level); l >= 0; --l) {
+      index_->SearchLayer(query, entry, param_.ef_construction, l, visited,
+                          read_links, &candidates);
+      entry = candidates.front().second;
+      SelectNeighbors(param_.m, &candidates);
+      Connect(node, l, candidates);
+    }
+
+    if (level > max_level) {
+      max_level_ = level;
+      entry_point_ = node;
+    }
+  }
+
+  // The heuristic of the paper, a candidate is dropped if it is closer to a
+  // selected one than to the base node, which keeps links in all directions.
+  void SelectNeighbors(int max_links,
+                       std::vector<dist_node_t>* candidates) const {
+    if ((int)candidates->size() <= max_links) {
+      return;
+    }
+
+    std::vector<dist_node_t> selected;
+    selected.reserve(max_links);
+    for (const auto& candidate : *candidates) {
+      if ((int)selected.size() == max_links) {
+        break;
+      }
+
+      const float* vector = Vector(candidate.second);
+      bool good = true;
+      for (const auto& entry : selected) {
+        if (Distance(index_->metric(), index_->dim(), vector,
+                     Vector(entry.second)) < candidate.first) {
+          good = false;
+          break;
+        }
+      }
+      if (good) {
+        selected.emplace_back(candidate);
+      }
+    }
+    candidates->swap(selected);
+  }
+
+  void Connect(uint32_t node, int level,
+               const std::vector<dist_node_t>& neighbors) {
+    {
+      std::lock_guard<std::mutex> guard(locks_[node]);
+      uint32_t* links = MutableLinks(node, level);
+      links[0] = (uint32_t)neighbors.size();
+      for (size_t i = 0; i < neighbors.size(); ++i) {
+        links[i + 1] = neighbors[i].second;
+      }
+    }
+
+    int max_links = MaxLinks(level);
+    std::vector<dist_node_t> candidates;
+    for (const auto& neighbor : neighbors) {
+      std::lock_guard<std::mutex> guard(locks_[neighbor.second]);
+      uint32_t* links = MutableLinks(neighbor.second, level);
+      if ((int)links[0] < max_links) {
+        links[++links[0]] = node;
+        continue;
+      }
+
+      // shrink the links of the neighbor
+      const float* vector = Vector(neighbor.second);
+      candidates.clear();
+      candidates.emplace_back(neighbor.first, node);
+      for (uint32_t i = 1; i <= links[0]; ++i) {
+        candidates.emplace_back(Distance(index_->metric(), index_->dim(),
+                                         vector, Vector(links[i])),
+                                links[i]);
+      }
+      std::sort(candidates.begin(), candidates.end());
+      SelectNeighbors(max_links, &candidates);
+      links[0] = (uint32_t)candidates.size();
+      for (size_t i = 0; i < candidates.size(); ++i) {
+        links[i + 1] = candidates[i].second;
+      }
+    }
+  }
+};
+
+std::unique_ptr<HnswIndex> HnswIndex::Build(const vec_int_t& ids,
+                                            const std::vector<float>& vectors,
+                                            int dim, const HnswParam& param,
+                                            int thread_num) {
+  std::unique_ptr<HnswIndex> index;
+  if (dim <= 0 || param.m < 2 || param.ef_construction <= 0 ||
+      thread_num <= 0) {
+    DXERROR("Need dim > 0, m >= 2, ef_construction > 0 and thread_num > 0, "
+            "got dim: %d, m: %d, ef_construction: %d, thread_num: %d.",
+            dim, param.m, param.ef_construction, thread_num);
+    return index;
+  }
+  if (ids.empty() || ids.size() >= UINT32_MAX ||
+      vectors.size() != ids.size() * dim) {
+    DXERROR("Need 0 < ids.size() < 2^32 and vectors.size() == ids.size() * "
+            "dim, got ids.size(): %zu, vectors.size(): %zu.",
+            ids.size(), vectors.size());
+    return index;
+  }
+
+  // levels, P(level >= l) = m^-l
+  size_t size = ids.size();
+  std::vector<int32_t> levels(size);
+  std::vector<uint64_t> upper_offsets(size + 1, 0);
+  RandomEngine engine(param.seed, 0);
+  double mult = 1 / std::log((double)param.m);
+  for (size_t i = 0; i < size; ++i) {
+    double level = -std::log(1 - engine.NextDouble()) * mult;
+    levels[i] = (int32_t)std::min(level, (double)MAX_LEVEL);
+    upper_offsets[i + 1] =
+        upper_offsets[i] + (uint64_t)levels[i] * (1 + param.m);
+  }
+
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.dim = dim;
+  header.size = size;
+  header.m = param.m;
+  header.metric = (int32_t)param.metric;
+  header.max_level = levels[0];
+  header.entry_point = 0;
+  header.upper_link_size = upper_offsets.back();
+
+  Layout layout = GetLayout(header);
+  index.reset(new HnswIndex);
+  index->buffer_.assign(layout.total / sizeof(uint64_t), 0);
+  auto* data = (char*)index->buffer_.data();
+  std::memcpy(data, &header, sizeof(header));
+  std::memcpy(data + layout.ids, ids.data(), size * sizeof(int_t));
+  std::memcpy(data + layout.vectors, vectors.data(),
+              vectors.size() * sizeof(float));
+  std::memcpy(data + layout.levels, levels.data(), size * sizeof(int32_t));
+  std::memcpy(data + layout.upper_offsets, upper_offsets.data(),
+              upper_offsets.size() * sizeof(uint64_t));
+  DXCHECK(index->Attach(data, layout.total));
+
+  DXINFO("Building HNSW index of %zu nodes, dim: %d, m: %d, max level: %d...",
+         size, dim, param.m, *std::max_element(levels.begin(), levels.end()));
+  HnswBuilder builder(index.get(), param);
+  builder.Run(thread_num);
+  DXINFO("Done.");
+  return index;
+}
+
+/************************************************************************/
+/* Save and load */
+/************************************************************************/
+bool HnswIndex::Attach(const char* data, size_t size) {
+  static_assert(sizeof(Header) == 64, "Header must be 64 bytes.");
+  if (size < sizeof(Header)) {
+    DXERROR("Index is too small: %zu.", size);
+    return false;
+  }
+
+  const auto* header = (const Header*)data;
+  if (header->magic != MAGIC || header->version != VERSION) {
+    DXERROR("Not an HNSW index or unsupported version: %u.",
+            header->version);
+    return false;
+  }
+  if (header->dim <= 0 || header->m < 2 || header->size == 0 ||
+      header->entry_point >= header->size ||
+      (header->metric != (int32_t)MetricEnum::INNER_PRODUCT &&
+       header->metric != (int32_t)MetricEnum::L2)) {
+    DXERROR("Invalid index header.");
+    return false;
+  }
+
+  Layout layout = GetLayout(*header);
+  if (layout.total != size) {
+    DXERROR("Index size: %zu doesn't match its header: %zu.", size,
+            layout.total);
+    return false;
+  }
+
+  data_ = data;
+  data_size_ = size;
+  header_ = header;
+  ids_ = (const int_t*)(data + layout.ids);
+  vectors_ = (const float*)(data + layout.vectors);
+  levels_ = (const int32_t*)(data + layout.levels);
+  links0_ = (const uint32_t*)(data + layout.links0);
+  upper_offsets_ = (const uint64_t*)(data + layout.upper_offsets);
+  upper_links_ = (const uint32_t*)(data + layout.upper_links);
+  return true;
+}
+
+bool HnswIndex::Save(const std::string& file) const {
+  deepx_core::AutoOutputFileStream ofs;
+  if (!ofs.Open(file)) {
+    DXERROR("Failed to open file: %s.", file.c_str());
+    return false;
+  }
+
+  ofs.Write(data_, data_size_);
+  if (!ofs) {
+    DXERROR("Failed to write file: %s.", file.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<HnswIndex> HnswIndex::Load(const std::string& file) {
+  std::unique_ptr<HnswIndex> index(new HnswIndex);
+  if (index->mapped_file_.Open(file)) {
+    DXINFO("Mapped index file: %s.", file.c_str());
+    if (!index->Attach(index->mapped_file_.data(),
+                       index->mapped_file_.size())) {
+      index.reset();
+    }
+    return index;
+  }
+
+  // not a local file, read it
+  deepx_core::AutoInputFileStream ifs;
+  if (!ifs.Open(file)) {
+    DXERROR("Failed to open file: %s.", file.c_str());
+    index.reset();
+    return index;
+  }
+
+  std::string content;
+  std::vector<char> chunk(1 << 20);
+  for (;;) {
+    size_t n = ifs.Read(chunk.data(), chunk.size());
+    if (n == 0) {
+      break;
+    }
+    content.append(chunk.data(), n);
+  }
+
+  index->buffer_.resize(Align8(content.size()) / sizeof(uint64_t));
+  std::memcpy(index->buffer_.data(), content.data(), content.size());
+  if (!index->Attach((const char*)index->buffer_.data(), content.size())) {
+    index.reset();
+  }
+  return index;
+}
+
+/************************************************************************/
+/* Utils */
+/************************************************************************/
+void ExactSearch(const vec_int_t& ids, const std::vector<float>& vectors,
+                 int dim, MetricEnum metric, const float* query, int k,
+                 std::vector<scored_node_t>* nodes) {
+  std::vector<std::pair<float, size_t>> dists(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    dists[i].first = Distance(metric, dim, query, vectors.data() + i * dim);
+    dists[i].second = i;
+  }
+
+  size_t n = std::min((size_t)std::max(k, 0), dists.size());
+  std::partial_sort(dists.begin(), dists.begin() + n, dists.end());
+  nodes->clear();
+  for (size_t i = 0; i < n; ++i) {
+    nodes->emplace_back(ids[dists[i].second],
+                        DistanceToScore(metric, dists[i].first));
+  }
+}
+
+bool LoadEmbedding(const std::string& path, int thread_num, vec_int_t* ids,
+                   std::vector<float>* vectors, int* dim) {
+  vec_str_t files;
+  if (!io_util::ListFile(path, &files)) {
+    return false;
+  }
+
+  thread_num = std::max(std::min(thread_num, (int)files.size()), 1);
+  std::vector<vec_int_t> ids_list(thread_num);
+  std::vector<std::vector<float>> vectors_list(thread_num);
+  std::vector<int> dims(thread_num, 0);
+  auto load_func = [&](const vec_str_t& sub_files, int thread_id) {
+    for (const auto& file : sub_files) {
+      DXINFO("Thread: %d is processing file: %s.", thread_id, file.c_str());
+      if (!ReadEmbeddingFile(file, [&](const vec_int_t& sub_ids,
+                                       const std::vector<float>& sub_vectors,
+                                       int sub_dim) {
+            int& thread_dim = dims[thread_id];
+            if (thread_dim == 0) {
+              thread_dim = sub_dim;
+            } else if (thread_dim != sub_dim) {
+              DXERROR("Need the same dim of embeddings, got %d vs %d.",
+                      thread_dim, sub_dim);
+              return false;
+            }
+            ids_list[thread_id].insert(ids_list[thread_id].end(),
+                                       sub_ids.begin(), sub_ids.end());
+            vectors_list[thread_id].insert(vectors_list[thread_id].end(),
+                                           sub_vectors.begin(),
+                                           sub_vectors.end());
+            return true;
+          })) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (!io_util::ParallelProcess<std::string>(files, load_func, thread_num)) {
+    DXERROR("Failed to load embedding.");
+    return false;
+  }
+
+  ids->clear();
+  vectors->clear();
+  *dim = 0;
+  for (int i = 0; i < thread_num; ++i) {
+    if (dims[i] == 0) {
+      continue;
+    }
+    if (*dim != 0 && *dim != dims[i]) {
+      DXERROR("Need the same dim of embeddings, got %d vs %d.", *dim,
+              dims[i]);
+      return false;
+    }
+    *dim = dims[i];
+    ids->insert(ids->end(), ids_list[i].begin(), ids_list[i].end());
+    vectors->insert(vectors->end(), vectors_list[i].begin(),
+                    vectors_list[i].end());
+  }
+  return true;
+}
+
+}  // namespace ann
+}  // namespace embedx
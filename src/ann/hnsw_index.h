@@ -0,0 +1,135 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <cstdint>
+#include <memory>  // std::unique_ptr
+#include <mutex>
+#include <string>
+#include <utility>  // std::pair
+#include <vector>
+
+#include "src/ann/distance.h"
+#include "src/common/data_types.h"
+#include "src/common/mapped_file.h"
+
+namespace embedx {
+namespace ann {
+
+struct HnswParam {
+  // links of a node on upper levels, 2 * m on level 0
+  int m = 16;
+  // candidates of an insertion, the larger the better and the slower to build
+  int ef_construction = 200;
+  MetricEnum metric = MetricEnum::INNER_PRODUCT;
+  // seed of the levels of nodes
+  uint64_t seed = 0;
+};
+
+// a node and its score, see DistanceToScore
+using scored_node_t = std::pair<int_t, float>;
+
+// HnswIndex is a hierarchical navigable small world graph over embeddings for
+// approximate top k search.
+//
+// The index is one flat buffer with the same layout in memory and in files,
+// so a loaded index is the mapped file itself and processes serving the same
+// index share its pages. Search is thread safe.
+class HnswIndex {
+ private:
+  class VisitedList;
+  struct Header;
+  struct ReadLinks;
+  // a node and its distance to the query
+  using dist_node_t = std::pair<float, uint32_t>;
+
+  std::vector<uint64_t> buffer_;  // 8 bytes aligned
+  MappedFile mapped_file_;
+  const char* data_ = nullptr;
+  size_t data_size_ = 0;
+
+  const Header* header_ = nullptr;
+  const int_t* ids_ = nullptr;
+  const float* vectors_ = nullptr;
+  const int32_t* levels_ = nullptr;
+  // links of level 0, [count, node...] of '1 + 2 * m' slots per node
+  const uint32_t* links0_ = nullptr;
+  // links of upper levels, [count, node...] of '1 + m' slots per level
+  const uint64_t* upper_offsets_ = nullptr;
+  const uint32_t* upper_links_ = nullptr;
+
+  mutable std::mutex visited_mtx_;
+  mutable std::vector<std::unique_ptr<VisitedList>> visited_pool_;
+
+ public:
+  // Builds the index of 'ids[i]' whose embedding is
+  // 'vectors[i * dim, (i + 1) * dim)' with 'thread_num' threads.
+  static std::unique_ptr<HnswIndex> Build(const vec_int_t& ids,
+                                          const std::vector<float>& vectors,
+                                          int dim, const HnswParam& param,
+                                          int thread_num);
+  // Maps a local 'file', or reads it if it can't be mapped.
+  static std::unique_ptr<HnswIndex> Load(const std::string& file);
+
+ public:
+  ~HnswIndex();
+  bool Save(const std::string& file) const;
+
+  size_t size() const noexcept;
+  int dim() const noexcept;
+  MetricEnum metric() const noexcept;
+  bool mapped() const noexcept { return mapped_file_.data() != nullptr; }
+
+  // Top 'k' nodes closest to 'query' of 'dim()' floats, closest first. 'ef'
+  // is the number of candidates, the larger the better recall and the slower.
+  void Search(const float* query, int k, int ef,
+              std::vector<scored_node_t>* nodes) const;
+
+ private:
+  bool Attach(const char* data, size_t size);
+  const uint32_t* Links(uint32_t node, int level) const noexcept;
+  float NodeDistance(const float* query, uint32_t node) const noexcept {
+    return Distance(metric(), dim(), query, vectors_ + (size_t)node * dim());
+  }
+
+  // Greedy search from 'entry' on levels (to_level, from_level].
+  template <class ForEachLink>
+  uint32_t Descend(const float* query, uint32_t entry, int from_level,
+                   int to_level, const ForEachLink& for_each_link) const;
+  // The 'ef' nodes closest to 'query' on 'level', closest first.
+  template <class ForEachLink>
+  void SearchLayer(const float* query, uint32_t entry, int ef, int level,
+                   VisitedList* visited, const ForEachLink& for_each_link,
+                   std::vector<dist_node_t>* results) const;
+
+  VisitedList* GetVisitedList() const;
+  void ReleaseVisitedList(VisitedList* visited) const;
+
+  // HnswBuilder builds the index in place.
+  friend class HnswBuilder;
+
+ private:
+  HnswIndex() = default;
+};
+
+// Exact top 'k' nodes closest to 'query' by scanning 'vectors', see
+// HnswIndex::Build for the arguments.
+void ExactSearch(const vec_int_t& ids, const std::vector<float>& vectors,
+                 int dim, MetricEnum metric, const float* query, int k,
+                 std::vector<scored_node_t>* nodes);
+
+// Loads embeddings dumped by predictor in the files of 'path', text lines of
+// 'node val0 val1 ...' or binary embedding files, see ReadEmbeddingFile.
+bool LoadEmbedding(const std::string& path, int thread_num, vec_int_t* ids,
+                   std::vector<float>* vectors, int* dim);
+
+}  // namespace ann
+}  // namespace embedx
@@ -0,0 +1,165 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/ann/hnsw_index.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>  // std::remove
+#include <memory>  // std::unique_ptr
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/common/random.h"
+
+namespace embedx {
+namespace ann {
+
+class HnswIndexTest : public ::testing::Test {
+ protected:
+  const int SIZE = 2000;
+  const int DIM = 16;
+  const int QUERY_NUM = 50;
+  const int K = 10;
+  const int EF = 64;
+  const int THREAD_NUM = 4;
+  const std::string EMBEDDING = "testdata/embedding";
+  const std::string INDEX_FILE = "hnsw_index_test.index";
+
+  vec_int_t ids_;
+  std::vector<float> vectors_;
+  std::vector<float> queries_;
+
+ protected:
+  void SetUp() override {
+    RandomEngine engine(9527, 0);
+    ids_.resize(SIZE);
+    vectors_.resize((size_t)SIZE * DIM);
+    for (int i = 0; i < SIZE; ++i) {
+      ids_[i] = (int_t)(i * 3 + 1);
+    }
+    for (auto& value : vectors_) {
+      value = (float)(engine.NextDouble() * 2 - 1);
+    }
+    queries_.resize((size_t)QUERY_NUM * DIM);
+    for (auto& value : queries_) {
+      value = (float)(engine.NextDouble() * 2 - 1);
+    }
+  }
+
+  double Recall(const HnswIndex& index, MetricEnum metric) const {
+    std::vector<scored_node_t> nodes, exact_nodes;
+    int hit = 0;
+    for (int i = 0; i < QUERY_NUM; ++i) {
+      const float* query = queries_.data() + i * DIM;
+      index.Search(query, K, EF, &nodes);
+      ExactSearch(ids_, vectors_, DIM, metric, query, K, &exact_nodes);
+      EXPECT_EQ(nodes.size(), (size_t)K);
+
+      std::unordered_set<int_t> exact_ids;
+      for (const auto& node : exact_nodes) {
+        exact_ids.insert(node.first);
+      }
+      for (const auto& node : nodes) {
+        hit += (int)exact_ids.count(node.first);
+      }
+    }
+    return (double)hit / (QUERY_NUM * K);
+  }
+};
+
+TEST_F(HnswIndexTest, InnerProduct) {
+  HnswParam param;
+  param.metric = MetricEnum::INNER_PRODUCT;
+  auto index = HnswIndex::Build(ids_, vectors_, DIM, param, THREAD_NUM);
+  ASSERT_TRUE(index != nullptr);
+  EXPECT_EQ(index->size(), (size_t)SIZE);
+  EXPECT_EQ(index->dim(), DIM);
+  EXPECT_GE(Recall(*index, MetricEnum::INNER_PRODUCT), 0.9);
+
+  // closest first
+  std::vector<scored_node_t> nodes;
+  index->Search(queries_.data(), K, EF, &nodes);
+  for (size_t i = 1; i < nodes.size(); ++i) {
+    EXPECT_GE(nodes[i - 1].second, nodes[i].second);
+  }
+}
+
+TEST_F(HnswIndexTest, L2) {
+  HnswParam param;
+  param.metric = MetricEnum::L2;
+  auto index = HnswIndex::Build(ids_, vectors_, DIM, param, THREAD_NUM);
+  ASSERT_TRUE(index != nullptr);
+  EXPECT_GE(Recall(*index, MetricEnum::L2), 0.9);
+
+  // a node is its own nearest neighbor
+  std::vector<scored_node_t> nodes;
+  index->Search(vectors_.data() + 5 * DIM, 1, EF, &nodes);
+  ASSERT_EQ(nodes.size(), 1u);
+  EXPECT_EQ(nodes[0].first, ids_[5]);
+  EXPECT_FLOAT_EQ(nodes[0].second, 0);
+}
+
+TEST_F(HnswIndexTest, SaveAndLoad) {
+  HnswParam param;
+  auto index = HnswIndex::Build(ids_, vectors_, DIM, param, THREAD_NUM);
+  ASSERT_TRUE(index != nullptr);
+  ASSERT_TRUE(index->Save(INDEX_FILE));
+
+  auto loaded_index = HnswIndex::Load(INDEX_FILE);
+  ASSERT_TRUE(loaded_index != nullptr);
+  EXPECT_EQ(loaded_index->size(), index->size());
+  EXPECT_EQ(loaded_index->dim(), index->dim());
+  EXPECT_EQ(loaded_index->metric(), index->metric());
+
+  std::vector<scored_node_t> nodes, loaded_nodes;
+  for (int i = 0; i < QUERY_NUM; ++i) {
+    const float* query = queries_.data() + i * DIM;
+    index->Search(query, K, EF, &nodes);
+    loaded_index->Search(query, K, EF, &loaded_nodes);
+    EXPECT_EQ(nodes, loaded_nodes);
+  }
+
+  loaded_index.reset();
+  std::remove(INDEX_FILE.c_str());
+}
+
+TEST_F(HnswIndexTest, Invalid) {
+  HnswParam param;
+  EXPECT_TRUE(HnswIndex::Build(vec_int_t(), std::vector<float>(), DIM, param,
+                               THREAD_NUM) == nullptr);
+  vectors_.pop_back();
+  EXPECT_TRUE(HnswIndex::Build(ids_, vectors_, DIM, param, THREAD_NUM) ==
+              nullptr);
+  EXPECT_TRUE(HnswIndex::Load("testdata/embedding/embedding-0") == nullptr);
+}
+
+TEST_F(HnswIndexTest, LoadEmbedding) {
+  vec_int_t ids;
+  std::vector<float> vectors;
+  int dim;
+  ASSERT_TRUE(LoadEmbedding(EMBEDDING, THREAD_NUM, &ids, &vectors, &dim));
+  EXPECT_EQ(ids.size(), 20u);
+  EXPECT_EQ(dim, 8);
+  EXPECT_EQ(vectors.size(), 160u);
+
+  HnswParam param;
+  auto index = HnswIndex::Build(ids, vectors, dim, param, THREAD_NUM);
+  ASSERT_TRUE(index != nullptr);
+  std::vector<scored_node_t> nodes;
+  index->Search(vectors.data(), 20, 20, &nodes);
+  EXPECT_EQ(nodes.size(), 20u);
+}
+
+}  // namespace ann
+}  // namespace embedx
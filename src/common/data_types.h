@@ -12,12 +12,15 @@
 #pragma once
 #include <deepx_core/tensor/data_type.h>
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>  // std::pair
 #include <vector>
 
+#include "src/common/flat_hash.h"
+
 namespace embedx {
 
 using int_t = ::deepx_core::DataType::int_t;
@@ -30,16 +33,22 @@ using vec_float_t = std::vector<float_t>;
 using vecl_t = std::vector<int>;
 using vec_str_t = std::vector<std::string>;
 using vec_pair_t = std::vector<pair_t>;
+using vec_time_t = std::vector<int64_t>;
 using set_int_t = std::unordered_set<int_t>;
 
-using vec_set_t = std::vector<set_int_t>;
+// batch local node sets, iterated in insertion order
+using flat_set_t = FlatSet<int_t>;
+using vec_set_t = std::vector<flat_set_t>;
 using vec_map_neigh_t = std::vector<std::unordered_map<int_t, vec_int_t>>;
+// weighted neighbors of each level, see LayerwiseSample
+using vec_map_adj_t = std::vector<std::unordered_map<int_t, vec_pair_t>>;
 
 using id_name_t = std::unordered_map<uint16_t, std::string>;
 using adj_list_t = std::unordered_map<int_t, vec_pair_t>;
 using degree_list_t = std::unordered_map<int_t, std::pair<int_t, int_t>>;
 
 using index_map_t = std::unordered_map<int_t, int>;
+using flat_index_map_t = FlatMap<int_t, int>;
 using vec_index_map_t = std::vector<std::unordered_map<int_t, int>>;
 using weight_map_t = std::unordered_map<int_t, float_t>;
 
@@ -0,0 +1,107 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/common/epoch.h"
+
+#include <thread>
+
+namespace embedx {
+namespace {
+
+struct ThreadPin {
+  int depth = 0;
+  int slot = -1;
+  uint64_t epoch = EpochManager::LATEST;
+  // slot of the last pin, it is likely free again
+  int hint = -1;
+};
+
+thread_local ThreadPin thread_pin;
+std::atomic<int> next_hint{0};
+
+}  // namespace
+
+constexpr uint64_t EpochManager::LATEST;
+constexpr int EpochManager::SLOT_NUM;
+
+EpochManager::EpochManager() : slots_(new Slot[SLOT_NUM]) {
+  for (int i = 0; i < SLOT_NUM; ++i) {
+    slots_[i].epoch.store(LATEST);
+  }
+}
+
+EpochManager* EpochManager::GetInstance() {
+  static EpochManager manager;
+  return &manager;
+}
+
+uint64_t EpochManager::SafeEpoch() const noexcept {
+  uint64_t safe_epoch = epoch_.load();
+  for (int i = 0; i < SLOT_NUM; ++i) {
+    uint64_t epoch = slots_[i].epoch.load();
+    if (epoch < safe_epoch) {
+      safe_epoch = epoch;
+    }
+  }
+  return safe_epoch;
+}
+
+int EpochManager::Pin(uint64_t* epoch) noexcept {
+  ThreadPin& pin = thread_pin;
+  if (pin.hint < 0) {
+    pin.hint = next_hint.fetch_add(1) % SLOT_NUM;
+  }
+
+  for (;;) {
+    for (int i = 0; i < SLOT_NUM; ++i) {
+      int slot = (pin.hint + i) % SLOT_NUM;
+      uint64_t published = epoch_.load();
+      uint64_t expected = LATEST;
+      if (!slots_[slot].epoch.compare_exchange_strong(expected, published)) {
+        continue;
+      }
+
+      // The writer may publish between the load and the store, it then may
+      // not have seen the slot, so pin again until the epoch is stable.
+      uint64_t current = epoch_.load();
+      while (current != published) {
+        published = current;
+        slots_[slot].epoch.store(published);
+        current = epoch_.load();
+      }
+
+      pin.hint = slot;
+      *epoch = published;
+      return slot;
+    }
+    std::this_thread::yield();
+  }
+}
+
+EpochGuard::EpochGuard() noexcept {
+  ThreadPin& pin = thread_pin;
+  if (pin.depth++ == 0) {
+    pin.slot = EpochManager::GetInstance()->Pin(&pin.epoch);
+  }
+}
+
+EpochGuard::~EpochGuard() {
+  ThreadPin& pin = thread_pin;
+  if (--pin.depth == 0) {
+    EpochManager::GetInstance()->Unpin(pin.slot);
+    pin.slot = -1;
+    pin.epoch = EpochManager::LATEST;
+  }
+}
+
+uint64_t ReadEpoch() noexcept { return thread_pin.epoch; }
+
+}  // namespace embedx
@@ -0,0 +1,76 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>  // std::unique_ptr
+
+namespace embedx {
+
+// EpochManager versions the data of a running graph server.
+//
+// A writer stages an update batch at epoch 'epoch() + 1' and makes it visible
+// with Publish(). A reader pins the published epoch with EpochGuard for a
+// whole request, so all lookups of the request see the same snapshot and
+// never wait for the writer. What a batch replaces at epoch e is freed once
+// SafeEpoch() >= e, i.e. no reader pins an older epoch.
+class EpochManager {
+ public:
+  // epoch of reads outside any EpochGuard, they see the latest data
+  static constexpr uint64_t LATEST = UINT64_MAX;
+  // readers pinning at the same time, more of them wait for a free slot
+  static constexpr int SLOT_NUM = 1024;
+
+ private:
+  // one cache line per slot, LATEST marks a free slot
+  struct Slot {
+    std::atomic<uint64_t> epoch;
+    char padding[64 - sizeof(std::atomic<uint64_t>)];
+  };
+
+  std::atomic<uint64_t> epoch_{0};
+  std::unique_ptr<Slot[]> slots_;
+
+ public:
+  static EpochManager* GetInstance();
+
+ public:
+  uint64_t epoch() const noexcept { return epoch_.load(); }
+  // Called by the only writer with 'epoch() + 1'.
+  void Publish(uint64_t epoch) noexcept { epoch_.store(epoch); }
+  // the oldest epoch pinned by a reader, or epoch() if there is none
+  uint64_t SafeEpoch() const noexcept;
+
+ private:
+  friend class EpochGuard;
+  // Pins the published epoch and returns the slot holding it.
+  int Pin(uint64_t* epoch) noexcept;
+  void Unpin(int slot) noexcept { slots_[slot].epoch.store(LATEST); }
+
+ private:
+  EpochManager();
+};
+
+// EpochGuard pins the published epoch for the calling thread, nested guards
+// share the pin of the outermost one.
+class EpochGuard {
+ public:
+  EpochGuard() noexcept;
+  ~EpochGuard();
+  EpochGuard(const EpochGuard&) = delete;
+  EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+// The epoch pinned by the calling thread, or EpochManager::LATEST.
+uint64_t ReadEpoch() noexcept;
+
+}  // namespace embedx
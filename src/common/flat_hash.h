@@ -0,0 +1,233 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>  // std::pair
+#include <vector>
+
+namespace embedx {
+namespace detail {
+
+// FlatTable maps integer keys to their positions in insertion order.
+//
+// Keys live in one array, the slots of the open addressing table with linear
+// probing only hold positions. A slot is used only if it has the generation
+// of the table, so Clear() is O(1) and keeps the memory for the next batch.
+template <typename K>
+class FlatTable {
+ private:
+  static_assert(std::is_integral<K>::value, "K must be an integral type.");
+
+  struct Slot {
+    uint32_t generation;
+    uint32_t pos;
+  };
+
+  static constexpr size_t INIT_CAPACITY = 16;
+
+  std::vector<K> keys_;
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+  uint32_t generation_ = 1;
+
+ public:
+  static constexpr size_t NPOS = (size_t)-1;
+
+ public:
+  const std::vector<K>& keys() const noexcept { return keys_; }
+  size_t size() const noexcept { return keys_.size(); }
+
+  void Reserve(size_t size) {
+    keys_.reserve(size);
+    // load factor <= 0.5
+    if (size * 2 > slots_.size()) {
+      Rehash(size * 2);
+    }
+  }
+
+  void Clear() noexcept {
+    keys_.clear();
+    if (++generation_ == 0) {
+      for (auto& slot : slots_) {
+        slot.generation = 0;
+      }
+      generation_ = 1;
+    }
+  }
+
+  size_t Find(K key) const noexcept {
+    if (keys_.empty()) {
+      return NPOS;
+    }
+
+    for (size_t i = Hash(key) & mask_;; i = (i + 1) & mask_) {
+      const Slot& slot = slots_[i];
+      if (slot.generation != generation_) {
+        return NPOS;
+      }
+      if (keys_[slot.pos] == key) {
+        return slot.pos;
+      }
+    }
+  }
+
+  // Returns the position of 'key' and whether it is inserted.
+  std::pair<size_t, bool> Insert(K key) {
+    if ((keys_.size() + 1) * 2 > slots_.size()) {
+      Rehash(slots_.empty() ? INIT_CAPACITY : slots_.size() * 2);
+    }
+
+    size_t i = Hash(key) & mask_;
+    for (; slots_[i].generation == generation_; i = (i + 1) & mask_) {
+      if (keys_[slots_[i].pos] == key) {
+        return std::make_pair((size_t)slots_[i].pos, false);
+      }
+    }
+
+    slots_[i].generation = generation_;
+    slots_[i].pos = (uint32_t)keys_.size();
+    keys_.emplace_back(key);
+    return std::make_pair(keys_.size() - 1, true);
+  }
+
+ private:
+  static size_t Hash(K key) noexcept {
+    uint64_t h = (uint64_t)key;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (size_t)h;
+  }
+
+  void Rehash(size_t min_capacity) {
+    size_t capacity = INIT_CAPACITY;
+    while (capacity < min_capacity) {
+      capacity *= 2;
+    }
+    if (capacity <= slots_.size()) {
+      return;
+    }
+
+    slots_.assign(capacity, Slot{0, 0});
+    mask_ = capacity - 1;
+    generation_ = 1;
+    for (size_t pos = 0; pos < keys_.size(); ++pos) {
+      size_t i = Hash(keys_[pos]) & mask_;
+      while (slots_[i].generation == generation_) {
+        i = (i + 1) & mask_;
+      }
+      slots_[i].generation = generation_;
+      slots_[i].pos = (uint32_t)pos;
+    }
+  }
+};
+
+template <typename K>
+constexpr size_t FlatTable<K>::INIT_CAPACITY;
+template <typename K>
+constexpr size_t FlatTable<K>::NPOS;
+
+}  // namespace detail
+
+// FlatSet is a set of integer keys iterated in insertion order.
+//
+// It is meant for batch local sets rebuilt many times, clear() is O(1) and
+// keeps the memory.
+template <typename K>
+class FlatSet {
+ private:
+  detail::FlatTable<K> table_;
+
+ public:
+  using value_type = K;
+  using const_iterator = typename std::vector<K>::const_iterator;
+
+ public:
+  const_iterator begin() const noexcept { return table_.keys().begin(); }
+  const_iterator end() const noexcept { return table_.keys().end(); }
+  // keys in insertion order
+  const std::vector<K>& keys() const noexcept { return table_.keys(); }
+  size_t size() const noexcept { return table_.size(); }
+  bool empty() const noexcept { return table_.size() == 0; }
+
+  void reserve(size_t size) { table_.Reserve(size); }
+  void clear() noexcept { table_.Clear(); }
+
+  bool insert(K key) { return table_.Insert(key).second; }
+
+  template <class InputIt>
+  void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      table_.Insert(*first);
+    }
+  }
+
+  size_t count(K key) const noexcept {
+    return table_.Find(key) == detail::FlatTable<K>::NPOS ? 0 : 1;
+  }
+};
+
+// FlatMap maps integer keys to values, see FlatSet.
+//
+// Values are kept by position, a rehash doesn't move them.
+template <typename K, typename V>
+class FlatMap {
+ private:
+  detail::FlatTable<K> table_;
+  std::vector<V> values_;
+
+ public:
+  // keys and values in insertion order
+  const std::vector<K>& keys() const noexcept { return table_.keys(); }
+  const std::vector<V>& values() const noexcept { return values_; }
+  size_t size() const noexcept { return table_.size(); }
+  bool empty() const noexcept { return table_.size() == 0; }
+
+  void reserve(size_t size) {
+    table_.Reserve(size);
+    values_.reserve(size);
+  }
+
+  void clear() noexcept {
+    table_.Clear();
+    values_.clear();
+  }
+
+  // Inserts 'key' with 'value' unless 'key' exists, like std::map::emplace.
+  bool emplace(K key, const V& value) {
+    auto result = table_.Insert(key);
+    if (result.second) {
+      values_.emplace_back(value);
+    }
+    return result.second;
+  }
+
+  V& operator[](K key) {
+    auto result = table_.Insert(key);
+    if (result.second) {
+      values_.emplace_back();
+    }
+    return values_[result.first];
+  }
+
+  // Returns nullptr if 'key' doesn't exist.
+  const V* find(K key) const noexcept {
+    size_t pos = table_.Find(key);
+    return pos == detail::FlatTable<K>::NPOS ? nullptr : &values_[pos];
+  }
+
+  size_t count(K key) const noexcept { return find(key) == nullptr ? 0 : 1; }
+};
+
+}  // namespace embedx
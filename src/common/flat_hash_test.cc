@@ -0,0 +1,90 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/common/flat_hash.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+TEST(FlatHashTest, FlatSet) {
+  FlatSet<int_t> set;
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.count(1), 0u);
+
+  EXPECT_TRUE(set.insert(5));
+  EXPECT_TRUE(set.insert(3));
+  EXPECT_FALSE(set.insert(5));
+  vec_int_t nodes = {7, 3, 1};
+  set.insert(nodes.begin(), nodes.end());
+
+  // insertion order
+  EXPECT_EQ(set.keys(), vec_int_t({5, 3, 7, 1}));
+  EXPECT_EQ(vec_int_t(set.begin(), set.end()), vec_int_t({5, 3, 7, 1}));
+  EXPECT_EQ(set.count(7), 1u);
+  EXPECT_EQ(set.count(2), 0u);
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.count(5), 0u);
+  EXPECT_TRUE(set.insert(1));
+  EXPECT_EQ(set.keys(), vec_int_t({1}));
+}
+
+TEST(FlatHashTest, FlatMap) {
+  FlatMap<int_t, int> map;
+  EXPECT_TRUE(map.find(1) == nullptr);
+
+  EXPECT_TRUE(map.emplace(10, 1));
+  EXPECT_FALSE(map.emplace(10, 2));
+  map[20] += 3;
+  map[10] += 1;
+  ASSERT_TRUE(map.find(10) != nullptr);
+  EXPECT_EQ(*map.find(10), 2);
+  EXPECT_EQ(*map.find(20), 3);
+  EXPECT_EQ(map.count(30), 0u);
+  EXPECT_EQ(map.keys(), vec_int_t({10, 20}));
+  EXPECT_EQ(map.values(), std::vector<int>({2, 3}));
+}
+
+// Keys colliding and growing over many clears match std::unordered_map.
+TEST(FlatHashTest, GrowAndClear) {
+  FlatMap<int_t, int> map;
+  std::unordered_map<int_t, int> expected;
+  for (int round = 0; round < 50; ++round) {
+    map.clear();
+    expected.clear();
+    if (round % 2 == 0) {
+      map.reserve(100);
+    }
+
+    int n = (round % 10 + 1) * 100;
+    for (int i = 0; i < n; ++i) {
+      // keys equal in the low bits
+      int_t key = ((int_t)(i % (n / 2)) << 32) + (int_t)round;
+      map.emplace(key, i);
+      expected.emplace(key, i);
+    }
+
+    ASSERT_EQ(map.size(), expected.size());
+    for (const auto& entry : expected) {
+      ASSERT_TRUE(map.find(entry.first) != nullptr);
+      EXPECT_EQ(*map.find(entry.first), entry.second);
+    }
+    EXPECT_TRUE(map.find((int_t)round + 1) == nullptr);
+  }
+}
+
+}  // namespace embedx
@@ -0,0 +1,66 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/common/mapped_file.h"
+
+#include <deepx_core/dx_log.h>
+
+#if OS_POSIX == 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace embedx {
+
+#if OS_POSIX == 1
+bool MappedFile::Open(const std::string& file) {
+  Close();
+
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping keeps the file open
+  close(fd);
+  if (data == MAP_FAILED) {
+    DXERROR("Failed to mmap file: %s.", file.c_str());
+    return false;
+  }
+
+  data_ = data;
+  size_ = (size_t)st.st_size;
+  return true;
+}
+
+void MappedFile::Close() noexcept {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+#else
+bool MappedFile::Open(const std::string& /*file*/) { return false; }
+
+void MappedFile::Close() noexcept {}
+#endif
+
+}  // namespace embedx
@@ -0,0 +1,40 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace embedx {
+
+// MappedFile maps a local file read only, the pages are loaded on demand and
+// shared by processes mapping the same file.
+class MappedFile {
+ private:
+  void* data_ = nullptr;
+  size_t size_ = 0;
+
+ public:
+  MappedFile() = default;
+  ~MappedFile() { Close(); }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+ public:
+  // Returns false if 'file' is not a local file or mmap is not supported.
+  bool Open(const std::string& file);
+  void Close() noexcept;
+
+  const char* data() const noexcept { return (const char*)data_; }
+  size_t size() const noexcept { return size_; }
+};
+
+}  // namespace embedx
@@ -0,0 +1,180 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/common/parallel_util.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::min, std::max
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace embedx {
+namespace {
+
+/************************************************************************/
+/* ParallelJob */
+/************************************************************************/
+struct ParallelJob {
+  const std::function<void(int, int)>* func = nullptr;
+  int n = 0;
+  int grain = 0;
+  int task_num = 0;
+  std::atomic<int> next{0};
+  std::atomic<int> done{0};
+  std::mutex mtx;
+  std::condition_variable cv;
+
+  void Run() {
+    for (;;) {
+      int task = next.fetch_add(1);
+      if (task >= task_num) {
+        return;
+      }
+      int begin = task * grain;
+      int end = std::min(begin + grain, n);
+      (*func)(begin, end);
+      if (done.fetch_add(1) + 1 == task_num) {
+        std::unique_lock<std::mutex> guard(mtx);
+        cv.notify_all();
+      }
+    }
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> guard(mtx);
+    cv.wait(guard, [this]() { return done.load() == task_num; });
+  }
+};
+
+/************************************************************************/
+/* IntraOpThreadPool */
+/************************************************************************/
+class IntraOpThreadPool {
+ private:
+  int thread_num_ = 1;
+  bool stop_ = false;
+  std::vector<std::thread> threads_;
+  std::deque<std::shared_ptr<ParallelJob>> jobs_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+
+ public:
+  static IntraOpThreadPool* GetInstance() {
+    static IntraOpThreadPool pool;
+    return &pool;
+  }
+
+  int thread_num() const noexcept { return thread_num_; }
+
+  void Start(int thread_num) {
+    Stop();
+    thread_num_ = std::max(thread_num, 1);
+    stop_ = false;
+    // the caller is also a worker
+    for (int i = 1; i < thread_num_; ++i) {
+      threads_.emplace_back(&IntraOpThreadPool::WorkerEntry, this);
+    }
+  }
+
+  void Stop() {
+    {
+      std::unique_lock<std::mutex> guard(mtx_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+    threads_.clear();
+    jobs_.clear();
+  }
+
+  void Run(const std::shared_ptr<ParallelJob>& job) {
+    int helper_num = std::min(job->task_num, thread_num_) - 1;
+    if (helper_num > 0) {
+      {
+        std::unique_lock<std::mutex> guard(mtx_);
+        for (int i = 0; i < helper_num; ++i) {
+          jobs_.emplace_back(job);
+        }
+      }
+      cv_.notify_all();
+    }
+    job->Run();
+    job->Wait();
+  }
+
+  ~IntraOpThreadPool() { Stop(); }
+
+ private:
+  void WorkerEntry() {
+    for (;;) {
+      std::shared_ptr<ParallelJob> job;
+      {
+        std::unique_lock<std::mutex> guard(mtx_);
+        cv_.wait(guard, [this]() { return stop_ || !jobs_.empty(); });
+        if (stop_) {
+          return;
+        }
+        job = jobs_.front();
+        jobs_.pop_front();
+      }
+      job->Run();
+    }
+  }
+};
+
+}  // namespace
+
+void SetIntraOpThreadNum(int thread_num) {
+  DXINFO("Intra op thread num: %d.", thread_num);
+  IntraOpThreadPool::GetInstance()->Start(thread_num);
+}
+
+int GetIntraOpThreadNum() noexcept {
+  return IntraOpThreadPool::GetInstance()->thread_num();
+}
+
+void ParallelFor(int n, int grain, const std::function<void(int, int)>& func) {
+  if (n <= 0) {
+    return;
+  }
+
+  auto* pool = IntraOpThreadPool::GetInstance();
+  grain = std::max(grain, 1);
+  int task_num = (n + grain - 1) / grain;
+  if (pool->thread_num() == 1 || task_num == 1) {
+    func(0, n);
+    return;
+  }
+
+  // balance ranges over threads, 'grain' is only a lower bound
+  int max_task_num = pool->thread_num() * 4;
+  if (task_num > max_task_num) {
+    grain = (n + max_task_num - 1) / max_task_num;
+    task_num = (n + grain - 1) / grain;
+  }
+
+  auto job = std::make_shared<ParallelJob>();
+  job->func = &func;
+  job->n = n;
+  job->grain = grain;
+  job->task_num = task_num;
+  pool->Run(job);
+}
+
+}  // namespace embedx
@@ -0,0 +1,27 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <functional>
+
+namespace embedx {
+
+// Set the number of threads (including the caller) used by one intra-op
+// 'ParallelFor'. It is not thread safe and should be called before training.
+void SetIntraOpThreadNum(int thread_num);
+int GetIntraOpThreadNum() noexcept;
+
+// Split [0, n) into ranges of at least 'grain' elements and run
+// 'func(begin, end)' on them concurrently. The caller always takes part, so
+// nested or concurrent calls never dead lock.
+void ParallelFor(int n, int grain, const std::function<void(int, int)>& func);
+
+}  // namespace embedx
@@ -0,0 +1,81 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>  // std::fill, std::max
+#include <cmath>      // std::fabs, std::lrint
+#include <cstdint>
+
+namespace embedx {
+
+// Rows of floats are quantized to int8 with a scale per row,
+// 'x[i] ~= scale * codes[i]' where 'scale = max(|x|) / 127'. The largest
+// values of a row keep their precision whatever its range, a row of zeros
+// has scale 0.
+constexpr float INT8_MAX_CODE = 127;
+
+// Quantizes 'n' finite floats of 'x' to 'codes', and returns the scale.
+inline float QuantizeRow(int n, const float* x, int8_t* codes) noexcept {
+  float max_abs = 0;
+  for (int i = 0; i < n; ++i) {
+    max_abs = std::max(max_abs, std::fabs(x[i]));
+  }
+  if (max_abs == 0) {
+    std::fill(codes, codes + n, (int8_t)0);
+    return 0;
+  }
+
+  float inv_scale = INT8_MAX_CODE / max_abs;
+  for (int i = 0; i < n; ++i) {
+    codes[i] = (int8_t)std::lrint(x[i] * inv_scale);
+  }
+  return max_abs / INT8_MAX_CODE;
+}
+
+// y = scale * codes
+inline void DequantizeRow(int n, float scale, const int8_t* codes,
+                          float* y) noexcept {
+  int i = 0;
+#if defined(__AVX2__)
+  __m256 s = _mm256_set1_ps(scale);
+  for (; i + 8 <= n; i += 8) {
+    __m128i c = _mm_loadl_epi64((const __m128i*)(codes + i));
+    __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(c));
+    _mm256_storeu_ps(y + i, _mm256_mul_ps(s, v));
+  }
+#elif defined(__SSE2__)
+  __m128 s = _mm_set1_ps(scale);
+  for (; i + 16 <= n; i += 16) {
+    // Sign extends by unpacking a code into the high half of a wider lane and
+    // shifting it back.
+    __m128i c = _mm_loadu_si128((const __m128i*)(codes + i));
+    __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(c, c), 8);
+    __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(c, c), 8);
+    __m128i v0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16);
+    __m128i v1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16);
+    __m128i v2 = _mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16);
+    __m128i v3 = _mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16);
+    _mm_storeu_ps(y + i, _mm_mul_ps(s, _mm_cvtepi32_ps(v0)));
+    _mm_storeu_ps(y + i + 4, _mm_mul_ps(s, _mm_cvtepi32_ps(v1)));
+    _mm_storeu_ps(y + i + 8, _mm_mul_ps(s, _mm_cvtepi32_ps(v2)));
+    _mm_storeu_ps(y + i + 12, _mm_mul_ps(s, _mm_cvtepi32_ps(v3)));
+  }
+#endif
+  for (; i < n; ++i) {
+    y[i] = scale * codes[i];
+  }
+}
+
+}  // namespace embedx
@@ -0,0 +1,94 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/common/quantized_rows.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>   // std::adjacent_find, std::lower_bound
+#include <cinttypes>   // PRIu64
+#include <functional>  // std::greater_equal
+
+#include "src/common/quantize.h"
+
+namespace embedx {
+
+constexpr size_t QuantizedRows::NPOS;
+
+bool QuantizedRows::valid() const noexcept {
+  return col_ >= 0 && codes_.size() == scales_.size() * col_ &&
+         (ids_.empty() || ids_.size() == scales_.size()) &&
+         std::adjacent_find(ids_.begin(), ids_.end(),
+                            std::greater_equal<int_t>()) == ids_.end();
+}
+
+size_t QuantizedRows::memory_bytes() const noexcept {
+  return ids_.capacity() * sizeof(int_t) + codes_.capacity() * sizeof(int8_t) +
+         scales_.capacity() * sizeof(float);
+}
+
+void QuantizedRows::Init(int col) {
+  col_ = col;
+  ids_.clear();
+  codes_.clear();
+  scales_.clear();
+}
+
+void QuantizedRows::Reserve(size_t size, bool with_id) {
+  if (with_id) {
+    ids_.reserve(size);
+  }
+  codes_.reserve(size * col_);
+  scales_.reserve(size);
+}
+
+void QuantizedRows::AddRow(const float* row) {
+  size_t offset = codes_.size();
+  codes_.resize(offset + col_);
+  scales_.emplace_back(QuantizeRow(col_, row, &codes_[offset]));
+}
+
+bool QuantizedRows::AddRow(int_t id, const float* row) {
+  if (!ids_.empty() && id <= ids_.back()) {
+    DXERROR("Need increasing ids, got %" PRIu64 " after %" PRIu64 ".", id,
+            ids_.back());
+    return false;
+  }
+  ids_.emplace_back(id);
+  AddRow(row);
+  return true;
+}
+
+size_t QuantizedRows::Find(int_t id) const noexcept {
+  auto it = std::lower_bound(ids_.begin(), ids_.end(), id);
+  if (it == ids_.end() || *it != id) {
+    return NPOS;
+  }
+  return (size_t)(it - ids_.begin());
+}
+
+void QuantizedRows::GetRow(size_t i, float* row) const noexcept {
+  DequantizeRow(col_, scales_[i], &codes_[i * col_], row);
+}
+
+deepx_core::OutputStream& operator<<(deepx_core::OutputStream& os,
+                                     const QuantizedRows& rows) {
+  os << rows.col_ << rows.ids_ << rows.codes_ << rows.scales_;
+  return os;
+}
+
+deepx_core::InputStream& operator>>(deepx_core::InputStream& is,
+                                    QuantizedRows& rows) {
+  is >> rows.col_ >> rows.ids_ >> rows.codes_ >> rows.scales_;
+  return is;
+}
+
+}  // namespace embedx
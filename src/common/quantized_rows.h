@@ -0,0 +1,69 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <deepx_core/common/stream.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+// QuantizedRows keeps rows of 'col' floats as int8 codes and a scale per row,
+// see QuantizeRow.
+//
+// Rows of embedding tables are keyed by increasing ids and found by binary
+// search, rows of dense weights by their positions. A row takes 'col + 4'
+// bytes, plus 8 bytes of its id if it has one, against '4 * col' bytes of a
+// float row and its hash node in a srm, e.g. 3.6x smaller at col 8 and 3.9x
+// at col 128 against a std::unordered_map of float rows. The quantize suite
+// of bench measures it against a srm.
+class QuantizedRows {
+ private:
+  int col_ = 0;
+  vec_int_t ids_;  // increasing, empty for rows without ids
+  std::vector<int8_t> codes_;
+  std::vector<float> scales_;
+
+ public:
+  static constexpr size_t NPOS = (size_t)-1;
+
+ public:
+  int col() const noexcept { return col_; }
+  size_t size() const noexcept { return scales_.size(); }
+  const vec_int_t& ids() const noexcept { return ids_; }
+  // false if the rows read from a stream are inconsistent
+  bool valid() const noexcept;
+  // bytes of the codes, scales and ids
+  size_t memory_bytes() const noexcept;
+
+  // Clears the rows and sets the number of columns.
+  void Init(int col);
+  void Reserve(size_t size, bool with_id);
+  // Appends a row of 'col()' floats, 'id' must be greater than the last one.
+  void AddRow(const float* row);
+  bool AddRow(int_t id, const float* row);
+
+  // Returns the position of 'id', or NPOS.
+  size_t Find(int_t id) const noexcept;
+  // Dequantizes row 'i' to 'col()' floats of 'row'.
+  void GetRow(size_t i, float* row) const noexcept;
+
+  friend deepx_core::OutputStream& operator<<(deepx_core::OutputStream& os,
+                                              const QuantizedRows& rows);
+  friend deepx_core::InputStream& operator>>(deepx_core::InputStream& is,
+                                             QuantizedRows& rows);
+};
+
+}  // namespace embedx
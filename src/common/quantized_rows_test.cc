@@ -0,0 +1,137 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/common/quantized_rows.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::fill
+#include <cmath>      // std::fabs, std::sqrt
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/common/quantize.h"
+#include "src/common/random.h"
+
+namespace embedx {
+namespace {
+
+double Cosine(const std::vector<float>& x, const std::vector<float>& y) {
+  double xy = 0, xx = 0, yy = 0;
+  for (size_t i = 0; i < x.size(); ++i) {
+    xy += (double)x[i] * y[i];
+    xx += (double)x[i] * x[i];
+    yy += (double)y[i] * y[i];
+  }
+  return xy / std::sqrt(xx * yy);
+}
+
+std::vector<float> RoundTrip(const std::vector<float>& x) {
+  int n = (int)x.size();
+  std::vector<int8_t> codes(n);
+  std::vector<float> y(n);
+  float scale = QuantizeRow(n, x.data(), codes.data());
+  DequantizeRow(n, scale, codes.data(), y.data());
+  return y;
+}
+
+}  // namespace
+
+TEST(QuantizedRowsTest, ZeroRow) {
+  std::vector<float> x(37, 0);
+  std::vector<int8_t> codes(x.size(), 1);
+  float scale = QuantizeRow((int)x.size(), x.data(), codes.data());
+  EXPECT_EQ(scale, 0);
+  EXPECT_EQ(codes, std::vector<int8_t>(x.size(), 0));
+  EXPECT_EQ(RoundTrip(x), x);
+}
+
+TEST(QuantizedRowsTest, Dequantize) {
+  // sizes around the simd widths
+  RandomEngine engine(9527, 0);
+  for (int n : {1, 7, 8, 9, 16, 33, 64, 128}) {
+    std::vector<float> x(n);
+    for (auto& value : x) {
+      value = (float)(engine.NextDouble() * 2 - 1);
+    }
+    std::vector<int8_t> codes(n);
+    std::vector<float> y(n);
+    float scale = QuantizeRow(n, x.data(), codes.data());
+    DequantizeRow(n, scale, codes.data(), y.data());
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ(y[i], scale * codes[i]);
+      EXPECT_LE(std::fabs(y[i] - x[i]), scale / 2 * 1.001f);
+    }
+    EXPECT_GE(Cosine(x, y), 0.999);
+  }
+}
+
+TEST(QuantizedRowsTest, Outlier) {
+  RandomEngine engine(9527, 0);
+  std::vector<float> x(64);
+  for (auto& value : x) {
+    value = (float)(engine.NextDouble() * 0.02 - 0.01);
+  }
+  x[5] = -300;
+  x[40] = 1e-30f;
+
+  auto y = RoundTrip(x);
+  // the outlier keeps its value, the small values are flushed to 0 at most
+  EXPECT_FLOAT_EQ(y[5], -300);
+  EXPECT_EQ(y[40], 0);
+  EXPECT_GE(Cosine(x, y), 0.999);
+}
+
+TEST(QuantizedRowsTest, Rows) {
+  const int COL = 128;
+  const int SIZE = 1000;
+  RandomEngine engine(9527, 0);
+  std::vector<float> values((size_t)SIZE * COL);
+  for (auto& value : values) {
+    value = (float)(engine.NextDouble() * 2 - 1);
+  }
+  // a row of zeros and a row with an outlier
+  std::fill(values.begin(), values.begin() + COL, 0.0f);
+  values[COL + 3] = 1000;
+
+  QuantizedRows rows;
+  rows.Init(COL);
+  rows.Reserve(SIZE, true);
+  for (int i = 0; i < SIZE; ++i) {
+    ASSERT_TRUE(rows.AddRow((int_t)(i * 2 + 1), &values[(size_t)i * COL]));
+  }
+  EXPECT_FALSE(rows.AddRow(1, values.data()));
+  EXPECT_EQ(rows.size(), (size_t)SIZE);
+  EXPECT_TRUE(rows.valid());
+
+  EXPECT_EQ(rows.Find(0), QuantizedRows::NPOS);
+  EXPECT_EQ(rows.Find(2), QuantizedRows::NPOS);
+  EXPECT_EQ(rows.Find(2 * SIZE + 1), QuantizedRows::NPOS);
+  std::vector<float> row(COL);
+  for (int i = 0; i < SIZE; ++i) {
+    size_t pos = rows.Find((int_t)(i * 2 + 1));
+    ASSERT_EQ(pos, (size_t)i);
+    rows.GetRow(pos, row.data());
+    std::vector<float> x(values.begin() + (size_t)i * COL,
+                         values.begin() + (size_t)(i + 1) * COL);
+    if (i == 0) {
+      EXPECT_EQ(row, x);
+    } else {
+      EXPECT_GE(Cosine(x, row), 0.999);
+    }
+  }
+
+  // float rows with their ids take at least 3.5x memory
+  size_t float_bytes = (size_t)SIZE * (COL * sizeof(float) + sizeof(int_t));
+  EXPECT_GE((double)float_bytes / rows.memory_bytes(), 3.5);
+}
+
+}  // namespace embedx
@@ -11,19 +11,217 @@
 
 #include "src/common/random.h"
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <atomic>
 #include <chrono>
-#include <random>  // std::uniform_real_distribution
 
 namespace embedx {
 namespace {
 
-static thread_local std::default_random_engine e(
-    std::chrono::system_clock::now().time_since_epoch().count());
+constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+constexpr int PHILOX_ROUNDS = 10;
+
+// streams of threads seeded on their first draws, apart from the ones given
+// to SeedThreadLocalRandom
+constexpr uint64_t AUTO_STREAM = 1ULL << 63;
+
+std::atomic<uint64_t> global_seed{0};
+std::atomic<uint64_t> next_stream{0};
+
+uint64_t NewStreamSeed() {
+  uint64_t seed = global_seed.load();
+  if (seed == 0) {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    seed = (uint64_t)now.count();
+  }
+  return seed;
+}
+
+struct ThreadEngine {
+  RandomEngine engine;
+  ThreadEngine() : engine(NewStreamSeed(), AUTO_STREAM | next_stream++) {}
+};
 
-static thread_local std::uniform_real_distribution<double> u(0, 1);
+thread_local ThreadEngine thread_engine;
+
+// The rounds of Philox4x32 on RandomEngine::BLOCK_NUM lanes of words.
+#if defined(__AVX2__)
+inline void MulHiLo(__m256i a, __m256i m, __m256i* hi, __m256i* lo) noexcept {
+  // products of the even and the odd words
+  __m256i even = _mm256_mul_epu32(a, m);
+  __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+  *lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+  *hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+void PhiloxRounds(uint32_t k0, uint32_t k1, uint32_t* c0, uint32_t* c1,
+                  uint32_t* c2, uint32_t* c3) noexcept {
+  static_assert(RandomEngine::BLOCK_NUM == 8, "8 lanes of AVX2");
+  const __m256i m0 = _mm256_set1_epi32((int)PHILOX_M0);
+  const __m256i m1 = _mm256_set1_epi32((int)PHILOX_M1);
+  __m256i x0 = _mm256_loadu_si256((const __m256i*)c0);
+  __m256i x1 = _mm256_loadu_si256((const __m256i*)c1);
+  __m256i x2 = _mm256_loadu_si256((const __m256i*)c2);
+  __m256i x3 = _mm256_loadu_si256((const __m256i*)c3);
+  __m256i hi0, lo0, hi1, lo1;
+  for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+    MulHiLo(x0, m0, &hi0, &lo0);
+    MulHiLo(x2, m1, &hi1, &lo1);
+    x0 = _mm256_xor_si256(_mm256_xor_si256(hi1, x1),
+                          _mm256_set1_epi32((int)k0));
+    x2 = _mm256_xor_si256(_mm256_xor_si256(hi0, x3),
+                          _mm256_set1_epi32((int)k1));
+    x1 = lo1;
+    x3 = lo0;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  _mm256_storeu_si256((__m256i*)c0, x0);
+  _mm256_storeu_si256((__m256i*)c1, x1);
+  _mm256_storeu_si256((__m256i*)c2, x2);
+  _mm256_storeu_si256((__m256i*)c3, x3);
+}
+#elif defined(__SSE2__)
+inline void MulHiLo(__m128i a, __m128i m, __m128i* hi, __m128i* lo) noexcept {
+  // products of the even and the odd words
+  const __m128i low_mask = _mm_set_epi32(0, -1, 0, -1);
+  __m128i even = _mm_mul_epu32(a, m);
+  __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+  *lo = _mm_or_si128(_mm_and_si128(even, low_mask), _mm_slli_epi64(odd, 32));
+  *hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(low_mask, odd));
+}
+
+void PhiloxRounds(uint32_t k0, uint32_t k1, uint32_t* c0, uint32_t* c1,
+                  uint32_t* c2, uint32_t* c3) noexcept {
+  static_assert(RandomEngine::BLOCK_NUM % 4 == 0, "4 lanes of SSE2");
+  const __m128i m0 = _mm_set1_epi32((int)PHILOX_M0);
+  const __m128i m1 = _mm_set1_epi32((int)PHILOX_M1);
+  for (int i = 0; i < RandomEngine::BLOCK_NUM; i += 4) {
+    __m128i x0 = _mm_loadu_si128((const __m128i*)(c0 + i));
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(c1 + i));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(c2 + i));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(c3 + i));
+    __m128i hi0, lo0, hi1, lo1;
+    uint32_t rk0 = k0;
+    uint32_t rk1 = k1;
+    for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+      MulHiLo(x0, m0, &hi0, &lo0);
+      MulHiLo(x2, m1, &hi1, &lo1);
+      x0 = _mm_xor_si128(_mm_xor_si128(hi1, x1), _mm_set1_epi32((int)rk0));
+      x2 = _mm_xor_si128(_mm_xor_si128(hi0, x3), _mm_set1_epi32((int)rk1));
+      x1 = lo1;
+      x3 = lo0;
+      rk0 += PHILOX_W0;
+      rk1 += PHILOX_W1;
+    }
+    _mm_storeu_si128((__m128i*)(c0 + i), x0);
+    _mm_storeu_si128((__m128i*)(c1 + i), x1);
+    _mm_storeu_si128((__m128i*)(c2 + i), x2);
+    _mm_storeu_si128((__m128i*)(c3 + i), x3);
+  }
+}
+#else
+void PhiloxRounds(uint32_t k0, uint32_t k1, uint32_t* c0, uint32_t* c1,
+                  uint32_t* c2, uint32_t* c3) noexcept {
+  for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+    for (int i = 0; i < RandomEngine::BLOCK_NUM; ++i) {
+      uint64_t p0 = (uint64_t)PHILOX_M0 * c0[i];
+      uint64_t p1 = (uint64_t)PHILOX_M1 * c2[i];
+      c0[i] = (uint32_t)(p1 >> 32) ^ c1[i] ^ k0;
+      c2[i] = (uint32_t)(p0 >> 32) ^ c3[i] ^ k1;
+      c1[i] = (uint32_t)p1;
+      c3[i] = (uint32_t)p0;
+    }
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+}
+#endif
 
 }  // namespace
 
-double ThreadLocalRandom() { return u(e); }
+constexpr int RandomEngine::BLOCK_NUM;
+constexpr int RandomEngine::BUFFER_SIZE;
+
+void RandomEngine::Seed(uint64_t seed, uint64_t stream) noexcept {
+  key_[0] = (uint32_t)seed;
+  key_[1] = (uint32_t)(seed >> 32);
+  stream_ = stream;
+  counter_ = 0;
+  pos_ = BUFFER_SIZE;
+}
+
+void RandomEngine::Generate(uint64_t counter, uint32_t* out) const noexcept {
+  // one lane per block, the block counter in words 0 and 1 and the stream in
+  // words 2 and 3
+  uint32_t c0[BLOCK_NUM], c1[BLOCK_NUM], c2[BLOCK_NUM], c3[BLOCK_NUM];
+  for (int i = 0; i < BLOCK_NUM; ++i) {
+    uint64_t c = counter + i;
+    c0[i] = (uint32_t)c;
+    c1[i] = (uint32_t)(c >> 32);
+    c2[i] = (uint32_t)stream_;
+    c3[i] = (uint32_t)(stream_ >> 32);
+  }
+
+  PhiloxRounds(key_[0], key_[1], c0, c1, c2, c3);
+
+  for (int i = 0; i < BLOCK_NUM; ++i) {
+    out[4 * i] = c0[i];
+    out[4 * i + 1] = c1[i];
+    out[4 * i + 2] = c2[i];
+    out[4 * i + 3] = c3[i];
+  }
+}
+
+void RandomEngine::Fill(int n, uint32_t* out) noexcept {
+  int i = 0;
+  // what is left in the buffer first, then whole buffers in place
+  for (; i < n && pos_ < BUFFER_SIZE; ++i) {
+    out[i] = buffer_[pos_++];
+  }
+  for (; i + BUFFER_SIZE <= n; i += BUFFER_SIZE) {
+    Generate(counter_, out + i);
+    counter_ += BLOCK_NUM;
+  }
+  for (; i < n; ++i) {
+    out[i] = (*this)();
+  }
+}
+
+void RandomEngine::NextDoubles(int n, double* out) noexcept {
+  uint32_t words[2 * BUFFER_SIZE];
+  for (int i = 0; i < n; i += BUFFER_SIZE) {
+    int m = n - i < BUFFER_SIZE ? n - i : BUFFER_SIZE;
+    Fill(2 * m, words);
+    for (int j = 0; j < m; ++j) {
+      out[i + j] = ToDouble(words[2 * j], words[2 * j + 1]);
+    }
+  }
+}
+
+void RandomEngine::NextInts(uint32_t bound, int n, uint32_t* out) noexcept {
+  Fill(n, out);
+  for (int i = 0; i < n; ++i) {
+    out[i] = ToInt(out[i], bound);
+  }
+}
+
+void SetRandomSeed(uint64_t seed) noexcept { global_seed.store(seed); }
+
+uint64_t GetRandomSeed() noexcept { return global_seed.load(); }
+
+RandomEngine& ThreadLocalRandomEngine() { return thread_engine.engine; }
+
+void SeedThreadLocalRandom(uint64_t stream) {
+  thread_engine.engine.Seed(NewStreamSeed(), stream);
+}
+
+double ThreadLocalRandom() { return thread_engine.engine.NextDouble(); }
 
 }  // namespace embedx
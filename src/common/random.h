@@ -10,9 +10,102 @@
 //
 
 #pragma once
+#include <cstdint>
 
 namespace embedx {
 
+// RandomEngine is Philox4x32-10, a counter-based generator: block i of a
+// stream is a keyed hash of i, so streams of a seed are independent and
+// cheap to create, and every run with the same seed is reproducible.
+//
+// Blocks are generated BLOCK_NUM at a time in lanes the compiler vectorizes,
+// batch draws should prefer NextDoubles and NextInts. It meets the uniform
+// random bit generator requirements, e.g. for std::shuffle.
+class RandomEngine {
+ public:
+  using result_type = uint32_t;
+  static constexpr int BLOCK_NUM = 8;
+  static constexpr int BUFFER_SIZE = BLOCK_NUM * 4;
+
+ private:
+  uint32_t key_[2] = {0, 0};
+  uint64_t stream_ = 0;
+  uint64_t counter_ = 0;  // the next block
+  uint32_t buffer_[BUFFER_SIZE];
+  int pos_ = BUFFER_SIZE;
+
+ public:
+  RandomEngine() = default;
+  RandomEngine(uint64_t seed, uint64_t stream) noexcept {
+    Seed(seed, stream);
+  }
+  void Seed(uint64_t seed, uint64_t stream) noexcept;
+  // Jumps to block 'block' of the stream in O(1).
+  void Seek(uint64_t block) noexcept {
+    counter_ = block;
+    pos_ = BUFFER_SIZE;
+  }
+
+ public:
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept { return UINT32_MAX; }
+
+  result_type operator()() noexcept {
+    if (pos_ == BUFFER_SIZE) {
+      Refill();
+    }
+    return buffer_[pos_++];
+  }
+
+  // uniform in [0, 1) with 53 random bits
+  double NextDouble() noexcept {
+    uint64_t hi = (*this)();
+    uint64_t lo = (*this)();
+    return ToDouble(hi, lo);
+  }
+
+  // uniform in [0, bound) by multiply-shift, the bias is below bound / 2^32
+  uint32_t NextInt(uint32_t bound) noexcept {
+    return ToInt((*this)(), bound);
+  }
+
+ public:
+  void Fill(int n, uint32_t* out) noexcept;
+  void NextDoubles(int n, double* out) noexcept;
+  void NextInts(uint32_t bound, int n, uint32_t* out) noexcept;
+
+ private:
+  static double ToDouble(uint64_t hi, uint64_t lo) noexcept {
+    return (double)((hi << 21) ^ (lo >> 11)) * (1.0 / 9007199254740992.0);
+  }
+  static uint32_t ToInt(uint32_t x, uint32_t bound) noexcept {
+    return (uint32_t)(((uint64_t)x * bound) >> 32);
+  }
+
+  // BLOCK_NUM blocks from 'counter' into 'out'
+  void Generate(uint64_t counter, uint32_t* out) const noexcept;
+  void Refill() noexcept {
+    Generate(counter_, buffer_);
+    counter_ += BLOCK_NUM;
+    pos_ = 0;
+  }
+};
+
+// Seed of the engines of all threads, 0 for seeds from the clock. Call it
+// before any thread draws, e.g. with '--seed' in main.
+void SetRandomSeed(uint64_t seed) noexcept;
+uint64_t GetRandomSeed() noexcept;
+
+// The engine of the calling thread. A thread draws from a stream of the
+// global seed numbered in the order of the first draws of threads.
+RandomEngine& ThreadLocalRandomEngine();
+
+// Restarts the engine of the calling thread at 'stream' of the global seed.
+// Threads whose order of first draws varies between runs, e.g. workers of a
+// trainer, call it with their ids to be reproducible.
+void SeedThreadLocalRandom(uint64_t stream);
+
+// uniform in [0, 1)
 double ThreadLocalRandom();
 
 }  // namespace embedx
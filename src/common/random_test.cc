@@ -0,0 +1,128 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/common/random.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::shuffle
+#include <cstdint>
+#include <numeric>  // std::iota
+#include <thread>
+#include <vector>
+
+namespace embedx {
+
+// known answers of Philox4x32-10 from Random123
+TEST(RandomEngineTest, KnownAnswer) {
+  RandomEngine engine(0, 0);
+  std::vector<uint32_t> block(4);
+  for (auto& word : block) {
+    word = engine();
+  }
+  EXPECT_EQ(block, std::vector<uint32_t>(
+                       {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u}));
+
+  // counter 0x85a308d3243f6a88 of stream 0x0370734413198a2e
+  engine.Seed(0x299f31d0a4093822ULL, 0x0370734413198a2eULL);
+  engine.Seek(0x85a308d3243f6a88ULL);
+  for (auto& word : block) {
+    word = engine();
+  }
+  EXPECT_EQ(block, std::vector<uint32_t>(
+                       {0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u}));
+}
+
+TEST(RandomEngineTest, Batch) {
+  const int N = 1000;
+  RandomEngine engine(9527, 1);
+  RandomEngine batch_engine(9527, 1);
+
+  // batches continue where single draws stop
+  std::vector<uint32_t> words(N), batch_words(N);
+  for (int i = 0; i < 3; ++i) {
+    words[i] = engine();
+    batch_words[i] = batch_engine();
+  }
+  for (int i = 3; i < N; ++i) {
+    words[i] = engine();
+  }
+  batch_engine.Fill(N - 3, batch_words.data() + 3);
+  EXPECT_EQ(words, batch_words);
+
+  std::vector<double> doubles(N);
+  batch_engine.NextDoubles(N, doubles.data());
+  for (int i = 0; i < N; ++i) {
+    double expected = engine.NextDouble();
+    EXPECT_EQ(doubles[i], expected);
+    EXPECT_GE(doubles[i], 0.0);
+    EXPECT_LT(doubles[i], 1.0);
+  }
+
+  std::vector<uint32_t> ints(N);
+  std::vector<int> counts(10, 0);
+  batch_engine.NextInts(10, N, ints.data());
+  for (int i = 0; i < N; ++i) {
+    EXPECT_EQ(ints[i], engine.NextInt(10));
+    ++counts[ints[i]];
+  }
+  for (int count : counts) {
+    EXPECT_GT(count, N / 20);
+  }
+}
+
+TEST(RandomEngineTest, Stream) {
+  RandomEngine a(9527, 0);
+  RandomEngine b(9527, 1);
+  RandomEngine c(9528, 0);
+  int same_ab = 0, same_ac = 0;
+  for (int i = 0; i < 100; ++i) {
+    uint32_t x = a();
+    same_ab += x == b();
+    same_ac += x == c();
+  }
+  EXPECT_LT(same_ab, 2);
+  EXPECT_LT(same_ac, 2);
+
+  // a shuffle is reproducible
+  std::vector<int> x(100), y(100);
+  std::iota(x.begin(), x.end(), 0);
+  std::iota(y.begin(), y.end(), 0);
+  a.Seed(1, 2);
+  b.Seed(1, 2);
+  std::shuffle(x.begin(), x.end(), a);
+  std::shuffle(y.begin(), y.end(), b);
+  EXPECT_EQ(x, y);
+}
+
+TEST(RandomEngineTest, ThreadLocal) {
+  uint64_t seed = GetRandomSeed();
+  SetRandomSeed(9527);
+
+  // threads seeded with the same stream draw the same numbers
+  std::vector<double> x(2);
+  auto draw = [](double* value) {
+    SeedThreadLocalRandom(7);
+    ThreadLocalRandom();
+    *value = ThreadLocalRandom();
+  };
+  std::thread(draw, &x[0]).join();
+  std::thread(draw, &x[1]).join();
+  EXPECT_EQ(x[0], x[1]);
+
+  RandomEngine engine(9527, 7);
+  engine.NextDouble();
+  EXPECT_EQ(x[0], engine.NextDouble());
+
+  SetRandomSeed(seed);
+}
+
+}  // namespace embedx
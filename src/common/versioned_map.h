@@ -0,0 +1,263 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>   // std::unique_ptr
+#include <utility>  // std::move, std::pair
+#include <vector>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+// VersionedMap keeps the versions of values updated at epochs, see
+// EpochManager.
+//
+// Readers look up the newest version not newer than their epoch without any
+// lock. Puts and erases must be serialized by the caller, a version they
+// replace is kept until Reclaim() is called with an epoch no reader is older
+// than. Keys are never removed, an erased key keeps a tombstone version.
+//
+// The versions of the newest epoch may be dropped by Discard() before that
+// epoch is published, e.g. when a batch of updates fails half way.
+template <typename T>
+class VersionedMap {
+ private:
+  struct Version {
+    T value;
+    uint64_t epoch;
+    bool erased;
+    std::atomic<Version*> prev;
+
+    Version(T value, uint64_t epoch, bool erased)
+        : value(std::move(value)),
+          epoch(epoch),
+          erased(erased),
+          prev(nullptr) {}
+  };
+
+  struct Entry {
+    const int_t key;
+    std::atomic<Version*> head;
+
+    explicit Entry(int_t key) : key(key), head(nullptr) {}
+    ~Entry() { DeleteVersions(head.load()); }
+  };
+
+  // open addressing with linear probing
+  struct Table {
+    size_t mask;
+    std::unique_ptr<std::atomic<Entry*>[]> slots;
+
+    explicit Table(size_t capacity)
+        : mask(capacity - 1), slots(new std::atomic<Entry*>[capacity]) {
+      for (size_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr);
+      }
+    }
+  };
+
+  static constexpr size_t INIT_CAPACITY = 16;
+
+  std::atomic<Table*> table_;
+  std::atomic<size_t> size_{0};
+  std::vector<std::unique_ptr<Entry>> entries_;
+
+  // the version replacing others and the epoch they may be freed at
+  std::deque<std::pair<uint64_t, Version*>> retired_versions_;
+  std::deque<std::pair<uint64_t, Table*>> retired_tables_;
+  // discarded versions, freed alone
+  std::deque<std::pair<uint64_t, Version*>> discarded_versions_;
+
+  // the entries pushed at the newest epoch
+  uint64_t staged_epoch_ = 0;
+  std::vector<Entry*> staged_entries_;
+
+ public:
+  VersionedMap() : table_(new Table(INIT_CAPACITY)) {}
+  ~VersionedMap() {
+    Reclaim(UINT64_MAX);
+    delete table_.load();
+  }
+  VersionedMap(const VersionedMap&) = delete;
+  VersionedMap& operator=(const VersionedMap&) = delete;
+
+ public:
+  // number of keys ever put
+  size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+  bool empty() const noexcept { return size() == 0; }
+  size_t retired_size() const noexcept {
+    return retired_versions_.size() + retired_tables_.size() +
+           discarded_versions_.size();
+  }
+
+  // Returns false if 'key' has no version visible at 'epoch'. Otherwise
+  // '*value' is the visible value, or nullptr if it is erased.
+  bool Find(int_t key, uint64_t epoch, const T** value) const {
+    if (empty()) {
+      return false;
+    }
+
+    const Table* table = table_.load(std::memory_order_acquire);
+    const Entry* entry = FindEntry(*table, key);
+    if (entry == nullptr) {
+      return false;
+    }
+
+    const Version* version = entry->head.load(std::memory_order_acquire);
+    for (; version != nullptr;
+         version = version->prev.load(std::memory_order_acquire)) {
+      if (version->epoch <= epoch) {
+        *value = version->erased ? nullptr : &version->value;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Put(int_t key, T value, uint64_t epoch) {
+    Push(key, new Version(std::move(value), epoch, false));
+  }
+
+  void Erase(int_t key, uint64_t epoch) {
+    Push(key, new Version(T(), epoch, true));
+  }
+
+  // Drops the versions put or erased at 'epoch', which must be the newest
+  // epoch and not be published yet. Readers may still be walking through
+  // them, so they are freed by Reclaim once no reader is older than 'epoch'.
+  void Discard(uint64_t epoch) {
+    if (epoch != staged_epoch_) {
+      return;
+    }
+
+    for (Entry* entry : staged_entries_) {
+      Version* head = entry->head.load(std::memory_order_relaxed);
+      while (head != nullptr && head->epoch == epoch) {
+        Version* prev = head->prev.load(std::memory_order_relaxed);
+        entry->head.store(prev, std::memory_order_release);
+        discarded_versions_.emplace_back(epoch, head);
+        head = prev;
+      }
+    }
+    staged_entries_.clear();
+
+    // They are the newest, so they are at the back.
+    while (!retired_versions_.empty() &&
+           retired_versions_.back().first == epoch) {
+      retired_versions_.pop_back();
+    }
+  }
+
+  // Frees what was replaced at or before 'safe_epoch'.
+  void Reclaim(uint64_t safe_epoch) {
+    while (!retired_versions_.empty() &&
+           retired_versions_.front().first <= safe_epoch) {
+      Version* version = retired_versions_.front().second;
+      DeleteVersions(version->prev.exchange(nullptr));
+      retired_versions_.pop_front();
+    }
+
+    while (!retired_tables_.empty() &&
+           retired_tables_.front().first <= safe_epoch) {
+      delete retired_tables_.front().second;
+      retired_tables_.pop_front();
+    }
+
+    while (!discarded_versions_.empty() &&
+           discarded_versions_.front().first <= safe_epoch) {
+      delete discarded_versions_.front().second;
+      discarded_versions_.pop_front();
+    }
+  }
+
+ private:
+  static size_t Hash(int_t key) noexcept {
+    uint64_t h = (uint64_t)key;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (size_t)h;
+  }
+
+  static void DeleteVersions(Version* version) {
+    while (version != nullptr) {
+      Version* prev = version->prev.load();
+      delete version;
+      version = prev;
+    }
+  }
+
+  static const Entry* FindEntry(const Table& table, int_t key) {
+    for (size_t i = Hash(key) & table.mask;; i = (i + 1) & table.mask) {
+      const Entry* entry = table.slots[i].load(std::memory_order_acquire);
+      if (entry == nullptr || entry->key == key) {
+        return entry;
+      }
+    }
+  }
+
+  static void Insert(Table* table, Entry* entry) {
+    size_t i = Hash(entry->key) & table->mask;
+    while (table->slots[i].load(std::memory_order_relaxed) != nullptr) {
+      i = (i + 1) & table->mask;
+    }
+    table->slots[i].store(entry, std::memory_order_release);
+  }
+
+  Entry* FindOrInsertEntry(int_t key, uint64_t epoch) {
+    Table* table = table_.load(std::memory_order_relaxed);
+    auto* entry = const_cast<Entry*>(FindEntry(*table, key));
+    if (entry != nullptr) {
+      return entry;
+    }
+
+    // load factor <= 0.5
+    if ((entries_.size() + 1) * 2 > table->mask + 1) {
+      auto* new_table = new Table((table->mask + 1) * 2);
+      for (const auto& old_entry : entries_) {
+        Insert(new_table, old_entry.get());
+      }
+      table_.store(new_table, std::memory_order_release);
+      retired_tables_.emplace_back(epoch, table);
+      table = new_table;
+    }
+
+    entries_.emplace_back(new Entry(key));
+    entry = entries_.back().get();
+    Insert(table, entry);
+    size_.store(entries_.size(), std::memory_order_release);
+    return entry;
+  }
+
+  void Push(int_t key, Version* version) {
+    Entry* entry = FindOrInsertEntry(key, version->epoch);
+    if (version->epoch != staged_epoch_) {
+      staged_epoch_ = version->epoch;
+      staged_entries_.clear();
+    }
+    staged_entries_.emplace_back(entry);
+    Version* head = entry->head.load(std::memory_order_relaxed);
+    version->prev.store(head, std::memory_order_relaxed);
+    entry->head.store(version, std::memory_order_release);
+    if (head != nullptr) {
+      retired_versions_.emplace_back(version->epoch, version);
+    }
+  }
+};
+
+template <typename T>
+constexpr size_t VersionedMap<T>::INIT_CAPACITY;
+
+}  // namespace embedx
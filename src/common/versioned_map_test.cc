@@ -0,0 +1,165 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/common/versioned_map.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/common/epoch.h"
+
+namespace embedx {
+
+TEST(VersionedMapTest, Find) {
+  VersionedMap<int> map;
+  const int* value = nullptr;
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.Find(1, 10, &value));
+
+  map.Put(1, 100, 2);
+  map.Put(1, 101, 4);
+  map.Erase(1, 6);
+  EXPECT_EQ(map.size(), 1u);
+
+  // older than the first version, fall back
+  EXPECT_FALSE(map.Find(1, 1, &value));
+  ASSERT_TRUE(map.Find(1, 2, &value));
+  EXPECT_EQ(*value, 100);
+  ASSERT_TRUE(map.Find(1, 5, &value));
+  EXPECT_EQ(*value, 101);
+  ASSERT_TRUE(map.Find(1, 6, &value));
+  EXPECT_TRUE(value == nullptr);
+  EXPECT_FALSE(map.Find(2, 6, &value));
+}
+
+TEST(VersionedMapTest, Reclaim) {
+  VersionedMap<vec_int_t> map;
+  const vec_int_t* value = nullptr;
+  map.Put(1, vec_int_t{1}, 1);
+  map.Put(1, vec_int_t{1, 2}, 2);
+  map.Put(1, vec_int_t{1, 2, 3}, 3);
+  EXPECT_EQ(map.retired_size(), 2u);
+
+  // readers at epoch 2 still need the second version
+  map.Reclaim(2);
+  EXPECT_EQ(map.retired_size(), 1u);
+  ASSERT_TRUE(map.Find(1, 2, &value));
+  EXPECT_EQ(value->size(), 2u);
+  ASSERT_TRUE(map.Find(1, 3, &value));
+  EXPECT_EQ(value->size(), 3u);
+
+  map.Reclaim(3);
+  EXPECT_EQ(map.retired_size(), 0u);
+  ASSERT_TRUE(map.Find(1, 3, &value));
+  EXPECT_EQ(value->size(), 3u);
+}
+
+TEST(VersionedMapTest, Grow) {
+  VersionedMap<int> map;
+  const int* value = nullptr;
+  for (int i = 0; i < 1000; ++i) {
+    map.Put((int_t)i, i, 1);
+  }
+  EXPECT_EQ(map.size(), 1000u);
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(map.Find((int_t)i, 1, &value));
+    EXPECT_EQ(*value, i);
+  }
+  map.Reclaim(1);
+  EXPECT_EQ(map.retired_size(), 0u);
+}
+
+TEST(VersionedMapTest, Discard) {
+  VersionedMap<int> map;
+  const int* value = nullptr;
+  map.Put(1, 100, 1);
+  map.Put(1, 101, 2);
+  map.Put(2, 200, 2);
+  map.Erase(1, 2);
+  EXPECT_EQ(map.retired_size(), 2u);
+
+  // an older epoch is left alone
+  map.Discard(1);
+  ASSERT_TRUE(map.Find(1, 2, &value));
+  EXPECT_TRUE(value == nullptr);
+
+  map.Discard(2);
+  ASSERT_TRUE(map.Find(1, 2, &value));
+  EXPECT_EQ(*value, 100);
+  EXPECT_FALSE(map.Find(2, 2, &value));
+  // the 3 discarded versions wait for Reclaim
+  EXPECT_EQ(map.retired_size(), 3u);
+
+  // the epoch is staged again
+  map.Put(2, 201, 2);
+  ASSERT_TRUE(map.Find(2, 2, &value));
+  EXPECT_EQ(*value, 201);
+  map.Reclaim(1);
+  EXPECT_EQ(map.retired_size(), 3u);
+  map.Reclaim(2);
+  EXPECT_EQ(map.retired_size(), 0u);
+  ASSERT_TRUE(map.Find(1, 2, &value));
+  EXPECT_EQ(*value, 100);
+}
+
+// Readers pin an epoch and check that both keys of a batch are from it.
+TEST(VersionedMapTest, ConcurrentReaders) {
+  const int READER_NUM = 4;
+  const int BATCH_NUM = 2000;
+  auto* manager = EpochManager::GetInstance();
+  VersionedMap<vec_int_t> map;
+  std::atomic<bool> stop{false};
+  std::atomic<int> error_num{0};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < READER_NUM; ++i) {
+    readers.emplace_back([&]() {
+      while (!stop.load()) {
+        EpochGuard guard;
+        uint64_t epoch = ReadEpoch();
+        const vec_int_t* a = nullptr;
+        const vec_int_t* b = nullptr;
+        bool has_a = map.Find(1, epoch, &a);
+        bool has_b = map.Find(2, epoch, &b);
+        if (has_a != has_b ||
+            (has_a && ((*a)[0] != (int_t)epoch || (*b)[0] != (int_t)epoch))) {
+          error_num.fetch_add(1);
+        }
+      }
+    });
+  }
+
+  uint64_t first_epoch = manager->epoch() + 1;
+  for (int i = 0; i < BATCH_NUM; ++i) {
+    uint64_t epoch = manager->epoch() + 1;
+    map.Put(1, vec_int_t(100, (int_t)epoch), epoch);
+    // new keys grow the table under the readers
+    map.Put((int_t)(i + 3), vec_int_t(), epoch);
+    map.Put(2, vec_int_t(100, (int_t)epoch), epoch);
+    manager->Publish(epoch);
+    map.Reclaim(manager->SafeEpoch());
+  }
+  stop.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(error_num.load(), 0);
+  EXPECT_GT(manager->epoch(), first_epoch);
+  map.Reclaim(manager->SafeEpoch());
+  EXPECT_EQ(map.retired_size(), 0u);
+}
+
+}  // namespace embedx
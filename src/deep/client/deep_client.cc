@@ -35,20 +35,30 @@ bool DeepClient::LookupItemFeature(const vec_int_t& items,
   return impl_->LookupItemFeature(items, item_feats);
 }
 
+bool DeepClient::LookupItemFreq(const vec_int_t& items,
+                                vec_float_t* probs) const {
+  return impl_->LookupItemFreq(items, probs);
+}
+
 bool DeepClient::SampleInstance(int count, vec_int_t* insts,
                                 std::vector<vecl_t>* vec_labels_list) const {
   return impl_->SampleInstance(count, insts, vec_labels_list);
 }
 
 std::unique_ptr<DeepClient> NewDeepClient(const DeepConfig& config,
-                                          DeepClientEnum type) {
+                                          DeepClientEnum type,
+                                          const GraphClient* graph_client) {
   std::unique_ptr<DeepClient> deep_client;
   switch (type) {
     case DeepClientEnum::LOCAL:
       deep_client.reset(new DeepClient(NewLocalDeepClientImpl(config)));
       break;
+    case DeepClientEnum::DIST:
+      deep_client.reset(
+          new DeepClient(NewDistDeepClientImpl(config, graph_client)));
+      break;
     default:
-      DXERROR("Need type: LOCAL(0), got type: %d.", (int)type);
+      DXERROR("Need type: LOCAL(0) || DIST(1), got type: %d.", (int)type);
       break;
   }
 
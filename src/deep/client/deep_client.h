@@ -19,6 +19,7 @@
 namespace embedx {
 
 class DeepClientImpl;
+class GraphClient;
 
 class DeepClient {
  private:
@@ -38,14 +39,22 @@ class DeepClient {
   bool LookupItemFeature(const vec_int_t& items,
                          std::vector<vec_pair_t>* item_feats) const;
 
+  // Probabilities of 'items' in the frequencies of their namespaces in the
+  // freq file. 0 for items not in it.
+  bool LookupItemFreq(const vec_int_t& items, vec_float_t* probs) const;
+
   // instance sampler
   bool SampleInstance(int count, vec_int_t* insts,
                       std::vector<vecl_t>* vec_labels_list) const;
 };
 
-enum class DeepClientEnum : int { LOCAL = 0 };
+enum class DeepClientEnum : int { LOCAL = 0, DIST = 1 };
 
-std::unique_ptr<DeepClient> NewDeepClient(const DeepConfig& config,
-                                          DeepClientEnum type);
+// A DIST client looks up item features on the graph servers of
+// 'graph_client', which load them from their 'item_feature'. The instance
+// and freq files are still loaded by the client.
+std::unique_ptr<DeepClient> NewDeepClient(
+    const DeepConfig& config, DeepClientEnum type,
+    const GraphClient* graph_client = nullptr);
 
 }  // namespace embedx
@@ -18,6 +18,8 @@
 
 namespace embedx {
 
+class GraphClient;
+
 class DeepClientImpl {
  public:
   virtual ~DeepClientImpl() = default;
@@ -34,6 +36,9 @@ class DeepClientImpl {
   // feature
   virtual bool LookupItemFeature(const vec_int_t& items,
                                  std::vector<vec_pair_t>* item_feats) const = 0;
+  // freq
+  virtual bool LookupItemFreq(const vec_int_t& items,
+                              vec_float_t* probs) const = 0;
   // instance sampler
   virtual bool SampleInstance(int count, vec_int_t* insts,
                               std::vector<vecl_t>* vec_labels_list) const = 0;
@@ -42,4 +47,7 @@ class DeepClientImpl {
 std::unique_ptr<DeepClientImpl> NewLocalDeepClientImpl(
     const DeepConfig& deep_config);
 
+std::unique_ptr<DeepClientImpl> NewDistDeepClientImpl(
+    const DeepConfig& deep_config, const GraphClient* graph_client);
+
 }  // namespace embedx
@@ -0,0 +1,109 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+
+#include <memory>  // std::unique_ptr
+#include <vector>
+
+#include "src/deep/client/deep_client_impl.h"
+#include "src/deep/deep_config.h"
+#include "src/graph/client/graph_client.h"
+
+namespace embedx {
+
+// DistDeepClientImpl looks up item features on the graph servers, each
+// shard holds the items routed to it, so that trainers don't load them all.
+// A batch of items is one request per shard, see DistItemFeatureLookuper.
+//
+// Negative sampling, item frequencies and instance sampling need the whole
+// freq or instance file, they are served from the local files.
+class DistDeepClientImpl : public DeepClientImpl {
+ private:
+  const GraphClient* graph_client_ = nullptr;
+  std::unique_ptr<DeepClientImpl> local_impl_;
+
+ public:
+  explicit DistDeepClientImpl(const GraphClient* graph_client)
+      : graph_client_(graph_client) {}
+  ~DistDeepClientImpl() override = default;
+
+ public:
+  bool Init(const DeepConfig& config) override {
+    if (graph_client_ == nullptr) {
+      DXERROR("Graph_client is nullptr.");
+      return false;
+    }
+    if (!config.item_feature().empty()) {
+      DXERROR("Item features are loaded by graph servers, got item_feature: "
+              "%s.",
+              config.item_feature().c_str());
+      return false;
+    }
+
+    if (!config.inst_file().empty() || !config.freq_file().empty()) {
+      local_impl_ = NewLocalDeepClientImpl(config);
+      if (!local_impl_) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool SharedSampleNegative(
+      int count, const vec_int_t& nodes, const vec_int_t& excluded_nodes,
+      std::vector<vec_int_t>* sampled_nodes_list) const override {
+    return CheckLocal("freq_file") &&
+           local_impl_->SharedSampleNegative(count, nodes, excluded_nodes,
+                                             sampled_nodes_list);
+  }
+
+  bool LookupItemFeature(const vec_int_t& items,
+                         std::vector<vec_pair_t>* item_feats) const override {
+    return graph_client_->LookupItemFeature(items, item_feats);
+  }
+
+  bool LookupItemFreq(const vec_int_t& items,
+                      vec_float_t* probs) const override {
+    return CheckLocal("freq_file") &&
+           local_impl_->LookupItemFreq(items, probs);
+  }
+
+  bool SampleInstance(int count, vec_int_t* insts,
+                      std::vector<vecl_t>* vec_labels_list) const override {
+    return CheckLocal("inst_file") &&
+           local_impl_->SampleInstance(count, insts, vec_labels_list);
+  }
+
+ private:
+  bool CheckLocal(const char* file) const {
+    if (!local_impl_) {
+      DXERROR("Need %s of the deep client.", file);
+      return false;
+    }
+    return true;
+  }
+};
+
+std::unique_ptr<DeepClientImpl> NewDistDeepClientImpl(
+    const DeepConfig& config, const GraphClient* graph_client) {
+  std::unique_ptr<DeepClientImpl> deep_client_impl;
+  deep_client_impl.reset(new DistDeepClientImpl(graph_client));
+
+  if (!deep_client_impl->Init(config)) {
+    DXERROR("Failed to new dist deep client impl.");
+    deep_client_impl.reset();
+  }
+
+  return deep_client_impl;
+}
+
+}  // namespace embedx
@@ -0,0 +1,296 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/common/stream.h>
+#include <deepx_core/dx_log.h>
+#include <deepx_core/ps/tcp_connection.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>  // std::remove
+#include <memory>  // std::unique_ptr
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/deep/client/deep_client.h"
+#include "src/deep/deep_config.h"
+#include "src/graph/client/graph_client.h"
+#include "src/graph/data_op/feature_lookuper_op/dist_item_feature_lookuper.h"
+#include "src/graph/data_op/feature_lookuper_op/item_feature_lookuper.h"
+#include "src/graph/data_op/gs_op_registry.h"
+#include "src/graph/data_op/gs_op_resource.h"
+#include "src/graph/data_op/gs_op_stats.h"
+#include "src/graph/graph_config.h"
+#include "src/graph/in_memory_graph.h"
+#include "src/graph/proto/graph_service_proto.h"
+#include "src/graph/server/dist_graph_server.h"
+
+namespace embedx {
+namespace {
+
+constexpr int SERVER_WAIT_SECONDS = 60;
+
+bool WaitServer(const std::string& success_file) {
+  for (int i = 0; i < SERVER_WAIT_SECONDS; ++i) {
+    if (deepx_core::AutoFileSystem::Exists(success_file)) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+  }
+  return false;
+}
+
+void CloseServer(const std::string& ip_port) {
+  deepx_core::IoContext io;
+  deepx_core::TcpConnection conn(&io);
+  DXCHECK_THROW(conn.ConnectRetry(deepx_core::MakeTcpEndpoint(ip_port), 10,
+                                  1) == 0);
+  DXCHECK_THROW(conn.RpcTerminationNotify() == 0);
+}
+
+}  // namespace
+
+class DistDeepClientImplTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<DeepClient> local_client_;
+
+ protected:
+  const std::string CONTEXT = "testdata/context";
+  const std::string ITEM_FEATURE_FILE = "testdata/context";
+  const int THREAD_NUM = 3;
+  const int SHARD_NUM = 2;
+
+ protected:
+  void SetUp() override {
+    DeepConfig config;
+    config.set_item_feature(ITEM_FEATURE_FILE);
+    config.set_thread_num(THREAD_NUM);
+    local_client_ = NewDeepClient(config, DeepClientEnum::LOCAL);
+    ASSERT_TRUE(local_client_ != nullptr);
+  }
+
+  GraphConfig NewGraphConfig(int shard_num, int shard_id) const {
+    GraphConfig config;
+    config.set_node_graph(CONTEXT);
+    config.set_item_feature(ITEM_FEATURE_FILE);
+    config.set_shard_num(shard_num);
+    config.set_shard_id(shard_id);
+    config.set_thread_num(THREAD_NUM);
+    return config;
+  }
+};
+
+TEST_F(DistDeepClientImplTest, LookupItemFeature) {
+  auto graph_client =
+      NewGraphClient(NewGraphConfig(1, 0), GraphClientEnum::LOCAL);
+  ASSERT_TRUE(graph_client != nullptr);
+  // Without the instance and freq files, the client creates no local deep
+  // ops, the deep op factory is shared by the clients of a process.
+  DeepConfig config;
+  auto dist_client =
+      NewDeepClient(config, DeepClientEnum::DIST, graph_client.get());
+  ASSERT_TRUE(dist_client != nullptr);
+
+  vec_int_t items = {2, 5, 8, 2, 12};
+  std::vector<vec_pair_t> expected_feats, item_feats;
+  ASSERT_TRUE(local_client_->LookupItemFeature(items, &expected_feats));
+  ASSERT_TRUE(dist_client->LookupItemFeature(items, &item_feats));
+  EXPECT_EQ(item_feats, expected_feats);
+
+  vec_int_t failed_items = {2, 13};
+  EXPECT_FALSE(dist_client->LookupItemFeature(failed_items, &item_feats));
+
+  // the instance file is loaded by the client
+  vec_int_t insts;
+  std::vector<vecl_t> vec_labels_list;
+  EXPECT_FALSE(dist_client->SampleInstance(16, &insts, &vec_labels_list));
+}
+
+// A graph server in process, a batch of items is one request.
+TEST_F(DistDeepClientImplTest, GraphServer) {
+  const std::string WORK_DIR = "dist_deep_client_impl_test";
+  const std::string GS_ADDR = "127.0.0.1:61741";
+
+  std::string success_file = WORK_DIR + "/_SUCCESS0";
+  (void)std::remove(success_file.c_str());
+  (void)deepx_core::AutoFileSystem::MakeDir(WORK_DIR);
+  GraphConfig server_config = NewGraphConfig(1, 0);
+  server_config.set_ip_ports(GS_ADDR);
+  server_config.set_success_out(WORK_DIR);
+  DistGraphServer graph_server;
+  std::thread gs_thread([&graph_server, &server_config]() {
+    DXCHECK(graph_server.Start(server_config));
+  });
+  ASSERT_TRUE(WaitServer(success_file));
+
+  GraphConfig client_config;
+  client_config.set_ip_ports(GS_ADDR);
+  auto graph_client = NewGraphClient(client_config, GraphClientEnum::DIST);
+  EXPECT_TRUE(graph_client != nullptr);
+  if (graph_client) {
+    auto dist_client = NewDeepClient(DeepConfig(), DeepClientEnum::DIST,
+                                     graph_client.get());
+    auto* stats = graph_op::GSOpStatsRegistry::GetClientInstance()->Get(
+        RPC_TYPE_ITEM_FEATURE_LOOKUPER, 0);
+    auto before = stats->Snapshot();
+
+    vec_int_t items = {3, 4, 3, 0, 12, 4, 4, 7};
+    std::vector<vec_pair_t> expected_feats, item_feats;
+    EXPECT_TRUE(local_client_->LookupItemFeature(items, &expected_feats));
+    EXPECT_TRUE(dist_client->LookupItemFeature(items, &item_feats));
+    EXPECT_EQ(item_feats, expected_feats);
+
+    auto after = stats->Snapshot();
+    EXPECT_EQ(after.count - before.count, 1u);
+    EXPECT_EQ(after.nodes - before.nodes, 5u);
+
+    items = {1, 13, 1};
+    EXPECT_FALSE(dist_client->LookupItemFeature(items, &item_feats));
+  }
+
+  CloseServer(GS_ADDR);
+  gs_thread.join();
+}
+
+// Two shards in process, the requests of DistItemFeatureLookuper are
+// handled by the ops of the graph servers directly. See TwoGraphServers for
+// the rpc path.
+TEST_F(DistDeepClientImplTest, TwoShards) {
+  std::vector<graph_op::LocalGSOpResource> resources(SHARD_NUM);
+  std::vector<std::unique_ptr<graph_op::LocalGSOp>> ops;
+  auto* creator = graph_op::LocalGSOpRegistry::GetInstance()->Lookup(
+      "ItemFeatureLookuper");
+  ASSERT_TRUE(creator != nullptr);
+  for (int i = 0; i < SHARD_NUM; ++i) {
+    auto graph = InMemoryGraph::Create(NewGraphConfig(SHARD_NUM, i));
+    ASSERT_TRUE(graph != nullptr);
+    // each shard holds its part of the items only
+    EXPECT_LT(graph->item_feature_size(), 13u);
+    resources[i].set_graph(std::move(graph));
+    ops.emplace_back((*creator)());
+    ASSERT_TRUE(ops.back()->Init(&resources[i]));
+  }
+
+  auto lookup = [&](const vec_int_t& items,
+                    std::vector<ItemFeatureLookuperRequest>* requests,
+                    std::vector<vec_pair_t>* item_feats) {
+    graph_op::ItemRouter router;
+    std::vector<int> masks;
+    std::vector<ItemFeatureLookuperResponse> responses(SHARD_NUM);
+    router.Split(
+        items, SHARD_NUM, [](int_t item) { return (int)(item % 2); },
+        requests, &masks);
+    for (int i = 0; i < SHARD_NUM; ++i) {
+      EXPECT_EQ(masks[i], (*requests)[i].items.empty() ? 0 : 1);
+      if (masks[i]) {
+        auto* op = dynamic_cast<graph_op::ItemFeatureLookuper*>(ops[i].get());
+        EXPECT_EQ(op->HandleRpc((*requests)[i], &responses[i]), 0);
+      }
+    }
+    return router.Gather(items, responses, item_feats);
+  };
+
+  // duplicate items are requested once
+  vec_int_t items = {3, 4, 3, 0, 12, 4, 4, 7};
+  std::vector<ItemFeatureLookuperRequest> requests;
+  std::vector<vec_pair_t> expected_feats, item_feats;
+  ASSERT_TRUE(local_client_->LookupItemFeature(items, &expected_feats));
+  ASSERT_TRUE(lookup(items, &requests, &item_feats));
+  EXPECT_EQ(item_feats, expected_feats);
+  EXPECT_EQ(requests[0].items, vec_int_t({4, 0, 12}));
+  EXPECT_EQ(requests[1].items, vec_int_t({3, 7}));
+
+  // items of one shard
+  items = {5, 5};
+  ASSERT_TRUE(local_client_->LookupItemFeature(items, &expected_feats));
+  ASSERT_TRUE(lookup(items, &requests, &item_feats));
+  EXPECT_EQ(item_feats, expected_feats);
+  EXPECT_TRUE(requests[0].items.empty());
+
+  // missing items fail as the local client does
+  items = {1, 13, 2};
+  EXPECT_FALSE(local_client_->LookupItemFeature(items, &expected_feats));
+  EXPECT_FALSE(lookup(items, &requests, &item_feats));
+  items = {14, 14};
+  EXPECT_FALSE(lookup(items, &requests, &item_feats));
+}
+
+// Two graph servers in process, each with its own op factory, a batch of
+// items is one request per shard.
+TEST_F(DistDeepClientImplTest, TwoGraphServers) {
+  const std::string WORK_DIR = "dist_deep_client_impl_test_two";
+  const std::vector<std::string> GS_ADDRS = {"127.0.0.1:61761",
+                                             "127.0.0.1:61762"};
+  const std::string IP_PORTS = GS_ADDRS[0] + ";" + GS_ADDRS[1];
+
+  (void)deepx_core::AutoFileSystem::MakeDir(WORK_DIR);
+  std::vector<std::unique_ptr<DistGraphServer>> graph_servers;
+  std::vector<std::thread> gs_threads;
+  for (int i = 0; i < SHARD_NUM; ++i) {
+    std::string success_file = WORK_DIR + "/_SUCCESS" + std::to_string(i);
+    (void)std::remove(success_file.c_str());
+    GraphConfig server_config = NewGraphConfig(SHARD_NUM, i);
+    server_config.set_ip_ports(IP_PORTS);
+    server_config.set_success_out(WORK_DIR);
+    graph_servers.emplace_back(new DistGraphServer);
+    DistGraphServer* graph_server = graph_servers.back().get();
+    gs_threads.emplace_back([graph_server, server_config]() {
+      DXCHECK(graph_server->Start(server_config));
+    });
+    // the next server inits its ops after this one registered its handlers
+    ASSERT_TRUE(WaitServer(success_file));
+  }
+
+  GraphConfig client_config;
+  client_config.set_ip_ports(IP_PORTS);
+  auto graph_client = NewGraphClient(client_config, GraphClientEnum::DIST);
+  EXPECT_TRUE(graph_client != nullptr);
+  if (graph_client) {
+    auto dist_client = NewDeepClient(DeepConfig(), DeepClientEnum::DIST,
+                                     graph_client.get());
+    auto* registry = graph_op::GSOpStatsRegistry::GetClientInstance();
+    EXPECT_TRUE(registry->Init(SHARD_NUM));
+    std::vector<graph_op::GSOpStats*> stats;
+    std::vector<graph_op::GSOpStatsSnapshot> before;
+    for (int i = 0; i < SHARD_NUM; ++i) {
+      stats.emplace_back(registry->Get(RPC_TYPE_ITEM_FEATURE_LOOKUPER, i));
+      before.emplace_back(stats.back()->Snapshot());
+    }
+
+    // items of both shards, every shard answers from its own part
+    vec_int_t items = {3, 4, 3, 0, 12, 4, 4, 7};
+    std::vector<vec_pair_t> expected_feats, item_feats;
+    EXPECT_TRUE(local_client_->LookupItemFeature(items, &expected_feats));
+    EXPECT_TRUE(dist_client->LookupItemFeature(items, &item_feats));
+    EXPECT_EQ(item_feats, expected_feats);
+
+    // shard 0 holds {4,0,12}, shard 1 holds {3,7}
+    const uint64_t expected_nodes[] = {3, 2};
+    for (int i = 0; i < SHARD_NUM; ++i) {
+      auto after = stats[i]->Snapshot();
+      EXPECT_EQ(after.count - before[i].count, 1u);
+      // timed by the service time the shard returns
+      EXPECT_EQ(after.timed - before[i].timed, 1u);
+      EXPECT_EQ(after.nodes - before[i].nodes, expected_nodes[i]);
+    }
+
+    items = {1, 13, 2};
+    EXPECT_FALSE(dist_client->LookupItemFeature(items, &item_feats));
+  }
+
+  for (int i = 0; i < SHARD_NUM; ++i) {
+    CloseServer(GS_ADDRS[i]);
+    gs_threads[i].join();
+  }
+}
+
+}  // namespace embedx
@@ -16,6 +16,7 @@
 #include "src/deep/data_op/deep_op_factory.h"
 #include "src/deep/data_op/deep_op_resource.h"
 #include "src/deep/data_op/feature_lookuper_op/item_feature_lookuper.h"
+#include "src/deep/data_op/freq_lookuper_op/item_freq_lookuper.h"
 #include "src/deep/data_op/instance_sampler_op/instance_sampler_op.h"
 #include "src/deep/data_op/negative_sampler_op/shared_negative_sampler.h"
 #include "src/deep/deep_config.h"
@@ -55,7 +56,8 @@ class LocalDeepClientImpl : public DeepClientImpl {
 
       auto negative_sampler_builder = NewSamplerBuilder(
           resource_->sampler_source(), SamplerBuilderEnum::NEGATIVE_SAMPLER,
-          config.negative_sampler_type(), config.thread_num());
+          config.negative_sampler_type(), config.thread_num(),
+          (float_t)config.negative_sampler_power());
       if (!negative_sampler_builder) {
         return false;
       }
@@ -82,6 +84,12 @@ class LocalDeepClientImpl : public DeepClientImpl {
                                                                 item_feats);
   }
 
+  bool LookupItemFreq(const vec_int_t& items,
+                      vec_float_t* probs) const override {
+    auto* op = factory_->LookupOrCreate("ItemFreqLookuper");
+    return dynamic_cast<deep_op::ItemFreqLookuper*>(op)->Run(items, probs);
+  }
+
   bool SampleInstance(int count, vec_int_t* insts,
                       std::vector<vecl_t>* vec_labels_list) const override {
     auto* op = factory_->LookupOrCreate("InstanceSampler");
@@ -85,6 +85,16 @@ TEST_F(LocalDeepClientImplTest, LookupItemFeature) {
   }
 }
 
+TEST_F(LocalDeepClientImplTest, LookupItemFreq) {
+  vec_int_t items = {0, 416653778443095, 13};
+  vec_float_t probs;
+  EXPECT_TRUE(deep_client_->LookupItemFreq(items, &probs));
+  ASSERT_EQ(probs.size(), 3u);
+  EXPECT_FLOAT_EQ(probs[0], 1.0 / 13);
+  EXPECT_FLOAT_EQ(probs[1], 3.0 / 39);
+  EXPECT_EQ(probs[2], 0);
+}
+
 TEST_F(LocalDeepClientImplTest, SampleInstance) {
   int count = 16;  // all test instances
   vec_int_t insts;
@@ -0,0 +1,37 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/deep/data_op/freq_lookuper_op/item_freq_lookuper.h"
+
+#include <deepx_core/dx_log.h>
+
+#include "src/deep/data_op/deep_op_registry.h"
+
+namespace embedx {
+namespace deep_op {
+
+bool ItemFreqLookuper::Run(const vec_int_t& items, vec_float_t* probs) const {
+  if (!freq_table_) {
+    DXERROR("Failed to lookup item freq, please specify the freq file.");
+    return false;
+  }
+
+  probs->resize(items.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    (*probs)[i] = freq_table_->Prob(items[i]);
+  }
+  return true;
+}
+
+REGISTER_LOCAL_DEEP_OP("ItemFreqLookuper", ItemFreqLookuper);
+
+}  // namespace deep_op
+}  // namespace embedx
@@ -0,0 +1,45 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <memory>  // std::unique_ptr
+
+#include "src/common/data_types.h"
+#include "src/deep/data_op/deep_op.h"
+#include "src/deep/data_op/deep_op_resource.h"
+#include "src/sampler/freq_table.h"
+
+namespace embedx {
+namespace deep_op {
+
+class ItemFreqLookuper : public LocalDeepOp {
+ private:
+  std::unique_ptr<FreqTable> freq_table_;
+
+ public:
+  ~ItemFreqLookuper() override = default;
+
+ public:
+  bool Run(const vec_int_t& items, vec_float_t* probs) const;
+
+ private:
+  bool Init(const LocalDeepOpResource* resource) override {
+    // the freq file is optional
+    if (resource->sampler_source() == nullptr) {
+      return true;
+    }
+    freq_table_ = FreqTable::Create(resource->sampler_source());
+    return freq_table_ != nullptr;
+  }
+};
+
+}  // namespace deep_op
+}  // namespace embedx
@@ -22,6 +22,7 @@ class DeepConfig {
   std::string freq_file_;
 
   int negative_sampler_type_ = 0;
+  double negative_sampler_power_ = 0.75;
   int thread_num_ = 1;
 
  public:
@@ -31,6 +32,9 @@ class DeepConfig {
   const std::string& freq_file() const noexcept { return freq_file_; }
 
   int negative_sampler_type() const noexcept { return negative_sampler_type_; }
+  double negative_sampler_power() const noexcept {
+    return negative_sampler_power_;
+  }
   int thread_num() const noexcept { return thread_num_; }
 
  public:
@@ -46,6 +50,9 @@ class DeepConfig {
   void set_negative_sampler_type(int type) noexcept {
     negative_sampler_type_ = type;
   }
+  void set_negative_sampler_power(double power) noexcept {
+    negative_sampler_power_ = power;
+  }
 
   // performance
   void set_thread_num(int thread_num) noexcept { thread_num_ = thread_num; }
@@ -31,8 +31,9 @@ bool CacheNodeBuilder::RandomCache(const vec_int_t& nodes, int thread_id) {
             (int)(nodes.size() * cache_thld_));
     return false;
   }
+  auto& engine = ThreadLocalRandomEngine();
   for (auto& node : nodes) {
-    if (ThreadLocalRandom() < cache_thld_) {
+    if (engine.NextDouble() < cache_thld_) {
       std::lock_guard<std::mutex> guard(mtx_);
       nodes_.emplace_back(node);
     }
@@ -10,7 +10,7 @@
 //
 
 #include <deepx_core/dx_log.h>
-#include <deepx_core/ps/rpc_client.h>
+#include <deepx_core/ps/tcp_connection.h>
 
 #include <memory>  // std::unique_ptr
 #include <vector>
@@ -20,9 +20,13 @@
 #include "src/graph/client/resource_post_initializer.h"
 #include "src/graph/client/rpc_connector.h"
 #include "src/graph/data_op/context_lookuper_op/dist_context_lookuper.h"
+#include "src/graph/data_op/feature_lookuper_op/dist_edge_feature_lookuper.h"
 #include "src/graph/data_op/feature_lookuper_op/dist_feature_lookuper.h"
+#include "src/graph/data_op/feature_lookuper_op/dist_item_feature_lookuper.h"
 #include "src/graph/data_op/feature_lookuper_op/dist_neighbor_feature_lookuper.h"
 #include "src/graph/data_op/feature_lookuper_op/dist_node_feature_lookuper.h"
+#include "src/graph/data_op/freq_lookuper_op/dist_node_freq_lookuper.h"
+#include "src/graph/data_op/graph_updater_op/dist_graph_updater.h"
 #include "src/graph/data_op/gs_op_factory.h"
 #include "src/graph/data_op/gs_op_resource.h"
 #include "src/graph/data_op/negative_sampler_op/dist_indep_negative_sampler.h"
@@ -45,40 +49,68 @@ struct DistGraphClientTypes {
   using FeatureLookuper = graph_op::DistFeatureLookuper;
   using NodeFeatureLookuper = graph_op::DistNodeFeatureLookuper;
   using NeighborFeatureLookuper = graph_op::DistNeighborFeatureLookuper;
+  using EdgeFeatureLookuper = graph_op::DistEdgeFeatureLookuper;
+  using ItemFeatureLookuper = graph_op::DistItemFeatureLookuper;
+  using NodeFreqLookuper = graph_op::DistNodeFreqLookuper;
   using ContextLookuper = graph_op::DistContextLookuper;
 };
 
 }  // namespace
 
 class DistGraphClientImpl : public GraphClientImplBase<DistGraphClientTypes> {
+ private:
+  graph_op::DistGraphUpdater* graph_updater_ = nullptr;
+
  public:
   bool Init(const GraphConfig& config) {
     resource_.reset(new graph_op::DistGSOpResource);
 
-    std::vector<deepx_core::TcpEndpoint> endpoints =
-        deepx_core::MakeTcpEndpoints(config.ip_ports());
-    auto rpc_connector = NewRpcConnector();
-    if (!rpc_connector->Connect(endpoints)) {
+    std::vector<vec_str_t> replica_ip_ports;
+    if (!SplitReplicaIpPorts(config.ip_ports(), &replica_ip_ports)) {
+      DXERROR("Invalid graph server address: %s.", config.ip_ports().c_str());
       return false;
     }
-    resource_->set_rpc_connector(std::move(rpc_connector));
 
-    int shard_num = (int)endpoints.size();
-    if (shard_num <= 0) {
-      DXERROR("Number of shard: %d must be greater than 0.", shard_num);
+    std::vector<RpcConnector::endpoints_t> replica_endpoints;
+    for (const auto& ip_ports : replica_ip_ports) {
+      replica_endpoints.emplace_back();
+      for (const auto& ip_port : ip_ports) {
+        replica_endpoints.back().emplace_back(
+            deepx_core::MakeTcpEndpoint(ip_port));
+      }
+    }
+
+    auto rpc_connector = NewRpcConnector();
+    // threads of the client call on lanes of their own
+    if (!rpc_connector->Connect(replica_endpoints, config.hedge_percentile(),
+                                (uint64_t)config.hedge_min_delay_us(),
+                                config.thread_num())) {
       return false;
     }
-    DXINFO("Number of shard is: %d.", shard_num);
+
+    int shard_num = rpc_connector->shard_num();
+    DXINFO("Number of shard is: %d, number of lane is: %d.", shard_num,
+           rpc_connector->lane_num());
+    resource_->set_rpc_connector(std::move(rpc_connector));
 
     // op factory init
     factory_ = graph_op::DistGSOpFactory::GetInstance();
-    if (!factory_->Init(resource_.get(), shard_num)) {
+    if (!factory_->Init(resource_.get(), shard_num) || !InitOps() ||
+        !ResolveOp("GraphUpdater", &graph_updater_)) {
       return false;
     }
 
-    return PostInitCacheStorage(resource_.get()) &&
+    return PostInitPartitioner(shard_num, resource_.get()) &&
+           PostInitCacheStorage(resource_.get()) &&
            PostInitServerDistribution(shard_num, resource_.get());
   }
+
+ public:
+  bool UpdateEdges(const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+                   const vec_float_t& weights,
+                   const vecl_t& ops) const override {
+    return graph_updater_->Run(src_nodes, dst_nodes, weights, ops);
+  }
 };
 
 std::unique_ptr<GraphClientImpl> NewDistGraphClientImpl(
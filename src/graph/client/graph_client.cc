@@ -16,6 +16,7 @@
 #include <utility>  // std::move
 
 #include "src/graph/client/graph_client_impl.h"
+#include "src/sampler/layerwise_sampler.h"
 
 namespace embedx {
 
@@ -49,7 +50,29 @@ bool GraphClient::StaticTraverse(const vec_int_t& cur_nodes,
 bool GraphClient::RandomSampleNeighbor(
     int count, const vec_int_t& nodes,
     std::vector<vec_int_t>* neighbor_nodes_list) const {
-  return impl_->RandomSampleNeighbor(count, nodes, neighbor_nodes_list);
+  return impl_->RandomSampleNeighbor(count, nodes, TimeWindow(),
+                                     neighbor_nodes_list);
+}
+
+bool GraphClient::RandomSampleNeighbor(
+    int count, const vec_int_t& nodes, const TimeWindow& time_window,
+    std::vector<vec_int_t>* neighbor_nodes_list) const {
+  return impl_->RandomSampleNeighbor(count, nodes, time_window,
+                                     neighbor_nodes_list);
+}
+
+bool GraphClient::LayerwiseSampleNeighbor(
+    int budget, const vec_int_t& nodes, vec_int_t* sampled_nodes,
+    std::vector<vec_pair_t>* adjs) const {
+  // A layer draws at most 'budget' candidates, so the contexts of hubs are
+  // cut to 'budget' drawn neighbors by the graph servers. The rows of the
+  // frontier become unbiased estimates, and a response is at most 'budget'
+  // neighbors a node instead of whole neighbor lists.
+  std::vector<vec_pair_t> contexts;
+  if (!impl_->LookupContext(nodes, budget, &contexts)) {
+    return false;
+  }
+  return LayerwiseSample(budget, contexts, sampled_nodes, adjs);
 }
 
 bool GraphClient::LookupFeature(const vec_int_t& nodes,
@@ -68,9 +91,32 @@ bool GraphClient::LookupNeighborFeature(
   return impl_->LookupNeighborFeature(nodes, neigh_feats);
 }
 
+bool GraphClient::LookupEdgeFeature(const vec_int_t& src_nodes,
+                                    const vec_int_t& dst_nodes,
+                                    std::vector<vec_pair_t>* edge_feats) const {
+  return impl_->LookupEdgeFeature(src_nodes, dst_nodes, edge_feats);
+}
+
+bool GraphClient::LookupItemFeature(const vec_int_t& items,
+                                    std::vector<vec_pair_t>* item_feats) const {
+  return impl_->LookupItemFeature(items, item_feats);
+}
+
+bool GraphClient::LookupNodeFreq(const vec_int_t& nodes,
+                                 vec_float_t* probs) const {
+  return impl_->LookupNodeFreq(nodes, probs);
+}
+
 bool GraphClient::LookupContext(const vec_int_t& nodes,
                                 std::vector<vec_pair_t>* contexts) const {
-  return impl_->LookupContext(nodes, contexts);
+  return impl_->LookupContext(nodes, 0, contexts);
+}
+
+bool GraphClient::UpdateEdges(const vec_int_t& src_nodes,
+                              const vec_int_t& dst_nodes,
+                              const vec_float_t& weights,
+                              const vecl_t& ops) const {
+  return impl_->UpdateEdges(src_nodes, dst_nodes, weights, ops);
 }
 
 std::unique_ptr<GraphClient> NewGraphClient(const GraphConfig& config,
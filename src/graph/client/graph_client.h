@@ -16,6 +16,7 @@
 #include "src/common/data_types.h"
 #include "src/graph/graph_config.h"
 #include "src/sampler/random_walker_data_types.h"
+#include "src/sampler/time_window.h"
 
 namespace embedx {
 
@@ -40,6 +41,19 @@ class GraphClient {
   // neighbor sampler
   bool RandomSampleNeighbor(int count, const vec_int_t& nodes,
                             std::vector<vec_int_t>* neighbor_nodes_list) const;
+  // samples among the edges in 'time_window' of temporal contexts
+  bool RandomSampleNeighbor(int count, const vec_int_t& nodes,
+                            const TimeWindow& time_window,
+                            std::vector<vec_int_t>* neighbor_nodes_list) const;
+  // Samples at most 'budget' nodes among the neighbors of 'nodes' as one
+  // layer, see LayerwiseSample. 'adjs[i]' are the sampled neighbors of
+  // 'nodes[i]' with their weights.
+  //
+  // Graph servers send at most 'budget' neighbors of a node, longer contexts
+  // are drawn by weight, see Context::Lookup.
+  bool LayerwiseSampleNeighbor(int budget, const vec_int_t& nodes,
+                               vec_int_t* sampled_nodes,
+                               std::vector<vec_pair_t>* adjs) const;
 
   // random walker
   bool StaticTraverse(const vec_int_t& cur_nodes,
@@ -57,10 +71,28 @@ class GraphClient {
 
   bool LookupNeighborFeature(const vec_int_t& nodes,
                              std::vector<vec_pair_t>* neigh_feats) const;
+  // Features of the edges 'src_nodes[i]' -> 'dst_nodes[i]', an edge without
+  // features gets an empty feature.
+  bool LookupEdgeFeature(const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+                         std::vector<vec_pair_t>* edge_feats) const;
+  // Features of the items of deep models loaded from 'item_feature', fails
+  // on an item without features. Duplicate items are looked up once.
+  bool LookupItemFeature(const vec_int_t& items,
+                         std::vector<vec_pair_t>* item_feats) const;
+
+  // Probabilities of 'nodes' in the frequencies of their namespaces, the ones
+  // negative samplers are built from. 0 for nodes not in the graph.
+  bool LookupNodeFreq(const vec_int_t& nodes, vec_float_t* probs) const;
 
   // context
   bool LookupContext(const vec_int_t& nodes,
                      std::vector<vec_pair_t>* contexts) const;
+
+  // Updates the edges 'src_nodes[i]' -> 'dst_nodes[i]' of graph servers, see
+  // EdgeUpdateEnum for 'ops'. Updates are idempotent, a failed call can be
+  // retried. Local graph clients don't support it.
+  bool UpdateEdges(const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+                   const vec_float_t& weights, const vecl_t& ops) const;
 };
 
 enum class GraphClientEnum : int { LOCAL = 0, DIST = 1 };
@@ -10,12 +10,17 @@
 //
 
 #pragma once
+#include <deepx_core/dx_log.h>
+
 #include <memory>  // std::unique_ptr
+#include <mutex>   // std::once_flag
+#include <string>
 #include <vector>
 
 #include "src/common/data_types.h"
 #include "src/graph/graph_config.h"
 #include "src/sampler/random_walker_data_types.h"
+#include "src/sampler/time_window.h"
 
 namespace embedx {
 
@@ -34,7 +39,7 @@ class GraphClientImpl {
 
   // neighbor sampler
   virtual bool RandomSampleNeighbor(
-      int count, const vec_int_t& nodes,
+      int count, const vec_int_t& nodes, const TimeWindow& time_window,
       std::vector<vec_int_t>* neighbor_nodes_list) const = 0;
 
   // random walker
@@ -54,17 +59,59 @@ class GraphClientImpl {
   virtual bool LookupNeighborFeature(
       const vec_int_t& nodes, std::vector<vec_pair_t>* neigh_feats) const = 0;
 
-  // context
-  virtual bool LookupContext(const vec_int_t& nodes,
+  virtual bool LookupEdgeFeature(
+      const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+      std::vector<vec_pair_t>* edge_feats) const = 0;
+
+  virtual bool LookupItemFeature(const vec_int_t& items,
+                                 std::vector<vec_pair_t>* item_feats) const = 0;
+
+  // freq
+  virtual bool LookupNodeFreq(const vec_int_t& nodes,
+                              vec_float_t* probs) const = 0;
+
+  // context, at most 'max_size' neighbors each, 0 for all
+  virtual bool LookupContext(const vec_int_t& nodes, int max_size,
                              std::vector<vec_pair_t>* contexts) const = 0;
+
+  // update
+  virtual bool UpdateEdges(const vec_int_t& src_nodes,
+                           const vec_int_t& dst_nodes,
+                           const vec_float_t& weights,
+                           const vecl_t& ops) const = 0;
 };
 
+// The ops are resolved once by InitOps, the calls run them without the
+// factory, so they take no lock and do no lookup.
 template <typename GraphClientTypes>
 class GraphClientImplBase : public GraphClientImpl {
  protected:
   std::unique_ptr<typename GraphClientTypes::Resource> resource_;
   typename GraphClientTypes::Factory* factory_;
 
+  typename GraphClientTypes::SharedNegativeSampler* shared_negative_sampler_ =
+      nullptr;
+  typename GraphClientTypes::IndepNegativeSampler* indep_negative_sampler_ =
+      nullptr;
+  typename GraphClientTypes::RandomNeighborSampler* random_neighbor_sampler_ =
+      nullptr;
+  typename GraphClientTypes::StaticRandomWalker* static_random_walker_ =
+      nullptr;
+  typename GraphClientTypes::FeatureLookuper* feature_lookuper_ = nullptr;
+  typename GraphClientTypes::NodeFeatureLookuper* node_feature_lookuper_ =
+      nullptr;
+  typename GraphClientTypes::NeighborFeatureLookuper*
+      neighbor_feature_lookuper_ = nullptr;
+  typename GraphClientTypes::EdgeFeatureLookuper* edge_feature_lookuper_ =
+      nullptr;
+  typename GraphClientTypes::ItemFeatureLookuper* item_feature_lookuper_ =
+      nullptr;
+  // resolved on the first lookup, see LookupNodeFreq
+  mutable std::once_flag node_freq_lookuper_flag_;
+  mutable typename GraphClientTypes::NodeFreqLookuper* node_freq_lookuper_ =
+      nullptr;
+  typename GraphClientTypes::ContextLookuper* context_lookuper_ = nullptr;
+
  public:
   ~GraphClientImplBase() override = default;
 
@@ -75,28 +122,25 @@ class GraphClientImplBase : public GraphClientImpl {
   bool SharedSampleNegative(
       int count, const vec_int_t& nodes, const vec_int_t& excluded_nodes,
       std::vector<vec_int_t>* sampled_nodes_list) const override {
-    auto* op = factory_->LookupOrCreate("SharedNegativeSampler");
-    return dynamic_cast<typename GraphClientTypes::SharedNegativeSampler*>(op)
-        ->Run(count, nodes, excluded_nodes, sampled_nodes_list);
+    return shared_negative_sampler_->Run(count, nodes, excluded_nodes,
+                                         sampled_nodes_list);
   }
 
   bool IndepSampleNegative(
       int count, const vec_int_t& nodes, const vec_int_t& excluded_nodes,
       std::vector<vec_int_t>* sampled_nodes_list) const override {
-    auto* op = factory_->LookupOrCreate("IndepNegativeSampler");
-    return dynamic_cast<typename GraphClientTypes::IndepNegativeSampler*>(op)
-        ->Run(count, nodes, excluded_nodes, sampled_nodes_list);
+    return indep_negative_sampler_->Run(count, nodes, excluded_nodes,
+                                        sampled_nodes_list);
   }
 
   /************************************************************************/
   /* Random neighbor sampler */
   /************************************************************************/
   bool RandomSampleNeighbor(
-      int count, const vec_int_t& nodes,
+      int count, const vec_int_t& nodes, const TimeWindow& time_window,
       std::vector<vec_int_t>* neighbor_nodes_list) const override {
-    auto* op = factory_->LookupOrCreate("RandomNeighborSampler");
-    return dynamic_cast<typename GraphClientTypes::RandomNeighborSampler*>(op)
-        ->Run(count, nodes, neighbor_nodes_list);
+    return random_neighbor_sampler_->Run(count, nodes, time_window,
+                                         neighbor_nodes_list);
   }
 
   /************************************************************************/
@@ -106,9 +150,7 @@ class GraphClientImplBase : public GraphClientImpl {
                       const std::vector<int>& walk_lens,
                       const WalkerInfo& walker_info,
                       std::vector<vec_int_t>* seqs) const override {
-    auto* op = factory_->LookupOrCreate("StaticRandomWalker");
-    return dynamic_cast<typename GraphClientTypes::StaticRandomWalker*>(op)
-        ->Run(cur_nodes, walk_lens, walker_info, seqs);
+    return static_random_walker_->Run(cur_nodes, walk_lens, walker_info, seqs);
   }
 
   /************************************************************************/
@@ -117,34 +159,78 @@ class GraphClientImplBase : public GraphClientImpl {
   bool LookupFeature(const vec_int_t& nodes,
                      std::vector<vec_pair_t>* node_feats,
                      std::vector<vec_pair_t>* neigh_feats) const override {
-    auto* op = factory_->LookupOrCreate("FeatureLookuper");
-    return dynamic_cast<typename GraphClientTypes::FeatureLookuper*>(op)->Run(
-        nodes, node_feats, neigh_feats);
+    return feature_lookuper_->Run(nodes, node_feats, neigh_feats);
   }
 
   bool LookupNodeFeature(const vec_int_t& nodes,
                          std::vector<vec_pair_t>* node_feats) const override {
-    auto* op = factory_->LookupOrCreate("NodeFeatureLookuper");
-    return dynamic_cast<typename GraphClientTypes::NodeFeatureLookuper*>(op)
-        ->Run(nodes, node_feats);
+    return node_feature_lookuper_->Run(nodes, node_feats);
   }
 
   bool LookupNeighborFeature(
       const vec_int_t& nodes,
       std::vector<vec_pair_t>* neigh_feats) const override {
-    auto* op = factory_->LookupOrCreate("NeighborFeatureLookuper");
-    return dynamic_cast<typename GraphClientTypes::NeighborFeatureLookuper*>(op)
-        ->Run(nodes, neigh_feats);
+    return neighbor_feature_lookuper_->Run(nodes, neigh_feats);
+  }
+
+  bool LookupEdgeFeature(const vec_int_t& src_nodes,
+                         const vec_int_t& dst_nodes,
+                         std::vector<vec_pair_t>* edge_feats) const override {
+    return edge_feature_lookuper_->Run(src_nodes, dst_nodes, edge_feats);
+  }
+
+  bool LookupItemFeature(const vec_int_t& items,
+                         std::vector<vec_pair_t>* item_feats) const override {
+    return item_feature_lookuper_->Run(items, item_feats);
+  }
+
+  /************************************************************************/
+  /* Freq Lookuper */
+  /************************************************************************/
+  // Only logQ corrected models look up frequencies, the op is created on the
+  // first lookup instead of by InitOps.
+  bool LookupNodeFreq(const vec_int_t& nodes,
+                      vec_float_t* probs) const override {
+    std::call_once(node_freq_lookuper_flag_, [this]() {
+      ResolveOp("NodeFreqLookuper", &node_freq_lookuper_);
+    });
+    if (node_freq_lookuper_ == nullptr) {
+      return false;
+    }
+    return node_freq_lookuper_->Run(nodes, probs);
   }
 
   /************************************************************************/
   /* Context Lookuper */
   /************************************************************************/
-  bool LookupContext(const vec_int_t& nodes,
+  bool LookupContext(const vec_int_t& nodes, int max_size,
                      std::vector<vec_pair_t>* contexts) const override {
-    auto* op = factory_->LookupOrCreate("ContextLookuper");
-    return dynamic_cast<typename GraphClientTypes::ContextLookuper*>(op)->Run(
-        nodes, contexts);
+    return context_lookuper_->Run(nodes, max_size, contexts);
+  }
+
+ protected:
+  // Creates the ops of the calls, after 'factory_' is initialized.
+  bool InitOps() {
+    return ResolveOp("SharedNegativeSampler", &shared_negative_sampler_) &&
+           ResolveOp("IndepNegativeSampler", &indep_negative_sampler_) &&
+           ResolveOp("RandomNeighborSampler", &random_neighbor_sampler_) &&
+           ResolveOp("StaticRandomWalker", &static_random_walker_) &&
+           ResolveOp("FeatureLookuper", &feature_lookuper_) &&
+           ResolveOp("NodeFeatureLookuper", &node_feature_lookuper_) &&
+           ResolveOp("NeighborFeatureLookuper", &neighbor_feature_lookuper_) &&
+           ResolveOp("EdgeFeatureLookuper", &edge_feature_lookuper_) &&
+           ResolveOp("ItemFeatureLookuper", &item_feature_lookuper_) &&
+           ResolveOp("ContextLookuper", &context_lookuper_);
+  }
+
+  template <class Op>
+  bool ResolveOp(const std::string& name, Op** op) const {
+    *op = dynamic_cast<Op*>(factory_->LookupOrCreate(name));
+    if (*op == nullptr) {
+      DXERROR("Op: %s has an unexpected type.", name.c_str());
+      return false;
+    }
+    return true;
   }
 };
 
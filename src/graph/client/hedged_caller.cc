@@ -0,0 +1,210 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/client/hedged_caller.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::max
+#include <chrono>
+#include <utility>  // std::move
+
+namespace embedx {
+
+using ::embedx::graph_op::GSOpStats;
+using ::embedx::graph_op::GSOpTimer;
+
+constexpr uint64_t HedgedCaller::WARMUP_NUM;
+constexpr uint64_t HedgedCaller::REFRESH_NUM;
+
+HedgedCaller::HedgedCaller(int lane_num, int key_num, double percentile,
+                           uint64_t min_delay_us)
+    : lane_num_(lane_num),
+      key_num_(key_num),
+      percentile_(std::min(percentile, 100.0)),
+      min_delay_us_(min_delay_us) {
+  DXCHECK(lane_num_ > 0);
+  DXCHECK(key_num_ > 0);
+
+  lanes_.reset(new Lane[lane_num_]);
+  keys_.reset(new KeyStats[key_num_]);
+  for (int i = 0; i < key_num_; ++i) {
+    keys_[i].stats.reset(new GSOpStats(lane_num_));
+  }
+
+  if (hedge()) {
+    for (int i = 0; i < lane_num_; ++i) {
+      lanes_[i].thread = std::thread(&HedgedCaller::Work, this, i);
+    }
+  }
+}
+
+HedgedCaller::~HedgedCaller() {
+  {
+    std::unique_lock<std::mutex> guard(mtx_);
+    stop_ = true;
+  }
+  for (int i = 0; i < lane_num_; ++i) {
+    lanes_[i].cv.notify_all();
+  }
+  // the losers still running are waited for
+  for (int i = 0; i < lane_num_; ++i) {
+    if (lanes_[i].thread.joinable()) {
+      lanes_[i].thread.join();
+    }
+  }
+}
+
+int HedgedCaller::Run(int key, const call_t& call, int* winner) {
+  DXCHECK(0 <= key && key < key_num_);
+  call_num_.fetch_add(1, std::memory_order_relaxed);
+
+  if (!hedge()) {
+    int lane = AcquireLane(-1, true);
+    int ret = call(lane, 0);
+    ReleaseLane(lane);
+    *winner = 0;
+    return ret;
+  }
+
+  auto state = std::make_shared<CallState>();
+  int first_lane = AcquireLane(-1, true);
+  Post(first_lane, Task{call, key, 0, state});
+
+  int try_num = 1;
+  uint64_t delay_us = keys_[key].delay_us.load(std::memory_order_relaxed);
+  std::unique_lock<std::mutex> guard(state->mtx);
+  if (delay_us != UINT64_MAX &&
+      !state->cv.wait_for(guard, std::chrono::microseconds(delay_us),
+                          [&state]() { return state->done > 0; })) {
+    guard.unlock();
+    // no idle lane, no hedging
+    int lane = AcquireLane(first_lane, false);
+    if (lane >= 0) {
+      Post(lane, Task{call, key, 1, state});
+      hedge_num_.fetch_add(1, std::memory_order_relaxed);
+      try_num = 2;
+    }
+    guard.lock();
+  }
+
+  state->cv.wait(guard, [&state, try_num]() {
+    return state->winner >= 0 || state->done == try_num;
+  });
+  if (state->winner >= 0) {
+    if (state->winner == 1) {
+      hedge_win_num_.fetch_add(1, std::memory_order_relaxed);
+    }
+    *winner = state->winner;
+    return 0;
+  }
+  *winner = 0;
+  return state->rets[0];
+}
+
+int HedgedCaller::RunOn(int lane, const call_t& call) {
+  DXCHECK(0 <= lane && lane < lane_num_);
+  AcquireLane(lane);
+  int ret = call(lane, 0);
+  ReleaseLane(lane);
+  return ret;
+}
+
+int HedgedCaller::AcquireLane(int excluded, bool wait) {
+  std::unique_lock<std::mutex> guard(mtx_);
+  for (;;) {
+    for (int i = 0; i < lane_num_; ++i) {
+      int lane = (next_lane_ + i) % lane_num_;
+      if (lane != excluded && !lanes_[lane].busy) {
+        lanes_[lane].busy = true;
+        next_lane_ = (lane + 1) % lane_num_;
+        return lane;
+      }
+    }
+    if (!wait) {
+      return -1;
+    }
+    idle_cv_.wait(guard);
+  }
+}
+
+void HedgedCaller::AcquireLane(int lane) {
+  std::unique_lock<std::mutex> guard(mtx_);
+  idle_cv_.wait(guard, [this, lane]() { return !lanes_[lane].busy; });
+  lanes_[lane].busy = true;
+}
+
+void HedgedCaller::ReleaseLane(int lane) {
+  {
+    std::unique_lock<std::mutex> guard(mtx_);
+    lanes_[lane].busy = false;
+  }
+  // RunOn waits for a given lane
+  idle_cv_.notify_all();
+}
+
+void HedgedCaller::Post(int lane, Task task) {
+  {
+    std::unique_lock<std::mutex> guard(mtx_);
+    lanes_[lane].task = std::move(task);
+    lanes_[lane].has_task = true;
+  }
+  lanes_[lane].cv.notify_one();
+}
+
+void HedgedCaller::Work(int lane) {
+  Lane& self = lanes_[lane];
+  for (;;) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> guard(mtx_);
+      self.cv.wait(guard, [this, &self]() { return stop_ || self.has_task; });
+      if (!self.has_task) {
+        return;
+      }
+      task = std::move(self.task);
+      self.has_task = false;
+    }
+
+    GSOpTimer timer;
+    int ret = task.call(lane, task.slot);
+    // latency of the first tries only, hedging must not bias the delay
+    if (task.slot == 0) {
+      Record(task.key, timer.ElapsedUs());
+    }
+
+    {
+      std::unique_lock<std::mutex> guard(task.state->mtx);
+      task.state->rets[task.slot] = ret;
+      task.state->done += 1;
+      if (ret == 0 && task.state->winner < 0) {
+        task.state->winner = task.slot;
+      }
+    }
+    task.state->cv.notify_all();
+    task = Task();
+    ReleaseLane(lane);
+  }
+}
+
+void HedgedCaller::Record(int key, uint64_t latency_us) {
+  KeyStats& key_stats = keys_[key];
+  key_stats.stats->Add(latency_us, 0, 0, 0, false);
+  uint64_t count =
+      key_stats.count.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (count >= WARMUP_NUM && count % REFRESH_NUM == 0) {
+    uint64_t delay_us = std::max(
+        key_stats.stats->Snapshot().Percentile(percentile_), min_delay_us_);
+    key_stats.delay_us.store(delay_us, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace embedx
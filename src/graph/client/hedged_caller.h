@@ -0,0 +1,130 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>  // std::unique_ptr, std::shared_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/graph/data_op/gs_op_stats.h"
+
+namespace embedx {
+
+// HedgedCaller runs calls on lanes, a lane is a set of connections to one
+// replica of every shard and serves one call at a time.
+//
+// Lanes are taken round-robin, so calls are spread over replicas. When
+// hedging is on and a call is slower than the 'percentile'-th latency of its
+// key, it is sent again on another idle lane and the first successful answer
+// wins. The loser keeps its lane until its answer is read, so the connections
+// of a lane never mix up answers.
+class HedgedCaller {
+ public:
+  // 'call(lane, slot)' runs a call on 'lane' and puts the answer in 'slot',
+  // 0 for the first try and 1 for the hedged one.
+  using call_t = std::function<int(int lane, int slot)>;
+
+  // keys with fewer calls than WARMUP_NUM are not hedged
+  static constexpr uint64_t WARMUP_NUM = 64;
+  // the hedge delay of a key is refreshed every REFRESH_NUM calls
+  static constexpr uint64_t REFRESH_NUM = 64;
+
+ private:
+  struct CallState {
+    std::mutex mtx;
+    std::condition_variable cv;
+    int done = 0;
+    int winner = -1;
+    int rets[2] = {-1, -1};
+  };
+
+  struct Task {
+    call_t call;
+    int key;
+    int slot;
+    std::shared_ptr<CallState> state;
+  };
+
+  struct Lane {
+    bool busy = false;
+    bool has_task = false;
+    Task task;
+    std::condition_variable cv;
+    std::thread thread;
+  };
+
+  struct KeyStats {
+    std::unique_ptr<graph_op::GSOpStats> stats;
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> delay_us{UINT64_MAX};
+  };
+
+ private:
+  const int lane_num_;
+  const int key_num_;
+  const double percentile_;
+  const uint64_t min_delay_us_;
+
+  std::mutex mtx_;
+  std::condition_variable idle_cv_;
+  std::unique_ptr<Lane[]> lanes_;
+  int next_lane_ = 0;
+  bool stop_ = false;
+
+  std::unique_ptr<KeyStats[]> keys_;
+  std::atomic<uint64_t> call_num_{0};
+  std::atomic<uint64_t> hedge_num_{0};
+  std::atomic<uint64_t> hedge_win_num_{0};
+
+ public:
+  // Hedging is on when 'percentile' > 0 and there are at least 2 lanes.
+  HedgedCaller(int lane_num, int key_num, double percentile,
+               uint64_t min_delay_us);
+  ~HedgedCaller();
+
+ public:
+  int lane_num() const noexcept { return lane_num_; }
+  bool hedge() const noexcept { return percentile_ > 0 && lane_num_ > 1; }
+
+  // Runs 'call' and returns the return value of the winner, whose slot is
+  // put in 'winner'.
+  //
+  // Without hedging 'call' is run in the calling thread, otherwise it may be
+  // run after Run returns, it must own what it touches.
+  int Run(int key, const call_t& call, int* winner);
+
+  // Runs 'call' on 'lane' in the calling thread once the lane is idle, its
+  // slot is 0.
+  int RunOn(int lane, const call_t& call);
+
+  // current hedge delay of 'key', UINT64_MAX during warmup
+  uint64_t delay_us(int key) const noexcept {
+    return keys_[key].delay_us.load(std::memory_order_relaxed);
+  }
+  uint64_t call_num() const noexcept { return call_num_.load(); }
+  uint64_t hedge_num() const noexcept { return hedge_num_.load(); }
+  uint64_t hedge_win_num() const noexcept { return hedge_win_num_.load(); }
+
+ private:
+  int AcquireLane(int excluded, bool wait);
+  void AcquireLane(int lane);
+  void ReleaseLane(int lane);
+  void Post(int lane, Task task);
+  void Work(int lane);
+  void Record(int key, uint64_t latency_us);
+};
+
+}  // namespace embedx
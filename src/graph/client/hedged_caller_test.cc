@@ -0,0 +1,143 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/client/hedged_caller.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>  // std::shared_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace embedx {
+
+class HedgedCallerTest : public ::testing::Test {
+ protected:
+  static constexpr int LANE_NUM = 4;
+  static constexpr int CALL_NUM = 200;
+  static constexpr int STALL_PERIOD = 50;
+  // long enough that only the stalled tries are hedged
+  static constexpr uint64_t HEDGE_DELAY_US = 100000;
+
+  // A stalled first try waits until the hedged one has answered and then
+  // fails, so the hedged try wins however the threads are scheduled.
+  struct Stall {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool answered = false;
+  };
+
+ protected:
+  static int Serve(const std::shared_ptr<Stall>& stall, int slot) {
+    std::unique_lock<std::mutex> guard(stall->mtx);
+    if (slot == 1) {
+      stall->answered = true;
+      stall->cv.notify_all();
+      return 0;
+    }
+    stall->cv.wait(guard, [&stall]() { return stall->answered; });
+    return 1;
+  }
+};
+
+constexpr int HedgedCallerTest::LANE_NUM;
+constexpr int HedgedCallerTest::CALL_NUM;
+constexpr int HedgedCallerTest::STALL_PERIOD;
+constexpr uint64_t HedgedCallerTest::HEDGE_DELAY_US;
+
+TEST_F(HedgedCallerTest, RoundRobin) {
+  HedgedCaller caller(LANE_NUM, 1, 0, 0);
+  ASSERT_FALSE(caller.hedge());
+
+  std::vector<int> lanes;
+  int winner;
+  for (int i = 0; i < 2 * LANE_NUM; ++i) {
+    EXPECT_EQ(caller.Run(0,
+                         [&lanes](int lane, int slot) {
+                           EXPECT_EQ(slot, 0);
+                           lanes.emplace_back(lane);
+                           return 0;
+                         },
+                         &winner),
+              0);
+    EXPECT_EQ(winner, 0);
+  }
+  EXPECT_EQ(lanes, std::vector<int>({0, 1, 2, 3, 0, 1, 2, 3}));
+  EXPECT_EQ(caller.Run(0, [](int, int) { return 1; }, &winner), 1);
+}
+
+TEST_F(HedgedCallerTest, FirstSuccessWins) {
+  HedgedCaller caller(2, 1, 50, 1000);
+  ASSERT_TRUE(caller.hedge());
+
+  int winner;
+  auto fast = [](int, int) { return 0; };
+  for (uint64_t i = 0; i < HedgedCaller::WARMUP_NUM; ++i) {
+    ASSERT_EQ(caller.Run(0, fast, &winner), 0);
+  }
+  ASSERT_EQ(caller.delay_us(0), 1000u);
+
+  // the first try is slow and fails, the hedged one answers
+  auto slow_first = [](int, int slot) {
+    if (slot == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      return 1;
+    }
+    return 0;
+  };
+  EXPECT_EQ(caller.Run(0, slow_first, &winner), 0);
+  EXPECT_EQ(winner, 1);
+  EXPECT_EQ(caller.hedge_num(), 1u);
+  EXPECT_EQ(caller.hedge_win_num(), 1u);
+
+  // both fail
+  auto slow_fail = [](int, int slot) {
+    if (slot == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return 1;
+  };
+  EXPECT_EQ(caller.Run(0, slow_fail, &winner), 1);
+}
+
+TEST_F(HedgedCallerTest, StalledTries) {
+  HedgedCaller caller(LANE_NUM, 1, 90, HEDGE_DELAY_US);
+  ASSERT_TRUE(caller.hedge());
+
+  int winner;
+  auto fast = [](int, int) { return 0; };
+  for (uint64_t i = 0; i < HedgedCaller::WARMUP_NUM; ++i) {
+    ASSERT_EQ(caller.Run(0, fast, &winner), 0);
+  }
+  ASSERT_EQ(caller.delay_us(0), HEDGE_DELAY_US);
+
+  uint64_t stall_num = 0;
+  for (int i = 0; i < CALL_NUM; ++i) {
+    if (i % STALL_PERIOD != 0) {
+      EXPECT_EQ(caller.Run(0, fast, &winner), 0);
+      EXPECT_EQ(winner, 0);
+      continue;
+    }
+    auto stall = std::make_shared<Stall>();
+    auto stalled = [stall](int, int slot) { return Serve(stall, slot); };
+    EXPECT_EQ(caller.Run(0, stalled, &winner), 0);
+    EXPECT_EQ(winner, 1);
+    ++stall_num;
+  }
+  EXPECT_EQ(caller.hedge_num(), stall_num);
+  EXPECT_EQ(caller.hedge_win_num(), stall_num);
+}
+
+}  // namespace embedx
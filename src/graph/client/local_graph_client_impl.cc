@@ -17,9 +17,12 @@
 #include "src/common/data_types.h"
 #include "src/graph/client/graph_client_impl.h"
 #include "src/graph/data_op/context_lookuper_op/context_lookuper.h"
+#include "src/graph/data_op/feature_lookuper_op/edge_feature_lookuper.h"
 #include "src/graph/data_op/feature_lookuper_op/feature_lookuper.h"
+#include "src/graph/data_op/feature_lookuper_op/item_feature_lookuper.h"
 #include "src/graph/data_op/feature_lookuper_op/neighbor_feature_lookuper.h"
 #include "src/graph/data_op/feature_lookuper_op/node_feature_lookuper.h"
+#include "src/graph/data_op/freq_lookuper_op/node_freq_lookuper.h"
 #include "src/graph/data_op/gs_op_factory.h"
 #include "src/graph/data_op/gs_op_resource.h"
 #include "src/graph/data_op/negative_sampler_op/indep_negative_sampler.h"
@@ -44,6 +47,9 @@ struct LocalGraphClientTypes {
   using FeatureLookuper = graph_op::FeatureLookuper;
   using NodeFeatureLookuper = graph_op::NodeFeatureLookuper;
   using NeighborFeatureLookuper = graph_op::NeighborFeatureLookuper;
+  using EdgeFeatureLookuper = graph_op::EdgeFeatureLookuper;
+  using ItemFeatureLookuper = graph_op::ItemFeatureLookuper;
+  using NodeFreqLookuper = graph_op::NodeFreqLookuper;
   using ContextLookuper = graph_op::ContextLookuper;
 };
 
@@ -71,7 +77,8 @@ class LocalGraphClientImpl : public GraphClientImplBase<LocalGraphClientTypes> {
 
     auto negative_sampler_builder = NewSamplerBuilder(
         resource_->sampler_source(), SamplerBuilderEnum::NEGATIVE_SAMPLER,
-        config.negative_sampler_type(), config.thread_num());
+        config.negative_sampler_type(), config.thread_num(),
+        (float_t)config.negative_sampler_power());
     if (!negative_sampler_builder) {
       return false;
     }
@@ -89,7 +96,16 @@ class LocalGraphClientImpl : public GraphClientImplBase<LocalGraphClientTypes> {
 
     // op factory init
     factory_ = graph_op::LocalGSOpFactory::GetInstance();
-    return factory_->Init(resource_.get());
+    return factory_->Init(resource_.get()) && InitOps();
+  }
+
+ public:
+  bool UpdateEdges(const vec_int_t& /*src_nodes*/,
+                   const vec_int_t& /*dst_nodes*/,
+                   const vec_float_t& /*weights*/,
+                   const vecl_t& /*ops*/) const override {
+    DXERROR("Local graph client doesn't support graph updates.");
+    return false;
   }
 };
 
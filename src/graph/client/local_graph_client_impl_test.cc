@@ -12,7 +12,10 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>  // std::find_if
-#include <memory>     // std::unique_ptr
+#include <atomic>
+#include <memory>  // std::unique_ptr
+#include <thread>
+#include <vector>
 
 #include "src/graph/client/graph_client.h"
 #include "src/graph/graph_config.h"
@@ -32,6 +35,7 @@ class LocalGraphClientImplTest : public ::testing::Test {
 
   const std::string NODE_FEATURE = "testdata/node_feature";
   const std::string NEIGHBOR_FEATURE = "testdata/neigh_feature";
+  const std::string EDGE_FEATURE = "testdata/edge_feature";
 
   const int THREAD_NUM = 3;
   const uint64_t ESTIMATED_SIZE = 1000000;
@@ -42,6 +46,7 @@ class LocalGraphClientImplTest : public ::testing::Test {
     config_.set_node_graph(CONTEXT);
     config_.set_node_feature(NODE_FEATURE);
     config_.set_neighbor_feature(NEIGHBOR_FEATURE);
+    config_.set_edge_feature(EDGE_FEATURE);
 
     config_.set_thread_num(THREAD_NUM);
 
@@ -126,6 +131,29 @@ TEST_F(LocalGraphClientImplTest, RandomSampleNeighbor) {
   }
 }
 
+TEST_F(LocalGraphClientImplTest, LayerwiseSampleNeighbor) {
+  int budget = 4;
+  vec_int_t nodes = {0, 9};
+  vec_int_t sampled_nodes;
+  std::vector<vec_pair_t> adjs;
+
+  vec_int_t candidates = {12, 11, 10, 8, 7, 6};
+  for (int i = 0; i < NUMBER_TEST; ++i) {
+    EXPECT_TRUE(graph_client_->LayerwiseSampleNeighbor(budget, nodes,
+                                                       &sampled_nodes, &adjs));
+    EXPECT_LE((int)sampled_nodes.size(), budget);
+    EXPECT_EQ(nodes.size(), adjs.size());
+    for (const auto& adj : adjs) {
+      for (const auto& pair : adj) {
+        EXPECT_TRUE(std::find(sampled_nodes.begin(), sampled_nodes.end(),
+                              pair.first) != sampled_nodes.end());
+        EXPECT_TRUE(std::find(candidates.begin(), candidates.end(),
+                              pair.first) != candidates.end());
+      }
+    }
+  }
+}
+
 TEST_F(LocalGraphClientImplTest, StaticTraverse) {
   vec_int_t cur_nodes = {0, 9};
   std::vector<int> walk_lens = {3, 3};
@@ -210,6 +238,41 @@ TEST_F(LocalGraphClientImplTest, LookupNeighborFeature) {
   }
 }
 
+TEST_F(LocalGraphClientImplTest, LookupEdgeFeature) {
+  vec_int_t src_nodes = {0, 0, 3, 13};
+  vec_int_t dst_nodes = {12, 11, 1, 0};
+  std::vector<vec_pair_t> edge_feats;
+
+  for (int i = 0; i < NUMBER_TEST; ++i) {
+    EXPECT_TRUE(
+        graph_client_->LookupEdgeFeature(src_nodes, dst_nodes, &edge_feats));
+    ASSERT_EQ(edge_feats.size(), 4u);
+    EXPECT_EQ(edge_feats[0].size(), 2u);
+    // edge(0, 11) has no features, insert an empty feature
+    EXPECT_EQ(edge_feats[1].size(), 1u);
+    EXPECT_EQ(edge_feats[2].size(), 1u);
+    EXPECT_EQ(edge_feats[2][0].first, 4u);
+    // node(13) does not exist in graph, insert an empty feature
+    EXPECT_EQ(edge_feats[3].size(), 1u);
+  }
+
+  dst_nodes.pop_back();
+  EXPECT_FALSE(
+      graph_client_->LookupEdgeFeature(src_nodes, dst_nodes, &edge_feats));
+}
+
+TEST_F(LocalGraphClientImplTest, LookupNodeFreq) {
+  vec_int_t nodes = {0, 5, 13};
+  vec_float_t probs;
+  EXPECT_TRUE(graph_client_->LookupNodeFreq(nodes, &probs));
+  ASSERT_EQ(probs.size(), 3u);
+  // a node counts once as a key and once per appearance in a context
+  EXPECT_FLOAT_EQ(probs[0], 4.0 / 52);
+  EXPECT_FLOAT_EQ(probs[1], 4.0 / 52);
+  // node(13) does not exist in graph
+  EXPECT_EQ(probs[2], 0);
+}
+
 TEST_F(LocalGraphClientImplTest, LookupContext) {
   vec_int_t nodes = {0, 1, 2};
   std::vector<vec_pair_t> contexts;
@@ -224,4 +287,59 @@ TEST_F(LocalGraphClientImplTest, LookupContext) {
   }
 }
 
+// Threads share the ops of the client, each call must see the result of a
+// single threaded call.
+TEST_F(LocalGraphClientImplTest, ConcurrentCalls) {
+  const int CALL_THREAD_NUM = 16;
+  const int CALL_NUM = 200;
+  vec_int_t nodes = {0, 1, 2, 10, 11, 12};
+  std::vector<vec_pair_t> expected_node_feats, expected_contexts;
+  vec_float_t expected_probs;
+  ASSERT_TRUE(graph_client_->LookupNodeFeature(nodes, &expected_node_feats));
+  ASSERT_TRUE(graph_client_->LookupContext(nodes, &expected_contexts));
+  ASSERT_TRUE(graph_client_->LookupNodeFreq(nodes, &expected_probs));
+
+  std::atomic<int> error_num{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < CALL_THREAD_NUM; ++i) {
+    threads.emplace_back([&]() {
+      std::vector<vec_pair_t> node_feats, contexts;
+      vec_float_t probs;
+      std::vector<vec_int_t> sampled_nodes_list;
+      for (int j = 0; j < CALL_NUM; ++j) {
+        // one node calls as in the hot path of a trainer
+        vec_int_t node{nodes[j % nodes.size()]};
+        if (!graph_client_->LookupNodeFeature(node, &node_feats) ||
+            node_feats.size() != 1 ||
+            node_feats[0] != expected_node_feats[j % nodes.size()]) {
+          error_num.fetch_add(1);
+        }
+
+        if (!graph_client_->LookupNodeFeature(nodes, &node_feats) ||
+            node_feats != expected_node_feats ||
+            !graph_client_->LookupContext(nodes, &contexts) ||
+            contexts != expected_contexts ||
+            !graph_client_->LookupNodeFreq(nodes, &probs) ||
+            probs != expected_probs) {
+          error_num.fetch_add(1);
+        }
+
+        if (!graph_client_->SharedSampleNegative(3, nodes, nodes,
+                                                 &sampled_nodes_list) ||
+            sampled_nodes_list.size() != 1 ||
+            sampled_nodes_list[0].size() != 3u ||
+            !graph_client_->RandomSampleNeighbor(2, nodes,
+                                                 &sampled_nodes_list) ||
+            sampled_nodes_list.size() != nodes.size()) {
+          error_num.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(error_num.load(), 0);
+}
+
 }  // namespace embedx
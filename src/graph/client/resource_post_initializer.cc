@@ -13,12 +13,14 @@
 
 #include <deepx_core/dx_log.h>
 
+#include <string>
 #include <vector>
 
 #include "src/graph/cache/cache_storage.h"
 #include "src/graph/data_op/cache_storage_lookuper_op/dist_cache_storage_lookuper.h"
 #include "src/graph/data_op/gs_op_factory.h"
 #include "src/graph/data_op/meta_lookuper_op/dist_meta_lookuper.h"
+#include "src/io/partitioner.h"
 #include "src/sampler/sampling.h"
 
 namespace embedx {
@@ -76,6 +78,33 @@ bool FetchServerDistribution(int shard_num, int* ns_size, vec_float_t* probs) {
 
 }  // namespace
 
+bool PostInitPartitioner(int shard_num, graph_op::DistGSOpResource* resource) {
+  auto* op = graph_op::DistGSOpFactory::GetInstance()->LookupOrCreate(
+      "DistMetaLookuper");
+  DXCHECK(op != nullptr);
+
+  DXINFO("Fetching partition map...");
+  std::string text;
+  if (!dynamic_cast<graph_op::DistMetaLookuper*>(op)->LookupPartition(&text)) {
+    DXERROR("Failed to fetch partition map.");
+    return false;
+  }
+
+  auto partitioner = ParsePartitioner(text);
+  if (!partitioner) {
+    return false;
+  }
+  if (partitioner->shard_num() != shard_num) {
+    DXERROR("Partition map is for %d shards, but there are %d shards.",
+            partitioner->shard_num(), shard_num);
+    return false;
+  }
+  DXINFO("Done, partitioner type: %d, number of hubs: %zu.",
+         (int)partitioner->type(), partitioner->hubs().size());
+  resource->set_partitioner(std::move(partitioner));
+  return true;
+}
+
 bool PostInitCacheStorage(graph_op::DistGSOpResource* resource) {
   auto cache_storage = NewCacheStorage();
   if (!BuildCacheStorage(cache_storage.get())) {
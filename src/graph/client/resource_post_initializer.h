@@ -14,6 +14,8 @@
 
 namespace embedx {
 
+bool PostInitPartitioner(int shard_num, graph_op::DistGSOpResource* resource);
+
 bool PostInitCacheStorage(graph_op::DistGSOpResource* resource);
 
 bool PostInitServerDistribution(int shard_num,
@@ -11,8 +11,79 @@
 
 #include "src/graph/client/rpc_connector.h"
 
+#include <algorithm>  // std::max
+
+#include "src/graph/proto/graph_service_proto.h"
+
 namespace embedx {
 
+bool RpcConnector::Connect(const endpoints_t& endpoints) {
+  std::vector<endpoints_t> replica_endpoints;
+  for (const auto& endpoint : endpoints) {
+    replica_endpoints.emplace_back(1, endpoint);
+  }
+  return Connect(replica_endpoints, 0, 0);
+}
+
+bool RpcConnector::Connect(const std::vector<endpoints_t>& replica_endpoints,
+                           double hedge_percentile,
+                           uint64_t hedge_min_delay_us, int min_lane_num) {
+  if (replica_endpoints.empty()) {
+    DXERROR("Please set ip_ports first.");
+    return false;
+  }
+
+  size_t lane_num = (size_t)std::max(min_lane_num, 1);
+  for (const auto& endpoints : replica_endpoints) {
+    if (endpoints.empty()) {
+      DXERROR("Every shard needs at least one replica.");
+      return false;
+    }
+    lane_num = std::max(lane_num, endpoints.size());
+  }
+
+  Close();
+  shard_num_ = (int)replica_endpoints.size();
+  lanes_.resize(lane_num);
+  for (size_t i = 0; i < lane_num; ++i) {
+    endpoints_t endpoints;
+    for (const auto& replicas : replica_endpoints) {
+      endpoints.emplace_back(replicas[i % replicas.size()]);
+    }
+
+    Lane& lane = lanes_[i];
+    lane.io.reset(new deepx_core::IoContext);
+    lane.conns.reset(new deepx_core::TcpConnections(lane.io.get()));
+    if (lane.conns->ConnectRetry(endpoints) != 0) {
+      DXERROR("Failed to connect lane: %zu.", i);
+      Close();
+      return false;
+    }
+  }
+
+  caller_.reset(new HedgedCaller((int)lane_num, RPC_TYPE_NUM,
+                                 hedge_percentile, hedge_min_delay_us));
+  if (caller_->hedge()) {
+    DXINFO("Hedge requests slower than p%g over %zu lanes.", hedge_percentile,
+           lane_num);
+  }
+  return true;
+}
+
+void RpcConnector::Close() {
+  // wait for the losers of hedged calls first, they use the connections
+  caller_.reset();
+  for (auto& lane : lanes_) {
+    if (lane.conns) {
+      lane.conns->Close();
+      lane.conns.reset();
+    }
+    lane.io.reset();
+  }
+  lanes_.clear();
+  shard_num_ = 0;
+}
+
 std::unique_ptr<RpcConnector> NewRpcConnector() {
   std::unique_ptr<RpcConnector> rpc_connector;
   rpc_connector.reset(new RpcConnector());
@@ -11,48 +11,149 @@
 
 #pragma once
 #include <deepx_core/dx_log.h>
+#include <deepx_core/ps/rpc_client.h>
 #include <deepx_core/ps/tcp_connection.h>
 
-#include <memory>  // std::unique_ptr
+#include <cstdint>
+#include <memory>  // std::unique_ptr, std::shared_ptr
 #include <vector>
 
+#include "src/graph/client/hedged_caller.h"
+
 namespace embedx {
 
+// RpcConnector connects to the replicas of every graph server shard.
+//
+// Lane i holds one connection per shard, to replica 'i % replica number' of
+// the shard, so there are as many lanes as replicas of the largest replica
+// set, or 'min_lane_num' if more threads share the connector. Calls go
+// through HedgedCaller, which spreads them over lanes and hedges the slow
+// ones.
 class RpcConnector {
+ public:
+  using endpoints_t = std::vector<deepx_core::TcpEndpoint>;
+
  private:
-  std::unique_ptr<deepx_core::IoContext> io_;
-  std::unique_ptr<deepx_core::TcpConnections> conns_;
+  struct Lane {
+    std::unique_ptr<deepx_core::IoContext> io;
+    std::unique_ptr<deepx_core::TcpConnections> conns;
+  };
+
+  int shard_num_ = 0;
+  std::vector<Lane> lanes_;
+  std::unique_ptr<HedgedCaller> caller_;
 
  public:
   RpcConnector() = default;
-  ~RpcConnector() = default;
+  ~RpcConnector() { Close(); }
 
  public:
-  deepx_core::TcpConnections* conns() { return conns_.get(); }
+  int shard_num() const noexcept { return shard_num_; }
+  int lane_num() const noexcept { return (int)lanes_.size(); }
+  const HedgedCaller* caller() const noexcept { return caller_.get(); }
 
  public:
-  bool Connect(const std::vector<deepx_core::TcpEndpoint>& endpoints) {
-    if (endpoints.empty()) {
-      DXERROR("Please set ip_ports first.");
-      return false;
-    }
+  // one replica per shard
+  bool Connect(const endpoints_t& endpoints);
+  // 'replica_endpoints[i]' are the replicas of shard i
+  bool Connect(const std::vector<endpoints_t>& replica_endpoints,
+               double hedge_percentile, uint64_t hedge_min_delay_us,
+               int min_lane_num = 1);
+  void Close();
+
+  // WriteRequestReadResponse over a lane.
+  template <class Request, class Response>
+  int Call(int rpc_type, const std::vector<Request>& requests,
+           std::vector<Response>* responses, std::vector<int>* masks);
 
-    Close();
-    io_.reset(new deepx_core::IoContext);
-    conns_.reset(new deepx_core::TcpConnections(io_.get()));
-    return conns_->ConnectRetry(endpoints) == 0;
+  // WriteRequestReadResponse over every lane one by one, so that every
+  // replica gets the requests, e.g. updates. A shard with fewer replicas than
+  // lanes gets them more than once.
+  template <class Request, class Response>
+  int CallAll(int rpc_type, const std::vector<Request>& requests,
+              std::vector<Response>* responses, std::vector<int>* masks);
+};
+
+template <class Request, class Response>
+int RpcConnector::Call(int rpc_type, const std::vector<Request>& requests,
+                       std::vector<Response>* responses,
+                       std::vector<int>* masks) {
+  int winner = 0;
+  if (!caller_->hedge()) {
+    return caller_->Run(
+        rpc_type,
+        [this, rpc_type, &requests, responses, masks](int lane, int) {
+          auto* conns = lanes_[lane].conns.get();
+          return masks == nullptr
+                     ? WriteRequestReadResponse(conns, rpc_type, requests,
+                                                responses)
+                     : WriteRequestReadResponse(conns, rpc_type, requests,
+                                                responses, masks);
+        },
+        &winner);
+  }
+
+  // A loser may outlive this call, so it works on copies. The tries write
+  // their own responses and masks, only those of the winner are returned.
+  struct Context {
+    std::vector<Request> requests;
+    bool has_masks = false;
+    std::vector<int> masks[2];
+    std::vector<Response> responses[2];
+  };
+  auto context = std::make_shared<Context>();
+  context->requests = requests;
+  if (masks != nullptr) {
+    context->has_masks = true;
+    context->masks[0] = *masks;
+    context->masks[1] = *masks;
   }
+  context->responses[0].resize(responses->size());
+  context->responses[1].resize(responses->size());
 
-  void Close() {
-    if (conns_) {
-      conns_->Close();
-      conns_.reset();
+  int ret = caller_->Run(
+      rpc_type,
+      [this, rpc_type, context](int lane, int slot) {
+        auto* conns = lanes_[lane].conns.get();
+        auto* slot_responses = &context->responses[slot];
+        return context->has_masks
+                   ? WriteRequestReadResponse(conns, rpc_type,
+                                              context->requests, slot_responses,
+                                              &context->masks[slot])
+                   : WriteRequestReadResponse(conns, rpc_type,
+                                              context->requests,
+                                              slot_responses);
+      },
+      &winner);
+  if (ret == 0) {
+    responses->swap(context->responses[winner]);
+    if (masks != nullptr) {
+      masks->swap(context->masks[winner]);
     }
-    if (io_) {
-      io_.reset();
+  }
+  return ret;
+}
+
+template <class Request, class Response>
+int RpcConnector::CallAll(int rpc_type, const std::vector<Request>& requests,
+                          std::vector<Response>* responses,
+                          std::vector<int>* masks) {
+  for (int i = 0; i < lane_num(); ++i) {
+    int ret = caller_->RunOn(
+        i, [this, rpc_type, &requests, responses, masks](int lane, int) {
+          auto* conns = lanes_[lane].conns.get();
+          return masks == nullptr
+                     ? WriteRequestReadResponse(conns, rpc_type, requests,
+                                                responses)
+                     : WriteRequestReadResponse(conns, rpc_type, requests,
+                                                responses, masks);
+        });
+    if (ret != 0) {
+      return ret;
     }
   }
-};
+  return 0;
+}
 
 std::unique_ptr<RpcConnector> NewRpcConnector();
 
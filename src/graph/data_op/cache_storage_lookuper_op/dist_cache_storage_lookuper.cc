@@ -38,7 +38,7 @@ int DistCacheStorageLookuper::InitMaxNodePerRpc() const {
   }
 
   auto rpc_type = MetaLookuperRequest::rpc_type();
-  if (WriteRequestReadResponse(conns_, rpc_type, reqs, &resps) != 0) {
+  if (CallRpc(rpc_type, reqs, &resps) != 0) {
     return false;
   }
 
@@ -76,8 +76,7 @@ bool DistCacheStorageLookuper::LookupNode(int max_node_num,
     }
 
     // rpc
-    if (WriteRequestReadResponse(conns_, RPC_TYPE_CACHE_NODE_LOOKUPER, reqs,
-                                 &resps, &masks) != 0) {
+    if (CallRpc(RPC_TYPE_CACHE_NODE_LOOKUPER, reqs, &resps, &masks) != 0) {
       return false;
     }
 
@@ -129,8 +128,7 @@ bool DistCacheStorageLookuper::LookupFeature(const vec_int_t& nodes,
     }
 
     // rpc
-    if (WriteRequestReadResponse(conns_, RPC_TYPE_FEATURE_LOOKUPER, reqs,
-                                 &resps, &masks) != 0) {
+    if (CallRpc(RPC_TYPE_FEATURE_LOOKUPER, reqs, &resps, &masks) != 0) {
       return false;
     }
 
@@ -187,8 +185,7 @@ bool DistCacheStorageLookuper::LookupContext(const vec_int_t& nodes,
     }
 
     // rpc
-    if (WriteRequestReadResponse(conns_, RPC_TYPE_NODE_CONTEXT_LOOKUPER, reqs,
-                                 &resps, &masks) != 0) {
+    if (CallRpc(RPC_TYPE_NODE_CONTEXT_LOOKUPER, reqs, &resps, &masks) != 0) {
       return false;
     }
 
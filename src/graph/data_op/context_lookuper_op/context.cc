@@ -13,8 +13,11 @@
 
 #include <deepx_core/dx_log.h>
 
+#include <algorithm>  // std::sort
 #include <cinttypes>  // PRIu64
 
+#include "src/common/random.h"
+
 namespace embedx {
 namespace graph_op {
 
@@ -41,6 +44,75 @@ bool Context::Lookup(const vec_int_t& nodes,
   return nodes.size() > empty_count;
 }
 
+namespace {
+
+void DrawContext(const vec_pair_t& context, int max_size, vec_pair_t* drawn) {
+  double total = 0;
+  for (const auto& entry : context) {
+    total += entry.second;
+  }
+  if (total <= 0) {
+    *drawn = context;
+    return;
+  }
+
+  // sorted draws are matched to the neighbors in one pass
+  std::vector<double> draws(max_size);
+  ThreadLocalRandomEngine().NextDoubles(max_size, draws.data());
+  std::sort(draws.begin(), draws.end());
+
+  drawn->clear();
+  float_t weight = (float_t)(total / max_size);
+  double cum = 0;
+  size_t k = 0;
+  for (size_t i = 0; i < context.size() && k < draws.size(); ++i) {
+    cum += context[i].second;
+    int count = 0;
+    // the last neighbor takes the draws lost to rounding
+    while (k < draws.size() &&
+           (draws[k] * total < cum || i + 1 == context.size())) {
+      ++count;
+      ++k;
+    }
+    if (count > 0) {
+      drawn->emplace_back(context[i].first, count * weight);
+    }
+  }
+}
+
+}  // namespace
+
+bool Context::Lookup(const vec_int_t& nodes, int max_size,
+                     std::vector<vec_pair_t>* contexts) const {
+  if (max_size <= 0) {
+    return Lookup(nodes, contexts);
+  }
+
+  contexts->clear();
+  contexts->resize(nodes.size());
+
+  size_t empty_count = 0;
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const auto* cur_context = graph_.FindContext(nodes[i]);
+
+    if (cur_context == nullptr) {
+      DXERROR("Couldn't find node: %" PRIu64 " context.", nodes[i]);
+
+      empty_count += 1;
+      continue;
+    }
+
+    if ((int)cur_context->size() <= max_size) {
+      (*contexts)[i] = *cur_context;
+    } else {
+      DrawContext(*cur_context, max_size, &(*contexts)[i]);
+    }
+  }
+
+  return nodes.size() > empty_count;
+}
+
 std::unique_ptr<Context> NewContext(const InMemoryGraph* graph) {
   std::unique_ptr<Context> context;
   context.reset(new Context(graph));
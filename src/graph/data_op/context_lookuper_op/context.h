@@ -28,6 +28,15 @@ class Context {
   explicit Context(const InMemoryGraph* graph) : graph_(*graph) {}
 
   bool Lookup(const vec_int_t& nodes, std::vector<vec_pair_t>* contexts) const;
+
+  // Contexts longer than 'max_size' are replaced by 'max_size' neighbors
+  // drawn with replacement in proportion to the weights, a neighbor drawn
+  // c(u) times has weight c(u) / max_size * the total weight. Normalized by
+  // their total weights, the rows are unbiased estimates of the whole ones,
+  // and no more than 'max_size' neighbors of a hub are sent. 0 for whole
+  // contexts.
+  bool Lookup(const vec_int_t& nodes, int max_size,
+              std::vector<vec_pair_t>* contexts) const;
 };
 
 std::unique_ptr<Context> NewContext(const InMemoryGraph* graph);
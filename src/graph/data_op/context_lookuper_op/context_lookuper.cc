@@ -16,14 +16,14 @@
 namespace embedx {
 namespace graph_op {
 
-bool ContextLookuper::Run(const vec_int_t& nodes,
+bool ContextLookuper::Run(const vec_int_t& nodes, int max_size,
                           std::vector<vec_pair_t>* contexts) const {
-  return context_->Lookup(nodes, contexts);
+  return context_->Lookup(nodes, max_size, contexts);
 }
 
 int ContextLookuper::HandleRpc(const ContextLookuperRequest& req,
                                ContextLookuperResponse* resp) const {
-  if (Run(req.nodes, &resp->contexts)) {
+  if (Run(req.nodes, req.max_size, &resp->contexts)) {
     return 0;
   }
 
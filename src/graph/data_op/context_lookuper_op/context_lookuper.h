@@ -30,7 +30,9 @@ class ContextLookuper : public LocalGSOp {
   ~ContextLookuper() override = default;
 
  public:
-  bool Run(const vec_int_t& nodes, std::vector<vec_pair_t>* contexts) const;
+  // see Context::Lookup
+  bool Run(const vec_int_t& nodes, int max_size,
+           std::vector<vec_pair_t>* contexts) const;
   int HandleRpc(const ContextLookuperRequest& req,
                 ContextLookuperResponse* resp) const;
 
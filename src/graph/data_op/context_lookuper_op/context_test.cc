@@ -13,8 +13,11 @@
 
 #include <gtest/gtest.h>
 
-#include <memory>  // std::unique_ptr
+#include <algorithm>  // std::find_if
+#include <cmath>      // std::lround
+#include <memory>     // std::unique_ptr
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "src/common/data_types.h"
@@ -62,5 +65,53 @@ TEST_F(ContextTest, Lookup) {
   }
 }
 
+TEST_F(ContextTest, Lookup_MaxSize) {
+  graph_ = InMemoryGraph::Create(config_);
+  EXPECT_TRUE(graph_ != nullptr);
+
+  context_ = NewContext(graph_.get());
+  EXPECT_TRUE(context_ != nullptr);
+
+  vec_int_t nodes = {0, 1, 2};
+  std::vector<vec_pair_t> contexts;
+
+  // not longer than 'max_size'
+  EXPECT_TRUE(context_->Lookup(nodes, 3, &contexts));
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    EXPECT_EQ(contexts[i], *graph_->FindContext(nodes[i]));
+  }
+
+  const auto& real_context = *graph_->FindContext(0);
+  float_t total = 0;
+  for (const auto& entry : real_context) {
+    total += entry.second;
+  }
+
+  std::unordered_map<int_t, int> counts;
+  const int DRAW_NUM = 10000;
+  for (int i = 0; i < DRAW_NUM; ++i) {
+    EXPECT_TRUE(context_->Lookup({0}, 2, &contexts));
+    ASSERT_EQ(contexts.size(), 1u);
+    EXPECT_LE(contexts[0].size(), 2u);
+
+    float_t sum = 0;
+    for (const auto& entry : contexts[0]) {
+      auto it = std::find_if(
+          real_context.begin(), real_context.end(),
+          [&entry](const pair_t& real) { return real.first == entry.first; });
+      EXPECT_TRUE(it != real_context.end());
+      sum += entry.second;
+      counts[entry.first] += (int)std::lround(entry.second / total * 2);
+    }
+    EXPECT_NEAR(sum, total, 1e-4);
+  }
+
+  // neighbors are drawn in proportion to the weights
+  for (const auto& entry : real_context) {
+    EXPECT_NEAR((double)counts[entry.first] / (2 * DRAW_NUM),
+                entry.second / total, 0.02);
+  }
+}
+
 }  // namespace graph_op
 }  // namespace embedx
@@ -21,13 +21,16 @@
 namespace embedx {
 namespace graph_op {
 
-bool DistContextLookuper::Run(const vec_int_t& nodes,
+bool DistContextLookuper::Run(const vec_int_t& nodes, int max_size,
                               std::vector<vec_pair_t>* contexts) const {
   // prepare
   std::vector<int> masks(shard_num_, 0);
   std::vector<std::vector<int>> indices(shard_num_);
   std::vector<ContextLookuperRequest> requests(shard_num_);
   std::vector<ContextLookuperResponse> responses(shard_num_);
+  for (auto& request : requests) {
+    request.max_size = max_size;
+  }
 
   // map
   for (size_t i = 0; i < nodes.size(); ++i) {
@@ -40,8 +43,7 @@ bool DistContextLookuper::Run(const vec_int_t& nodes,
 
   // rpc
   auto rpc_type = ContextLookuperRequest::rpc_type();
-  if (WriteRequestReadResponse(conns_, rpc_type, requests, &responses,
-                               &masks) != 0) {
+  if (CallRpc(rpc_type, requests, &responses, &masks) != 0) {
     return false;
   }
 
@@ -23,7 +23,9 @@ class DistContextLookuper : public DistGSOp {
   ~DistContextLookuper() override = default;
 
  public:
-  bool Run(const vec_int_t& nodes, std::vector<vec_pair_t>* contexts) const;
+  // see Context::Lookup
+  bool Run(const vec_int_t& nodes, int max_size,
+           std::vector<vec_pair_t>* contexts) const;
 };
 
 }  // namespace graph_op
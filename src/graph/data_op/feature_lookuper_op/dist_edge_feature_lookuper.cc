@@ -0,0 +1,71 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/data_op/feature_lookuper_op/dist_edge_feature_lookuper.h"
+
+#include <deepx_core/dx_log.h>
+
+#include "src/graph/data_op/gs_op_registry.h"
+#include "src/graph/proto/graph_service_proto.h"
+
+namespace embedx {
+namespace graph_op {
+
+bool DistEdgeFeatureLookuper::Run(const vec_int_t& src_nodes,
+                                  const vec_int_t& dst_nodes,
+                                  std::vector<vec_pair_t>* edge_feats) const {
+  if (src_nodes.size() != dst_nodes.size()) {
+    DXERROR("Need src_nodes.size() == dst_nodes.size(), got %zu vs %zu.",
+            src_nodes.size(), dst_nodes.size());
+    return false;
+  }
+
+  // prepare
+  std::vector<int> masks;
+  std::vector<std::vector<int>> indices_list(shard_num_);
+  std::vector<EdgeFeatureLookuperRequest> requests(shard_num_);
+  std::vector<EdgeFeatureLookuperResponse> responses(shard_num_);
+
+  // map, an edge lives in the shard of its source node
+  masks.assign(shard_num_, 0);
+  for (size_t i = 0; i < src_nodes.size(); ++i) {
+    int shard_id = ModShard(src_nodes[i]);
+    indices_list[shard_id].emplace_back((int)i);
+    requests[shard_id].src_nodes.emplace_back(src_nodes[i]);
+    requests[shard_id].dst_nodes.emplace_back(dst_nodes[i]);
+    masks[shard_id] += 1;
+  }
+
+  // rpc
+  auto rpc_type = EdgeFeatureLookuperRequest::rpc_type();
+  if (CallRpc(rpc_type, requests, &responses, &masks) != 0) {
+    return false;
+  }
+
+  // reduce
+  edge_feats->clear();
+  edge_feats->resize(src_nodes.size());
+  for (int i = 0; i < shard_num_; ++i) {
+    if (masks[i]) {
+      const auto& indices = indices_list[i];
+      auto& remote_feats = responses[i].edge_feats;
+      for (size_t j = 0; j < remote_feats.size(); ++j) {
+        (*edge_feats)[indices[j]].swap(remote_feats[j]);
+      }
+    }
+  }
+  return true;
+}
+
+REGISTER_DIST_GS_OP("EdgeFeatureLookuper", DistEdgeFeatureLookuper);
+
+}  // namespace graph_op
+}  // namespace embedx
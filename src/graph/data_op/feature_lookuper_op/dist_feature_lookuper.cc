@@ -60,8 +60,7 @@ bool DistFeatureLookuper::Run(const vec_int_t& nodes,
 
   // rpc
   auto rpc_type = FeatureLookuperRequest::rpc_type();
-  if (WriteRequestReadResponse(conns_, rpc_type, requests, &responses,
-                               &masks) != 0) {
+  if (CallRpc(rpc_type, requests, &responses, &masks) != 0) {
     return false;
   }
 
@@ -0,0 +1,69 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/data_op/feature_lookuper_op/dist_item_feature_lookuper.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <cinttypes>  // PRIu64
+
+#include "src/graph/data_op/gs_op_registry.h"
+
+namespace embedx {
+namespace graph_op {
+
+bool ItemRouter::Gather(
+    const vec_int_t& items,
+    const std::vector<ItemFeatureLookuperResponse>& responses,
+    std::vector<vec_pair_t>* item_feats) const {
+  item_feats->resize(items.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    const auto& response = responses[routes_[i].first];
+    size_t j = (size_t)routes_[i].second;
+    if (j >= response.found.size() || j >= response.item_feats.size()) {
+      DXERROR("Response of shard: %d has too few items: %zu.",
+              routes_[i].first, response.found.size());
+      return false;
+    }
+    if (!response.found[j]) {
+      DXERROR("Couldn't find item: %" PRIu64 ".", items[i]);
+      return false;
+    }
+    (*item_feats)[i] = response.item_feats[j];
+  }
+  return true;
+}
+
+bool DistItemFeatureLookuper::Run(const vec_int_t& items,
+                                  std::vector<vec_pair_t>* item_feats) const {
+  // map
+  ItemRouter router;
+  std::vector<int> masks;
+  std::vector<ItemFeatureLookuperRequest> requests;
+  std::vector<ItemFeatureLookuperResponse> responses(shard_num_);
+  router.Split(
+      items, shard_num_, [this](int_t item) { return ModShard(item); },
+      &requests, &masks);
+
+  // rpc
+  auto rpc_type = ItemFeatureLookuperRequest::rpc_type();
+  if (CallRpc(rpc_type, requests, &responses, &masks) != 0) {
+    return false;
+  }
+
+  // reduce
+  return router.Gather(items, responses, item_feats);
+}
+
+REGISTER_DIST_GS_OP("ItemFeatureLookuper", DistItemFeatureLookuper);
+
+}  // namespace graph_op
+}  // namespace embedx
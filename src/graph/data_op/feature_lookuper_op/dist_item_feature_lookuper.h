@@ -0,0 +1,84 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <utility>  // std::pair
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/graph/data_op/gs_op.h"
+#include "src/graph/proto/graph_service_proto.h"
+
+namespace embedx {
+namespace graph_op {
+
+// ItemRouter splits the items of a batch over the shards, an item appearing
+// more than once is requested once, and gathers the responses back in the
+// order of the batch.
+class ItemRouter {
+ private:
+  // shard and index in the request of the shard of each item
+  std::vector<std::pair<int, int>> routes_;
+  index_map_t uniq_routes_;
+
+ public:
+  template <class ShardFunc>
+  void Split(const vec_int_t& items, int shard_num, ShardFunc&& shard_func,
+             std::vector<ItemFeatureLookuperRequest>* requests,
+             std::vector<int>* masks);
+
+  // Fails on an item found by no shard, as ItemFeature does.
+  bool Gather(const vec_int_t& items,
+              const std::vector<ItemFeatureLookuperResponse>& responses,
+              std::vector<vec_pair_t>* item_feats) const;
+};
+
+template <class ShardFunc>
+void ItemRouter::Split(const vec_int_t& items, int shard_num,
+                       ShardFunc&& shard_func,
+                       std::vector<ItemFeatureLookuperRequest>* requests,
+                       std::vector<int>* masks) {
+  requests->resize(shard_num);
+  for (auto& request : *requests) {
+    request.items.clear();
+  }
+  masks->assign(shard_num, 0);
+  routes_.resize(items.size());
+  uniq_routes_.clear();
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    auto it = uniq_routes_.find(items[i]);
+    if (it != uniq_routes_.end()) {
+      routes_[i] = routes_[it->second];
+      continue;
+    }
+
+    int shard_id = shard_func(items[i]);
+    auto& shard_items = (*requests)[shard_id].items;
+    routes_[i] = std::make_pair(shard_id, (int)shard_items.size());
+    shard_items.emplace_back(items[i]);
+    (*masks)[shard_id] = 1;
+    uniq_routes_.emplace(items[i], (int)i);
+  }
+}
+
+// DistItemFeatureLookuper looks up the features of a batch of items with one
+// request per shard, see ItemFeatureLookuper.
+class DistItemFeatureLookuper : public DistGSOp {
+ public:
+  ~DistItemFeatureLookuper() override = default;
+
+ public:
+  bool Run(const vec_int_t& items, std::vector<vec_pair_t>* item_feats) const;
+};
+
+}  // namespace graph_op
+}  // namespace embedx
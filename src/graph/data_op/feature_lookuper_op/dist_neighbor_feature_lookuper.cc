@@ -41,8 +41,7 @@ bool DistNeighborFeatureLookuper::Run(
 
   // rpc
   auto rpc_type = NeighborFeatureLookuperRequest::rpc_type();
-  if (WriteRequestReadResponse(conns_, rpc_type, requests, &responses,
-                               &masks) != 0) {
+  if (CallRpc(rpc_type, requests, &responses, &masks) != 0) {
     return false;
   }
 
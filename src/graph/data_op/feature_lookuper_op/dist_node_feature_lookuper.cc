@@ -54,8 +54,7 @@ bool DistNodeFeatureLookuper::Run(const vec_int_t& nodes,
 
   // rpc
   auto rpc_type = NodeFeatureLookuperRequest::rpc_type();
-  if (WriteRequestReadResponse(conns_, rpc_type, requests, &responses,
-                               &masks) != 0) {
+  if (CallRpc(rpc_type, requests, &responses, &masks) != 0) {
     return false;
   }
 
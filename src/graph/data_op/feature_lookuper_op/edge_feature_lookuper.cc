@@ -0,0 +1,43 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/data_op/feature_lookuper_op/edge_feature_lookuper.h"
+
+#include <deepx_core/dx_log.h>
+
+#include "src/graph/data_op/gs_op_registry.h"
+
+namespace embedx {
+namespace graph_op {
+
+bool EdgeFeatureLookuper::Run(const vec_int_t& src_nodes,
+                              const vec_int_t& dst_nodes,
+                              std::vector<vec_pair_t>* edge_feats) const {
+  if (!feature_->LookupEdgeFeature(src_nodes, dst_nodes, edge_feats)) {
+    DXERROR("Failed to lookup edge feature.");
+    return false;
+  }
+
+  return true;
+}
+
+int EdgeFeatureLookuper::HandleRpc(const EdgeFeatureLookuperRequest& req,
+                                   EdgeFeatureLookuperResponse* resp) const {
+  if (!Run(req.src_nodes, req.dst_nodes, &resp->edge_feats)) {
+    return -1;
+  }
+  return 0;
+}
+
+REGISTER_LOCAL_GS_OP("EdgeFeatureLookuper", EdgeFeatureLookuper);
+
+}  // namespace graph_op
+}  // namespace embedx
@@ -0,0 +1,46 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <memory>  //std::unique_ptr
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/graph/data_op/feature_lookuper_op/feature.h"
+#include "src/graph/data_op/gs_op.h"
+#include "src/graph/data_op/gs_op_resource.h"
+#include "src/graph/proto/graph_service_proto.h"
+
+namespace embedx {
+namespace graph_op {
+
+class EdgeFeatureLookuper : public LocalGSOp {
+ private:
+  std::unique_ptr<Feature> feature_;
+
+ public:
+  ~EdgeFeatureLookuper() override = default;
+
+ public:
+  bool Run(const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+           std::vector<vec_pair_t>* edge_feats) const;
+  int HandleRpc(const EdgeFeatureLookuperRequest& req,
+                EdgeFeatureLookuperResponse* resp) const;
+
+ private:
+  bool Init(const LocalGSOpResource* resource) override {
+    feature_ = NewFeature(resource->graph());
+    return feature_ != nullptr;
+  }
+};
+
+}  // namespace graph_op
+}  // namespace embedx
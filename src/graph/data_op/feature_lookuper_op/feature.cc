@@ -77,6 +77,32 @@ bool Feature::LookupNeighborFeature(
   return nodes.size() == neighbor_feats->size();
 }
 
+bool Feature::LookupEdgeFeature(const vec_int_t& src_nodes,
+                                const vec_int_t& dst_nodes,
+                                std::vector<vec_pair_t>* edge_feats) const {
+  if (src_nodes.size() != dst_nodes.size()) {
+    DXERROR("Need src_nodes.size() == dst_nodes.size(), got %zu vs %zu.",
+            src_nodes.size(), dst_nodes.size());
+    return false;
+  }
+
+  edge_feats->clear();
+  edge_feats->reserve(src_nodes.size());
+  for (size_t i = 0; i < src_nodes.size(); ++i) {
+    size_t size;
+    const pair_t* feat =
+        graph_.FindEdgeFeature(src_nodes[i], dst_nodes[i], &size);
+    if (feat == nullptr) {
+      // insert an empty feature
+      edge_feats->emplace_back(EMPTY_FEATURE);
+    } else {
+      edge_feats->emplace_back(feat, feat + size);
+    }
+  }
+
+  return src_nodes.size() == edge_feats->size();
+}
+
 std::unique_ptr<Feature> NewFeature(const InMemoryGraph* graph) {
   std::unique_ptr<Feature> feature;
   feature.reset(new Feature(graph));
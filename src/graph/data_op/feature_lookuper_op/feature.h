@@ -34,6 +34,9 @@ class Feature {
                          std::vector<vec_pair_t>* node_feats) const;
   bool LookupNeighborFeature(const vec_int_t& nodes,
                              std::vector<vec_pair_t>* neighbor_feats) const;
+  // features of the edges 'src_nodes[i]' -> 'dst_nodes[i]'
+  bool LookupEdgeFeature(const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+                         std::vector<vec_pair_t>* edge_feats) const;
 };
 
 std::unique_ptr<Feature> NewFeature(const InMemoryGraph* graph);
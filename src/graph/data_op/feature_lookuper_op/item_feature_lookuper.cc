@@ -0,0 +1,57 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/data_op/feature_lookuper_op/item_feature_lookuper.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <cinttypes>  // PRIu64
+
+#include "src/graph/data_op/gs_op_registry.h"
+
+namespace embedx {
+namespace graph_op {
+
+bool ItemFeatureLookuper::Run(const vec_int_t& items,
+                              std::vector<vec_pair_t>* item_feats) const {
+  item_feats->clear();
+  for (auto item : items) {
+    const auto* feat = graph_->FindItemFeature(item);
+    if (feat == nullptr) {
+      DXERROR("Couldn't find item: %" PRIu64 ".", item);
+      return false;
+    }
+    item_feats->emplace_back(*feat);
+  }
+  return true;
+}
+
+int ItemFeatureLookuper::HandleRpc(const ItemFeatureLookuperRequest& req,
+                                   ItemFeatureLookuperResponse* resp) const {
+  resp->item_feats.resize(req.items.size());
+  resp->found.resize(req.items.size());
+  for (size_t i = 0; i < req.items.size(); ++i) {
+    const auto* feat = graph_->FindItemFeature(req.items[i]);
+    if (feat == nullptr) {
+      resp->item_feats[i].clear();
+      resp->found[i] = 0;
+    } else {
+      resp->item_feats[i] = *feat;
+      resp->found[i] = 1;
+    }
+  }
+  return 0;
+}
+
+REGISTER_LOCAL_GS_OP("ItemFeatureLookuper", ItemFeatureLookuper);
+
+}  // namespace graph_op
+}  // namespace embedx
@@ -0,0 +1,49 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/graph/data_op/gs_op.h"
+#include "src/graph/data_op/gs_op_resource.h"
+#include "src/graph/in_memory_graph.h"
+#include "src/graph/proto/graph_service_proto.h"
+
+namespace embedx {
+namespace graph_op {
+
+// ItemFeatureLookuper looks up the features of the items of deep models,
+// loaded by graph servers from 'item_feature', see DistDeepClientImpl.
+//
+// An item without features fails Run as ItemFeature does. HandleRpc answers
+// it with 'found' 0 instead, it may be in another shard.
+class ItemFeatureLookuper : public LocalGSOp {
+ private:
+  const InMemoryGraph* graph_ = nullptr;
+
+ public:
+  ~ItemFeatureLookuper() override = default;
+
+ public:
+  bool Run(const vec_int_t& items, std::vector<vec_pair_t>* item_feats) const;
+  int HandleRpc(const ItemFeatureLookuperRequest& req,
+                ItemFeatureLookuperResponse* resp) const;
+
+ private:
+  bool Init(const LocalGSOpResource* resource) override {
+    graph_ = resource->graph();
+    return graph_ != nullptr;
+  }
+};
+
+}  // namespace graph_op
+}  // namespace embedx
@@ -0,0 +1,76 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/data_op/freq_lookuper_op/dist_node_freq_lookuper.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <vector>
+
+#include "src/graph/data_op/gs_op_registry.h"
+#include "src/graph/proto/graph_service_proto.h"
+#include "src/io/io_util.h"
+
+namespace embedx {
+namespace graph_op {
+
+bool DistNodeFreqLookuper::Run(const vec_int_t& nodes,
+                               vec_float_t* probs) const {
+  // prepare
+  // Frequencies of a node come from the contexts of all shards.
+  std::vector<NodeFreqLookuperRequest> requests(shard_num_);
+  std::vector<NodeFreqLookuperResponse> responses(shard_num_);
+  for (int i = 0; i < shard_num_; ++i) {
+    requests[i].nodes = nodes;
+  }
+
+  // rpc
+  auto rpc_type = NodeFreqLookuperRequest::rpc_type();
+  if (CallRpc(rpc_type, requests, &responses) != 0) {
+    return false;
+  }
+
+  // reduce
+  vec_float_t total_freqs;
+  probs->assign(nodes.size(), 0);
+  for (int i = 0; i < shard_num_; ++i) {
+    const auto& response = responses[i];
+    if (response.freqs.size() != nodes.size()) {
+      DXERROR("Need the same size of nodes: %zu and freqs: %zu.", nodes.size(),
+              response.freqs.size());
+      return false;
+    }
+    for (size_t j = 0; j < nodes.size(); ++j) {
+      (*probs)[j] += response.freqs[j];
+    }
+    if (total_freqs.size() < response.total_freqs.size()) {
+      total_freqs.resize(response.total_freqs.size(), 0);
+    }
+    for (size_t j = 0; j < response.total_freqs.size(); ++j) {
+      total_freqs[j] += response.total_freqs[j];
+    }
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    auto ns_id = io_util::GetNodeType(nodes[i]);
+    if (ns_id < total_freqs.size() && total_freqs[ns_id] > 0) {
+      (*probs)[i] /= total_freqs[ns_id];
+    } else {
+      (*probs)[i] = 0;
+    }
+  }
+  return true;
+}
+
+REGISTER_DIST_GS_OP("NodeFreqLookuper", DistNodeFreqLookuper);
+
+}  // namespace graph_op
+}  // namespace embedx
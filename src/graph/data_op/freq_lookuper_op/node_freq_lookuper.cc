@@ -0,0 +1,58 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/data_op/freq_lookuper_op/node_freq_lookuper.h"
+
+#include "src/graph/data_op/gs_op_registry.h"
+
+namespace embedx {
+namespace graph_op {
+
+const FreqTable* NodeFreqLookuper::GetFreqTable() const {
+  std::call_once(freq_table_flag_, [this]() {
+    freq_table_ = FreqTable::Create(sampler_source_);
+  });
+  return freq_table_.get();
+}
+
+bool NodeFreqLookuper::Run(const vec_int_t& nodes, vec_float_t* probs) const {
+  const auto* freq_table = GetFreqTable();
+  if (freq_table == nullptr) {
+    return false;
+  }
+
+  probs->resize(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    (*probs)[i] = freq_table->Prob(nodes[i]);
+  }
+  return true;
+}
+
+int NodeFreqLookuper::HandleRpc(const NodeFreqLookuperRequest& req,
+                                NodeFreqLookuperResponse* resp) const {
+  const auto* freq_table = GetFreqTable();
+  if (freq_table == nullptr) {
+    return -1;
+  }
+
+  // a node appears in the contexts of many shards, clients add them up
+  resp->freqs.resize(req.nodes.size());
+  for (size_t i = 0; i < req.nodes.size(); ++i) {
+    resp->freqs[i] = freq_table->Freq(req.nodes[i]);
+  }
+  resp->total_freqs = freq_table->total_freqs();
+  return 0;
+}
+
+REGISTER_LOCAL_GS_OP("NodeFreqLookuper", NodeFreqLookuper);
+
+}  // namespace graph_op
+}  // namespace embedx
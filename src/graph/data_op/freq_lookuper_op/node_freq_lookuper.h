@@ -0,0 +1,54 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <memory>  // std::unique_ptr
+#include <mutex>   // std::once_flag
+
+#include "src/common/data_types.h"
+#include "src/graph/data_op/gs_op.h"
+#include "src/graph/data_op/gs_op_resource.h"
+#include "src/graph/proto/graph_service_proto.h"
+#include "src/sampler/freq_table.h"
+
+namespace embedx {
+namespace graph_op {
+
+// NodeFreqLookuper looks up the probabilities of nodes in the frequencies of
+// the loaded graph, see FreqTable. Updates of the graph are not counted.
+//
+// Every graph server and local graph client creates the op, most models never
+// look up frequencies, so the table is built on the first lookup.
+class NodeFreqLookuper : public LocalGSOp {
+ private:
+  const SamplerSource* sampler_source_ = nullptr;
+  mutable std::once_flag freq_table_flag_;
+  mutable std::unique_ptr<FreqTable> freq_table_;
+
+ public:
+  ~NodeFreqLookuper() override = default;
+
+ public:
+  bool Run(const vec_int_t& nodes, vec_float_t* probs) const;
+  int HandleRpc(const NodeFreqLookuperRequest& req,
+                NodeFreqLookuperResponse* resp) const;
+
+ private:
+  bool Init(const LocalGSOpResource* resource) override {
+    sampler_source_ = resource->sampler_source();
+    return sampler_source_ != nullptr;
+  }
+
+  const FreqTable* GetFreqTable() const;
+};
+
+}  // namespace graph_op
+}  // namespace embedx
@@ -0,0 +1,72 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/data_op/graph_updater_op/dist_graph_updater.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <vector>
+
+#include "src/graph/data_op/gs_op_registry.h"
+#include "src/graph/proto/graph_service_proto.h"
+
+namespace embedx {
+namespace graph_op {
+
+bool DistGraphUpdater::Run(const vec_int_t& src_nodes,
+                           const vec_int_t& dst_nodes,
+                           const vec_float_t& weights,
+                           const vecl_t& ops) const {
+  if (src_nodes.size() != dst_nodes.size() ||
+      src_nodes.size() != weights.size() || src_nodes.size() != ops.size()) {
+    DXERROR("Need the same size of src_nodes: %zu, dst_nodes: %zu, weights: "
+            "%zu and ops: %zu.",
+            src_nodes.size(), dst_nodes.size(), weights.size(), ops.size());
+    return false;
+  }
+
+  // prepare
+  std::vector<int> masks(shard_num_, 0);
+  std::vector<GraphUpdaterRequest> requests(shard_num_);
+  std::vector<GraphUpdaterResponse> responses(shard_num_);
+
+  auto add = [&](int shard_id, size_t i) {
+    masks[shard_id] += 1;
+    auto& request = requests[shard_id];
+    request.src_nodes.emplace_back(src_nodes[i]);
+    request.dst_nodes.emplace_back(dst_nodes[i]);
+    request.weights.emplace_back(weights[i]);
+    request.ops.emplace_back(ops[i]);
+  };
+
+  // map, the context of a hub is on every shard
+  const Partitioner* partitioner = resource_->partitioner();
+  for (size_t i = 0; i < src_nodes.size(); ++i) {
+    if (partitioner == nullptr) {
+      add((int)(src_nodes[i] % shard_num_), i);
+    } else if (partitioner->IsHub(src_nodes[i])) {
+      for (int shard_id = 0; shard_id < shard_num_; ++shard_id) {
+        add(shard_id, i);
+      }
+    } else {
+      add(partitioner->Shard(src_nodes[i]), i);
+    }
+  }
+
+  // rpc
+  auto rpc_type = GraphUpdaterRequest::rpc_type();
+  return CallRpcAll(rpc_type, requests, &responses, &masks) == 0;
+}
+
+REGISTER_DIST_GS_OP("GraphUpdater", DistGraphUpdater);
+
+}  // namespace graph_op
+}  // namespace embedx
@@ -0,0 +1,31 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include "src/common/data_types.h"
+#include "src/graph/data_op/gs_op.h"
+
+namespace embedx {
+namespace graph_op {
+
+// DistGraphUpdater sends an edge update to every replica of the home shard of
+// its source node, or of all shards if the source node is a hub.
+class DistGraphUpdater : public DistGSOp {
+ public:
+  ~DistGraphUpdater() override = default;
+
+ public:
+  bool Run(const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+           const vec_float_t& weights, const vecl_t& ops) const;
+};
+
+}  // namespace graph_op
+}  // namespace embedx
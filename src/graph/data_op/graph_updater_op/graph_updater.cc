@@ -0,0 +1,44 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/data_op/graph_updater_op/graph_updater.h"
+
+#include <deepx_core/dx_log.h>
+
+#include "src/graph/data_op/gs_op_registry.h"
+
+namespace embedx {
+namespace graph_op {
+
+bool GraphUpdater::Run(const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+                       const vec_float_t& weights, const vecl_t& ops,
+                       uint64_t* epoch) const {
+  if (!update_builder_->Apply(src_nodes, dst_nodes, weights, ops, epoch)) {
+    DXERROR("Failed to update graph.");
+    return false;
+  }
+
+  return true;
+}
+
+int GraphUpdater::HandleRpc(const GraphUpdaterRequest& req,
+                            GraphUpdaterResponse* resp) const {
+  if (!Run(req.src_nodes, req.dst_nodes, req.weights, req.ops,
+           &resp->epoch)) {
+    return -1;
+  }
+  return 0;
+}
+
+REGISTER_LOCAL_GS_OP("GraphUpdater", GraphUpdater);
+
+}  // namespace graph_op
+}  // namespace embedx
@@ -0,0 +1,50 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <cstdint>
+
+#include "src/common/data_types.h"
+#include "src/graph/data_op/gs_op.h"
+#include "src/graph/data_op/gs_op_resource.h"
+#include "src/graph/proto/graph_service_proto.h"
+#include "src/graph/update_builder.h"
+
+namespace embedx {
+namespace graph_op {
+
+class GraphUpdater : public LocalGSOp {
+ private:
+  UpdateBuilder* update_builder_ = nullptr;
+
+ public:
+  ~GraphUpdater() override = default;
+
+ public:
+  bool Run(const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+           const vec_float_t& weights, const vecl_t& ops,
+           uint64_t* epoch) const;
+  int HandleRpc(const GraphUpdaterRequest& req,
+                GraphUpdaterResponse* resp) const;
+
+ private:
+  bool Init(const LocalGSOpResource* resource) override {
+    update_builder_ = resource->update_builder();
+    if (update_builder_ == nullptr) {
+      DXERROR("Graph updates are supported by graph servers only.");
+      return false;
+    }
+    return true;
+  }
+};
+
+}  // namespace graph_op
+}  // namespace embedx
@@ -11,10 +11,15 @@
 
 #pragma once
 #include <deepx_core/dx_log.h>
-#include <deepx_core/ps/rpc_client.h>
+
+#include <cstdint>
+#include <utility>  // std::move
+#include <vector>
 
 #include "src/common/data_types.h"
 #include "src/graph/data_op/gs_op_resource.h"
+#include "src/graph/data_op/gs_op_stats.h"
+#include "src/graph/proto/graph_service_proto.h"
 
 namespace embedx {
 namespace graph_op {
@@ -29,7 +34,7 @@ class LocalGSOp {
 
 class DistGSOp {
  protected:
-  deepx_core::TcpConnections* conns_ = nullptr;
+  RpcConnector* rpc_connector_ = nullptr;
   const DistGSOpResource* resource_ = nullptr;
   int shard_num_ = 0;
 
@@ -38,23 +43,82 @@ class DistGSOp {
 
  public:
   bool Init(const DistGSOpResource* resource, int shard_num) {
-    if (resource->rpc_connector()->conns() == nullptr) {
-      DXERROR("The connections of DistGSOpResource is nullptr.");
+    if (resource->rpc_connector()->lane_num() == 0) {
+      DXERROR("The rpc connector of DistGSOpResource is not connected.");
       return false;
     }
     if (shard_num <= 0) {
       DXERROR("Number of shard: %d must be greater than 0.", shard_num);
       return false;
     }
+    if (!GSOpStatsRegistry::GetClientInstance()->Init(shard_num)) {
+      DXERROR("Number of shard: %d must not be greater than %d.", shard_num,
+              GSOpStatsRegistry::MAX_SHARD_NUM);
+      return false;
+    }
 
     resource_ = resource;
-    conns_ = resource_->rpc_connector()->conns();
+    rpc_connector_ = resource_->rpc_connector();
     shard_num_ = shard_num;
     return true;
   }
 
  protected:
-  int ModShard(int_t node) const noexcept { return node % shard_num_; }
+  // Hubs of the partitioner may go to any shard.
+  int ModShard(int_t node) const noexcept {
+    const Partitioner* partitioner = resource_->partitioner();
+    return partitioner == nullptr ? (int)(node % shard_num_)
+                                  : partitioner->Route(node);
+  }
+
+  // WriteRequestReadResponse over the replicas with per shard stats.
+  //
+  // A fan out waits for its shards together, so the latency of a shard is
+  // the service time its graph server returns in TimedResponse, which leaves
+  // out the network.
+  template <class Request, class Response>
+  int CallRpc(int rpc_type, const std::vector<Request>& requests,
+              std::vector<Response>* responses,
+              std::vector<int>* masks = nullptr) const {
+    std::vector<TimedResponse<Response>> timed_responses(responses->size());
+    int ret =
+        rpc_connector_->Call(rpc_type, requests, &timed_responses, masks);
+    return Unwrap(rpc_type, requests, &timed_responses, responses, masks, ret);
+  }
+
+  // CallRpc to every replica of the shards, the stats hold the service times
+  // of the last replicas.
+  template <class Request, class Response>
+  int CallRpcAll(int rpc_type, const std::vector<Request>& requests,
+                 std::vector<Response>* responses,
+                 std::vector<int>* masks = nullptr) const {
+    std::vector<TimedResponse<Response>> timed_responses(responses->size());
+    int ret =
+        rpc_connector_->CallAll(rpc_type, requests, &timed_responses, masks);
+    return Unwrap(rpc_type, requests, &timed_responses, responses, masks, ret);
+  }
+
+ private:
+  // Moves the responses out of 'timed_responses' and records the stats of
+  // every shard called.
+  template <class Request, class Response>
+  static int Unwrap(int rpc_type, const std::vector<Request>& requests,
+                    std::vector<TimedResponse<Response>>* timed_responses,
+                    std::vector<Response>* responses,
+                    const std::vector<int>* masks, int ret) {
+    auto* registry = GSOpStatsRegistry::GetClientInstance();
+    responses->resize(timed_responses->size());
+    for (size_t i = 0; i < timed_responses->size(); ++i) {
+      auto& timed_response = (*timed_responses)[i];
+      if (masks == nullptr || (*masks)[i]) {
+        registry->Get(rpc_type, (int)i)
+            ->Add(requests[i], timed_response.resp, timed_response.service_us,
+                  ret != 0);
+      }
+      (*responses)[i] = std::move(timed_response.resp);
+    }
+    return ret;
+  }
 };
 
 }  // namespace graph_op
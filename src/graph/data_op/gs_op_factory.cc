@@ -13,6 +13,7 @@
 
 #include <deepx_core/dx_log.h>
 
+#include <memory>  // std::unique_ptr
 #include <mutex>
 #include <unordered_map>
 
@@ -78,6 +79,10 @@ LocalGSOpFactory* LocalGSOpFactory::GetInstance() {
   return &factory;
 }
 
+std::unique_ptr<LocalGSOpFactory> LocalGSOpFactory::Create() {
+  return std::unique_ptr<LocalGSOpFactory>(new CreateOnceGSOpFactory);
+}
+
 class CreateOnceDistGSOpFactory : public DistGSOpFactory {
  private:
   std::mutex mtx_;
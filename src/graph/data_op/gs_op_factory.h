@@ -13,6 +13,7 @@
 #pragma once
 #include <deepx_core/ps/rpc_client.h>
 
+#include <memory>  // std::unique_ptr
 #include <string>
 
 #include "src/graph/data_op/gs_op.h"
@@ -29,14 +30,19 @@ class LocalGSOpFactory {
 
  public:
   static LocalGSOpFactory* GetInstance();
+  // A factory of its own, e.g. for each graph server of a process, whose ops
+  // must not be re-inited with the resource of another one.
+  static std::unique_ptr<LocalGSOpFactory> Create();
 
   virtual bool Init(const LocalGSOpResource* resource) = 0;
 
   virtual LocalGSOp* LookupOrCreate(const std::string& name) = 0;
 
+ public:
+  virtual ~LocalGSOpFactory() = default;
+
  protected:
   LocalGSOpFactory();
-  virtual ~LocalGSOpFactory() = default;
 };
 
 class DistGSOpFactory {
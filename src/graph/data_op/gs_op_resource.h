@@ -19,6 +19,8 @@
 #include "src/graph/client/rpc_connector.h"
 #include "src/graph/graph_config.h"
 #include "src/graph/in_memory_graph.h"
+#include "src/graph/update_builder.h"
+#include "src/io/partitioner.h"
 #include "src/sampler/sampler_builder.h"
 #include "src/sampler/sampler_source.h"
 #include "src/sampler/sampling.h"
@@ -33,6 +35,8 @@ class LocalGSOpResource {
   std::unique_ptr<SamplerSource> sampler_source_;
   std::unique_ptr<SamplerBuilder> negative_sampler_builder_;
   std::unique_ptr<SamplerBuilder> neighbor_sampler_builder_;
+  // graph servers only, it updates the resources above
+  mutable std::unique_ptr<UpdateBuilder> update_builder_;
 
  public:
   const GraphConfig& graph_config() const noexcept { return graph_config_; }
@@ -46,6 +50,9 @@ class LocalGSOpResource {
   const SamplerBuilder* neighbor_sampler_builder() const noexcept {
     return neighbor_sampler_builder_.get();
   }
+  UpdateBuilder* update_builder() const noexcept {
+    return update_builder_.get();
+  }
 
  public:
   void set_graph_config(const GraphConfig& graph_config) {
@@ -65,6 +72,9 @@ class LocalGSOpResource {
       std::unique_ptr<SamplerBuilder> sampler_builder) {
     neighbor_sampler_builder_ = std::move(sampler_builder);
   }
+  void set_update_builder(std::unique_ptr<UpdateBuilder> update_builder) {
+    update_builder_ = std::move(update_builder);
+  }
 };
 
 class DistGSOpResource {
@@ -73,6 +83,7 @@ class DistGSOpResource {
   int ns_size_ = 1;
   std::unique_ptr<Sampling> sampling_;
   std::unique_ptr<CacheStorage> cache_storage_;
+  std::unique_ptr<Partitioner> partitioner_;
 
  public:
   ~DistGSOpResource() { rpc_connector_->Close(); }
@@ -84,6 +95,7 @@ class DistGSOpResource {
   const CacheStorage* cache_storage() const noexcept {
     return cache_storage_.get();
   }
+  const Partitioner* partitioner() const noexcept { return partitioner_.get(); }
 
  public:
   void set_rpc_connector(std::unique_ptr<RpcConnector> rpc_connector) noexcept {
@@ -96,6 +108,9 @@ class DistGSOpResource {
   void set_cache_storage(std::unique_ptr<CacheStorage> cache_storage) noexcept {
     cache_storage_ = std::move(cache_storage);
   }
+  void set_partitioner(std::unique_ptr<Partitioner> partitioner) noexcept {
+    partitioner_ = std::move(partitioner);
+  }
 };
 
 }  // namespace graph_op
@@ -0,0 +1,275 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/data_op/gs_op_stats.h"
+
+#include <algorithm>  // std::max
+#include <cmath>      // std::ceil
+#include <sstream>    // std::ostringstream
+
+#include "src/graph/proto/graph_service_proto.h"
+
+namespace embedx {
+namespace graph_op {
+namespace {
+
+int SlotIndex(int slot_num) noexcept {
+  static std::atomic<int> next_thread_id{0};
+  thread_local int thread_id =
+      next_thread_id.fetch_add(1, std::memory_order_relaxed);
+  return thread_id % slot_num;
+}
+
+int HighestBit(uint64_t v) noexcept {
+  int bit = 0;
+  while (v >>= 1) {
+    ++bit;
+  }
+  return bit;
+}
+
+uint64_t Load(const std::atomic<uint64_t>& a) noexcept {
+  return a.load(std::memory_order_relaxed);
+}
+
+void Inc(std::atomic<uint64_t>* a, uint64_t v) noexcept {
+  a->fetch_add(v, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+/************************************************************************/
+/* LatencyHistogram */
+/************************************************************************/
+constexpr int LatencyHistogram::SUB_BITS;
+constexpr int LatencyHistogram::SUB_COUNT;
+constexpr int LatencyHistogram::MAX_BITS;
+constexpr int LatencyHistogram::BUCKET_NUM;
+
+int LatencyHistogram::BucketIndex(uint64_t us) noexcept {
+  if (us < (uint64_t)SUB_COUNT) {
+    return (int)us;
+  }
+  us = std::min(us, ((uint64_t)1 << MAX_BITS) - 1);
+  int bit = HighestBit(us);
+  int shift = bit - SUB_BITS;
+  int sub = (int)(us >> shift) - SUB_COUNT;
+  return (shift + 1) * SUB_COUNT + sub;
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(int index) noexcept {
+  if (index < SUB_COUNT) {
+    return (uint64_t)index;
+  }
+  int shift = index / SUB_COUNT - 1;
+  int sub = index % SUB_COUNT;
+  return (uint64_t)(SUB_COUNT + sub) << shift;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(int index) noexcept {
+  if (index < SUB_COUNT) {
+    return (uint64_t)index;
+  }
+  int shift = index / SUB_COUNT - 1;
+  return BucketLowerBound(index) + ((uint64_t)1 << shift) - 1;
+}
+
+/************************************************************************/
+/* GSOpStatsSnapshot */
+/************************************************************************/
+void GSOpStatsSnapshot::Merge(const GSOpStatsSnapshot& other) {
+  count += other.count;
+  error += other.error;
+  timed += other.timed;
+  latency_us += other.latency_us;
+  max_latency_us = std::max(max_latency_us, other.max_latency_us);
+  req_bytes += other.req_bytes;
+  resp_bytes += other.resp_bytes;
+  nodes += other.nodes;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    buckets[i] += other.buckets[i];
+  }
+}
+
+double GSOpStatsSnapshot::MeanLatency() const noexcept {
+  return timed == 0 ? 0 : 1.0 * latency_us / timed;
+}
+
+uint64_t GSOpStatsSnapshot::Percentile(double p) const noexcept {
+  if (timed == 0) {
+    return 0;
+  }
+  // nearest rank
+  auto rank = (uint64_t)std::ceil(p / 100 * timed);
+  rank = std::max(rank, (uint64_t)1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::min(LatencyHistogram::BucketUpperBound((int)i),
+                      max_latency_us);
+    }
+  }
+  return max_latency_us;
+}
+
+/************************************************************************/
+/* GSOpStats */
+/************************************************************************/
+GSOpStats::GSOpStats(int slot_num)
+    : slot_num_(std::max(slot_num, 1)), slots_(new Slot[slot_num_]) {
+  Clear();
+}
+
+void GSOpStats::Add(uint64_t latency_us, uint64_t req_bytes,
+                    uint64_t resp_bytes, uint64_t nodes, bool error) noexcept {
+  AddUntimed(req_bytes, resp_bytes, nodes, error);
+
+  Slot& slot = slots_[SlotIndex(slot_num_)];
+  Inc(&slot.timed, 1);
+  Inc(&slot.latency_us, latency_us);
+  Inc(&slot.buckets[LatencyHistogram::BucketIndex(latency_us)], 1);
+
+  uint64_t max_latency_us = Load(slot.max_latency_us);
+  while (latency_us > max_latency_us &&
+         !slot.max_latency_us.compare_exchange_weak(
+             max_latency_us, latency_us, std::memory_order_relaxed)) {
+  }
+}
+
+void GSOpStats::AddUntimed(uint64_t req_bytes, uint64_t resp_bytes,
+                           uint64_t nodes, bool error) noexcept {
+  Slot& slot = slots_[SlotIndex(slot_num_)];
+  Inc(&slot.count, 1);
+  if (error) {
+    Inc(&slot.error, 1);
+  }
+  Inc(&slot.req_bytes, req_bytes);
+  Inc(&slot.resp_bytes, resp_bytes);
+  Inc(&slot.nodes, nodes);
+}
+
+GSOpStatsSnapshot GSOpStats::Snapshot() const {
+  GSOpStatsSnapshot snapshot;
+  for (int i = 0; i < slot_num_; ++i) {
+    const Slot& slot = slots_[i];
+    snapshot.count += Load(slot.count);
+    snapshot.error += Load(slot.error);
+    snapshot.timed += Load(slot.timed);
+    snapshot.latency_us += Load(slot.latency_us);
+    snapshot.max_latency_us =
+        std::max(snapshot.max_latency_us, Load(slot.max_latency_us));
+    snapshot.req_bytes += Load(slot.req_bytes);
+    snapshot.resp_bytes += Load(slot.resp_bytes);
+    snapshot.nodes += Load(slot.nodes);
+    for (int j = 0; j < LatencyHistogram::BUCKET_NUM; ++j) {
+      snapshot.buckets[j] += Load(slot.buckets[j]);
+    }
+  }
+  return snapshot;
+}
+
+void GSOpStats::Clear() noexcept {
+  for (int i = 0; i < slot_num_; ++i) {
+    Slot& slot = slots_[i];
+    slot.count.store(0, std::memory_order_relaxed);
+    slot.error.store(0, std::memory_order_relaxed);
+    slot.timed.store(0, std::memory_order_relaxed);
+    slot.latency_us.store(0, std::memory_order_relaxed);
+    slot.max_latency_us.store(0, std::memory_order_relaxed);
+    slot.req_bytes.store(0, std::memory_order_relaxed);
+    slot.resp_bytes.store(0, std::memory_order_relaxed);
+    slot.nodes.store(0, std::memory_order_relaxed);
+    for (auto& bucket : slot.buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+/************************************************************************/
+/* GSOpStatsRegistry */
+/************************************************************************/
+constexpr int GSOpStatsRegistry::MAX_SHARD_NUM;
+constexpr int GSOpStatsRegistry::SERVER_SLOT_NUM;
+constexpr int GSOpStatsRegistry::CLIENT_SLOT_NUM;
+
+GSOpStatsRegistry* GSOpStatsRegistry::GetServerInstance() {
+  static GSOpStatsRegistry registry(SERVER_SLOT_NUM, 1);
+  return &registry;
+}
+
+GSOpStatsRegistry* GSOpStatsRegistry::GetClientInstance() {
+  static GSOpStatsRegistry registry(CLIENT_SLOT_NUM, 1);
+  return &registry;
+}
+
+GSOpStatsRegistry::GSOpStatsRegistry(int slot_num, int shard_num)
+    : slot_num_(slot_num), stats_(RPC_TYPE_NUM) {
+  for (auto& shard_stats : stats_) {
+    shard_stats.resize(MAX_SHARD_NUM);
+  }
+  Init(shard_num);
+}
+
+bool GSOpStatsRegistry::Init(int shard_num) {
+  if (shard_num > MAX_SHARD_NUM) {
+    return false;
+  }
+  std::unique_lock<std::mutex> _(mtx_);
+  int old_shard_num = shard_num_.load(std::memory_order_relaxed);
+  if (shard_num <= old_shard_num) {
+    return true;
+  }
+  for (auto& shard_stats : stats_) {
+    for (int i = old_shard_num; i < shard_num; ++i) {
+      shard_stats[i].reset(new GSOpStats(slot_num_));
+    }
+  }
+  shard_num_.store(shard_num, std::memory_order_release);
+  return true;
+}
+
+std::string GSOpStatsRegistry::ToString() const {
+  std::ostringstream oss;
+  int shard_num = this->shard_num();
+  for (int rpc_type = 0; rpc_type < RPC_TYPE_NUM; ++rpc_type) {
+    for (int i = 0; i < shard_num; ++i) {
+      GSOpStatsSnapshot s = stats_[rpc_type][i]->Snapshot();
+      if (s.count == 0) {
+        continue;
+      }
+      oss << RpcTypeName(rpc_type);
+      if (shard_num > 1) {
+        oss << " shard=" << i;
+      }
+      oss << " count=" << s.count << " error=" << s.error
+          << " timed=" << s.timed << " mean_us=" << (uint64_t)s.MeanLatency()
+          << " p50_us=" << s.Percentile(50) << " p90_us=" << s.Percentile(90)
+          << " p99_us=" << s.Percentile(99)
+          << " p999_us=" << s.Percentile(99.9)
+          << " max_us=" << s.max_latency_us << " req_bytes=" << s.req_bytes
+          << " resp_bytes=" << s.resp_bytes << " nodes=" << s.nodes << "\n";
+    }
+  }
+  return oss.str();
+}
+
+void GSOpStatsRegistry::Clear() noexcept {
+  int shard_num = this->shard_num();
+  for (auto& shard_stats : stats_) {
+    for (int i = 0; i < shard_num; ++i) {
+      shard_stats[i]->Clear();
+    }
+  }
+}
+
+}  // namespace graph_op
+}  // namespace embedx
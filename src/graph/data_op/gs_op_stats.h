@@ -0,0 +1,183 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>  // std::unique_ptr
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace embedx {
+namespace graph_op {
+
+/************************************************************************/
+/* LatencyHistogram */
+/************************************************************************/
+// HDR style buckets of latency in microseconds.
+//
+// Values below SUB_COUNT own exact buckets, every larger power of two range is
+// split into SUB_COUNT linear buckets, so the relative error of a percentile
+// is below 1 / SUB_COUNT.
+class LatencyHistogram {
+ public:
+  static constexpr int SUB_BITS = 3;
+  static constexpr int SUB_COUNT = 1 << SUB_BITS;
+  static constexpr int MAX_BITS = 36;  // about 19 hours
+  static constexpr int BUCKET_NUM = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+ public:
+  static int BucketIndex(uint64_t us) noexcept;
+  static uint64_t BucketLowerBound(int index) noexcept;
+  static uint64_t BucketUpperBound(int index) noexcept;
+};
+
+/************************************************************************/
+/* GSOpStatsSnapshot */
+/************************************************************************/
+struct GSOpStatsSnapshot {
+  uint64_t count = 0;
+  uint64_t error = 0;
+  // calls whose latency is recorded
+  uint64_t timed = 0;
+  uint64_t latency_us = 0;
+  uint64_t max_latency_us = 0;
+  uint64_t req_bytes = 0;
+  uint64_t resp_bytes = 0;
+  uint64_t nodes = 0;
+  std::vector<uint64_t> buckets =
+      std::vector<uint64_t>(LatencyHistogram::BUCKET_NUM, 0);
+
+  void Merge(const GSOpStatsSnapshot& other);
+  double MeanLatency() const noexcept;
+  // upper bound of the bucket holding the p-th percentile, p is in [0, 100]
+  uint64_t Percentile(double p) const noexcept;
+};
+
+/************************************************************************/
+/* GSOpStats */
+/************************************************************************/
+// Counters of one op.
+//
+// Threads are spread over slots, each slot is only written by relaxed atomic
+// adds, so recording takes no lock and seldom shares a cache line.
+class GSOpStats {
+ private:
+  struct Slot {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> error;
+    std::atomic<uint64_t> timed;
+    std::atomic<uint64_t> latency_us;
+    std::atomic<uint64_t> max_latency_us;
+    std::atomic<uint64_t> req_bytes;
+    std::atomic<uint64_t> resp_bytes;
+    std::atomic<uint64_t> nodes;
+    std::atomic<uint64_t> buckets[LatencyHistogram::BUCKET_NUM];
+    char padding[64];
+  };
+
+  int slot_num_ = 0;
+  std::unique_ptr<Slot[]> slots_;
+
+ public:
+  explicit GSOpStats(int slot_num);
+
+ public:
+  void Add(uint64_t latency_us, uint64_t req_bytes, uint64_t resp_bytes,
+           uint64_t nodes, bool error) noexcept;
+  // Add without a latency.
+  void AddUntimed(uint64_t req_bytes, uint64_t resp_bytes, uint64_t nodes,
+                  bool error) noexcept;
+
+  // 'WireSize' and 'NodeSize' are found by ADL in the proto headers.
+  template <class Request, class Response>
+  void Add(const Request& req, const Response& resp, uint64_t latency_us,
+           bool error) noexcept {
+    Add(latency_us, WireSize(req), WireSize(resp), NodeSize(req), error);
+  }
+
+  template <class Request, class Response>
+  void AddUntimed(const Request& req, const Response& resp,
+                  bool error) noexcept {
+    AddUntimed(WireSize(req), WireSize(resp), NodeSize(req), error);
+  }
+
+  GSOpStatsSnapshot Snapshot() const;
+  void Clear() noexcept;
+};
+
+/************************************************************************/
+/* GSOpStatsRegistry */
+/************************************************************************/
+// Stats of every rpc type and every shard.
+//
+// The server instance holds a single shard, the client instance holds one
+// stats per shard of the graph servers it talks to.
+//
+// The tables are sized to MAX_SHARD_NUM once, Init only fills the entries of
+// new shards under the lock. A thread reads the shards its own Init has
+// filled, so Get takes no lock.
+class GSOpStatsRegistry {
+ public:
+  static constexpr int MAX_SHARD_NUM = 1024;
+
+ private:
+  static constexpr int SERVER_SLOT_NUM = 16;
+  static constexpr int CLIENT_SLOT_NUM = 4;
+
+ private:
+  const int slot_num_;
+  std::mutex mtx_;
+  std::atomic<int> shard_num_{0};
+  // [rpc_type][shard]
+  std::vector<std::vector<std::unique_ptr<GSOpStats>>> stats_;
+
+ public:
+  static GSOpStatsRegistry* GetServerInstance();
+  static GSOpStatsRegistry* GetClientInstance();
+
+ public:
+  GSOpStatsRegistry(int slot_num, int shard_num);
+
+  // Init grows the shards only, false if 'shard_num' > MAX_SHARD_NUM.
+  bool Init(int shard_num);
+  int shard_num() const noexcept {
+    return shard_num_.load(std::memory_order_acquire);
+  }
+  GSOpStats* Get(int rpc_type, int shard_id) const noexcept {
+    return stats_[rpc_type][shard_id].get();
+  }
+
+  // One line of each rpc type and shard which has been called.
+  std::string ToString() const;
+  void Clear() noexcept;
+};
+
+/************************************************************************/
+/* GSOpTimer */
+/************************************************************************/
+class GSOpTimer {
+ private:
+  using clock = std::chrono::steady_clock;
+  clock::time_point begin_ = clock::now();
+
+ public:
+  uint64_t ElapsedUs() const noexcept {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+               clock::now() - begin_)
+        .count();
+  }
+};
+
+}  // namespace graph_op
+}  // namespace embedx
@@ -0,0 +1,147 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/data_op/gs_op_stats.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/graph/proto/graph_service_proto.h"
+
+namespace embedx {
+namespace graph_op {
+
+TEST(LatencyHistogramTest, Bucket) {
+  for (uint64_t us = 0; us < (uint64_t)LatencyHistogram::SUB_COUNT; ++us) {
+    EXPECT_EQ(LatencyHistogram::BucketIndex(us), (int)us);
+  }
+
+  int prev_index = 0;
+  for (uint64_t us = 1; us < 100000; us += 7) {
+    int index = LatencyHistogram::BucketIndex(us);
+    EXPECT_GE(index, prev_index);
+    EXPECT_LE(LatencyHistogram::BucketLowerBound(index), us);
+    EXPECT_GE(LatencyHistogram::BucketUpperBound(index), us);
+    // relative error
+    EXPECT_LE(LatencyHistogram::BucketUpperBound(index) -
+                  LatencyHistogram::BucketLowerBound(index),
+              us / LatencyHistogram::SUB_COUNT);
+    prev_index = index;
+  }
+
+  EXPECT_EQ(LatencyHistogram::BucketIndex((uint64_t)-1),
+            LatencyHistogram::BUCKET_NUM - 1);
+}
+
+TEST(GSOpStatsTest, Snapshot) {
+  GSOpStats stats(4);
+  for (uint64_t us = 1; us <= 100; ++us) {
+    stats.Add(us, 10, 20, 3, us == 100);
+  }
+
+  GSOpStatsSnapshot snapshot = stats.Snapshot();
+  EXPECT_EQ(snapshot.count, 100u);
+  EXPECT_EQ(snapshot.error, 1u);
+  EXPECT_EQ(snapshot.timed, 100u);
+  EXPECT_EQ(snapshot.latency_us, 5050u);
+  EXPECT_EQ(snapshot.max_latency_us, 100u);
+  EXPECT_EQ(snapshot.req_bytes, 1000u);
+  EXPECT_EQ(snapshot.resp_bytes, 2000u);
+  EXPECT_EQ(snapshot.nodes, 300u);
+  EXPECT_DOUBLE_EQ(snapshot.MeanLatency(), 50.5);
+  EXPECT_GE(snapshot.Percentile(50), 50u);
+  EXPECT_LE(snapshot.Percentile(50), 50u + 50u / 8);
+  EXPECT_GE(snapshot.Percentile(99), 99u);
+  EXPECT_EQ(snapshot.Percentile(100), 100u);
+
+  stats.Clear();
+  EXPECT_EQ(stats.Snapshot().count, 0u);
+}
+
+TEST(GSOpStatsTest, AddUntimed) {
+  GSOpStats stats(2);
+  stats.Add(10, 1, 2, 3, false);
+  stats.AddUntimed(1, 2, 3, true);
+  stats.AddUntimed(1, 2, 3, false);
+
+  GSOpStatsSnapshot snapshot = stats.Snapshot();
+  EXPECT_EQ(snapshot.count, 3u);
+  EXPECT_EQ(snapshot.error, 1u);
+  EXPECT_EQ(snapshot.timed, 1u);
+  EXPECT_EQ(snapshot.req_bytes, 3u);
+  EXPECT_EQ(snapshot.nodes, 9u);
+  EXPECT_DOUBLE_EQ(snapshot.MeanLatency(), 10);
+  EXPECT_EQ(snapshot.Percentile(50), 10u);
+}
+
+TEST(GSOpStatsTest, MultiThread) {
+  GSOpStats stats(2);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&stats]() {
+      for (int j = 0; j < 1000; ++j) {
+        stats.Add(5, 1, 1, 1, false);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(stats.Snapshot().count, 4000u);
+  EXPECT_EQ(stats.Snapshot().buckets[5], 4000u);
+}
+
+TEST(GSOpStatsRegistryTest, ToString) {
+  GSOpStatsRegistry registry(1, 1);
+  ASSERT_TRUE(registry.Init(2));
+  ASSERT_TRUE(registry.Init(1));
+  ASSERT_EQ(registry.shard_num(), 2);
+  EXPECT_FALSE(registry.Init(GSOpStatsRegistry::MAX_SHARD_NUM + 1));
+  EXPECT_TRUE(registry.ToString().empty());
+
+  ContextLookuperRequest req;
+  req.nodes = {1, 2, 3};
+  ContextLookuperResponse resp;
+  resp.contexts.resize(3);
+  registry.Get(RPC_TYPE_NODE_CONTEXT_LOOKUPER, 1)->Add(req, resp, 8, false);
+
+  GSOpStatsSnapshot snapshot =
+      registry.Get(RPC_TYPE_NODE_CONTEXT_LOOKUPER, 1)->Snapshot();
+  EXPECT_EQ(snapshot.nodes, 3u);
+  EXPECT_EQ(snapshot.req_bytes, WireSize(req));
+  EXPECT_EQ(snapshot.resp_bytes, WireSize(resp));
+
+  std::string s = registry.ToString();
+  EXPECT_NE(s.find("ContextLookuper shard=1 count=1"), std::string::npos);
+}
+
+TEST(GSOpStatsRegistryTest, InitWhileGet) {
+  GSOpStatsRegistry registry(1, 1);
+  GSOpStats* stats = registry.Get(RPC_TYPE_NODE_CONTEXT_LOOKUPER, 0);
+  std::thread reader([&registry]() {
+    for (int i = 0; i < 10000; ++i) {
+      registry.Get(RPC_TYPE_NODE_CONTEXT_LOOKUPER, 0)->Add(1, 1, 1, 1, false);
+    }
+  });
+  for (int shard_num = 2; shard_num <= 64; ++shard_num) {
+    ASSERT_TRUE(registry.Init(shard_num));
+  }
+  reader.join();
+  EXPECT_EQ(registry.Get(RPC_TYPE_NODE_CONTEXT_LOOKUPER, 0), stats);
+  EXPECT_EQ(stats->Snapshot().count, 10000u);
+  EXPECT_NE(registry.Get(RPC_TYPE_NODE_CONTEXT_LOOKUPER, 63), nullptr);
+}
+
+}  // namespace graph_op
+}  // namespace embedx
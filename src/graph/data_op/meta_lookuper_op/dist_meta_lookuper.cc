@@ -14,6 +14,8 @@
 #include <deepx_core/common/str_util.h>
 #include <deepx_core/dx_log.h>
 
+#include <utility>  // std::move
+
 #include "src/graph/data_op/gs_op_registry.h"
 #include "src/graph/data_op/rpc_key.h"
 #include "src/graph/proto/graph_service_proto.h"
@@ -22,7 +24,9 @@ namespace embedx {
 namespace graph_op {
 namespace {
 
+using ::embedx::rpc_key::GS_OP_STATS;
 using ::embedx::rpc_key::NODE_FREQ;
+using ::embedx::rpc_key::PARTITION;
 
 }  // namespace
 
@@ -36,7 +40,7 @@ bool DistMetaLookuper::Run(std::vector<vec_int_t>* node_freqs_list) const {
 
   // rpc
   auto rpc_type = MetaLookuperRequest::rpc_type();
-  if (WriteRequestReadResponse(conns_, rpc_type, requests, &responses) != 0) {
+  if (CallRpc(rpc_type, requests, &responses) != 0) {
     return false;
   }
 
@@ -65,6 +69,42 @@ bool DistMetaLookuper::Run(std::vector<vec_int_t>* node_freqs_list) const {
   return true;
 }
 
+bool DistMetaLookuper::LookupStats(vec_str_t* shard_stats) const {
+  std::vector<MetaLookuperRequest> requests(shard_num_);
+  std::vector<MetaLookuperResponse> responses(shard_num_);
+  for (int i = 0; i < shard_num_; ++i) {
+    requests[i].key = GS_OP_STATS;
+  }
+
+  auto rpc_type = MetaLookuperRequest::rpc_type();
+  if (CallRpc(rpc_type, requests, &responses) != 0) {
+    return false;
+  }
+
+  shard_stats->resize(shard_num_);
+  for (int i = 0; i < shard_num_; ++i) {
+    (*shard_stats)[i] = std::move(responses[i].value);
+  }
+  return true;
+}
+
+bool DistMetaLookuper::LookupPartition(std::string* partition) const {
+  // shard 0 only
+  std::vector<MetaLookuperRequest> requests(shard_num_);
+  std::vector<MetaLookuperResponse> responses(shard_num_);
+  std::vector<int> masks(shard_num_, 0);
+  requests[0].key = PARTITION;
+  masks[0] = 1;
+
+  auto rpc_type = MetaLookuperRequest::rpc_type();
+  if (CallRpc(rpc_type, requests, &responses, &masks) != 0) {
+    return false;
+  }
+
+  *partition = std::move(responses[0].value);
+  return true;
+}
+
 REGISTER_DIST_GS_OP("DistMetaLookuper", DistMetaLookuper);
 
 }  // namespace graph_op
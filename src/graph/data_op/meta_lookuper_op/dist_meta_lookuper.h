@@ -10,6 +10,7 @@
 //
 
 #pragma once
+#include <string>
 #include <vector>
 
 #include "src/common/data_types.h"
@@ -24,6 +25,10 @@ class DistMetaLookuper : public DistGSOp {
 
  public:
   bool Run(std::vector<vec_int_t>* node_freqs_list) const;
+  // op stats of each graph server
+  bool LookupStats(vec_str_t* shard_stats) const;
+  // partition map in text, every graph server holds the same one
+  bool LookupPartition(std::string* partition) const;
 };
 
 }  // namespace graph_op
@@ -17,6 +17,7 @@
 
 #include "src/common/data_types.h"
 #include "src/graph/data_op/gs_op_registry.h"
+#include "src/graph/data_op/gs_op_stats.h"
 #include "src/graph/data_op/rpc_key.h"
 
 namespace embedx {
@@ -34,8 +35,10 @@ std::string VecToString(const vec_int_t& vec) {
   return ss.str();
 }
 
+using ::embedx::rpc_key::GS_OP_STATS;
 using ::embedx::rpc_key::MAX_NODE_PER_RPC;
 using ::embedx::rpc_key::NODE_FREQ;
+using ::embedx::rpc_key::PARTITION;
 
 }  // namespace
 
@@ -46,9 +49,14 @@ bool MetaLookuper::Run(const std::string& key, std::string* value) const {
     *value = VecToString(total_freqs);
   } else if (key == MAX_NODE_PER_RPC) {
     *value = std::to_string(max_node_per_rpc_);
+  } else if (key == GS_OP_STATS) {
+    *value = GSOpStatsRegistry::GetServerInstance()->ToString();
+  } else if (key == PARTITION) {
+    *value = graph_->partitioner()->ToString();
   } else {
-    DXERROR("Only support key: '%s' || '%s'.", NODE_FREQ.c_str(),
-            MAX_NODE_PER_RPC.c_str());
+    DXERROR("Only support key: '%s' || '%s' || '%s' || '%s'.",
+            NODE_FREQ.c_str(), MAX_NODE_PER_RPC.c_str(), GS_OP_STATS.c_str(),
+            PARTITION.c_str());
     return false;
   }
 
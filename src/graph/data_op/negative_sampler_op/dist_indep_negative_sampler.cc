@@ -44,8 +44,7 @@ bool DistIndepNegativeSampler::Run(
 
   // rpc
   auto rpc_type = IndepNegativeSamplerRequest::rpc_type();
-  if (WriteRequestReadResponse(conns_, rpc_type, requests, &responses,
-                               &masks) != 0) {
+  if (CallRpc(rpc_type, requests, &responses, &masks) != 0) {
     return false;
   }
 
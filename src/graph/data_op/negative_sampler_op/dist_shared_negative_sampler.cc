@@ -43,8 +43,7 @@ bool DistSharedNegativeSampler::Run(
 
   // rpc
   auto rpc_type = SharedNegativeSamplerRequest::rpc_type();
-  if (WriteRequestReadResponse(conns_, rpc_type, requests, &responses,
-                               &masks) != 0) {
+  if (CallRpc(rpc_type, requests, &responses, &masks) != 0) {
     return false;
   }
 
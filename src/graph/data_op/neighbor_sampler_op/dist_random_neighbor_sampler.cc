@@ -18,7 +18,7 @@ namespace embedx {
 namespace graph_op {
 
 bool DistRandomNeighborSampler::Run(
-    int count, const vec_int_t& nodes,
+    int count, const vec_int_t& nodes, const TimeWindow& time_window,
     std::vector<vec_int_t>* neighbor_nodes_list) const {
   // prepare
   std::vector<int> masks;
@@ -29,6 +29,7 @@ bool DistRandomNeighborSampler::Run(
   for (int i = 0; i < shard_num_; ++i) {
     indices_list[i].clear();
     requests[i].count = count;
+    requests[i].time_window = time_window;
     requests[i].nodes.clear();
   }
 
@@ -43,8 +44,7 @@ bool DistRandomNeighborSampler::Run(
 
   // rpc
   auto rpc_type = RandomNeighborSamplerRequest::rpc_type();
-  if (WriteRequestReadResponse(conns_, rpc_type, requests, &responses,
-                               &masks) != 0) {
+  if (CallRpc(rpc_type, requests, &responses, &masks) != 0) {
     return false;
   }
 
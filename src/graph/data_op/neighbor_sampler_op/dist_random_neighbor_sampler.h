@@ -14,6 +14,7 @@
 
 #include "src/common/data_types.h"
 #include "src/graph/data_op/gs_op.h"
+#include "src/sampler/time_window.h"
 
 namespace embedx {
 namespace graph_op {
@@ -23,7 +24,7 @@ class DistRandomNeighborSampler : public DistGSOp {
   ~DistRandomNeighborSampler() override = default;
 
  public:
-  bool Run(int count, const vec_int_t& nodes,
+  bool Run(int count, const vec_int_t& nodes, const TimeWindow& time_window,
            std::vector<vec_int_t>* neighbor_nodes_list) const;
 };
 
@@ -19,9 +19,10 @@ namespace embedx {
 namespace graph_op {
 
 bool RandomNeighborSampler::Run(
-    int count, const vec_int_t& nodes,
+    int count, const vec_int_t& nodes, const TimeWindow& time_window,
     std::vector<vec_int_t>* neighbor_nodes_list) const {
-  if (!neighbor_sampler_->Sample(count, nodes, neighbor_nodes_list)) {
+  if (!neighbor_sampler_->Sample(count, nodes, time_window,
+                                 neighbor_nodes_list)) {
     DXERROR("Failed to sample neighbor.");
     return false;
   }
@@ -32,7 +33,8 @@ bool RandomNeighborSampler::Run(
 int RandomNeighborSampler::HandleRpc(
     const RandomNeighborSamplerRequest& req,
     RandomNeighborSamplerResponse* resp) const {
-  if (!Run(req.count, req.nodes, &resp->neighbor_nodes_list)) {
+  if (!Run(req.count, req.nodes, req.time_window,
+           &resp->neighbor_nodes_list)) {
     return -1;
   }
   return 0;
@@ -18,6 +18,7 @@
 #include "src/graph/data_op/gs_op_resource.h"
 #include "src/graph/proto/graph_service_proto.h"
 #include "src/sampler/neighbor_sampler.h"
+#include "src/sampler/time_window.h"
 
 namespace embedx {
 namespace graph_op {
@@ -30,7 +31,7 @@ class RandomNeighborSampler : public LocalGSOp {
   ~RandomNeighborSampler() override = default;
 
  public:
-  bool Run(int count, const vec_int_t& nodes,
+  bool Run(int count, const vec_int_t& nodes, const TimeWindow& time_window,
            std::vector<vec_int_t>* neighbor_nodes_list) const;
 
   int HandleRpc(const RandomNeighborSamplerRequest& req,
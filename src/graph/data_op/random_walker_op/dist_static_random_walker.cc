@@ -50,9 +50,8 @@ bool DistStaticRandomWalker::Run(const vec_int_t& cur_nodes,
 
     // call rpc.
     auto rpc_type = StaticRandomWalkerRequest::rpc_type();
-    if (WriteRequestReadResponse(conns_, rpc_type, rpc_session.requests,
-                                 &rpc_session.responses,
-                                 &rpc_session.masks) != 0) {
+    if (CallRpc(rpc_type, rpc_session.requests, &rpc_session.responses,
+                &rpc_session.masks) != 0) {
       return false;
     }
 
@@ -78,6 +77,7 @@ void DistStaticRandomWalker::FillRequest(
     rpc_session->requests[i].walker_info.meta_path = walker_info.meta_path;
     rpc_session->requests[i].walker_info.walker_length =
         walker_info.walker_length;
+    rpc_session->requests[i].walker_info.time_window = walker_info.time_window;
     rpc_session->responses[i].seqs.clear();
   }
 
@@ -12,6 +12,7 @@
 #include "src/graph/data_op/random_walker_op/static_random_walker.h"
 
 #include "src/graph/data_op/gs_op_registry.h"
+#include "src/sampler/time_window.h"
 
 namespace embedx {
 namespace graph_op {
@@ -20,6 +21,9 @@ bool StaticRandomWalker::Run(const vec_int_t& cur_nodes,
                              const std::vector<int>& walk_lens,
                              const WalkerInfo& walker_info,
                              std::vector<vec_int_t>* seqs) const {
+  if (!CheckTimeWindow(walker_info.time_window, sampling_type_)) {
+    return false;
+  }
   random_walker_->Traverse(cur_nodes, walk_lens, walker_info, seqs, nullptr);
   return true;
 }
@@ -26,6 +26,7 @@ namespace graph_op {
 class StaticRandomWalker : public LocalGSOp {
  private:
   std::unique_ptr<RandomWalker> random_walker_;
+  int sampling_type_ = 0;
 
  public:
   ~StaticRandomWalker() override = default;
@@ -40,6 +41,7 @@ class StaticRandomWalker : public LocalGSOp {
   bool Init(const LocalGSOpResource* resource) override {
     random_walker_ = NewRandomWalker(resource->neighbor_sampler_builder(),
                                      RandomWalkerEnum::STATIC);
+    sampling_type_ = resource->neighbor_sampler_builder()->sampling_type();
     return random_walker_ != nullptr;
   }
 };
@@ -17,6 +17,8 @@ namespace rpc_key {
 
 const std::string NODE_FREQ = "__RPC_NAME_NODE_FREQ__";                // NOLINT
 const std::string MAX_NODE_PER_RPC = "__RPC_NAME_MAX_NODE_PER_RPC__";  // NOLINT
+const std::string GS_OP_STATS = "__RPC_NAME_GS_OP_STATS__";            // NOLINT
+const std::string PARTITION = "__RPC_NAME_PARTITION__";                // NOLINT
 
 }  // namespace rpc_key
 }  // namespace embedx
@@ -0,0 +1,192 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/edge_feature_table.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::copy, std::lower_bound
+#include <atomic>
+
+#include "src/io/io_util.h"
+#include "src/io/storage/edge_vector.h"
+
+namespace embedx {
+namespace {
+
+constexpr int64_t NO_EDGE = -1;
+
+// the order of io_util::SortByNode
+bool NodeLess(int_t a, int_t b) noexcept {
+  uint16_t type_a = io_util::GetNodeType(a);
+  uint16_t type_b = io_util::GetNodeType(b);
+  return type_a == type_b ? a < b : type_a < type_b;
+}
+
+// Calls 'func(i)' for every i with 'context[i].first == dst_node'. Contexts
+// without timestamps are sorted by nodes, temporal ones by timestamps.
+template <class Func>
+void ForEachEdge(const vec_pair_t& context, bool sorted, int_t dst_node,
+                 Func&& func) {
+  if (!sorted) {
+    for (size_t i = 0; i < context.size(); ++i) {
+      if (context[i].first == dst_node) {
+        func((int)i);
+      }
+    }
+    return;
+  }
+
+  auto it = std::lower_bound(context.begin(), context.end(), dst_node,
+                             [](const pair_t& pair, int_t node) {
+                               return NodeLess(pair.first, node);
+                             });
+  for (; it != context.end() && it->first == dst_node; ++it) {
+    func((int)(it - context.begin()));
+  }
+}
+
+}  // namespace
+
+const pair_t* EdgeFeatureTable::FindByIndex(int_t src_node, int i,
+                                            size_t* size) const {
+  *size = 0;
+  const Rows* rows = row_index_.find(src_node);
+  if (rows == nullptr || i < 0 || i >= rows->size) {
+    return nullptr;
+  }
+
+  uint64_t row = rows->first + i;
+  *size = (size_t)(feat_offsets_[row + 1] - feat_offsets_[row]);
+  return *size == 0 ? nullptr : feat_list_.data() + feat_offsets_[row];
+}
+
+const pair_t* EdgeFeatureTable::Find(int_t src_node, int_t dst_node,
+                                     size_t* size) const {
+  *size = 0;
+  if (row_index_.find(src_node) == nullptr) {
+    return nullptr;
+  }
+
+  const vec_pair_t* context = context_storage_->FindNeighbor(src_node);
+  bool sorted = context_storage_->FindTimestamps(src_node) == nullptr;
+  int index = -1;
+  ForEachEdge(*context, sorted, dst_node, [&index](int i) {
+    if (index < 0) {
+      index = i;
+    }
+  });
+  return FindByIndex(src_node, index, size);
+}
+
+bool EdgeFeatureTable::Build(const Storage* edge_storage, int thread_num) {
+  const EdgeVector* edges = edge_storage->edge_vector();
+  if (edges == nullptr) {
+    DXERROR("Need an edge storage.");
+    return false;
+  }
+
+  // rows of the contexts of the nodes with edge features
+  vec_int_t nodes;
+  uint64_t row_size = 0;
+  for (auto node : context_storage_->Keys()) {
+    if (edges->src_indexing().Find(node)) {
+      int size = (int)context_storage_->FindNeighbor(node)->size();
+      row_index_.emplace(node, Rows{row_size, size});
+      nodes.emplace_back(node);
+      row_size += size;
+    }
+  }
+
+  // the edge of each row
+  std::vector<int64_t> row_edges(row_size, NO_EDGE);
+  std::atomic<uint64_t> matched_edge_num{0};
+  auto match_func = [&](const vec_int_t& sub_nodes, int /*thread_id*/) {
+    for (auto node : sub_nodes) {
+      const vec_pair_t* context = context_storage_->FindNeighbor(node);
+      bool sorted = context_storage_->FindTimestamps(node) == nullptr;
+      uint64_t first_row = row_index_.find(node)->first;
+      const vec_int_t& dst_nodes = *edges->FindNeighborNode(node);
+      const vec_int_t& edge_ids = *edges->FindNeighborEdge(node);
+      for (size_t j = 0; j < dst_nodes.size(); ++j) {
+        bool matched = false;
+        ForEachEdge(*context, sorted, dst_nodes[j], [&](int i) {
+          // the first feature line of an edge wins
+          if (row_edges[first_row + i] == NO_EDGE) {
+            row_edges[first_row + i] = (int64_t)edge_ids[j];
+          }
+          matched = true;
+        });
+        if (matched) {
+          matched_edge_num.fetch_add(1);
+        }
+      }
+    }
+    return true;
+  };
+  if (!io_util::ParallelProcess<int_t>(nodes, match_func, thread_num)) {
+    return false;
+  }
+
+  feat_offsets_.assign(row_size + 1, 0);
+  for (uint64_t row = 0; row < row_size; ++row) {
+    size_t feat_size = 0;
+    if (row_edges[row] != NO_EDGE) {
+      edges->GetFeature((int_t)row_edges[row], &feat_size);
+    }
+    feat_offsets_[row + 1] = feat_offsets_[row] + feat_size;
+  }
+
+  feat_list_.resize(feat_offsets_.back());
+  auto copy_func = [&](const vec_int_t& sub_nodes, int /*thread_id*/) {
+    for (auto node : sub_nodes) {
+      const Rows* rows = row_index_.find(node);
+      for (uint64_t row = rows->first; row < rows->first + rows->size; ++row) {
+        if (row_edges[row] != NO_EDGE) {
+          size_t feat_size;
+          const pair_t* feats =
+              edges->GetFeature((int_t)row_edges[row], &feat_size);
+          std::copy(feats, feats + feat_size,
+                    feat_list_.begin() + feat_offsets_[row]);
+        }
+      }
+    }
+    return true;
+  };
+  if (!io_util::ParallelProcess<int_t>(nodes, copy_func, thread_num)) {
+    return false;
+  }
+
+  if (matched_edge_num.load() < edges->Size()) {
+    DXINFO("Dropped %zu edge features of edges not in the contexts.",
+           (size_t)(edges->Size() - matched_edge_num.load()));
+  }
+  DXINFO("Number of nodes with edge features: %zu, rows: %zu.", node_size(),
+         this->row_size());
+  return true;
+}
+
+std::unique_ptr<EdgeFeatureTable> EdgeFeatureTable::Create(
+    const Storage* context_storage, const Storage* edge_storage,
+    int thread_num) {
+  std::unique_ptr<EdgeFeatureTable> table;
+  table.reset(new EdgeFeatureTable());
+  table->context_storage_ = context_storage;
+  table->feat_offsets_.assign(1, 0);
+
+  if (!table->Build(edge_storage, thread_num)) {
+    DXERROR("Failed to create edge feature table.");
+    table.reset();
+  }
+  return table;
+}
+
+}  // namespace embedx
@@ -0,0 +1,70 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <cstdint>
+#include <memory>  // std::unique_ptr
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/io/storage/storage.h"
+
+namespace embedx {
+
+// EdgeFeatureTable keeps the features of the edges of the loaded contexts.
+//
+// The rows are aligned with the contexts, the i-th edge of the context of a
+// node is the row 'first row of the node + i', and the features of a row are
+// stored in CSR. Only nodes with edge features take rows. A feature line
+// applies to every occurrence of its edge in the context, and a feature line
+// of an edge not in the contexts is dropped.
+//
+// Edges added by graph updates have no features, see UpdateBuilder.
+class EdgeFeatureTable {
+ private:
+  // rows of the context of a node
+  struct Rows {
+    uint64_t first;
+    int size;
+  };
+
+  const Storage* context_storage_ = nullptr;
+  FlatMap<int_t, Rows> row_index_;
+  // features of row r are [feat_offsets_[r], feat_offsets_[r + 1])
+  std::vector<uint64_t> feat_offsets_;
+  vec_pair_t feat_list_;
+
+ public:
+  // 'context_storage' must outlive the table, 'edge_storage' is only used to
+  // build it.
+  static std::unique_ptr<EdgeFeatureTable> Create(
+      const Storage* context_storage, const Storage* edge_storage,
+      int thread_num);
+
+ public:
+  size_t node_size() const noexcept { return row_index_.size(); }
+  size_t row_size() const noexcept { return feat_offsets_.size() - 1; }
+  bool empty() const noexcept { return feat_list_.empty(); }
+
+  // Features of the i-th edge of the context of 'src_node', nullptr with
+  // '*size' 0 if it has none.
+  const pair_t* FindByIndex(int_t src_node, int i, size_t* size) const;
+  // Features of the edge 'src_node' -> 'dst_node', see FindByIndex.
+  const pair_t* Find(int_t src_node, int_t dst_node, size_t* size) const;
+
+ private:
+  bool Build(const Storage* edge_storage, int thread_num);
+
+ private:
+  EdgeFeatureTable() = default;
+};
+
+}  // namespace embedx
@@ -0,0 +1,101 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/edge_feature_table.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>  // std::unique_ptr
+#include <string>
+
+#include "src/common/data_types.h"
+#include "src/io/loader/loader.h"
+
+namespace embedx {
+
+class EdgeFeatureTableTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<Loader> context_loader_;
+  std::unique_ptr<Loader> edge_loader_;
+
+ protected:
+  const std::string CONTEXT = "testdata/context";
+  const std::string EDGE_FEATURE = "testdata/edge_feature";
+  const int THREAD_NUM = 3;
+
+ protected:
+  void SetUp() override {
+    context_loader_ = NewContextLoader();
+    edge_loader_ = NewEdgeLoader();
+    ASSERT_TRUE(context_loader_->Load(CONTEXT, THREAD_NUM));
+    ASSERT_TRUE(edge_loader_->Load(EDGE_FEATURE, THREAD_NUM));
+  }
+};
+
+TEST_F(EdgeFeatureTableTest, Create) {
+  auto table = EdgeFeatureTable::Create(context_loader_->storage(),
+                                        edge_loader_->storage(), THREAD_NUM);
+  ASSERT_TRUE(table != nullptr);
+  // nodes 0, 3, 7 with 3 edges each
+  EXPECT_EQ(table->node_size(), 3u);
+  EXPECT_EQ(table->row_size(), 9u);
+  EXPECT_FALSE(table->empty());
+
+  // the first feature line of an edge wins
+  size_t size;
+  const pair_t* feats = table->Find(0, 12, &size);
+  ASSERT_TRUE(feats != nullptr);
+  ASSERT_EQ(size, 2u);
+  EXPECT_EQ(feats[0].first, 1u);
+  EXPECT_EQ(feats[1].first, 2u);
+  EXPECT_FLOAT_EQ(feats[1].second, 0.5);
+
+  feats = table->Find(7, 4, &size);
+  ASSERT_TRUE(feats != nullptr);
+  ASSERT_EQ(size, 1u);
+  EXPECT_EQ(feats[0].first, 6u);
+
+  // the edges 0 -> 11 and 1 -> 0 have no features
+  EXPECT_TRUE(table->Find(0, 11, &size) == nullptr);
+  EXPECT_EQ(size, 0u);
+  EXPECT_TRUE(table->Find(1, 0, &size) == nullptr);
+  EXPECT_EQ(size, 0u);
+  // the edge 3 -> 9 is not in the contexts
+  EXPECT_TRUE(table->Find(3, 9, &size) == nullptr);
+
+  // rows are aligned with the contexts
+  const auto* context = context_loader_->storage()->FindNeighbor(3);
+  for (int i = 0; i < (int)context->size(); ++i) {
+    const pair_t* row_feats = table->FindByIndex(3, i, &size);
+    EXPECT_EQ(row_feats, table->Find(3, (*context)[i].first, &size));
+  }
+  EXPECT_TRUE(table->FindByIndex(3, (int)context->size(), &size) == nullptr);
+}
+
+TEST_F(EdgeFeatureTableTest, Empty) {
+  edge_loader_->Clear();
+  auto table = EdgeFeatureTable::Create(context_loader_->storage(),
+                                        edge_loader_->storage(), THREAD_NUM);
+  ASSERT_TRUE(table != nullptr);
+  EXPECT_EQ(table->node_size(), 0u);
+  EXPECT_TRUE(table->empty());
+
+  size_t size;
+  EXPECT_TRUE(table->Find(0, 12, &size) == nullptr);
+}
+
+TEST_F(EdgeFeatureTableTest, NotEdgeStorage) {
+  auto table = EdgeFeatureTable::Create(context_loader_->storage(),
+                                        context_loader_->storage(), THREAD_NUM);
+  EXPECT_TRUE(table == nullptr);
+}
+
+}  // namespace embedx
@@ -15,10 +15,36 @@
 
 namespace embedx {
 
+bool GraphBuilder::InitPartitioner(const GraphConfig& config) {
+  if (config.partition_file().empty()) {
+    partitioner_ = NewPartitioner(PartitionerEnum::HASH, config.shard_num());
+    return partitioner_ != nullptr;
+  }
+
+  DXINFO("Loading partition file: %s...", config.partition_file().c_str());
+  partitioner_ = LoadPartitioner(config.partition_file());
+  if (!partitioner_) {
+    return false;
+  }
+  if (partitioner_->shard_num() != config.shard_num()) {
+    DXERROR("Partition file is for %d shards, but there are %d shards.",
+            partitioner_->shard_num(), config.shard_num());
+    return false;
+  }
+  DXINFO("Done, partitioner type: %d, number of hubs: %zu.",
+         (int)partitioner_->type(), partitioner_->hubs().size());
+  return true;
+}
+
 void GraphBuilder::InitLoader(int shard_num, int shard_id, int store_type) {
   context_loader_ = NewContextLoader(shard_num, shard_id, store_type);
   node_feat_loader_ = NewFeatureLoader(shard_num, shard_id, store_type);
   neigh_feat_loader_ = NewFeatureLoader(shard_num, shard_id, store_type);
+  item_feat_loader_ = NewFeatureLoader(shard_num, shard_id, store_type);
+  context_loader_->set_partitioner(partitioner_.get());
+  node_feat_loader_->set_partitioner(partitioner_.get());
+  neigh_feat_loader_->set_partitioner(partitioner_.get());
+  item_feat_loader_->set_partitioner(partitioner_.get());
 }
 
 /************************************************************************/
@@ -74,18 +100,73 @@ bool GraphBuilder::BuildNeighborFeature(const std::string& neighbor_feature,
   return true;
 }
 
+bool GraphBuilder::BuildItemFeature(const std::string& item_feature,
+                                    int thread_num) {
+  if (item_feature.empty()) {
+    return true;
+  }
+
+  DXINFO("Building item feature...");
+  item_feat_loader_->Clear();
+  item_feat_loader_->Reserve(estimated_size_);
+  if (!item_feat_loader_->Load(item_feature, thread_num)) {
+    DXERROR("Failed to load item feature.");
+    return false;
+  }
+
+  DXINFO("Done.");
+  return true;
+}
+
+bool GraphBuilder::BuildEdgeFeature(const std::string& edge_feature,
+                                    int shard_num, int shard_id,
+                                    int store_type, int thread_num) {
+  if (edge_feature.empty()) {
+    return true;
+  }
+
+  DXINFO("Building edge feature...");
+  // Edge features are moved to a table aligned with the contexts, the loader
+  // is only needed here.
+  auto edge_feat_loader = NewEdgeLoader(shard_num, shard_id, store_type);
+  edge_feat_loader->set_partitioner(partitioner_.get());
+  edge_feat_loader->Reserve(estimated_size_);
+  if (!edge_feat_loader->Load(edge_feature, thread_num)) {
+    DXERROR("Failed to load edge feature.");
+    return false;
+  }
+
+  edge_feat_table_ = EdgeFeatureTable::Create(
+      context_storage(), edge_feat_loader->storage(), thread_num);
+  if (!edge_feat_table_) {
+    return false;
+  }
+
+  DXINFO("Done.");
+  return true;
+}
+
 std::unique_ptr<GraphBuilder> GraphBuilder::Create(const GraphConfig& config) {
   std::unique_ptr<GraphBuilder> builder;
   builder.reset(new GraphBuilder());
 
   builder->set_estimated_size(config.estimated_size());
+  if (!builder->InitPartitioner(config)) {
+    DXERROR("Failed to create graph builder.");
+    builder.reset();
+    return builder;
+  }
   builder->InitLoader(config.shard_num(), config.shard_id(),
                       config.store_type());
 
   if (!builder->BuildContext(config.node_graph(), config.thread_num()) ||
       !builder->BuildNodeFeature(config.node_feature(), config.thread_num()) ||
       !builder->BuildNeighborFeature(config.neighbor_feature(),
-                                     config.thread_num())) {
+                                     config.thread_num()) ||
+      !builder->BuildItemFeature(config.item_feature(), config.thread_num()) ||
+      !builder->BuildEdgeFeature(config.edge_feature(), config.shard_num(),
+                                 config.shard_id(), config.store_type(),
+                                 config.thread_num())) {
     DXERROR("Failed to create graph builder.");
     builder.reset();
   }
@@ -14,8 +14,10 @@
 #include <string>
 
 #include "src/common/data_types.h"
+#include "src/graph/edge_feature_table.h"
 #include "src/graph/graph_config.h"
 #include "src/io/loader/loader.h"
+#include "src/io/partitioner.h"
 #include "src/io/storage/storage.h"
 
 namespace embedx {
@@ -23,9 +25,12 @@ namespace embedx {
 class GraphBuilder {
  private:
   uint64_t estimated_size_ = 1000000;  // magic number
+  std::unique_ptr<Partitioner> partitioner_;
   std::unique_ptr<Loader> context_loader_;
   std::unique_ptr<Loader> node_feat_loader_;
   std::unique_ptr<Loader> neigh_feat_loader_;
+  std::unique_ptr<Loader> item_feat_loader_;
+  std::unique_ptr<EdgeFeatureTable> edge_feat_table_;
 
  public:
   static std::unique_ptr<GraphBuilder> Create(const GraphConfig& config);
@@ -40,14 +45,27 @@ class GraphBuilder {
   const Storage* neigh_feature_storage() const noexcept {
     return neigh_feat_loader_->storage();
   }
+  // features of the items of deep models, see DistDeepClientImpl
+  const Storage* item_feature_storage() const noexcept {
+    return item_feat_loader_->storage();
+  }
+  // nullptr without edge features
+  const EdgeFeatureTable* edge_feature_table() const noexcept {
+    return edge_feat_table_.get();
+  }
+  const Partitioner* partitioner() const noexcept { return partitioner_.get(); }
 
  private:
   void set_estimated_size(uint64_t size) noexcept { estimated_size_ = size; }
+  bool InitPartitioner(const GraphConfig& config);
   void InitLoader(int shard_num, int shard_id, int store_type);
   bool BuildContext(const std::string& context, int thread_num);
   bool BuildNodeFeature(const std::string& node_feature, int thread_num);
   bool BuildNeighborFeature(const std::string& neighbor_feature,
                             int thread_num);
+  bool BuildItemFeature(const std::string& item_feature, int thread_num);
+  bool BuildEdgeFeature(const std::string& edge_feature, int shard_num,
+                        int shard_id, int store_type, int thread_num);
 
  private:
   GraphBuilder() = default;
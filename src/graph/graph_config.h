@@ -10,12 +10,35 @@
 //
 
 #pragma once
+#include <deepx_core/common/str_util.h>
+
 #include <string>
+#include <vector>
 
 #include "src/common/data_types.h"
 
 namespace embedx {
 
+// Splits graph server addresses into replicas of each shard.
+//
+// Shards are separated by ';' and replicas of a shard by ',', e.g.
+// "ip0:port0,ip1:port1;ip2:port2" is 2 shards and shard 0 has 2 replicas.
+inline bool SplitReplicaIpPorts(const std::string& ip_ports,
+                                std::vector<vec_str_t>* replica_ip_ports) {
+  vec_str_t shards;
+  deepx_core::Split(ip_ports, ";", &shards);
+  replica_ip_ports->clear();
+  for (const auto& shard : shards) {
+    vec_str_t replicas;
+    deepx_core::Split(shard, ",", &replicas);
+    if (replicas.empty()) {
+      return false;
+    }
+    replica_ip_ports->emplace_back(std::move(replicas));
+  }
+  return !replica_ip_ports->empty();
+}
+
 class GraphConfig {
  private:
   static constexpr uint64_t ESTIMATED_SIZE = 1000000;  // magic number
@@ -25,14 +48,25 @@ class GraphConfig {
   std::string node_config_;
   std::string node_feat_;
   std::string neigh_feat_;
+  std::string edge_feat_;
+  std::string item_feat_;
   int store_type_ = 0;
 
   int negative_sampler_type_ = 0;
+  double negative_sampler_power_ = 0.75;
+  // see UpdateBuilder
+  double negative_update_ratio_ = 0.01;
   int neighbor_sampler_type_ = 0;
   int random_walker_type_ = 0;
 
   int shard_num_ = 1;
   int shard_id_ = 0;
+  int replica_id_ = 0;
+  std::string partition_file_;
+
+  // hedged requests of clients, 0 for no hedging
+  double hedge_percentile_ = 0.0;
+  int hedge_min_delay_us_ = 1000;
 
   int thread_num_ = 1;
   std::string ip_ports_;
@@ -43,22 +77,36 @@ class GraphConfig {
 
   std::string success_out_;
 
+  int stats_interval_ = 0;
+
  public:
   // data
   const std::string& node_graph() const noexcept { return node_graph_; }
   const std::string& node_config() const noexcept { return node_config_; }
   const std::string& node_feature() const noexcept { return node_feat_; }
   const std::string& neighbor_feature() const noexcept { return neigh_feat_; }
+  const std::string& edge_feature() const noexcept { return edge_feat_; }
+  const std::string& item_feature() const noexcept { return item_feat_; }
   int store_type() const noexcept { return store_type_; }
 
   // sampler type
   int negative_sampler_type() const noexcept { return negative_sampler_type_; }
+  double negative_sampler_power() const noexcept {
+    return negative_sampler_power_;
+  }
+  double negative_update_ratio() const noexcept {
+    return negative_update_ratio_;
+  }
   int neighbor_sampler_type() const noexcept { return neighbor_sampler_type_; }
   int random_walker_type() const noexcept { return random_walker_type_; }
 
   // dist
   int shard_num() const noexcept { return shard_num_; }
   int shard_id() const noexcept { return shard_id_; }
+  int replica_id() const noexcept { return replica_id_; }
+  const std::string& partition_file() const noexcept { return partition_file_; }
+  double hedge_percentile() const noexcept { return hedge_percentile_; }
+  int hedge_min_delay_us() const noexcept { return hedge_min_delay_us_; }
 
   // performance
   int thread_num() const noexcept { return thread_num_; }
@@ -73,6 +121,9 @@ class GraphConfig {
   // output
   const std::string& success_out() const noexcept { return success_out_; }
 
+  // stats
+  int stats_interval() const noexcept { return stats_interval_; }
+
  public:
   // data
   void set_node_graph(const std::string& path) noexcept { node_graph_ = path; }
@@ -83,12 +134,20 @@ class GraphConfig {
   void set_neighbor_feature(const std::string& path) noexcept {
     neigh_feat_ = path;
   }
+  void set_edge_feature(const std::string& path) noexcept { edge_feat_ = path; }
+  void set_item_feature(const std::string& path) noexcept { item_feat_ = path; }
   void set_store_type(int store_type) noexcept { store_type_ = store_type; }
 
   // sampler type
   void set_negative_sampler_type(int type) noexcept {
     negative_sampler_type_ = type;
   }
+  void set_negative_sampler_power(double power) noexcept {
+    negative_sampler_power_ = power;
+  }
+  void set_negative_update_ratio(double ratio) noexcept {
+    negative_update_ratio_ = ratio;
+  }
   void set_neighbor_sampler_type(int type) noexcept {
     neighbor_sampler_type_ = type;
   }
@@ -97,6 +156,16 @@ class GraphConfig {
   // dist
   void set_shard_num(int shard_num) noexcept { shard_num_ = shard_num; }
   void set_shard_id(int shard_id) noexcept { shard_id_ = shard_id; }
+  void set_replica_id(int replica_id) noexcept { replica_id_ = replica_id; }
+  void set_partition_file(const std::string& path) noexcept {
+    partition_file_ = path;
+  }
+  void set_hedge_percentile(double percentile) noexcept {
+    hedge_percentile_ = percentile;
+  }
+  void set_hedge_min_delay_us(int delay_us) noexcept {
+    hedge_min_delay_us_ = delay_us;
+  }
 
   // performance
   void set_thread_num(int thread_num) noexcept { thread_num_ = thread_num; }
@@ -115,6 +184,11 @@ class GraphConfig {
   void set_success_out(const std::string& success_out) noexcept {
     success_out_ = success_out;
   }
+
+  // stats
+  void set_stats_interval(int stats_interval) noexcept {
+    stats_interval_ = stats_interval;
+  }
 };
 
 }  // namespace embedx
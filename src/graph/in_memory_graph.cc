@@ -13,6 +13,9 @@
 
 #include <deepx_core/dx_log.h>
 
+#include <algorithm>  // std::find_if
+#include <utility>    // std::move
+
 namespace embedx {
 
 /************************************************************************/
@@ -26,8 +29,8 @@ bool InMemoryGraph::Build(const GraphConfig& config) {
     return false;
   }
 
-  post_builder_ =
-      PostBuilder::Create(graph_builder_->context_storage(), config);
+  post_builder_ = PostBuilder::Create(graph_builder_->context_storage(),
+                                      config, graph_builder_->partitioner());
   if (!post_builder_) {
     return false;
   }
@@ -79,6 +82,58 @@ void InMemoryGraph::PrintGraphTopo() const {
     DXINFO("Frequency of namespace: %s nodes are: %d.", ns_name.c_str(),
            (int)freq);
   }
+  if (item_feature_size() > 0) {
+    DXINFO("Number of items with features are: %zu.", item_feature_size());
+  }
+}
+
+const pair_t* InMemoryGraph::FindEdgeFeature(int_t src_node, int_t dst_node,
+                                             size_t* size) const {
+  *size = 0;
+  const auto* table = graph_builder_->edge_feature_table();
+  if (table == nullptr) {
+    return nullptr;
+  }
+
+  const vec_pair_t* context;
+  if (!context_delta_.empty() &&
+      context_delta_.Find(src_node, ReadEpoch(), &context)) {
+    if (context == nullptr ||
+        std::find_if(context->begin(), context->end(),
+                     [dst_node](const pair_t& pair) {
+                       return pair.first == dst_node;
+                     }) == context->end()) {
+      return nullptr;
+    }
+  }
+  return table->Find(src_node, dst_node, size);
+}
+
+/************************************************************************/
+/* Update graph */
+/************************************************************************/
+void InMemoryGraph::UpdateContext(int_t node, vec_pair_t context,
+                                  uint64_t epoch) {
+  if (context.empty()) {
+    context_delta_.Erase(node, epoch);
+  } else {
+    context_delta_.Put(node, std::move(context), epoch);
+  }
+}
+
+void InMemoryGraph::UpdateInDegree(int_t dst_node, int in_degree,
+                                   uint64_t epoch) {
+  in_degree_delta_.Put(dst_node, in_degree, epoch);
+}
+
+void InMemoryGraph::Discard(uint64_t epoch) {
+  context_delta_.Discard(epoch);
+  in_degree_delta_.Discard(epoch);
+}
+
+void InMemoryGraph::Reclaim(uint64_t safe_epoch) {
+  context_delta_.Reclaim(safe_epoch);
+  in_degree_delta_.Reclaim(safe_epoch);
 }
 
 std::unique_ptr<InMemoryGraph> InMemoryGraph::Create(
@@ -14,6 +14,8 @@
 #include <vector>
 
 #include "src/common/data_types.h"
+#include "src/common/epoch.h"
+#include "src/common/versioned_map.h"
 #include "src/graph/graph_builder.h"
 #include "src/graph/graph_config.h"
 #include "src/graph/post_builder.h"
@@ -25,6 +27,10 @@ class InMemoryGraph {
   std::unique_ptr<GraphBuilder> graph_builder_;
   std::unique_ptr<PostBuilder> post_builder_;
 
+  // updates on top of the loaded graph, see UpdateBuilder
+  VersionedMap<vec_pair_t> context_delta_;
+  VersionedMap<int> in_degree_delta_;
+
  public:
   static std::unique_ptr<InMemoryGraph> Create(const GraphConfig& config);
 
@@ -42,17 +48,32 @@ class InMemoryGraph {
   const id_name_t& id_name_map() const noexcept {
     return post_builder_->id_name_map();
   }
+  const Partitioner* partitioner() const noexcept {
+    return graph_builder_->partitioner();
+  }
 
  public:
   // degree
   int GetInDegree(int_t dst_node) const {
+    return GetInDegree(dst_node, ReadEpoch());
+  }
+  int GetInDegree(int_t dst_node, uint64_t epoch) const {
+    const int* in_degree;
+    if (!in_degree_delta_.empty() &&
+        in_degree_delta_.Find(dst_node, epoch, &in_degree)) {
+      return in_degree == nullptr ? 0 : *in_degree;
+    }
     return graph_builder_->context_storage()->GetInDegree(dst_node);
   }
   int GetOutDegree(int_t src_node) const {
+    if (!context_delta_.empty()) {
+      const auto* context = FindContext(src_node);
+      return context == nullptr ? 0 : (int)context->size();
+    }
     return graph_builder_->context_storage()->GetOutDegree(src_node);
   }
 
-  // keys
+  // keys of the loaded graph, nodes added by updates are not in them
   const vec_int_t& node_keys() const noexcept {
     return graph_builder_->context_storage()->Keys();
   }
@@ -65,16 +86,35 @@ class InMemoryGraph {
 
   // find
   const vec_pair_t* FindContext(int_t node) const {
+    return FindContext(node, ReadEpoch());
+  }
+  const vec_pair_t* FindContext(int_t node, uint64_t epoch) const {
+    const vec_pair_t* context;
+    if (!context_delta_.empty() && context_delta_.Find(node, epoch, &context)) {
+      return context;
+    }
     return graph_builder_->context_storage()->FindNeighbor(node);
   }
+  // Timestamps of the context of 'node', nullptr if it has none. Temporal
+  // nodes are not updated, see UpdateBuilder.
+  const vec_time_t* FindTimestamps(int_t node) const {
+    return graph_builder_->context_storage()->FindTimestamps(node);
+  }
   const vec_pair_t* FindNodeFeature(int_t node) const {
     return graph_builder_->node_feature_storage()->FindNeighbor(node);
   }
   const vec_pair_t* FindNeighFeature(int_t node) const {
     return graph_builder_->neigh_feature_storage()->FindNeighbor(node);
   }
+  const vec_pair_t* FindItemFeature(int_t item) const {
+    return graph_builder_->item_feature_storage()->FindNeighbor(item);
+  }
+  // Features of the edge 'src_node' -> 'dst_node', nullptr with '*size' 0 if
+  // it has none, see EdgeFeatureTable. An edge removed by updates has none.
+  const pair_t* FindEdgeFeature(int_t src_node, int_t dst_node,
+                                size_t* size) const;
 
-  // size
+  // size of the loaded graph
   size_t node_size() const noexcept {
     return graph_builder_->context_storage()->Size();
   }
@@ -84,6 +124,9 @@ class InMemoryGraph {
   size_t neigh_feature_size() const noexcept {
     return graph_builder_->neigh_feature_storage()->Size();
   }
+  size_t item_feature_size() const noexcept {
+    return graph_builder_->item_feature_storage()->Size();
+  }
 
   // empty
   bool node_empty() const noexcept {
@@ -95,6 +138,22 @@ class InMemoryGraph {
   bool neigh_feature_empty() const noexcept {
     return graph_builder_->neigh_feature_storage()->Empty();
   }
+  bool edge_feature_empty() const noexcept {
+    const auto* table = graph_builder_->edge_feature_table();
+    return table == nullptr || table->empty();
+  }
+
+ public:
+  // Updates of a running graph, visible to readers pinning 'epoch' or a later
+  // one. The caller serializes them, see UpdateBuilder.
+  //
+  // An empty context removes the node.
+  void UpdateContext(int_t node, vec_pair_t context, uint64_t epoch);
+  void UpdateInDegree(int_t dst_node, int in_degree, uint64_t epoch);
+  // Drops the updates at 'epoch' before it is published.
+  void Discard(uint64_t epoch);
+  void Reclaim(uint64_t safe_epoch);
+  size_t updated_node_size() const noexcept { return context_delta_.size(); }
 
  private:
   bool Build(const GraphConfig& config);
@@ -28,6 +28,8 @@ class PostBuilderHelper {
   uint16_t ns_size_ = 1;
   int estimated_size_ = 0;
   const Storage* store_ = nullptr;
+  const Partitioner* partitioner_ = nullptr;
+  int shard_id_ = 0;
 
   std::vector<vec_int_t>* uniq_nodes_list_ = nullptr;
   std::vector<vec_float_t>* uniq_freqs_list_ = nullptr;
@@ -39,11 +41,14 @@ class PostBuilderHelper {
 
  public:
   PostBuilderHelper(const id_name_t& id_name_map, uint16_t ns_size,
-                    int estimated_size, const Storage* storage)
+                    int estimated_size, const Storage* storage,
+                    const Partitioner* partitioner, int shard_id)
       : id_name_map_(id_name_map),
         ns_size_(ns_size),
         estimated_size_(estimated_size),
-        store_(storage) {}
+        store_(storage),
+        partitioner_(partitioner),
+        shard_id_(shard_id) {}
 
  public:
   bool Build(std::vector<vec_int_t>* uniq_nodes_list,
@@ -154,6 +159,11 @@ bool PostBuilderHelper::ProcessEntry(const vec_int_t& nodes, int thread_id) {
   DXINFO("Thread: %d is processing ...", thread_id);
 
   for (auto node : nodes) {
+    if (partitioner_ != nullptr && partitioner_->IsHub(node) &&
+        partitioner_->Shard(node) != shard_id_) {
+      continue;
+    }
+
     // node
     {
       std::lock_guard<std::mutex> guard(mtx_);
@@ -193,18 +203,20 @@ bool PostBuilder::Build(const std::string& config, int thread_num) {
   }
 
   PostBuilderHelper builder_helper(id_name_map_, ns_size_, estimated_size_,
-                                   store_);
+                                   store_, partitioner_, shard_id_);
   return builder_helper.Build(&uniq_nodes_list_, &uniq_freqs_list_,
                               &total_freqs_, thread_num);
 }
 
-std::unique_ptr<PostBuilder> PostBuilder::Create(const Storage* store,
-                                                 const GraphConfig& config) {
+std::unique_ptr<PostBuilder> PostBuilder::Create(
+    const Storage* store, const GraphConfig& config,
+    const Partitioner* partitioner) {
   std::unique_ptr<PostBuilder> post_builder;
   post_builder.reset(new PostBuilder());
 
   post_builder->set_store(store);
   post_builder->set_estimated_size(config.estimated_size());
+  post_builder->set_partitioner(partitioner, config.shard_id());
 
   if (!post_builder->Build(config.node_config(), config.thread_num())) {
     DXERROR("Failed to create post builder.");
@@ -17,6 +17,7 @@
 #include "src/common/data_types.h"
 #include "src/graph/graph_builder.h"
 #include "src/graph/graph_config.h"
+#include "src/io/partitioner.h"
 #include "src/io/storage/storage.h"
 
 namespace embedx {
@@ -31,10 +32,15 @@ class PostBuilder {
 
   const Storage* store_ = nullptr;
   uint64_t estimated_size_ = 1000000;  // magic number
+  const Partitioner* partitioner_ = nullptr;
+  int shard_id_ = 0;
 
  public:
-  static std::unique_ptr<PostBuilder> Create(const Storage* store,
-                                             const GraphConfig& config);
+  // Hubs replicated from other shards are skipped, so that the frequencies
+  // of every node are counted by one shard only.
+  static std::unique_ptr<PostBuilder> Create(
+      const Storage* store, const GraphConfig& config,
+      const Partitioner* partitioner = nullptr);
 
  public:
   uint16_t ns_size() const noexcept { return ns_size_; }
@@ -51,6 +57,10 @@ class PostBuilder {
  private:
   void set_store(const Storage* store) noexcept { store_ = store; }
   void set_estimated_size(uint64_t size) noexcept { estimated_size_ = size; }
+  void set_partitioner(const Partitioner* partitioner, int shard_id) noexcept {
+    partitioner_ = partitioner;
+    shard_id_ = shard_id;
+  }
   bool Build(const std::string& config, int thread_num);
 
  private:
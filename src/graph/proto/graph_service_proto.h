@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "src/common/data_types.h"
+#include "src/sampler/time_window.h"
 
 namespace embedx {
 
@@ -31,9 +32,84 @@ constexpr int RPC_TYPE_NODE_CONTEXT_LOOKUPER = 7;
 constexpr int RPC_TYPE_NEIGHBOR_FEATURE_LOOKUPER = 8;
 constexpr int RPC_TYPE_CACHE_NODE_LOOKUPER = 9;
 constexpr int RPC_TYPE_DYNAMIC_RANDOM_WALKER = 10;
+constexpr int RPC_TYPE_GRAPH_UPDATER = 11;
+constexpr int RPC_TYPE_EDGE_FEATURE_LOOKUPER = 12;
+constexpr int RPC_TYPE_NODE_FREQ_LOOKUPER = 13;
+constexpr int RPC_TYPE_ITEM_FEATURE_LOOKUPER = 14;
+constexpr int RPC_TYPE_NUM = 15;
+
+inline const char* RpcTypeName(int rpc_type) noexcept {
+  static const char* const NAMES[RPC_TYPE_NUM] = {
+      "MetaLookuper",
+      "SharedNegativeSampler",
+      "IndepNegativeSampler",
+      "RandomNeighborSampler",
+      "StaticRandomWalker",
+      "FeatureLookuper",
+      "NodeFeatureLookuper",
+      "ContextLookuper",
+      "NeighborFeatureLookuper",
+      "CacheNodeLookuper",
+      "DynamicRandomWalker",
+      "GraphUpdater",
+      "EdgeFeatureLookuper",
+      "NodeFreqLookuper",
+      "ItemFeatureLookuper",
+  };
+  return (0 <= rpc_type && rpc_type < RPC_TYPE_NUM) ? NAMES[rpc_type]
+                                                    : "Unknown";
+}
 
 using OutputStream = ::deepx_core::OutputStream;
 using InputStream = ::deepx_core::InputStream;
+
+/************************************************************************/
+/* Wire Size */
+/************************************************************************/
+// Approximate serialized bytes of a message, counted by the gs op stats
+// without serializing it again.
+inline size_t WireSize(const std::string& s) noexcept {
+  return sizeof(uint64_t) + s.size();
+}
+
+template <typename T>
+size_t WireSize(const std::vector<T>& vec) noexcept {
+  return sizeof(uint64_t) + vec.size() * sizeof(T);
+}
+
+template <typename T>
+size_t WireSize(const std::vector<std::vector<T>>& vec_list) noexcept {
+  size_t size = sizeof(uint64_t);
+  for (const auto& vec : vec_list) {
+    size += WireSize(vec);
+  }
+  return size;
+}
+
+/************************************************************************/
+/* Timed Response */
+/************************************************************************/
+// A response with the time the graph server took to serve it, every graph
+// server response goes over the wire in it. A client waits for all shards of
+// a fan out together, it tells their latencies apart by 'service_us'.
+template <class Response>
+struct TimedResponse {
+  Response resp;
+  uint64_t service_us = 0;
+};
+
+template <class Response>
+OutputStream& operator<<(OutputStream& os, const TimedResponse<Response>& t) {
+  os << t.resp << t.service_us;
+  return os;
+}
+
+template <class Response>
+InputStream& operator>>(InputStream& is, TimedResponse<Response>& t) {
+  is >> t.resp >> t.service_us;
+  return is;
+}
+
 /************************************************************************/
 /* Meta Lookuper */
 /************************************************************************/
@@ -69,6 +145,18 @@ inline InputStream& operator>>(InputStream& is, MetaLookuperResponse& resp) {
   return is;
 }
 
+inline size_t WireSize(const MetaLookuperRequest& req) noexcept {
+  return WireSize(req.key);
+}
+
+inline size_t NodeSize(const MetaLookuperRequest& /*req*/) noexcept {
+  return 0;
+}
+
+inline size_t WireSize(const MetaLookuperResponse& resp) noexcept {
+  return WireSize(resp.value);
+}
+
 /************************************************************************/
 /* Shared Negative Sampling */
 /************************************************************************/
@@ -108,6 +196,18 @@ inline InputStream& operator>>(InputStream& is,
   return is;
 }
 
+inline size_t WireSize(const SharedNegativeSamplerRequest& req) noexcept {
+  return sizeof(req.count) + WireSize(req.nodes) + WireSize(req.excluded_nodes);
+}
+
+inline size_t NodeSize(const SharedNegativeSamplerRequest& req) noexcept {
+  return req.nodes.size();
+}
+
+inline size_t WireSize(const SharedNegativeSamplerResponse& resp) noexcept {
+  return WireSize(resp.sampled_nodes_list);
+}
+
 /************************************************************************/
 /* Indepdent Negative Sampling */
 /************************************************************************/
@@ -147,12 +247,43 @@ inline InputStream& operator>>(InputStream& is,
   return is;
 }
 
+inline size_t WireSize(const IndepNegativeSamplerRequest& req) noexcept {
+  return sizeof(req.count) + WireSize(req.nodes) + WireSize(req.excluded_nodes);
+}
+
+inline size_t NodeSize(const IndepNegativeSamplerRequest& req) noexcept {
+  return req.nodes.size();
+}
+
+inline size_t WireSize(const IndepNegativeSamplerResponse& resp) noexcept {
+  return WireSize(resp.sampled_nodes_list);
+}
+
+/************************************************************************/
+/* Time Window */
+/************************************************************************/
+inline OutputStream& operator<<(OutputStream& os, const TimeWindow& window) {
+  os << window.type << window.timestamp << window.recent_num;
+  return os;
+}
+
+inline InputStream& operator>>(InputStream& is, TimeWindow& window) {
+  is >> window.type >> window.timestamp >> window.recent_num;
+  return is;
+}
+
+inline size_t WireSize(const TimeWindow& window) noexcept {
+  return sizeof(window.type) + sizeof(window.timestamp) +
+         sizeof(window.recent_num);
+}
+
 /************************************************************************/
 /* Random Neighbor Sampling  */
 /************************************************************************/
 struct RandomNeighborSamplerRequest {
   int count;
   vec_int_t nodes;
+  TimeWindow time_window;
 
   static int rpc_type() noexcept { return RPC_TYPE_RANDOM_NEIGHBOR_SAMPLER; }
 };
@@ -163,13 +294,13 @@ struct RandomNeighborSamplerResponse {
 
 inline OutputStream& operator<<(OutputStream& os,
                                 const RandomNeighborSamplerRequest& req) {
-  os << req.count << req.nodes;
+  os << req.count << req.nodes << req.time_window;
   return os;
 }
 
 inline InputStream& operator>>(InputStream& is,
                                RandomNeighborSamplerRequest& req) {
-  is >> req.count >> req.nodes;
+  is >> req.count >> req.nodes >> req.time_window;
   return is;
 }
 
@@ -185,6 +316,18 @@ inline InputStream& operator>>(InputStream& is,
   return is;
 }
 
+inline size_t WireSize(const RandomNeighborSamplerRequest& req) noexcept {
+  return sizeof(req.count) + WireSize(req.nodes) + WireSize(req.time_window);
+}
+
+inline size_t NodeSize(const RandomNeighborSamplerRequest& req) noexcept {
+  return req.nodes.size();
+}
+
+inline size_t WireSize(const RandomNeighborSamplerResponse& resp) noexcept {
+  return WireSize(resp.neighbor_nodes_list);
+}
+
 /************************************************************************/
 /* Feature Lookuper */
 /************************************************************************/
@@ -221,6 +364,18 @@ inline InputStream& operator>>(InputStream& is, FeatureLookuperResponse& resp) {
   return is;
 }
 
+inline size_t WireSize(const FeatureLookuperRequest& req) noexcept {
+  return WireSize(req.nodes);
+}
+
+inline size_t NodeSize(const FeatureLookuperRequest& req) noexcept {
+  return req.nodes.size();
+}
+
+inline size_t WireSize(const FeatureLookuperResponse& resp) noexcept {
+  return WireSize(resp.node_feats) + WireSize(resp.neigh_feats);
+}
+
 /************************************************************************/
 /* Node Feature Lookuper */
 /************************************************************************/
@@ -257,6 +412,18 @@ inline InputStream& operator>>(InputStream& is,
   return is;
 }
 
+inline size_t WireSize(const NodeFeatureLookuperRequest& req) noexcept {
+  return WireSize(req.nodes);
+}
+
+inline size_t NodeSize(const NodeFeatureLookuperRequest& req) noexcept {
+  return req.nodes.size();
+}
+
+inline size_t WireSize(const NodeFeatureLookuperResponse& resp) noexcept {
+  return WireSize(resp.node_feats);
+}
+
 /************************************************************************/
 /* Neighbor Feature Lookuper */
 /************************************************************************/
@@ -293,11 +460,25 @@ inline InputStream& operator>>(InputStream& is,
   return is;
 }
 
+inline size_t WireSize(const NeighborFeatureLookuperRequest& req) noexcept {
+  return WireSize(req.nodes);
+}
+
+inline size_t NodeSize(const NeighborFeatureLookuperRequest& req) noexcept {
+  return req.nodes.size();
+}
+
+inline size_t WireSize(const NeighborFeatureLookuperResponse& resp) noexcept {
+  return WireSize(resp.neigh_feats);
+}
+
 /************************************************************************/
 /* Node Context Lookuper*/
 /************************************************************************/
 struct ContextLookuperRequest {
   vec_int_t nodes;
+  // at most 'max_size' neighbors of a context, 0 for all, see Context::Lookup
+  int max_size = 0;
 
   static int rpc_type() noexcept { return RPC_TYPE_NODE_CONTEXT_LOOKUPER; }
 };
@@ -308,12 +489,12 @@ struct ContextLookuperResponse {
 
 inline OutputStream& operator<<(OutputStream& os,
                                 const ContextLookuperRequest& req) {
-  os << req.nodes;
+  os << req.nodes << req.max_size;
   return os;
 }
 
 inline InputStream& operator>>(InputStream& is, ContextLookuperRequest& req) {
-  is >> req.nodes;
+  is >> req.nodes >> req.max_size;
   return is;
 }
 
@@ -328,6 +509,18 @@ inline InputStream& operator>>(InputStream& is, ContextLookuperResponse& resp) {
   return is;
 }
 
+inline size_t WireSize(const ContextLookuperRequest& req) noexcept {
+  return WireSize(req.nodes) + sizeof(req.max_size);
+}
+
+inline size_t NodeSize(const ContextLookuperRequest& req) noexcept {
+  return req.nodes.size();
+}
+
+inline size_t WireSize(const ContextLookuperResponse& resp) noexcept {
+  return WireSize(resp.contexts);
+}
+
 /************************************************************************/
 /* Node Cacher*/
 /************************************************************************/
@@ -365,4 +558,218 @@ inline InputStream& operator>>(InputStream& is,
   return is;
 }
 
+inline size_t WireSize(const CacheNodeLookuperRequest& req) noexcept {
+  return sizeof(req.cursor) + sizeof(req.count);
+}
+
+inline size_t NodeSize(const CacheNodeLookuperRequest& /*req*/) noexcept {
+  return 0;
+}
+
+inline size_t WireSize(const CacheNodeLookuperResponse& resp) noexcept {
+  return WireSize(resp.nodes);
+}
+
+/************************************************************************/
+/* Graph Updater */
+/************************************************************************/
+// edge updates, see UpdateBuilder
+struct GraphUpdaterRequest {
+  vec_int_t src_nodes;
+  vec_int_t dst_nodes;
+  vec_float_t weights;
+  std::vector<int> ops;
+
+  static int rpc_type() noexcept { return RPC_TYPE_GRAPH_UPDATER; }
+};
+
+struct GraphUpdaterResponse {
+  // the epoch the updates are visible from
+  uint64_t epoch;
+};
+
+inline OutputStream& operator<<(OutputStream& os,
+                                const GraphUpdaterRequest& req) {
+  os << req.src_nodes << req.dst_nodes << req.weights << req.ops;
+  return os;
+}
+
+inline InputStream& operator>>(InputStream& is, GraphUpdaterRequest& req) {
+  is >> req.src_nodes >> req.dst_nodes >> req.weights >> req.ops;
+  return is;
+}
+
+inline OutputStream& operator<<(OutputStream& os,
+                                const GraphUpdaterResponse& resp) {
+  os << resp.epoch;
+  return os;
+}
+
+inline InputStream& operator>>(InputStream& is, GraphUpdaterResponse& resp) {
+  is >> resp.epoch;
+  return is;
+}
+
+inline size_t WireSize(const GraphUpdaterRequest& req) noexcept {
+  return WireSize(req.src_nodes) + WireSize(req.dst_nodes) +
+         WireSize(req.weights) + WireSize(req.ops);
+}
+
+inline size_t NodeSize(const GraphUpdaterRequest& req) noexcept {
+  return req.src_nodes.size();
+}
+
+inline size_t WireSize(const GraphUpdaterResponse& resp) noexcept {
+  return sizeof(resp.epoch);
+}
+
+/************************************************************************/
+/* Edge Feature Lookuper */
+/************************************************************************/
+struct EdgeFeatureLookuperRequest {
+  vec_int_t src_nodes;
+  vec_int_t dst_nodes;
+  static int rpc_type() noexcept { return RPC_TYPE_EDGE_FEATURE_LOOKUPER; }
+};
+
+struct EdgeFeatureLookuperResponse {
+  std::vector<vec_pair_t> edge_feats;
+};
+
+inline OutputStream& operator<<(OutputStream& os,
+                                const EdgeFeatureLookuperRequest& req) {
+  os << req.src_nodes << req.dst_nodes;
+  return os;
+}
+
+inline InputStream& operator>>(InputStream& is,
+                               EdgeFeatureLookuperRequest& req) {
+  is >> req.src_nodes >> req.dst_nodes;
+  return is;
+}
+
+inline OutputStream& operator<<(OutputStream& os,
+                                const EdgeFeatureLookuperResponse& resp) {
+  os << resp.edge_feats;
+  return os;
+}
+
+inline InputStream& operator>>(InputStream& is,
+                               EdgeFeatureLookuperResponse& resp) {
+  is >> resp.edge_feats;
+  return is;
+}
+
+inline size_t WireSize(const EdgeFeatureLookuperRequest& req) noexcept {
+  return WireSize(req.src_nodes) + WireSize(req.dst_nodes);
+}
+
+inline size_t NodeSize(const EdgeFeatureLookuperRequest& req) noexcept {
+  return req.src_nodes.size();
+}
+
+inline size_t WireSize(const EdgeFeatureLookuperResponse& resp) noexcept {
+  return WireSize(resp.edge_feats);
+}
+
+/************************************************************************/
+/* Node Freq Lookuper */
+/************************************************************************/
+struct NodeFreqLookuperRequest {
+  vec_int_t nodes;
+  static int rpc_type() noexcept { return RPC_TYPE_NODE_FREQ_LOOKUPER; }
+};
+
+struct NodeFreqLookuperResponse {
+  // frequencies of the nodes and total frequencies of the namespaces in the
+  // shard
+  vec_float_t freqs;
+  vec_float_t total_freqs;
+};
+
+inline OutputStream& operator<<(OutputStream& os,
+                                const NodeFreqLookuperRequest& req) {
+  os << req.nodes;
+  return os;
+}
+
+inline InputStream& operator>>(InputStream& is, NodeFreqLookuperRequest& req) {
+  is >> req.nodes;
+  return is;
+}
+
+inline OutputStream& operator<<(OutputStream& os,
+                                const NodeFreqLookuperResponse& resp) {
+  os << resp.freqs << resp.total_freqs;
+  return os;
+}
+
+inline InputStream& operator>>(InputStream& is,
+                               NodeFreqLookuperResponse& resp) {
+  is >> resp.freqs >> resp.total_freqs;
+  return is;
+}
+
+inline size_t WireSize(const NodeFreqLookuperRequest& req) noexcept {
+  return WireSize(req.nodes);
+}
+
+inline size_t NodeSize(const NodeFreqLookuperRequest& req) noexcept {
+  return req.nodes.size();
+}
+
+inline size_t WireSize(const NodeFreqLookuperResponse& resp) noexcept {
+  return WireSize(resp.freqs) + WireSize(resp.total_freqs);
+}
+
+/************************************************************************/
+/* Item Feature Lookuper */
+/************************************************************************/
+struct ItemFeatureLookuperRequest {
+  vec_int_t items;
+  static int rpc_type() noexcept { return RPC_TYPE_ITEM_FEATURE_LOOKUPER; }
+};
+
+struct ItemFeatureLookuperResponse {
+  std::vector<vec_pair_t> item_feats;
+  // 1 if the item is in the shard, its feature is empty otherwise
+  vecl_t found;
+};
+
+inline OutputStream& operator<<(OutputStream& os,
+                                const ItemFeatureLookuperRequest& req) {
+  os << req.items;
+  return os;
+}
+
+inline InputStream& operator>>(InputStream& is,
+                               ItemFeatureLookuperRequest& req) {
+  is >> req.items;
+  return is;
+}
+
+inline OutputStream& operator<<(OutputStream& os,
+                                const ItemFeatureLookuperResponse& resp) {
+  os << resp.item_feats << resp.found;
+  return os;
+}
+
+inline InputStream& operator>>(InputStream& is,
+                               ItemFeatureLookuperResponse& resp) {
+  is >> resp.item_feats >> resp.found;
+  return is;
+}
+
+inline size_t WireSize(const ItemFeatureLookuperRequest& req) noexcept {
+  return WireSize(req.items);
+}
+
+inline size_t NodeSize(const ItemFeatureLookuperRequest& req) noexcept {
+  return req.items.size();
+}
+
+inline size_t WireSize(const ItemFeatureLookuperResponse& resp) noexcept {
+  return WireSize(resp.item_feats) + WireSize(resp.found);
+}
+
 }  // namespace embedx
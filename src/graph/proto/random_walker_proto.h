@@ -39,7 +39,7 @@ inline OutputStream& operator<<(OutputStream& os,
                                 const StaticRandomWalkerRequest& req) {
   os << req.cur_nodes << req.walk_lens << req.walker_info.meta_path
      << req.walker_info.walker_length << req.walker_info.prev_info.nodes
-     << req.walker_info.prev_info.contexts;
+     << req.walker_info.prev_info.contexts << req.walker_info.time_window;
   return os;
 }
 
@@ -47,7 +47,7 @@ inline InputStream& operator>>(InputStream& is,
                                StaticRandomWalkerRequest& req) {
   is >> req.cur_nodes >> req.walk_lens >> req.walker_info.meta_path >>
       req.walker_info.walker_length >> req.walker_info.prev_info.nodes >>
-      req.walker_info.prev_info.contexts;
+      req.walker_info.prev_info.contexts >> req.walker_info.time_window;
   return is;
 }
 
@@ -63,6 +63,23 @@ inline InputStream& operator>>(InputStream& is,
   return is;
 }
 
+inline size_t WireSize(const StaticRandomWalkerRequest& req) noexcept {
+  return WireSize(req.cur_nodes) + WireSize(req.walk_lens) +
+         WireSize(req.walker_info.meta_path) +
+         sizeof(req.walker_info.walker_length) +
+         WireSize(req.walker_info.prev_info.nodes) +
+         WireSize(req.walker_info.prev_info.contexts) +
+         WireSize(req.walker_info.time_window);
+}
+
+inline size_t NodeSize(const StaticRandomWalkerRequest& req) noexcept {
+  return req.cur_nodes.size();
+}
+
+inline size_t WireSize(const StaticRandomWalkerResponse& resp) noexcept {
+  return WireSize(resp.seqs);
+}
+
 /************************************************************************/
 /* Dynamic Random walker */
 /************************************************************************/
@@ -83,7 +100,7 @@ inline OutputStream& operator<<(OutputStream& os,
                                 const DynamicRandomWalkerRequest& req) {
   os << req.cur_nodes << req.walk_lens << req.walker_info.meta_path
      << req.walker_info.walker_length << req.walker_info.prev_info.nodes
-     << req.walker_info.prev_info.contexts;
+     << req.walker_info.prev_info.contexts << req.walker_info.time_window;
   return os;
 }
 
@@ -91,7 +108,7 @@ inline InputStream& operator>>(InputStream& is,
                                DynamicRandomWalkerRequest& req) {
   is >> req.cur_nodes >> req.walk_lens >> req.walker_info.meta_path >>
       req.walker_info.walker_length >> req.walker_info.prev_info.nodes >>
-      req.walker_info.prev_info.contexts;
+      req.walker_info.prev_info.contexts >> req.walker_info.time_window;
   return is;
 }
 
@@ -107,4 +124,22 @@ inline InputStream& operator>>(InputStream& is,
   return is;
 }
 
+inline size_t WireSize(const DynamicRandomWalkerRequest& req) noexcept {
+  return WireSize(req.cur_nodes) + WireSize(req.walk_lens) +
+         WireSize(req.walker_info.meta_path) +
+         sizeof(req.walker_info.walker_length) +
+         WireSize(req.walker_info.prev_info.nodes) +
+         WireSize(req.walker_info.prev_info.contexts) +
+         WireSize(req.walker_info.time_window);
+}
+
+inline size_t NodeSize(const DynamicRandomWalkerRequest& req) noexcept {
+  return req.cur_nodes.size();
+}
+
+inline size_t WireSize(const DynamicRandomWalkerResponse& resp) noexcept {
+  return WireSize(resp.seqs) + WireSize(resp.prev_info.nodes) +
+         WireSize(resp.prev_info.contexts);
+}
+
 }  // namespace embedx
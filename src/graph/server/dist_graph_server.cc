@@ -15,21 +15,29 @@
 #include <deepx_core/common/stream.h>
 #include <deepx_core/dx_log.h>
 
+#include <chrono>
 #include <string>
+#include <vector>
 
+#include "src/common/epoch.h"
 #include "src/graph/data_op/cache_node_lookuper_op/cache_node_lookuper.h"
 #include "src/graph/data_op/context_lookuper_op/context_lookuper.h"
 #include "src/graph/data_op/feature_lookuper_op/feature_lookuper.h"
+#include "src/graph/data_op/feature_lookuper_op/item_feature_lookuper.h"
 #include "src/graph/data_op/feature_lookuper_op/neighbor_feature_lookuper.h"
 #include "src/graph/data_op/feature_lookuper_op/node_feature_lookuper.h"
+#include "src/graph/data_op/graph_updater_op/graph_updater.h"
 #include "src/graph/data_op/gs_op.h"
 #include "src/graph/data_op/gs_op_factory.h"
+#include "src/graph/data_op/gs_op_stats.h"
 #include "src/graph/data_op/meta_lookuper_op/meta_lookuper.h"
 #include "src/graph/data_op/negative_sampler_op/indep_negative_sampler.h"
 #include "src/graph/data_op/negative_sampler_op/shared_negative_sampler.h"
 #include "src/graph/data_op/neighbor_sampler_op/random_neighbor_sampler.h"
 #include "src/graph/data_op/random_walker_op/static_random_walker.h"
 #include "src/graph/graph_config.h"
+#include "src/graph/proto/graph_service_proto.h"
+#include "src/graph/update_builder.h"
 
 namespace embedx {
 namespace {
@@ -42,6 +50,9 @@ void TouchSuccessFile(const GraphConfig& config) {
 
   std::string out_file =
       config.success_out() + "/_SUCCESS" + std::to_string(config.shard_id());
+  if (config.replica_id() > 0) {
+    out_file += "_" + std::to_string(config.replica_id());
+  }
   DXINFO("Touch 'success_out' file: %s.", out_file.c_str());
   deepx_core::AutoOutputFileStream os;
   DXCHECK_THROW(os.Open(out_file));
@@ -51,6 +62,8 @@ void TouchSuccessFile(const GraphConfig& config) {
 }  // namespace
 
 using ::embedx::graph_op::LocalGSOp;
+using ::embedx::graph_op::GSOpStatsRegistry;
+using ::embedx::graph_op::GSOpTimer;
 using ::embedx::graph_op::LocalGSOpFactory;
 using ::embedx::graph_op::LocalGSOpResource;
 
@@ -64,6 +77,7 @@ bool DistGraphServer::InitGraphServer(const GraphConfig& config) {
   if (!graph) {
     return false;
   }
+  InMemoryGraph* mutable_graph = graph.get();
   resource_->set_graph(std::move(graph));
 
   auto sampler_source = NewGraphSamplerSource(resource_->graph());
@@ -74,10 +88,13 @@ bool DistGraphServer::InitGraphServer(const GraphConfig& config) {
 
   auto negative_sampler_builder = NewSamplerBuilder(
       resource_->sampler_source(), SamplerBuilderEnum::NEGATIVE_SAMPLER,
-      config.negative_sampler_type(), config.thread_num());
+      config.negative_sampler_type(), config.thread_num(),
+      (float_t)config.negative_sampler_power());
   if (!negative_sampler_builder) {
     return false;
   }
+  SamplerBuilder* mutable_negative_sampler_builder =
+      negative_sampler_builder.get();
   resource_->set_negative_sampler_builder(std::move(negative_sampler_builder));
 
   auto neighbor_sampler_builder = NewSamplerBuilder(
@@ -86,22 +103,41 @@ bool DistGraphServer::InitGraphServer(const GraphConfig& config) {
   if (!neighbor_sampler_builder) {
     return false;
   }
+  SamplerBuilder* mutable_neighbor_sampler_builder =
+      neighbor_sampler_builder.get();
   resource_->set_neighbor_sampler_builder(std::move(neighbor_sampler_builder));
 
-  return LocalGSOpFactory::GetInstance()->Init(resource_.get());
+  auto update_builder = UpdateBuilder::Create(
+      mutable_graph, mutable_neighbor_sampler_builder,
+      mutable_negative_sampler_builder, config);
+  if (!update_builder) {
+    return false;
+  }
+  resource_->set_update_builder(std::move(update_builder));
+
+  op_factory_ = LocalGSOpFactory::Create();
+  return op_factory_->Init(resource_.get());
 }
 
 bool DistGraphServer::InitRpcServer(const GraphConfig& config) {
-  vec_str_t ip_ports;
-  deepx_core::Split(config.ip_ports(), ";", &ip_ports);
-  if (ip_ports.empty()) {
+  std::vector<vec_str_t> replica_ip_ports;
+  if (!SplitReplicaIpPorts(config.ip_ports(), &replica_ip_ports)) {
     DXERROR("Invalid graph server address: %s.", config.ip_ports().c_str());
     return false;
   }
 
+  int shard_id = config.shard_id();
+  int replica_id = config.replica_id();
+  if (shard_id >= (int)replica_ip_ports.size() ||
+      replica_id >= (int)replica_ip_ports[shard_id].size()) {
+    DXERROR("No address of shard: %d, replica: %d in: %s.", shard_id,
+            replica_id, config.ip_ports().c_str());
+    return false;
+  }
+
   deepx_core::TcpServerConfig tcp_config;
   tcp_config.listen_endpoint =
-      deepx_core::MakeTcpEndpoint(ip_ports[config.shard_id()]);
+      deepx_core::MakeTcpEndpoint(replica_ip_ports[shard_id][replica_id]);
   tcp_config.thread = config.thread_num();
   rpc_server_.set_config(tcp_config);
   return true;
@@ -109,16 +145,29 @@ bool DistGraphServer::InitRpcServer(const GraphConfig& config) {
 
 // The last declaration of DistGraphServer::Name() function is to avoid compile
 // warning of extra ';'
+//
+// Every handler records its latency, message sizes and node count in the
+// server op stats and returns the latency to the client in TimedResponse. It
+// pins the published epoch, so that all its reads see the same graph while
+// GraphUpdater updates it.
 #define DEFINE_REQUEST_HANDLER(Name)                                           \
   void DistGraphServer::Name() {                                               \
-    LocalGSOp* gs_op = LocalGSOpFactory::GetInstance()->LookupOrCreate(#Name); \
+    LocalGSOp* gs_op = op_factory_->LookupOrCreate(#Name);                     \
     DXCHECK(gs_op != nullptr);                                                 \
     auto* op = dynamic_cast<class ::embedx::graph_op::Name*>(gs_op);           \
     auto rpc_type = Name##Request::rpc_type();                                 \
-    rpc_server_.RegisterRequestHandler<Name##Request, Name##Response>(         \
-        rpc_type, [op](const Name##Request& req, Name##Response* resp) {       \
-          return op->HandleRpc(req, resp);                                     \
-        });                                                                    \
+    auto* stats = GSOpStatsRegistry::GetServerInstance()->Get(rpc_type, 0);    \
+    rpc_server_                                                                \
+        .RegisterRequestHandler<Name##Request, TimedResponse<Name##Response>>( \
+            rpc_type, [op, stats](const Name##Request& req,                    \
+                                  TimedResponse<Name##Response>* resp) {       \
+              GSOpTimer timer;                                                 \
+              EpochGuard guard;                                                \
+              int ret = op->HandleRpc(req, &resp->resp);                       \
+              resp->service_us = timer.ElapsedUs();                            \
+              stats->Add(req, resp->resp, resp->service_us, ret != 0);         \
+              return ret;                                                      \
+            });                                                                \
   }                                                                            \
   void DistGraphServer::Name()
 
@@ -126,12 +175,16 @@ DEFINE_REQUEST_HANDLER(MetaLookuper);
 DEFINE_REQUEST_HANDLER(FeatureLookuper);
 DEFINE_REQUEST_HANDLER(NodeFeatureLookuper);
 DEFINE_REQUEST_HANDLER(NeighborFeatureLookuper);
+DEFINE_REQUEST_HANDLER(EdgeFeatureLookuper);
+DEFINE_REQUEST_HANDLER(NodeFreqLookuper);
+DEFINE_REQUEST_HANDLER(ItemFeatureLookuper);
 DEFINE_REQUEST_HANDLER(ContextLookuper);
 DEFINE_REQUEST_HANDLER(RandomNeighborSampler);
 DEFINE_REQUEST_HANDLER(SharedNegativeSampler);
 DEFINE_REQUEST_HANDLER(IndepNegativeSampler);
 DEFINE_REQUEST_HANDLER(StaticRandomWalker);
 DEFINE_REQUEST_HANDLER(CacheNodeLookuper);
+DEFINE_REQUEST_HANDLER(GraphUpdater);
 
 #undef DEFINE_REQUEST_HANDLER
 
@@ -140,12 +193,16 @@ void DistGraphServer::RegisterRequestHandler() {
   FeatureLookuper();
   NodeFeatureLookuper();
   NeighborFeatureLookuper();
+  EdgeFeatureLookuper();
+  NodeFreqLookuper();
+  ItemFeatureLookuper();
   ContextLookuper();
   RandomNeighborSampler();
   SharedNegativeSampler();
   IndepNegativeSampler();
   StaticRandomWalker();
   CacheNodeLookuper();
+  GraphUpdater();
 }
 
 bool DistGraphServer::Start(const GraphConfig& config) {
@@ -160,9 +217,40 @@ bool DistGraphServer::Start(const GraphConfig& config) {
   }
 
   RegisterRequestHandler();
+  StartStatsDumper(config.stats_interval());
   TouchSuccessFile(config);
   rpc_server_.Run();
+  StopStatsDumper();
   return true;
 }
 
+void DistGraphServer::StartStatsDumper(int interval) {
+  if (interval <= 0) {
+    return;
+  }
+
+  stats_stop_ = false;
+  stats_thread_ = std::thread([this, interval]() {
+    std::unique_lock<std::mutex> guard(stats_mtx_);
+    while (!stats_cv_.wait_for(guard, std::chrono::seconds(interval),
+                               [this]() { return stats_stop_; })) {
+      DXINFO("Graph server op stats:\n%s",
+             GSOpStatsRegistry::GetServerInstance()->ToString().c_str());
+    }
+  });
+}
+
+void DistGraphServer::StopStatsDumper() {
+  if (!stats_thread_.joinable()) {
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> guard(stats_mtx_);
+    stats_stop_ = true;
+  }
+  stats_cv_.notify_all();
+  stats_thread_.join();
+}
+
 }  // namespace embedx
@@ -12,8 +12,12 @@
 #pragma once
 #include <deepx_core/ps/rpc_server.h>
 
+#include <condition_variable>
 #include <memory>  // std::unique_ptr
+#include <mutex>
+#include <thread>
 
+#include "src/graph/data_op/gs_op_factory.h"
 #include "src/graph/data_op/gs_op_resource.h"
 #include "src/graph/graph_config.h"
 #include "src/graph/in_memory_graph.h"
@@ -23,8 +27,16 @@ namespace embedx {
 class DistGraphServer {
  private:
   std::unique_ptr<graph_op::LocalGSOpResource> resource_;
+  // ops of this server, see LocalGSOpFactory::Create
+  std::unique_ptr<graph_op::LocalGSOpFactory> op_factory_;
   deepx_core::RpcServer rpc_server_;
 
+  // periodic dump of op stats
+  std::mutex stats_mtx_;
+  std::condition_variable stats_cv_;
+  bool stats_stop_ = false;
+  std::thread stats_thread_;
+
  public:
   bool Start(const GraphConfig& config);
 
@@ -32,6 +44,8 @@ class DistGraphServer {
   bool InitGraphServer(const GraphConfig& config);
   bool InitRpcServer(const GraphConfig& config);
   void RegisterRequestHandler();
+  void StartStatsDumper(int interval);
+  void StopStatsDumper();
 
  private:
 #define DECLARE_REQUEST_HANDLER(Name) void Name()
@@ -39,12 +53,16 @@ class DistGraphServer {
   DECLARE_REQUEST_HANDLER(FeatureLookuper);
   DECLARE_REQUEST_HANDLER(NodeFeatureLookuper);
   DECLARE_REQUEST_HANDLER(NeighborFeatureLookuper);
+  DECLARE_REQUEST_HANDLER(EdgeFeatureLookuper);
+  DECLARE_REQUEST_HANDLER(NodeFreqLookuper);
+  DECLARE_REQUEST_HANDLER(ItemFeatureLookuper);
   DECLARE_REQUEST_HANDLER(ContextLookuper);
   DECLARE_REQUEST_HANDLER(RandomNeighborSampler);
   DECLARE_REQUEST_HANDLER(SharedNegativeSampler);
   DECLARE_REQUEST_HANDLER(IndepNegativeSampler);
   DECLARE_REQUEST_HANDLER(StaticRandomWalker);
   DECLARE_REQUEST_HANDLER(CacheNodeLookuper);
+  DECLARE_REQUEST_HANDLER(GraphUpdater);
 
 #undef DECLARE_REQUEST_HANDLER
 };
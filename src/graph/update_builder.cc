@@ -0,0 +1,349 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/update_builder.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <cinttypes>  // PRIu64
+#include <initializer_list>
+#include <map>
+#include <unordered_map>
+#include <utility>  // std::move
+
+#include "src/common/epoch.h"
+#include "src/io/io_util.h"
+
+namespace embedx {
+namespace {
+
+void FoldAction(int op, float_t weight, UpdateBuilder::EdgeAction* action) {
+  switch ((EdgeUpdateEnum)op) {
+    case EdgeUpdateEnum::INSERT:
+    case EdgeUpdateEnum::DELETE:
+      action->op = op;
+      action->weight = weight;
+      break;
+    case EdgeUpdateEnum::REWEIGHT:
+      // reweighting a deleted edge does nothing
+      if (action->op != (int)EdgeUpdateEnum::DELETE) {
+        action->weight = weight;
+      }
+      break;
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<UpdateBuilder> UpdateBuilder::Create(
+    InMemoryGraph* graph, SamplerBuilder* neighbor_sampler_builder,
+    SamplerBuilder* negative_sampler_builder, const GraphConfig& config) {
+  std::unique_ptr<UpdateBuilder> update_builder;
+  if (graph == nullptr || neighbor_sampler_builder == nullptr ||
+      negative_sampler_builder == nullptr) {
+    DXERROR("Failed to create update builder, got nullptr.");
+    return update_builder;
+  }
+
+  update_builder.reset(new UpdateBuilder);
+  update_builder->graph_ = graph;
+  update_builder->neighbor_sampler_builder_ = neighbor_sampler_builder;
+  update_builder->negative_sampler_builder_ = negative_sampler_builder;
+  update_builder->shard_id_ = config.shard_id();
+  update_builder->negative_update_ratio_ = config.negative_update_ratio();
+  update_builder->ns_freqs_list_.resize(graph->ns_size());
+  return update_builder;
+}
+
+bool UpdateBuilder::Check(const vec_int_t& src_nodes,
+                          const vec_int_t& dst_nodes,
+                          const vec_float_t& weights,
+                          const vecl_t& ops) const {
+  if (src_nodes.size() != dst_nodes.size() ||
+      src_nodes.size() != weights.size() || src_nodes.size() != ops.size()) {
+    DXERROR("Need the same size of src_nodes: %zu, dst_nodes: %zu, weights: "
+            "%zu and ops: %zu.",
+            src_nodes.size(), dst_nodes.size(), weights.size(), ops.size());
+    return false;
+  }
+
+  const auto& id_name_map = graph_->id_name_map();
+  for (size_t i = 0; i < src_nodes.size(); ++i) {
+    for (auto node : {src_nodes[i], dst_nodes[i]}) {
+      auto ns_id = io_util::GetNodeType(node);
+      if (id_name_map.find(ns_id) == id_name_map.end()) {
+        DXERROR("Couldn't find node: %" PRIu64
+                " namespace id: %d in the config file.",
+                node, (int)ns_id);
+        return false;
+      }
+    }
+
+    if (ops[i] < (int)EdgeUpdateEnum::INSERT ||
+        ops[i] > (int)EdgeUpdateEnum::REWEIGHT) {
+      DXERROR("Need op: INSERT(0) || DELETE(1) || REWEIGHT(2), got op: %d.",
+              ops[i]);
+      return false;
+    }
+
+    // contexts of updates carry no timestamps
+    if (graph_->FindTimestamps(src_nodes[i]) != nullptr) {
+      DXERROR("Couldn't update node: %" PRIu64 " with timestamps.",
+              src_nodes[i]);
+      return false;
+    }
+
+    // the neighbor sampler needs positive weights
+    if (ops[i] != (int)EdgeUpdateEnum::DELETE && !(weights[i] > 0)) {
+      DXERROR("Weight %f of node: %" PRIu64 " and neighbor: %" PRIu64
+              " must be greater than 0.",
+              weights[i], src_nodes[i], dst_nodes[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool UpdateBuilder::CountsFreq(int_t src_node) const noexcept {
+  const Partitioner* partitioner = graph_->partitioner();
+  return partitioner == nullptr || !partitioner->IsHub(src_node) ||
+         partitioner->Shard(src_node) == shard_id_;
+}
+
+UpdateBuilder::NsFreqs* UpdateBuilder::GetNsFreqs(uint16_t ns_id) {
+  NsFreqs* ns_freqs = &ns_freqs_list_[ns_id];
+  if (!ns_freqs->init) {
+    ns_freqs->nodes = graph_->uniq_nodes_list()[ns_id];
+    ns_freqs->freqs = graph_->uniq_freqs_list()[ns_id];
+    ns_freqs->index.reserve(ns_freqs->nodes.size());
+    for (size_t i = 0; i < ns_freqs->nodes.size(); ++i) {
+      ns_freqs->index.emplace(ns_freqs->nodes[i], (int)i);
+    }
+    ns_freqs->init = true;
+  }
+  return ns_freqs;
+}
+
+float_t UpdateBuilder::GetFreq(int_t node) {
+  NsFreqs* ns_freqs = GetNsFreqs(io_util::GetNodeType(node));
+  auto it = ns_freqs->index.find(node);
+  return it == ns_freqs->index.end() ? 0 : ns_freqs->freqs[it->second];
+}
+
+void UpdateBuilder::SetFreq(int_t node, float_t freq) {
+  NsFreqs* ns_freqs = GetNsFreqs(io_util::GetNodeType(node));
+  auto it = ns_freqs->index.find(node);
+  if (it == ns_freqs->index.end()) {
+    if (freq > 0) {
+      ns_freqs->index.emplace(node, (int)ns_freqs->nodes.size());
+      ns_freqs->nodes.emplace_back(node);
+      ns_freqs->freqs.emplace_back(freq);
+    }
+    return;
+  }
+
+  int i = it->second;
+  if (freq > 0) {
+    ns_freqs->freqs[i] = freq;
+    return;
+  }
+
+  // a node no longer in the graph, move the last one to its place
+  int last = (int)ns_freqs->nodes.size() - 1;
+  ns_freqs->index.erase(it);
+  if (i != last) {
+    ns_freqs->nodes[i] = ns_freqs->nodes[last];
+    ns_freqs->freqs[i] = ns_freqs->freqs[last];
+    ns_freqs->index[ns_freqs->nodes[i]] = i;
+  }
+  ns_freqs->nodes.pop_back();
+  ns_freqs->freqs.pop_back();
+}
+
+void UpdateBuilder::AddFreq(int_t node, float_t delta,
+                            std::vector<std::pair<int_t, float_t>>* undo) {
+  float_t freq = GetFreq(node);
+  // a node not in the graph isn't removed again
+  if (freq <= 0 && delta <= 0) {
+    return;
+  }
+  undo->emplace_back(node, freq);
+  SetFreq(node, freq + delta);
+}
+
+bool UpdateBuilder::Apply(const vec_int_t& src_nodes,
+                          const vec_int_t& dst_nodes,
+                          const vec_float_t& weights, const vecl_t& ops,
+                          uint64_t* epoch) {
+  if (!Check(src_nodes, dst_nodes, weights, ops)) {
+    return false;
+  }
+
+  // group by source node, in the order of their first updates
+  vec_int_t uniq_src_nodes;
+  actions_t actions;
+  for (size_t i = 0; i < src_nodes.size(); ++i) {
+    auto it = actions.find(src_nodes[i]);
+    if (it == actions.end()) {
+      uniq_src_nodes.emplace_back(src_nodes[i]);
+      it = actions.emplace(src_nodes[i],
+                           std::unordered_map<int_t, EdgeAction>())
+               .first;
+    }
+    // an edge only reweighted so far is left alone if it doesn't exist
+    EdgeAction init_action{(int)EdgeUpdateEnum::REWEIGHT, weights[i], false};
+    auto& action = it->second.emplace(dst_nodes[i], init_action).first->second;
+    FoldAction(ops[i], weights[i], &action);
+  }
+
+  std::lock_guard<std::mutex> guard(mtx_);
+  auto* manager = EpochManager::GetInstance();
+  uint64_t new_epoch = manager->epoch() + 1;
+
+  // Pinned readers see nothing of the batch before Publish. A batch failing
+  // half way drops what it has staged and restores the frequencies, so that
+  // the next batch and a retry of this one start from the published state.
+  std::vector<std::pair<int_t, float_t>> freq_undo;
+  if (!Stage(uniq_src_nodes, &actions, new_epoch, &freq_undo)) {
+    graph_->Discard(new_epoch);
+    neighbor_sampler_builder_->Discard(new_epoch);
+    negative_sampler_builder_->Discard(new_epoch);
+    for (auto it = freq_undo.rbegin(); it != freq_undo.rend(); ++it) {
+      SetFreq(it->first, it->second);
+    }
+    return false;
+  }
+
+  manager->Publish(new_epoch);
+  update_num_ += src_nodes.size();
+
+  // What readers no longer see is freed, including what this batch replaced
+  // once later batches find no reader older than it.
+  uint64_t safe_epoch = manager->SafeEpoch();
+  graph_->Reclaim(safe_epoch);
+  neighbor_sampler_builder_->Reclaim(safe_epoch);
+  negative_sampler_builder_->Reclaim(safe_epoch);
+
+  *epoch = new_epoch;
+  return true;
+}
+
+bool UpdateBuilder::Stage(const vec_int_t& uniq_src_nodes, actions_t* actions,
+                          uint64_t new_epoch,
+                          std::vector<std::pair<int_t, float_t>>* freq_undo) {
+  index_map_t in_degree_deltas;
+  weight_map_t freq_deltas;
+  for (auto src_node : uniq_src_nodes) {
+    auto& src_actions = (*actions)[src_node];
+    const vec_pair_t* old_context =
+        graph_->FindContext(src_node, EpochManager::LATEST);
+    bool counts_freq = CountsFreq(src_node);
+    bool changed = false;
+
+    vec_pair_t context;
+    if (old_context != nullptr) {
+      context.reserve(old_context->size());
+      for (const auto& pair : *old_context) {
+        auto it = src_actions.find(pair.first);
+        if (it == src_actions.end()) {
+          context.emplace_back(pair);
+          continue;
+        }
+
+        EdgeAction& action = it->second;
+        action.found = true;
+        if (action.op == (int)EdgeUpdateEnum::DELETE) {
+          in_degree_deltas[pair.first] -= 1;
+          if (counts_freq) {
+            freq_deltas[pair.first] -= 1;
+          }
+          changed = true;
+        } else {
+          changed = changed || pair.second != action.weight;
+          context.emplace_back(pair.first, action.weight);
+        }
+      }
+    }
+
+    for (const auto& entry : src_actions) {
+      const EdgeAction& action = entry.second;
+      if (!action.found && action.op == (int)EdgeUpdateEnum::INSERT) {
+        context.emplace_back(entry.first, action.weight);
+        in_degree_deltas[entry.first] += 1;
+        if (counts_freq) {
+          freq_deltas[entry.first] += 1;
+        }
+        changed = true;
+      }
+    }
+
+    if (!changed) {
+      continue;
+    }
+
+    // a node counts once as a key
+    if (counts_freq) {
+      if (old_context == nullptr && !context.empty()) {
+        freq_deltas[src_node] += 1;
+      } else if (old_context != nullptr && context.empty()) {
+        freq_deltas[src_node] -= 1;
+      }
+    }
+
+    io_util::SortByNode(&context);
+    if (!neighbor_sampler_builder_->UpdateNode(
+            src_node, context.empty() ? nullptr : &context, new_epoch)) {
+      DXERROR("Failed to update the neighbor sampler of node: %" PRIu64 ".",
+              src_node);
+      return false;
+    }
+    graph_->UpdateContext(src_node, std::move(context), new_epoch);
+  }
+
+  for (const auto& entry : in_degree_deltas) {
+    if (entry.second != 0) {
+      int in_degree =
+          graph_->GetInDegree(entry.first, EpochManager::LATEST) + entry.second;
+      graph_->UpdateInDegree(entry.first, in_degree, new_epoch);
+    }
+  }
+
+  // namespace id -> its changed frequencies since the last rebuild
+  std::map<uint16_t, uint64_t> ns_pendings;
+  for (const auto& entry : freq_deltas) {
+    if (entry.second != 0) {
+      AddFreq(entry.first, entry.second, freq_undo);
+      ns_pendings[io_util::GetNodeType(entry.first)] += 1;
+    }
+  }
+  for (auto& entry : ns_pendings) {
+    const NsFreqs& ns_freqs = ns_freqs_list_[entry.first];
+    entry.second += ns_freqs.pending;
+    if (entry.second <= negative_update_ratio_ * ns_freqs.nodes.size()) {
+      continue;
+    }
+    if (!negative_sampler_builder_->UpdateNamespace(
+            entry.first, ns_freqs.nodes, ns_freqs.freqs, new_epoch)) {
+      DXERROR("Failed to update the negative sampler of namespace: %d.",
+              (int)entry.first);
+      return false;
+    }
+    entry.second = 0;
+  }
+
+  // nothing fails from here on
+  for (const auto& entry : ns_pendings) {
+    ns_freqs_list_[entry.first].pending = entry.second;
+  }
+  return true;
+}
+
+}  // namespace embedx
@@ -0,0 +1,125 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <cstdint>
+#include <memory>  // std::unique_ptr
+#include <mutex>
+#include <unordered_map>
+#include <utility>  // std::pair
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/graph/graph_config.h"
+#include "src/graph/in_memory_graph.h"
+#include "src/sampler/sampler_builder.h"
+
+namespace embedx {
+
+enum class EdgeUpdateEnum : int {
+  INSERT = 0,    // add an edge, or set the weight of an existing one
+  DELETE = 1,    // remove an edge
+  REWEIGHT = 2,  // set the weight of an existing edge
+};
+
+// UpdateBuilder applies batches of edge updates to the graph of a running
+// graph server.
+//
+// A batch is staged at epoch 'EpochManager::epoch() + 1' and published at
+// once: the new contexts and in degrees of the graph, the neighbor samplings
+// of the updated nodes and the negative sampling tables of the touched
+// namespaces. Readers pinning an older epoch keep the old data, see
+// EpochGuard. A batch failing half way is dropped as a whole, and updates are
+// idempotent, so a retried batch does no harm.
+//
+// Frequencies follow PostBuilder, a node counts once as a key and once per
+// appearance in a context. Hubs replicated from other shards don't count.
+//
+// The negative sampling table of a namespace is rebuilt from all its nodes,
+// which costs O(namespace size). To keep the cost of a batch near its own
+// size, a namespace is rebuilt only once the nodes whose frequencies changed
+// since its last rebuild exceed 'negative_update_ratio' of its nodes, so the
+// table lags behind by at most that ratio. 0 rebuilds on every batch.
+//
+// Nodes loaded with timestamps can't be updated, updates carry none.
+class UpdateBuilder {
+ public:
+  // the result of the updates of an edge in a batch
+  struct EdgeAction {
+    int op;
+    float_t weight;
+    bool found;
+  };
+  // source node -> destination node -> action
+  using actions_t =
+      std::unordered_map<int_t, std::unordered_map<int_t, EdgeAction>>;
+
+ private:
+  // frequencies of a namespace, copied from the graph on its first update
+  struct NsFreqs {
+    bool init = false;
+    vec_int_t nodes;
+    vec_float_t freqs;
+    index_map_t index;
+    // changed frequencies since the last rebuild of the sampling table
+    uint64_t pending = 0;
+  };
+
+  InMemoryGraph* graph_ = nullptr;
+  SamplerBuilder* neighbor_sampler_builder_ = nullptr;
+  SamplerBuilder* negative_sampler_builder_ = nullptr;
+  int shard_id_ = 0;
+  double negative_update_ratio_ = 0;
+
+  std::mutex mtx_;
+  std::vector<NsFreqs> ns_freqs_list_;
+  uint64_t update_num_ = 0;
+
+ public:
+  static std::unique_ptr<UpdateBuilder> Create(
+      InMemoryGraph* graph, SamplerBuilder* neighbor_sampler_builder,
+      SamplerBuilder* negative_sampler_builder, const GraphConfig& config);
+
+ public:
+  // Applies the edges 'src_nodes[i]' -> 'dst_nodes[i]' with 'weights[i]' and
+  // 'ops[i]' in order, and returns the epoch they are visible from.
+  //
+  // A batch with an invalid update is rejected as a whole.
+  bool Apply(const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+             const vec_float_t& weights, const vecl_t& ops, uint64_t* epoch);
+
+  // number of applied edge updates
+  uint64_t update_num() {
+    std::lock_guard<std::mutex> guard(mtx_);
+    return update_num_;
+  }
+
+ private:
+  bool Check(const vec_int_t& src_nodes, const vec_int_t& dst_nodes,
+             const vec_float_t& weights, const vecl_t& ops) const;
+  bool CountsFreq(int_t src_node) const noexcept;
+  NsFreqs* GetNsFreqs(uint16_t ns_id);
+  float_t GetFreq(int_t node);
+  // a frequency <= 0 removes 'node'
+  void SetFreq(int_t node, float_t freq);
+  // Adds 'delta' and puts the old frequency in 'undo'.
+  void AddFreq(int_t node, float_t delta,
+               std::vector<std::pair<int_t, float_t>>* undo);
+  // Stages the updates of a checked batch at 'new_epoch'.
+  bool Stage(const vec_int_t& uniq_src_nodes, actions_t* actions,
+             uint64_t new_epoch,
+             std::vector<std::pair<int_t, float_t>>* freq_undo);
+
+ private:
+  UpdateBuilder() = default;
+};
+
+}  // namespace embedx
@@ -0,0 +1,250 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/graph/update_builder.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>  // std::unique_ptr
+#include <string>
+
+#include "src/common/data_types.h"
+#include "src/common/epoch.h"
+#include "src/graph/graph_config.h"
+#include "src/graph/in_memory_graph.h"
+#include "src/sampler/sampler_builder.h"
+#include "src/sampler/sampler_source.h"
+#include "src/sampler/sampling.h"
+
+namespace embedx {
+namespace {
+
+// fails the first 'fail_num' namespace updates of 'builder'
+class FailingSamplerBuilder : public SamplerBuilder {
+ private:
+  SamplerBuilder* builder_;
+  int fail_num_;
+  int update_num_ = 0;
+
+ public:
+  FailingSamplerBuilder(SamplerBuilder* builder, int fail_num)
+      : SamplerBuilder(&builder->sampler_source(), builder->sampling_type(),
+                       1),
+        builder_(builder),
+        fail_num_(fail_num) {}
+
+ public:
+  int update_num() const noexcept { return update_num_; }
+
+  bool UpdateNamespace(uint16_t ns_id, const vec_int_t& nodes,
+                       const vec_float_t& freqs, uint64_t epoch) override {
+    ++update_num_;
+    if (fail_num_ > 0) {
+      --fail_num_;
+      return false;
+    }
+    return builder_->UpdateNamespace(ns_id, nodes, freqs, epoch);
+  }
+  void Discard(uint64_t epoch) override { builder_->Discard(epoch); }
+  void Reclaim(uint64_t safe_epoch) override { builder_->Reclaim(safe_epoch); }
+
+ private:
+  bool InitUniformFuncs() override { return true; }
+  bool InitFrequencySampler() override { return true; }
+  bool InitFrequencyFuncs() override { return true; }
+};
+
+}  // namespace
+
+class UpdateBuilderTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<InMemoryGraph> graph_;
+  std::unique_ptr<SamplerSource> sampler_source_;
+  std::unique_ptr<SamplerBuilder> neighbor_sampler_builder_;
+  std::unique_ptr<SamplerBuilder> negative_sampler_builder_;
+  std::unique_ptr<UpdateBuilder> update_builder_;
+  GraphConfig config_;
+
+ protected:
+  const std::string CONTEXT = "testdata/context";
+  const int THREAD_NUM = 3;
+
+ protected:
+  void SetUp() override {
+    config_.set_node_graph(CONTEXT);
+    config_.set_shard_num(1);
+    config_.set_shard_id(0);
+    config_.set_thread_num(THREAD_NUM);
+
+    graph_ = InMemoryGraph::Create(config_);
+    ASSERT_TRUE(graph_ != nullptr);
+    sampler_source_ = NewGraphSamplerSource(graph_.get());
+    neighbor_sampler_builder_ = NewSamplerBuilder(
+        sampler_source_.get(), SamplerBuilderEnum::NEIGHBOR_SAMPLER,
+        (int)SamplingEnum::ALIAS, THREAD_NUM);
+    ASSERT_TRUE(neighbor_sampler_builder_ != nullptr);
+    negative_sampler_builder_ = NewSamplerBuilder(
+        sampler_source_.get(), SamplerBuilderEnum::NEGATIVE_SAMPLER,
+        (int)SamplingEnum::ALIAS, THREAD_NUM);
+    ASSERT_TRUE(negative_sampler_builder_ != nullptr);
+
+    update_builder_ = UpdateBuilder::Create(
+        graph_.get(), neighbor_sampler_builder_.get(),
+        negative_sampler_builder_.get(), config_);
+    ASSERT_TRUE(update_builder_ != nullptr);
+  }
+};
+
+TEST_F(UpdateBuilderTest, Apply) {
+  // node 0: 12:1.1 11:1.2 10:1.3
+  vec_int_t src_nodes = {0, 0, 0};
+  vec_int_t dst_nodes = {5, 12, 11};
+  vec_float_t weights = {2.0, 0, 3.0};
+  vecl_t ops = {(int)EdgeUpdateEnum::INSERT, (int)EdgeUpdateEnum::DELETE,
+                (int)EdgeUpdateEnum::REWEIGHT};
+  uint64_t old_epoch = EpochManager::GetInstance()->epoch();
+  uint64_t epoch = 0;
+  EXPECT_TRUE(
+      update_builder_->Apply(src_nodes, dst_nodes, weights, ops, &epoch));
+  EXPECT_EQ(epoch, old_epoch + 1);
+  EXPECT_EQ(update_builder_->update_num(), 3u);
+  EXPECT_EQ(graph_->updated_node_size(), 1u);
+
+  // new context, sorted by node
+  const vec_pair_t* context = graph_->FindContext(0);
+  ASSERT_TRUE(context != nullptr);
+  ASSERT_EQ(context->size(), 3u);
+  EXPECT_EQ((*context)[0].first, (int_t)5);
+  EXPECT_EQ((*context)[1].first, (int_t)10);
+  EXPECT_EQ((*context)[2].first, (int_t)11);
+  EXPECT_FLOAT_EQ((*context)[2].second, 3.0);
+  EXPECT_EQ(graph_->GetInDegree(5), 4);
+  EXPECT_EQ(graph_->GetInDegree(12), 2);
+  EXPECT_EQ(graph_->GetOutDegree(0), 3);
+
+  // old epoch still sees the loaded context
+  context = graph_->FindContext(0, old_epoch);
+  ASSERT_TRUE(context != nullptr);
+  EXPECT_EQ(context->size(), 3u);
+  EXPECT_EQ(graph_->GetInDegree(5, old_epoch), 3);
+
+  // the neighbor sampler follows the new context
+  for (int i = 0; i < 100; ++i) {
+    int_t next;
+    EXPECT_TRUE(neighbor_sampler_builder_->Next(0, &next));
+    EXPECT_NE(next, (int_t)12);
+  }
+
+  // retried batch does nothing
+  EXPECT_TRUE(
+      update_builder_->Apply(src_nodes, dst_nodes, weights, ops, &epoch));
+  EXPECT_EQ(graph_->GetInDegree(5), 4);
+  EXPECT_EQ(graph_->FindContext(0)->size(), 3u);
+}
+
+TEST_F(UpdateBuilderTest, Apply_RemoveNode) {
+  vec_int_t src_nodes = {3, 3, 3};
+  vec_int_t dst_nodes = {2, 1, 0};
+  vec_float_t weights = {0, 0, 0};
+  vecl_t ops(3, (int)EdgeUpdateEnum::DELETE);
+  uint64_t epoch = 0;
+  EXPECT_TRUE(
+      update_builder_->Apply(src_nodes, dst_nodes, weights, ops, &epoch));
+  EXPECT_TRUE(graph_->FindContext(3) == nullptr);
+  EXPECT_EQ(graph_->GetOutDegree(3), 0);
+  EXPECT_EQ(graph_->GetInDegree(0), 2);
+
+  int_t next;
+  EXPECT_FALSE(neighbor_sampler_builder_->Next(3, &next));
+}
+
+TEST_F(UpdateBuilderTest, Apply_Invalid) {
+  uint64_t epoch = 0;
+  // size mismatch
+  EXPECT_FALSE(update_builder_->Apply({0}, {1, 2}, {1.0}, {0}, &epoch));
+  // unknown op
+  EXPECT_FALSE(update_builder_->Apply({0}, {1}, {1.0}, {3}, &epoch));
+  // non-positive weight
+  EXPECT_FALSE(update_builder_->Apply({0}, {1}, {0}, {0}, &epoch));
+  EXPECT_EQ(update_builder_->update_num(), 0u);
+  EXPECT_EQ(graph_->updated_node_size(), 0u);
+}
+
+TEST_F(UpdateBuilderTest, Apply_FailAndRetry) {
+  FailingSamplerBuilder failing_builder(negative_sampler_builder_.get(), 1);
+  update_builder_ = UpdateBuilder::Create(
+      graph_.get(), neighbor_sampler_builder_.get(), &failing_builder, config_);
+  ASSERT_TRUE(update_builder_ != nullptr);
+
+  // node 0: 12:1.1 11:1.2 10:1.3
+  vec_int_t src_nodes = {0, 0};
+  vec_int_t dst_nodes = {5, 12};
+  vec_float_t weights = {2.0, 0};
+  vecl_t ops = {(int)EdgeUpdateEnum::INSERT, (int)EdgeUpdateEnum::DELETE};
+  uint64_t old_epoch = EpochManager::GetInstance()->epoch();
+  uint64_t epoch = 0;
+
+  // the negative sampler fails after the contexts are staged
+  EXPECT_FALSE(
+      update_builder_->Apply(src_nodes, dst_nodes, weights, ops, &epoch));
+  EXPECT_EQ(EpochManager::GetInstance()->epoch(), old_epoch);
+  EXPECT_EQ(update_builder_->update_num(), 0u);
+  const vec_pair_t* context = graph_->FindContext(0);
+  ASSERT_TRUE(context != nullptr);
+  ASSERT_EQ(context->size(), 3u);
+  for (const auto& pair : *context) {
+    EXPECT_NE(pair.first, (int_t)5);
+  }
+  EXPECT_EQ(graph_->GetInDegree(5), 3);
+  EXPECT_EQ(graph_->GetInDegree(12), 3);
+  for (int i = 0; i < 100; ++i) {
+    int_t next;
+    EXPECT_TRUE(neighbor_sampler_builder_->Next(0, &next));
+    EXPECT_NE(next, (int_t)5);
+  }
+
+  // the retry is applied once at the same epoch
+  EXPECT_TRUE(
+      update_builder_->Apply(src_nodes, dst_nodes, weights, ops, &epoch));
+  EXPECT_EQ(epoch, old_epoch + 1);
+  context = graph_->FindContext(0);
+  ASSERT_TRUE(context != nullptr);
+  ASSERT_EQ(context->size(), 3u);
+  EXPECT_EQ((*context)[0].first, (int_t)5);
+  EXPECT_EQ(graph_->GetInDegree(5), 4);
+  EXPECT_EQ(graph_->GetInDegree(12), 2);
+
+  // so is a later batch
+  EXPECT_TRUE(update_builder_->Apply({1}, {5}, {1.0}, {0}, &epoch));
+  EXPECT_EQ(epoch, old_epoch + 2);
+  EXPECT_EQ(graph_->GetInDegree(5), 5);
+}
+
+TEST_F(UpdateBuilderTest, Apply_NegativeUpdateRatio) {
+  // 13 nodes, rebuilt after 3 changed frequencies
+  config_.set_negative_update_ratio(0.2);
+  FailingSamplerBuilder counting_builder(negative_sampler_builder_.get(), 0);
+  update_builder_ = UpdateBuilder::Create(graph_.get(),
+                                          neighbor_sampler_builder_.get(),
+                                          &counting_builder, config_);
+  ASSERT_TRUE(update_builder_ != nullptr);
+
+  uint64_t epoch = 0;
+  EXPECT_TRUE(update_builder_->Apply({0}, {5}, {1.0}, {0}, &epoch));
+  EXPECT_TRUE(update_builder_->Apply({1}, {6}, {1.0}, {0}, &epoch));
+  EXPECT_EQ(counting_builder.update_num(), 0);
+  EXPECT_TRUE(update_builder_->Apply({2}, {7}, {1.0}, {0}, &epoch));
+  EXPECT_EQ(counting_builder.update_num(), 1);
+  EXPECT_TRUE(update_builder_->Apply({3}, {8}, {1.0}, {0}, &epoch));
+  EXPECT_EQ(counting_builder.update_num(), 1);
+}
+
+}  // namespace embedx
@@ -0,0 +1,103 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/async_writer.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <utility>  // std::move
+
+namespace embedx {
+
+bool AsyncWriter::Open(const std::string& file, int max_pending) {
+  Close();
+  if (!ofs_.Open(file)) {
+    DXERROR("Failed to open: %s.", file.c_str());
+    return false;
+  }
+
+  file_ = file;
+  max_pending_ = max_pending > 0 ? max_pending : 1;
+  closing_ = false;
+  failed_ = false;
+  thread_ = std::thread(&AsyncWriter::Run, this);
+  return true;
+}
+
+bool AsyncWriter::Write(std::string* buf) {
+  std::unique_lock<std::mutex> guard(mtx_);
+  cond_.wait(guard, [this]() {
+    return failed_ || (int)pending_.size() < max_pending_;
+  });
+  if (failed_) {
+    return false;
+  }
+
+  pending_.emplace_back(std::move(*buf));
+  if (free_.empty()) {
+    buf->clear();
+  } else {
+    buf->swap(free_.back());
+    free_.pop_back();
+  }
+  cond_.notify_all();
+  return true;
+}
+
+bool AsyncWriter::Close() {
+  if (!thread_.joinable()) {
+    return !failed_;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(mtx_);
+    closing_ = true;
+  }
+  cond_.notify_all();
+  thread_.join();
+  ofs_.Close();
+  free_.clear();
+  return !failed_;
+}
+
+void AsyncWriter::Run() {
+  std::string buf;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> guard(mtx_);
+      cond_.wait(guard, [this]() { return closing_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      buf.swap(pending_.front());
+      pending_.pop_front();
+      cond_.notify_all();
+    }
+
+    ofs_.Write(buf.data(), buf.size());
+    std::lock_guard<std::mutex> guard(mtx_);
+    if (!ofs_) {
+      DXERROR("Failed to write: %s.", file_.c_str());
+      failed_ = true;
+      pending_.clear();
+      cond_.notify_all();
+      return;
+    }
+
+    buf.clear();
+    if ((int)free_.size() < max_pending_) {
+      free_.emplace_back();
+      free_.back().swap(buf);
+    }
+  }
+}
+
+}  // namespace embedx
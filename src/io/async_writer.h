@@ -0,0 +1,62 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <deepx_core/common/stream.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace embedx {
+
+// AsyncWriter writes buffers to a file in a background thread, so formatting
+// the next buffer overlaps writing the previous ones.
+//
+// At most 'max_pending' buffers are queued, Write blocks when the writer falls
+// behind. Written buffers are recycled to keep their memory.
+class AsyncWriter {
+ private:
+  deepx_core::AutoOutputFileStream ofs_;
+  std::string file_;
+  int max_pending_ = 4;
+
+  std::thread thread_;
+  std::mutex mtx_;
+  std::condition_variable cond_;
+  std::deque<std::string> pending_;
+  std::vector<std::string> free_;
+  bool closing_ = false;
+  bool failed_ = false;
+
+ public:
+  AsyncWriter() = default;
+  ~AsyncWriter() { Close(); }
+  AsyncWriter(const AsyncWriter&) = delete;
+  AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+ public:
+  bool Open(const std::string& file, int max_pending = 4);
+  // Queues '*buf' and hands back a recycled empty buffer in '*buf'.
+  // Returns false if an earlier write failed.
+  bool Write(std::string* buf);
+  // Writes the queued buffers and closes the file, returns false if any
+  // write failed.
+  bool Close();
+
+ private:
+  void Run();
+};
+
+}  // namespace embedx
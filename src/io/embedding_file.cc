@@ -0,0 +1,239 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/embedding_file.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <cmath>    // std::nearbyint
+#include <cstring>  // std::memcpy
+
+#include "src/io/line_parser.h"
+#include "src/io/value.h"
+
+namespace embedx {
+namespace {
+
+static_assert(sizeof(EmbeddingFileHeader) == 32,
+              "EmbeddingFileHeader must be 32 bytes.");
+static_assert(sizeof(int_t) == 8, "int_t must be 8 bytes.");
+
+constexpr int TEXT_BATCH = 1024;
+
+template <typename T>
+void AppendPod(const T* data, size_t n, std::string* buf) {
+  buf->append((const char*)data, n * sizeof(T));
+}
+
+}  // namespace
+
+uint16_t FloatToHalf(float value) noexcept {
+  uint32_t x;
+  std::memcpy(&x, &value, sizeof(x));
+  auto sign = (uint16_t)((x >> 16) & 0x8000);
+  uint32_t abs_x = x & 0x7fffffff;
+
+  if (abs_x >= 0x7f800000) {
+    // inf or nan
+    return (uint16_t)(sign | 0x7c00 | (abs_x > 0x7f800000 ? 0x200 : 0));
+  }
+  if (abs_x >= 0x477ff000) {
+    // 65520 and above round to inf
+    return (uint16_t)(sign | 0x7c00);
+  }
+  if (abs_x < 0x38800000) {
+    // subnormal halfs are multiples of 2^-24, ties to even
+    float abs_value;
+    std::memcpy(&abs_value, &abs_x, sizeof(abs_value));
+    return (uint16_t)(sign | (uint16_t)std::nearbyint(abs_value * 16777216.0f));
+  }
+
+  // rebias the exponent and round the mantissa to 10 bits, ties to even
+  abs_x += 0xc8000fff + ((abs_x >> 13) & 1);
+  return (uint16_t)(sign | (abs_x >> 13));
+}
+
+float HalfToFloat(uint16_t value) noexcept {
+  uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+  uint32_t exp = (value >> 10) & 0x1f;
+  uint32_t mantissa = value & 0x3ff;
+  uint32_t x;
+  if (exp == 0) {
+    float abs_value = (float)mantissa * 5.9604644775390625e-8f;  // 2^-24
+    std::memcpy(&x, &abs_value, sizeof(x));
+    x |= sign;
+  } else if (exp == 0x1f) {
+    x = sign | 0x7f800000 | (mantissa << 13);
+  } else {
+    x = sign | ((exp + 112) << 23) | (mantissa << 13);
+  }
+
+  float f;
+  std::memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
+void AppendEmbeddingHeader(EmbeddingDtypeEnum dtype, int dim,
+                           std::string* buf) {
+  EmbeddingFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = EMBEDDING_FILE_MAGIC;
+  header.version = EMBEDDING_FILE_VERSION;
+  header.dtype = (uint32_t)dtype;
+  header.dim = (uint32_t)dim;
+  AppendPod(&header, 1, buf);
+}
+
+void AppendEmbeddingBlock(EmbeddingDtypeEnum dtype, int dim, const int_t* ids,
+                          const float* values, int n, std::string* buf) {
+  auto count = (uint64_t)n;
+  AppendPod(&count, 1, buf);
+  AppendPod(ids, (size_t)n, buf);
+
+  size_t value_size = (size_t)n * dim;
+  if (dtype == EmbeddingDtypeEnum::FLOAT32) {
+    AppendPod(values, value_size, buf);
+    return;
+  }
+
+  size_t offset = buf->size();
+  buf->resize(offset + value_size * sizeof(uint16_t));
+  char* data = &(*buf)[offset];
+  for (size_t i = 0; i < value_size; ++i) {
+    uint16_t half = FloatToHalf(values[i]);
+    std::memcpy(data + i * sizeof(half), &half, sizeof(half));
+  }
+}
+
+bool IsEmbeddingFile(const std::string& file) {
+  deepx_core::AutoInputFileStream is;
+  if (!is.Open(file)) {
+    return false;
+  }
+
+  uint32_t magic = 0;
+  return is.Read(&magic, sizeof(magic)) == sizeof(magic) &&
+         magic == EMBEDDING_FILE_MAGIC;
+}
+
+bool ReadEmbeddingFile(const std::string& file, const embedding_func_t& func) {
+  vec_int_t ids;
+  std::vector<float> values;
+  if (IsEmbeddingFile(file)) {
+    EmbeddingFileReader reader;
+    if (!reader.Open(file)) {
+      return false;
+    }
+    while (reader.NextBlock(&ids, &values)) {
+      if (!func(ids, values, reader.dim())) {
+        return false;
+      }
+    }
+    return !reader.failed();
+  }
+
+  LineParser line_parser;
+  if (!line_parser.Open(file)) {
+    return false;
+  }
+
+  std::vector<EmbeddingValue> embedding_values;
+  while (line_parser.NextBatch<EmbeddingValue>(TEXT_BATCH,
+                                               &embedding_values)) {
+    int dim = (int)embedding_values[0].embedding.size();
+    ids.clear();
+    values.clear();
+    for (const auto& value : embedding_values) {
+      if ((int)value.embedding.size() != dim) {
+        DXERROR("Need the same dim of embeddings, got %d vs %zu in: %s.", dim,
+                value.embedding.size(), file.c_str());
+        return false;
+      }
+      ids.emplace_back(value.node);
+      values.insert(values.end(), value.embedding.begin(),
+                    value.embedding.end());
+    }
+    if (!func(ids, values, dim)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool EmbeddingFileReader::Open(const std::string& file) {
+  failed_ = false;
+  is_.Close();
+  if (!is_.Open(file)) {
+    DXERROR("Failed to open: %s.", file.c_str());
+    return false;
+  }
+
+  file_ = file;
+  bool eof;
+  if (!ReadFull(&header_, sizeof(header_), &eof) ||
+      header_.magic != EMBEDDING_FILE_MAGIC ||
+      header_.version != EMBEDDING_FILE_VERSION) {
+    DXERROR("Not an embedding file or unsupported version: %s.",
+            file.c_str());
+    return false;
+  }
+
+  if ((header_.dtype != (uint32_t)EmbeddingDtypeEnum::FLOAT32 &&
+       header_.dtype != (uint32_t)EmbeddingDtypeEnum::FLOAT16) ||
+      header_.dim == 0) {
+    DXERROR("Invalid dtype: %u or dim: %u of: %s.", header_.dtype,
+            header_.dim, file.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool EmbeddingFileReader::ReadFull(void* data, size_t size, bool* eof) {
+  size_t read_size = is_.Read(data, size);
+  *eof = read_size == 0;
+  return read_size == size;
+}
+
+bool EmbeddingFileReader::NextBlock(vec_int_t* ids,
+                                    std::vector<float>* values) {
+  uint64_t count;
+  bool eof;
+  if (!ReadFull(&count, sizeof(count), &eof)) {
+    if (!eof) {
+      DXERROR("Truncated block of: %s.", file_.c_str());
+      failed_ = true;
+    }
+    return false;
+  }
+
+  size_t value_size = (size_t)count * header_.dim;
+  ids->resize((size_t)count);
+  values->resize(value_size);
+  bool ok = ReadFull(ids->data(), ids->size() * sizeof(int_t), &eof);
+  if (ok && dtype() == EmbeddingDtypeEnum::FLOAT32) {
+    ok = ReadFull(values->data(), value_size * sizeof(float), &eof);
+  } else if (ok) {
+    halfs_.resize(value_size);
+    ok = ReadFull(halfs_.data(), value_size * sizeof(uint16_t), &eof);
+    for (size_t i = 0; ok && i < value_size; ++i) {
+      (*values)[i] = HalfToFloat(halfs_[i]);
+    }
+  }
+
+  if (!ok) {
+    DXERROR("Truncated block of: %s.", file_.c_str());
+    failed_ = true;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace embedx
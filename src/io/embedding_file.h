@@ -0,0 +1,92 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <deepx_core/common/stream.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+enum class EmbeddingDtypeEnum : int {
+  FLOAT32 = 0,
+  FLOAT16 = 1,
+};
+
+// Binary embedding file.
+//
+// A file is a 32 bytes header and blocks. A block is an uint64 row count 'n',
+// 'n' uint64 node ids and the 'n * dim' embedding matrix in row major of the
+// dtype of the header, all in little endian. A block is appended per batch,
+// so files are written without knowing the number of rows, to hdfs as well.
+struct EmbeddingFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t dtype;
+  uint32_t dim;
+  uint64_t reserved[2];
+};
+
+constexpr uint32_t EMBEDDING_FILE_MAGIC = 0x454d4258;  // "XBME"
+constexpr uint32_t EMBEDDING_FILE_VERSION = 1;
+
+uint16_t FloatToHalf(float value) noexcept;
+float HalfToFloat(uint16_t value) noexcept;
+
+// Appends the header or a block of 'n' rows to 'buf'.
+void AppendEmbeddingHeader(EmbeddingDtypeEnum dtype, int dim,
+                           std::string* buf);
+void AppendEmbeddingBlock(EmbeddingDtypeEnum dtype, int dim, const int_t* ids,
+                          const float* values, int n, std::string* buf);
+
+// Returns true if 'file' starts with the magic of embedding files.
+bool IsEmbeddingFile(const std::string& file);
+
+// 'n' rows of 'ids' and the 'n * dim' embeddings 'values'
+using embedding_func_t = std::function<bool(
+    const vec_int_t& ids, const std::vector<float>& values, int dim)>;
+
+// Reads a binary embedding file or a text one of 'node val0 val1 ...' lines,
+// and calls 'func' for each batch of rows. Rows of a batch have the same dim.
+bool ReadEmbeddingFile(const std::string& file, const embedding_func_t& func);
+
+// EmbeddingFileReader reads binary embedding files block by block.
+class EmbeddingFileReader {
+ private:
+  deepx_core::AutoInputFileStream is_;
+  std::string file_;
+  EmbeddingFileHeader header_;
+  std::vector<uint16_t> halfs_;
+  bool failed_ = false;
+
+ public:
+  bool Open(const std::string& file);
+  EmbeddingDtypeEnum dtype() const noexcept {
+    return (EmbeddingDtypeEnum)header_.dtype;
+  }
+  int dim() const noexcept { return (int)header_.dim; }
+  // true if a block is truncated
+  bool failed() const noexcept { return failed_; }
+
+  // Reads the next block, 'values' are float32 of any dtype.
+  // Returns false at the end of the file or if it fails.
+  bool NextBlock(vec_int_t* ids, std::vector<float>* values);
+
+ private:
+  bool ReadFull(void* data, size_t size, bool* eof);
+};
+
+}  // namespace embedx
@@ -0,0 +1,177 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/embedding_file.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>  // std::remove
+#include <string>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/io/async_writer.h"
+
+namespace embedx {
+
+class EmbeddingFileTest : public ::testing::Test {
+ protected:
+  const int DIM = 4;
+  const int BLOCK_NUM = 3;
+  const int BLOCK_SIZE = 100;
+  const std::string FILE = "embedding_file_test.bin";
+
+  // Writes 'BLOCK_NUM' blocks through AsyncWriter.
+  void Write(EmbeddingDtypeEnum dtype, vec_int_t* all_ids,
+             std::vector<float>* all_values) const {
+    AsyncWriter writer;
+    ASSERT_TRUE(writer.Open(FILE, 2));
+    std::string buf;
+    AppendEmbeddingHeader(dtype, DIM, &buf);
+    for (int i = 0; i < BLOCK_NUM; ++i) {
+      vec_int_t ids;
+      std::vector<float> values;
+      for (int j = 0; j < BLOCK_SIZE; ++j) {
+        ids.emplace_back((int_t)(i * BLOCK_SIZE + j));
+        for (int k = 0; k < DIM; ++k) {
+          values.emplace_back((float)(i * BLOCK_SIZE + j) * 0.25f - k);
+        }
+      }
+      AppendEmbeddingBlock(dtype, DIM, ids.data(), values.data(), BLOCK_SIZE,
+                           &buf);
+      ASSERT_TRUE(writer.Write(&buf));
+      EXPECT_TRUE(buf.empty());
+      all_ids->insert(all_ids->end(), ids.begin(), ids.end());
+      all_values->insert(all_values->end(), values.begin(), values.end());
+    }
+    ASSERT_TRUE(writer.Close());
+  }
+
+  void Read(vec_int_t* all_ids, std::vector<float>* all_values,
+            EmbeddingDtypeEnum* dtype) const {
+    EmbeddingFileReader reader;
+    ASSERT_TRUE(reader.Open(FILE));
+    EXPECT_EQ(reader.dim(), DIM);
+    *dtype = reader.dtype();
+    vec_int_t ids;
+    std::vector<float> values;
+    while (reader.NextBlock(&ids, &values)) {
+      all_ids->insert(all_ids->end(), ids.begin(), ids.end());
+      all_values->insert(all_values->end(), values.begin(), values.end());
+    }
+    EXPECT_FALSE(reader.failed());
+  }
+
+  void TearDown() override { std::remove(FILE.c_str()); }
+};
+
+TEST_F(EmbeddingFileTest, Half) {
+  EXPECT_EQ(FloatToHalf(0.0f), 0x0000);
+  EXPECT_EQ(FloatToHalf(-0.0f), 0x8000);
+  EXPECT_EQ(FloatToHalf(1.0f), 0x3c00);
+  EXPECT_EQ(FloatToHalf(-2.0f), 0xc000);
+  EXPECT_EQ(FloatToHalf(65504.0f), 0x7bff);
+  EXPECT_EQ(FloatToHalf(65520.0f), 0x7c00);
+  EXPECT_EQ(FloatToHalf(1e-8f), 0x0000);
+  EXPECT_EQ(FloatToHalf(5.9604644775390625e-8f), 0x0001);
+  // ties to even
+  EXPECT_EQ(FloatToHalf(1.0f + 1.0f / 2048), 0x3c00);
+  EXPECT_EQ(FloatToHalf(1.0f + 3.0f / 2048), 0x3c02);
+  EXPECT_TRUE(std::isnan(HalfToFloat(FloatToHalf(std::nanf("")))));
+
+  // every half but nans round trips
+  for (uint32_t i = 0; i < 0x10000; ++i) {
+    auto half = (uint16_t)i;
+    float value = HalfToFloat(half);
+    if (!std::isnan(value)) {
+      ASSERT_EQ(FloatToHalf(value), half) << i;
+    }
+  }
+}
+
+TEST_F(EmbeddingFileTest, Float32) {
+  vec_int_t ids, read_ids;
+  std::vector<float> values, read_values;
+  EmbeddingDtypeEnum dtype;
+  Write(EmbeddingDtypeEnum::FLOAT32, &ids, &values);
+  EXPECT_TRUE(IsEmbeddingFile(FILE));
+  Read(&read_ids, &read_values, &dtype);
+  EXPECT_EQ(dtype, EmbeddingDtypeEnum::FLOAT32);
+  EXPECT_EQ(read_ids, ids);
+  EXPECT_EQ(read_values, values);
+}
+
+TEST_F(EmbeddingFileTest, Float16) {
+  vec_int_t ids, read_ids;
+  std::vector<float> values, read_values;
+  EmbeddingDtypeEnum dtype;
+  Write(EmbeddingDtypeEnum::FLOAT16, &ids, &values);
+  Read(&read_ids, &read_values, &dtype);
+  EXPECT_EQ(dtype, EmbeddingDtypeEnum::FLOAT16);
+  EXPECT_EQ(read_ids, ids);
+  ASSERT_EQ(read_values.size(), values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(read_values[i], values[i], std::fabs(values[i]) / 1024);
+  }
+}
+
+TEST_F(EmbeddingFileTest, ReadEmbeddingFile) {
+  vec_int_t ids, read_ids;
+  std::vector<float> values, read_values;
+  auto func = [&read_ids, &read_values](const vec_int_t& ids,
+                                        const std::vector<float>& values,
+                                        int dim) {
+    EXPECT_EQ(values.size(), ids.size() * dim);
+    read_ids.insert(read_ids.end(), ids.begin(), ids.end());
+    read_values.insert(read_values.end(), values.begin(), values.end());
+    return true;
+  };
+
+  // text
+  ASSERT_TRUE(ReadEmbeddingFile("testdata/embedding/embedding-0", func));
+  EXPECT_EQ(read_ids.size(), 10u);
+  EXPECT_EQ(read_values.size(), 80u);
+
+  // binary
+  read_ids.clear();
+  read_values.clear();
+  Write(EmbeddingDtypeEnum::FLOAT32, &ids, &values);
+  ASSERT_TRUE(ReadEmbeddingFile(FILE, func));
+  EXPECT_EQ(read_ids, ids);
+  EXPECT_EQ(read_values, values);
+}
+
+TEST_F(EmbeddingFileTest, Invalid) {
+  EXPECT_FALSE(IsEmbeddingFile("testdata/embedding/embedding-0"));
+  EmbeddingFileReader reader;
+  EXPECT_FALSE(reader.Open("testdata/embedding/embedding-0"));
+
+  // a truncated block
+  std::string buf;
+  int_t id = 1;
+  float value = 1;
+  AppendEmbeddingHeader(EmbeddingDtypeEnum::FLOAT32, 1, &buf);
+  AppendEmbeddingBlock(EmbeddingDtypeEnum::FLOAT32, 1, &id, &value, 1, &buf);
+  buf.pop_back();
+  AsyncWriter writer;
+  ASSERT_TRUE(writer.Open(FILE));
+  ASSERT_TRUE(writer.Write(&buf));
+  ASSERT_TRUE(writer.Close());
+
+  vec_int_t ids;
+  std::vector<float> values;
+  ASSERT_TRUE(reader.Open(FILE));
+  EXPECT_FALSE(reader.NextBlock(&ids, &values));
+  EXPECT_TRUE(reader.failed());
+}
+
+}  // namespace embedx
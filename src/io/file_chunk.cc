@@ -0,0 +1,96 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/file_chunk.h"
+
+#include <deepx_core/common/stream.h>
+#include <deepx_core/dx_log.h>
+#include <sys/stat.h>
+
+#include <algorithm>  // std::min
+#include <fstream>
+
+namespace embedx {
+
+bool GetSplittableSize(const std::string& file, uint64_t* size) {
+  if (file.find("://") != std::string::npos) {
+    return false;
+  }
+
+  struct stat st;
+  if (stat(file.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    return false;
+  }
+
+  // gzip magic
+  std::ifstream ifs(file, std::ios::binary);
+  char magic[2] = {0, 0};
+  if (!ifs || (ifs.read(magic, 2) && (unsigned char)magic[0] == 0x1f &&
+               (unsigned char)magic[1] == 0x8b)) {
+    return false;
+  }
+
+  *size = (uint64_t)st.st_size;
+  return true;
+}
+
+bool SplitFile(const std::string& file, uint64_t chunk_size,
+               std::vector<FileChunk>* chunks) {
+  FileChunk chunk;
+  chunk.file = file;
+  uint64_t size;
+  if (chunk_size == 0 || !GetSplittableSize(file, &size)) {
+    chunks->emplace_back(chunk);
+    return false;
+  }
+
+  uint64_t begin = 0;
+  do {
+    chunk.begin = begin;
+    chunk.end = std::min(begin + chunk_size, size);
+    chunks->emplace_back(chunk);
+    begin = chunk.end;
+  } while (begin < size);
+  return true;
+}
+
+bool ConcatFiles(const std::vector<std::string>& in_files,
+                 const std::string& out_file) {
+  deepx_core::AutoOutputFileStream ofs;
+  if (!ofs.Open(out_file)) {
+    DXERROR("Failed to open file: %s.", out_file.c_str());
+    return false;
+  }
+
+  std::vector<char> buf(1 << 20);
+  for (const std::string& in_file : in_files) {
+    deepx_core::AutoInputFileStream ifs;
+    if (!ifs.Open(in_file)) {
+      DXERROR("Failed to open file: %s.", in_file.c_str());
+      return false;
+    }
+    for (;;) {
+      size_t n = ifs.Read(buf.data(), buf.size());
+      if (n == 0) {
+        break;
+      }
+      ofs.Write(buf.data(), n);
+    }
+  }
+
+  if (!ofs) {
+    DXERROR("Failed to write: %s.", out_file.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace embedx
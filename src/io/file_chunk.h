@@ -0,0 +1,53 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace embedx {
+
+// the end of a chunk running to the end of its file
+constexpr uint64_t FILE_CHUNK_END = (uint64_t)-1;
+
+// FileChunk is the byte range ['begin', 'end') of a file.
+//
+// A line belongs to the chunk where it begins, so the chunks of a file split
+// at any offsets hold every line of it exactly once.
+struct FileChunk {
+  std::string file;
+  uint64_t begin = 0;
+  uint64_t end = FILE_CHUNK_END;
+
+  bool whole() const noexcept { return begin == 0 && end == FILE_CHUNK_END; }
+};
+
+// Called by a reader at offset 'pos' >= '*end' of its chunk, it may move
+// '*end' further to grant more lines and returns false on errors.
+using FileChunkExtender = std::function<bool(uint64_t pos, uint64_t* end)>;
+
+// Gets the size of 'file' and returns true if it can be read from an offset,
+// i.e. it is a local uncompressed file.
+bool GetSplittableSize(const std::string& file, uint64_t* size);
+
+// Splits 'file' into chunks of 'chunk_size' bytes, the last one may be
+// shorter. A file which can't be read from an offset is one whole chunk.
+// Returns true if 'file' is split.
+bool SplitFile(const std::string& file, uint64_t chunk_size,
+               std::vector<FileChunk>* chunks);
+
+// Writes 'in_files' one by one to 'out_file'.
+bool ConcatFiles(const std::vector<std::string>& in_files,
+                 const std::string& out_file);
+
+}  // namespace embedx
@@ -0,0 +1,140 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/file_chunk.h"
+
+#include <deepx_core/common/stream.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "src/io/line_parser.h"
+#include "src/io/value.h"
+
+namespace embedx {
+
+class FileChunkTest : public ::testing::Test {
+ protected:
+  const std::string WORK_DIR = "file_chunk_test";
+  const int BATCH = 3;
+
+ protected:
+  void SetUp() override { (void)deepx_core::AutoFileSystem::MakeDir(WORK_DIR); }
+
+  std::string WriteFile(const std::string& name,
+                        const std::string& content) const {
+    std::string file = WORK_DIR + "/" + name;
+    std::ofstream os(file, std::ios::binary);
+    os << content;
+    return file;
+  }
+
+  static std::string ReadFile(const std::string& file) {
+    std::ifstream is(file, std::ios::binary);
+    std::ostringstream os;
+    os << is.rdbuf();
+    return os.str();
+  }
+
+  // Parses the lines of 'chunk' to 'out_file', a line per node.
+  void Parse(const FileChunk& chunk, const std::string& out_file) const {
+    LineParser parser;
+    ASSERT_TRUE(parser.Open(chunk, FileChunkExtender()));
+    std::ofstream os(out_file, std::ios::binary);
+    std::vector<NodeValue> values;
+    while (parser.NextBatch<NodeValue>(BATCH, &values)) {
+      for (const auto& value : values) {
+        os << value.ToString() << "\n";
+      }
+    }
+  }
+
+  // Parses the ranges of 'file' split by 'chunk_size' and concatenates them,
+  // every line must be parsed once and in order. See trainer_context_test for
+  // the stitched predictions.
+  void CheckLines(const std::string& file, uint64_t chunk_size) const {
+    FileChunk whole;
+    whole.file = file;
+    std::string whole_out = file + ".out";
+    Parse(whole, whole_out);
+
+    std::vector<FileChunk> chunks;
+    EXPECT_TRUE(SplitFile(file, chunk_size, &chunks));
+    std::vector<std::string> part_files;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      part_files.emplace_back(file + ".part-" + std::to_string(i));
+      Parse(chunks[i], part_files.back());
+    }
+    std::string concat_out = file + ".concat";
+    ASSERT_TRUE(ConcatFiles(part_files, concat_out));
+    EXPECT_EQ(ReadFile(concat_out), ReadFile(whole_out))
+        << "chunk_size: " << chunk_size;
+  }
+};
+
+TEST_F(FileChunkTest, SplitFile) {
+  std::string file = WriteFile("split", "1\n22\n333\n");
+  std::vector<FileChunk> chunks;
+  EXPECT_TRUE(SplitFile(file, 4, &chunks));
+  ASSERT_EQ(chunks.size(), 3u);
+  EXPECT_EQ(chunks[0].begin, 0u);
+  EXPECT_EQ(chunks[0].end, 4u);
+  EXPECT_EQ(chunks[2].begin, 8u);
+  EXPECT_EQ(chunks[2].end, 9u);
+
+  // not a local file
+  chunks.clear();
+  EXPECT_FALSE(SplitFile(WORK_DIR + "/not_exist", 4, &chunks));
+  ASSERT_EQ(chunks.size(), 1u);
+  EXPECT_TRUE(chunks[0].whole());
+}
+
+// Ranges start in the middle of lines at every size.
+TEST_F(FileChunkTest, Lines) {
+  std::string content;
+  for (int i = 0; i < 50; ++i) {
+    content += std::to_string(i * 37) + " " + std::to_string(i % 3 + 1) + "\n";
+  }
+  std::string file = WriteFile("lines", content);
+  for (uint64_t chunk_size = 1; chunk_size <= content.size() + 1;
+       ++chunk_size) {
+    CheckLines(file, chunk_size);
+  }
+}
+
+TEST_F(FileChunkTest, Lines_CRLF) {
+  std::string file = WriteFile("crlf", "1 2\r\n3\r\n5 6\r\n7 8");
+  for (uint64_t chunk_size = 1; chunk_size <= 20; ++chunk_size) {
+    CheckLines(file, chunk_size);
+  }
+
+  FileChunk whole;
+  whole.file = file;
+  Parse(whole, file + ".out");
+  EXPECT_EQ(ReadFile(file + ".out"), "1 2\n3 1\n5 6\n7 8\n");
+}
+
+// A file shorter than the range size is one range.
+TEST_F(FileChunkTest, Lines_Short) {
+  std::string file = WriteFile("short", "1 2\n3 4\n");
+  std::vector<FileChunk> chunks;
+  EXPECT_TRUE(SplitFile(file, 1 << 20, &chunks));
+  EXPECT_EQ(chunks.size(), 1u);
+  CheckLines(file, 1 << 20);
+
+  file = WriteFile("empty", "");
+  CheckLines(file, 4);
+}
+
+}  // namespace embedx
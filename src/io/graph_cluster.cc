@@ -0,0 +1,265 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/graph_cluster.h"
+
+#include <deepx_core/common/stream.h>
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::shuffle, std::sort
+#include <cmath>      // std::ceil
+#include <numeric>    // std::iota
+#include <sstream>    // std::istringstream
+#include <utility>    // std::pair
+#include <vector>
+
+#include "src/common/random.h"
+
+namespace embedx {
+namespace {
+
+// undirected graph of the dense ids of nodes
+struct DenseGraph {
+  vec_int_t nodes;
+  std::vector<std::vector<int>> neighbors;
+
+  int Id(int_t node, index_map_t* ids) {
+    auto result = ids->emplace(node, (int)nodes.size());
+    if (result.second) {
+      nodes.emplace_back(node);
+      neighbors.emplace_back();
+    }
+    return result.first->second;
+  }
+};
+
+void BuildDenseGraph(const adj_list_t& graph, DenseGraph* dense) {
+  index_map_t ids;
+  ids.reserve(graph.size());
+  for (const auto& entry : graph) {
+    int u = dense->Id(entry.first, &ids);
+    for (const auto& pair : entry.second) {
+      int v = dense->Id(pair.first, &ids);
+      if (u != v) {
+        dense->neighbors[u].emplace_back(v);
+        dense->neighbors[v].emplace_back(u);
+      }
+    }
+  }
+}
+
+// Returns the number of moved nodes.
+int Propagate(const DenseGraph& dense, int capacity, std::vector<int>* order,
+              std::vector<int>* sizes, std::vector<int>* labels) {
+  std::shuffle(order->begin(), order->end(), ThreadLocalRandomEngine());
+  std::vector<int> counts(sizes->size(), 0);
+  std::vector<int> touched;
+  int moved = 0;
+
+  for (auto u : *order) {
+    touched.clear();
+    for (auto v : dense.neighbors[u]) {
+      int cluster = (*labels)[v];
+      if (counts[cluster]++ == 0) {
+        touched.emplace_back(cluster);
+      }
+    }
+
+    int cur = (*labels)[u];
+    int best = cur;
+    for (auto cluster : touched) {
+      if (counts[cluster] > counts[best] && (*sizes)[cluster] < capacity) {
+        best = cluster;
+      }
+    }
+    for (auto cluster : touched) {
+      counts[cluster] = 0;
+    }
+
+    if (best != cur) {
+      (*sizes)[cur] -= 1;
+      (*sizes)[best] += 1;
+      (*labels)[u] = best;
+      moved += 1;
+    }
+  }
+  return moved;
+}
+
+// Packs the communities of 'labels' into 'cluster_num' clusters of at most
+// 'target' nodes, largest first into the least loaded cluster. A community
+// larger than the room of the cluster spills over into the next one.
+void Pack(int cluster_num, int target, std::vector<int>* labels) {
+  std::vector<std::vector<int>> communities(labels->size());
+  for (size_t u = 0; u < labels->size(); ++u) {
+    communities[(*labels)[u]].emplace_back((int)u);
+  }
+  std::sort(communities.begin(), communities.end(),
+            [](const std::vector<int>& a, const std::vector<int>& b) {
+              return a.size() > b.size();
+            });
+
+  std::vector<int> loads(cluster_num, 0);
+  auto least_loaded = [&loads]() {
+    return (int)(std::min_element(loads.begin(), loads.end()) -
+                 loads.begin());
+  };
+  for (const auto& community : communities) {
+    if (community.empty()) {
+      break;
+    }
+    int cluster = least_loaded();
+    for (auto u : community) {
+      if (loads[cluster] >= target) {
+        cluster = least_loaded();
+      }
+      (*labels)[u] = cluster;
+      loads[cluster] += 1;
+    }
+  }
+}
+
+}  // namespace
+
+bool ClusterGraph(const adj_list_t& graph, int cluster_num, double imbalance,
+                  int iter_num, index_map_t* clusters) {
+  if (cluster_num <= 0 || imbalance < 0 || iter_num < 0) {
+    DXERROR("Need cluster_num > 0, imbalance >= 0 and iter_num >= 0, got "
+            "cluster_num: %d, imbalance: %f, iter_num: %d.",
+            cluster_num, imbalance, iter_num);
+    return false;
+  }
+
+  DenseGraph dense;
+  BuildDenseGraph(graph, &dense);
+  int node_num = (int)dense.nodes.size();
+
+  int target = (node_num + cluster_num - 1) / cluster_num;
+  int capacity = std::max(
+      target, (int)std::ceil((double)node_num / cluster_num * (1 + imbalance)));
+  std::vector<int> order(node_num);
+  std::iota(order.begin(), order.end(), 0);
+  auto propagate = [&](std::vector<int>* sizes, std::vector<int>* labels) {
+    for (int i = 0; i < iter_num; ++i) {
+      int moved = Propagate(dense, capacity, &order, sizes, labels);
+      if (moved == 0) {
+        break;
+      }
+    }
+  };
+
+  // communities of at most 'capacity' nodes, each node starts as its own
+  std::vector<int> labels(order);
+  std::vector<int> sizes(node_num, 1);
+  propagate(&sizes, &labels);
+
+  Pack(cluster_num, target, &labels);
+  sizes.assign(cluster_num, 0);
+  for (auto label : labels) {
+    sizes[label] += 1;
+  }
+  propagate(&sizes, &labels);
+
+  clusters->clear();
+  clusters->reserve(node_num);
+  for (int i = 0; i < node_num; ++i) {
+    clusters->emplace(dense.nodes[i], labels[i]);
+  }
+  return true;
+}
+
+ClusterQuality EvalClusters(const adj_list_t& graph, int cluster_num,
+                            const index_map_t& clusters) {
+  ClusterQuality quality;
+  auto cluster_of = [&clusters](int_t node) {
+    auto it = clusters.find(node);
+    return it == clusters.end() ? -1 : it->second;
+  };
+
+  double edge_num = 0, cut_num = 0;
+  for (const auto& entry : graph) {
+    int cluster = cluster_of(entry.first);
+    for (const auto& pair : entry.second) {
+      edge_num += 1;
+      int neigh_cluster = cluster_of(pair.first);
+      if (cluster < 0 || neigh_cluster != cluster) {
+        cut_num += 1;
+      }
+    }
+  }
+  quality.edge_cut_ratio = edge_num > 0 ? cut_num / edge_num : 0;
+
+  std::vector<int> sizes(cluster_num, 0);
+  for (const auto& entry : clusters) {
+    if (entry.second >= 0 && entry.second < cluster_num) {
+      sizes[entry.second] += 1;
+    }
+  }
+  if (cluster_num > 0 && !clusters.empty()) {
+    double mean_size = (double)clusters.size() / cluster_num;
+    quality.balance = *std::max_element(sizes.begin(), sizes.end()) / mean_size;
+  }
+  return quality;
+}
+
+bool LoadClusters(const std::string& file, index_map_t* clusters) {
+  deepx_core::AutoInputFileStream ifs;
+  if (!ifs.Open(file)) {
+    DXERROR("Failed to open file: %s.", file.c_str());
+    return false;
+  }
+
+  clusters->clear();
+  std::string line;
+  std::istringstream iss;
+  while (GetLine(ifs, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    iss.clear();
+    iss.str(line);
+    int_t node;
+    int cluster;
+    if (!(iss >> node >> cluster) || cluster < 0) {
+      DXERROR("Invalid cluster line: %s.", line.c_str());
+      return false;
+    }
+    (*clusters)[node] = cluster;
+  }
+  return true;
+}
+
+bool SaveClusters(const index_map_t& clusters, const std::string& file) {
+  deepx_core::AutoOutputFileStream ofs;
+  if (!ofs.Open(file)) {
+    DXERROR("Failed to open file: %s.", file.c_str());
+    return false;
+  }
+
+  std::vector<std::pair<int_t, int>> entries(clusters.begin(), clusters.end());
+  std::sort(entries.begin(), entries.end());
+  std::string text;
+  for (const auto& entry : entries) {
+    text += std::to_string(entry.first);
+    text += " ";
+    text += std::to_string(entry.second);
+    text += "\n";
+  }
+  ofs.Write(text.data(), text.size());
+  if (!ofs) {
+    DXERROR("Failed to write file: %s.", file.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace embedx
@@ -0,0 +1,49 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <string>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+// Graph clustering for partition local mini-batches (Cluster-GCN) and for
+// sharding graph servers by cluster, see ClusterGraph.
+
+struct ClusterQuality {
+  // edges between clusters / all edges
+  double edge_cut_ratio = 0;
+  // the largest cluster size / the mean cluster size
+  double balance = 0;
+};
+
+// Partitions the nodes of 'graph', keys and neighbors, into 'cluster_num'
+// clusters of balanced sizes with few edges between them, edges are taken as
+// undirected. 'clusters' maps each node to its cluster in [0, cluster_num).
+//
+// Label propagation, at most 'iter_num' rounds: a node moves to the community
+// most of its neighbors are in, unless it would get more than
+// (1 + 'imbalance') times the mean cluster size. The communities found from
+// single nodes are packed into clusters of equal sizes, largest first, and
+// refined by label propagation again.
+bool ClusterGraph(const adj_list_t& graph, int cluster_num, double imbalance,
+                  int iter_num, index_map_t* clusters);
+
+// An edge with an end not in 'clusters' is cut.
+ClusterQuality EvalClusters(const adj_list_t& graph, int cluster_num,
+                            const index_map_t& clusters);
+
+// A cluster file has a line "node cluster" for each node.
+bool LoadClusters(const std::string& file, index_map_t* clusters);
+bool SaveClusters(const index_map_t& clusters, const std::string& file);
+
+}  // namespace embedx
@@ -0,0 +1,90 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/graph_cluster.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>  // std::remove
+#include <random>
+#include <string>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+class GraphClusterTest : public ::testing::Test {
+ protected:
+  const int BLOCK_NUM = 8;
+  const int BLOCK_SIZE = 100;
+  const double IMBALANCE = 0.05;
+  const std::string FILE = "graph_cluster_test.txt";
+
+  // a stochastic block model graph
+  adj_list_t graph_;
+
+ protected:
+  void SetUp() override {
+    const double P_IN = 0.1;
+    const double P_OUT = 0.002;
+    std::mt19937 engine(9527);
+    std::uniform_real_distribution<double> dist(0, 1);
+
+    // blocks are interleaved in the id space
+    int node_num = BLOCK_NUM * BLOCK_SIZE;
+    for (int u = 0; u < node_num; ++u) {
+      for (int v = u + 1; v < node_num; ++v) {
+        double p = u % BLOCK_NUM == v % BLOCK_NUM ? P_IN : P_OUT;
+        if (dist(engine) < p) {
+          graph_[(int_t)u].emplace_back((int_t)v, 1);
+          graph_[(int_t)v].emplace_back((int_t)u, 1);
+        }
+      }
+    }
+  }
+
+  void TearDown() override { std::remove(FILE.c_str()); }
+};
+
+TEST_F(GraphClusterTest, ClusterGraph) {
+  index_map_t clusters;
+  EXPECT_FALSE(ClusterGraph(graph_, 0, IMBALANCE, 10, &clusters));
+  ASSERT_TRUE(ClusterGraph(graph_, BLOCK_NUM, IMBALANCE, 10, &clusters));
+  EXPECT_EQ(clusters.size(), graph_.size());
+  for (const auto& entry : clusters) {
+    EXPECT_GE(entry.second, 0);
+    EXPECT_LT(entry.second, BLOCK_NUM);
+  }
+
+  // id ranges cut about (BLOCK_NUM - 1) / BLOCK_NUM of the edges
+  index_map_t range_clusters;
+  for (const auto& entry : graph_) {
+    range_clusters.emplace(entry.first, (int)(entry.first / BLOCK_SIZE));
+  }
+  auto range_quality = EvalClusters(graph_, BLOCK_NUM, range_clusters);
+  auto quality = EvalClusters(graph_, BLOCK_NUM, clusters);
+  EXPECT_GT(range_quality.edge_cut_ratio, 0.8);
+  EXPECT_LT(quality.edge_cut_ratio, 0.2);
+  EXPECT_LE(quality.balance, 1 + IMBALANCE + 1e-6);
+
+  // all edges are cut without clusters
+  EXPECT_EQ(EvalClusters(graph_, BLOCK_NUM, {}).edge_cut_ratio, 1);
+}
+
+TEST_F(GraphClusterTest, SaveAndLoad) {
+  index_map_t clusters{{1, 0}, {2, 0}, {30, 1}, {4, 2}};
+  ASSERT_TRUE(SaveClusters(clusters, FILE));
+  index_map_t loaded;
+  ASSERT_TRUE(LoadClusters(FILE, &loaded));
+  EXPECT_EQ(loaded, clusters);
+}
+
+}  // namespace embedx
@@ -31,17 +31,17 @@ void Indexing::Add(int_t node) {
 void Indexing::Emplace(int_t k, int v) { index_map_.emplace(k, v); }
 
 int Indexing::Get(int_t node) const {
-  auto it = index_map_.find(node);
-  if (it == index_map_.end()) {
+  const int* index = index_map_.find(node);
+  if (index == nullptr) {
     DXERROR("Couldn't find Node: %" PRIu64 " in index the table.", node);
     return -1;
   } else {
-    return it->second;
+    return *index;
   }
 }
 
 bool Indexing::Find(int_t node) const {
-  return index_map_.find(node) != index_map_.end();
+  return index_map_.count(node) > 0;
 }
 
 size_t Indexing::Size() const noexcept { return index_map_.size(); }
@@ -17,7 +17,7 @@ namespace embedx {
 
 class Indexing {
  private:
-  index_map_t index_map_;
+  flat_index_map_t index_map_;
 
  public:
   void Reserve(uint64_t estimated_size);
@@ -39,6 +39,7 @@ void IndexingWrapper::BuildFrom(const vec_int_t& nodes) {
   auto& subgraph_indexing = subgraph_indexings_[ns_id];
   subgraph_indexing.resize(1);
   subgraph_indexing[0].Clear();
+  subgraph_indexing[0].Reserve(nodes.size());
 
   for (auto node : nodes) {
     subgraph_indexing[0].Add(node);
@@ -57,6 +58,7 @@ void IndexingWrapper::BuildFrom(const vec_set_t& level_nodes) {
   int k = 0;
   for (size_t i = 0; i < level_nodes.size(); ++i) {
     subgraph_indexing[i].Clear();
+    subgraph_indexing[i].Reserve(level_nodes[i].size());
     for (auto node : level_nodes[i]) {
       subgraph_indexing[i].Emplace(node, k);
       k += 1;
@@ -50,6 +50,19 @@ void ParseMaxNodeType(int max_num, const vec_int_t& node_list,
   }
 }
 
+void SortByNode(vec_pair_t* context) {
+  std::stable_sort(context->begin(), context->end(),
+                   [](const pair_t& a, const pair_t& b) {
+                     uint16_t type_a = GetNodeType(a.first);
+                     uint16_t type_b = GetNodeType(b.first);
+                     if (type_a == type_b) {
+                       return a.first < b.first;
+                     } else {
+                       return type_a < type_b;
+                     }
+                   });
+}
+
 static bool InitEmptyConfig(uint16_t* ns_size, id_name_t* id_name_map) {
   uint16_t max_ns_id = 0;
   id_name_map->clear();
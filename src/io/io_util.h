@@ -27,6 +27,8 @@ bool ListFile(const std::string& dir, vec_str_t* files);
 uint16_t GetNodeType(int_t node);
 void ParseMaxNodeType(int max_num, const vec_int_t& nodes,
                       std::unordered_set<uint16_t>* ns_ids);
+// sort a context by node type, then by node
+void SortByNode(vec_pair_t* context);
 
 bool LoadConfig(const std::string& file, uint16_t* ns_size,
                 id_name_t* id_name_map);
@@ -32,6 +32,51 @@ bool CheckWeightInRange(float_t weight) {
 
 }  // namespace
 
+/************************************************************************/
+/* FileChunk */
+/************************************************************************/
+bool LineParser::Open(const FileChunk& chunk,
+                      const FileChunkExtender& extender) {
+  if (chunk.whole() && !extender) {
+    return Open(chunk.file);
+  }
+
+  Close();
+  chunk_ifs_.open(chunk.file, std::ios::binary);
+  if (!chunk_ifs_) {
+    DXERROR("Failed to open file: %s.", chunk.file.c_str());
+    chunk_ifs_.clear();
+    return false;
+  }
+
+  // The line across 'begin' belongs to the previous chunk, skip it. If the
+  // byte before 'begin' is '\n', only it is skipped.
+  if (chunk.begin > 0) {
+    chunk_ifs_.seekg((std::streamoff)(chunk.begin - 1));
+    std::getline(chunk_ifs_, line_);
+  }
+  chunk_end_ = chunk.end;
+  extender_ = extender;
+  chunked_ = true;
+  return true;
+}
+
+bool LineParser::NextChunkLine() {
+  std::streamoff pos = chunk_ifs_.tellg();
+  if (pos < 0) {
+    // the end of the file
+    return false;
+  }
+
+  if ((uint64_t)pos >= chunk_end_) {
+    if (!extender_ || !extender_((uint64_t)pos, &chunk_end_) ||
+        (uint64_t)pos >= chunk_end_) {
+      return false;
+    }
+  }
+  return (bool)std::getline(chunk_ifs_, line_);
+}
+
 /************************************************************************/
 /* NodeValue */
 /************************************************************************/
@@ -44,11 +89,9 @@ bool LineParser::ParseValue(const std::string& line, NodeValue* value) {
     return false;
   }
 
-  // IF a NODE is made up of [node, weight].
+  // IF a NODE is made up of [node, weight], or the weight is 1.
   float_t weight;
-  if (iss_ >> weight && iss_.eof()) {
-    value->weight = weight;
-  }
+  value->weight = (iss_ >> weight && iss_.eof()) ? weight : 1;
 
   return true;
 }
@@ -65,8 +108,10 @@ bool LineParser::ParseValue(const std::string& line, EdgeValue* value) {
     return false;
   }
 
-  // IF an EDGE is made up of [src_node, dst_node, weight].
+  // IF an EDGE is made up of [src_node, dst_node, weight], or the weight is
+  // 1.
   float_t weight;
+  value->weight = 1;
   if (iss_ >> weight && iss_.eof()) {
     if (!CheckWeightInRange(weight)) {
       return false;
@@ -77,6 +122,61 @@ bool LineParser::ParseValue(const std::string& line, EdgeValue* value) {
   return true;
 }
 
+/************************************************************************/
+/* EdgeFeatureValue */
+/************************************************************************/
+bool LineParser::ParseValue(const std::string& line, EdgeFeatureValue* value) {
+  // EdgeFeatureValue is made up of [src_node, dst_node, id:value ...].
+  iss_.clear();
+  iss_.str(line);
+
+  if (!(iss_ >> value->src_node >> value->dst_node)) {
+    DXERROR("Failed to parse edge from line: %s.", line.c_str());
+    return false;
+  }
+
+  value->feats.clear();
+  std::string pair;
+  vec_str_t tokens;
+  while (iss_ >> pair) {
+    deepx_core::Split(pair, ":", &tokens);
+    if (tokens.size() != 2u) {
+      DXERROR("The pair: %s format must be id:value.", pair.c_str());
+      return false;
+    }
+    value->feats.emplace_back(std::stoull(tokens[0]),
+                              (float_t)std::stod(tokens[1]));
+  }
+
+  return true;
+}
+
+/************************************************************************/
+/* EmbeddingValue */
+/************************************************************************/
+bool LineParser::ParseValue(const std::string& line, EmbeddingValue* value) {
+  // EmbeddingValue is made up of [node, val0, val1, ...].
+  iss_.clear();
+  iss_.str(line);
+
+  if (!(iss_ >> value->node)) {
+    DXERROR("Failed to parse node from line: %s.", line.c_str());
+    return false;
+  }
+
+  value->embedding.clear();
+  float_t val;
+  while (iss_ >> val) {
+    value->embedding.emplace_back(val);
+  }
+
+  if (!iss_.eof() || value->embedding.empty()) {
+    DXERROR("Failed to parse embedding from line: %s.", line.c_str());
+    return false;
+  }
+  return true;
+}
+
 /************************************************************************/
 /* SeqValue */
 /************************************************************************/
@@ -97,7 +197,8 @@ bool LineParser::ParseValue(const std::string& line, SeqValue* value) {
 /* AdjValue */
 /************************************************************************/
 bool LineParser::ParseValue(const std::string& line, AdjValue* value) {
-  // AdjValue is make up of [node, id:weight, id:weight ...]
+  // AdjValue is make up of [node, id:weight, id:weight ...], or
+  // [node, id:weight:timestamp, id:weight:timestamp ...] for temporal edges.
   iss_.clear();
   iss_.str(line);
   if (!(iss_ >> value->node)) {
@@ -107,15 +208,24 @@ bool LineParser::ParseValue(const std::string& line, AdjValue* value) {
 
   // pair
   value->pairs.clear();
+  value->timestamps.clear();
   std::string pair;
   vec_str_t tokens;
+  size_t token_size = 0;
 
   while (iss_ >> pair) {
     deepx_core::Split(pair, ":", &tokens);
-    if (tokens.size() != 2u) {
-      DXERROR("The pair: %s format must be id:value.", pair.c_str());
+    if (tokens.size() != 2u && tokens.size() != 3u) {
+      DXERROR("The pair: %s format must be id:value or id:value:timestamp.",
+              pair.c_str());
+      return false;
+    }
+    if (token_size != 0 && tokens.size() != token_size) {
+      DXERROR("Need timestamps for all or none of the pairs, got line: %s.",
+              line.c_str());
       return false;
     }
+    token_size = tokens.size();
 
     auto id = std::stoull(tokens[0]);
     auto weight = (float_t)std::stod(tokens[1]);
@@ -123,6 +233,9 @@ bool LineParser::ParseValue(const std::string& line, AdjValue* value) {
       return false;
     }
     value->pairs.emplace_back(id, weight);
+    if (token_size == 3u) {
+      value->timestamps.emplace_back((int64_t)std::stoll(tokens[2]));
+    }
   }
 
   return !value->pairs.empty();
@@ -13,10 +13,13 @@
 #include <deepx_core/common/stream.h>
 #include <deepx_core/dx_log.h>
 
+#include <cstdint>
+#include <fstream>
 #include <sstream>  // std::istringstream
 #include <string>
 #include <vector>
 
+#include "src/io/file_chunk.h"
 #include "src/io/value.h"
 
 namespace embedx {
@@ -27,16 +30,37 @@ class LineParser {
   std::istringstream iss_;
   deepx_core::AutoInputFileStream ifs_;
 
+  // a chunk of a local file
+  bool chunked_ = false;
+  std::ifstream chunk_ifs_;
+  uint64_t chunk_end_ = FILE_CHUNK_END;
+  FileChunkExtender extender_;
+
  public:
   bool Open(const std::string& file) {
-    ifs_.Close();
+    Close();
     if (!ifs_.Open(file)) {
       DXERROR("Failed to open file: %s.", file.c_str());
       return false;
     }
     return true;
   }
-  void Close() noexcept { ifs_.Close(); }
+
+  // Opens the lines of 'chunk', 'extender' is called at the end of it if it
+  // isn't empty. A chunk other than a whole file must be of a local
+  // uncompressed file.
+  bool Open(const FileChunk& chunk,
+            const FileChunkExtender& extender = FileChunkExtender());
+
+  void Close() noexcept {
+    ifs_.Close();
+    if (chunked_) {
+      chunk_ifs_.close();
+      chunk_ifs_.clear();
+      extender_ = nullptr;
+      chunked_ = false;
+    }
+  }
 
  public:
   template <typename ValueType>
@@ -45,7 +69,7 @@ class LineParser {
     ValueType value;
 
     for (;;) {
-      if (!GetLine(ifs_, line_)) {
+      if (!NextLine()) {
         break;
       }
 
@@ -61,8 +85,22 @@ class LineParser {
   }
 
  private:
+  bool NextLine() {
+    if (!(chunked_ ? NextChunkLine() : (bool)GetLine(ifs_, line_))) {
+      return false;
+    }
+    // CRLF line endings
+    if (!line_.empty() && line_.back() == '\r') {
+      line_.pop_back();
+    }
+    return true;
+  }
+  bool NextChunkLine();
+
   bool ParseValue(const std::string& line, NodeValue* node);
   bool ParseValue(const std::string& line, EdgeValue* value);
+  bool ParseValue(const std::string& line, EdgeFeatureValue* value);
+  bool ParseValue(const std::string& line, EmbeddingValue* value);
   bool ParseValue(const std::string& line, SeqValue* value);
   bool ParseValue(const std::string& line, AdjValue* value);
   bool ParseValue(const std::string& line, NodeAndLabelValue* value);
@@ -13,10 +13,14 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <fstream>
 #include <memory>  // std::unique_ptr
 #include <string>
 #include <vector>
 
+#include "src/common/data_types.h"
+#include "src/io/file_chunk.h"
 #include "src/io/value.h"
 
 namespace embedx {
@@ -27,6 +31,8 @@ class LineParserTest : public ::testing::Test {
 
  protected:
   const std::string CONTEXT = "testdata/context/context-0";
+  const std::string TEMPORAL_CONTEXT =
+      "testdata/temporal_context/temporal_context-0";
   const std::string FEATURE_FILE = "testdata/node_feature/feature-0";
   const std::string WALK_FILE = "testdata/walk_file";
   const std::string LABEL_FILE = "testdata/label_file";
@@ -111,6 +117,17 @@ TEST_F(LineParserTest, NextBatch_Context) {
   EXPECT_FALSE(parser_->NextBatch<AdjValue>(BATCH, &values));
 }
 
+TEST_F(LineParserTest, NextBatch_TemporalContext) {
+  EXPECT_TRUE(parser_->Open(TEMPORAL_CONTEXT));
+
+  std::vector<AdjValue> values;
+  EXPECT_TRUE(parser_->NextBatch<AdjValue>(BATCH, &values));
+  EXPECT_EQ(values.size(), (size_t)BATCH);
+  EXPECT_EQ(values[0].ToString(), "0 1:1:30 2:1:10 3:1:20 1:1:40");
+  EXPECT_EQ(values[0].timestamps.size(), values[0].pairs.size());
+  EXPECT_EQ(values[1].ToString(), "1 0:1:30 2:1:5");
+}
+
 TEST_F(LineParserTest, NextBatch_Feature) {
   EXPECT_TRUE(parser_->Open(FEATURE_FILE));
 
@@ -156,4 +173,50 @@ TEST_F(LineParserTest, NextBatch_NodeAndLabel) {
   EXPECT_FALSE(parser_->NextBatch<NodeAndLabelValue>(BATCH, &values));
 }
 
+// Two chunks split at any offset hold every line once, and an extender grows
+// a chunk.
+TEST_F(LineParserTest, NextBatch_Chunk) {
+  std::vector<NodeValue> values;
+  std::vector<int_t> nodes;
+  EXPECT_TRUE(parser_->Open(CONTEXT));
+  while (parser_->NextBatch<NodeValue>(BATCH, &values)) {
+    for (const auto& value : values) {
+      nodes.emplace_back(value.node);
+    }
+  }
+  std::ifstream ifs(CONTEXT, std::ios::binary | std::ios::ate);
+  uint64_t size = (uint64_t)ifs.tellg();
+
+  for (uint64_t mid = 0; mid <= size; ++mid) {
+    std::vector<int_t> chunk_nodes;
+    FileChunk chunk;
+    chunk.file = CONTEXT;
+    for (int i = 0; i < 2; ++i) {
+      chunk.begin = i == 0 ? 0 : mid;
+      chunk.end = i == 0 ? mid : size;
+      EXPECT_TRUE(parser_->Open(chunk, FileChunkExtender()));
+      while (parser_->NextBatch<NodeValue>(BATCH, &values)) {
+        for (const auto& value : values) {
+          chunk_nodes.emplace_back(value.node);
+        }
+      }
+    }
+    EXPECT_EQ(chunk_nodes, nodes);
+  }
+
+  FileChunk chunk;
+  chunk.file = CONTEXT;
+  chunk.end = 1;
+  int extend_num = 0;
+  EXPECT_TRUE(parser_->Open(chunk, [&extend_num](uint64_t pos, uint64_t* end) {
+    ++extend_num;
+    *end = pos + 1;
+    return true;
+  }));
+  EXPECT_TRUE(parser_->NextBatch<NodeValue>(10, &values));
+  EXPECT_EQ(values.size(), nodes.size());
+  // at every line but the first one and at the end
+  EXPECT_EQ(extend_num, (int)nodes.size());
+}
+
 }  // namespace embedx
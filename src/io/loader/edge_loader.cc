@@ -27,6 +27,7 @@ constexpr int BATCH = 128;
 
 }
 
+// EdgeLoader loads edges with features, see EdgeFeatureValue.
 class EdgeLoader : public Loader {
  private:
   int shard_num_;
@@ -50,7 +51,7 @@ class EdgeLoader : public Loader {
 
  private:
   bool LoadEntry(const vec_str_t& files, int thread_id) override {
-    std::vector<EdgeValue> values;
+    std::vector<EdgeFeatureValue> values;
     LineParser line_parser;
 
     for (const auto& file : files) {
@@ -60,12 +61,12 @@ class EdgeLoader : public Loader {
         return false;
       }
 
-      while (line_parser.NextBatch<EdgeValue>(BATCH, &values)) {
+      while (line_parser.NextBatch<EdgeFeatureValue>(BATCH, &values)) {
         store_->Lock();
 
         for (auto& value : values) {
           if (Loader::PartOfShard(value.src_node, shard_num_, shard_id_)) {
-            if (!store_->InsertEdge(&value)) {
+            if (!store_->InsertEdgeFeature(&value)) {
               store_->UnLock();
               return false;
             }
@@ -14,11 +14,15 @@
 #include <string>
 
 #include "src/common/data_types.h"
+#include "src/io/partitioner.h"
 #include "src/io/storage/storage.h"
 
 namespace embedx {
 
 class Loader {
+ protected:
+  const Partitioner* partitioner_ = nullptr;
+
  public:
   Loader() = default;
   virtual ~Loader() = default;
@@ -31,8 +35,15 @@ class Loader {
  public:
   virtual bool Load(const std::string& path, int thread_num);
   virtual bool PartOfShard(int_t node, int shard_num, int shard_id) const {
+    if (partitioner_ != nullptr) {
+      return partitioner_->PartOfShard(node, shard_id);
+    }
     return node % shard_num == (size_t)shard_id;
   }
+  // nullptr for partitioning by 'node % shard_num'
+  void set_partitioner(const Partitioner* partitioner) noexcept {
+    partitioner_ = partitioner;
+  }
 
  protected:
   virtual bool LoadEntry(const vec_str_t& files, int thread_id) = 0;
@@ -0,0 +1,462 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/partitioner.h"
+
+#include <deepx_core/common/stream.h>
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>   // std::sort, std::upper_bound
+#include <functional>  // std::greater
+#include <queue>       // std::priority_queue
+#include <unordered_map>
+#include <utility>     // std::pair
+
+namespace embedx {
+namespace {
+
+/************************************************************************/
+/* HashPartitioner */
+/************************************************************************/
+class HashPartitioner : public Partitioner {
+ public:
+  explicit HashPartitioner(int shard_num) : Partitioner(shard_num) {}
+
+ public:
+  PartitionerEnum type() const noexcept override {
+    return PartitionerEnum::HASH;
+  }
+  int Shard(int_t node) const noexcept override {
+    return (int)(node % shard_num_);
+  }
+
+ protected:
+  void WriteBody(std::ostringstream* /*oss*/) const override {}
+  bool ParseLine(const std::string& /*key*/,
+                 std::istringstream* /*iss*/) override {
+    return false;
+  }
+};
+
+/************************************************************************/
+/* RangePartitioner */
+/************************************************************************/
+// Shard i owns the nodes in [bounds[i - 1], bounds[i]).
+class RangePartitioner : public Partitioner {
+ private:
+  vec_int_t bounds_;
+
+ public:
+  explicit RangePartitioner(int shard_num) : Partitioner(shard_num) {}
+
+ public:
+  PartitionerEnum type() const noexcept override {
+    return PartitionerEnum::RANGE;
+  }
+  int Shard(int_t node) const noexcept override {
+    return (int)(std::upper_bound(bounds_.begin(), bounds_.end(), node) -
+                 bounds_.begin());
+  }
+
+  void set_bounds(const vec_int_t& bounds) { bounds_ = bounds; }
+
+ protected:
+  void WriteBody(std::ostringstream* oss) const override {
+    for (auto bound : bounds_) {
+      *oss << "bound " << bound << "\n";
+    }
+  }
+
+  bool ParseLine(const std::string& key, std::istringstream* iss) override {
+    int_t bound;
+    if (key != "bound" || !(*iss >> bound)) {
+      return false;
+    }
+    bounds_.emplace_back(bound);
+    return true;
+  }
+
+  bool Check() const override {
+    if (bounds_.size() + 1 != (size_t)shard_num_) {
+      DXERROR("Range partitioner needs %d bounds, got %zu.", shard_num_ - 1,
+              bounds_.size());
+      return false;
+    }
+    if (!std::is_sorted(bounds_.begin(), bounds_.end())) {
+      DXERROR("Bounds of range partitioner must be sorted.");
+      return false;
+    }
+    return true;
+  }
+};
+
+/************************************************************************/
+/* DegreePartitioner */
+/************************************************************************/
+// Heavy nodes are assigned explicitly, the others are hashed.
+class DegreePartitioner : public Partitioner {
+ private:
+  std::unordered_map<int_t, int> assignments_;
+
+ public:
+  explicit DegreePartitioner(int shard_num) : Partitioner(shard_num) {}
+
+ public:
+  PartitionerEnum type() const noexcept override {
+    return PartitionerEnum::DEGREE;
+  }
+  int Shard(int_t node) const noexcept override {
+    auto it = assignments_.find(node);
+    return it == assignments_.end() ? (int)(node % shard_num_) : it->second;
+  }
+
+  void Assign(int_t node, int shard_id) { assignments_[node] = shard_id; }
+
+ protected:
+  void WriteBody(std::ostringstream* oss) const override {
+    for (const auto& entry : assignments_) {
+      *oss << "assign " << entry.first << " " << entry.second << "\n";
+    }
+  }
+
+  bool ParseLine(const std::string& key, std::istringstream* iss) override {
+    int_t node;
+    int shard_id;
+    if (key != "assign" || !(*iss >> node >> shard_id)) {
+      return false;
+    }
+    if (shard_id < 0 || shard_id >= shard_num_) {
+      DXERROR("Invalid shard id: %d.", shard_id);
+      return false;
+    }
+    assignments_[node] = shard_id;
+    return true;
+  }
+};
+
+/************************************************************************/
+/* ClusterPartitioner */
+/************************************************************************/
+// Nodes of a cluster are on the same shard, the others are hashed.
+class ClusterPartitioner : public Partitioner {
+ private:
+  index_map_t clusters_;
+
+ public:
+  explicit ClusterPartitioner(int shard_num) : Partitioner(shard_num) {}
+
+ public:
+  PartitionerEnum type() const noexcept override {
+    return PartitionerEnum::CLUSTER;
+  }
+  int Shard(int_t node) const noexcept override {
+    auto it = clusters_.find(node);
+    return it == clusters_.end() ? (int)(node % shard_num_)
+                                 : it->second % shard_num_;
+  }
+
+  void set_clusters(const index_map_t& clusters) { clusters_ = clusters; }
+
+ protected:
+  void WriteBody(std::ostringstream* oss) const override {
+    std::vector<std::pair<int_t, int>> entries(clusters_.begin(),
+                                               clusters_.end());
+    std::sort(entries.begin(), entries.end());
+    for (const auto& entry : entries) {
+      *oss << "cluster " << entry.first << " " << entry.second << "\n";
+    }
+  }
+
+  bool ParseLine(const std::string& key, std::istringstream* iss) override {
+    int_t node;
+    int cluster;
+    if (key != "cluster" || !(*iss >> node >> cluster)) {
+      return false;
+    }
+    if (cluster < 0) {
+      DXERROR("Invalid cluster: %d.", cluster);
+      return false;
+    }
+    clusters_[node] = cluster;
+    return true;
+  }
+};
+
+// Merges the loads of a node listed more than once, sorts 'node_loads'
+// heaviest first and makes the first 'hub_num' hubs, returns the number of
+// hubs.
+size_t SetHubs(int hub_num, std::vector<node_load_t>* node_loads,
+               Partitioner* partitioner) {
+  // A node listed twice would take two hubs, or be a hub and be assigned.
+  std::sort(node_loads->begin(), node_loads->end());
+  size_t size = 0;
+  for (size_t i = 0; i < node_loads->size(); ++i) {
+    if (size > 0 && (*node_loads)[size - 1].first == (*node_loads)[i].first) {
+      (*node_loads)[size - 1].second += (*node_loads)[i].second;
+    } else {
+      (*node_loads)[size++] = (*node_loads)[i];
+    }
+  }
+  node_loads->resize(size);
+
+  std::sort(node_loads->begin(), node_loads->end(),
+            [](const node_load_t& a, const node_load_t& b) {
+              return a.second > b.second ||
+                     (a.second == b.second && a.first < b.first);
+            });
+
+  size_t hub_size =
+      std::min((size_t)std::max(hub_num, 0), node_loads->size());
+  vec_int_t hubs;
+  for (size_t i = 0; i < hub_size; ++i) {
+    hubs.emplace_back((*node_loads)[i].first);
+  }
+  partitioner->set_hubs(hubs);
+  return hub_size;
+}
+
+}  // namespace
+
+/************************************************************************/
+/* Partitioner */
+/************************************************************************/
+int Partitioner::Route(int_t node) const noexcept {
+  if (IsHub(node)) {
+    thread_local int next = 0;
+    next = (next + 1) % shard_num_;
+    return next;
+  }
+  return Shard(node);
+}
+
+std::string Partitioner::ToString() const {
+  std::ostringstream oss;
+  oss << "type " << (int)type() << "\n";
+  oss << "shard_num " << shard_num_ << "\n";
+  WriteBody(&oss);
+  for (auto hub : hubs_) {
+    oss << "hub " << hub << "\n";
+  }
+  return oss.str();
+}
+
+std::unique_ptr<Partitioner> NewPartitioner(PartitionerEnum type,
+                                            int shard_num) {
+  std::unique_ptr<Partitioner> partitioner;
+  if (shard_num <= 0) {
+    DXERROR("Number of shard: %d must be greater than 0.", shard_num);
+    return partitioner;
+  }
+
+  switch (type) {
+    case PartitionerEnum::HASH:
+      partitioner.reset(new HashPartitioner(shard_num));
+      break;
+    case PartitionerEnum::RANGE:
+      partitioner.reset(new RangePartitioner(shard_num));
+      break;
+    case PartitionerEnum::DEGREE:
+      partitioner.reset(new DegreePartitioner(shard_num));
+      break;
+    case PartitionerEnum::CLUSTER:
+      partitioner.reset(new ClusterPartitioner(shard_num));
+      break;
+    default:
+      DXERROR("Unknown partitioner type: %d.", (int)type);
+      break;
+  }
+  return partitioner;
+}
+
+std::unique_ptr<Partitioner> ParsePartitioner(const std::string& text) {
+  std::unique_ptr<Partitioner> partitioner;
+  std::istringstream lines(text);
+  std::string line, key;
+  std::istringstream iss;
+  int type = -1, shard_num = 0;
+  vec_int_t hubs;
+
+  while (std::getline(lines, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    iss.clear();
+    iss.str(line);
+    if (!(iss >> key)) {
+      continue;
+    }
+
+    bool ok = true;
+    if (key == "type") {
+      ok = !partitioner && (bool)(iss >> type);
+    } else if (key == "shard_num") {
+      ok = !partitioner && (bool)(iss >> shard_num) && type >= 0;
+      if (ok) {
+        partitioner = NewPartitioner((PartitionerEnum)type, shard_num);
+        ok = partitioner != nullptr;
+      }
+    } else if (key == "hub") {
+      int_t hub;
+      ok = (bool)(iss >> hub);
+      hubs.emplace_back(hub);
+    } else {
+      ok = partitioner && partitioner->ParseLine(key, &iss);
+    }
+
+    if (!ok) {
+      DXERROR("Invalid partition line: %s.", line.c_str());
+      partitioner.reset();
+      return partitioner;
+    }
+  }
+
+  if (!partitioner) {
+    DXERROR("Partition type and shard number are required.");
+    return partitioner;
+  }
+
+  partitioner->set_hubs(hubs);
+  if (!partitioner->Check()) {
+    partitioner.reset();
+  }
+  return partitioner;
+}
+
+std::unique_ptr<Partitioner> LoadPartitioner(const std::string& file) {
+  deepx_core::AutoInputFileStream ifs;
+  if (!ifs.Open(file)) {
+    DXERROR("Failed to open file: %s.", file.c_str());
+    return nullptr;
+  }
+
+  std::string text, line;
+  while (GetLine(ifs, line)) {
+    text += line;
+    text += "\n";
+  }
+  return ParsePartitioner(text);
+}
+
+bool SavePartitioner(const Partitioner& partitioner, const std::string& file) {
+  deepx_core::AutoOutputFileStream ofs;
+  if (!ofs.Open(file)) {
+    DXERROR("Failed to open file: %s.", file.c_str());
+    return false;
+  }
+
+  std::string text = partitioner.ToString();
+  ofs.Write(text.data(), text.size());
+  if (!ofs) {
+    DXERROR("Failed to write file: %s.", file.c_str());
+    return false;
+  }
+  return true;
+}
+
+/************************************************************************/
+/* Partitioner builder */
+/************************************************************************/
+std::unique_ptr<Partitioner> BuildPartitioner(
+    PartitionerEnum type, int shard_num, int hub_num, int assign_num,
+    std::vector<node_load_t> node_loads) {
+  auto partitioner = NewPartitioner(type, shard_num);
+  if (!partitioner) {
+    return partitioner;
+  }
+
+  // heaviest first
+  size_t hub_size = SetHubs(hub_num, &node_loads, partitioner.get());
+
+  if (type == PartitionerEnum::RANGE) {
+    std::vector<node_load_t> others(node_loads.begin() + hub_size,
+                                    node_loads.end());
+    std::sort(others.begin(), others.end());
+    double total = 0;
+    for (const auto& entry : others) {
+      total += entry.second;
+    }
+
+    vec_int_t bounds;
+    double sum = 0;
+    for (size_t i = 0;
+         i < others.size() && (int)bounds.size() + 1 < shard_num; ++i) {
+      sum += others[i].second;
+      if (sum >= total * (bounds.size() + 1) / shard_num &&
+          i + 1 < others.size()) {
+        bounds.emplace_back(others[i + 1].first);
+      }
+    }
+    // shards past the last node are empty
+    while ((int)bounds.size() + 1 < shard_num) {
+      bounds.emplace_back(others.empty() ? 0 : others.back().first + 1);
+    }
+    static_cast<RangePartitioner*>(partitioner.get())->set_bounds(bounds);
+  } else if (type == PartitionerEnum::DEGREE) {
+    auto* degree_partitioner =
+        static_cast<DegreePartitioner*>(partitioner.get());
+    size_t assign_end = std::min(
+        hub_size + (size_t)std::max(assign_num, 0), node_loads.size());
+
+    // load of the hashed nodes
+    std::vector<double> loads(shard_num, 0);
+    for (size_t i = assign_end; i < node_loads.size(); ++i) {
+      loads[node_loads[i].first % shard_num] += node_loads[i].second;
+    }
+
+    // longest processing time first
+    using shard_load_t = std::pair<double, int>;
+    std::priority_queue<shard_load_t, std::vector<shard_load_t>,
+                        std::greater<shard_load_t>>
+        heap;
+    for (int i = 0; i < shard_num; ++i) {
+      heap.emplace(loads[i], i);
+    }
+    for (size_t i = hub_size; i < assign_end; ++i) {
+      shard_load_t least = heap.top();
+      heap.pop();
+      degree_partitioner->Assign(node_loads[i].first, least.second);
+      heap.emplace(least.first + node_loads[i].second, least.second);
+    }
+  }
+  return partitioner;
+}
+
+std::unique_ptr<Partitioner> BuildClusterPartitioner(
+    int shard_num, int hub_num, std::vector<node_load_t> node_loads,
+    const index_map_t& clusters) {
+  auto partitioner = NewPartitioner(PartitionerEnum::CLUSTER, shard_num);
+  if (!partitioner) {
+    return partitioner;
+  }
+
+  SetHubs(hub_num, &node_loads, partitioner.get());
+  static_cast<ClusterPartitioner*>(partitioner.get())->set_clusters(clusters);
+  return partitioner;
+}
+
+std::vector<double> ShardLoads(const Partitioner& partitioner,
+                               const std::vector<node_load_t>& node_loads) {
+  int shard_num = partitioner.shard_num();
+  std::vector<double> loads(shard_num, 0);
+  for (const auto& entry : node_loads) {
+    if (partitioner.IsHub(entry.first)) {
+      for (auto& load : loads) {
+        load += entry.second / shard_num;
+      }
+    } else {
+      loads[partitioner.Shard(entry.first)] += entry.second;
+    }
+  }
+  return loads;
+}
+
+}  // namespace embedx
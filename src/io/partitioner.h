@@ -0,0 +1,112 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <memory>   // std::unique_ptr
+#include <sstream>  // std::ostringstream, std::istringstream
+#include <string>
+#include <unordered_set>
+#include <utility>  // std::pair
+#include <vector>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+enum class PartitionerEnum : int {
+  HASH = 0,
+  RANGE = 1,
+  DEGREE = 2,
+  CLUSTER = 3,
+};
+
+// Partitioner maps a node to the graph server shard owning it.
+//
+// Hub nodes are replicated on every shard, so a client may send them to any
+// shard. The same partitioner is used by the loaders of graph servers and by
+// the dist ops of clients, clients fetch it from graph servers.
+class Partitioner {
+ protected:
+  int shard_num_ = 1;
+  std::unordered_set<int_t> hubs_;
+
+ public:
+  explicit Partitioner(int shard_num) : shard_num_(shard_num) {}
+  virtual ~Partitioner() = default;
+
+ public:
+  virtual PartitionerEnum type() const noexcept = 0;
+  // the home shard of node
+  virtual int Shard(int_t node) const noexcept = 0;
+
+  int shard_num() const noexcept { return shard_num_; }
+  const std::unordered_set<int_t>& hubs() const noexcept { return hubs_; }
+  void set_hubs(const vec_int_t& hubs) {
+    hubs_.clear();
+    hubs_.insert(hubs.begin(), hubs.end());
+  }
+
+  bool IsHub(int_t node) const noexcept {
+    return !hubs_.empty() && hubs_.find(node) != hubs_.end();
+  }
+  // whether shard 'shard_id' stores node
+  bool PartOfShard(int_t node, int shard_id) const noexcept {
+    return Shard(node) == shard_id || IsHub(node);
+  }
+  // the shard a client sends node to, hubs are spread over all shards
+  int Route(int_t node) const noexcept;
+
+  // The text form is also the format of partition files.
+  std::string ToString() const;
+
+ protected:
+  virtual void WriteBody(std::ostringstream* oss) const = 0;
+  virtual bool ParseLine(const std::string& key, std::istringstream* iss) = 0;
+  virtual bool Check() const { return true; }
+
+  friend std::unique_ptr<Partitioner> ParsePartitioner(const std::string& text);
+};
+
+std::unique_ptr<Partitioner> NewPartitioner(PartitionerEnum type,
+                                            int shard_num);
+std::unique_ptr<Partitioner> ParsePartitioner(const std::string& text);
+std::unique_ptr<Partitioner> LoadPartitioner(const std::string& file);
+bool SavePartitioner(const Partitioner& partitioner, const std::string& file);
+
+/************************************************************************/
+/* Partitioner builder */
+/************************************************************************/
+// load of a node, e.g. its degree
+using node_load_t = std::pair<int_t, double>;
+
+// Builds a partitioner from node loads, the loads of a node listed more than
+// once are summed.
+//
+// The 'hub_num' heaviest nodes become hubs. RANGE cuts the sorted node ids
+// into ranges of equal load. DEGREE assigns the 'assign_num' heaviest of the
+// remaining nodes greedily to the least loaded shard, on top of the load the
+// other nodes bring by hashing.
+std::unique_ptr<Partitioner> BuildPartitioner(
+    PartitionerEnum type, int shard_num, int hub_num, int assign_num,
+    std::vector<node_load_t> node_loads);
+
+// Builds a CLUSTER partitioner, shard 'cluster % shard_num' owns the nodes of
+// a cluster of 'clusters', see ClusterGraph. Nodes without clusters are
+// hashed. The 'hub_num' heaviest nodes become hubs.
+std::unique_ptr<Partitioner> BuildClusterPartitioner(
+    int shard_num, int hub_num, std::vector<node_load_t> node_loads,
+    const index_map_t& clusters);
+
+// Load of each shard, the load of a hub is spread over all shards.
+std::vector<double> ShardLoads(const Partitioner& partitioner,
+                               const std::vector<node_load_t>& node_loads);
+
+}  // namespace embedx
@@ -0,0 +1,163 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/partitioner.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::max_element
+#include <cmath>      // std::pow
+#include <memory>     // std::unique_ptr
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace embedx {
+
+class PartitionerTest : public ::testing::Test {
+ protected:
+  const int SHARD_NUM = 8;
+  const int NODE_NUM = 100000;
+
+  std::vector<node_load_t> node_loads_;
+
+ protected:
+  void SetUp() override {
+    // zipf like loads, the heaviest nodes are spread over the id space
+    for (int i = 0; i < NODE_NUM; ++i) {
+      int_t node = (int_t)((i * 7919) % NODE_NUM);
+      node_loads_.emplace_back(node, 1e5 / std::pow(i + 1, 1.1) + 1);
+    }
+  }
+
+  double Imbalance(const Partitioner& partitioner) const {
+    auto loads = ShardLoads(partitioner, node_loads_);
+    double sum = 0;
+    for (double load : loads) {
+      sum += load;
+    }
+    return *std::max_element(loads.begin(), loads.end()) / (sum / SHARD_NUM);
+  }
+
+  void ExpectSame(const Partitioner& a, const Partitioner& b) const {
+    EXPECT_EQ(a.type(), b.type());
+    EXPECT_EQ(a.shard_num(), b.shard_num());
+    EXPECT_EQ(a.hubs(), b.hubs());
+    for (const auto& entry : node_loads_) {
+      EXPECT_EQ(a.Shard(entry.first), b.Shard(entry.first));
+    }
+  }
+};
+
+TEST_F(PartitionerTest, Hash) {
+  auto partitioner = NewPartitioner(PartitionerEnum::HASH, SHARD_NUM);
+  ASSERT_TRUE(partitioner);
+  EXPECT_EQ(partitioner->Shard(17), 1);
+  EXPECT_TRUE(partitioner->PartOfShard(17, 1));
+  EXPECT_FALSE(partitioner->PartOfShard(17, 2));
+  EXPECT_EQ(partitioner->Route(17), 1);
+
+  partitioner->set_hubs({17});
+  for (int i = 0; i < SHARD_NUM; ++i) {
+    EXPECT_TRUE(partitioner->PartOfShard(17, i));
+  }
+  std::vector<int> routed(SHARD_NUM, 0);
+  for (int i = 0; i < SHARD_NUM; ++i) {
+    routed[partitioner->Route(17)] += 1;
+  }
+  EXPECT_EQ(routed, std::vector<int>(SHARD_NUM, 1));
+}
+
+TEST_F(PartitionerTest, ParseInvalid) {
+  EXPECT_FALSE(ParsePartitioner(""));
+  EXPECT_FALSE(ParsePartitioner("shard_num 2\n"));
+  EXPECT_FALSE(ParsePartitioner("type 1\nshard_num 3\nbound 10\n"));
+  EXPECT_FALSE(ParsePartitioner("type 2\nshard_num 2\nassign 1 5\n"));
+  EXPECT_FALSE(ParsePartitioner("type 0\nshard_num 2\nbound 10\n"));
+  EXPECT_FALSE(ParsePartitioner("type 3\nshard_num 2\ncluster 1 -1\n"));
+}
+
+TEST_F(PartitionerTest, Range) {
+  auto partitioner =
+      BuildPartitioner(PartitionerEnum::RANGE, SHARD_NUM, 16, 0, node_loads_);
+  ASSERT_TRUE(partitioner);
+  EXPECT_EQ(partitioner->hubs().size(), 16u);
+  EXPECT_LT(Imbalance(*partitioner), 1.1);
+
+  // ranges are ordered
+  int prev_shard = 0;
+  for (int node = 0; node < NODE_NUM; ++node) {
+    if (partitioner->IsHub((int_t)node)) {
+      continue;
+    }
+    int shard = partitioner->Shard((int_t)node);
+    EXPECT_GE(shard, prev_shard);
+    prev_shard = shard;
+  }
+
+  auto parsed = ParsePartitioner(partitioner->ToString());
+  ASSERT_TRUE(parsed);
+  ExpectSame(*partitioner, *parsed);
+}
+
+// The loads of a node listed twice are merged, it is a hub once.
+TEST_F(PartitionerTest, DuplicateNodes) {
+  std::vector<node_load_t> node_loads = {
+      {1, 10}, {2, 8}, {1, 10}, {3, 9}, {4, 1}};
+  auto partitioner =
+      BuildPartitioner(PartitionerEnum::DEGREE, 2, 2, 2, node_loads);
+  ASSERT_TRUE(partitioner);
+  EXPECT_EQ(partitioner->hubs(), std::unordered_set<int_t>({1, 3}));
+  // the heaviest of the others goes to the least loaded shard
+  EXPECT_EQ(partitioner->Shard(2), 0);
+  EXPECT_EQ(partitioner->Shard(4), 1);
+
+  partitioner = BuildClusterPartitioner(2, 2, node_loads, index_map_t());
+  ASSERT_TRUE(partitioner);
+  EXPECT_EQ(partitioner->hubs(), std::unordered_set<int_t>({1, 3}));
+}
+
+TEST_F(PartitionerTest, Degree) {
+  auto hash = NewPartitioner(PartitionerEnum::HASH, SHARD_NUM);
+  auto partitioner = BuildPartitioner(PartitionerEnum::DEGREE, SHARD_NUM, 16,
+                                      1000, node_loads_);
+  ASSERT_TRUE(partitioner);
+  EXPECT_GT(Imbalance(*hash), 1.5);
+  EXPECT_LT(Imbalance(*partitioner), 1.01);
+
+  auto parsed = ParsePartitioner(partitioner->ToString());
+  ASSERT_TRUE(parsed);
+  ExpectSame(*partitioner, *parsed);
+}
+
+TEST_F(PartitionerTest, Cluster) {
+  // nodes 0, 1, ... 99 in clusters of ten
+  index_map_t clusters;
+  for (int node = 0; node < 100; ++node) {
+    clusters.emplace((int_t)node, node / 10);
+  }
+  auto partitioner =
+      BuildClusterPartitioner(SHARD_NUM, 16, node_loads_, clusters);
+  ASSERT_TRUE(partitioner);
+  EXPECT_EQ(partitioner->type(), PartitionerEnum::CLUSTER);
+  EXPECT_EQ(partitioner->hubs().size(), 16u);
+  for (int node = 0; node < 100; ++node) {
+    EXPECT_EQ(partitioner->Shard((int_t)node), node / 10 % SHARD_NUM);
+  }
+  // hashed without a cluster
+  EXPECT_EQ(partitioner->Shard(100), 100 % SHARD_NUM);
+
+  auto parsed = ParsePartitioner(partitioner->ToString());
+  ASSERT_TRUE(parsed);
+  ExpectSame(*partitioner, *parsed);
+}
+
+}  // namespace embedx
@@ -15,6 +15,7 @@
 #include <memory>     // std::unique_ptr
 #include <sstream>    // std::stringstream
 #include <string>
+#include <unordered_map>
 
 #include "src/common/data_types.h"
 #include "src/io/storage/adjacency_impl.h"
@@ -27,6 +28,7 @@ class AdjListImpl : public AdjacencyImpl {
   vec_int_t keys_;
   adj_list_t adj_list_;
   index_map_t in_degree_;
+  std::unordered_map<int_t, vec_time_t> timestamps_;
 
  public:
   ~AdjListImpl() override = default;
@@ -40,6 +42,7 @@ class AdjListImpl : public AdjacencyImpl {
   void Clear() noexcept override {
     adj_list_.clear();
     in_degree_.clear();
+    timestamps_.clear();
     keys_.clear();
   }
 
@@ -58,7 +61,12 @@ class AdjListImpl : public AdjacencyImpl {
     }
 
     // TODO(longsail): which sorting function to use
-    AdjacencyImpl::SortByNode(&value->pairs);
+    if (value->timestamps.empty()) {
+      AdjacencyImpl::SortByNode(&value->pairs);
+    } else {
+      AdjacencyImpl::SortByTime(value);
+      timestamps_.emplace(value->node, value->timestamps);
+    }
     keys_.emplace_back(value->node);
     adj_list_.emplace(value->node, value->pairs);
 
@@ -97,6 +105,15 @@ class AdjListImpl : public AdjacencyImpl {
     return nullptr;
   }
 
+  const vec_time_t* FindTimestamps(int_t node) const override {
+    auto it = timestamps_.find(node);
+    if (it != timestamps_.end()) {
+      return &it->second;
+    }
+
+    return nullptr;
+  }
+
   std::string Print(int_t node) const override {
     std::stringstream ss;
     ss << "Key:" << node;
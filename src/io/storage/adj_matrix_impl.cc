@@ -30,6 +30,8 @@ class AdjMatrixImpl : public AdjacencyImpl {
   Indexing src_indexing_;
   Indexing dst_indexing_;
   std::vector<vec_pair_t> adj_matrix_;
+  // empty for contexts without timestamps
+  std::vector<vec_time_t> timestamps_;
   std::unique_ptr<GraphStatics> graph_statics_;
 
  public:
@@ -49,6 +51,7 @@ class AdjMatrixImpl : public AdjacencyImpl {
     src_indexing_.Clear();
     dst_indexing_.Clear();
     adj_matrix_.clear();
+    timestamps_.clear();
   }
 
   void Reserve(uint64_t estimated_size) override {
@@ -66,9 +69,14 @@ class AdjMatrixImpl : public AdjacencyImpl {
     }
 
     // TODO(longsail): which sorting function to use
-    AdjacencyImpl::SortByNode(&value->pairs);
+    if (value->timestamps.empty()) {
+      AdjacencyImpl::SortByNode(&value->pairs);
+    } else {
+      AdjacencyImpl::SortByTime(value);
+    }
     src_indexing_.Add(value->node);
     adj_matrix_.emplace_back(value->pairs);
+    timestamps_.emplace_back(value->timestamps);
 
     for (auto& pair : value->pairs) {
       dst_indexing_.Add(pair.first);
@@ -91,6 +99,7 @@ class AdjMatrixImpl : public AdjacencyImpl {
 
     src_indexing_.Add(value->node);
     adj_matrix_.emplace_back(value->pairs);
+    timestamps_.emplace_back();
 
     return true;
   }
@@ -108,6 +117,15 @@ class AdjMatrixImpl : public AdjacencyImpl {
     return &adj_matrix_[src_index];
   }
 
+  const vec_time_t* FindTimestamps(int_t node) const override {
+    int src_index = src_indexing_.Get(node);
+    if (src_index < 0 || src_index >= (int)timestamps_.size() ||
+        timestamps_[src_index].empty()) {
+      return nullptr;
+    }
+    return &timestamps_[src_index];
+  }
+
   std::string Print(int_t node) const override {
     std::stringstream ss;
     ss << "Key:" << node;
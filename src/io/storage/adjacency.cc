@@ -45,6 +45,10 @@ const vec_pair_t* Adjacency::FindNeighbor(int_t node) const {
   return impl_->FindNeighbor(node);
 }
 
+const vec_time_t* Adjacency::FindTimestamps(int_t node) const {
+  return impl_->FindTimestamps(node);
+}
+
 std::string Adjacency::Print(int_t node) const { return impl_->Print(node); }
 
 int Adjacency::GetInDegree(int_t dst_node) const {
@@ -41,6 +41,7 @@ class Adjacency {
 
  public:
   const vec_pair_t* FindNeighbor(int_t node) const;
+  const vec_time_t* FindTimestamps(int_t node) const;
   std::string Print(int_t node) const;
   int GetInDegree(int_t dst_node) const;
   int GetOutDegree(int_t src_node) const;
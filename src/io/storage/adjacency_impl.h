@@ -13,6 +13,7 @@
 #include <algorithm>  // std::stable_sort
 #include <memory>     // std::unique_ptr
 #include <string>
+#include <vector>
 
 #include "src/common/data_types.h"
 #include "src/io/io_util.h"
@@ -38,22 +39,37 @@ class AdjacencyImpl {
 
  public:
   virtual const vec_pair_t* FindNeighbor(int_t node) const = 0;
+  // nullptr if the context of 'node' has no timestamps
+  virtual const vec_time_t* FindTimestamps(int_t node) const = 0;
   virtual std::string Print(int_t node) const = 0;
   virtual int GetInDegree(int_t dst_node) const = 0;
   virtual int GetOutDegree(int_t src_node) const = 0;
 
  protected:
-  void SortByNode(vec_pair_t* context) const {
-    std::stable_sort(context->begin(), context->end(),
-                     [&](const pair_t& a, const pair_t& b) {
-                       uint16_t type_a = io_util::GetNodeType(a.first);
-                       uint16_t type_b = io_util::GetNodeType(b.first);
-                       if (type_a == type_b) {
-                         return a.first < b.first;
-                       } else {
-                         return type_a < type_b;
-                       }
-                     });
+  void SortByNode(vec_pair_t* context) const { io_util::SortByNode(context); }
+
+  // Sorts the pairs of a temporal context by timestamps, and then by nodes.
+  void SortByTime(AdjValue* value) const {
+    std::vector<int> indices(value->pairs.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      indices[i] = (int)i;
+    }
+    std::stable_sort(indices.begin(), indices.end(), [value](int a, int b) {
+      if (value->timestamps[a] == value->timestamps[b]) {
+        return value->pairs[a].first < value->pairs[b].first;
+      } else {
+        return value->timestamps[a] < value->timestamps[b];
+      }
+    });
+
+    vec_pair_t pairs(indices.size());
+    vec_time_t timestamps(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      pairs[i] = value->pairs[indices[i]];
+      timestamps[i] = value->timestamps[indices[i]];
+    }
+    value->pairs.swap(pairs);
+    value->timestamps.swap(timestamps);
   }
 
   void SortByWeight(vec_pair_t* context) const {
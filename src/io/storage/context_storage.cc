@@ -51,6 +51,9 @@ class ContextStorage : public Storage {
   const vec_pair_t* FindNeighbor(int_t node) const override {
     return adj_->FindNeighbor(node);
   }
+  const vec_time_t* FindTimestamps(int_t node) const override {
+    return adj_->FindTimestamps(node);
+  }
   std::string Print(int_t node) const override { return adj_->Print(node); }
   int GetInDegree(int_t dst_node) const override {
     return adj_->GetInDegree(dst_node);
@@ -81,4 +81,37 @@ TEST_F(ContextStorageTest, Insert_AdjMatrix) {
   }
 }
 
+TEST_F(ContextStorageTest, Insert_Temporal) {
+  for (auto store_type : {AdjacencyEnum::ADJ_LIST, AdjacencyEnum::ADJ_MATRIX}) {
+    context_store_ = NewContextStorage((int)store_type);
+    context_store_->Reserve(ESTIMATED_SIZE);
+
+    AdjValue value;
+    value.node = 1;
+    value.pairs = {{5, 1.0}, {3, 1.0}, {4, 1.0}, {3, 2.0}};
+    value.timestamps = {30, 20, 10, 10};
+    EXPECT_TRUE(context_store_->InsertContext(&value));
+    EXPECT_TRUE(context_store_->InsertContext(&context_values_[0]));
+
+    // sorted by time and then by node
+    const auto* context = context_store_->FindNeighbor(1);
+    const auto* timestamps = context_store_->FindTimestamps(1);
+    ASSERT_TRUE(context != nullptr);
+    ASSERT_TRUE(timestamps != nullptr);
+    vec_int_t expected_nodes = {3, 4, 3, 5};
+    vec_time_t expected_timestamps = {10, 10, 20, 30};
+    ASSERT_EQ(context->size(), expected_nodes.size());
+    for (size_t i = 0; i < expected_nodes.size(); ++i) {
+      EXPECT_EQ((*context)[i].first, expected_nodes[i]);
+      EXPECT_EQ((*timestamps)[i], expected_timestamps[i]);
+    }
+    EXPECT_FLOAT_EQ((*context)[0].second, 2.0);
+    EXPECT_EQ(context_store_->GetInDegree(3), 2);
+
+    // no timestamps
+    EXPECT_TRUE(context_store_->FindTimestamps(0) == nullptr);
+    EXPECT_TRUE(context_store_->FindTimestamps(100) == nullptr);
+  }
+}
+
 }  // namespace embedx
@@ -42,6 +42,9 @@ class EdgeStorage : public Storage {
   bool InsertEdge(EdgeValue* value) override {
     return edge_vector_->Add(value);
   }
+  bool InsertEdgeFeature(EdgeFeatureValue* value) override {
+    return edge_vector_->Add(value);
+  }
 
  public:
   size_t Size() const noexcept override { return edge_vector_->Size(); }
@@ -65,6 +68,11 @@ class EdgeStorage : public Storage {
   int GetOutDegree(int_t src_node) const override {
     return edge_vector_->GetOutDegree(src_node);
   }
+
+ public:
+  const EdgeVector* edge_vector() const noexcept override {
+    return edge_vector_.get();
+  }
 };
 
 std::unique_ptr<Storage> NewEdgeStorage(int store_type) {
@@ -17,7 +17,7 @@
 
 namespace embedx {
 
-EdgeVector::EdgeVector() {
+EdgeVector::EdgeVector() : feat_offsets_(1, 0) {
   graph_statics_ = NewGraphStatics(&src_indexing_, &dst_indexing_);
 }
 
@@ -29,6 +29,9 @@ void EdgeVector::Clear() noexcept {
   adj_node_list_.clear();
   adj_edge_list_.clear();
 
+  feat_offsets_.assign(1, 0);
+  feat_list_.clear();
+
   src_indexing_.Clear();
   dst_indexing_.Clear();
 }
@@ -41,37 +44,57 @@ void EdgeVector::Reserve(uint64_t estimated_size) {
   adj_node_list_.reserve(estimated_size);
   adj_edge_list_.reserve(estimated_size);
 
+  feat_offsets_.reserve(estimated_size + 1);
+
   src_indexing_.Reserve(estimated_size);
   dst_indexing_.Reserve(estimated_size);
 }
 
 bool EdgeVector::Add(EdgeValue* value) {
+  if (!AddEdge(value->src_node, value->dst_node, value->weight)) {
+    return false;
+  }
+  feat_offsets_.emplace_back(feat_list_.size());
+  return true;
+}
+
+bool EdgeVector::Add(EdgeFeatureValue* value) {
+  if (!AddEdge(value->src_node, value->dst_node, 1)) {
+    return false;
+  }
+  feat_list_.insert(feat_list_.end(), value->feats.begin(),
+                    value->feats.end());
+  feat_offsets_.emplace_back(feat_list_.size());
+  return true;
+}
+
+bool EdgeVector::AddEdge(int_t src_node, int_t dst_node, float_t weight) {
   auto edge_id = (int_t)src_node_list_.size();
-  src_node_list_.emplace_back(value->src_node);
-  dst_node_list_.emplace_back(value->dst_node);
-  weight_list_.emplace_back(value->weight);
+  src_node_list_.emplace_back(src_node);
+  dst_node_list_.emplace_back(dst_node);
+  weight_list_.emplace_back(weight);
 
   // graph stat
-  src_indexing_.Add(value->src_node);
-  dst_indexing_.Add(value->dst_node);
-  if (!graph_statics_->Add(value->src_node, value->dst_node)) {
+  src_indexing_.Add(src_node);
+  dst_indexing_.Add(dst_node);
+  if (!graph_statics_->Add(src_node, dst_node)) {
     return false;
   }
 
   // fill adj_node and adj_edge
-  auto src_index = src_indexing_.Get(value->src_node);
+  auto src_index = src_indexing_.Get(src_node);
   if (src_index < (int)adj_edge_list_.size()) {
-    adj_node_list_[src_index].emplace_back(value->dst_node);
+    adj_node_list_[src_index].emplace_back(dst_node);
     adj_edge_list_[src_index].emplace_back(edge_id);
   } else {
-    vec_int_t dst_node_list(1, value->dst_node);
+    vec_int_t dst_node_list(1, dst_node);
     adj_node_list_.emplace_back(dst_node_list);
 
     vec_int_t edge_id_list(1, edge_id);
     adj_edge_list_.emplace_back(edge_id_list);
   }
 
-  return false;
+  return true;
 }
 
 bool EdgeVector::GetSrcNode(int_t edge_id, int_t* src_node) const {
@@ -113,6 +136,19 @@ bool EdgeVector::GetWeight(int_t edge_id, float_t* weight) const {
   return true;
 }
 
+const pair_t* EdgeVector::GetFeature(int_t edge_id, size_t* size) const {
+  if (edge_id >= (int_t)src_node_list_.size()) {
+    DXERROR("Need edge_id < src_node_list.size(), got edge_id: %" PRIu64
+            " vs src_node_list.size(): %zu",
+            edge_id, src_node_list_.size());
+    *size = 0;
+    return nullptr;
+  }
+
+  *size = (size_t)(feat_offsets_[edge_id + 1] - feat_offsets_[edge_id]);
+  return feat_list_.data() + feat_offsets_[edge_id];
+}
+
 const vec_int_t* EdgeVector::FindNeighborNode(int_t node) const {
   int src_index = src_indexing_.Get(node);
   int adj_node_size = (int)adj_node_list_.size();
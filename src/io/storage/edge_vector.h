@@ -30,6 +30,10 @@ class EdgeVector {
   std::vector<vec_int_t> adj_node_list_;
   std::vector<vec_int_t> adj_edge_list_;
 
+  // features of edge i are [feat_offsets_[i], feat_offsets_[i + 1])
+  std::vector<uint64_t> feat_offsets_;
+  vec_pair_t feat_list_;
+
   Indexing src_indexing_;
   Indexing dst_indexing_;
   std::unique_ptr<GraphStatics> graph_statics_;
@@ -42,6 +46,7 @@ class EdgeVector {
   void Clear() noexcept;
   void Reserve(uint64_t estimated_size);
   bool Add(EdgeValue* value);
+  bool Add(EdgeFeatureValue* value);
 
   size_t Size() const noexcept { return src_node_list_.size(); }
   bool Empty() const noexcept { return src_node_list_.empty(); }
@@ -50,6 +55,8 @@ class EdgeVector {
   bool GetSrcNode(int_t edge_id, int_t* src_node) const;
   bool GetDstNode(int_t edge_id, int_t* dst_node) const;
   bool GetWeight(int_t edge_id, float_t* weight) const;
+  // features of 'edge_id', '*size' is 0 if it has none
+  const pair_t* GetFeature(int_t edge_id, size_t* size) const;
   const vec_int_t* FindNeighborNode(int_t node) const;
   const vec_int_t* FindNeighborEdge(int_t node) const;
   std::string Print(int_t edge_id) const;
@@ -71,6 +78,9 @@ class EdgeVector {
 
   const Indexing& src_indexing() const noexcept { return src_indexing_; }
   const Indexing& dst_indexing() const noexcept { return dst_indexing_; }
+
+ private:
+  bool AddEdge(int_t src_node, int_t dst_node, float_t weight);
 };
 
 std::unique_ptr<EdgeVector> NewEdgeVector(int store_type);
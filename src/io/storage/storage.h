@@ -18,6 +18,8 @@
 
 namespace embedx {
 
+class EdgeVector;
+
 class Storage {
  public:
   Storage() = default;
@@ -31,6 +33,7 @@ class Storage {
   virtual bool InsertContext(AdjValue*) { return true; }
   virtual bool InsertFeature(AdjValue*) { return true; }
   virtual bool InsertEdge(EdgeValue*) { return true; }
+  virtual bool InsertEdgeFeature(EdgeFeatureValue*) { return true; }
 
  public:
   virtual size_t Size() const noexcept = 0;
@@ -39,9 +42,17 @@ class Storage {
 
  public:
   virtual const vec_pair_t* FindNeighbor(int_t node) const = 0;
+  // nullptr if the context of 'node' has no timestamps
+  virtual const vec_time_t* FindTimestamps(int_t /*node*/) const {
+    return nullptr;
+  }
   virtual std::string Print(int_t node) const = 0;
   virtual int GetInDegree(int_t dst_node) const = 0;
   virtual int GetOutDegree(int_t src_node) const = 0;
+
+ public:
+  // edges of an edge storage, nullptr for the others
+  virtual const EdgeVector* edge_vector() const noexcept { return nullptr; }
 };
 
 std::unique_ptr<Storage> NewContextStorage(int store_type);
@@ -0,0 +1,164 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/text_buffer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>  // std::memcpy
+
+namespace embedx {
+namespace {
+
+constexpr double POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                            1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                            1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+constexpr int MAX_POW10 = 22;
+
+constexpr char DIGITS2[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536"
+    "37383940414243444546474849505152535455565758596061626364656667686970717273"
+    "7475767778798081828384858687888990919293949596979899";
+
+int FormatFloatSlow(float value, char* buf) noexcept {
+  char tmp[32];
+  int n = std::snprintf(tmp, sizeof(tmp), "%g", (double)value);
+  std::memcpy(buf, tmp, (size_t)n);
+  return n;
+}
+
+// Rounds 'v * 10^(5 - e)' to the nearest integer, ties to even as printf.
+//
+// Powers of 10 up to 10^22 are exact doubles, the residual of the product or
+// the quotient is exact by fma, so the result is correctly rounded.
+bool Round6(double v, int e, uint32_t* m) noexcept {
+  int k = 5 - e;
+  if (k < -MAX_POW10 || k > MAX_POW10) {
+    return false;
+  }
+
+  double p = POW10[k < 0 ? -k : k];
+  double q = k < 0 ? v / p : v * p;
+  double n = std::floor(q);
+  double d = q - n;
+  if (d > 0.5 + 1e-6) {
+    n += 1;
+  } else if (d >= 0.5 - 1e-6) {
+    // the sign of 'v * 10^k - q'
+    double r = k < 0 ? std::fma(-q, p, v) : std::fma(v, p, -q);
+    if (d > 0.5 || (d == 0.5 && (r > 0 || (r == 0 && std::fmod(n, 2) != 0)))) {
+      n += 1;
+    }
+  }
+  *m = (uint32_t)n;
+  return true;
+}
+
+}  // namespace
+
+int FormatUint64(uint64_t value, char* buf) noexcept {
+  char tmp[MAX_UINT64_CHARS];
+  int n = MAX_UINT64_CHARS;
+  while (value >= 100) {
+    int i = (int)(value % 100) * 2;
+    value /= 100;
+    tmp[--n] = DIGITS2[i + 1];
+    tmp[--n] = DIGITS2[i];
+  }
+  if (value >= 10) {
+    int i = (int)value * 2;
+    tmp[--n] = DIGITS2[i + 1];
+    tmp[--n] = DIGITS2[i];
+  } else {
+    tmp[--n] = (char)('0' + value);
+  }
+  std::memcpy(buf, tmp + n, (size_t)(MAX_UINT64_CHARS - n));
+  return MAX_UINT64_CHARS - n;
+}
+
+int FormatFloat(float value, char* buf) noexcept {
+  double v = value;
+  if (!std::isfinite(v)) {
+    return FormatFloatSlow(value, buf);
+  }
+
+  int n = 0;
+  if (std::signbit(v)) {
+    buf[n++] = '-';
+    v = -v;
+  }
+  if (v == 0) {
+    buf[n++] = '0';
+    return n;
+  }
+
+  // 'v' is about 'm * 10^(e - 5)' with 6 digits of 'm'
+  int e = (int)std::floor(std::log10(v));
+  uint32_t m;
+  if (!Round6(v, e, &m)) {
+    return FormatFloatSlow(value, buf);
+  }
+  if (m >= 1000000 || m < 100000) {
+    e += m >= 1000000 ? 1 : -1;
+    if (!Round6(v, e, &m)) {
+      return FormatFloatSlow(value, buf);
+    }
+  }
+
+  char digits[6];
+  for (int i = 4; i >= 0; i -= 2) {
+    int j = (int)(m % 100) * 2;
+    m /= 100;
+    digits[i] = DIGITS2[j];
+    digits[i + 1] = DIGITS2[j + 1];
+  }
+  int len = 6;
+  while (len > 1 && digits[len - 1] == '0') {
+    --len;
+  }
+
+  if (e < -4 || e >= 6) {
+    buf[n++] = digits[0];
+    if (len > 1) {
+      buf[n++] = '.';
+      std::memcpy(buf + n, digits + 1, (size_t)(len - 1));
+      n += len - 1;
+    }
+    buf[n++] = 'e';
+    buf[n++] = e < 0 ? '-' : '+';
+    int abs_e = e < 0 ? -e : e;
+    if (abs_e >= 100) {
+      buf[n++] = (char)('0' + abs_e / 100);
+      abs_e %= 100;
+    }
+    buf[n++] = DIGITS2[abs_e * 2];
+    buf[n++] = DIGITS2[abs_e * 2 + 1];
+  } else if (e >= 0) {
+    std::memcpy(buf + n, digits, (size_t)(e + 1));
+    n += e + 1;
+    if (len > e + 1) {
+      buf[n++] = '.';
+      std::memcpy(buf + n, digits + e + 1, (size_t)(len - e - 1));
+      n += len - e - 1;
+    }
+  } else {
+    buf[n++] = '0';
+    buf[n++] = '.';
+    for (int i = 0; i < -e - 1; ++i) {
+      buf[n++] = '0';
+    }
+    std::memcpy(buf + n, digits, (size_t)len);
+    n += len;
+  }
+  return n;
+}
+
+}  // namespace embedx
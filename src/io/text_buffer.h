@@ -0,0 +1,81 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <algorithm>  // std::max
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace embedx {
+
+// Max chars of FormatFloat, e.g. '-1.23457e-38'.
+constexpr int MAX_FLOAT_CHARS = 16;
+// Max chars of FormatUint64.
+constexpr int MAX_UINT64_CHARS = 20;
+
+// Formats 'value' like printf("%g") and std::ostream, 6 significant digits
+// without trailing zeros, into 'buf' of at least MAX_FLOAT_CHARS chars.
+// Returns the number of chars, 'buf' is not null terminated.
+int FormatFloat(float value, char* buf) noexcept;
+int FormatUint64(uint64_t value, char* buf) noexcept;
+
+// TextBuffer formats lines of numbers into a reusable buffer, several times
+// faster than std::ostringstream.
+class TextBuffer {
+ private:
+  std::string buf_;
+  size_t size_ = 0;
+
+ public:
+  const char* data() const noexcept { return buf_.data(); }
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  void clear() noexcept { size_ = 0; }
+
+  // Moves the text to 's' and takes the memory of 's' for later appends.
+  void Swap(std::string* s) {
+    buf_.resize(size_);
+    buf_.swap(*s);
+    buf_.resize(buf_.capacity());
+    size_ = 0;
+  }
+
+  void Append(char c) {
+    Reserve(1);
+    buf_[size_++] = c;
+  }
+
+  void Append(const char* s, size_t n) {
+    Reserve(n);
+    buf_.replace(size_, n, s, n);
+    size_ += n;
+  }
+
+  void Append(uint64_t value) {
+    Reserve(MAX_UINT64_CHARS);
+    size_ += FormatUint64(value, &buf_[size_]);
+  }
+
+  void Append(float value) {
+    Reserve(MAX_FLOAT_CHARS);
+    size_ += FormatFloat(value, &buf_[size_]);
+  }
+
+ private:
+  void Reserve(size_t n) {
+    if (size_ + n > buf_.size()) {
+      buf_.resize(std::max<size_t>((size_ + n) * 2, 4096));
+    }
+  }
+};
+
+}  // namespace embedx
@@ -0,0 +1,112 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/io/text_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>  // std::memcpy
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "src/common/random.h"
+
+namespace embedx {
+namespace {
+
+std::string Format(float value) {
+  char buf[MAX_FLOAT_CHARS];
+  return std::string(buf, (size_t)FormatFloat(value, buf));
+}
+
+std::string Printf(float value) {
+  char buf[32];
+  return std::string(buf, (size_t)std::snprintf(buf, sizeof(buf), "%g",
+                                                (double)value));
+}
+
+}  // namespace
+
+TEST(TextBufferTest, FormatFloat) {
+  std::vector<float> values = {0.0f,
+                               -0.0f,
+                               1.0f,
+                               -1.0f,
+                               0.5f,
+                               1.5f,
+                               2.5f,
+                               0.1f,
+                               123456.0f,
+                               1234565.0f,
+                               999999.5f,
+                               9999995.0f,
+                               0.0001f,
+                               0.00001f,
+                               0.000123456789f,
+                               3.14159265f,
+                               1e30f,
+                               -1e-30f,
+                               std::numeric_limits<float>::max(),
+                               std::numeric_limits<float>::min(),
+                               std::numeric_limits<float>::denorm_min(),
+                               std::numeric_limits<float>::infinity(),
+                               -std::numeric_limits<float>::infinity()};
+  for (auto value : values) {
+    EXPECT_EQ(Format(value), Printf(value));
+  }
+
+  // all exponents of random bit patterns
+  RandomEngine engine(9527, 0);
+  for (int i = 0; i < 1000000; ++i) {
+    uint32_t bits = (uint32_t)engine();
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (value == value) {
+      ASSERT_EQ(Format(value), Printf(value)) << bits;
+    }
+  }
+
+  // integers and halves where ties happen
+  for (int i = 0; i < 2000000; ++i) {
+    float value = (float)i * 0.5f + 999000.0f;
+    ASSERT_EQ(Format(value), Printf(value));
+  }
+}
+
+TEST(TextBufferTest, FormatUint64) {
+  char buf[MAX_UINT64_CHARS];
+  for (uint64_t value : {(uint64_t)0, (uint64_t)7, (uint64_t)10,
+                         (uint64_t)99, (uint64_t)100, (uint64_t)123456789,
+                         std::numeric_limits<uint64_t>::max()}) {
+    EXPECT_EQ(std::string(buf, (size_t)FormatUint64(value, buf)),
+              std::to_string(value));
+  }
+}
+
+TEST(TextBufferTest, Append) {
+  TextBuffer text;
+  for (int i = 0; i < 10000; ++i) {
+    text.Append((uint64_t)i);
+    text.Append(' ');
+    text.Append(0.25f);
+    text.Append("\n", 1);
+  }
+
+  std::string s;
+  text.Swap(&s);
+  EXPECT_TRUE(text.empty());
+  EXPECT_EQ(s.substr(0, 14), "0 0.25\n1 0.25\n");
+  EXPECT_EQ(s.size(), (size_t)(10 * 7 + 90 * 8 + 900 * 9 + 9000 * 10));
+}
+
+}  // namespace embedx
@@ -41,6 +41,35 @@ struct EdgeValue {
   }
 };
 
+struct EdgeFeatureValue {
+  int_t src_node;
+  int_t dst_node;
+  vec_pair_t feats;
+
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << src_node << " " << dst_node;
+    for (auto& feat : feats) {
+      ss << " " << feat.first << ":" << feat.second;
+    }
+    return ss.str();
+  }
+};
+
+struct EmbeddingValue {
+  int_t node;
+  vec_float_t embedding;
+
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << node;
+    for (auto value : embedding) {
+      ss << " " << value;
+    }
+    return ss.str();
+  }
+};
+
 struct SeqValue {
   vec_int_t nodes;
 
@@ -56,12 +85,16 @@ struct SeqValue {
 struct AdjValue {
   int_t node;
   vec_pair_t pairs;
+  vec_time_t timestamps;  // optional, one per pair
 
   std::string ToString() const {
     std::stringstream ss;
     ss << node;
-    for (auto& pair : pairs) {
-      ss << " " << pair.first << ":" << pair.second;
+    for (size_t i = 0; i < pairs.size(); ++i) {
+      ss << " " << pairs[i].first << ":" << pairs[i].second;
+      if (!timestamps.empty()) {
+        ss << ":" << timestamps[i];
+      }
     }
     return ss.str();
   }
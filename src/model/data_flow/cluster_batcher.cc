@@ -0,0 +1,92 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/model/data_flow/cluster_batcher.h"
+
+#include <algorithm>  // std::max, std::shuffle
+#include <utility>    // std::move
+
+#include "src/common/random.h"
+#include "src/io/graph_cluster.h"
+
+namespace embedx {
+
+bool ClusterBatcher::Init(const std::string& cluster_file) {
+  index_map_t clusters;
+  if (!LoadClusters(cluster_file, &clusters)) {
+    return false;
+  }
+  Init(clusters);
+  return true;
+}
+
+void ClusterBatcher::Init(const index_map_t& clusters) {
+  clusters_ = clusters;
+  int cluster_num = 0;
+  for (const auto& entry : clusters_) {
+    cluster_num = std::max(cluster_num, entry.second + 1);
+  }
+
+  cluster_nodes_.assign(cluster_num, vec_int_t());
+  for (const auto& entry : clusters_) {
+    cluster_nodes_[entry.second].emplace_back(entry.first);
+  }
+}
+
+void ClusterBatcher::Reset(const vec_int_t& seed_nodes) {
+  std::vector<vec_int_t> seeds_list(cluster_nodes_.size());
+  seed_groups_.clear();
+  group_clusters_.clear();
+  for (auto node : seed_nodes) {
+    auto it = clusters_.find(node);
+    if (it == clusters_.end()) {
+      seed_groups_.emplace_back(vec_int_t{node});
+      group_clusters_.emplace_back(-1);
+    } else {
+      seeds_list[it->second].emplace_back(node);
+    }
+  }
+  for (size_t i = 0; i < seeds_list.size(); ++i) {
+    if (!seeds_list[i].empty()) {
+      seed_groups_.emplace_back(std::move(seeds_list[i]));
+      group_clusters_.emplace_back((int)i);
+    }
+  }
+
+  // the same permutation of seeds and clusters
+  auto& engine = ThreadLocalRandomEngine();
+  RandomEngine cluster_engine = engine;
+  std::shuffle(seed_groups_.begin(), seed_groups_.end(), engine);
+  std::shuffle(group_clusters_.begin(), group_clusters_.end(), cluster_engine);
+  next_ = 0;
+}
+
+bool ClusterBatcher::Next(vec_int_t* nodes, vec_int_t* seed_nodes) {
+  if (next_ >= seed_groups_.size()) {
+    return false;
+  }
+
+  nodes->clear();
+  seed_nodes->clear();
+  for (int i = 0; i < cluster_per_batch_ && next_ < seed_groups_.size();
+       ++i, ++next_) {
+    const auto& seed_group = seed_groups_[next_];
+    int cluster = group_clusters_[next_];
+    const auto& node_group =
+        cluster < 0 ? seed_group : cluster_nodes_[cluster];
+    nodes->insert(nodes->end(), node_group.begin(), node_group.end());
+    seed_nodes->insert(seed_nodes->end(), seed_group.begin(),
+                       seed_group.end());
+  }
+  return true;
+}
+
+}  // namespace embedx
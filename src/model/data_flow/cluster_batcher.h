@@ -0,0 +1,59 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <deepx_core/graph/tensor_map.h>  // DataType
+
+#include <string>
+#include <vector>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+// ClusterBatcher forms the partition local batches of Cluster-GCN, a batch is
+// the union of the nodes of a few random clusters, see ClusterGraph. Graph
+// convolutions of a batch only use the edges inside it, see
+// NeighborAggregationFlow::SampleInducedSubGraph, so no neighbor is sampled.
+//
+// Only clusters with seeds, e.g. labeled nodes, are drawn. A seed out of the
+// clusters makes a cluster of its own.
+class ClusterBatcher : public deepx_core::DataType {
+ private:
+  int cluster_per_batch_ = 1;
+  index_map_t clusters_;
+  // nodes of each cluster
+  std::vector<vec_int_t> cluster_nodes_;
+
+  // seeds of the clusters to draw and the clusters, -1 for a seed out of
+  // the clusters, in random order
+  std::vector<vec_int_t> seed_groups_;
+  std::vector<int> group_clusters_;
+  size_t next_ = 0;
+
+ public:
+  void set_cluster_per_batch(int cluster_per_batch) noexcept {
+    cluster_per_batch_ = cluster_per_batch;
+  }
+
+  // Loads a cluster file of ClusterGraph.
+  bool Init(const std::string& cluster_file);
+  void Init(const index_map_t& clusters);
+
+  // Groups 'seed_nodes' by clusters and shuffles the clusters.
+  void Reset(const vec_int_t& seed_nodes);
+
+  // The next batch of 'cluster_per_batch' clusters, 'nodes' are all their
+  // nodes and 'seed_nodes' their seeds. Returns false if no cluster is left.
+  bool Next(vec_int_t* nodes, vec_int_t* seed_nodes);
+};
+
+}  // namespace embedx
@@ -0,0 +1,72 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/model/data_flow/cluster_batcher.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::sort
+#include <vector>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+TEST(ClusterBatcherTest, Next) {
+  // clusters {0, 1, 2}, {3, 4}, {5}, {6, 7}
+  index_map_t clusters{{0, 0}, {1, 0}, {2, 0}, {3, 1},
+                       {4, 1}, {5, 2}, {6, 3}, {7, 3}};
+  ClusterBatcher batcher;
+  batcher.Init(clusters);
+  batcher.set_cluster_per_batch(2);
+
+  // cluster 2 has no seed, 100 is out of the clusters
+  vec_int_t seeds{0, 2, 3, 7, 100};
+  for (int epoch = 0; epoch < 10; ++epoch) {
+    batcher.Reset(seeds);
+    vec_int_t nodes, seed_nodes;
+    vec_int_t all_nodes, all_seeds;
+    int batch_num = 0;
+    while (batcher.Next(&nodes, &seed_nodes)) {
+      batch_num += 1;
+      flat_set_t node_set;
+      node_set.insert(nodes.begin(), nodes.end());
+      EXPECT_EQ(node_set.size(), nodes.size());
+      for (auto seed : seed_nodes) {
+        EXPECT_EQ(node_set.count(seed), 1u);
+      }
+
+      // whole clusters
+      for (auto node : nodes) {
+        auto it = clusters.find(node);
+        if (it == clusters.end()) {
+          continue;
+        }
+        for (const auto& entry : clusters) {
+          if (entry.second == it->second) {
+            EXPECT_EQ(node_set.count(entry.first), 1u);
+          }
+        }
+      }
+      all_nodes.insert(all_nodes.end(), nodes.begin(), nodes.end());
+      all_seeds.insert(all_seeds.end(), seed_nodes.begin(), seed_nodes.end());
+    }
+
+    // 4 groups of seeds in 2 batches, each seed once
+    EXPECT_EQ(batch_num, 2);
+    std::sort(all_seeds.begin(), all_seeds.end());
+    EXPECT_EQ(all_seeds, seeds);
+    std::sort(all_nodes.begin(), all_nodes.end());
+    EXPECT_EQ(all_nodes, vec_int_t({0, 1, 2, 3, 4, 6, 7, 100}));
+  }
+}
+
+}  // namespace embedx
@@ -64,6 +64,40 @@ class DeepFlow : public deepx_core::DataType {
                         const std::vector<vec_int_t>& neg_items_list,
                         PosIndexingFunc&& pos_indexing_func,
                         NegIndexingFunc&& neg_indexing_func) const {
+    // negatives of a namespace are shared
+    auto neg_items_func = [&pos_items, &neg_items_list](size_t i) {
+      return &neg_items_list[io_util::GetNodeType(pos_items[i])];
+    };
+    FillEdgeAndLabelImpl(inst, user_name, item_name, y_name, pos_items,
+                         neg_items_func, pos_indexing_func, neg_indexing_func);
+  }
+
+  // 'neg_items_list[i]' are the negatives of 'pos_items[i]', see
+  // InBatchNegative.
+  template <class PosIndexingFunc, class NegIndexingFunc>
+  void FillInBatchEdgeAndLabel(Instance* inst, const std::string& user_name,
+                               const std::string& item_name,
+                               const std::string& y_name,
+                               const vec_int_t& pos_items,
+                               const std::vector<vec_int_t>& neg_items_list,
+                               PosIndexingFunc&& pos_indexing_func,
+                               NegIndexingFunc&& neg_indexing_func) const {
+    auto neg_items_func = [&neg_items_list](size_t i) {
+      return &neg_items_list[i];
+    };
+    FillEdgeAndLabelImpl(inst, user_name, item_name, y_name, pos_items,
+                         neg_items_func, pos_indexing_func, neg_indexing_func);
+  }
+
+ private:
+  template <class NegItemsFunc, class PosIndexingFunc, class NegIndexingFunc>
+  void FillEdgeAndLabelImpl(Instance* inst, const std::string& user_name,
+                            const std::string& item_name,
+                            const std::string& y_name,
+                            const vec_int_t& pos_items,
+                            NegItemsFunc&& neg_items_func,
+                            PosIndexingFunc&& pos_indexing_func,
+                            NegIndexingFunc&& neg_indexing_func) const {
     auto* user_ptr = &inst->get_or_insert<csr_t>(user_name);
     auto* item_ptr = &inst->get_or_insert<csr_t>(item_name);
     auto* y_ptr = &inst->get_or_insert<tsr_t>(y_name);
@@ -85,8 +119,7 @@ class DeepFlow : public deepx_core::DataType {
       y_ptr->data(k++) = 0;
 
       // (user, neg_item)
-      auto ns = io_util::GetNodeType(pos_items[i]);
-      for (auto neg_item : neg_items_list[ns]) {
+      for (auto neg_item : *neg_items_func(i)) {
         auto neg = neg_indexing_func(neg_item);
         user_ptr->emplace(i, 1);
         user_ptr->add_row();
@@ -0,0 +1,92 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/model/data_flow/in_batch_negative.h"
+
+#include "src/common/random.h"
+#include "src/io/io_util.h"
+
+namespace embedx {
+
+constexpr size_t InBatchNegative::MAX_PROB_MAP_SIZE;
+constexpr float_t InBatchNegative::MIN_PROB;
+
+bool InBatchNegative::Sample(int count, const vec_int_t& pos_nodes,
+                             std::vector<vec_int_t>* neg_nodes_list) {
+  for (auto& entry : pools_) {
+    entry.second.clear();
+  }
+  for (auto node : pos_nodes) {
+    pools_[io_util::GetNodeType(node)].emplace_back(node);
+  }
+  for (auto node : bank_) {
+    auto it = pools_.find(io_util::GetNodeType(node));
+    if (it != pools_.end()) {
+      it->second.emplace_back(node);
+    }
+  }
+
+  // With two distinct candidates every positive has a negative.
+  for (const auto& entry : pools_) {
+    const auto& pool = entry.second;
+    bool distinct = false;
+    for (size_t i = 1; i < pool.size() && !distinct; ++i) {
+      distinct = pool[i] != pool[0];
+    }
+    if (!pool.empty() && !distinct) {
+      return false;
+    }
+  }
+
+  auto& engine = ThreadLocalRandomEngine();
+  neg_nodes_list->resize(pos_nodes.size());
+  for (size_t i = 0; i < pos_nodes.size(); ++i) {
+    const auto& pool = pools_[io_util::GetNodeType(pos_nodes[i])];
+    auto& neg_nodes = (*neg_nodes_list)[i];
+    neg_nodes.clear();
+    while ((int)neg_nodes.size() < count) {
+      int_t node = pool[engine.NextInt((uint32_t)pool.size())];
+      if (node != pos_nodes[i]) {
+        neg_nodes.emplace_back(node);
+      }
+    }
+  }
+
+  Push(pos_nodes);
+  return true;
+}
+
+void InBatchNegative::RepeatShared(
+    const vec_int_t& pos_nodes, const std::vector<vec_int_t>& shared_nodes_list,
+    std::vector<vec_int_t>* neg_nodes_list) {
+  neg_nodes_list->resize(pos_nodes.size());
+  for (size_t i = 0; i < pos_nodes.size(); ++i) {
+    (*neg_nodes_list)[i] =
+        shared_nodes_list[io_util::GetNodeType(pos_nodes[i])];
+  }
+}
+
+void InBatchNegative::Push(const vec_int_t& pos_nodes) {
+  if (bank_size_ <= 0) {
+    return;
+  }
+
+  for (auto node : pos_nodes) {
+    if ((int)bank_.size() < bank_size_) {
+      bank_.emplace_back(node);
+    } else {
+      bank_[bank_pos_] = node;
+      bank_pos_ = (bank_pos_ + 1) % bank_.size();
+    }
+  }
+}
+
+}  // namespace embedx
@@ -0,0 +1,148 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <deepx_core/graph/tensor_map.h>  // Instance
+
+#include <cmath>  // std::log
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+using ::deepx_core::Instance;
+
+// InBatchNegative draws the negatives of a batch from its own positives and
+// from the positives of recent batches kept in a memory bank, so no negative
+// sampler is called.
+//
+// Positives are drawn in proportion to their frequencies, popular ones are
+// drawn more often than negative samplers would. Models correct their logits
+// by the log probabilities of the candidates (logQ correction), see
+// FillLogQ and the LogQ targets.
+class InBatchNegative : public deepx_core::DataType {
+ private:
+  static constexpr size_t MAX_PROB_MAP_SIZE = 1 << 22;
+  static constexpr float_t MIN_PROB = 1e-10;
+
+  int bank_size_ = 0;
+  // positives of recent batches, a ring buffer
+  vec_int_t bank_;
+  size_t bank_pos_ = 0;
+
+  // candidates of each namespace, the positives of the batch and the bank
+  std::unordered_map<uint16_t, vec_int_t> pools_;
+  // probabilities looked up so far, they don't change during training
+  weight_map_t prob_map_;
+
+ public:
+  void set_bank_size(int bank_size) noexcept { bank_size_ = bank_size; }
+
+  // Draws 'count' negatives for each of 'pos_nodes' among the candidates of
+  // its namespace other than itself, 'neg_nodes_list[i]' are the negatives of
+  // 'pos_nodes[i]'. 'pos_nodes' are put into the bank afterwards.
+  //
+  // Returns false if a namespace has no candidate other than its positive,
+  // e.g. a last batch of one positive.
+  bool Sample(int count, const vec_int_t& pos_nodes,
+              std::vector<vec_int_t>* neg_nodes_list);
+
+  // 'neg_nodes_list' of negative samplers are shared by the positives of a
+  // namespace, repeats them for each of 'pos_nodes' as Sample does.
+  static void RepeatShared(const vec_int_t& pos_nodes,
+                           const std::vector<vec_int_t>& shared_nodes_list,
+                           std::vector<vec_int_t>* neg_nodes_list);
+
+  // Fills 'name' with the log probabilities of the candidates of each
+  // positive, in the order of FillEdgeAndLabel: [pos, neg, ..., neg].
+  //
+  // 'lookup_func(nodes, probs)' looks up the probabilities of 'nodes', e.g.
+  // LookupNodeFreq of graph clients. Only nodes not looked up before are
+  // passed to it.
+  template <class LookupFunc>
+  bool FillLogQ(Instance* inst, const std::string& name,
+                const vec_int_t& pos_nodes,
+                const std::vector<vec_int_t>& neg_nodes_list,
+                LookupFunc&& lookup_func) {
+    if (!LookupProbs(pos_nodes, neg_nodes_list, lookup_func)) {
+      return false;
+    }
+
+    size_t size = pos_nodes.size();
+    for (const auto& neg_nodes : neg_nodes_list) {
+      size += neg_nodes.size();
+    }
+
+    auto* logq_ptr = &inst->get_or_insert<tsr_t>(name);
+    logq_ptr->resize((int)size, 1);
+    int k = 0;
+    for (size_t i = 0; i < pos_nodes.size(); ++i) {
+      logq_ptr->data(k++) = LogProb(pos_nodes[i]);
+      for (auto neg_node : neg_nodes_list[i]) {
+        logq_ptr->data(k++) = LogProb(neg_node);
+      }
+    }
+    return true;
+  }
+
+ private:
+  void Push(const vec_int_t& pos_nodes);
+
+  template <class LookupFunc>
+  bool LookupProbs(const vec_int_t& pos_nodes,
+                   const std::vector<vec_int_t>& neg_nodes_list,
+                   LookupFunc&& lookup_func) {
+    if (prob_map_.size() > MAX_PROB_MAP_SIZE) {
+      prob_map_.clear();
+    }
+
+    vec_int_t nodes;
+    for (auto node : pos_nodes) {
+      if (prob_map_.emplace(node, 0).second) {
+        nodes.emplace_back(node);
+      }
+    }
+    for (const auto& neg_nodes : neg_nodes_list) {
+      for (auto node : neg_nodes) {
+        if (prob_map_.emplace(node, 0).second) {
+          nodes.emplace_back(node);
+        }
+      }
+    }
+    if (nodes.empty()) {
+      return true;
+    }
+
+    vec_float_t probs;
+    if (!lookup_func(nodes, &probs) || probs.size() != nodes.size()) {
+      for (auto node : nodes) {
+        prob_map_.erase(node);
+      }
+      return false;
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      prob_map_[nodes[i]] = probs[i];
+    }
+    return true;
+  }
+
+  float_t LogProb(int_t node) const {
+    auto it = prob_map_.find(node);
+    float_t prob = it == prob_map_.end() ? 0 : it->second;
+    // nodes out of the frequencies, e.g. of new data
+    return std::log(prob < MIN_PROB ? MIN_PROB : prob);
+  }
+};
+
+}  // namespace embedx
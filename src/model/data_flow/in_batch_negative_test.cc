@@ -0,0 +1,107 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/model/data_flow/in_batch_negative.h"
+
+#include <deepx_core/graph/tensor_map.h>  // Instance
+#include <gtest/gtest.h>
+
+#include <cmath>  // std::log
+#include <vector>
+
+#include "src/io/io_util.h"
+
+namespace embedx {
+
+TEST(InBatchNegativeTest, Sample) {
+  // two namespaces
+  const int_t NS1 = (int_t)1 << 48;
+  vec_int_t pos_nodes = {1, 2, 3, NS1 + 1, NS1 + 2, 1};
+  std::vector<vec_int_t> neg_nodes_list;
+  InBatchNegative in_batch_negative;
+  ASSERT_TRUE(in_batch_negative.Sample(4, pos_nodes, &neg_nodes_list));
+
+  ASSERT_EQ(neg_nodes_list.size(), pos_nodes.size());
+  for (size_t i = 0; i < pos_nodes.size(); ++i) {
+    ASSERT_EQ(neg_nodes_list[i].size(), 4u);
+    for (auto neg_node : neg_nodes_list[i]) {
+      EXPECT_NE(neg_node, pos_nodes[i]);
+      EXPECT_EQ(io_util::GetNodeType(neg_node),
+                io_util::GetNodeType(pos_nodes[i]));
+    }
+  }
+
+  // a namespace without other candidates
+  EXPECT_FALSE(in_batch_negative.Sample(4, {1, 1, NS1 + 1}, &neg_nodes_list));
+}
+
+TEST(InBatchNegativeTest, Bank) {
+  std::vector<vec_int_t> neg_nodes_list;
+  InBatchNegative in_batch_negative;
+  in_batch_negative.set_bank_size(2);
+  ASSERT_TRUE(in_batch_negative.Sample(2, {1, 2, 3}, &neg_nodes_list));
+
+  // the bank keeps 2 and 3 of the last batch
+  ASSERT_TRUE(in_batch_negative.Sample(8, {1}, &neg_nodes_list));
+  ASSERT_EQ(neg_nodes_list.size(), 1u);
+  for (auto neg_node : neg_nodes_list[0]) {
+    EXPECT_TRUE(neg_node == 2 || neg_node == 3);
+  }
+}
+
+TEST(InBatchNegativeTest, RepeatShared) {
+  const int_t NS1 = (int_t)1 << 48;
+  std::vector<vec_int_t> shared_nodes_list = {{4, 5}, {NS1 + 4}};
+  std::vector<vec_int_t> neg_nodes_list;
+  InBatchNegative::RepeatShared({1, NS1 + 1, 2}, shared_nodes_list,
+                                &neg_nodes_list);
+  ASSERT_EQ(neg_nodes_list.size(), 3u);
+  EXPECT_EQ(neg_nodes_list[0], shared_nodes_list[0]);
+  EXPECT_EQ(neg_nodes_list[1], shared_nodes_list[1]);
+  EXPECT_EQ(neg_nodes_list[2], shared_nodes_list[0]);
+}
+
+TEST(InBatchNegativeTest, FillLogQ) {
+  int lookup_num = 0;
+  auto lookup_func = [&lookup_num](const vec_int_t& nodes,
+                                   vec_float_t* probs) {
+    lookup_num += (int)nodes.size();
+    probs->clear();
+    for (auto node : nodes) {
+      // node 3 is out of the frequencies
+      probs->emplace_back(node == 3 ? 0 : (float_t)node / 10);
+    }
+    return true;
+  };
+
+  Instance inst;
+  InBatchNegative in_batch_negative;
+  std::vector<vec_int_t> neg_nodes_list = {{2, 3}, {1, 1}};
+  ASSERT_TRUE(in_batch_negative.FillLogQ(&inst, "logq", {1, 2},
+                                         neg_nodes_list, lookup_func));
+  EXPECT_EQ(lookup_num, 3);
+
+  auto& logq = inst.get_or_insert<tsr_t>("logq");
+  ASSERT_EQ(logq.total_dim(), 6u);
+  EXPECT_NEAR(logq.data(0), std::log(0.1), 1e-6);
+  EXPECT_NEAR(logq.data(1), std::log(0.2), 1e-6);
+  EXPECT_NEAR(logq.data(2), std::log(1e-10), 1e-3);
+  EXPECT_NEAR(logq.data(3), std::log(0.2), 1e-6);
+  EXPECT_NEAR(logq.data(4), std::log(0.1), 1e-6);
+  EXPECT_NEAR(logq.data(5), std::log(0.1), 1e-6);
+
+  // looked up before
+  ASSERT_TRUE(in_batch_negative.FillLogQ(&inst, "logq", {1, 2},
+                                         neg_nodes_list, lookup_func));
+  EXPECT_EQ(lookup_num, 3);
+}
+
+}  // namespace embedx
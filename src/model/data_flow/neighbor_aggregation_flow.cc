@@ -13,36 +13,69 @@
 
 #include <deepx_core/dx_log.h>
 
-#include <random>  // std::random_device, std::default_random_engine
+#include <algorithm>  // std::shuffle
+#include <utility>    // std::move, std::pair
+#include <vector>
 
 #include "src/common/random.h"
 
 namespace embedx {
 namespace {
 
+// Appends a row of features of each of 'nodes' to 'csr_feats'.
+template <class Func>
+void FillFeature(Func&& LookupFunc, const vec_int_t& nodes,
+                 float_t feat_mask_prob, csr_t* csr_feats) {
+  std::vector<vec_pair_t> tmp_feats_list;
+  auto& engine = ThreadLocalRandomEngine();
+  std::vector<double> randoms;
+  LookupFunc(nodes, &tmp_feats_list);
+
+  for (size_t j = 0; j < nodes.size(); ++j) {
+    const auto& feats = tmp_feats_list[j];
+    if (feat_mask_prob > 0) {
+      randoms.resize(feats.size());
+      engine.NextDoubles((int)feats.size(), randoms.data());
+    }
+    for (size_t k = 0; k < feats.size(); ++k) {
+      // Consistent with tf and pytorch mask operations
+      if (feat_mask_prob <= 0 || randoms[k] <= 1.0 - feat_mask_prob) {
+        csr_feats->emplace(feats[k].first, feats[k].second);
+      }
+    }
+    csr_feats->add_row();
+  }
+}
+
 template <class Func>
 void FillLevelFeature(Func&& LookupFunc, const vec_set_t& level_nodes,
-                      float_t feat_mask_prob, csr_t* csr_feats) {
+                      float_t feat_mask_prob, bool shared_feature,
+                      csr_t* csr_feats) {
   csr_feats->clear();
+  if (shared_feature) {
+    flat_set_t uniq_nodes;
+    for (const auto& level_node : level_nodes) {
+      uniq_nodes.insert(level_node.begin(), level_node.end());
+    }
+    FillFeature(LookupFunc, uniq_nodes.keys(), feat_mask_prob, csr_feats);
+    return;
+  }
 
-  vec_int_t tmp_nodes;
-  std::vector<vec_pair_t> tmp_feats_list;
   for (const auto& level_node : level_nodes) {
-    tmp_nodes.assign(level_node.begin(), level_node.end());
-    LookupFunc(tmp_nodes, &tmp_feats_list);
-
-    for (size_t j = 0; j < tmp_nodes.size(); ++j) {
-      for (const auto& entry : tmp_feats_list[j]) {
-        // Consistent with tf and pytorch mask operations
-        if (ThreadLocalRandom() <= 1.0 - feat_mask_prob) {
-          csr_feats->emplace(entry.first, entry.second);
-        }
-      }
-      csr_feats->add_row();
-    }
+    FillFeature(LookupFunc, level_node.keys(), feat_mask_prob, csr_feats);
   }
 }
 
+// a neighbor of a vec_int_t or a vec_pair_t
+inline int_t NeighNode(int_t node) noexcept { return node; }
+inline int_t NeighNode(const std::pair<int_t, float_t>& pair) noexcept {
+  return pair.first;
+}
+inline float_t NeighWeight(int_t /*node*/) noexcept { return 1; }
+inline float_t NeighWeight(const std::pair<int_t, float_t>& pair) noexcept {
+  return pair.second;
+}
+
 }  // namespace
 
 void NeighborAggregationFlow::SampleSubGraph(
@@ -54,20 +87,77 @@ void NeighborAggregationFlow::SampleSubGraph(
   (*level_nodes)[0].clear();
   (*level_nodes)[0].insert(nodes.begin(), nodes.end());
 
-  vec_int_t tmp_nodes;
   std::vector<vec_int_t> tmp_neighbors_list;
 
   for (size_t i = 0; i < num_neighbors.size(); ++i) {
     (*level_nodes)[i + 1].clear();
     (*level_neighs)[i].clear();
 
-    tmp_nodes.assign((*level_nodes)[i].begin(), (*level_nodes)[i].end());
-    graph_client_.RandomSampleNeighbor(num_neighbors[i], tmp_nodes,
+    const vec_int_t& cur_nodes = (*level_nodes)[i].keys();
+    graph_client_.RandomSampleNeighbor(num_neighbors[i], cur_nodes,
                                        &tmp_neighbors_list);
-    for (size_t j = 0; j < tmp_nodes.size(); ++j) {
+    for (size_t j = 0; j < cur_nodes.size(); ++j) {
       (*level_nodes)[i + 1].insert(tmp_neighbors_list[j].begin(),
                                    tmp_neighbors_list[j].end());
-      (*level_neighs)[i].emplace(tmp_nodes[j], tmp_neighbors_list[j]);
+      (*level_neighs)[i].emplace(cur_nodes[j], tmp_neighbors_list[j]);
+    }
+  }
+}
+
+void NeighborAggregationFlow::SampleLayerwiseSubGraph(
+    const vec_int_t& nodes, const std::vector<int>& layer_sizes,
+    vec_set_t* level_nodes, vec_map_adj_t* level_adjs) const {
+  int graph_depth = layer_sizes.size();
+  level_nodes->resize(graph_depth + 1);
+  level_adjs->resize(graph_depth + 1);
+  (*level_nodes)[0].clear();
+  (*level_nodes)[0].insert(nodes.begin(), nodes.end());
+
+  vec_int_t sampled_nodes;
+  std::vector<vec_pair_t> adjs;
+
+  for (size_t i = 0; i < layer_sizes.size(); ++i) {
+    (*level_nodes)[i + 1].clear();
+    (*level_adjs)[i].clear();
+
+    const vec_int_t& cur_nodes = (*level_nodes)[i].keys();
+    DXCHECK(graph_client_.LayerwiseSampleNeighbor(layer_sizes[i], cur_nodes,
+                                                  &sampled_nodes, &adjs));
+    (*level_nodes)[i + 1].insert(sampled_nodes.begin(), sampled_nodes.end());
+    for (size_t j = 0; j < cur_nodes.size(); ++j) {
+      (*level_adjs)[i].emplace(cur_nodes[j], std::move(adjs[j]));
+    }
+  }
+}
+
+void NeighborAggregationFlow::SampleInducedSubGraph(
+    const vec_int_t& nodes, int depth, vec_set_t* level_nodes,
+    vec_map_neigh_t* level_neighs) const {
+  level_nodes->resize(depth + 1);
+  level_neighs->resize(depth + 1);
+  flat_set_t& node_set = (*level_nodes)[0];
+  node_set.clear();
+  node_set.insert(nodes.begin(), nodes.end());
+
+  // one lookup for all levels
+  std::vector<vec_pair_t> contexts;
+  const vec_int_t& uniq_nodes = node_set.keys();
+  DXCHECK(graph_client_.LookupContext(uniq_nodes, &contexts));
+  auto& neighs = (*level_neighs)[0];
+  neighs.clear();
+  for (size_t j = 0; j < uniq_nodes.size(); ++j) {
+    auto& neigh_nodes = neighs[uniq_nodes[j]];
+    for (const auto& pair : contexts[j]) {
+      if (node_set.count(pair.first) > 0) {
+        neigh_nodes.emplace_back(pair.first);
+      }
+    }
+  }
+
+  for (int i = 1; i <= depth; ++i) {
+    (*level_nodes)[i] = node_set;
+    if (i < depth) {
+      (*level_neighs)[i] = neighs;
     }
   }
 }
@@ -92,9 +182,8 @@ void NeighborAggregationFlow::ShuffleNodesInBatch(
                            level_node.end());
   }
 
-  static thread_local std::random_device rd;
-  static thread_local std::default_random_engine rng(rd());
-  std::shuffle(shuffled_nodes->begin(), shuffled_nodes->end(), rng);
+  std::shuffle(shuffled_nodes->begin(), shuffled_nodes->end(),
+               ThreadLocalRandomEngine());
 }
 
 void NeighborAggregationFlow::ShuffleNodesInGlobal(
@@ -167,7 +256,7 @@ void NeighborAggregationFlow::FillLevelNodeFeature(
                   std::vector<vec_pair_t>* tmp_feats_list) {
     graph_client_.LookupNodeFeature(nodes, tmp_feats_list);
   };
-  FillLevelFeature(f, level_nodes, feat_mask_prob_, feat_ptr);
+  FillLevelFeature(f, level_nodes, feat_mask_prob_, shared_feature_, feat_ptr);
 }
 
 void NeighborAggregationFlow::FillLevelNeighFeature(
@@ -178,14 +267,28 @@ void NeighborAggregationFlow::FillLevelNeighFeature(
                   std::vector<vec_pair_t>* tmp_feats_list) {
     graph_client_.LookupNeighborFeature(nodes, tmp_feats_list);
   };
-  FillLevelFeature(f, level_nodes, feat_mask_prob_, feat_ptr);
+  FillLevelFeature(f, level_nodes, feat_mask_prob_, shared_feature_, feat_ptr);
 }
 
-void NeighborAggregationFlow::FillSelfAndNeighGraphBlock(
+template <class LevelNeighs>
+void NeighborAggregationFlow::FillGraphBlock(
     Instance* inst, const std::string& self_name, const std::string& neigh_name,
-    const vec_set_t& level_nodes, const vec_map_neigh_t& level_neighs,
+    const vec_set_t& level_nodes, const LevelNeighs& level_neighs,
     const std::vector<Indexing>& indexings, bool add_self) const {
   int graph_depth = level_neighs.size() - 1;
+  auto& engine = ThreadLocalRandomEngine();
+  std::vector<double> randoms;
+
+  // blocks 0 gather the rows of the shared feature table
+  Indexing feat_indexing;
+  if (shared_feature_ && graph_depth > 0) {
+    for (const auto& nodes : level_nodes) {
+      for (auto node : nodes) {
+        feat_indexing.Add(node);
+      }
+    }
+  }
+
   for (int i = 0; i < graph_depth; ++i) {
     auto* self_block =
         &inst->get_or_insert<csr_t>(self_name + std::to_string(i));
@@ -195,20 +298,30 @@ void NeighborAggregationFlow::FillSelfAndNeighGraphBlock(
     neigh_block->clear();
 
     for (int j = 0; j < graph_depth - i; ++j) {
+      bool shared = shared_feature_ && i == 0;
+      const Indexing* self_indexing = shared ? &feat_indexing : &indexings[j];
+      const Indexing* neigh_indexing =
+          shared ? &feat_indexing : &indexings[j + 1];
+
       for (auto node : level_nodes[j]) {
         // Fill self node block
-        int self_id = indexings[j].Get(node);
+        int self_id = self_indexing->Get(node);
         DXCHECK(self_id >= 0);
         self_block->emplace(self_id, 1);
         self_block->add_row();
 
         // Fill neighbor node block
-        for (auto neigh_node : level_neighs[j].at(node)) {
+        const auto& neigh_nodes = level_neighs[j].at(node);
+        if (edge_drop_prob_ > 0) {
+          randoms.resize(neigh_nodes.size());
+          engine.NextDoubles((int)neigh_nodes.size(), randoms.data());
+        }
+        for (size_t k = 0; k < neigh_nodes.size(); ++k) {
           // Consistent with tf and pytorch drop operations
-          if (ThreadLocalRandom() <= 1.0 - edge_drop_prob_) {
-            auto neigh_id = indexings[j + 1].Get(neigh_node);
+          if (edge_drop_prob_ <= 0 || randoms[k] <= 1.0 - edge_drop_prob_) {
+            auto neigh_id = neigh_indexing->Get(NeighNode(neigh_nodes[k]));
             DXCHECK(neigh_id >= 0);
-            neigh_block->emplace(neigh_id, 1);
+            neigh_block->emplace(neigh_id, NeighWeight(neigh_nodes[k]));
           }
         }
 
@@ -223,6 +336,22 @@ void NeighborAggregationFlow::FillSelfAndNeighGraphBlock(
   }
 }
 
+void NeighborAggregationFlow::FillSelfAndNeighGraphBlock(
+    Instance* inst, const std::string& self_name, const std::string& neigh_name,
+    const vec_set_t& level_nodes, const vec_map_neigh_t& level_neighs,
+    const std::vector<Indexing>& indexings, bool add_self) const {
+  FillGraphBlock(inst, self_name, neigh_name, level_nodes, level_neighs,
+                 indexings, add_self);
+}
+
+void NeighborAggregationFlow::FillSelfAndNeighGraphBlock(
+    Instance* inst, const std::string& self_name, const std::string& neigh_name,
+    const vec_set_t& level_nodes, const vec_map_adj_t& level_adjs,
+    const std::vector<Indexing>& indexings, bool add_self) const {
+  FillGraphBlock(inst, self_name, neigh_name, level_nodes, level_adjs,
+                 indexings, add_self);
+}
+
 void NeighborAggregationFlow::FillLabelAndCheck(
     Instance* inst, const std::string& y_name,
     const std::vector<vecl_t>& labels_list, int label_num,
@@ -31,6 +31,7 @@ class NeighborAggregationFlow : public deepx_core::DataType {
   const GraphClient& graph_client_;
   float_t edge_drop_prob_ = 0;
   float_t feat_mask_prob_ = 0;
+  bool shared_feature_ = false;
 
  public:
   explicit NeighborAggregationFlow(const GraphClient* graph_client)
@@ -46,10 +47,32 @@ class NeighborAggregationFlow : public deepx_core::DataType {
     feat_mask_prob_ = feat_mask_prob;
   }
 
+  // With shared feature, the feature rows are the unique nodes of all levels
+  // in the order of their first appearance, rather than the nodes of each
+  // level. A hub in several levels is looked up and filled once, the first
+  // blocks index the shared rows and the other blocks are unchanged. Nodes of
+  // level 0 keep their rows either way.
+  //
+  // Features of a node are masked once for all its levels.
+  void set_shared_feature(bool shared_feature) noexcept {
+    shared_feature_ = shared_feature;
+  }
+
   void SampleSubGraph(const vec_int_t& nodes,
                       const std::vector<int>& num_neighbors,
                       vec_set_t* level_nodes,
                       vec_map_neigh_t* level_neighs) const;
+  // Samples the levels by LayerwiseSampleNeighbor, level i + 1 has at most
+  // 'layer_sizes[i]' nodes shared by all the nodes of level i.
+  void SampleLayerwiseSubGraph(const vec_int_t& nodes,
+                               const std::vector<int>& layer_sizes,
+                               vec_set_t* level_nodes,
+                               vec_map_adj_t* level_adjs) const;
+  // The subgraph induced by 'nodes' as 'depth' levels of 'nodes', a node has
+  // all its neighbors among 'nodes', see ClusterBatcher.
+  void SampleInducedSubGraph(const vec_int_t& nodes, int depth,
+                             vec_set_t* level_nodes,
+                             vec_map_neigh_t* level_neighs) const;
   void MergeTo(const vec_int_t& src_nodes, vec_int_t* dst_nodes) const;
   void MergeTo(const std::vector<vec_int_t>& src_nodes_list,
                vec_int_t* dst_nodes) const;
@@ -73,6 +96,13 @@ class NeighborAggregationFlow : public deepx_core::DataType {
                                   const vec_map_neigh_t& level_neighs,
                                   const std::vector<Indexing>& indexings,
                                   bool add_self) const;
+  // The neighbor blocks hold the weights of 'level_adjs'.
+  void FillSelfAndNeighGraphBlock(Instance* inst, const std::string& self_name,
+                                  const std::string& neigh_name,
+                                  const vec_set_t& level_nodes,
+                                  const vec_map_adj_t& level_adjs,
+                                  const std::vector<Indexing>& indexings,
+                                  bool add_self) const;
   void FillLabelAndCheck(Instance* inst, const std::string& y_name,
                          const std::vector<vecl_t>& labels_list, int label_num,
                          int max_label) const;
@@ -85,6 +115,50 @@ class NeighborAggregationFlow : public deepx_core::DataType {
                         const std::vector<vec_int_t>& neg_nodes_list,
                         SrcIndexingFunc&& src_f,
                         DstIndexingFunc&& dst_f) const {
+    // negatives of a namespace are shared
+    auto neg_nodes_func = [&dst_nodes, &neg_nodes_list](size_t i) {
+      return &neg_nodes_list[io_util::GetNodeType(dst_nodes[i])];
+    };
+    FillEdgeAndLabelImpl(inst, src_name, dst_name, y_name, src_nodes,
+                         dst_nodes, neg_nodes_func, src_f, dst_f);
+  }
+
+  // 'neg_nodes_list[i]' are the negatives of 'dst_nodes[i]', see
+  // InBatchNegative.
+  template <class SrcIndexingFunc, class DstIndexingFunc>
+  void FillInBatchEdgeAndLabel(Instance* inst, const std::string& src_name,
+                               const std::string& dst_name,
+                               const std::string& y_name,
+                               const vec_int_t& src_nodes,
+                               const vec_int_t& dst_nodes,
+                               const std::vector<vec_int_t>& neg_nodes_list,
+                               SrcIndexingFunc&& src_f,
+                               DstIndexingFunc&& dst_f) const {
+    auto neg_nodes_func = [&neg_nodes_list](size_t i) {
+      return &neg_nodes_list[i];
+    };
+    FillEdgeAndLabelImpl(inst, src_name, dst_name, y_name, src_nodes,
+                         dst_nodes, neg_nodes_func, src_f, dst_f);
+  }
+
+ private:
+  template <class LevelNeighs>
+  void FillGraphBlock(Instance* inst, const std::string& self_name,
+                      const std::string& neigh_name,
+                      const vec_set_t& level_nodes,
+                      const LevelNeighs& level_neighs,
+                      const std::vector<Indexing>& indexings,
+                      bool add_self) const;
+
+  template <class NegNodesFunc, class SrcIndexingFunc, class DstIndexingFunc>
+  void FillEdgeAndLabelImpl(Instance* inst, const std::string& src_name,
+                            const std::string& dst_name,
+                            const std::string& y_name,
+                            const vec_int_t& src_nodes,
+                            const vec_int_t& dst_nodes,
+                            NegNodesFunc&& neg_nodes_func,
+                            SrcIndexingFunc&& src_f,
+                            DstIndexingFunc&& dst_f) const {
     auto* src_ptr = &inst->get_or_insert<csr_t>(src_name);
     auto* dst_ptr = &inst->get_or_insert<csr_t>(dst_name);
     src_ptr->clear();
@@ -100,8 +174,7 @@ class NeighborAggregationFlow : public deepx_core::DataType {
       dst_ptr->emplace(dst, 1);
       dst_ptr->add_row();
       y_bufs.emplace_back(1);
-      auto ns = io_util::GetNodeType(dst_nodes[i]);
-      for (auto neg_node : neg_nodes_list[ns]) {
+      for (auto neg_node : *neg_nodes_func(i)) {
         // (src, neg, 0)
         auto neg = dst_f(neg_node);
         src_ptr->emplace(src, 1);
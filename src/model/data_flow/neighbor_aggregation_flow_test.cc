@@ -40,6 +40,25 @@ void CreateIndexings(const vec_set_t& level_nodes,
   }
 }
 
+vec_pair_t GetRow(const csr_t& csr, int i) {
+  vec_pair_t row;
+  for (int k = csr.row_offset(i); k < csr.row_offset(i + 1); ++k) {
+    row.emplace_back(csr.col(k), csr.value(k));
+  }
+  return row;
+}
+
+// Rows of 'feats' gathered by the entries of 'block'.
+std::vector<vec_pair_t> Gather(const csr_t& feats, const csr_t& block) {
+  std::vector<vec_pair_t> rows;
+  for (int i = 0; i < block.row(); ++i) {
+    for (int k = block.row_offset(i); k < block.row_offset(i + 1); ++k) {
+      rows.emplace_back(GetRow(feats, (int)block.col(k)));
+    }
+  }
+  return rows;
+}
+
 }  // namespace
 
 class NeighborAggregationFlowTest : public ::testing::Test {
@@ -215,4 +234,128 @@ TEST_F(NeighborAggregationFlowTest, FillSelfAndNeighGraphBlock) {
   }
 }
 
+TEST_F(NeighborAggregationFlowTest, SharedFeature) {
+  vec_set_t level_nodes;
+  vec_map_neigh_t level_neighs;
+  flow_->SampleSubGraph({0, 1, 2, 3}, {3, 3}, &level_nodes, &level_neighs);
+  std::vector<Indexing> indexings;
+  inst_util::CreateIndexings(level_nodes, &indexings);
+
+  deepx_core::Instance inst;
+  flow_->FillLevelNodeFeature(&inst, "level_feature", level_nodes);
+  flow_->FillSelfAndNeighGraphBlock(&inst, "level_self", "level_neigh",
+                                    level_nodes, level_neighs, indexings,
+                                    true);
+  flow_->set_shared_feature(true);
+  flow_->FillLevelNodeFeature(&inst, "shared_feature", level_nodes);
+  flow_->FillSelfAndNeighGraphBlock(&inst, "shared_self", "shared_neigh",
+                                    level_nodes, level_neighs, indexings,
+                                    true);
+
+  // a row for each unique node
+  flat_set_t uniq_nodes;
+  int level_node_num = 0;
+  for (const auto& nodes : level_nodes) {
+    uniq_nodes.insert(nodes.begin(), nodes.end());
+    level_node_num += (int)nodes.size();
+  }
+  const auto& level_feats = inst.get_or_insert<csr_t>("level_feature");
+  const auto& shared_feats = inst.get_or_insert<csr_t>("shared_feature");
+  EXPECT_EQ(level_feats.row(), level_node_num);
+  EXPECT_EQ(shared_feats.row(), (int)uniq_nodes.size());
+  EXPECT_LT(shared_feats.row(), level_feats.row());
+
+  // blocks 0 gather the same features, the other blocks are unchanged
+  for (std::string block : {"_self", "_neigh"}) {
+    const auto& level_block0 = inst.get_or_insert<csr_t>("level" + block + "0");
+    const auto& shared_block0 =
+        inst.get_or_insert<csr_t>("shared" + block + "0");
+    EXPECT_EQ(Gather(level_feats, level_block0),
+              Gather(shared_feats, shared_block0));
+
+    const auto& level_block1 = inst.get_or_insert<csr_t>("level" + block + "1");
+    const auto& shared_block1 =
+        inst.get_or_insert<csr_t>("shared" + block + "1");
+    ASSERT_EQ(level_block1.row(), shared_block1.row());
+    for (int i = 0; i < level_block1.row(); ++i) {
+      EXPECT_EQ(GetRow(level_block1, i), GetRow(shared_block1, i));
+    }
+  }
+}
+
+TEST_F(NeighborAggregationFlowTest, LayerwiseSubGraph) {
+  std::vector<int> layer_sizes = {4, 2};
+  vec_set_t level_nodes;
+  vec_map_adj_t level_adjs;
+  flow_->SampleLayerwiseSubGraph({0, 1, 2, 3}, layer_sizes, &level_nodes,
+                                 &level_adjs);
+  ASSERT_EQ(level_nodes.size(), 3u);
+  for (size_t i = 0; i < layer_sizes.size(); ++i) {
+    EXPECT_LE((int)level_nodes[i + 1].size(), layer_sizes[i]);
+    EXPECT_EQ(level_adjs[i].size(), level_nodes[i].size());
+    for (const auto& entry : level_adjs[i]) {
+      for (const auto& pair : entry.second) {
+        EXPECT_EQ(level_nodes[i + 1].count(pair.first), 1u);
+      }
+    }
+  }
+
+  std::vector<Indexing> indexings;
+  inst_util::CreateIndexings(level_nodes, &indexings);
+  deepx_core::Instance inst;
+  flow_->FillSelfAndNeighGraphBlock(&inst, "self_block", "neigh_block",
+                                    level_nodes, level_adjs, indexings, false);
+
+  // the neighbor blocks hold the weights of the sampled neighbors
+  const auto& neigh_block0 = inst.get_or_insert<csr_t>("neigh_block0");
+  int row = 0;
+  for (int j = 0; j < 2; ++j) {
+    for (auto node : level_nodes[j]) {
+      vec_pair_t expected;
+      for (const auto& pair : level_adjs[j].at(node)) {
+        expected.emplace_back(indexings[j + 1].Get(pair.first), pair.second);
+      }
+      EXPECT_EQ(GetRow(neigh_block0, row), expected);
+      row += 1;
+    }
+  }
+  EXPECT_EQ(neigh_block0.row(), row);
+}
+
+TEST_F(NeighborAggregationFlowTest, SampleInducedSubGraph) {
+  vec_int_t nodes = {0, 1, 2, 10, 11, 12, 20};
+  vec_set_t level_nodes;
+  vec_map_neigh_t level_neighs;
+  flow_->SampleInducedSubGraph(nodes, 2, &level_nodes, &level_neighs);
+  ASSERT_EQ(level_nodes.size(), 3u);
+
+  std::vector<vec_pair_t> contexts;
+  ASSERT_TRUE(client_->LookupContext(nodes, &contexts));
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(level_nodes[i].keys(), nodes);
+    ASSERT_EQ(level_neighs[i].size(), nodes.size());
+
+    // all the edges inside 'nodes', and only them
+    for (size_t j = 0; j < nodes.size(); ++j) {
+      vec_int_t expected;
+      for (const auto& pair : contexts[j]) {
+        if (level_nodes[i].count(pair.first) > 0) {
+          expected.emplace_back(pair.first);
+        }
+      }
+      EXPECT_EQ(level_neighs[i].at(nodes[j]), expected);
+    }
+  }
+  EXPECT_EQ(level_nodes[2].keys(), nodes);
+
+  std::vector<Indexing> indexings;
+  inst_util::CreateIndexings(level_nodes, &indexings);
+  deepx_core::Instance inst;
+  flow_->FillSelfAndNeighGraphBlock(&inst, "self_block", "neigh_block",
+                                    level_nodes, level_neighs, indexings,
+                                    false);
+  EXPECT_EQ(inst.get_or_insert<csr_t>("neigh_block0").row(),
+            2 * (int)nodes.size());
+}
+
 }  // namespace embedx
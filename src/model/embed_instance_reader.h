@@ -21,6 +21,7 @@
 #include "src/common/data_types.h"
 #include "src/deep/client/deep_client.h"
 #include "src/graph/client/graph_client.h"
+#include "src/io/file_chunk.h"
 #include "src/io/line_parser.h"
 
 namespace embedx {
@@ -44,6 +45,11 @@ class EmbedInstanceReader : public InstanceReaderImpl {
     return line_parser_.Open(file);
   }
 
+  // Opens the lines of 'chunk', see LineParser::Open.
+  bool OpenChunk(const FileChunk& chunk, const FileChunkExtender& extender) {
+    return line_parser_.Open(chunk, extender);
+  }
+
  protected:
   template <typename ValueType>
   bool NextInstanceBatch(Instance* inst, int batch,
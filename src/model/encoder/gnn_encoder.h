@@ -160,4 +160,18 @@ std::vector<GraphNode*> MultiLabelClassificationTarget(
 
 std::vector<GraphNode*> MultiLabelClassificationTarget(GraphNode* X, int has_w);
 
+// logQ corrected targets with the log probabilities of the candidates in
+// X_LOGQ_NAME, see InBatchNegative. Probabilities are of the logits before
+// correction.
+//
+// The binary target subtracts log(num_neg * q) from the logits of negatives
+// (Y = 0) only. The multi target is a sampled softmax of the logits minus
+// log q.
+std::vector<GraphNode*> LogQBinaryClassificationTarget(
+    const std::string& prefix, GraphNode* X, GraphNode* Y, int num_neg,
+    int has_w);
+
+std::vector<GraphNode*> LogQMultiClassificationTarget(
+    const std::string& prefix, GraphNode* X, int has_w);
+
 }  // namespace embedx
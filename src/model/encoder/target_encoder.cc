@@ -11,9 +11,20 @@
 
 #include <deepx_core/dx_log.h>
 
+#include <cmath>  // std::log
+
 #include "src/model/encoder/gnn_encoder.h"
+#include "src/model/instance_node_name.h"
 
 namespace embedx {
+namespace {
+
+GraphNode* GetXLogQ() {
+  return new InstanceNode(instance_name::X_LOGQ_NAME, Shape(-1, 1),
+                          TENSOR_TYPE_TSR);
+}
+
+}  // namespace
 
 std::vector<GraphNode*> BinaryClassificationTarget(const std::string& prefix,
                                                    GraphNode* X, GraphNode* Y,
@@ -123,4 +134,53 @@ std::vector<GraphNode*> MultiLabelClassificationTarget(GraphNode* X,
   }
 }
 
+std::vector<GraphNode*> LogQBinaryClassificationTarget(
+    const std::string& prefix, GraphNode* X, GraphNode* Y, int num_neg,
+    int has_w) {
+  DXCHECK_THROW(X->shape().is_rank(2));
+  DXCHECK_THROW(X->shape()[1] == 1);
+  DXCHECK_THROW(Y->shape()[1] == 1);
+  DXCHECK_THROW(num_neg > 0);
+  // sigmoid isn't shift invariant, only the logits of negatives are corrected
+  // by log(num_neg * q), positives are left as they are
+  auto* LK =
+      deepx_core::ConstantScalar(prefix + "LK", std::log((double)num_neg));
+  auto* LKQ = deepx_core::BroadcastAdd(prefix + "LKQ", GetXLogQ(), LK);
+  auto* NY = deepx_core::Sub(prefix + "NY", deepx_core::OnesLike("", Y), Y);
+  auto* NLKQ = deepx_core::Mul(prefix + "NLKQ", NY, LKQ);
+  auto* CX = deepx_core::Sub(prefix + "CX", X, NLKQ);
+  auto* L = deepx_core::SigmoidBCELoss(prefix + "L", CX, Y);
+  auto* P = deepx_core::Sigmoid(prefix + "P", X);
+  if (has_w) {
+    auto* W = deepx_core::GetW(1);
+    auto* WL = deepx_core::Mul(prefix + "WL", L, W);
+    auto* WM = deepx_core::ReduceMean(prefix + "WM", WL);
+    return {WM, P};
+  } else {
+    auto* M = deepx_core::ReduceMean(prefix + "M", L);
+    return {M, P};
+  }
+}
+
+std::vector<GraphNode*> LogQMultiClassificationTarget(
+    const std::string& prefix, GraphNode* X, int has_w) {
+  DXCHECK_THROW(X->shape().is_rank(2));
+  auto* Y = deepx_core::GetY(1);
+  // one log probability per logit
+  auto* LQ = deepx_core::Reshape2(prefix + "LQ", GetXLogQ(),
+                                  Shape(-1, X->shape()[1]));
+  auto* CX = deepx_core::Sub(prefix + "CX", X, LQ);
+  auto* L = deepx_core::BatchSoftmaxCELoss(prefix + "L", CX, Y);
+  auto* P = deepx_core::Softmax(prefix + "P", X);
+  if (has_w) {
+    auto* W = deepx_core::GetW(1);
+    auto* WL = deepx_core::Mul(prefix + "WL", L, W);
+    auto* WM = deepx_core::ReduceMean(prefix + "WM", WL);
+    return {WM, P};
+  } else {
+    auto* M = deepx_core::ReduceMean(prefix + "M", L);
+    return {M, P};
+  }
+}
+
 }  // namespace embedx
@@ -54,6 +54,8 @@ const std::string X_NODE_ID_NAME = "__instXnode_id_";            // NOLINT
 const std::string X_PREDICT_NODE_NAME = "__instXpredict_node_";  // NOLINT
 const std::string X_UNIQUE_NODE_NAME = "__instXunique_node_";    // NOLINT
 const std::string Y_UNSUPVISED_NAME = "__instYunsup_";           // NOLINT
+// log probabilities of the candidates, see InBatchNegative
+const std::string X_LOGQ_NAME = "__instXlogq_";  // NOLINT
 
 // NonGNN
 const std::string X_USER_NODE_NAME = "__instXuser_node_";        // NOLINT
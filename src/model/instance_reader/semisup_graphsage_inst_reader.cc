@@ -13,9 +13,9 @@
 #include <deepx_core/dx_log.h>
 
 #include <algorithm>  // std::shuffle, std::max, std::min
-#include <random>     // std::random_device, std::default_random_engine
 #include <vector>
 
+#include "src/common/random.h"
 #include "src/io/indexing.h"
 #include "src/io/value.h"
 #include "src/model/data_flow/neighbor_aggregation_flow.h"
@@ -28,12 +28,11 @@ namespace {
 
 void DiscardNodeAndLabel(vec_int_t* nodes, std::vector<vecl_t>* labels_list,
                          int num_remain) {
-  static thread_local std::random_device rd;
-  auto seed = (uint64_t)rd();
-  static thread_local std::default_random_engine rng(seed);
-  std::shuffle(nodes->begin(), nodes->end(), rng);
-  rng.seed(seed);
-  std::shuffle(labels_list->begin(), labels_list->end(), rng);
+  // the same permutation of nodes and labels
+  auto& engine = ThreadLocalRandomEngine();
+  RandomEngine label_engine = engine;
+  std::shuffle(nodes->begin(), nodes->end(), engine);
+  std::shuffle(labels_list->begin(), labels_list->end(), label_engine);
   nodes->erase(nodes->begin() + num_remain, nodes->end());
   labels_list->erase(labels_list->begin() + num_remain, labels_list->end());
 }
@@ -47,8 +46,10 @@ class SemisupGraphsageInstReader : public EmbedInstanceReader {
  private:
   bool is_train_ = true;
   bool use_neigh_feat_ = false;
+  bool shared_feature_ = false;
   int num_neg_ = 5;
   std::vector<int> num_neighbors_;
+  std::vector<int> layer_sizes_;
   int min_batch_ = 16;
   int num_label_ = 1;
   int max_label_ = 1;
@@ -67,6 +68,7 @@ class SemisupGraphsageInstReader : public EmbedInstanceReader {
   vec_int_t merged_nodes_;
   vec_set_t level_nodes_;
   vec_map_neigh_t level_neighbors_;
+  vec_map_adj_t level_adjs_;
   std::vector<Indexing> indexings_;
 
  public:
@@ -79,6 +81,7 @@ class SemisupGraphsageInstReader : public EmbedInstanceReader {
     }
 
     flow_ = NewNeighborAggregationFlow(graph_client);
+    flow_->set_shared_feature(shared_feature_);
     return true;
   }
 
@@ -93,11 +96,17 @@ class SemisupGraphsageInstReader : public EmbedInstanceReader {
       auto val = std::stoi(v);
       DXCHECK(val == 1 || val == 0);
       use_neigh_feat_ = val;
+    } else if (k == "shared_feature") {
+      auto val = std::stoi(v);
+      DXCHECK(val == 1 || val == 0);
+      shared_feature_ = val;
     } else if (k == "num_neg") {
       num_neg_ = std::stoi(v);
       DXCHECK(num_neg_ >= 1);
     } else if (k == "num_neighbors") {
       DXCHECK(deepx_core::Split<int>(v, ",", &num_neighbors_));
+    } else if (k == "layer_sizes") {
+      DXCHECK(deepx_core::Split<int>(v, ",", &layer_sizes_));
     } else if (k == "min_batch_") {
       min_batch_ = std::stoi(v);
       DXCHECK(min_batch_ >= 1);
@@ -175,8 +184,7 @@ class SemisupGraphsageInstReader : public EmbedInstanceReader {
     flow_->MergeTo(nodes_, &merged_nodes_);
 
     // Sample subgraph
-    flow_->SampleSubGraph(merged_nodes_, num_neighbors_, &level_nodes_,
-                          &level_neighbors_);
+    SampleSubGraph(merged_nodes_);
 
     // Fill Instance
     // 1. Fill node feature
@@ -191,10 +199,7 @@ class SemisupGraphsageInstReader : public EmbedInstanceReader {
 
     // 3. Fill self And neigbor block
     inst_util::CreateIndexings(level_nodes_, &indexings_);
-    flow_->FillSelfAndNeighGraphBlock(inst, instance_name::X_SELF_BLOCK_NAME,
-                                      instance_name::X_NEIGH_BLOCK_NAME,
-                                      level_nodes_, level_neighbors_,
-                                      indexings_, false);
+    FillGraphBlock(inst);
 
     // 4. Fill index
     flow_->FillNodeOrIndex(inst, instance_name::X_NODE_ID_NAME, nodes_,
@@ -232,8 +237,7 @@ class SemisupGraphsageInstReader : public EmbedInstanceReader {
     nodes_ = Collect<NodeValue, int_t>(values, &NodeValue::node);
 
     // Sample subgraph
-    flow_->SampleSubGraph(nodes_, num_neighbors_, &level_nodes_,
-                          &level_neighbors_);
+    SampleSubGraph(nodes_);
 
     // Fill Instance
     // 1. Fill node feature
@@ -248,10 +252,7 @@ class SemisupGraphsageInstReader : public EmbedInstanceReader {
 
     // 3. Fill self And neigbor block
     inst_util::CreateIndexings(level_nodes_, &indexings_);
-    flow_->FillSelfAndNeighGraphBlock(inst, instance_name::X_SELF_BLOCK_NAME,
-                                      instance_name::X_NEIGH_BLOCK_NAME,
-                                      level_nodes_, level_neighbors_,
-                                      indexings_, false);
+    FillGraphBlock(inst);
 
     // 4. Fill index
     flow_->FillNodeOrIndex(inst, instance_name::X_NODE_ID_NAME, nodes_,
@@ -264,6 +265,32 @@ class SemisupGraphsageInstReader : public EmbedInstanceReader {
     inst->set_batch((int)nodes_.size());
     return true;
   }
+
+ private:
+  // samples the levels layer-wise if 'layer_sizes_' is set
+  void SampleSubGraph(const vec_int_t& nodes) {
+    if (layer_sizes_.empty()) {
+      flow_->SampleSubGraph(nodes, num_neighbors_, &level_nodes_,
+                            &level_neighbors_);
+    } else {
+      flow_->SampleLayerwiseSubGraph(nodes, layer_sizes_, &level_nodes_,
+                                     &level_adjs_);
+    }
+  }
+
+  void FillGraphBlock(Instance* inst) const {
+    if (layer_sizes_.empty()) {
+      flow_->FillSelfAndNeighGraphBlock(
+          inst, instance_name::X_SELF_BLOCK_NAME,
+          instance_name::X_NEIGH_BLOCK_NAME, level_nodes_, level_neighbors_,
+          indexings_, false);
+    } else {
+      flow_->FillSelfAndNeighGraphBlock(
+          inst, instance_name::X_SELF_BLOCK_NAME,
+          instance_name::X_NEIGH_BLOCK_NAME, level_nodes_, level_adjs_,
+          indexings_, false);
+    }
+  }
 };
 
 INSTANCE_READER_REGISTER(SemisupGraphsageInstReader,
@@ -13,10 +13,13 @@
 #include <deepx_core/common/str_util.h>
 #include <deepx_core/dx_log.h>
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "src/io/indexing.h"
 #include "src/io/value.h"
+#include "src/model/data_flow/cluster_batcher.h"
 #include "src/model/data_flow/neighbor_aggregation_flow.h"
 #include "src/model/embed_instance_reader.h"
 #include "src/model/instance_node_name.h"
@@ -31,10 +34,14 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
  private:
   bool is_train_ = true;
   std::vector<int> num_neighbors_;
+  std::vector<int> layer_sizes_;
   bool use_neigh_feat_ = false;
+  bool shared_feature_ = false;
   int num_label_ = 1;
   int max_label_ = 1;
   bool multi_label_ = false;
+  std::string cluster_file_;
+  int cluster_per_batch_ = 1;
 
  private:
   std::unique_ptr<NeighborAggregationFlow> flow_;
@@ -42,8 +49,15 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
   vec_int_t nodes_;
   std::vector<vecl_t> labels_list_;
 
+  // Cluster-GCN batches, see ClusterBatcher
+  ClusterBatcher cluster_batcher_;
+  bool cluster_ready_ = false;
+  std::unordered_map<int_t, vecl_t> label_map_;
+  vec_int_t batch_nodes_;
+
   vec_set_t level_nodes_;
   vec_map_neigh_t level_neighs_;
+  vec_map_adj_t level_adjs_;
   std::vector<Indexing> indexings_;
 
  public:
@@ -56,6 +70,7 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
     }
 
     flow_ = NewNeighborAggregationFlow(graph_client);
+    flow_->set_shared_feature(shared_feature_);
     return true;
   }
 
@@ -67,10 +82,16 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
       is_train_ = val;
     } else if (k == "num_neighbors") {
       DXCHECK(deepx_core::Split<int>(v, ",", &num_neighbors_));
+    } else if (k == "layer_sizes") {
+      DXCHECK(deepx_core::Split<int>(v, ",", &layer_sizes_));
     } else if (k == "use_neigh_feat") {
       auto val = std::stoi(v);
       DXCHECK(val == 1 || val == 0);
       use_neigh_feat_ = val;
+    } else if (k == "shared_feature") {
+      auto val = std::stoi(v);
+      DXCHECK(val == 1 || val == 0);
+      shared_feature_ = val;
     } else if (k == "num_label") {
       num_label_ = std::stoi(v);
       DXCHECK(num_label_ >= 1);
@@ -81,6 +102,11 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
     } else if (k == "max_label") {
       max_label_ = std::stoi(v);
       DXCHECK(max_label_ >= 1);
+    } else if (k == "cluster_file") {
+      cluster_file_ = v;
+    } else if (k == "cluster_per_batch") {
+      cluster_per_batch_ = std::stoi(v);
+      DXCHECK(cluster_per_batch_ >= 1);
     } else {
       DXERROR("Unexpected config: %s = %s.", k.c_str(), v.c_str());
       return false;
@@ -98,6 +124,16 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
       }
     }
 
+    if (!cluster_file_.empty()) {
+      if (!layer_sizes_.empty()) {
+        DXERROR("cluster_file and layer_sizes can't be used together.");
+        return false;
+      }
+      if (!cluster_batcher_.Init(cluster_file_)) {
+        return false;
+      }
+      cluster_batcher_.set_cluster_per_batch(cluster_per_batch_);
+    }
     return true;
   }
 
@@ -110,6 +146,10 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
   /* Read batch data from file for training */
   /************************************************************************/
   bool GetTrainBatch(Instance* inst) {
+    if (!cluster_file_.empty()) {
+      return GetClusterBatch(inst);
+    }
+
     std::vector<NodeAndLabelValue> values;
     if (!line_parser_.NextBatch<NodeAndLabelValue>(batch_, &values)) {
       line_parser_.Close();
@@ -122,9 +162,57 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
         Collect<NodeAndLabelValue, vecl_t>(values, &NodeAndLabelValue::labels);
 
     // Sample subgraph
-    flow_->SampleSubGraph(nodes_, num_neighbors_, &level_nodes_,
-                          &level_neighs_);
+    SampleSubGraph(nodes_);
+
+    FillTrainInstance(inst);
+    return true;
+  }
+
+  /************************************************************************/
+  /* Cluster-GCN batches of the clusters of the nodes of a file */
+  /************************************************************************/
+  // Clusters are drawn from all the labeled nodes of the opened file, so the
+  // nodes and labels of the whole file are held before its first batch, about
+  // 100 bytes a line. Dist workers open chunks of '--chunk_size' MB instead
+  // of files, which bounds it, see ChunkDispatcher.
+  bool GetClusterBatch(Instance* inst) {
+    if (!cluster_ready_) {
+      // the labels of all the nodes of the file
+      label_map_.clear();
+      vec_int_t seeds;
+      std::vector<NodeAndLabelValue> values;
+      while (line_parser_.NextBatch<NodeAndLabelValue>(batch_, &values)) {
+        for (auto& value : values) {
+          if (label_map_.emplace(value.node, value.labels).second) {
+            seeds.emplace_back(value.node);
+          }
+        }
+      }
+      cluster_batcher_.Reset(seeds);
+      cluster_ready_ = true;
+    }
+
+    if (!cluster_batcher_.Next(&batch_nodes_, &nodes_)) {
+      line_parser_.Close();
+      inst->clear_batch();
+      cluster_ready_ = false;
+      std::unordered_map<int_t, vecl_t>().swap(label_map_);
+      return false;
+    }
+    labels_list_.clear();
+    for (auto node : nodes_) {
+      labels_list_.emplace_back(label_map_.at(node));
+    }
 
+    // Subgraph of the edges inside the batch
+    flow_->SampleInducedSubGraph(batch_nodes_, (int)num_neighbors_.size(),
+                                 &level_nodes_, &level_neighs_);
+
+    FillTrainInstance(inst);
+    return true;
+  }
+
+  void FillTrainInstance(Instance* inst) {
     // Fill Instance
     // 1. Fill node feature
     flow_->FillLevelNodeFeature(inst, instance_name::X_NODE_FEATURE_NAME,
@@ -138,10 +226,7 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
 
     // 3. Fill self And neigbor block
     inst_util::CreateIndexings(level_nodes_, &indexings_);
-    flow_->FillSelfAndNeighGraphBlock(inst, instance_name::X_SELF_BLOCK_NAME,
-                                      instance_name::X_NEIGH_BLOCK_NAME,
-                                      level_nodes_, level_neighs_, indexings_,
-                                      false);
+    FillGraphBlock(inst);
 
     // 4. Fill index
     flow_->FillNodeOrIndex(inst, instance_name::X_NODE_ID_NAME, nodes_,
@@ -152,7 +237,6 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
                              max_label_);
 
     inst->set_batch(nodes_.size());
-    return true;
   }
 
   /************************************************************************/
@@ -169,8 +253,7 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
     nodes_ = Collect<NodeValue, int_t>(values, &NodeValue::node);
 
     // Sample subgraph
-    flow_->SampleSubGraph(nodes_, num_neighbors_, &level_nodes_,
-                          &level_neighs_);
+    SampleSubGraph(nodes_);
 
     // Fill Instance
     // 1. Fill node feature
@@ -185,10 +268,7 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
 
     // 3. Fill self And neigbor block
     inst_util::CreateIndexings(level_nodes_, &indexings_);
-    flow_->FillSelfAndNeighGraphBlock(inst, instance_name::X_SELF_BLOCK_NAME,
-                                      instance_name::X_NEIGH_BLOCK_NAME,
-                                      level_nodes_, level_neighs_, indexings_,
-                                      false);
+    FillGraphBlock(inst);
 
     // 4. Fill index
     flow_->FillNodeOrIndex(inst, instance_name::X_NODE_ID_NAME, nodes_,
@@ -202,6 +282,32 @@ class SupGraphsageInstReader : public EmbedInstanceReader {
     inst->set_batch(nodes_.size());
     return true;
   }
+
+ private:
+  // samples the levels layer-wise if 'layer_sizes_' is set
+  void SampleSubGraph(const vec_int_t& nodes) {
+    if (layer_sizes_.empty()) {
+      flow_->SampleSubGraph(nodes, num_neighbors_, &level_nodes_,
+                            &level_neighs_);
+    } else {
+      flow_->SampleLayerwiseSubGraph(nodes, layer_sizes_, &level_nodes_,
+                                     &level_adjs_);
+    }
+  }
+
+  void FillGraphBlock(Instance* inst) const {
+    if (layer_sizes_.empty()) {
+      flow_->FillSelfAndNeighGraphBlock(
+          inst, instance_name::X_SELF_BLOCK_NAME,
+          instance_name::X_NEIGH_BLOCK_NAME, level_nodes_, level_neighs_,
+          indexings_, false);
+    } else {
+      flow_->FillSelfAndNeighGraphBlock(
+          inst, instance_name::X_SELF_BLOCK_NAME,
+          instance_name::X_NEIGH_BLOCK_NAME, level_nodes_, level_adjs_,
+          indexings_, false);
+    }
+  }
 };
 
 INSTANCE_READER_REGISTER(SupGraphsageInstReader, "SupGraphsageInstReader");
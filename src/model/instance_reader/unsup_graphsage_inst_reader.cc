@@ -17,6 +17,7 @@
 
 #include "src/io/indexing.h"
 #include "src/io/value.h"
+#include "src/model/data_flow/in_batch_negative.h"
 #include "src/model/data_flow/neighbor_aggregation_flow.h"
 #include "src/model/embed_instance_reader.h"
 #include "src/model/instance_node_name.h"
@@ -29,10 +30,16 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
   bool is_train_ = true;
   int num_neg_ = 5;
   std::vector<int> num_neighbors_;
+  std::vector<int> layer_sizes_;
   bool use_neigh_feat_ = false;
+  bool shared_feature_ = false;
+  bool in_batch_neg_ = false;
+  // fills X_LOGQ_NAME for logQ correction, see InBatchNegative
+  bool logq_ = false;
 
  private:
   std::unique_ptr<NeighborAggregationFlow> flow_;
+  InBatchNegative in_batch_negative_;
 
   vec_int_t src_nodes_;
   vec_int_t dst_nodes_;
@@ -41,6 +48,7 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
   vec_int_t merged_nodes_;
   vec_set_t level_nodes_;
   vec_map_neigh_t level_neighbors_;
+  vec_map_adj_t level_adjs_;
   std::vector<Indexing> indexings_;
 
  public:
@@ -53,6 +61,7 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
     }
 
     flow_ = NewNeighborAggregationFlow(graph_client);
+    flow_->set_shared_feature(shared_feature_);
     return true;
   }
 
@@ -68,10 +77,28 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
       DXCHECK(num_neg_ > 0);
     } else if (k == "num_neighbors") {
       DXCHECK(deepx_core::Split<int>(v, ",", &num_neighbors_));
+    } else if (k == "layer_sizes") {
+      DXCHECK(deepx_core::Split<int>(v, ",", &layer_sizes_));
     } else if (k == "use_neigh_feat") {
       auto val = std::stoi(v);
       DXCHECK(val == 0 || val == 1);
       use_neigh_feat_ = val;
+    } else if (k == "shared_feature") {
+      auto val = std::stoi(v);
+      DXCHECK(val == 0 || val == 1);
+      shared_feature_ = val;
+    } else if (k == "in_batch_neg") {
+      auto val = std::stoi(v);
+      DXCHECK(val == 0 || val == 1);
+      in_batch_neg_ = val;
+    } else if (k == "bank_size") {
+      auto val = std::stoi(v);
+      DXCHECK(val >= 0);
+      in_batch_negative_.set_bank_size(val);
+    } else if (k == "logq") {
+      auto val = std::stoi(v);
+      DXCHECK(val == 0 || val == 1);
+      logq_ = val;
     } else {
       DXERROR("Unexpected config: %s = %s.", k.c_str(), v.c_str());
       return false;
@@ -81,6 +108,16 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
     return true;
   }
 
+  bool PostInitConfig() override {
+    if (logq_ && !in_batch_neg_) {
+      // only in-batch negatives fill X_LOGQ_NAME
+      DXERROR("logq=1 requires in_batch_neg=1.");
+      return false;
+    }
+
+    return true;
+  }
+
  protected:
   bool GetBatch(Instance* inst) override {
     return is_train_ ? GetTrainBatch(inst) : GetPredictBatch(inst);
@@ -99,8 +136,13 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
     dst_nodes_ = Collect<EdgeValue, int_t>(values, &EdgeValue::dst_node);
 
     // negative sampling
-    DXCHECK(graph_client_->SharedSampleNegative(num_neg_, dst_nodes_,
-                                                dst_nodes_, &neg_nodes_list_));
+    if (in_batch_neg_) {
+      // negatives are mostly in the batch, their subgraphs are sampled once
+      SampleInBatchNegative();
+    } else {
+      DXCHECK(graph_client_->SharedSampleNegative(
+          num_neg_, dst_nodes_, dst_nodes_, &neg_nodes_list_));
+    }
 
     // merge nodes to avoid repeated construction of node computation graph.
     merged_nodes_.clear();
@@ -109,8 +151,7 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
     flow_->MergeTo(neg_nodes_list_, &merged_nodes_);
 
     // sample subgraph
-    flow_->SampleSubGraph(merged_nodes_, num_neighbors_, &level_nodes_,
-                          &level_neighbors_);
+    SampleSubGraph(merged_nodes_);
 
     // Fill instance
     // 1. Fill node and neighbor feature
@@ -121,10 +162,7 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
 
     // 2. Fill self and neighbor block
     inst_util::CreateIndexings(level_nodes_, &indexings_);
-    flow_->FillSelfAndNeighGraphBlock(inst, instance_name::X_SELF_BLOCK_NAME,
-                                      instance_name::X_NEIGH_BLOCK_NAME,
-                                      level_nodes_, level_neighbors_,
-                                      indexings_, false);
+    FillGraphBlock(inst);
 
     // 3. Fill edge and label
     auto indexing_func = [this](int_t node) {
@@ -133,15 +171,46 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
       return (int_t)index;
     };
 
-    flow_->FillEdgeAndLabel(inst, instance_name::X_SRC_ID_NAME,
-                            instance_name::X_DST_ID_NAME, deepx_core::Y_NAME,
-                            src_nodes_, dst_nodes_, neg_nodes_list_,
-                            indexing_func, indexing_func);
+    if (in_batch_neg_) {
+      flow_->FillInBatchEdgeAndLabel(
+          inst, instance_name::X_SRC_ID_NAME, instance_name::X_DST_ID_NAME,
+          deepx_core::Y_NAME, src_nodes_, dst_nodes_, neg_nodes_list_,
+          indexing_func, indexing_func);
+      if (logq_) {
+        FillLogQ(inst);
+      }
+    } else {
+      flow_->FillEdgeAndLabel(inst, instance_name::X_SRC_ID_NAME,
+                              instance_name::X_DST_ID_NAME, deepx_core::Y_NAME,
+                              src_nodes_, dst_nodes_, neg_nodes_list_,
+                              indexing_func, indexing_func);
+    }
 
     inst->set_batch(src_nodes_.size());
     return true;
   }
 
+  // negatives of each dst node from the batch, see InBatchNegative
+  void SampleInBatchNegative() {
+    if (!in_batch_negative_.Sample(num_neg_, dst_nodes_, &neg_nodes_list_)) {
+      // too few dst nodes, e.g. a last batch
+      std::vector<vec_int_t> shared_nodes_list;
+      DXCHECK(graph_client_->SharedSampleNegative(
+          num_neg_, dst_nodes_, dst_nodes_, &shared_nodes_list));
+      InBatchNegative::RepeatShared(dst_nodes_, shared_nodes_list,
+                                    &neg_nodes_list_);
+    }
+  }
+
+  void FillLogQ(Instance* inst) {
+    auto lookup_func = [this](const vec_int_t& nodes, vec_float_t* probs) {
+      return graph_client_->LookupNodeFreq(nodes, probs);
+    };
+    DXCHECK(in_batch_negative_.FillLogQ(inst, instance_name::X_LOGQ_NAME,
+                                        dst_nodes_, neg_nodes_list_,
+                                        lookup_func));
+  }
+
   /************************************************************************/
   /* Read batch data from file for predicting */
   /************************************************************************/
@@ -154,8 +223,7 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
     src_nodes_ = Collect<NodeValue, int_t>(values, &NodeValue::node);
 
     // Sample subgraph
-    flow_->SampleSubGraph(src_nodes_, num_neighbors_, &level_nodes_,
-                          &level_neighbors_);
+    SampleSubGraph(src_nodes_);
 
     // Fill Instance
     // 1. Fill node and neighbor feature
@@ -166,10 +234,7 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
 
     // 2. Fill self and neighbor block
     inst_util::CreateIndexings(level_nodes_, &indexings_);
-    flow_->FillSelfAndNeighGraphBlock(inst, instance_name::X_SELF_BLOCK_NAME,
-                                      instance_name::X_NEIGH_BLOCK_NAME,
-                                      level_nodes_, level_neighbors_,
-                                      indexings_, false);
+    FillGraphBlock(inst);
 
     // 3. Fill index
     flow_->FillNodeOrIndex(inst, instance_name::X_SRC_ID_NAME, src_nodes_,
@@ -182,6 +247,32 @@ class UnsupGraphsageInstReader : public EmbedInstanceReader {
     inst->set_batch((int)src_nodes_.size());
     return true;
   }
+
+ private:
+  // samples the levels layer-wise if 'layer_sizes_' is set
+  void SampleSubGraph(const vec_int_t& nodes) {
+    if (layer_sizes_.empty()) {
+      flow_->SampleSubGraph(nodes, num_neighbors_, &level_nodes_,
+                            &level_neighbors_);
+    } else {
+      flow_->SampleLayerwiseSubGraph(nodes, layer_sizes_, &level_nodes_,
+                                     &level_adjs_);
+    }
+  }
+
+  void FillGraphBlock(Instance* inst) const {
+    if (layer_sizes_.empty()) {
+      flow_->FillSelfAndNeighGraphBlock(
+          inst, instance_name::X_SELF_BLOCK_NAME,
+          instance_name::X_NEIGH_BLOCK_NAME, level_nodes_, level_neighbors_,
+          indexings_, false);
+    } else {
+      flow_->FillSelfAndNeighGraphBlock(
+          inst, instance_name::X_SELF_BLOCK_NAME,
+          instance_name::X_NEIGH_BLOCK_NAME, level_nodes_, level_adjs_,
+          indexings_, false);
+    }
+  }
 };
 
 INSTANCE_READER_REGISTER(UnsupGraphsageInstReader, "UnsupGraphsageInstReader");
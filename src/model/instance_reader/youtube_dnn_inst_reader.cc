@@ -16,6 +16,7 @@
 
 #include "src/io/value.h"
 #include "src/model/data_flow/deep_flow.h"
+#include "src/model/data_flow/in_batch_negative.h"
 #include "src/model/embed_instance_reader.h"
 #include "src/model/instance_node_name.h"
 
@@ -25,9 +26,13 @@ class YoutubeDNNInstReader : public EmbedInstanceReader {
  private:
   bool is_train_ = true;
   int num_neg_ = 5;
+  bool in_batch_neg_ = false;
+  // fills X_LOGQ_NAME for logQ correction, see InBatchNegative
+  bool logq_ = false;
 
  private:
   DeepFlow flow_;
+  InBatchNegative in_batch_negative_;
   // for training/predicting data
   vec_int_t pos_items_;
   std::vector<vec_pair_t> feats_list_;
@@ -46,6 +51,18 @@ class YoutubeDNNInstReader : public EmbedInstanceReader {
     } else if (k == "num_neg") {
       num_neg_ = std::stoi(v);
       DXCHECK(num_neg_ > 0);
+    } else if (k == "in_batch_neg") {
+      auto val = std::stoi(v);
+      DXCHECK(val == 0 || val == 1);
+      in_batch_neg_ = val;
+    } else if (k == "bank_size") {
+      auto val = std::stoi(v);
+      DXCHECK(val >= 0);
+      in_batch_negative_.set_bank_size(val);
+    } else if (k == "logq") {
+      auto val = std::stoi(v);
+      DXCHECK(val == 0 || val == 1);
+      logq_ = val;
     } else {
       DXERROR("Unexpected config: %s = %s.", k.c_str(), v.c_str());
       return false;
@@ -55,6 +72,16 @@ class YoutubeDNNInstReader : public EmbedInstanceReader {
     return true;
   }
 
+  bool PostInitConfig() override {
+    if (logq_ && !in_batch_neg_) {
+      // only in-batch negatives fill X_LOGQ_NAME
+      DXERROR("logq=1 requires in_batch_neg=1.");
+      return false;
+    }
+
+    return true;
+  }
+
  public:
   bool GetBatch(Instance* inst) override {
     return is_train_ ? GetTrainBatch(inst) : GetPredictBatch(inst);
@@ -70,9 +97,13 @@ class YoutubeDNNInstReader : public EmbedInstanceReader {
     }
     pos_items_ = Collect<AdjValue, int_t>(values, &AdjValue::node);
 
-    // shared sampling
-    DXCHECK(deep_client_->SharedSampleNegative(num_neg_, pos_items_, pos_items_,
-                                               &neg_items_list_));
+    if (in_batch_neg_) {
+      SampleInBatchNegative();
+    } else {
+      // shared sampling
+      DXCHECK(deep_client_->SharedSampleNegative(
+          num_neg_, pos_items_, pos_items_, &neg_items_list_));
+    }
     // Fill Instance
     // 1. Fill user feature
     vec_int_t* user_nodes_ptr = nullptr;
@@ -82,15 +113,46 @@ class YoutubeDNNInstReader : public EmbedInstanceReader {
 
     // 2. Fill edge and label
     auto indexing_func = [](int_t node) { return node; };
-    flow_.FillEdgeAndLabel(inst, instance_name::X_USER_ID_NAME,
-                           instance_name::X_ITEM_NODE_NAME, deepx_core::Y_NAME,
-                           pos_items_, neg_items_list_, indexing_func,
-                           indexing_func);
+    if (in_batch_neg_) {
+      flow_.FillInBatchEdgeAndLabel(
+          inst, instance_name::X_USER_ID_NAME, instance_name::X_ITEM_NODE_NAME,
+          deepx_core::Y_NAME, pos_items_, neg_items_list_, indexing_func,
+          indexing_func);
+      if (logq_) {
+        FillLogQ(inst);
+      }
+    } else {
+      flow_.FillEdgeAndLabel(inst, instance_name::X_USER_ID_NAME,
+                             instance_name::X_ITEM_NODE_NAME,
+                             deepx_core::Y_NAME, pos_items_, neg_items_list_,
+                             indexing_func, indexing_func);
+    }
 
     inst->set_batch(pos_items_.size());
     return true;
   }
 
+  // negatives of each positive from the batch, see InBatchNegative
+  void SampleInBatchNegative() {
+    if (!in_batch_negative_.Sample(num_neg_, pos_items_, &neg_items_list_)) {
+      // too few positives, e.g. a last batch
+      std::vector<vec_int_t> shared_items_list;
+      DXCHECK(deep_client_->SharedSampleNegative(
+          num_neg_, pos_items_, pos_items_, &shared_items_list));
+      InBatchNegative::RepeatShared(pos_items_, shared_items_list,
+                                    &neg_items_list_);
+    }
+  }
+
+  void FillLogQ(Instance* inst) {
+    auto lookup_func = [this](const vec_int_t& items, vec_float_t* probs) {
+      return deep_client_->LookupItemFreq(items, probs);
+    };
+    DXCHECK(in_batch_negative_.FillLogQ(inst, instance_name::X_LOGQ_NAME,
+                                        pos_items_, neg_items_list_,
+                                        lookup_func));
+  }
+
   /************************************************************************/
   /* Read batch data from file for predicting */
   /************************************************************************/
@@ -59,11 +59,12 @@ void CreateIndexing(const vec_int_t& nodes, Indexing* indexing) {
 
 void CreateIndexings(const vec_set_t& level_nodes,
                      std::vector<Indexing>* indexings) {
-  indexings->clear();
+  // keep the tables of the last batch, Clear() is O(1)
   indexings->resize(level_nodes.size());
   int k = 0;
   for (int i = 0; i < (int)level_nodes.size(); ++i) {
     (*indexings)[i].Clear();
+    (*indexings)[i].Reserve(level_nodes[i].size());
     for (auto node : level_nodes[i]) {
       (*indexings)[i].Emplace(node, k);
       k += 1;
@@ -25,6 +25,8 @@ class DSSM : public ModelZooImpl {
   std::vector<int> dims_ = {64, 32};
   double relu_alpha_ = 0;
   int num_neg_ = 5;
+  // logQ correction for in-batch negatives
+  int logq_ = 0;
 
   vec_group_config user_config_;
   vec_group_config item_config_;
@@ -60,6 +62,12 @@ class DSSM : public ModelZooImpl {
         DXERROR("Invalid %s: %s.", k.c_str(), v.c_str());
         return false;
       }
+    } else if (k == "logq") {
+      logq_ = std::stoi(v);
+      if (logq_ != 0 && logq_ != 1) {
+        DXERROR("Invalid %s: %s.", k.c_str(), v.c_str());
+        return false;
+      }
     } else {
       DXERROR("Unexpected config: %s = %s.", k.c_str(), v.c_str());
       return false;
@@ -104,7 +112,8 @@ class DSSM : public ModelZooImpl {
     //  ...]
     dot = Reshape("", dot, Shape(-1, num_neg_ + 1));
     // sampled softmax loss
-    auto Z = MultiClassificationTarget("loss", dot, has_w_);
+    auto Z = logq_ ? LogQMultiClassificationTarget("loss", dot, has_w_)
+                   : MultiClassificationTarget("loss", dot, has_w_);
 
     Z.emplace_back(user_embed);
     Z.emplace_back(item_embed);
@@ -26,6 +26,10 @@ class UnsupGraphsage : public ModelZooImpl {
   double relu_alpha_ = 0;
 
   bool use_neigh_feat_ = false;
+  // logQ correction for in-batch negatives
+  int logq_ = 0;
+  // negatives of each positive, for logQ correction
+  int num_neg_ = 5;
 
  public:
   DEFINE_MODEL_ZOO_LIKE(UnsupGraphsage);
@@ -59,6 +63,18 @@ class UnsupGraphsage : public ModelZooImpl {
         DXERROR("Invalid %s: %s.", k.c_str(), v.c_str());
         return false;
       }
+    } else if (k == "logq") {
+      logq_ = std::stoi(v);
+      if (logq_ != 0 && logq_ != 1) {
+        DXERROR("Invalid %s: %s.", k.c_str(), v.c_str());
+        return false;
+      }
+    } else if (k == "num_neg") {
+      num_neg_ = std::stoi(v);
+      if (num_neg_ <= 0) {
+        DXERROR("Invalid %s: %s.", k.c_str(), v.c_str());
+        return false;
+      }
     } else {
       DXERROR("Unexpected config: %s = %s.", k.c_str(), v.c_str());
       return false;
@@ -88,7 +104,9 @@ class UnsupGraphsage : public ModelZooImpl {
     auto* dst_embed = HiddenLookup("", Xdst_id, hidden);
 
     auto* dot = deepx_core::BatchDot("", src_embed, dst_embed);
-    auto Z = BinaryClassificationTarget(dot, has_w_);
+    auto Z = logq_ ? LogQBinaryClassificationTarget(
+                         "", dot, deepx_core::GetY(1), num_neg_, has_w_)
+                   : BinaryClassificationTarget(dot, has_w_);
     Z.emplace_back(src_embed);
     deepx_core::ReleaseVariable();
     // Z[0]: loss
@@ -26,6 +26,8 @@ class YoutubeDNN : public ModelZooImpl {
   std::vector<int> dims_ = {64, 32};
   double relu_alpha_ = 0;
   int num_neg_ = 5;
+  // logQ correction for in-batch negatives
+  int logq_ = 0;
 
   // label_group_id refers to the clicked items
   uint16_t label_group_id_ = 0;
@@ -60,6 +62,12 @@ class YoutubeDNN : public ModelZooImpl {
       }
     } else if (k == "label_group_id") {
       label_group_id_ = std::stoi(v);
+    } else if (k == "logq") {
+      logq_ = std::stoi(v);
+      if (logq_ != 0 && logq_ != 1) {
+        DXERROR("Invalid %s: %s.", k.c_str(), v.c_str());
+        return false;
+      }
     } else {
       DXERROR("Unexpected config: %s = %s.", k.c_str(), v.c_str());
       return false;
@@ -120,7 +128,8 @@ class YoutubeDNN : public ModelZooImpl {
     //  ...]
     dot = Reshape("", dot, Shape(-1, num_neg_ + 1));
     // sampled softmax loss
-    auto Z = MultiClassificationTarget("loss", dot, has_w_);
+    auto Z = logq_ ? LogQMultiClassificationTarget("loss", dot, has_w_)
+                   : MultiClassificationTarget("loss", dot, has_w_);
 
     Z.emplace_back(user_embed);
     auto* dump_item_embed =
@@ -11,8 +11,12 @@
 
 #include <deepx_core/dx_log.h>
 
+#include <vector>
+
 #include "src/common/data_types.h"
+#include "src/common/parallel_util.h"
 #include "src/model/op/gnn_graph_node.h"
+#include "src/model/op/gnn_kernel.h"
 
 namespace embedx {
 
@@ -25,55 +29,21 @@ bool AggregatorInferShape(int Xrow, const Shape& W, Shape* Z) noexcept {
   return true;
 }
 
+// inv[i] = 1 / sum(X[i])
 template <typename T, typename I>
-void MeanAggregate(const CSRMatrix<T, I>& X, const Tensor<T>& W,
-                   Tensor<T>* Z) noexcept {
-  DXASSERT_RANK2(W);
-  int col = W.dim(1);
-  DXASSERT(Z->same_shape(X.row(), col));
-  const auto* _W = W.data();
-  auto* _Z = Z->data();
-
-  Z->zeros();
-
-  T weight_sum = 0;
+void RowWeightInverse(const CSRMatrix<T, I>& X, std::vector<T>* inv) {
+  inv->resize(X.row());
   CSR_FOR_EACH_ROW(X, i) {
-    weight_sum = 0;
+    T weight_sum = 0;
     CSR_FOR_EACH_COL(X, i) { weight_sum += CSR_VALUE(X); }
-    CSR_FOR_EACH_COL(X, i) {
-      DXASSERT(CSR_COL(X) < (int_t)W.dim(0));
-      const auto* Wj = _W + CSR_COL(X) * col;
-      deepx_core::LLMath<T>::axpy(col, CSR_VALUE(X) / weight_sum, Wj, _Z);
-    }
-    _Z += col;
+    (*inv)[i] = 1 / weight_sum;
   }
 }
 
+// Z[i] = sum(X[i][j] * row_scale[i] * W[j]), rows are split across threads.
 template <typename T, typename I>
-void MeanAggregateBackward(const CSRMatrix<T, I>& X, const Tensor<T>& /*W*/,
-                           const Tensor<T>& /*Z*/, const Tensor<T>& gZ,
-                           Tensor<T>* gW) noexcept {
-  int col = gW->dim(1);
-  DXASSERT(gZ.same_shape(X.row(), col));
-  const auto* _gZ = gZ.data();
-  auto* _gW = gW->data();
-
-  T weight_sum = 0;
-  CSR_FOR_EACH_ROW(X, i) {
-    weight_sum = 0;
-    CSR_FOR_EACH_COL(X, i) { weight_sum += CSR_VALUE(X); }
-    CSR_FOR_EACH_COL(X, i) {
-      DXASSERT(CSR_COL(X) < (int_t)gW->dim(0));
-      auto* gWj = _gW + CSR_COL(X) * col;
-      deepx_core::LLMath<T>::axpy(col, CSR_VALUE(X) / weight_sum, _gZ, gWj);
-    }
-    _gZ += col;
-  }
-}
-
-template <typename T, typename I>
-void SumAggregate(const CSRMatrix<T, I>& X, const Tensor<T>& W,
-                  Tensor<T>* Z) noexcept {
+void Aggregate(const CSRMatrix<T, I>& X, const Tensor<T>& W,
+               const T* row_scale, Tensor<T>* Z) noexcept {
   DXASSERT_RANK2(W);
   int col = W.dim(1);
   DXASSERT(Z->same_shape(X.row(), col));
@@ -82,33 +52,32 @@ void SumAggregate(const CSRMatrix<T, I>& X, const Tensor<T>& W,
 
   Z->zeros();
 
-  CSR_FOR_EACH_ROW(X, i) {
-    CSR_FOR_EACH_COL(X, i) {
-      DXASSERT(CSR_COL(X) < (int_t)W.dim(0));
-      const auto* Wj = _W + CSR_COL(X) * col;
-      deepx_core::LLMath<T>::axpy(col, CSR_VALUE(X), Wj, _Z);
+  int avg_nnz = X.row() ? (int)(X.col_size() / X.row()) : 0;
+  int grain = gnn_kernel::RowGrain((avg_nnz + 1) * col);
+  ParallelFor(X.row(), grain, [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      T scale = row_scale ? row_scale[i] : (T)1;
+      auto* Zi = _Z + (size_t)i * col;
+      CSR_FOR_EACH_COL(X, i) {
+        DXASSERT(CSR_COL(X) < (int_t)W.dim(0));
+        const auto* Wj = _W + CSR_COL(X) * col;
+        gnn_kernel::Axpy<T>(col, CSR_VALUE(X) * scale, Wj, Zi);
+      }
     }
-    _Z += col;
-  }
+  });
 }
 
+// gW[j] += sum(X[i][j] * row_scale[i] * gZ[i]), conflict free by transposing X.
 template <typename T, typename I>
-void SumAggregateBackward(const CSRMatrix<T, I>& X, const Tensor<T>& /*W*/,
-                          const Tensor<T>& /*Z*/, const Tensor<T>& gZ,
-                          Tensor<T>* gW) noexcept {
+void AggregateBackward(const CSRMatrix<T, I>& X, const T* row_scale,
+                       const Tensor<T>& gZ, Tensor<T>* gW,
+                       gnn_kernel::CSCBlock<T>* block) {
+  int k = gW->dim(0);
   int col = gW->dim(1);
   DXASSERT(gZ.same_shape(X.row(), col));
-  const auto* _gZ = gZ.data();
-  auto* _gW = gW->data();
-
-  CSR_FOR_EACH_ROW(X, i) {
-    CSR_FOR_EACH_COL(X, i) {
-      DXASSERT(CSR_COL(X) < (int_t)gW->dim(0));
-      auto* gWj = _gW + CSR_COL(X) * col;
-      deepx_core::LLMath<T>::axpy(col, CSR_VALUE(X), _gZ, gWj);
-    }
-    _gZ += col;
-  }
+  gnn_kernel::TransposeCSR(
+      X, k, [](int_t j) { return (int)j; }, row_scale, block);
+  gnn_kernel::SegmentReduce(*block, gZ.data(), col, gW->data());
 }
 
 AggregatorNodeBase::AggregatorNodeBase(std::string name, GraphNode* X,
@@ -138,6 +107,7 @@ class AggregatorOpBase : public deepx_core::OpImpl {
   tsr_t* Z_ = nullptr;
   tsr_t* gZ_ = nullptr;
   tsr_t* gW_ = nullptr;
+  gnn_kernel::CSCBlock<float_t> block_;
 
  public:
   void InitForward() override {
@@ -165,10 +135,18 @@ MeanAggregatorNode::MeanAggregatorNode(std::string name, GraphNode* X,
 class MeanAggregatorOp : public AggregatorOpBase {
  public:
   DEFINE_OP_LIKE(MeanAggregatorOp);
-  void Forward() override { MeanAggregate(*X_, *Wtsr_, Z_); }
+
+ private:
+  std::vector<float_t> inv_weight_sum_;
+
+ public:
+  void Forward() override {
+    RowWeightInverse(*X_, &inv_weight_sum_);
+    Aggregate(*X_, *Wtsr_, inv_weight_sum_.data(), Z_);
+  }
 
   void Backward() override {
-    MeanAggregateBackward(*X_, *Wtsr_, *Z_, *gZ_, gW_);
+    AggregateBackward(*X_, inv_weight_sum_.data(), *gZ_, gW_, &block_);
   }
 };
 
@@ -182,10 +160,12 @@ SumAggregatorNode::SumAggregatorNode(std::string name, GraphNode* X,
 class SumAggregatorOp : public AggregatorOpBase {
  public:
   DEFINE_OP_LIKE(SumAggregatorOp);
-  void Forward() override { SumAggregate(*X_, *Wtsr_, Z_); }
+  void Forward() override {
+    Aggregate(*X_, *Wtsr_, (const float_t*)nullptr, Z_);
+  }
 
   void Backward() override {
-    SumAggregateBackward(*X_, *Wtsr_, *Z_, *gZ_, gW_);
+    AggregateBackward(*X_, (const float_t*)nullptr, *gZ_, gW_, &block_);
   }
 };
 
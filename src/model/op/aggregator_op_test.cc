@@ -11,6 +11,9 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+
+#include "src/common/parallel_util.h"
 #include "src/model/op/gnn_graph_node.h"
 #include "src/model/op/op_test.h"
 
@@ -74,4 +77,104 @@ TEST_F(GnnOpBackwardTest, SumAggregatorOp) {
   };
   CheckOpBackward(&Z, 0, nullptr, nullptr, inst_initializer);
 }
+
+// Enough rows and hidden units to split the kernels across threads.
+class GnnOpParallelTest : public testing::Test, public deepx_core::DataType {
+ protected:
+  static constexpr int ROW = 256;
+  static constexpr int NNZ = 8;
+  static constexpr int WROW = 50;
+  csr_t X_;
+
+ protected:
+  void SetUp() override {
+    std::default_random_engine engine(9527);
+    std::uniform_int_distribution<int> col_dist(0, WROW - 1);
+    std::uniform_int_distribution<int> value_dist(1, 3);
+    X_.clear();
+    for (int i = 0; i < ROW; ++i) {
+      for (int j = 0; j < NNZ; ++j) {
+        X_.emplace(col_dist(engine), (float_t)value_dist(engine));
+      }
+      X_.add_row();
+    }
+    SetIntraOpThreadNum(4);
+  }
+
+  void TearDown() override { SetIntraOpThreadNum(1); }
+
+  static float_t WValue(int i) noexcept { return (float_t)(i % 7 - 3); }
+
+  // W[j][k] = WValue(j * col + k)
+  tsr_t Expected(int col, bool mean) const {
+    tsr_t Z;
+    Z.resize(ROW, col);
+    Z.zeros();
+    CSR_FOR_EACH_ROW(X_, i) {
+      float_t weight_sum = 0;
+      CSR_FOR_EACH_COL(X_, i) { weight_sum += CSR_VALUE(X_); }
+      CSR_FOR_EACH_COL(X_, i) {
+        float_t w = mean ? CSR_VALUE(X_) / weight_sum : CSR_VALUE(X_);
+        for (int k = 0; k < col; ++k) {
+          Z.data(i * col + k) += w * WValue((int)CSR_COL(X_) * col + k);
+        }
+      }
+    }
+    return Z;
+  }
+
+  template <class Node>
+  void TestForward(int col, bool mean) {
+    InstanceNode X("X", Shape(-1, 0), deepx_core::TENSOR_TYPE_CSR);
+    VariableNode W("W", Shape(WROW, col), deepx_core::TENSOR_TYPE_TSR);
+    Node Z("Z", &X, &W);
+    auto post_param_initializer = [](std::default_random_engine& /*engine*/,
+                                     deepx_core::TensorMap* param) {
+      auto& W = param->get<tsr_t>("W");
+      for (int i = 0; i < W.total_dim(); ++i) {
+        W.data(i) = WValue(i);
+      }
+    };
+    auto inst_initializer = [this](deepx_core::Instance* inst) {
+      inst->insert<csr_t>("X") = X_;
+    };
+    CheckOpForward(&Z, 0, Expected(col, mean), nullptr, post_param_initializer,
+                   inst_initializer);
+  }
+
+  template <class Node>
+  void TestBackward(int col) {
+    InstanceNode X("X", Shape(-1, 0), deepx_core::TENSOR_TYPE_CSR);
+    VariableNode W("W", Shape(WROW, col),
+                   deepx_core::TENSOR_INITIALIZER_TYPE_RANDN, 0, 1);
+    Node Z("Z", &X, &W);
+    auto inst_initializer = [this](deepx_core::Instance* inst) {
+      inst->insert<csr_t>("X") = X_;
+    };
+    CheckOpBackward(&Z, 0, nullptr, nullptr, inst_initializer);
+  }
+};
+
+TEST_F(GnnOpParallelTest, MeanAggregatorOpForward) {
+  TestForward<MeanAggregatorNode>(32, true);
+  TestForward<MeanAggregatorNode>(64, true);
+  TestForward<MeanAggregatorNode>(17, true);
+}
+
+TEST_F(GnnOpParallelTest, MeanAggregatorOpBackward) {
+  TestBackward<MeanAggregatorNode>(32);
+  TestBackward<MeanAggregatorNode>(17);
+}
+
+TEST_F(GnnOpParallelTest, SumAggregatorOpForward) {
+  TestForward<SumAggregatorNode>(32, false);
+  TestForward<SumAggregatorNode>(64, false);
+  TestForward<SumAggregatorNode>(17, false);
+}
+
+TEST_F(GnnOpParallelTest, SumAggregatorOpBackward) {
+  TestBackward<SumAggregatorNode>(32);
+  TestBackward<SumAggregatorNode>(17);
+}
+
 }  // namespace embedx
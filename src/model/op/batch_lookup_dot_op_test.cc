@@ -24,9 +24,26 @@ class GraphBatchLookupDotOpForwardTest : public testing::Test,
   csr_t Xin_{{0, 1, 2, 3, 4}, {0, 1, 2, 3}, {1, 1, 1, 1}};
   // output ids {1,3,2,4}
   csr_t Xout_{{0, 1, 2, 3, 4}, {1, 3, 2, 4}, {1, 1, 1, 1}};
+  // input ids {1,1,1,1,1,2,2,3}, consecutive rows share their input
+  csr_t shared_Xin_{{0, 1, 2, 3, 4, 5, 6, 7, 8},
+                    {1, 1, 1, 1, 1, 2, 2, 3},
+                    {1, 1, 1, 1, 1, 1, 1, 1}};
+  // output ids {0,1,2,3,4,0,4,3}
+  csr_t shared_Xout_{{0, 1, 2, 3, 4, 5, 6, 7, 8},
+                     {0, 1, 2, 3, 4, 0, 4, 3},
+                     {1, 1, 1, 1, 1, 1, 1, 1}};
 
  protected:
   void TestInputTensorType(int Win_tensor_type, int Wout_tensor_type) {
+    tsr_t expected_Z{14, 122, 149, 392};
+    expected_Z.reshape(4, 1);
+    TestInputTensorType(Win_tensor_type, Wout_tensor_type, Xin_, Xout_,
+                        expected_Z);
+  }
+
+  void TestInputTensorType(int Win_tensor_type, int Wout_tensor_type,
+                           const csr_t& Xin_value, const csr_t& Xout_value,
+                           const tsr_t& expected_Z) {
     deepx_core::InstanceNode Xin("Xin", Shape(-1, 0),
                                  deepx_core::TENSOR_TYPE_CSR);
     deepx_core::InstanceNode Xout("Xout", Shape(-1, 0),
@@ -42,13 +59,12 @@ class GraphBatchLookupDotOpForwardTest : public testing::Test,
       InitParam("Wout", Wout_tensor_type, param);
     };
 
-    auto inst_initializer = [this](deepx_core::Instance* inst) {
-      inst->insert<csr_t>("Xin") = Xin_;
-      inst->insert<csr_t>("Xout") = Xout_;
+    auto inst_initializer = [&Xin_value,
+                             &Xout_value](deepx_core::Instance* inst) {
+      inst->insert<csr_t>("Xin") = Xin_value;
+      inst->insert<csr_t>("Xout") = Xout_value;
     };
 
-    tsr_t expected_Z{14, 122, 149, 392};
-    expected_Z.reshape(4, 1);
     CheckOpForward(&Z, 0, expected_Z, nullptr, post_param_initializer,
                    inst_initializer);
   }
@@ -91,6 +107,20 @@ TEST_F(GraphBatchLookupDotOpForwardTest, BatchLookupDot_SRM_SRM) {
   TestInputTensorType(deepx_core::TENSOR_TYPE_SRM, deepx_core::TENSOR_TYPE_SRM);
 }
 
+TEST_F(GraphBatchLookupDotOpForwardTest, BatchLookupDot_TSR_TSR_SharedXin) {
+  tsr_t expected_Z{14, 50, 86, 122, 158, 23, 275, 302};
+  expected_Z.reshape(8, 1);
+  TestInputTensorType(deepx_core::TENSOR_TYPE_TSR, deepx_core::TENSOR_TYPE_TSR,
+                      shared_Xin_, shared_Xout_, expected_Z);
+}
+
+TEST_F(GraphBatchLookupDotOpForwardTest, BatchLookupDot_SRM_SRM_SharedXin) {
+  tsr_t expected_Z{14, 50, 86, 122, 158, 23, 275, 302};
+  expected_Z.reshape(8, 1);
+  TestInputTensorType(deepx_core::TENSOR_TYPE_SRM, deepx_core::TENSOR_TYPE_SRM,
+                      shared_Xin_, shared_Xout_, expected_Z);
+}
+
 class GraphBatchLookupDotOpBackwardTest : public testing::Test,
                                           public deepx_core::DataType {
  protected:
@@ -98,6 +128,9 @@ class GraphBatchLookupDotOpBackwardTest : public testing::Test,
   csr_t Xin_{{0, 1, 2, 3, 4, 5, 6}, {0, 1, 2, 4, 3, 1}, {1, 1, 1, 1, 1, 1}};
   // output ids {0,3,2,4,1,2}
   csr_t Xout_{{0, 1, 2, 3, 4, 5, 6}, {0, 3, 2, 4, 1, 2}, {1, 1, 1, 1, 1, 1}};
+  // input ids {1,1,1,3,3,0}, consecutive rows share their input
+  csr_t shared_Xin_{
+      {0, 1, 2, 3, 4, 5, 6}, {1, 1, 1, 3, 3, 0}, {1, 1, 1, 1, 1, 1}};
 
   // for copy param to hidden
   csr_t in_{{0, 1, 2, 3, 4, 5}, {0, 1, 2, 3, 4}, {1, 1, 1, 1, 1}};
@@ -228,4 +261,20 @@ TEST_F(GraphBatchLookupDotOpBackwardTest, BatchLookupDot_SRM_SRM) {
       deepx_core::TENSOR_TYPE_SRM, deepx_core::GRAPH_NODE_TYPE_PARAM);
 }
 
+// rows of the same input share their gradient rows
+TEST_F(GraphBatchLookupDotOpBackwardTest,
+       BatchLookupDot_TSR_PARAM_TSR_PARAM_SharedXin) {
+  Xin_ = shared_Xin_;
+  TestInputTensorTypeAndNodeType(
+      deepx_core::TENSOR_TYPE_TSR, deepx_core::GRAPH_NODE_TYPE_PARAM,
+      deepx_core::TENSOR_TYPE_TSR, deepx_core::GRAPH_NODE_TYPE_PARAM);
+}
+
+TEST_F(GraphBatchLookupDotOpBackwardTest, BatchLookupDot_SRM_SRM_SharedXin) {
+  Xin_ = shared_Xin_;
+  TestInputTensorTypeAndNodeType(
+      deepx_core::TENSOR_TYPE_SRM, deepx_core::GRAPH_NODE_TYPE_PARAM,
+      deepx_core::TENSOR_TYPE_SRM, deepx_core::GRAPH_NODE_TYPE_PARAM);
+}
+
 }  // namespace embedx
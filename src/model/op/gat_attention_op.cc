@@ -0,0 +1,316 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::max
+#include <cmath>      // std::exp
+#include <limits>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/common/parallel_util.h"
+#include "src/model/op/gnn_graph_node.h"
+#include "src/model/op/gnn_kernel.h"
+
+namespace embedx {
+namespace {
+
+constexpr float_t GAT_NEGATIVE_SLOPE = (float_t)0.2;
+
+}  // namespace
+
+bool GATAttentionInferShape(int Xrow, const Shape& Hs, const Shape& Hd,
+                            const Shape& As, const Shape& Ad,
+                            Shape* Z) noexcept {
+  if (!Hs.is_rank(2) || !Hd.is_rank(2)) {
+    DXERROR("Invalid Hs or Hd, rank of Hs: %d and Hd: %d must be 2.",
+            Hs.rank(), Hd.rank());
+    return false;
+  }
+  if (!As.is_rank(2) || !Ad.is_rank(2) || As[0] != Ad[0] || As[1] != Ad[1]) {
+    DXERROR("Invalid As or Ad, they must be of the same rank 2 shape.");
+    return false;
+  }
+  if (Hs[1] != As[0] * As[1] || Hd[1] != Hs[1]) {
+    DXERROR("Invalid Hs or Hd, col: %d, %d must be num_head * dim: %d.",
+            Hs[1], Hd[1], As[0] * As[1]);
+    return false;
+  }
+  if (Xrow >= 0 && Hd[0] != Xrow) {
+    DXERROR("Invalid Hd, row: %d must be equal to row of X: %d.", Hd[0], Xrow);
+    return false;
+  }
+  Z->resize(Hd[0], Hd[1]);
+  return true;
+}
+
+template <typename T>
+struct GATAttentionAux {
+  std::vector<T> ss;        // Shape(num_src, num_head), Hs_jh * As_h
+  std::vector<T> sd;        // Shape(row, num_head), Hd_ih * Ad_h
+  std::vector<T> row_max;   // Shape(row, num_head)
+  std::vector<T> row_sum;   // Shape(row, num_head)
+  std::vector<T> edge_buf;  // scratch of one row in backward
+};
+
+template <typename T>
+void GATNodeScore(const Tensor<T>& H, const Tensor<T>& A, std::vector<T>* s) {
+  int row = H.dim(0);
+  int num_head = A.dim(0);
+  int dim = A.dim(1);
+  s->resize((size_t)row * num_head);
+  const auto* _H = H.data();
+  const auto* _A = A.data();
+  int grain = gnn_kernel::RowGrain(num_head * dim);
+  ParallelFor(row, grain, [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      for (int h = 0; h < num_head; ++h) {
+        (*s)[(size_t)i * num_head + h] = deepx_core::LLMath<T>::dot(
+            dim, _H + (size_t)i * num_head * dim + h * dim, _A + h * dim);
+      }
+    }
+  });
+}
+
+template <typename T>
+inline T GATLeakyReLU(T x) noexcept {
+  return x > 0 ? x : GAT_NEGATIVE_SLOPE * x;
+}
+
+// GAT attention fuses edge score, edge softmax and weighted aggregation.
+// For node i, its neighbor j and head h:
+//     e_ij = LeakyReLU(Hd_ih * Ad_h + Hs_jh * As_h)
+//     a_ij = exp(e_ij) / sum(exp(e_ik))
+//     Z_ih = sum(a_ij * Hs_jh)
+// Only the per row max and sum of exp(e_ij) are kept for the backward pass,
+// edge sized tensors are never materialized.
+//
+// inputs:
+//      X(CSR):  Shape(row, ), neighbors of node i are indices to rows of Hs
+//      Hs(TSR): Shape(num_src, num_head * dim), projected source features
+//      Hd(TSR): Shape(row, num_head * dim), projected destination features
+//      As(TSR): Shape(num_head, dim), source attention vector
+//      Ad(TSR): Shape(num_head, dim), destination attention vector
+// output:
+//      Z(TSR): Shape(row, num_head * dim)
+template <typename T, typename I>
+void GATAttention(const CSRMatrix<T, I>& X, const Tensor<T>& Hs,
+                  const Tensor<T>& Hd, const Tensor<T>& As,
+                  const Tensor<T>& Ad, Tensor<T>* Z, GATAttentionAux<T>* aux) {
+  int num_head = As.dim(0);
+  int dim = As.dim(1);
+  int col = num_head * dim;
+  int num_src = Hs.dim(0);
+  DXASSERT(Z->same_shape(X.row(), col));
+  const auto* _Hs = Hs.data();
+  auto* _Z = Z->data();
+
+  GATNodeScore(Hs, As, &aux->ss);
+  GATNodeScore(Hd, Ad, &aux->sd);
+  aux->row_max.resize((size_t)X.row() * num_head);
+  aux->row_sum.resize((size_t)X.row() * num_head);
+
+  Z->zeros();
+
+  int avg_nnz = X.row() ? (int)(X.col_size() / X.row()) : 0;
+  int grain = gnn_kernel::RowGrain((avg_nnz + 1) * col);
+  ParallelFor(X.row(), grain, [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      int row_start = X.row_offset(i);
+      int row_end = X.row_offset(i + 1);
+      for (int h = 0; h < num_head; ++h) {
+        T sd = aux->sd[(size_t)i * num_head + h];
+        T max_e = -std::numeric_limits<T>::max();
+        for (int k = row_start; k < row_end; ++k) {
+          int j = (int)(X.col(k) % num_src);
+          T e = GATLeakyReLU(sd + aux->ss[j * num_head + h]);
+          max_e = std::max(max_e, e);
+        }
+
+        T sum = 0;
+        auto* Zih = _Z + (size_t)i * col + h * dim;
+        for (int k = row_start; k < row_end; ++k) {
+          int j = (int)(X.col(k) % num_src);
+          T e = GATLeakyReLU(sd + aux->ss[j * num_head + h]);
+          T p = std::exp(e - max_e);
+          sum += p;
+          gnn_kernel::Axpy<T>(dim, p, _Hs + (size_t)j * col + h * dim, Zih);
+        }
+
+        if (sum > 0) {
+          T inv_sum = 1 / sum;
+          for (int d = 0; d < dim; ++d) {
+            Zih[d] *= inv_sum;
+          }
+        }
+        aux->row_max[(size_t)i * num_head + h] = max_e;
+        aux->row_sum[(size_t)i * num_head + h] = sum;
+      }
+    }
+  });
+}
+
+template <typename T, typename I>
+void GATAttentionBackward(const CSRMatrix<T, I>& X, const Tensor<T>& Hs,
+                          const Tensor<T>& Hd, const Tensor<T>& As,
+                          const Tensor<T>& Ad, const Tensor<T>& /*Z*/,
+                          const Tensor<T>& gZ, Tensor<T>* gHs, Tensor<T>* gHd,
+                          Tensor<T>* gAs, Tensor<T>* gAd,
+                          GATAttentionAux<T>* aux) {
+  int num_head = As.dim(0);
+  int dim = As.dim(1);
+  int col = num_head * dim;
+  int num_src = Hs.dim(0);
+  const auto* _Hs = Hs.data();
+  const auto* _Hd = Hd.data();
+  const auto* _As = As.data();
+  const auto* _Ad = Ad.data();
+  const auto* _gZ = gZ.data();
+  auto& edge_buf = aux->edge_buf;
+
+  CSR_FOR_EACH_ROW(X, i) {
+    int row_start = X.row_offset(i);
+    int row_end = X.row_offset(i + 1);
+    int n = row_end - row_start;
+    // a_ij, dLoss/da_ij
+    edge_buf.resize(2 * (size_t)n);
+    T* a = edge_buf.data();
+    T* ga = a + n;
+    for (int h = 0; h < num_head; ++h) {
+      T sd = aux->sd[(size_t)i * num_head + h];
+      T max_e = aux->row_max[(size_t)i * num_head + h];
+      T sum = aux->row_sum[(size_t)i * num_head + h];
+      const auto* gZih = _gZ + (size_t)i * col + h * dim;
+
+      T ga_dot_a = 0;
+      for (int k = 0; k < n; ++k) {
+        int j = (int)(X.col(row_start + k) % num_src);
+        const auto* Hsjh = _Hs + (size_t)j * col + h * dim;
+        T e = GATLeakyReLU(sd + aux->ss[j * num_head + h]);
+        a[k] = std::exp(e - max_e) / sum;
+        ga[k] = deepx_core::LLMath<T>::dot(dim, gZih, Hsjh);
+        ga_dot_a += a[k] * ga[k];
+      }
+
+      for (int k = 0; k < n; ++k) {
+        int j = (int)(X.col(row_start + k) % num_src);
+        T e = sd + aux->ss[j * num_head + h];
+        // softmax and LeakyReLU backward
+        T ge = a[k] * (ga[k] - ga_dot_a);
+        T gs = e > 0 ? ge : GAT_NEGATIVE_SLOPE * ge;
+        const auto* Hsjh = _Hs + (size_t)j * col + h * dim;
+        if (gHs) {
+          auto* gHsjh = gHs->data() + (size_t)j * col + h * dim;
+          gnn_kernel::Axpy<T>(dim, a[k], gZih, gHsjh);
+          gnn_kernel::Axpy<T>(dim, gs, _As + h * dim, gHsjh);
+        }
+        if (gAs) {
+          gnn_kernel::Axpy<T>(dim, gs, Hsjh, gAs->data() + h * dim);
+        }
+        if (gHd) {
+          gnn_kernel::Axpy<T>(dim, gs, _Ad + h * dim,
+                              gHd->data() + (size_t)i * col + h * dim);
+        }
+        if (gAd) {
+          gnn_kernel::Axpy<T>(dim, gs, _Hd + (size_t)i * col + h * dim,
+                              gAd->data() + h * dim);
+        }
+      }
+    }
+  }
+}
+
+GATAttentionNode::GATAttentionNode(std::string name, GraphNode* X,
+                                   GraphNode* Hs, GraphNode* Hd, GraphNode* As,
+                                   GraphNode* Ad)
+    : GraphNode(std::move(name)) {
+  DXCHECK_THROW(X->node_type() == deepx_core::GRAPH_NODE_TYPE_INSTANCE);
+  DXCHECK_THROW(X->tensor_type() == deepx_core::TENSOR_TYPE_CSR);
+  DXCHECK_THROW(Hs->tensor_type() == deepx_core::TENSOR_TYPE_TSR);
+  DXCHECK_THROW(Hd->tensor_type() == deepx_core::TENSOR_TYPE_TSR);
+  DXCHECK_THROW(As->tensor_type() == deepx_core::TENSOR_TYPE_TSR);
+  DXCHECK_THROW(Ad->tensor_type() == deepx_core::TENSOR_TYPE_TSR);
+  input_ = {X, Hs, Hd, As, Ad};
+  node_type_ = deepx_core::GRAPH_NODE_TYPE_HIDDEN;
+  tensor_type_ = deepx_core::TENSOR_TYPE_TSR;
+
+  if (!Hs->shape().empty() && !Hd->shape().empty() && !As->shape().empty() &&
+      !Ad->shape().empty()) {
+    (void)GATAttentionInferShape(-1, Hs->shape(), Hd->shape(), As->shape(),
+                                 Ad->shape(), &shape_);
+  }
+}
+
+class GATAttentionOp : public deepx_core::OpImpl {
+ private:
+  const GraphNode* Xnode_ = nullptr;
+  const GraphNode* Hs_node_ = nullptr;
+  const GraphNode* Hd_node_ = nullptr;
+  const GraphNode* As_node_ = nullptr;
+  const GraphNode* Ad_node_ = nullptr;
+  const csr_t* X_ = nullptr;
+  const tsr_t* Hs_ = nullptr;
+  const tsr_t* Hd_ = nullptr;
+  const tsr_t* As_ = nullptr;
+  const tsr_t* Ad_ = nullptr;
+  Shape Zshape_;
+  tsr_t* Z_ = nullptr;
+  tsr_t* gZ_ = nullptr;
+  tsr_t* gHs_ = nullptr;
+  tsr_t* gHd_ = nullptr;
+  tsr_t* gAs_ = nullptr;
+  tsr_t* gAd_ = nullptr;
+  GATAttentionAux<float_t> aux_;
+
+ public:
+  DEFINE_OP_LIKE(GATAttentionOp);
+
+  void InitForward() override {
+    Xnode_ = node_->input(0);
+    DXCHECK_THROW(!Xnode_->need_grad());
+    Hs_node_ = node_->input(1);
+    Hd_node_ = node_->input(2);
+    As_node_ = node_->input(3);
+    Ad_node_ = node_->input(4);
+    X_ = GetPtrCSR(Xnode_);
+    Hs_ = GetPtrTSR(Hs_node_);
+    Hd_ = GetPtrTSR(Hd_node_);
+    As_ = GetPtrTSR(As_node_);
+    Ad_ = GetPtrTSR(Ad_node_);
+    DXCHECK_THROW(GATAttentionInferShape(X_->row(), Hs_->shape(), Hd_->shape(),
+                                         As_->shape(), Ad_->shape(),
+                                         &Zshape_));
+    Z_ = InitHiddenTSR(node_, Zshape_);
+  }
+
+  void InitBackward() override {
+    gZ_ = GetGradPtrTSR(node_);
+    gHs_ = InitGradTSR(Hs_node_, Hs_->shape());
+    gHd_ = InitGradTSR(Hd_node_, Hd_->shape());
+    gAs_ = InitGradTSR(As_node_, As_->shape());
+    gAd_ = InitGradTSR(Ad_node_, Ad_->shape());
+  }
+
+  void Forward() override {
+    GATAttention(*X_, *Hs_, *Hd_, *As_, *Ad_, Z_, &aux_);
+  }
+
+  void Backward() override {
+    GATAttentionBackward(*X_, *Hs_, *Hd_, *As_, *Ad_, *Z_, *gZ_, gHs_, gHd_,
+                         gAs_, gAd_, &aux_);
+  }
+};
+
+GRAPH_NODE_REGISTER(GATAttentionNode);
+OP_REGISTER(GATAttentionOp, "GATAttentionNode");
+
+}  // namespace embedx
@@ -0,0 +1,77 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <gtest/gtest.h>
+
+#include "src/model/op/gnn_graph_node.h"
+#include "src/model/op/op_test.h"
+
+namespace embedx {
+
+class GATAttentionOpForwardTest : public testing::Test,
+                                  public deepx_core::DataType {
+ protected:
+  // row 0: 0=1 1=1 2=1
+  // row 1: 1=1 3=1
+  const csr_t X_{{0, 3, 5}, {0, 1, 2, 1, 3}, {1, 1, 1, 1, 1}};
+};
+
+class GATAttentionOpBackwardTest : public testing::Test,
+                                   public deepx_core::DataType {
+ protected:
+  // row 0: 0=1 1=1 3=1
+  // row 1: 2=1 3=1 4=1 6=1
+  // row 2: 1=1 5=1
+  const csr_t X_{
+      {0, 3, 7, 9}, {0, 1, 3, 2, 3, 4, 6, 1, 5}, {1, 1, 1, 1, 1, 1, 1, 1, 1}};
+
+ protected:
+  void TestNumHead(int num_head, int dim) {
+    InstanceNode X("X", Shape(-1, 0), deepx_core::TENSOR_TYPE_CSR);
+    VariableNode Hs("Hs", Shape(7, num_head * dim),
+                    deepx_core::TENSOR_INITIALIZER_TYPE_RANDN, 0, 1);
+    VariableNode Hd("Hd", Shape(3, num_head * dim),
+                    deepx_core::TENSOR_INITIALIZER_TYPE_RANDN, 0, 1);
+    VariableNode As("As", Shape(num_head, dim),
+                    deepx_core::TENSOR_INITIALIZER_TYPE_RANDN, 0, 1);
+    VariableNode Ad("Ad", Shape(num_head, dim),
+                    deepx_core::TENSOR_INITIALIZER_TYPE_RANDN, 0, 1);
+    GATAttentionNode Z("Z", &X, &Hs, &Hd, &As, &Ad);
+    auto inst_initializer = [this](deepx_core::Instance* inst) {
+      inst->insert<csr_t>("X") = X_;
+    };
+    CheckOpBackward(&Z, 0, nullptr, nullptr, inst_initializer);
+  }
+};
+
+TEST_F(GATAttentionOpForwardTest, NumHead2) {
+  InstanceNode X("X", Shape(-1, 0), deepx_core::TENSOR_TYPE_CSR);
+  deepx_core::ConstantNode Hs(
+      "Hs", Shape(4, 4), {1, 0, 0, 1, 0, 1, 1, 0, 1, 1, -1, 0, 2, 0, 0, 2});
+  deepx_core::ConstantNode Hd("Hd", Shape(2, 4), {1, 1, 0, 1, 0, 1, 1, 1});
+  deepx_core::ConstantNode As("As", Shape(2, 2), {1, -1, 0.5, 0.5});
+  deepx_core::ConstantNode Ad("Ad", Shape(2, 2), {0.5, 1, 1, -1});
+  GATAttentionNode Z("Z", &X, &Hs, &Hd, &As, &Ad);
+
+  auto inst_initializer = [this](deepx_core::Instance* inst) {
+    inst->insert<csr_t>("X") = X_;
+  };
+  tsr_t expected_Z{0.90997, 0.33476, 0.06431, 0.35477,
+                   1.90515, 0.04743, 0.37754, 1.24492};
+  expected_Z.reshape(2, 4);
+  CheckOpForward(&Z, 0, expected_Z, nullptr, nullptr, inst_initializer);
+}
+
+TEST_F(GATAttentionOpBackwardTest, NumHead1) { TestNumHead(1, 4); }
+
+TEST_F(GATAttentionOpBackwardTest, NumHead2) { TestNumHead(2, 3); }
+
+}  // namespace embedx
@@ -77,6 +77,23 @@ class EdgeSoftmaxNode : public GraphNode {
   DEFINE_GRAPH_NODE_LIKE(EdgeSoftmaxNode);
 };
 
+// GATAttention fuses GAT edge score, edge softmax and weighted aggregation.
+//
+// inputs:
+//      X(CSR):  Shape(row, ), neighbors of node i are indices to rows of Hs
+//      Hs(TSR): Shape(num_src, num_head * dim), projected source features
+//      Hd(TSR): Shape(row, num_head * dim), projected destination features
+//      As(TSR): Shape(num_head, dim), source attention vector
+//      Ad(TSR): Shape(num_head, dim), destination attention vector
+// output:
+//      Z(TSR): Shape(row, num_head * dim), attention weighted Hs
+class GATAttentionNode : public GraphNode {
+ public:
+  GATAttentionNode(std::string name, GraphNode* X, GraphNode* Hs,
+                   GraphNode* Hd, GraphNode* As, GraphNode* Ad);
+  DEFINE_GRAPH_NODE_LIKE(GATAttentionNode);
+};
+
 // Assemble is an operation that assemble X(as key) and Y (as value) to
 // update W.
 // if key not in W:
@@ -123,6 +140,7 @@ DEFINE_GRAPH_NODE_CREATOR(BatchLookupDot)
 DEFINE_GRAPH_NODE_CREATOR(MeanAggregator)
 DEFINE_GRAPH_NODE_CREATOR(SumAggregator)
 DEFINE_GRAPH_NODE_CREATOR(EdgeSoftmax)
+DEFINE_GRAPH_NODE_CREATOR(GATAttention)
 DEFINE_GRAPH_NODE_CREATOR(Assemble)
 
 }  // namespace embedx
@@ -0,0 +1,172 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <deepx_core/dx_log.h>
+#include <deepx_core/tensor/csr_matrix.h>
+#include <deepx_core/tensor/ll_math.h>
+
+#if defined(__AVX__) || defined(__SSE__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>  // std::max
+#include <vector>
+
+#include "src/common/parallel_util.h"
+
+namespace embedx {
+namespace gnn_kernel {
+
+// Minimum number of multiply-adds of one intra-op task.
+constexpr int MIN_TASK_WORK = 1 << 15;
+
+// Number of rows of one intra-op task whose rows cost 'row_work' each.
+inline int RowGrain(int row_work) noexcept {
+  return std::max(MIN_TASK_WORK / std::max(row_work, 1), 1);
+}
+
+/************************************************************************/
+/* axpy: y += alpha * x */
+/************************************************************************/
+template <typename T, int N>
+inline void AxpyN(T alpha, const T* x, T* y) noexcept {
+  for (int i = 0; i < N; ++i) {
+    y[i] += alpha * x[i];
+  }
+}
+
+template <typename T>
+inline void Axpy(int n, T alpha, const T* x, T* y) noexcept {
+  switch (n) {
+    case 32:
+      AxpyN<T, 32>(alpha, x, y);
+      break;
+    case 64:
+      AxpyN<T, 64>(alpha, x, y);
+      break;
+    case 128:
+      AxpyN<T, 128>(alpha, x, y);
+      break;
+    default:
+      deepx_core::LLMath<T>::axpy(n, alpha, x, y);
+      break;
+  }
+}
+
+#if defined(__AVX__)
+template <int N>
+inline void AxpyFloatN(float alpha, const float* x, float* y) noexcept {
+  __m256 a = _mm256_set1_ps(alpha);
+  for (int i = 0; i < N; i += 8) {
+    __m256 yi = _mm256_loadu_ps(y + i);
+    yi = _mm256_add_ps(yi, _mm256_mul_ps(a, _mm256_loadu_ps(x + i)));
+    _mm256_storeu_ps(y + i, yi);
+  }
+}
+#elif defined(__SSE__)
+template <int N>
+inline void AxpyFloatN(float alpha, const float* x, float* y) noexcept {
+  __m128 a = _mm_set1_ps(alpha);
+  for (int i = 0; i < N; i += 4) {
+    __m128 yi = _mm_loadu_ps(y + i);
+    yi = _mm_add_ps(yi, _mm_mul_ps(a, _mm_loadu_ps(x + i)));
+    _mm_storeu_ps(y + i, yi);
+  }
+}
+#endif
+
+#if defined(__AVX__) || defined(__SSE__)
+template <>
+inline void Axpy<float>(int n, float alpha, const float* x, float* y) noexcept {
+  switch (n) {
+    case 32:
+      AxpyFloatN<32>(alpha, x, y);
+      break;
+    case 64:
+      AxpyFloatN<64>(alpha, x, y);
+      break;
+    case 128:
+      AxpyFloatN<128>(alpha, x, y);
+      break;
+    default:
+      deepx_core::LLMath<float>::axpy(n, alpha, x, y);
+      break;
+  }
+}
+#endif
+
+/************************************************************************/
+/* CSR transpose */
+/************************************************************************/
+// Column major copy of a CSR block.
+//
+// Gradients w.r.t. the looked up rows are scattered into 'gW' in random order
+// by the row major CSR. Transposing the block first gives every 'gW' row a
+// contiguous segment, so the segments can be reduced in parallel without any
+// write conflict.
+template <typename T>
+struct CSCBlock {
+  int col = 0;
+  std::vector<int> col_offset;  // size: col + 1
+  std::vector<int> row;         // source row of each value
+  std::vector<T> value;
+};
+
+// 'to_col' maps the CSR col to [0, col), 'row_scale' scales row i of X when
+// not null.
+template <typename T, typename I, class ToCol>
+void TransposeCSR(const deepx_core::CSRMatrix<T, I>& X, int col,
+                  const ToCol& to_col, const T* row_scale,
+                  CSCBlock<T>* block) {
+  block->col = col;
+  block->col_offset.assign(col + 1, 0);
+  block->row.resize(X.col_size());
+  block->value.resize(X.col_size());
+
+  auto& offset = block->col_offset;
+  CSR_FOR_EACH_ROW(X, i) {
+    CSR_FOR_EACH_COL(X, i) {
+      DXASSERT(to_col(CSR_COL(X)) < col);
+      ++offset[to_col(CSR_COL(X)) + 1];
+    }
+  }
+  for (int j = 0; j < col; ++j) {
+    offset[j + 1] += offset[j];
+  }
+
+  std::vector<int> pos(offset.begin(), offset.end() - 1);
+  CSR_FOR_EACH_ROW(X, i) {
+    T scale = row_scale ? row_scale[i] : (T)1;
+    CSR_FOR_EACH_COL(X, i) {
+      int k = pos[to_col(CSR_COL(X))]++;
+      block->row[k] = i;
+      block->value[k] = CSR_VALUE(X) * scale;
+    }
+  }
+}
+
+// gW[j] += sum(value * gZ[row]) for each col j of 'block'.
+template <typename T>
+void SegmentReduce(const CSCBlock<T>& block, const T* gZ, int n, T* gW) {
+  int avg_nnz = block.col ? (int)(block.row.size() / block.col) : 0;
+  ParallelFor(block.col, RowGrain((avg_nnz + 1) * n), [&](int begin, int end) {
+    for (int j = begin; j < end; ++j) {
+      auto* gWj = gW + (size_t)j * n;
+      for (int k = block.col_offset[j]; k < block.col_offset[j + 1]; ++k) {
+        Axpy<T>(n, block.value[k], gZ + (size_t)block.row[k] * n, gWj);
+      }
+    }
+  });
+}
+
+}  // namespace gnn_kernel
+}  // namespace embedx
@@ -11,7 +11,9 @@
 
 #include <deepx_core/dx_log.h>
 
+#include "src/common/parallel_util.h"
 #include "src/model/op/gnn_graph_node.h"
+#include "src/model/op/gnn_kernel.h"
 
 namespace embedx {
 
@@ -24,29 +26,41 @@ bool HiddenLookupInferShape(int Xrow, const Shape& W, Shape* Z) noexcept {
   return true;
 }
 
+// Z[i] = sum(X[i][j] * W[j % k]), rows are split across threads.
 template <typename T, typename I>
 void HiddenLookup(const CSRMatrix<T, I>& X, const Tensor<T>& W,
                   Tensor<T>* Z) noexcept {
-  deepx_core::LLSparseTensor<T, I>::gesmm_mod(X, W, 0, Z);
+  int k = W.dim(0);
+  int n = W.dim(1);
+  DXASSERT(Z->same_shape(X.row(), n));
+  const auto* _W = W.data();
+  auto* _Z = Z->data();
+
+  Z->zeros();
+
+  int avg_nnz = X.row() ? (int)(X.col_size() / X.row()) : 0;
+  int grain = gnn_kernel::RowGrain((avg_nnz + 1) * n);
+  ParallelFor(X.row(), grain, [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      auto* Zi = _Z + (size_t)i * n;
+      CSR_FOR_EACH_COL(X, i) {
+        const auto* Wj = _W + (CSR_COL(X) % k) * n;
+        gnn_kernel::Axpy<T>(n, CSR_VALUE(X), Wj, Zi);
+      }
+    }
+  });
 }
 
 template <typename T, typename I>
 void HiddenLookupBackward(const CSRMatrix<T, I>& X, const Tensor<T>& W,
                           const Tensor<T>& /*Z*/, const Tensor<T>& gZ,
-                          Tensor<T>* gW) noexcept {
+                          Tensor<T>* gW, gnn_kernel::CSCBlock<T>* block) {
   int k = W.dim(0);
   int n = gZ.dim(1);
   DXASSERT(gZ.same_shape(X.row(), n));
-  const auto* _gZ = gZ.data();
-  auto* _gW = gW->data();
-
-  CSR_FOR_EACH_ROW(X, i) {
-    CSR_FOR_EACH_COL(X, i) {
-      auto* gWj = _gW + (CSR_COL(X) % k) * n;
-      deepx_core::LLMath<T>::axpy(n, CSR_VALUE(X), _gZ, gWj);
-    }
-    _gZ += n;
-  }
+  gnn_kernel::TransposeCSR(
+      X, k, [k](int_t j) { return (int)(j % k); }, (const T*)nullptr, block);
+  gnn_kernel::SegmentReduce(*block, gZ.data(), n, gW->data());
 }
 
 HiddenLookupNode::HiddenLookupNode(std::string name, GraphNode* X, GraphNode* W)
@@ -75,6 +89,7 @@ class HiddenLookupOp : public deepx_core::OpImpl {
   tsr_t* Z_ = nullptr;
   tsr_t* gZ_ = nullptr;
   tsr_t* gW_ = nullptr;
+  gnn_kernel::CSCBlock<float_t> block_;
 
  public:
   DEFINE_OP_LIKE(HiddenLookupOp);
@@ -99,7 +114,7 @@ class HiddenLookupOp : public deepx_core::OpImpl {
   void Forward() override { HiddenLookup(*X_, *Wtsr_, Z_); }
 
   void Backward() override {
-    HiddenLookupBackward(*X_, *Wtsr_, *Z_, *gZ_, gW_);
+    HiddenLookupBackward(*X_, *Wtsr_, *Z_, *gZ_, gW_, &block_);
   }
 };
 
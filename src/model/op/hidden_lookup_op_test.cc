@@ -11,6 +11,9 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+
+#include "src/common/parallel_util.h"
 #include "src/model/op/gnn_graph_node.h"
 #include "src/model/op/op_test.h"
 
@@ -44,4 +47,47 @@ TEST_F(GraphHiddenLookupOpBackwardTest, EmbeddingLookupTSRWcol4) {
   TestTSR(Shape(10, 4));
 }
 
+class GraphHiddenLookupOpParallelTest : public testing::Test,
+                                        public deepx_core::DataType {
+ protected:
+  csr_t X_;
+
+ protected:
+  void SetUp() override {
+    // col ids exceed the row number of W to cover the modulo lookup
+    std::default_random_engine engine(9527);
+    std::uniform_int_distribution<int> col_dist(0, 99);
+    std::uniform_int_distribution<int> value_dist(1, 3);
+    X_.clear();
+    for (int i = 0; i < 256; ++i) {
+      for (int j = 0; j < 8; ++j) {
+        X_.emplace(col_dist(engine), (float_t)value_dist(engine));
+      }
+      X_.add_row();
+    }
+    SetIntraOpThreadNum(4);
+  }
+
+  void TearDown() override { SetIntraOpThreadNum(1); }
+
+  void TestTSR(const Shape& Wshape) {
+    InstanceNode X("X", Shape(-1, 0), deepx_core::TENSOR_TYPE_CSR);
+    VariableNode W("W", Wshape, deepx_core::TENSOR_INITIALIZER_TYPE_RANDN, 0,
+                   1);
+    HiddenLookupNode Z("Z", &X, &W);
+    auto inst_initializer = [this](deepx_core::Instance* inst) {
+      inst->insert<csr_t>("X") = X_;
+    };
+    CheckOpBackward(&Z, 0, nullptr, nullptr, inst_initializer);
+  }
+};
+
+TEST_F(GraphHiddenLookupOpParallelTest, EmbeddingLookupTSRWcol32) {
+  TestTSR(Shape(40, 32));
+}
+
+TEST_F(GraphHiddenLookupOpParallelTest, EmbeddingLookupTSRWcol64) {
+  TestTSR(Shape(40, 64));
+}
+
 }  // namespace embedx
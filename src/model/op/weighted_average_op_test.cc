@@ -39,4 +39,14 @@ TEST_F(WeightedAverageOpBackwardTest, WeightedAverageOpBackward) {
   WeightedAverageNode Z("Z", &X, &W);
   CheckOpBackward(&Z, 0);
 }
+
+// 32 columns take the vectorized kernels
+TEST_F(WeightedAverageOpBackwardTest, WeightedAverageOpBackward_Col32) {
+  deepx_core::VariableNode X("X", Shape(3, 96),
+                             deepx_core::TENSOR_INITIALIZER_TYPE_RANDN, 0, 1);
+  deepx_core::VariableNode W("W", Shape(3, 3),
+                             deepx_core::TENSOR_INITIALIZER_TYPE_RANDN, 0, 1);
+  WeightedAverageNode Z("Z", &X, &W);
+  CheckOpBackward(&Z, 0);
+}
 }  // namespace embedx
@@ -0,0 +1,57 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/sampler/freq_table.h"
+
+#include <deepx_core/dx_log.h>
+
+#include "src/io/io_util.h"
+
+namespace embedx {
+
+std::unique_ptr<FreqTable> FreqTable::Create(const SamplerSource* source) {
+  std::unique_ptr<FreqTable> freq_table;
+  if (source == nullptr) {
+    DXERROR("Failed to create freq table, got nullptr.");
+    return freq_table;
+  }
+
+  freq_table.reset(new FreqTable);
+  const auto& nodes_list = source->nodes_list();
+  const auto& freqs_list = source->freqs_list();
+  size_t size = 0;
+  for (const auto& nodes : nodes_list) {
+    size += nodes.size();
+  }
+
+  freq_table->freq_map_.reserve(size);
+  freq_table->total_freqs_.assign(source->ns_size(), 0);
+  for (size_t i = 0; i < nodes_list.size(); ++i) {
+    const auto& nodes = nodes_list[i];
+    const auto& freqs = freqs_list[i];
+    DXCHECK(nodes.size() == freqs.size());
+    for (size_t j = 0; j < nodes.size(); ++j) {
+      freq_table->freq_map_.emplace(nodes[j], freqs[j]);
+      freq_table->total_freqs_[i] += freqs[j];
+    }
+  }
+  return freq_table;
+}
+
+float_t FreqTable::Prob(int_t node) const noexcept {
+  auto ns_id = io_util::GetNodeType(node);
+  if (ns_id >= total_freqs_.size() || total_freqs_[ns_id] == 0) {
+    return 0;
+  }
+  return Freq(node) / total_freqs_[ns_id];
+}
+
+}  // namespace embedx
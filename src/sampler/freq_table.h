@@ -0,0 +1,47 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <memory>  // std::unique_ptr
+
+#include "src/common/data_types.h"
+#include "src/sampler/sampler_source.h"
+
+namespace embedx {
+
+// FreqTable looks up the frequencies of nodes in a sampler source, the ones
+// negative samplers are built from.
+//
+// Probabilities are normalized by the total frequency of the namespace of a
+// node, they estimate how often a node is a positive of a batch.
+class FreqTable {
+ private:
+  weight_map_t freq_map_;
+  vec_float_t total_freqs_;
+
+ public:
+  static std::unique_ptr<FreqTable> Create(const SamplerSource* source);
+
+ public:
+  // 0 if 'node' is not in the source
+  float_t Freq(int_t node) const noexcept {
+    auto it = freq_map_.find(node);
+    return it == freq_map_.end() ? 0 : it->second;
+  }
+  float_t Prob(int_t node) const noexcept;
+  // total frequency of each namespace
+  const vec_float_t& total_freqs() const noexcept { return total_freqs_; }
+
+ private:
+  FreqTable() = default;
+};
+
+}  // namespace embedx
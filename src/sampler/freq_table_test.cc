@@ -0,0 +1,44 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/sampler/freq_table.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>  // std::unique_ptr
+#include <string>
+
+#include "src/common/data_types.h"
+#include "src/sampler/sampler_source.h"
+
+namespace embedx {
+
+TEST(FreqTableTest, Lookup) {
+  const std::string CONTEXT = "testdata/context";
+  auto sampler_source = NewMockSamplerSource(CONTEXT, "", 3);
+  ASSERT_TRUE(sampler_source != nullptr);
+  auto freq_table = FreqTable::Create(sampler_source.get());
+  ASSERT_TRUE(freq_table != nullptr);
+
+  // a node counts once as a key and once per appearance in a context
+  ASSERT_EQ(freq_table->total_freqs().size(), 1u);
+  EXPECT_FLOAT_EQ(freq_table->total_freqs()[0], 52);
+  for (int_t node = 0; node < 13; ++node) {
+    EXPECT_FLOAT_EQ(freq_table->Freq(node), 4);
+    EXPECT_FLOAT_EQ(freq_table->Prob(node), 4.0 / 52);
+  }
+  EXPECT_EQ(freq_table->Freq(13), 0);
+  EXPECT_EQ(freq_table->Prob(13), 0);
+
+  EXPECT_TRUE(FreqTable::Create(nullptr) == nullptr);
+}
+
+}  // namespace embedx
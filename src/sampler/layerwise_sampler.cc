@@ -0,0 +1,145 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/sampler/layerwise_sampler.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::upper_bound
+
+#include "src/common/random.h"
+
+namespace embedx {
+namespace {
+
+// P[v][u] of a context
+void RowNormalize(const vec_pair_t& context, vec_float_t* row) {
+  float_t weight_sum = 0;
+  for (const auto& pair : context) {
+    weight_sum += pair.second;
+  }
+
+  row->resize(context.size());
+  for (size_t j = 0; j < context.size(); ++j) {
+    (*row)[j] = weight_sum > 0 ? context[j].second / weight_sum : 0;
+  }
+}
+
+// LayerwiseProbs with the positions of candidates in 'index'
+void Probs(const std::vector<vec_pair_t>& contexts, vec_int_t* candidates,
+           vec_float_t* probs, flat_index_map_t* index) {
+  candidates->clear();
+  probs->clear();
+  index->clear();
+
+  vec_float_t row;
+  double prob_sum = 0;
+  for (const auto& context : contexts) {
+    RowNormalize(context, &row);
+    for (size_t j = 0; j < context.size(); ++j) {
+      int_t node = context[j].first;
+      if (index->emplace(node, (int)candidates->size())) {
+        candidates->emplace_back(node);
+        probs->emplace_back(0);
+      }
+      (*probs)[*index->find(node)] += row[j] * row[j];
+      prob_sum += row[j] * row[j];
+    }
+  }
+
+  if (prob_sum > 0) {
+    for (auto& prob : *probs) {
+      prob = (float_t)(prob / prob_sum);
+    }
+  }
+}
+
+// the position of 'random' in 'cum_probs', skips candidates of probability 0
+size_t Search(const std::vector<double>& cum_probs, double random) {
+  auto it = std::upper_bound(cum_probs.begin(), cum_probs.end(),
+                             random * cum_probs.back());
+  size_t k = (size_t)(it - cum_probs.begin());
+  // 'random * sum' rounded up to the sum
+  while (k == cum_probs.size() ||
+         (k > 0 && cum_probs[k] == cum_probs[k - 1])) {
+    k -= 1;
+  }
+  return k;
+}
+
+}  // namespace
+
+void LayerwiseProbs(const std::vector<vec_pair_t>& contexts,
+                    vec_int_t* candidates, vec_float_t* probs) {
+  flat_index_map_t index;
+  Probs(contexts, candidates, probs, &index);
+}
+
+bool LayerwiseSample(int budget, const std::vector<vec_pair_t>& contexts,
+                     vec_int_t* sampled_nodes,
+                     std::vector<vec_pair_t>* adjs) {
+  if (budget <= 0) {
+    DXERROR("Budget: %d must be greater than 0.", budget);
+    return false;
+  }
+
+  vec_int_t candidates;
+  vec_float_t probs;
+  flat_index_map_t index;
+  Probs(contexts, &candidates, &probs, &index);
+
+  // c(u) / (budget * q(u)) of each candidate, 0 if not sampled
+  vec_float_t scales(candidates.size(), 0);
+  sampled_nodes->clear();
+  if ((int)candidates.size() <= budget) {
+    scales.assign(candidates.size(), 1);
+    *sampled_nodes = candidates;
+  } else {
+    std::vector<double> cum_probs(probs.size());
+    double cum_prob = 0;
+    for (size_t k = 0; k < probs.size(); ++k) {
+      cum_prob += probs[k];
+      cum_probs[k] = cum_prob;
+    }
+
+    // no candidate to draw if all weights are 0
+    std::vector<double> randoms(cum_prob > 0 ? budget : 0);
+    ThreadLocalRandomEngine().NextDoubles((int)randoms.size(), randoms.data());
+    for (auto random : randoms) {
+      size_t k = Search(cum_probs, random);
+      scales[k] += 1 / (budget * probs[k]);
+    }
+
+    for (size_t k = 0; k < candidates.size(); ++k) {
+      if (scales[k] > 0) {
+        sampled_nodes->emplace_back(candidates[k]);
+      }
+    }
+  }
+
+  vec_float_t row;
+  adjs->resize(contexts.size());
+  for (size_t i = 0; i < contexts.size(); ++i) {
+    const auto& context = contexts[i];
+    auto& adj = (*adjs)[i];
+    adj.clear();
+    RowNormalize(context, &row);
+    for (size_t j = 0; j < context.size(); ++j) {
+      float_t scale = scales[*index.find(context[j].first)];
+      if (scale > 0) {
+        adj.emplace_back(context[j].first, row[j] * scale);
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace embedx
@@ -0,0 +1,41 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <vector>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+// Layer-wise importance sampling of GCN layers, as LADIES.
+//
+// The candidates of a layer are the neighbors of its frontier nodes. Let P be
+// the row normalized adjacency of the frontier, P[v][u] = w(v, u) / sum of
+// w(v, .), a candidate u has probability q(u) proportional to the sum of
+// P[v][u]^2 over the frontier, i.e. its squared normalized degree into it.
+//
+// 'contexts[i]' are the neighbors and weights of frontier node i.
+void LayerwiseProbs(const std::vector<vec_pair_t>& contexts,
+                    vec_int_t* candidates, vec_float_t* probs);
+
+// Draws 'budget' candidates with replacement by q, so a layer has at most
+// 'budget' nodes, and returns them in 'sampled_nodes'. 'adjs[i]' are the
+// sampled neighbors of frontier node i with weights
+// c(u) * P[v][u] / (budget * q(u)), where u is drawn c(u) times, so the sum of
+// weight * h(u) is an unbiased estimate of the mean of h over the neighbors.
+//
+// Candidates no more than 'budget' are all taken with weights P[v][u].
+bool LayerwiseSample(int budget, const std::vector<vec_pair_t>& contexts,
+                     vec_int_t* sampled_nodes,
+                     std::vector<vec_pair_t>* adjs);
+
+}  // namespace embedx
@@ -0,0 +1,151 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/sampler/layerwise_sampler.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>  // std::sqrt
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/sampler/sampling/sampling_validator.h"
+
+namespace embedx {
+
+class LayerwiseSamplerTest : public ::testing::Test {
+ protected:
+  // frontier nodes 0, 1, 2 and their neighbors
+  std::vector<vec_pair_t> contexts_{
+      {{10, 1}, {11, 1}, {12, 2}},
+      {{11, 1}, {13, 3}},
+      {{12, 1}, {13, 1}, {14, 1}, {15, 1}},
+  };
+
+ protected:
+  // h(u) of the synthetic test
+  static double H(int_t node) { return (double)(node % 7) - 2.5; }
+
+  // the mean of h over the neighbors of 'context'
+  static double ExactMean(const vec_pair_t& context) {
+    double weight_sum = 0;
+    double mean = 0;
+    for (const auto& pair : context) {
+      weight_sum += pair.second;
+      mean += pair.second * H(pair.first);
+    }
+    return mean / weight_sum;
+  }
+};
+
+TEST_F(LayerwiseSamplerTest, LayerwiseProbs) {
+  vec_int_t candidates;
+  vec_float_t probs;
+  LayerwiseProbs(contexts_, &candidates, &probs);
+  EXPECT_EQ(candidates, vec_int_t({10, 11, 12, 13, 14, 15}));
+
+  // sum of P[v][u]^2
+  std::vector<double> expected{1.0 / 16, 1.0 / 16 + 1.0 / 16,
+                               1.0 / 4 + 1.0 / 16, 9.0 / 16 + 1.0 / 16,
+                               1.0 / 16, 1.0 / 16};
+  double sum = 0;
+  for (auto prob : expected) {
+    sum += prob;
+  }
+  ASSERT_EQ(probs.size(), expected.size());
+  for (size_t k = 0; k < probs.size(); ++k) {
+    EXPECT_NEAR(probs[k], expected[k] / sum, 1e-6);
+  }
+}
+
+TEST_F(LayerwiseSamplerTest, Budget) {
+  vec_int_t sampled_nodes;
+  std::vector<vec_pair_t> adjs;
+  EXPECT_FALSE(LayerwiseSample(0, contexts_, &sampled_nodes, &adjs));
+
+  for (int budget = 1; budget <= 8; ++budget) {
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_TRUE(LayerwiseSample(budget, contexts_, &sampled_nodes, &adjs));
+      EXPECT_GE((int)sampled_nodes.size(), 1);
+      EXPECT_LE((int)sampled_nodes.size(), budget);
+
+      flat_set_t sampled_set;
+      sampled_set.insert(sampled_nodes.begin(), sampled_nodes.end());
+      EXPECT_EQ(sampled_set.size(), sampled_nodes.size());
+      ASSERT_EQ(adjs.size(), contexts_.size());
+      for (const auto& adj : adjs) {
+        for (const auto& pair : adj) {
+          EXPECT_EQ(sampled_set.count(pair.first), 1u);
+          EXPECT_GT(pair.second, 0);
+        }
+      }
+    }
+  }
+
+  // all candidates are taken with weights P[v][u]
+  ASSERT_TRUE(LayerwiseSample(6, contexts_, &sampled_nodes, &adjs));
+  EXPECT_EQ(sampled_nodes, vec_int_t({10, 11, 12, 13, 14, 15}));
+  ASSERT_EQ(adjs[1].size(), 2u);
+  EXPECT_NEAR(adjs[1][0].second, 0.25, 1e-6);
+  EXPECT_NEAR(adjs[1][1].second, 0.75, 1e-6);
+}
+
+TEST_F(LayerwiseSamplerTest, Distribution) {
+  vec_int_t candidates;
+  vec_float_t probs;
+  LayerwiseProbs(contexts_, &candidates, &probs);
+  vec_pair_t distribution;
+  for (size_t k = 0; k < candidates.size(); ++k) {
+    distribution.emplace_back(candidates[k], probs[k]);
+  }
+
+  // a budget of 1 draws exactly one node
+  vec_int_t draws;
+  vec_int_t sampled_nodes;
+  std::vector<vec_pair_t> adjs;
+  for (int i = 0; i < 100000; ++i) {
+    ASSERT_TRUE(LayerwiseSample(1, contexts_, &sampled_nodes, &adjs));
+    ASSERT_EQ(sampled_nodes.size(), 1u);
+    draws.emplace_back(sampled_nodes[0]);
+  }
+  EXPECT_TRUE(SamplingValidator::Test(distribution, draws));
+}
+
+TEST_F(LayerwiseSamplerTest, Unbiased) {
+  const int BUDGET = 3;
+  const int TRIAL = 20000;
+  std::vector<double> sums(contexts_.size(), 0);
+  std::vector<double> square_sums(contexts_.size(), 0);
+
+  vec_int_t sampled_nodes;
+  std::vector<vec_pair_t> adjs;
+  for (int i = 0; i < TRIAL; ++i) {
+    ASSERT_TRUE(LayerwiseSample(BUDGET, contexts_, &sampled_nodes, &adjs));
+    for (size_t v = 0; v < adjs.size(); ++v) {
+      double estimate = 0;
+      for (const auto& pair : adjs[v]) {
+        estimate += pair.second * H(pair.first);
+      }
+      sums[v] += estimate;
+      square_sums[v] += estimate * estimate;
+    }
+  }
+
+  // the mean of the estimates is within 5 standard errors of the exact mean
+  for (size_t v = 0; v < contexts_.size(); ++v) {
+    double mean = sums[v] / TRIAL;
+    double var = square_sums[v] / TRIAL - mean * mean;
+    double std_error = std::sqrt(var / TRIAL);
+    EXPECT_NEAR(mean, ExactMean(contexts_[v]), 5 * std_error + 1e-6);
+  }
+}
+
+}  // namespace embedx
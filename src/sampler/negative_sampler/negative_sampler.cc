@@ -22,18 +22,22 @@ bool NegativeSampler::DoSampling(int count, const vec_int_t& candidates,
                                  const vec_int_t& excluded_nodes,
                                  vec_int_t* sampled_nodes) const {
   sampled_nodes->clear();
-  int_t next_node;
+  vec_int_t next_nodes;
   while (sampled_nodes->size() < (size_t)count) {
-    if (!sampler_builder_.Next(candidates[0], &next_node)) {
+    // draw what is missing at once
+    int missing = count - (int)sampled_nodes->size();
+    if (!sampler_builder_.NextN(candidates[0], missing, &next_nodes)) {
       return false;
     }
 
-    // o(n) !!!
-    auto it =
-        std::find_if(excluded_nodes.begin(), excluded_nodes.end(),
-                     [next_node](int_t node) { return node == next_node; });
-    if (it == excluded_nodes.end()) {
-      sampled_nodes->emplace_back(next_node);
+    for (auto next_node : next_nodes) {
+      // o(n) !!!
+      auto it =
+          std::find_if(excluded_nodes.begin(), excluded_nodes.end(),
+                       [next_node](int_t node) { return node == next_node; });
+      if (it == excluded_nodes.end()) {
+        sampled_nodes->emplace_back(next_node);
+      }
     }
   }
 
@@ -14,35 +14,40 @@
 
 #include <deepx_core/dx_log.h>
 
+#include <algorithm>  // std::max, std::min
 #include <cmath>
 #include <utility>  // std::move
 
+#include "src/common/epoch.h"
 #include "src/common/random.h"
 #include "src/io/io_util.h"
 
 namespace embedx {
 namespace {
 
-void NormalizeProbs(const vec_float_t& probs, vec_float_t* norm_probs) {
-  float_t sum = 0.;
-  for (auto prob : probs) {
-    DXCHECK(prob > 0);
-    sum += std::pow(prob, 0.75);
+void NormalizeProbs(const vec_float_t& probs, float_t power,
+                    vec_float_t* norm_probs) {
+  double sum = 0.;
+  norm_probs->resize(probs.size());
+  for (size_t i = 0; i < probs.size(); ++i) {
+    DXCHECK(probs[i] > 0);
+    (*norm_probs)[i] = std::pow(probs[i], power);
+    sum += (*norm_probs)[i];
   }
 
-  norm_probs->clear();
-  for (auto prob : probs) {
-    norm_probs->emplace_back(std::pow(prob, 0.75) / sum);
+  for (auto& prob : *norm_probs) {
+    prob = (float_t)(prob / sum);
   }
 }
 
 }  // namespace
 
 std::unique_ptr<SamplerBuilder> NegativeSamplerBuilder::Create(
-    const SamplerSource* sampler_source, int sampler_type, int thread_num) {
+    const SamplerSource* sampler_source, int sampler_type, int thread_num,
+    float_t freq_power) {
   std::unique_ptr<SamplerBuilder> sampler_builder;
-  sampler_builder.reset(
-      new NegativeSamplerBuilder(sampler_source, sampler_type, thread_num));
+  sampler_builder.reset(new NegativeSamplerBuilder(
+      sampler_source, sampler_type, thread_num, freq_power));
   if (!sampler_builder->Init()) {
     DXERROR("Failed to init negative sampler builder.");
     sampler_builder.reset();
@@ -55,39 +60,79 @@ bool NegativeSamplerBuilder::InitUniformFuncs() {
 
   next_func_ = [this](int_t cur_node, int_t* next_node) -> bool {
     auto ns_id = io_util::GetNodeType(cur_node);
-    auto& candidate_nodes = sampler_source_.nodes_list()[ns_id];
-    int k = int(ThreadLocalRandom() * candidate_nodes.size());
-    *next_node = candidate_nodes[k];
+    const Sampling* sampling;
+    auto& candidate_nodes = FindCandidates(ns_id, &sampling);
+    if (candidate_nodes.empty()) {
+      return false;
+    }
+    auto size = (uint32_t)candidate_nodes.size();
+    *next_node = candidate_nodes[ThreadLocalRandomEngine().NextInt(size)];
     return true;
   };
 
   range_next_func_ = [this](int_t cur_node, int begin, int end,
                             int_t* next_node) -> bool {
     auto ns_id = io_util::GetNodeType(cur_node);
-    auto& candidate_nodes = sampler_source_.nodes_list()[ns_id];
-    int k = begin + int(ThreadLocalRandom() * (end - begin));
+    const Sampling* sampling;
+    auto& candidate_nodes = FindCandidates(ns_id, &sampling);
+    int k = begin + (int)ThreadLocalRandomEngine().NextInt(end - begin);
     *next_node = candidate_nodes[k];
     return true;
   };
 
+  next_n_func_ = [this](int_t cur_node, int count,
+                        vec_int_t* next_nodes) -> bool {
+    auto ns_id = io_util::GetNodeType(cur_node);
+    const Sampling* sampling;
+    auto& candidate_nodes = FindCandidates(ns_id, &sampling);
+    if (candidate_nodes.empty()) {
+      return false;
+    }
+    next_nodes->resize(count);
+    auto& engine = ThreadLocalRandomEngine();
+    uint32_t k[RandomEngine::BUFFER_SIZE];
+    for (int i = 0; i < count; i += RandomEngine::BUFFER_SIZE) {
+      int n = std::min(count - i, RandomEngine::BUFFER_SIZE);
+      engine.NextInts((uint32_t)candidate_nodes.size(), n, k);
+      for (int j = 0; j < n; ++j) {
+        (*next_nodes)[i + j] = candidate_nodes[k[j]];
+      }
+    }
+    return true;
+  };
+
   DXINFO("Done.");
   return true;
 }
 
 bool NegativeSamplerBuilder::InitFrequencySampler() {
-  DXINFO("Initing frequency negative sampler, with sampler_type: %d...",
-         sampling_type_);
+  DXINFO("Initing frequency negative sampler, with sampler_type: %d and "
+         "freq_power: %f...",
+         sampling_type_, freq_power_);
   const auto& probs_list = sampler_source_.freqs_list();
   samplings_.resize(sampler_source_.ns_size());
-  vec_float_t norm_probs;
+  vec_int_t ns_ids;
   for (auto& entry : sampler_source_.id_name_map()) {
-    auto ns_id = entry.first;
-    NormalizeProbs(probs_list[ns_id], &norm_probs);
-    auto sampling = NewSampling(&norm_probs, (SamplingEnum)sampling_type_);
-    if (!sampling) {
-      return false;
+    ns_ids.emplace_back(entry.first);
+  }
+
+  // namespaces are built in parallel
+  auto func = [this, &probs_list](const vec_int_t& ns_ids,
+                                  int /*thread_id*/) -> bool {
+    vec_float_t norm_probs;
+    for (auto ns_id : ns_ids) {
+      NormalizeProbs(probs_list[ns_id], freq_power_, &norm_probs);
+      auto sampling = NewSampling(&norm_probs, (SamplingEnum)sampling_type_);
+      if (!sampling) {
+        return false;
+      }
+      samplings_[ns_id] = std::move(sampling);
     }
-    samplings_[ns_id] = std::move(sampling);
+    return true;
+  };
+  int thread_num = std::max(std::min(thread_num_, (int)ns_ids.size()), 1);
+  if (!io_util::ParallelProcess<int_t>(ns_ids, func, thread_num)) {
+    return false;
   }
 
   DXINFO("Done.");
@@ -100,13 +145,14 @@ bool NegativeSamplerBuilder::InitFrequencyFuncs() {
 
   next_func_ = [this](int_t cur_node, int_t* next_node) -> bool {
     auto ns_id = io_util::GetNodeType(cur_node);
-    auto& candidate_nodes = sampler_source_.nodes_list()[ns_id];
-    if (!samplings_[ns_id]) {
+    const Sampling* sampling;
+    auto& candidate_nodes = FindCandidates(ns_id, &sampling);
+    if (sampling == nullptr) {
       DXERROR("The sampler of namespace: %d is nullptr.", (int)ns_id);
       return false;
     }
 
-    auto k = samplings_[ns_id]->Next();
+    auto k = sampling->Next();
     *next_node = candidate_nodes[k];
 
     return true;
@@ -115,25 +161,75 @@ bool NegativeSamplerBuilder::InitFrequencyFuncs() {
   range_next_func_ = [this](int_t cur_node, int begin, int end,
                             int_t* next_node) -> bool {
     auto ns_id = io_util::GetNodeType(cur_node);
-    auto& candidate_nodes = sampler_source_.nodes_list()[ns_id];
-    if (!samplings_[ns_id]) {
+    const Sampling* sampling;
+    auto& candidate_nodes = FindCandidates(ns_id, &sampling);
+    if (sampling == nullptr) {
       DXERROR("The sampler of namespace: %d is nullptr.", (int)ns_id);
       return false;
     }
 
-    auto k = samplings_[ns_id]->Next(begin, end);
+    auto k = sampling->Next(begin, end);
     *next_node = candidate_nodes[k];
     return true;
   };
 
+  next_n_func_ = [this](int_t cur_node, int count,
+                        vec_int_t* next_nodes) -> bool {
+    auto ns_id = io_util::GetNodeType(cur_node);
+    const Sampling* sampling;
+    auto& candidate_nodes = FindCandidates(ns_id, &sampling);
+    if (sampling == nullptr) {
+      DXERROR("The sampler of namespace: %d is nullptr.", (int)ns_id);
+      return false;
+    }
+
+    sampling->NextN(count, next_nodes);
+    for (auto& next_node : *next_nodes) {
+      next_node = candidate_nodes[next_node];
+    }
+    return true;
+  };
+
   DXINFO("Done.");
   return true;
 }
 
+bool NegativeSamplerBuilder::UpdateNamespace(uint16_t ns_id,
+                                             const vec_int_t& nodes,
+                                             const vec_float_t& freqs,
+                                             uint64_t epoch) {
+  NsTable table;
+  table.nodes = nodes;
+  if (sampling_type_ != (int)SamplingEnum::UNIFORM && !nodes.empty()) {
+    vec_float_t norm_probs;
+    NormalizeProbs(freqs, freq_power_, &norm_probs);
+    table.sampling = NewSampling(&norm_probs, (SamplingEnum)sampling_type_);
+    if (!table.sampling) {
+      return false;
+    }
+  }
+
+  ns_delta_.Put(ns_id, std::move(table), epoch);
+  return true;
+}
+
+const vec_int_t& NegativeSamplerBuilder::FindCandidates(
+    uint16_t ns_id, const Sampling** sampling) const {
+  const NsTable* table;
+  if (!ns_delta_.empty() && ns_delta_.Find(ns_id, ReadEpoch(), &table)) {
+    *sampling = table->sampling.get();
+    return table->nodes;
+  }
+
+  *sampling = ns_id < samplings_.size() ? samplings_[ns_id].get() : nullptr;
+  return sampler_source_.nodes_list()[ns_id];
+}
+
 std::unique_ptr<SamplerBuilder> NewNegativeSamplerBuilder(
-    const SamplerSource* sampler_source, int sampler_type, int thread_num) {
+    const SamplerSource* sampler_source, int sampler_type, int thread_num,
+    float_t freq_power) {
   return NegativeSamplerBuilder::Create(sampler_source, sampler_type,
-                                        thread_num);
+                                        thread_num, freq_power);
 }
 
 }  // namespace embedx
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "src/common/data_types.h"
+#include "src/common/versioned_map.h"
 #include "src/sampler/sampler_builder.h"
 #include "src/sampler/sampler_source.h"
 #include "src/sampler/sampling.h"
@@ -24,24 +25,45 @@ namespace embedx {
 class NegativeSamplerBuilder : public SamplerBuilder {
  private:
   std::mutex mtx_;
+  // distortion exponent of frequencies
+  float_t freq_power_ = 0.75;
   std::vector<std::unique_ptr<Sampling>> samplings_;
 
+  // candidates of a namespace updated by UpdateNamespace, 'sampling' is
+  // nullptr for uniform sampling
+  struct NsTable {
+    vec_int_t nodes;
+    std::unique_ptr<Sampling> sampling;
+  };
+  VersionedMap<NsTable> ns_delta_;
+
  public:
   ~NegativeSamplerBuilder() override = default;
 
  public:
   static std::unique_ptr<SamplerBuilder> Create(
-      const SamplerSource* sampler_source, int sampler_type, int thread_num);
+      const SamplerSource* sampler_source, int sampler_type, int thread_num,
+      float_t freq_power);
+
+ public:
+  bool UpdateNamespace(uint16_t ns_id, const vec_int_t& nodes,
+                       const vec_float_t& freqs, uint64_t epoch) override;
+  void Discard(uint64_t epoch) override { ns_delta_.Discard(epoch); }
+  void Reclaim(uint64_t safe_epoch) override { ns_delta_.Reclaim(safe_epoch); }
 
  private:
   bool InitUniformFuncs() override;
   bool InitFrequencySampler() override;
   bool InitFrequencyFuncs() override;
 
+  const vec_int_t& FindCandidates(uint16_t ns_id,
+                                  const Sampling** sampling) const;
+
  private:
   NegativeSamplerBuilder(const SamplerSource* sampler_source, int sampler_type,
-                         int thread_num)
-      : SamplerBuilder(sampler_source, sampler_type, thread_num) {}
+                         int thread_num, float_t freq_power)
+      : SamplerBuilder(sampler_source, sampler_type, thread_num),
+        freq_power_(freq_power) {}
 };
 
 }  // namespace embedx
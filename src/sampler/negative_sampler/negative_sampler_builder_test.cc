@@ -71,4 +71,27 @@ TEST_F(NegativeSamplerBuilderTest, Next) {
   EXPECT_TRUE(it != node_keys.end());
 }
 
+TEST_F(NegativeSamplerBuilderTest, NextN_CompactAlias) {
+  sampler_source_ =
+      NewMockSamplerSource(USER_ITEM_CONTEXT, USER_ITEM_CONFIG, THREAD_NUM);
+  EXPECT_TRUE(sampler_source_ != nullptr);
+
+  for (float_t freq_power : {(float_t)0.75, (float_t)0.5, (float_t)1.0}) {
+    sampler_builder_ = NewSamplerBuilder(
+        sampler_source_.get(), SamplerBuilderEnum::NEGATIVE_SAMPLER,
+        (int)SamplingEnum::COMPACT_ALIAS, THREAD_NUM, freq_power);
+    ASSERT_TRUE(sampler_builder_ != nullptr);
+
+    vec_int_t next_nodes;
+    EXPECT_TRUE(sampler_builder_->NextN(0, 100, &next_nodes));
+    EXPECT_EQ(next_nodes.size(), 100u);
+    const auto& node_keys = sampler_source_->node_keys();
+    for (auto next : next_nodes) {
+      auto it = std::find_if(node_keys.begin(), node_keys.end(),
+                             [next](const int_t node) { return node == next; });
+      EXPECT_TRUE(it != node_keys.end());
+    }
+  }
+}
+
 }  // namespace embedx
@@ -11,11 +11,13 @@
 //
 
 #pragma once
-#include <memory>  // std::unique_ptr
+#include <memory>   // std::unique_ptr
+#include <utility>  // std::pair
 #include <vector>
 
 #include "src/common/data_types.h"
 #include "src/sampler/sampler_builder.h"
+#include "src/sampler/time_window.h"
 
 namespace embedx {
 
@@ -29,15 +31,29 @@ class NeighborSampler {
 
  public:
   bool Sample(int count, const vec_int_t& nodes,
+              std::vector<vec_int_t>* neighbor_nodes_list) const {
+    return Sample(count, nodes, TimeWindow(), neighbor_nodes_list);
+  }
+  // Samples among the edges in 'window' of temporal contexts, which needs
+  // a neighbor sampler with ranges, UNIFORM or PARTIAL_SUM.
+  bool Sample(int count, const vec_int_t& nodes, const TimeWindow& window,
               std::vector<vec_int_t>* neighbor_nodes_list) const;
 
  private:
-  void DoSampling(int_t node, int count, vec_int_t* neighbor_nodes) const;
-  void FullSampling(int_t node, vec_int_t* neighbor_nodes) const;
-  void NoReplacementSampling(int_t node, int count,
-                             vec_int_t* neighbor_nodes) const;
-  void WithReplacementSampling(int_t node, int count,
-                               vec_int_t* neighbor_nodes) const;
+  using bound_t = std::pair<int, int>;
+
+  void DoSampling(int_t node, int count, const TimeWindow& window,
+                  vec_int_t* neighbor_nodes) const;
+  void FullSampling(const vec_pair_t& context, const bound_t& bound,
+                    vec_int_t* neighbor_nodes) const;
+  bool UniqueSampling(const vec_pair_t& context, const bound_t& bound,
+                      int count, vec_int_t* neighbor_nodes) const;
+  void NoReplacementSampling(int_t node, int count, const bound_t& bound,
+                             bool full, vec_int_t* neighbor_nodes) const;
+  void WithReplacementSampling(int_t node, int count, const bound_t& bound,
+                               bool full, vec_int_t* neighbor_nodes) const;
+  void Next(int_t node, const bound_t& bound, bool full,
+            int_t* next_node) const;
 };
 
 std::unique_ptr<NeighborSampler> NewNeighborSampler(
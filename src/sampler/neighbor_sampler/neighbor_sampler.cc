@@ -20,14 +20,18 @@
 namespace embedx {
 
 bool NeighborSampler::Sample(
-    int count, const vec_int_t& nodes,
+    int count, const vec_int_t& nodes, const TimeWindow& window,
     std::vector<vec_int_t>* neighbor_nodes_list) const {
+  if (!CheckTimeWindow(window, sampler_builder_.sampling_type())) {
+    return false;
+  }
+
   neighbor_nodes_list->clear();
   neighbor_nodes_list->resize(nodes.size());
 
   int empty_node_num = 0;
   for (size_t i = 0; i < nodes.size(); ++i) {
-    DoSampling(nodes[i], count, &(*neighbor_nodes_list)[i]);
+    DoSampling(nodes[i], count, window, &(*neighbor_nodes_list)[i]);
     if ((*neighbor_nodes_list)[i].empty()) {
       empty_node_num += 1;
     }
@@ -38,41 +42,74 @@ bool NeighborSampler::Sample(
 }
 
 void NeighborSampler::DoSampling(int_t node, int count,
+                                 const TimeWindow& window,
                                  vec_int_t* neighbor_nodes) const {
-  const auto* context = sampler_builder_.sampler_source().FindContext(node);
-  DXCHECK(context != nullptr);
-  int neighbor_size = (int)context->size();
+  neighbor_nodes->clear();
+
+  const auto& sampler_source = sampler_builder_.sampler_source();
+  const auto* context = sampler_source.FindContext(node);
+  // removed by an update
+  if (context == nullptr) {
+    return;
+  }
+
+  bound_t bound(0, (int)context->size());
+  const auto* timestamps = sampler_source.FindTimestamps(node);
+  if (timestamps != nullptr) {
+    FindTimeBound(*timestamps, window, &bound);
+  }
+  bool full = bound.first == 0 && bound.second == (int)context->size();
+  int neighbor_size = bound.second - bound.first;
+  if (neighbor_size == 0) {
+    return;
+  }
 
   if (count < 0 || count == neighbor_size) {
-    FullSampling(node, neighbor_nodes);
+    FullSampling(*context, bound, neighbor_nodes);
   } else if (count < neighbor_size) {
-    NoReplacementSampling(node, count, neighbor_nodes);
+    // temporal contexts may repeat neighbors
+    if (timestamps != nullptr &&
+        UniqueSampling(*context, bound, count, neighbor_nodes)) {
+      return;
+    }
+    NoReplacementSampling(node, count, bound, full, neighbor_nodes);
   } else {
-    WithReplacementSampling(node, count, neighbor_nodes);
+    WithReplacementSampling(node, count, bound, full, neighbor_nodes);
   }
 }
 
-void NeighborSampler::FullSampling(int_t node,
+void NeighborSampler::FullSampling(const vec_pair_t& context,
+                                   const bound_t& bound,
                                    vec_int_t* neighbor_nodes) const {
-  neighbor_nodes->clear();
+  for (int i = bound.first; i < bound.second; ++i) {
+    neighbor_nodes->emplace_back(context[i].first);
+  }
+}
 
-  const auto* context = sampler_builder_.sampler_source().FindContext(node);
-  if (context == nullptr) {
-    return;
+bool NeighborSampler::UniqueSampling(const vec_pair_t& context,
+                                     const bound_t& bound, int count,
+                                     vec_int_t* neighbor_nodes) const {
+  set_int_t node_set;
+  for (int i = bound.first; i < bound.second; ++i) {
+    if (node_set.insert(context[i].first).second) {
+      neighbor_nodes->emplace_back(context[i].first);
+    }
   }
 
-  for (const auto& pair : *context) {
-    neighbor_nodes->emplace_back(pair.first);
+  // not enough unique neighbors to sample from, take them all
+  if ((int)neighbor_nodes->size() <= count) {
+    return true;
   }
+  neighbor_nodes->clear();
+  return false;
 }
 
 void NeighborSampler::NoReplacementSampling(int_t node, int count,
+                                            const bound_t& bound, bool full,
                                             vec_int_t* neighbor_nodes) const {
-  neighbor_nodes->clear();
-
   int_t next_node;
   while (neighbor_nodes->size() < (size_t)count) {
-    DXCHECK(sampler_builder_.Next(node, &next_node));
+    Next(node, bound, full, &next_node);
     // o(n) !!!
     auto it = std::find_if(neighbor_nodes->begin(), neighbor_nodes->end(),
                            [next_node](int_t neighbor_node) {
@@ -85,16 +122,24 @@ void NeighborSampler::NoReplacementSampling(int_t node, int count,
 }
 
 void NeighborSampler::WithReplacementSampling(int_t node, int count,
+                                              const bound_t& bound, bool full,
                                               vec_int_t* neighbor_nodes) const {
-  neighbor_nodes->clear();
-
   int_t next_node;
   for (int i = 0; i < count; ++i) {
-    DXCHECK(sampler_builder_.Next(node, &next_node));
+    Next(node, bound, full, &next_node);
     neighbor_nodes->emplace_back(next_node);
   }
 }
 
+void NeighborSampler::Next(int_t node, const bound_t& bound, bool full,
+                           int_t* next_node) const {
+  if (full) {
+    DXCHECK(sampler_builder_.Next(node, next_node));
+  } else {
+    DXCHECK(sampler_builder_.Next(node, bound.first, bound.second, next_node));
+  }
+}
+
 std::unique_ptr<NeighborSampler> NewNeighborSampler(
     const SamplerBuilder* sampler_builder) {
   std::unique_ptr<NeighborSampler> sampler;
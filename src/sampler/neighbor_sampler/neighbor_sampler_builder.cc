@@ -15,16 +15,17 @@
 #include <deepx_core/dx_log.h>
 
 #include <cinttypes>  // PRIu64
+#include <utility>    // std::move
 
+#include "src/common/epoch.h"
 #include "src/common/random.h"
 #include "src/io/io_util.h"
 
 namespace embedx {
 namespace {
 
-bool NormNeighborProb(const SamplerSource& sampler_source, int_t node,
+bool NormNeighborProb(int_t node, const vec_pair_t* context,
                       vec_float_t* probs) {
-  const auto* context = sampler_source.FindContext(node);
   if (context == nullptr) {
     DXERROR("Couldn't find node: %" PRIu64 " context.", node);
     return false;
@@ -73,7 +74,7 @@ bool NeighborSamplerBuilder::InitUniformFuncs() {
     if (context == nullptr) {
       return false;
     }
-    int k = int(ThreadLocalRandom() * context->size());
+    int k = (int)ThreadLocalRandomEngine().NextInt((uint32_t)context->size());
     *next_node = (*context)[k].first;
     return true;
   };
@@ -84,7 +85,7 @@ bool NeighborSamplerBuilder::InitUniformFuncs() {
     if (context == nullptr) {
       return false;
     }
-    int k = begin + int(ThreadLocalRandom() * (end - begin));
+    int k = begin + (int)ThreadLocalRandomEngine().NextInt(end - begin);
     *next_node = (*context)[k].first;
     return true;
   };
@@ -122,13 +123,13 @@ bool NeighborSamplerBuilder::InitFrequencyFuncs() {
       return false;
     }
 
-    auto it = sampling_map_.find(cur_node);
-    if (it == sampling_map_.end()) {
+    const auto* sampling = FindSampling(cur_node);
+    if (sampling == nullptr) {
       DXERROR("Couldn't find node: %" PRIu64 " sampler.", cur_node);
       return false;
     }
 
-    int k = int(it->second->Next());
+    int k = int(sampling->Next());
     *next_node = (*context)[k].first;
     return true;
   };
@@ -141,13 +142,13 @@ bool NeighborSamplerBuilder::InitFrequencyFuncs() {
       return false;
     }
 
-    auto it = sampling_map_.find(cur_node);
-    if (it == sampling_map_.end()) {
+    const auto* sampling = FindSampling(cur_node);
+    if (sampling == nullptr) {
       DXERROR("Couldn't find node: %" PRIu64 " sampler.", cur_node);
       return false;
     }
 
-    int k = int(it->second->Next(begin, end));
+    int k = int(sampling->Next(begin, end));
     *next_node = (*context)[k].first;
     return true;
   };
@@ -162,7 +163,8 @@ bool NeighborSamplerBuilder::InitEntry(const vec_int_t& nodes, int thread_id) {
   vec_float_t norm_probs;
   // more namespace
   for (const auto& node : nodes) {
-    if (!NormNeighborProb(sampler_source_, node, &norm_probs)) {
+    if (!NormNeighborProb(node, sampler_source_.FindContext(node),
+                          &norm_probs)) {
       return false;
     }
 
@@ -178,6 +180,42 @@ bool NeighborSamplerBuilder::InitEntry(const vec_int_t& nodes, int thread_id) {
   return true;
 }
 
+bool NeighborSamplerBuilder::UpdateNode(int_t node, const vec_pair_t* context,
+                                        uint64_t epoch) {
+  // uniform sampling reads contexts only
+  if (sampling_type_ == (int)SamplingEnum::UNIFORM) {
+    return true;
+  }
+
+  if (context == nullptr || context->empty()) {
+    sampling_delta_.Erase(node, epoch);
+    return true;
+  }
+
+  vec_float_t norm_probs;
+  if (!NormNeighborProb(node, context, &norm_probs)) {
+    return false;
+  }
+
+  auto sampling = NewSampling(&norm_probs, (SamplingEnum)sampling_type_);
+  if (!sampling) {
+    return false;
+  }
+  sampling_delta_.Put(node, std::move(sampling), epoch);
+  return true;
+}
+
+const Sampling* NeighborSamplerBuilder::FindSampling(int_t node) const {
+  const std::unique_ptr<Sampling>* sampling;
+  if (!sampling_delta_.empty() &&
+      sampling_delta_.Find(node, ReadEpoch(), &sampling)) {
+    return sampling == nullptr ? nullptr : sampling->get();
+  }
+
+  auto it = sampling_map_.find(node);
+  return it == sampling_map_.end() ? nullptr : it->second.get();
+}
+
 std::unique_ptr<SamplerBuilder> NewNeighborSamplerBuilder(
     const SamplerSource* sampler_source, int sampler_type, int thread_num) {
   return NeighborSamplerBuilder::Create(sampler_source, sampler_type,
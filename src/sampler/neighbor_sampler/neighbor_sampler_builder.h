@@ -16,6 +16,7 @@
 #include <unordered_map>
 
 #include "src/common/data_types.h"
+#include "src/common/versioned_map.h"
 #include "src/sampler/sampler_builder.h"
 #include "src/sampler/sampler_source.h"
 #include "src/sampler/sampling.h"
@@ -26,6 +27,8 @@ class NeighborSamplerBuilder : public SamplerBuilder {
  private:
   std::mutex mtx_;
   std::unordered_map<int_t, std::unique_ptr<Sampling>> sampling_map_;
+  // samplings of updated nodes, nullptr for removed nodes
+  VersionedMap<std::unique_ptr<Sampling>> sampling_delta_;
 
  public:
   ~NeighborSamplerBuilder() override = default;
@@ -34,12 +37,21 @@ class NeighborSamplerBuilder : public SamplerBuilder {
   static std::unique_ptr<SamplerBuilder> Create(
       const SamplerSource* sampler_source, int sampler_type, int thread_num);
 
+ public:
+  bool UpdateNode(int_t node, const vec_pair_t* context,
+                  uint64_t epoch) override;
+  void Discard(uint64_t epoch) override { sampling_delta_.Discard(epoch); }
+  void Reclaim(uint64_t safe_epoch) override {
+    sampling_delta_.Reclaim(safe_epoch);
+  }
+
  private:
   bool InitUniformFuncs() override;
   bool InitFrequencySampler() override;
   bool InitFrequencyFuncs() override;
 
   bool InitEntry(const vec_int_t& nodes, int thread_id);
+  const Sampling* FindSampling(int_t node) const;
 
  private:
   NeighborSamplerBuilder(const SamplerSource* sampler_source, int sampler_type,
@@ -22,6 +22,7 @@
 #include "src/sampler/sampler_builder.h"
 #include "src/sampler/sampler_source.h"
 #include "src/sampler/sampling.h"
+#include "src/sampler/time_window.h"
 
 namespace embedx {
 
@@ -33,6 +34,7 @@ class NeighborSamplerTest : public ::testing::Test {
 
  protected:
   const std::string CONTEXT = "testdata/context";
+  const std::string TEMPORAL_CONTEXT = "testdata/temporal_context";
   const int THREAD_NUM = 3;
 
  protected:
@@ -113,4 +115,54 @@ TEST_F(NeighborSamplerTest, Frequency_Sample) {
   }
 }
 
+TEST_F(NeighborSamplerTest, TimeWindow_Sample) {
+  // node 0: 2:1:10 3:1:20 1:1:30 1:1:40
+  sampler_source_ = NewMockSamplerSource(TEMPORAL_CONTEXT, "", THREAD_NUM);
+  ASSERT_TRUE(sampler_source_ != nullptr);
+  sampler_builder_ = NewSamplerBuilder(sampler_source_.get(),
+                                       SamplerBuilderEnum::NEIGHBOR_SAMPLER,
+                                       (int)SamplingEnum::UNIFORM, THREAD_NUM);
+  neighbor_sampler_.reset(new NeighborSampler(sampler_builder_.get()));
+  vec_int_t nodes = {0};
+  std::vector<vec_int_t> neighbor_nodes_list;
+
+  TimeWindow window;
+  window.type = (int)TimeWindowEnum::BEFORE;
+  window.timestamp = 30;
+  EXPECT_TRUE(
+      neighbor_sampler_->Sample(-1, nodes, window, &neighbor_nodes_list));
+  EXPECT_EQ(neighbor_nodes_list[0], vec_int_t({2, 3}));
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(
+        neighbor_sampler_->Sample(5, nodes, window, &neighbor_nodes_list));
+    EXPECT_EQ(neighbor_nodes_list[0].size(), 5u);
+    for (auto node : neighbor_nodes_list[0]) {
+      EXPECT_TRUE(node == 2 || node == 3);
+    }
+  }
+
+  // the latest edges repeat neighbor 1
+  window.type = (int)TimeWindowEnum::RECENT;
+  window.timestamp = 100;
+  window.recent_num = 2;
+  EXPECT_TRUE(
+      neighbor_sampler_->Sample(1, nodes, window, &neighbor_nodes_list));
+  EXPECT_EQ(neighbor_nodes_list[0], vec_int_t({1}));
+
+  // nothing before
+  window.type = (int)TimeWindowEnum::BEFORE;
+  window.timestamp = 10;
+  EXPECT_FALSE(
+      neighbor_sampler_->Sample(3, nodes, window, &neighbor_nodes_list));
+
+  // alias sampling has no ranges
+  sampler_builder_ = NewSamplerBuilder(sampler_source_.get(),
+                                       SamplerBuilderEnum::NEIGHBOR_SAMPLER,
+                                       (int)SamplingEnum::ALIAS, THREAD_NUM);
+  neighbor_sampler_.reset(new NeighborSampler(sampler_builder_.get()));
+  EXPECT_FALSE(
+      neighbor_sampler_->Sample(3, nodes, window, &neighbor_nodes_list));
+}
+
 }  // namespace embedx
@@ -14,7 +14,8 @@
 
 #include <deepx_core/dx_log.h>
 
-#include <utility>  // std::pair
+#include <cinttypes>  // PRIu64
+#include <utility>    // std::pair
 
 #include "src/io/io_util.h"
 #include "src/sampler/random_walker/random_walker_util.h"
@@ -35,7 +36,7 @@ void StaticRandomWalkerImpl::Traverse(const vec_int_t& cur_nodes,
                                       std::vector<vec_int_t>* seqs,
                                       PrevInfo* /*prev_info*/) const {
   if (walker_info.meta_path.empty()) {
-    Traverse(cur_nodes, walk_lens, seqs);
+    Traverse(cur_nodes, walk_lens, walker_info.time_window, seqs);
   } else {
     MetaPathTraverse(cur_nodes, walk_lens, walker_info, seqs);
   }
@@ -43,6 +44,7 @@ void StaticRandomWalkerImpl::Traverse(const vec_int_t& cur_nodes,
 
 void StaticRandomWalkerImpl::Traverse(const vec_int_t& cur_nodes,
                                       const std::vector<int>& walk_lens,
+                                      const TimeWindow& window,
                                       std::vector<vec_int_t>* seqs) const {
   seqs->clear();
   seqs->resize(cur_nodes.size());
@@ -50,7 +52,7 @@ void StaticRandomWalkerImpl::Traverse(const vec_int_t& cur_nodes,
   for (size_t i = 0; i < cur_nodes.size(); ++i) {
     auto cur_node = cur_nodes[i];
     for (int j = 0; j < walk_lens[i]; ++j) {
-      if (neighbor_sampler_builder_.Next(cur_node, &next_node)) {
+      if (Next(cur_node, window, &next_node)) {
         (*seqs)[i].emplace_back(next_node);
         cur_node = next_node;
       } else {
@@ -60,6 +62,23 @@ void StaticRandomWalkerImpl::Traverse(const vec_int_t& cur_nodes,
   }
 }
 
+bool StaticRandomWalkerImpl::Next(int_t cur_node, const TimeWindow& window,
+                                  int_t* next_node) const {
+  const auto* timestamps =
+      neighbor_sampler_builder_.sampler_source().FindTimestamps(cur_node);
+  if (timestamps == nullptr || window.type == (int)TimeWindowEnum::ALL) {
+    return neighbor_sampler_builder_.Next(cur_node, next_node);
+  }
+
+  std::pair<int, int> bound;
+  FindTimeBound(*timestamps, window, &bound);
+  if (bound.first == bound.second) {
+    return false;
+  }
+  return neighbor_sampler_builder_.Next(cur_node, bound.first, bound.second,
+                                        next_node);
+}
+
 void StaticRandomWalkerImpl::MetaPathTraverse(
     const vec_int_t& cur_nodes, const std::vector<int>& walk_lens,
     const WalkerInfo& walker_info, std::vector<vec_int_t>* seqs) const {
@@ -92,6 +111,15 @@ bool StaticRandomWalkerImpl::MetaPathNext(const meta_path_t& meta_path,
     return false;
   }
 
+  // temporal contexts are sorted by time, not by namespace
+  if (neighbor_sampler_builder_.sampler_source().FindTimestamps(cur_node) !=
+      nullptr) {
+    DXERROR("Couldn't walk meta path from node: %" PRIu64
+            " with timestamps.",
+            cur_node);
+    return false;
+  }
+
   uint16_t expected_next_type = meta_path[(cur_index + 1) % meta_path.size()];
 
   std::pair<int, int> bound;
@@ -39,7 +39,8 @@ class StaticRandomWalkerImpl : public RandomWalkerImpl {
 
  private:
   void Traverse(const vec_int_t& cur_nodes, const std::vector<int>& walk_lens,
-                std::vector<vec_int_t>* seqs) const;
+                const TimeWindow& window, std::vector<vec_int_t>* seqs) const;
+  bool Next(int_t cur_node, const TimeWindow& window, int_t* next_node) const;
   void MetaPathTraverse(const vec_int_t& cur_nodes,
                         const std::vector<int>& walk_lens,
                         const WalkerInfo& walker_info,
@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "src/common/data_types.h"
+#include "src/sampler/time_window.h"
 
 namespace embedx {
 
@@ -38,6 +39,9 @@ struct WalkerInfo {
 
   // dynamic
   PrevInfo prev_info;
+
+  // temporal, each step samples among the edges in it
+  TimeWindow time_window;
 };
 
 }  // namespace embedx
@@ -28,11 +28,12 @@ bool SamplerBuilder::Init() {
 std::unique_ptr<SamplerBuilder> NewNeighborSamplerBuilder(
     const SamplerSource* sampler_source, int sampler_type, int thread_num);
 std::unique_ptr<SamplerBuilder> NewNegativeSamplerBuilder(
-    const SamplerSource* sampler_source, int sampler_type, int thread_num);
+    const SamplerSource* sampler_source, int sampler_type, int thread_num,
+    float_t freq_power);
 
 std::unique_ptr<SamplerBuilder> NewSamplerBuilder(
     const SamplerSource* sampler_source, SamplerBuilderEnum type,
-    int sampler_type, int thread_num) {
+    int sampler_type, int thread_num, float_t freq_power) {
   std::unique_ptr<SamplerBuilder> sampler_builder;
   switch (type) {
     case SamplerBuilderEnum::NEIGHBOR_SAMPLER:
@@ -40,8 +41,8 @@ std::unique_ptr<SamplerBuilder> NewSamplerBuilder(
           NewNeighborSamplerBuilder(sampler_source, sampler_type, thread_num);
       break;
     case SamplerBuilderEnum::NEGATIVE_SAMPLER:
-      sampler_builder =
-          NewNegativeSamplerBuilder(sampler_source, sampler_type, thread_num);
+      sampler_builder = NewNegativeSamplerBuilder(sampler_source, sampler_type,
+                                                  thread_num, freq_power);
       break;
     default:
       DXERROR(
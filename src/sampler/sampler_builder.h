@@ -11,6 +11,7 @@
 //
 
 #pragma once
+#include <cstdint>
 #include <functional>
 #include <memory>  // std::unique_ptr
 
@@ -29,6 +30,9 @@ class SamplerBuilder {
   std::function<bool(int_t cur_node, int_t* next_node)> next_func_;
   std::function<bool(int_t cur_node, int begin, int end, int_t* next_node)>
       range_next_func_;
+  // optional, draws 'count' nodes at once
+  std::function<bool(int_t cur_node, int count, vec_int_t* next_nodes)>
+      next_n_func_;
 
  public:
   SamplerBuilder(const SamplerSource* sampler_source, int sampling_type,
@@ -41,10 +45,30 @@ class SamplerBuilder {
  public:
   virtual bool Init();
 
+ public:
+  // Updates of a running graph, visible to readers pinning 'epoch' or a later
+  // one. The caller serializes them, see UpdateBuilder.
+  //
+  // 'context' is the new context of 'node', nullptr if it is removed.
+  virtual bool UpdateNode(int_t /*node*/, const vec_pair_t* /*context*/,
+                          uint64_t /*epoch*/) {
+    return true;
+  }
+  // 'nodes' and 'freqs' are all the nodes of namespace 'ns_id'.
+  virtual bool UpdateNamespace(uint16_t /*ns_id*/, const vec_int_t& /*nodes*/,
+                               const vec_float_t& /*freqs*/,
+                               uint64_t /*epoch*/) {
+    return true;
+  }
+  // Drops the updates at 'epoch' before it is published.
+  virtual void Discard(uint64_t /*epoch*/) {}
+  virtual void Reclaim(uint64_t /*safe_epoch*/) {}
+
  public:
   const SamplerSource& sampler_source() const noexcept {
     return sampler_source_;
   }
+  int sampling_type() const noexcept { return sampling_type_; }
 
  public:
   bool Next(int_t cur_node, int_t* next_node) const noexcept {
@@ -56,6 +80,20 @@ class SamplerBuilder {
     return range_next_func_(cur_node, begin, end, next_node);
   }
 
+  bool NextN(int_t cur_node, int count, vec_int_t* next_nodes) const {
+    if (next_n_func_) {
+      return next_n_func_(cur_node, count, next_nodes);
+    }
+
+    next_nodes->resize(count);
+    for (int i = 0; i < count; ++i) {
+      if (!next_func_(cur_node, &(*next_nodes)[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
  protected:
   virtual bool InitUniformFuncs() = 0;
   virtual bool InitFrequencySampler() = 0;
@@ -67,8 +105,10 @@ enum class SamplerBuilderEnum : int {
   NEGATIVE_SAMPLER = 1,
 };
 
+// 'freq_power' is the distortion exponent of the frequencies of negative
+// sampling, the neighbor sampler ignores it.
 std::unique_ptr<SamplerBuilder> NewSamplerBuilder(
     const SamplerSource* sampler_source, SamplerBuilderEnum type,
-    int sampler_type, int thread_num);
+    int sampler_type, int thread_num, float_t freq_power = 0.75);
 
 }  // namespace embedx
@@ -31,6 +31,11 @@ class SamplerSource {
   virtual const std::vector<vec_float_t>& freqs_list() const noexcept = 0;
   virtual const vec_int_t& node_keys() const noexcept = 0;
   virtual const vec_pair_t* FindContext(int_t node) const = 0;
+  // Timestamps of the context of 'node' sorted by time, nullptr if it has
+  // none.
+  virtual const vec_time_t* FindTimestamps(int_t /*node*/) const {
+    return nullptr;
+  }
 };
 
 std::unique_ptr<SamplerSource> NewGraphSamplerSource(
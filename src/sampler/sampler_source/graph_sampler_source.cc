@@ -42,6 +42,9 @@ class GraphSamplerSource : public SamplerSource {
   const vec_pair_t* FindContext(int_t node) const override {
     return graph_.FindContext(node);
   }
+  const vec_time_t* FindTimestamps(int_t node) const override {
+    return graph_.FindTimestamps(node);
+  }
 };
 
 std::unique_ptr<SamplerSource> NewGraphSamplerSource(
@@ -61,6 +61,9 @@ class MockSamplerSource : public SamplerSource {
   const vec_pair_t* FindContext(int_t node) const override {
     return context_loader_->storage()->FindNeighbor(node);
   }
+  const vec_time_t* FindTimestamps(int_t node) const override {
+    return context_loader_->storage()->FindTimestamps(node);
+  }
 
  private:
   void Clear();
@@ -23,13 +23,21 @@ class Sampling {
  public:
   virtual int_t Next() const noexcept = 0;
   virtual int_t Next(int begin, int end) const noexcept = 0;
+  // Draws 'count' indices at once into 'next'.
+  virtual void NextN(int count, vec_int_t* next) const {
+    next->resize(count);
+    for (int i = 0; i < count; ++i) {
+      (*next)[i] = Next();
+    }
+  }
 };
 
 enum class SamplingEnum : int {
   UNIFORM = 0,
   ALIAS = 1,
   WORD2VEC = 2,
-  PARTIAL_SUM = 3
+  PARTIAL_SUM = 3,
+  COMPACT_ALIAS = 4
 };
 
 std::unique_ptr<Sampling> NewSampling(const vec_float_t* probs,
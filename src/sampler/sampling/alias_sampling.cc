@@ -57,8 +57,9 @@ std::unique_ptr<Sampling> AliasSampling::Create(const vec_float_t& probs) {
 
 int_t AliasSampling::Next() const noexcept {
   size_t table_size = alias_probs_.size();
-  auto k = int_t(ThreadLocalRandom() * table_size);
-  if (ThreadLocalRandom() < alias_probs_[k]) {
+  auto& engine = ThreadLocalRandomEngine();
+  auto k = int_t(engine.NextDouble() * table_size);
+  if (engine.NextDouble() < alias_probs_[k]) {
     return k;
   } else {
     return alias_tables_[k];
@@ -0,0 +1,153 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::min
+#include <cstdint>
+#include <memory>  // std::unique_ptr
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/common/random.h"
+#include "src/sampler/sampling.h"
+
+namespace embedx {
+
+// CompactAliasSampling is an alias table of 8 bytes per entry, 32-bit aliases
+// and float probabilities, built in O(n) without sorting.
+//
+// A draw takes one random number, its integral part picks the bucket and its
+// fractional part decides between the bucket and its alias.
+class CompactAliasSampling : public Sampling {
+ private:
+  static constexpr size_t MAX_TABLE_SIZE = UINT32_MAX;
+
+  std::vector<float> alias_probs_;
+  std::vector<uint32_t> alias_tables_;
+
+ public:
+  static std::unique_ptr<Sampling> Create(const vec_float_t& probs);
+
+ public:
+  int_t Next() const noexcept override;
+  int_t Next(int begin, int end) const noexcept override;
+  void NextN(int count, vec_int_t* next) const override;
+
+ private:
+  bool Init(const vec_float_t& probs);
+
+  int_t Select(double r) const noexcept {
+    double x = r * alias_probs_.size();
+    auto k = (uint32_t)x;
+    if (k >= alias_probs_.size()) {  // r * size may round up to size
+      k = (uint32_t)alias_probs_.size() - 1;
+    }
+    return (x - k) < alias_probs_[k] ? k : alias_tables_[k];
+  }
+};
+
+constexpr size_t CompactAliasSampling::MAX_TABLE_SIZE;
+
+std::unique_ptr<Sampling> CompactAliasSampling::Create(
+    const vec_float_t& probs) {
+  std::unique_ptr<Sampling> sampling(new CompactAliasSampling);
+  if (!dynamic_cast<CompactAliasSampling*>(sampling.get())->Init(probs)) {
+    DXERROR("Failed to init compact alias sampling.");
+    sampling.reset();
+  }
+  return sampling;
+}
+
+int_t CompactAliasSampling::Next() const noexcept {
+  return Select(ThreadLocalRandomEngine().NextDouble());
+}
+
+int_t CompactAliasSampling::Next(int /*begin*/, int /*end*/) const noexcept {
+  DXERROR("Next with range was not implemented in CompactAliasSampling.");
+  return 0;
+}
+
+void CompactAliasSampling::NextN(int count, vec_int_t* next) const {
+  next->resize(count);
+  auto& engine = ThreadLocalRandomEngine();
+  double r[RandomEngine::BUFFER_SIZE];
+  for (int i = 0; i < count; i += RandomEngine::BUFFER_SIZE) {
+    int n = std::min(count - i, RandomEngine::BUFFER_SIZE);
+    engine.NextDoubles(n, r);
+    for (int j = 0; j < n; ++j) {
+      (*next)[i + j] = Select(r[j]);
+    }
+  }
+}
+
+bool CompactAliasSampling::Init(const vec_float_t& probs) {
+  size_t table_size = probs.size();
+  if (table_size == 0 || table_size > MAX_TABLE_SIZE) {
+    DXERROR("The table size: %zu must be in (0, %zu].", table_size,
+            MAX_TABLE_SIZE);
+    return false;
+  }
+
+  // probs needn't be normalized
+  double sum = 0;
+  for (auto prob : probs) {
+    sum += prob;
+  }
+  if (!(sum > 0)) {
+    DXERROR("The sum of probs: %f must be greater than 0.", sum);
+    return false;
+  }
+  double scale = table_size / sum;
+
+  alias_probs_.resize(table_size);
+  alias_tables_.resize(table_size);
+
+  // smaller buckets from the front and larger ones from the back
+  std::vector<uint32_t> work(table_size);
+  size_t smaller_end = 0;
+  size_t larger_begin = table_size;
+  for (size_t i = 0; i < table_size; ++i) {
+    alias_probs_[i] = (float)(scale * probs[i]);
+    alias_tables_[i] = (uint32_t)i;
+    if (alias_probs_[i] < 1.0f) {
+      work[smaller_end++] = (uint32_t)i;
+    } else {
+      work[--larger_begin] = (uint32_t)i;
+    }
+  }
+
+  while (smaller_end > 0 && larger_begin < table_size) {
+    uint32_t s = work[--smaller_end];
+    uint32_t l = work[larger_begin];
+    alias_tables_[s] = l;
+    alias_probs_[l] += alias_probs_[s] - 1.0f;
+    if (alias_probs_[l] < 1.0f) {
+      ++larger_begin;
+      work[smaller_end++] = l;
+    }
+  }
+
+  // leftovers of rounding errors are full buckets
+  for (size_t i = 0; i < smaller_end; ++i) {
+    alias_probs_[work[i]] = 1.0f;
+  }
+  for (size_t i = larger_begin; i < table_size; ++i) {
+    alias_probs_[work[i]] = 1.0f;
+  }
+  return true;
+}
+
+std::unique_ptr<Sampling> NewCompactAliasSampling(const vec_float_t* probs) {
+  return CompactAliasSampling::Create(*probs);
+}
+
+}  // namespace embedx
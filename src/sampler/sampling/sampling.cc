@@ -17,6 +17,7 @@ std::unique_ptr<Sampling> NewUniformSampling(const vec_float_t* probs);
 std::unique_ptr<Sampling> NewAliasSampling(const vec_float_t* probs);
 std::unique_ptr<Sampling> NewWord2vecSampling(const vec_float_t* probs);
 std::unique_ptr<Sampling> NewPartialSumSampling(const vec_float_t* probs);
+std::unique_ptr<Sampling> NewCompactAliasSampling(const vec_float_t* probs);
 
 std::unique_ptr<Sampling> NewSampling(const vec_float_t* probs,
                                       SamplingEnum type) {
@@ -34,10 +35,13 @@ std::unique_ptr<Sampling> NewSampling(const vec_float_t* probs,
     case SamplingEnum::PARTIAL_SUM:
       sampling = NewPartialSumSampling(probs);
       break;
+    case SamplingEnum::COMPACT_ALIAS:
+      sampling = NewCompactAliasSampling(probs);
+      break;
     default:
       DXERROR(
-          "Need type: UNIFORM(0) || ALIAS(1) || WORD2VEC(2) || PARTIAL_SUM(3), "
-          "got type: %d.",
+          "Need type: UNIFORM(0) || ALIAS(1) || WORD2VEC(2) || PARTIAL_SUM(3) "
+          "|| COMPACT_ALIAS(4), got type: %d.",
           (int)type);
       break;
   }
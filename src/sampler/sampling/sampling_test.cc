@@ -97,6 +97,46 @@ TEST_F(SamplingTest, AliasSampling) {
   EXPECT_TRUE(SamplingValidator::Test(normed_distribution_, sampled_nodes_));
 }
 
+TEST_F(SamplingTest, CompactAliasSampling) {
+  sampler_ = NewSampling(&normed_probs_, SamplingEnum::COMPACT_ALIAS);
+  ASSERT_TRUE(sampler_ != nullptr);
+  DoSampling(&sampled_nodes_);
+  EXPECT_TRUE(SamplingValidator::Test(normed_distribution_, sampled_nodes_));
+
+  // unnormalized probs
+  sampler_ = NewSampling(&probs_, SamplingEnum::COMPACT_ALIAS);
+  ASSERT_TRUE(sampler_ != nullptr);
+  DoSampling(&sampled_nodes_);
+  EXPECT_TRUE(SamplingValidator::Test(normed_distribution_, sampled_nodes_));
+
+  vec_float_t empty_probs;
+  EXPECT_TRUE(NewSampling(&empty_probs, SamplingEnum::COMPACT_ALIAS) ==
+              nullptr);
+}
+
+TEST_F(SamplingTest, NextN) {
+  sampler_ = NewSampling(&normed_probs_, SamplingEnum::COMPACT_ALIAS);
+  ASSERT_TRUE(sampler_ != nullptr);
+  vec_int_t next;
+  sampled_nodes_.clear();
+  while (sampled_nodes_.size() < (size_t)count_) {
+    sampler_->NextN(BATCH, &next);
+    ASSERT_EQ(next.size(), (size_t)BATCH);
+    for (auto k : next) {
+      sampled_nodes_.emplace_back(nodes_[k]);
+    }
+  }
+  EXPECT_TRUE(SamplingValidator::Test(normed_distribution_, sampled_nodes_));
+
+  // the default one of Sampling
+  sampler_ = NewSampling(&normed_probs_, SamplingEnum::ALIAS);
+  sampler_->NextN(BATCH, &next);
+  EXPECT_EQ(next.size(), (size_t)BATCH);
+  for (auto k : next) {
+    EXPECT_LT(k, nodes_.size());
+  }
+}
+
 TEST_F(SamplingTest, PartialSumSampling) {
   sampler_ = NewSampling(&normed_probs_, SamplingEnum::PARTIAL_SUM);
   DoSampling(&sampled_nodes_);
@@ -46,7 +46,7 @@ std::unique_ptr<Sampling> UniformSampling::Create(const vec_float_t* probs) {
 int_t UniformSampling::Next() const noexcept { return Next(0, table_size_); }
 
 int_t UniformSampling::Next(int begin, int end) const noexcept {
-  return (int_t)(ThreadLocalRandom() * (end - begin)) + begin;
+  return (int_t)ThreadLocalRandomEngine().NextInt(end - begin) + begin;
 }
 
 bool UniformSampling::Init(const vec_float_t& probs) {
@@ -0,0 +1,88 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::lower_bound, std::max
+#include <cstdint>
+#include <utility>  // std::pair
+
+#include "src/common/data_types.h"
+#include "src/sampler/sampling.h"
+
+namespace embedx {
+
+enum class TimeWindowEnum : int {
+  ALL = 0,     // all the edges
+  BEFORE = 1,  // the edges before 'timestamp'
+  RECENT = 2,  // the 'recent_num' latest edges before 'timestamp'
+};
+
+// TimeWindow restricts sampling to the edges of temporal contexts in it.
+// Contexts without timestamps are not restricted.
+struct TimeWindow {
+  int type = 0;
+  int64_t timestamp = 0;
+  int recent_num = 0;
+};
+
+// Sampling in a window needs a sampling with ranges, see Sampling.
+inline bool CheckTimeWindow(const TimeWindow& window, int sampling_type) {
+  if (window.type < (int)TimeWindowEnum::ALL ||
+      window.type > (int)TimeWindowEnum::RECENT) {
+    DXERROR("Need time window type: ALL(0) || BEFORE(1) || RECENT(2), got "
+            "type: %d.",
+            window.type);
+    return false;
+  }
+
+  if (window.type == (int)TimeWindowEnum::RECENT && window.recent_num <= 0) {
+    DXERROR("Need recent_num > 0, got recent_num: %d.", window.recent_num);
+    return false;
+  }
+
+  if (window.type != (int)TimeWindowEnum::ALL &&
+      sampling_type != (int)SamplingEnum::UNIFORM &&
+      sampling_type != (int)SamplingEnum::PARTIAL_SUM) {
+    DXERROR("Need sampler type: UNIFORM(0) || PARTIAL_SUM(3) for time "
+            "windows, got type: %d.",
+            sampling_type);
+    return false;
+  }
+  return true;
+}
+
+// Finds the range [bound->first, bound->second) of the edges in 'window',
+// 'timestamps' are sorted.
+inline void FindTimeBound(const vec_time_t& timestamps,
+                          const TimeWindow& window,
+                          std::pair<int, int>* bound) {
+  int size = (int)timestamps.size();
+  switch ((TimeWindowEnum)window.type) {
+    case TimeWindowEnum::BEFORE:
+    case TimeWindowEnum::RECENT:
+      bound->second = (int)(std::lower_bound(timestamps.begin(),
+                                             timestamps.end(),
+                                             window.timestamp) -
+                            timestamps.begin());
+      bound->first = window.type == (int)TimeWindowEnum::RECENT
+                         ? std::max(0, bound->second - window.recent_num)
+                         : 0;
+      break;
+    default:
+      bound->first = 0;
+      bound->second = size;
+      break;
+  }
+}
+
+}  // namespace embedx
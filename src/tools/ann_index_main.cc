@@ -0,0 +1,117 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>  // std::min
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "src/ann/hnsw_index.h"
+#include "src/common/data_types.h"
+#include "src/common/random.h"
+
+DEFINE_string(in, "", "Input dir or file of item embeddings from predictor.");
+DEFINE_string(out, "", "Output ann index file.");
+DEFINE_int32(thread_num, 8, "Number of threads.");
+DEFINE_int32(ann_metric, 0, "Metric of ann index, 0 inner product | 1 l2.");
+DEFINE_int32(ann_m, 16, "Number of links of a node on upper levels.");
+DEFINE_int32(ann_ef_construction, 200, "Number of candidates of insertion.");
+DEFINE_int32(ann_eval_num, 0,
+             "Number of sampled items to evaluate the recall with, 0 not.");
+DEFINE_int32(ann_k, 10, "Top k of the evaluation.");
+DEFINE_int32(ann_ef, 64, "Number of candidates of the evaluation.");
+DEFINE_uint64(seed, 9527, "Random seed.");
+
+namespace embedx {
+namespace {
+
+// Recall@k of the index with items themselves as queries.
+void Evaluate(const ann::HnswIndex& index, const vec_int_t& ids,
+              const std::vector<float>& vectors, int dim) {
+  RandomEngine engine(FLAGS_seed, 1);
+  int eval_num = std::min(FLAGS_ann_eval_num, (int)ids.size());
+  int hit = 0, total = 0;
+  std::vector<ann::scored_node_t> nodes, exact_nodes;
+  for (int i = 0; i < eval_num; ++i) {
+    const float* query = vectors.data() + (size_t)(engine() % ids.size()) * dim;
+    index.Search(query, FLAGS_ann_k, FLAGS_ann_ef, &nodes);
+    ann::ExactSearch(ids, vectors, dim, index.metric(), query, FLAGS_ann_k,
+                     &exact_nodes);
+
+    std::unordered_set<int_t> exact_ids;
+    for (const auto& node : exact_nodes) {
+      exact_ids.insert(node.first);
+    }
+    for (const auto& node : nodes) {
+      hit += (int)exact_ids.count(node.first);
+    }
+    total += (int)exact_nodes.size();
+  }
+  DXINFO("Recall@%d of %d items with ef %d: %.4f.", FLAGS_ann_k, eval_num,
+         FLAGS_ann_ef, total > 0 ? (double)hit / total : 0.0);
+}
+
+void CheckFlags() {
+  DXCHECK(!FLAGS_in.empty());
+  DXCHECK(!FLAGS_out.empty());
+  DXCHECK(FLAGS_thread_num > 0);
+  DXCHECK(FLAGS_ann_metric == 0 || FLAGS_ann_metric == 1);
+  DXCHECK(FLAGS_ann_m > 1);
+  DXCHECK(FLAGS_ann_ef_construction > 0);
+  DXCHECK(FLAGS_ann_eval_num >= 0);
+  DXCHECK(FLAGS_ann_k > 0);
+  DXCHECK(FLAGS_ann_ef > 0);
+}
+
+int main(int argc, char** argv) {
+  google::SetUsageMessage("Usage: [Options]");
+#if HAVE_COMPILE_FLAGS_H == 1
+  google::SetVersionString("\n\n"
+#include "compile_flags.h"
+  );
+#endif
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  CheckFlags();
+
+  vec_int_t ids;
+  std::vector<float> vectors;
+  int dim;
+  DXCHECK(
+      ann::LoadEmbedding(FLAGS_in, FLAGS_thread_num, &ids, &vectors, &dim));
+
+  ann::HnswParam param;
+  param.m = FLAGS_ann_m;
+  param.ef_construction = FLAGS_ann_ef_construction;
+  param.metric = (ann::MetricEnum)FLAGS_ann_metric;
+  param.seed = FLAGS_seed;
+  auto index =
+      ann::HnswIndex::Build(ids, vectors, dim, param, FLAGS_thread_num);
+  DXCHECK(index);
+
+  if (FLAGS_ann_eval_num > 0) {
+    Evaluate(*index, ids, vectors, dim);
+  }
+
+  DXCHECK(index->Save(FLAGS_out));
+  DXINFO("Wrote ann index to: %s.", FLAGS_out.c_str());
+
+  google::ShutDownCommandLineFlags();
+  return 0;
+}
+
+}  // namespace
+}  // namespace embedx
+
+int main(int argc, char** argv) { return embedx::main(argc, argv); }
@@ -0,0 +1,143 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::min
+#include <chrono>
+#include <memory>  // std::unique_ptr
+#include <random>  // std::normal_distribution
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "src/ann/hnsw_index.h"
+#include "src/common/data_types.h"
+#include "src/common/random.h"
+#include "src/tools/bench/bench_util.h"
+
+namespace embedx {
+namespace {
+
+constexpr int ANN_DIM = 64;
+constexpr int ANN_MAX_SIZE = 50000;
+constexpr int ANN_CLUSTER_NUM = 256;
+constexpr int ANN_QUERY_NUM = 1000;
+constexpr int ANN_K = 10;
+
+// Embeddings of trained models are clustered, vectors are drawn around
+// random centers.
+void MakeVectors(int size, uint32_t seed, std::vector<float>* vectors) {
+  RandomEngine engine(seed, 0);
+  std::normal_distribution<float> normal;
+  std::vector<float> centers((size_t)ANN_CLUSTER_NUM * ANN_DIM);
+  for (auto& value : centers) {
+    value = normal(engine);
+  }
+
+  vectors->resize((size_t)size * ANN_DIM);
+  for (int i = 0; i < size; ++i) {
+    const float* center =
+        centers.data() + (size_t)(engine() % ANN_CLUSTER_NUM) * ANN_DIM;
+    for (int j = 0; j < ANN_DIM; ++j) {
+      (*vectors)[(size_t)i * ANN_DIM + j] = center[j] + 0.5f * normal(engine);
+    }
+  }
+}
+
+double Recall(const std::vector<std::vector<ann::scored_node_t>>& results,
+              const std::vector<std::vector<ann::scored_node_t>>& exact) {
+  int hit = 0, total = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    std::unordered_set<int_t> exact_ids;
+    for (const auto& node : exact[i]) {
+      exact_ids.insert(node.first);
+    }
+    for (const auto& node : results[i]) {
+      hit += (int)exact_ids.count(node.first);
+    }
+    total += (int)exact[i].size();
+  }
+  return total > 0 ? (double)hit / total : 0;
+}
+
+// Recall@10 and QPS of HNSW against brute force over the item embeddings of
+// the generated graph nodes.
+void BenchAnn(const BenchEnv& env, BenchRunner* runner) {
+  const vec_int_t& ids_all = env.graph.nodes;
+  int size = std::min((int)ids_all.size(), ANN_MAX_SIZE);
+  vec_int_t ids(ids_all.begin(), ids_all.begin() + size);
+  std::vector<float> vectors, queries;
+  MakeVectors(size, env.seed, &vectors);
+  MakeVectors(ANN_QUERY_NUM, env.seed + 1, &queries);
+
+  for (auto metric : {ann::MetricEnum::INNER_PRODUCT, ann::MetricEnum::L2}) {
+    std::string prefix =
+        metric == ann::MetricEnum::INNER_PRODUCT ? "ip/" : "l2/";
+    ann::HnswParam param;
+    param.metric = metric;
+    param.seed = env.seed;
+
+    auto begin = std::chrono::steady_clock::now();
+    auto index = ann::HnswIndex::Build(ids, vectors, ANN_DIM, param,
+                                       env.thread_num);
+    DXCHECK_THROW(index);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    DXINFO("Built %s index of %d nodes with %d threads in %.2f seconds.",
+           prefix.c_str(), size, env.thread_num, elapsed.count());
+
+    std::vector<std::vector<ann::scored_node_t>> exact(ANN_QUERY_NUM);
+    for (int i = 0; i < ANN_QUERY_NUM; ++i) {
+      ann::ExactSearch(ids, vectors, ANN_DIM, metric,
+                       queries.data() + (size_t)i * ANN_DIM, ANN_K, &exact[i]);
+    }
+
+    runner->Run(prefix + "ExactSearch",
+                [&ids, &vectors, &queries, metric](int /*thread_id*/) {
+                  std::vector<ann::scored_node_t> nodes;
+                  ann::ExactSearch(ids, vectors, ANN_DIM, metric,
+                                   queries.data(), ANN_K, &nodes);
+                  return (int64_t)1;
+                });
+
+    for (int ef : {16, 32, 64, 128, 256}) {
+      std::vector<std::vector<ann::scored_node_t>> results(ANN_QUERY_NUM);
+      for (int i = 0; i < ANN_QUERY_NUM; ++i) {
+        index->Search(queries.data() + (size_t)i * ANN_DIM, ANN_K, ef,
+                      &results[i]);
+      }
+      DXINFO("%sef=%d recall@%d: %.4f.", prefix.c_str(), ef, ANN_K,
+             Recall(results, exact));
+
+      // each thread walks the queries from its own offset
+      std::vector<int> next(env.thread_num);
+      for (int i = 0; i < env.thread_num; ++i) {
+        next[i] = i * ANN_QUERY_NUM / env.thread_num;
+      }
+      runner->Run(prefix + "Search/ef=" + std::to_string(ef), env.thread_num,
+                  [&index, &queries, &next, ef](int thread_id) {
+                    int& i = next[thread_id];
+                    i = (i + 1) % ANN_QUERY_NUM;
+                    std::vector<ann::scored_node_t> nodes;
+                    index->Search(queries.data() + (size_t)i * ANN_DIM, ANN_K,
+                                  ef, &nodes);
+                    return (int64_t)1;
+                  });
+    }
+  }
+}
+
+}  // namespace
+
+BENCH_SUITE_REGISTER(ann, &BenchAnn);
+
+}  // namespace embedx
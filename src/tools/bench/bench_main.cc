@@ -0,0 +1,125 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/common/str_util.h>
+#include <deepx_core/dx_log.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>  // std::find
+#include <map>
+#include <string>
+
+#include "src/common/data_types.h"
+#include "src/common/parallel_util.h"
+#include "src/tools/bench/bench_util.h"
+#include "src/tools/bench/graph_generator.h"
+
+DEFINE_string(bench_suites, "",
+              "Comma separated suites to run, empty for all of them: "
+              "graph_client, io, model_op, sampler, sampling.");
+DEFINE_string(bench_dir, "bench_data", "Working dir of generated graph.");
+DEFINE_string(bench_out, "", "Output json file, empty for stdout.");
+DEFINE_double(bench_seconds, 1.0, "Minimum seconds of each benchmark.");
+DEFINE_int32(bench_warmup, 3, "Warmup iterations of each benchmark.");
+DEFINE_int32(node_num, 100000, "Node number of generated graph.");
+DEFINE_int32(min_degree, 2, "Min degree of generated graph.");
+DEFINE_int32(max_degree, 1000, "Max degree of generated graph.");
+DEFINE_double(degree_alpha, 2.1, "Power law exponent of degrees.");
+DEFINE_double(popularity_s, 1.0, "Zipf exponent of neighbor popularity.");
+DEFINE_int32(feature_num, 8, "Feature number of each node.");
+DEFINE_int32(batch, 256, "Batch nodes.");
+DEFINE_int32(thread_num, 4, "Thread number of concurrent benchmarks.");
+DEFINE_int32(intra_op_thread_num, 1, "Intra op thread number of model ops.");
+DEFINE_string(gs_addr, "127.0.0.1:61000",
+              "Address of the in-process graph server.");
+DEFINE_int32(seed, 9527, "Seed of random engine.");
+
+namespace embedx {
+namespace {
+
+void CheckFlags() {
+  DXCHECK(!FLAGS_bench_dir.empty());
+  DXCHECK(FLAGS_bench_seconds > 0);
+  DXCHECK(FLAGS_bench_warmup >= 0);
+  DXCHECK(FLAGS_node_num > 0);
+  DXCHECK(0 < FLAGS_min_degree && FLAGS_min_degree <= FLAGS_max_degree);
+  DXCHECK(FLAGS_degree_alpha > 1);
+  DXCHECK(FLAGS_popularity_s >= 0);
+  DXCHECK(FLAGS_feature_num >= 0);
+  DXCHECK(FLAGS_batch > 0);
+  DXCHECK(FLAGS_thread_num > 0);
+  DXCHECK(FLAGS_intra_op_thread_num > 0);
+  DXCHECK(!FLAGS_gs_addr.empty());
+}
+
+int main(int argc, char** argv) {
+  google::SetUsageMessage("Usage: [Options]");
+#if HAVE_COMPILE_FLAGS_H == 1
+  google::SetVersionString("\n\n"
+#include "compile_flags.h"
+  );
+#endif
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  CheckFlags();
+  SetIntraOpThreadNum(FLAGS_intra_op_thread_num);
+
+  PowerLawGraphConfig graph_config;
+  graph_config.node_num = FLAGS_node_num;
+  graph_config.min_degree = FLAGS_min_degree;
+  graph_config.max_degree = FLAGS_max_degree;
+  graph_config.degree_alpha = FLAGS_degree_alpha;
+  graph_config.popularity_s = FLAGS_popularity_s;
+  graph_config.feature_num = FLAGS_feature_num;
+  graph_config.seed = (uint32_t)FLAGS_seed;
+
+  BenchEnv env;
+  DXCHECK(GeneratePowerLawGraph(graph_config, FLAGS_bench_dir, &env.graph));
+  env.work_dir = FLAGS_bench_dir;
+  env.batch = FLAGS_batch;
+  env.thread_num = FLAGS_thread_num;
+  env.gs_addr = FLAGS_gs_addr;
+  env.seed = (uint32_t)FLAGS_seed;
+
+  vec_str_t suites;
+  deepx_core::Split(FLAGS_bench_suites, ",", &suites);
+
+  BenchRunner runner;
+  runner.set_min_seconds(FLAGS_bench_seconds);
+  runner.set_warmup(FLAGS_bench_warmup);
+  for (const auto& entry : BenchSuiteRegistry::GetInstance()->suites()) {
+    if (!suites.empty() &&
+        std::find(suites.begin(), suites.end(), entry.first) == suites.end()) {
+      continue;
+    }
+    DXINFO("Running benchmark suite: %s...", entry.first.c_str());
+    runner.set_suite(entry.first);
+    entry.second(env, &runner);
+  }
+
+  std::map<std::string, std::string> meta;
+  meta["node_num"] = std::to_string(FLAGS_node_num);
+  meta["edge_num"] = std::to_string(env.graph.edge_num);
+  meta["degree_alpha"] = std::to_string(FLAGS_degree_alpha);
+  meta["batch"] = std::to_string(FLAGS_batch);
+  meta["thread_num"] = std::to_string(FLAGS_thread_num);
+  meta["intra_op_thread_num"] = std::to_string(FLAGS_intra_op_thread_num);
+  meta["seed"] = std::to_string(FLAGS_seed);
+  DXCHECK(runner.WriteJson(FLAGS_bench_out, meta));
+
+  google::ShutDownCommandLineFlags();
+  return 0;
+}
+
+}  // namespace
+}  // namespace embedx
+
+int main(int argc, char** argv) { return embedx::main(argc, argv); }
@@ -0,0 +1,227 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/tools/bench/bench_util.h"
+
+#include <unistd.h>  // sysconf
+
+#include <deepx_core/common/stream.h>
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::sort
+#include <chrono>
+#include <cmath>     // std::ceil
+#include <fstream>   // std::ifstream
+#include <iomanip>   // std::setprecision
+#include <iostream>  // std::cout
+#include <random>
+#include <sstream>  // std::ostringstream
+#include <thread>
+
+namespace embedx {
+
+/************************************************************************/
+/* BenchResult */
+/************************************************************************/
+double BenchResult::Percentile(double p) const noexcept {
+  if (latency_us.empty()) {
+    return 0;
+  }
+  // nearest rank
+  auto rank = (size_t)std::ceil(p / 100 * latency_us.size());
+  rank = std::max(rank, (size_t)1);
+  return latency_us[std::min(rank, latency_us.size()) - 1];
+}
+
+double BenchResult::Mean() const noexcept {
+  if (latency_us.empty()) {
+    return 0;
+  }
+  double sum = 0;
+  for (double latency : latency_us) {
+    sum += latency;
+  }
+  return sum / latency_us.size();
+}
+
+/************************************************************************/
+/* BenchRunner */
+/************************************************************************/
+void BenchRunner::Run(const std::string& name, int thread_num,
+                      const bench_func_t& func) {
+  using clock = std::chrono::steady_clock;
+  using us = std::chrono::duration<double, std::micro>;
+
+  thread_num = std::max(thread_num, 1);
+  std::vector<std::vector<double>> latency_tls(thread_num);
+  std::vector<int64_t> items_tls(thread_num, 0);
+
+  auto entry = [&](int thread_id) {
+    for (int i = 0; i < warmup_; ++i) {
+      (void)func(thread_id);
+    }
+
+    auto& latency = latency_tls[thread_id];
+    auto& items = items_tls[thread_id];
+    auto begin = clock::now();
+    for (;;) {
+      auto start = clock::now();
+      items += func(thread_id);
+      auto end = clock::now();
+      latency.emplace_back(us(end - start).count());
+      if (std::chrono::duration<double>(end - begin).count() >= min_seconds_) {
+        break;
+      }
+    }
+  };
+
+  auto begin = clock::now();
+  if (thread_num == 1) {
+    entry(0);
+  } else {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_num; ++i) {
+      threads.emplace_back(entry, i);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  auto end = clock::now();
+
+  BenchResult result;
+  result.suite = suite_;
+  result.name = name;
+  result.thread_num = thread_num;
+  // warmup of every thread is inside the wall time, but is small enough
+  result.seconds = std::chrono::duration<double>(end - begin).count();
+  for (int i = 0; i < thread_num; ++i) {
+    result.items += items_tls[i];
+    result.latency_us.insert(result.latency_us.end(), latency_tls[i].begin(),
+                             latency_tls[i].end());
+  }
+  result.iterations = (int64_t)result.latency_us.size();
+  std::sort(result.latency_us.begin(), result.latency_us.end());
+
+  DXINFO("%s/%s: threads=%d, items/s=%.1f, p50=%.2fus, p99=%.2fus.",
+         suite_.c_str(), name.c_str(), thread_num, result.items_per_second(),
+         result.Percentile(50), result.Percentile(99));
+  results_.emplace_back(std::move(result));
+}
+
+bool BenchRunner::WriteJson(
+    const std::string& file,
+    const std::map<std::string, std::string>& meta) const {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(3);
+  oss << "{\n  \"meta\": {";
+  const char* sep = "\n";
+  for (const auto& entry : meta) {
+    oss << sep << "    \"" << entry.first << "\": \"" << entry.second << "\"";
+    sep = ",\n";
+  }
+  oss << "\n  },\n  \"results\": [";
+
+  sep = "\n";
+  for (const auto& result : results_) {
+    oss << sep << "    {\"suite\": \"" << result.suite << "\", \"name\": \""
+        << result.name << "\", \"threads\": " << result.thread_num
+        << ", \"iterations\": " << result.iterations
+        << ", \"items\": " << result.items
+        << ", \"seconds\": " << result.seconds
+        << ", \"items_per_second\": " << result.items_per_second()
+        << ", \"latency_us\": {\"mean\": " << result.Mean()
+        << ", \"p50\": " << result.Percentile(50)
+        << ", \"p90\": " << result.Percentile(90)
+        << ", \"p99\": " << result.Percentile(99)
+        << ", \"p999\": " << result.Percentile(99.9)
+        << ", \"max\": " << result.Percentile(100) << "}}";
+    sep = ",\n";
+  }
+  oss << "\n  ]\n}\n";
+
+  std::string s = oss.str();
+  if (file.empty()) {
+    std::cout << s;
+    return true;
+  }
+
+  deepx_core::AutoOutputFileStream ofs;
+  if (!ofs.Open(file)) {
+    DXERROR("Failed to open file: %s.", file.c_str());
+    return false;
+  }
+  ofs.Write(s.data(), s.size());
+  if (!ofs) {
+    DXERROR("Failed to write file: %s.", file.c_str());
+    return false;
+  }
+  DXINFO("Wrote benchmark results to: %s.", file.c_str());
+  return true;
+}
+
+/************************************************************************/
+/* BenchSuiteRegistry */
+/************************************************************************/
+BenchSuiteRegistry* BenchSuiteRegistry::GetInstance() {
+  static BenchSuiteRegistry registry;
+  return &registry;
+}
+
+void BenchSuiteRegistry::Register(const std::string& name,
+                                  bench_suite_t suite) {
+  DXCHECK_THROW(suites_.emplace(name, suite).second);
+}
+
+/************************************************************************/
+/* NewBenchGraphConfig */
+/************************************************************************/
+GraphConfig NewBenchGraphConfig(const BenchEnv& env) {
+  GraphConfig config;
+  config.set_node_graph(env.graph.context_dir);
+  config.set_node_feature(env.graph.feature_dir);
+  config.set_neighbor_feature(env.graph.feature_dir);
+  config.set_thread_num(env.thread_num);
+  config.set_ip_ports(env.gs_addr);
+  return config;
+}
+
+/************************************************************************/
+/* MakeBatches */
+/************************************************************************/
+std::vector<vec_int_t> MakeBatches(const vec_int_t& nodes, int batch,
+                                   int batch_num, uint32_t seed) {
+  DXCHECK_THROW(!nodes.empty());
+  std::default_random_engine engine(seed);
+  std::uniform_int_distribution<size_t> dist(0, nodes.size() - 1);
+  std::vector<vec_int_t> batches(batch_num);
+  for (auto& nodes_batch : batches) {
+    nodes_batch.resize(batch);
+    for (auto& node : nodes_batch) {
+      node = nodes[dist(engine)];
+    }
+  }
+  return batches;
+}
+
+/************************************************************************/
+/* ResidentBytes */
+/************************************************************************/
+int64_t ResidentBytes() {
+  std::ifstream is("/proc/self/statm");
+  int64_t size = 0, resident = 0;
+  if (!(is >> size >> resident)) {
+    return 0;
+  }
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+}  // namespace embedx
@@ -0,0 +1,125 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/graph/graph_config.h"
+#include "src/tools/bench/graph_generator.h"
+
+namespace embedx {
+
+/************************************************************************/
+/* BenchResult */
+/************************************************************************/
+struct BenchResult {
+  std::string suite;
+  std::string name;
+  int thread_num = 1;
+  int64_t iterations = 0;
+  int64_t items = 0;
+  double seconds = 0;
+  // latency of each iteration in microseconds, sorted
+  std::vector<double> latency_us;
+
+  double items_per_second() const noexcept {
+    return seconds > 0 ? items / seconds : 0;
+  }
+  double Percentile(double p) const noexcept;
+  double Mean() const noexcept;
+};
+
+/************************************************************************/
+/* BenchRunner */
+/************************************************************************/
+// 'func' runs one iteration and returns the number of items it processed,
+// e.g. nodes sampled or lines parsed. 'thread_id' is in [0, thread_num).
+using bench_func_t = std::function<int64_t(int thread_id)>;
+
+class BenchRunner {
+ private:
+  double min_seconds_ = 1.0;
+  int warmup_ = 3;
+  std::string suite_;
+  std::vector<BenchResult> results_;
+
+ public:
+  void set_min_seconds(double min_seconds) noexcept {
+    min_seconds_ = min_seconds;
+  }
+  void set_warmup(int warmup) noexcept { warmup_ = warmup; }
+  void set_suite(const std::string& suite) { suite_ = suite; }
+  const std::vector<BenchResult>& results() const noexcept { return results_; }
+
+ public:
+  // Run 'func' for at least 'min_seconds' in each of 'thread_num' threads.
+  void Run(const std::string& name, int thread_num, const bench_func_t& func);
+  void Run(const std::string& name, const bench_func_t& func) {
+    Run(name, 1, func);
+  }
+
+  // Write all results as JSON to 'file', or stdout if 'file' is empty.
+  bool WriteJson(const std::string& file,
+                 const std::map<std::string, std::string>& meta) const;
+};
+
+/************************************************************************/
+/* BenchSuite */
+/************************************************************************/
+struct BenchEnv {
+  PowerLawGraph graph;
+  std::string work_dir;
+  int batch = 256;
+  int thread_num = 4;
+  std::string gs_addr;
+  uint32_t seed = 9527;
+};
+
+using bench_suite_t = void (*)(const BenchEnv& env, BenchRunner* runner);
+
+class BenchSuiteRegistry {
+ private:
+  std::map<std::string, bench_suite_t> suites_;
+
+ public:
+  static BenchSuiteRegistry* GetInstance();
+  void Register(const std::string& name, bench_suite_t suite);
+  const std::map<std::string, bench_suite_t>& suites() const noexcept {
+    return suites_;
+  }
+};
+
+struct BenchSuiteRegister {
+  BenchSuiteRegister(const std::string& name, bench_suite_t suite) {
+    BenchSuiteRegistry::GetInstance()->Register(name, suite);
+  }
+};
+
+#define BENCH_SUITE_REGISTER(name, suite) \
+  static ::embedx::BenchSuiteRegister bench_suite_register_##name(#name, suite)
+
+// Local graph config of the generated graph.
+GraphConfig NewBenchGraphConfig(const BenchEnv& env);
+
+// 'batch_num' batches of 'batch' nodes drawn uniformly from 'nodes', generated
+// ahead of time to keep the random engine out of the timed loops.
+std::vector<vec_int_t> MakeBatches(const vec_int_t& nodes, int batch,
+                                   int batch_num, uint32_t seed);
+
+// Resident memory of the process in bytes, 0 if unknown.
+int64_t ResidentBytes();
+
+}  // namespace embedx
@@ -0,0 +1,182 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/common/stream.h>
+#include <deepx_core/dx_log.h>
+#include <deepx_core/ps/tcp_connection.h>
+
+#include <chrono>
+#include <cstdio>  // std::remove
+#include <memory>  // std::unique_ptr
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/graph/client/graph_client.h"
+#include "src/graph/graph_config.h"
+#include "src/graph/server/dist_graph_server.h"
+#include "src/sampler/random_walker_data_types.h"
+#include "src/tools/bench/bench_util.h"
+
+namespace embedx {
+namespace {
+
+constexpr int BATCH_NUM = 64;
+constexpr int NEIGHBOR_COUNT = 10;
+constexpr int NEGATIVE_COUNT = 5;
+constexpr int WALK_LEN = 10;
+constexpr int SERVER_WAIT_SECONDS = 600;
+constexpr int CALL_THREAD_NUM = 16;
+
+// The same ops are run by the local client and the dist client, so their
+// difference is the cost of rpc.
+void BenchGraphClientOps(const std::string& prefix, const GraphClient& client,
+                         const BenchEnv& env, BenchRunner* runner) {
+  auto batches = MakeBatches(env.graph.nodes, env.batch, BATCH_NUM, env.seed);
+  std::vector<size_t> next(env.thread_num, 0);
+  auto next_batch = [&batches, &next](int thread_id) -> const vec_int_t& {
+    return batches[next[thread_id]++ % batches.size()];
+  };
+  int thread_num = env.thread_num;
+
+  runner->Run(prefix + "/LookupContext", thread_num, [&](int thread_id) {
+    std::vector<vec_pair_t> contexts;
+    const auto& nodes = next_batch(thread_id);
+    DXCHECK_THROW(client.LookupContext(nodes, &contexts));
+    return (int64_t)nodes.size();
+  });
+
+  runner->Run(prefix + "/LookupNodeFeature", thread_num, [&](int thread_id) {
+    std::vector<vec_pair_t> node_feats;
+    const auto& nodes = next_batch(thread_id);
+    DXCHECK_THROW(client.LookupNodeFeature(nodes, &node_feats));
+    return (int64_t)nodes.size();
+  });
+
+  runner->Run(prefix + "/LookupFeature", thread_num, [&](int thread_id) {
+    std::vector<vec_pair_t> node_feats, neigh_feats;
+    const auto& nodes = next_batch(thread_id);
+    DXCHECK_THROW(client.LookupFeature(nodes, &node_feats, &neigh_feats));
+    return (int64_t)nodes.size();
+  });
+
+  runner->Run(prefix + "/RandomSampleNeighbor", thread_num, [&](int thread_id) {
+    std::vector<vec_int_t> neighbor_nodes_list;
+    const auto& nodes = next_batch(thread_id);
+    DXCHECK_THROW(client.RandomSampleNeighbor(NEIGHBOR_COUNT, nodes,
+                                              &neighbor_nodes_list));
+    return (int64_t)nodes.size() * NEIGHBOR_COUNT;
+  });
+
+  runner->Run(prefix + "/SharedSampleNegative", thread_num, [&](int thread_id) {
+    std::vector<vec_int_t> sampled_nodes_list;
+    const auto& nodes = next_batch(thread_id);
+    DXCHECK_THROW(client.SharedSampleNegative(NEGATIVE_COUNT, nodes, nodes,
+                                              &sampled_nodes_list));
+    return (int64_t)nodes.size() * NEGATIVE_COUNT;
+  });
+
+  runner->Run(prefix + "/IndepSampleNegative", thread_num, [&](int thread_id) {
+    std::vector<vec_int_t> sampled_nodes_list;
+    const auto& nodes = next_batch(thread_id);
+    DXCHECK_THROW(client.IndepSampleNegative(NEGATIVE_COUNT, nodes, nodes,
+                                             &sampled_nodes_list));
+    return (int64_t)nodes.size() * NEGATIVE_COUNT;
+  });
+
+  std::vector<int> walk_lens(env.batch, WALK_LEN);
+  WalkerInfo walker_info;
+  runner->Run(prefix + "/StaticTraverse", thread_num, [&](int thread_id) {
+    std::vector<vec_int_t> seqs;
+    const auto& nodes = next_batch(thread_id);
+    DXCHECK_THROW(client.StaticTraverse(nodes, walk_lens, walker_info, &seqs));
+    return (int64_t)nodes.size() * WALK_LEN;
+  });
+}
+
+// One node calls of many threads, the cost of a call itself rather than of
+// its nodes.
+void BenchGraphClientCall(const std::string& prefix, const GraphClient& client,
+                          const BenchEnv& env, BenchRunner* runner) {
+  const auto& nodes = env.graph.nodes;
+  std::vector<size_t> next(CALL_THREAD_NUM, 0);
+  runner->Run(
+      prefix + "/LookupNodeFeature_1", CALL_THREAD_NUM, [&](int thread_id) {
+        vec_int_t node{nodes[next[thread_id]++ % nodes.size()]};
+        std::vector<vec_pair_t> node_feats;
+        DXCHECK_THROW(client.LookupNodeFeature(node, &node_feats));
+        return (int64_t)1;
+      });
+}
+
+bool WaitServer(const std::string& success_file) {
+  for (int i = 0; i < SERVER_WAIT_SECONDS; ++i) {
+    if (deepx_core::AutoFileSystem::Exists(success_file)) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+  }
+  DXERROR("Timeout waiting for graph server.");
+  return false;
+}
+
+void CloseServer(const std::string& ip_port) {
+  deepx_core::IoContext io;
+  deepx_core::TcpConnection conn(&io);
+  DXCHECK_THROW(conn.ConnectRetry(deepx_core::MakeTcpEndpoint(ip_port), 10,
+                                  1) == 0);
+  DXCHECK_THROW(conn.RpcTerminationNotify() == 0);
+}
+
+void BenchGraphClient(const BenchEnv& env, BenchRunner* runner) {
+  GraphConfig config = NewBenchGraphConfig(env);
+
+  // local
+  {
+    auto client = NewGraphClient(config, GraphClientEnum::LOCAL);
+    DXCHECK_THROW(client);
+    BenchGraphClientOps("local", *client, env, runner);
+    BenchGraphClientCall("local", *client, env, runner);
+  }
+
+  // dist, against a single shard server in this process
+  //
+  // The server shares the op factory with the local client above, it
+  // re-initializes the ops with its own resource before serving.
+  std::string success_out = env.work_dir + "/server";
+  std::string success_file = success_out + "/_SUCCESS0";
+  (void)std::remove(success_file.c_str());
+  (void)deepx_core::AutoFileSystem::MakeDir(success_out);
+  config.set_shard_num(1);
+  config.set_shard_id(0);
+  config.set_success_out(success_out);
+
+  DistGraphServer server;
+  std::thread server_thread(
+      [&server, &config]() { DXCHECK(server.Start(config)); });
+  DXCHECK_THROW(WaitServer(success_file));
+
+  {
+    auto client = NewGraphClient(config, GraphClientEnum::DIST);
+    DXCHECK_THROW(client);
+    BenchGraphClientOps("dist", *client, env, runner);
+  }
+
+  CloseServer(env.gs_addr);
+  server_thread.join();
+}
+
+}  // namespace
+
+BENCH_SUITE_REGISTER(graph_client, &BenchGraphClient);
+
+}  // namespace embedx
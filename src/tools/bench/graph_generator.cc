@@ -0,0 +1,159 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/tools/bench/graph_generator.h"
+
+#include <deepx_core/common/stream.h>
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::shuffle, std::sort, std::unique
+#include <cmath>      // std::pow
+#include <memory>     // std::unique_ptr
+#include <random>
+#include <sstream>  // std::ostringstream
+#include <string>
+#include <vector>
+
+namespace embedx {
+namespace {
+
+bool MakeDir(const std::string& dir) {
+  if (!deepx_core::AutoFileSystem::Exists(dir) &&
+      !deepx_core::AutoFileSystem::MakeDir(dir)) {
+    DXERROR("Failed to make dir: %s.", dir.c_str());
+    return false;
+  }
+  return true;
+}
+
+class PartFileWriter {
+ private:
+  std::vector<std::unique_ptr<deepx_core::AutoOutputFileStream>> ofs_;
+
+ public:
+  bool Open(const std::string& dir, int file_num) {
+    if (!MakeDir(dir)) {
+      return false;
+    }
+    ofs_.resize(file_num);
+    for (int i = 0; i < file_num; ++i) {
+      std::string file = dir + "/part-" + std::to_string(i);
+      ofs_[i].reset(new deepx_core::AutoOutputFileStream);
+      if (!ofs_[i]->Open(file)) {
+        DXERROR("Failed to open file: %s.", file.c_str());
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool Write(int_t node, const std::string& line) {
+    auto& ofs = *ofs_[node % ofs_.size()];
+    ofs.Write(line.data(), line.size());
+    if (!ofs) {
+      DXERROR("Failed to write file.");
+      return false;
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+bool GeneratePowerLawGraph(const PowerLawGraphConfig& config,
+                           const std::string& dir, PowerLawGraph* graph) {
+  DXCHECK(config.node_num > 0);
+  DXCHECK(0 < config.min_degree && config.min_degree <= config.max_degree);
+  DXCHECK(config.degree_alpha > 1);
+  DXCHECK(config.file_num > 0);
+
+  graph->config = config;
+  graph->context_dir = dir + "/context";
+  graph->feature_dir = dir + "/feature";
+  graph->nodes.clear();
+  graph->degrees.clear();
+  graph->edge_num = 0;
+
+  PartFileWriter context_writer, feature_writer;
+  if (!MakeDir(dir) ||
+      !context_writer.Open(graph->context_dir, config.file_num) ||
+      !feature_writer.Open(graph->feature_dir, config.file_num)) {
+    return false;
+  }
+
+  std::default_random_engine engine(config.seed);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  std::uniform_int_distribution<int_t> feature_dist(
+      0, (int_t)config.feature_space - 1);
+
+  // popularity rank -> node, so hubs are spread over shards
+  int node_num = config.node_num;
+  vec_int_t rank_node(node_num);
+  std::vector<double> popularity(node_num);
+  for (int i = 0; i < node_num; ++i) {
+    rank_node[i] = (int_t)i;
+    popularity[i] = std::pow(i + 1.0, -config.popularity_s);
+  }
+  std::shuffle(rank_node.begin(), rank_node.end(), engine);
+  std::discrete_distribution<int> rank_dist(popularity.begin(),
+                                            popularity.end());
+
+  DXINFO("Generating power law graph of %d nodes into: %s...", node_num,
+         dir.c_str());
+  vec_int_t neighbors;
+  std::ostringstream oss;
+  for (int i = 0; i < node_num; ++i) {
+    auto node = (int_t)i;
+
+    // P(degree >= d) ~ d^(1 - alpha)
+    double u = 1 - uniform(engine);
+    double degree = config.min_degree *
+                    std::pow(u, -1.0 / (config.degree_alpha - 1.0));
+    int n = (int)std::min(degree, (double)config.max_degree);
+    neighbors.clear();
+    for (int j = 0; j < n; ++j) {
+      neighbors.emplace_back(rank_node[rank_dist(engine)]);
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                    neighbors.end());
+
+    oss.clear();
+    oss.str("");
+    oss << node;
+    for (auto neighbor : neighbors) {
+      oss << " " << neighbor << ":" << (float)(1 - uniform(engine));
+    }
+    oss << "\n";
+    if (!context_writer.Write(node, oss.str())) {
+      return false;
+    }
+
+    oss.clear();
+    oss.str("");
+    oss << node;
+    for (int j = 0; j < config.feature_num; ++j) {
+      oss << " " << feature_dist(engine) << ":" << (float)uniform(engine);
+    }
+    oss << "\n";
+    if (!feature_writer.Write(node, oss.str())) {
+      return false;
+    }
+
+    graph->nodes.emplace_back(node);
+    graph->degrees.emplace_back((float_t)neighbors.size());
+    graph->edge_num += (int64_t)neighbors.size();
+  }
+  DXINFO("Done, %lld edges.", (long long)graph->edge_num);
+  return true;
+}
+
+}  // namespace embedx
@@ -0,0 +1,49 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "src/common/data_types.h"
+
+namespace embedx {
+
+// Synthetic graph whose degrees follow P(d) ~ d^-degree_alpha and whose
+// neighbors are drawn from a zipf(popularity_s) node popularity, so a few hub
+// nodes own most of the edges as in real social and item graphs.
+struct PowerLawGraphConfig {
+  int node_num = 100000;
+  int min_degree = 2;
+  int max_degree = 1000;
+  double degree_alpha = 2.1;
+  double popularity_s = 1.0;
+  int feature_num = 8;
+  int feature_space = 1 << 20;
+  int file_num = 4;
+  uint32_t seed = 9527;
+};
+
+struct PowerLawGraph {
+  PowerLawGraphConfig config;
+  // data format is the same as 'node_graph' and 'node_feature'
+  std::string context_dir;
+  std::string feature_dir;
+  vec_int_t nodes;
+  vec_float_t degrees;  // out degree of nodes[i]
+  int64_t edge_num = 0;
+};
+
+// Generate the graph files into 'dir', which is created if not exist.
+bool GeneratePowerLawGraph(const PowerLawGraphConfig& config,
+                           const std::string& dir, PowerLawGraph* graph);
+
+}  // namespace embedx
@@ -0,0 +1,73 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "src/graph/client/hedged_caller.h"
+#include "src/tools/bench/bench_util.h"
+
+namespace embedx {
+namespace {
+
+constexpr int LANE_NUM = 4;
+constexpr int STALL_PERIOD = 50;
+constexpr int SERVICE_US = 500;
+constexpr int STALL_US = 20000;
+constexpr double HEDGE_PERCENTILE = 90;
+constexpr uint64_t MIN_DELAY_US = 200;
+
+// Replicas of a fake shard, every STALL_PERIOD-th try stalls like a server in
+// a long gc pause, so that p99 of the plain calls is a stall and p99 of the
+// hedged calls is about the hedge delay plus a service time.
+void BenchHedged(const BenchEnv& /*env*/, BenchRunner* runner) {
+  std::atomic<int> try_num{0};
+  auto serve = [&try_num](int, int) {
+    int n = try_num.fetch_add(1) + 1;
+    int us = n % STALL_PERIOD == 0 ? STALL_US : SERVICE_US;
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+    return 0;
+  };
+
+  auto bench = [&runner, &serve](const char* name, HedgedCaller* caller) {
+    int winner;
+    for (uint64_t i = 0; i < HedgedCaller::WARMUP_NUM; ++i) {
+      DXCHECK_THROW(caller->Run(0, serve, &winner) == 0);
+    }
+    runner->Run(name, [caller, &serve](int) {
+      int winner;
+      DXCHECK_THROW(caller->Run(0, serve, &winner) == 0);
+      return (int64_t)1;
+    });
+    DXINFO("%s: %llu calls, %llu hedged, %llu won by the hedged try.", name,
+           (unsigned long long)caller->call_num(),
+           (unsigned long long)caller->hedge_num(),
+           (unsigned long long)caller->hedge_win_num());
+  };
+
+  {
+    HedgedCaller caller(LANE_NUM, 1, 0, 0);
+    bench("plain/Run", &caller);
+  }
+  {
+    HedgedCaller caller(LANE_NUM, 1, HEDGE_PERCENTILE, MIN_DELAY_US);
+    bench("hedged/Run", &caller);
+  }
+}
+
+}  // namespace
+
+BENCH_SUITE_REGISTER(hedged, &BenchHedged);
+
+}  // namespace embedx
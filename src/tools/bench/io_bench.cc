@@ -0,0 +1,131 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::min
+#include <sstream>    // std::ostringstream
+#include <string>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/common/random.h"
+#include "src/io/embedding_file.h"
+#include "src/io/io_util.h"
+#include "src/io/line_parser.h"
+#include "src/io/loader/loader.h"
+#include "src/io/text_buffer.h"
+#include "src/io/value.h"
+#include "src/tools/bench/bench_util.h"
+
+namespace embedx {
+namespace {
+
+// Parse the context files batch by batch, reopening them at the end.
+void BenchLineParser(const BenchEnv& env, BenchRunner* runner) {
+  vec_str_t files;
+  DXCHECK_THROW(io_util::ListFile(env.graph.context_dir, &files));
+  DXCHECK_THROW(!files.empty());
+
+  LineParser line_parser;
+  size_t file_id = 0;
+  DXCHECK_THROW(line_parser.Open(files[file_id]));
+  std::vector<AdjValue> values;
+  runner->Run("LineParser/AdjValue", [&](int /*thread_id*/) {
+    while (!line_parser.NextBatch<>(env.batch, &values)) {
+      file_id = (file_id + 1) % files.size();
+      DXCHECK_THROW(line_parser.Open(files[file_id]));
+    }
+    return (int64_t)values.size();
+  });
+}
+
+void BenchLoader(const BenchEnv& env, BenchRunner* runner) {
+  runner->Run("ContextLoader/Load", [&env](int /*thread_id*/) {
+    auto loader = NewContextLoader();
+    DXCHECK_THROW(loader->Load(env.graph.context_dir, env.thread_num));
+    return (int64_t)loader->storage()->Size();
+  });
+
+  runner->Run("FeatureLoader/Load", [&env](int /*thread_id*/) {
+    auto loader = NewFeatureLoader();
+    DXCHECK_THROW(loader->Load(env.graph.feature_dir, env.thread_num));
+    return (int64_t)loader->storage()->Size();
+  });
+}
+
+// Format a batch of 128-d embeddings as predictor dumps them.
+void BenchEmbeddingDump(const BenchEnv& env, BenchRunner* runner) {
+  const int dim = 128;
+  int batch = env.batch;
+  vec_int_t ids(env.graph.nodes.begin(),
+                env.graph.nodes.begin() +
+                    std::min((size_t)batch, env.graph.nodes.size()));
+  batch = (int)ids.size();
+  std::vector<float> values((size_t)batch * dim);
+  RandomEngine engine(env.seed, 0);
+  for (auto& value : values) {
+    value = (float)(engine.NextDouble() * 2 - 1);
+  }
+
+  runner->Run("EmbeddingDump/ostringstream", [&](int /*thread_id*/) {
+    std::ostringstream oss;
+    for (int i = 0; i < batch; ++i) {
+      oss << ids[i];
+      for (int j = 0; j < dim; ++j) {
+        oss << ' ' << values[(size_t)i * dim + j];
+      }
+      oss << "\n";
+    }
+    return (int64_t)batch;
+  });
+
+  std::string buf;
+  runner->Run("EmbeddingDump/TextBuffer", [&](int /*thread_id*/) {
+    TextBuffer text;
+    text.Swap(&buf);
+    for (int i = 0; i < batch; ++i) {
+      text.Append((uint64_t)ids[i]);
+      for (int j = 0; j < dim; ++j) {
+        text.Append(' ');
+        text.Append(values[(size_t)i * dim + j]);
+      }
+      text.Append('\n');
+    }
+    text.Swap(&buf);
+    return (int64_t)batch;
+  });
+
+  for (auto dtype :
+       {EmbeddingDtypeEnum::FLOAT32, EmbeddingDtypeEnum::FLOAT16}) {
+    std::string name = dtype == EmbeddingDtypeEnum::FLOAT32
+                           ? "EmbeddingDump/float32"
+                           : "EmbeddingDump/float16";
+    runner->Run(name, [&](int /*thread_id*/) {
+      buf.clear();
+      AppendEmbeddingBlock(dtype, dim, ids.data(), values.data(), batch,
+                           &buf);
+      return (int64_t)batch;
+    });
+  }
+}
+
+void BenchIO(const BenchEnv& env, BenchRunner* runner) {
+  BenchLineParser(env, runner);
+  BenchLoader(env, runner);
+  BenchEmbeddingDump(env, runner);
+}
+
+}  // namespace
+
+BENCH_SUITE_REGISTER(io, &BenchIO);
+
+}  // namespace embedx
@@ -0,0 +1,245 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+#include <deepx_core/graph/graph.h>
+#include <deepx_core/graph/graph_node.h>
+#include <deepx_core/graph/op_context.h>
+#include <deepx_core/graph/tensor_map.h>
+#include <deepx_core/tensor/data_type.h>
+
+#include <algorithm>  // std::min
+#include <functional>
+#include <memory>  // std::unique_ptr
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/common/parallel_util.h"
+#include "src/model/op/gnn_graph_node.h"
+#include "src/tools/bench/bench_util.h"
+
+namespace embedx {
+namespace {
+
+// Neighbors per row follow the node degrees of the power law graph, capped as
+// a neighbor sampler would do.
+constexpr int MAX_ROW_NNZ = 64;
+constexpr int DIM = 64;
+constexpr int NUM_HEAD = 4;
+constexpr int WEIGHTED_AVERAGE_K = 8;
+// a user against its positive and negative items, as in youtube_dnn
+constexpr int NUM_NEGATIVE = 10;
+constexpr int ITEM_DIM = 128;
+
+using int_t = deepx_core::DataType::int_t;
+using csr_t = deepx_core::DataType::csr_t;
+using tsr_t = deepx_core::DataType::tsr_t;
+using inst_initializer_t = std::function<void(deepx_core::Instance* inst)>;
+
+/************************************************************************/
+/* OpBench */
+/************************************************************************/
+class OpBench {
+ private:
+  std::default_random_engine engine_;
+  std::unique_ptr<GraphNode> loss_node_;
+  deepx_core::Graph graph_;
+  deepx_core::TensorMap param_;
+  deepx_core::OpContext op_context_;
+
+ public:
+  OpBench(GraphNode* node, const inst_initializer_t& inst_initializer,
+          uint32_t seed)
+      : engine_(seed) {
+    loss_node_.reset(new deepx_core::ReduceMeanNode("bench_loss", node));
+    DXCHECK_THROW(graph_.Compile({loss_node_.get()}, 0));
+    InitParam();
+
+    inst_initializer(op_context_.mutable_hidden()->mutable_inst());
+    op_context_.Init(&graph_, &param_);
+    DXCHECK_THROW(op_context_.InitOp(std::vector<int>{0}, 0));
+    op_context_.InitForward();
+    op_context_.InitBackward();
+  }
+
+  void Run(const std::string& name, int64_t items, BenchRunner* runner) {
+    runner->Run(name + "/Forward", [this, items](int /*thread_id*/) {
+      op_context_.Forward();
+      return items;
+    });
+    runner->Run(name + "/ForwardBackward", [this, items](int /*thread_id*/) {
+      op_context_.Forward();
+      op_context_.Backward();
+      return items;
+    });
+  }
+
+ private:
+  void InitParam() {
+    for (const auto& entry : graph_.name_2_node()) {
+      const GraphNode* node = entry.second;
+      if (node->node_type() != deepx_core::GRAPH_NODE_TYPE_PARAM) {
+        continue;
+      }
+      DXCHECK_THROW(node->tensor_type() == deepx_core::TENSOR_TYPE_TSR);
+      auto& W = param_.insert<tsr_t>(node->name());
+      W.resize(node->shape());
+      W.rand_init(engine_, node->initializer_type(),
+                  (deepx_core::DataType::float_t)node->initializer_param1(),
+                  (deepx_core::DataType::float_t)node->initializer_param2());
+    }
+  }
+};
+
+// CSR of 'row' rows pointing to rows of a table of 'col' rows.
+csr_t MakeNeighborCSR(const BenchEnv& env, int row, int col) {
+  std::default_random_engine engine(env.seed);
+  std::uniform_int_distribution<size_t> node_dist(
+      0, env.graph.degrees.size() - 1);
+  std::uniform_int_distribution<int> col_dist(0, col - 1);
+  csr_t X;
+  for (int i = 0; i < row; ++i) {
+    int nnz = std::min((int)env.graph.degrees[node_dist(engine)], MAX_ROW_NNZ);
+    for (int j = 0; j < nnz; ++j) {
+      X.emplace((int_t)col_dist(engine), 1);
+    }
+    X.add_row();
+  }
+  return X;
+}
+
+csr_t MakeOneHotCSR(int row, int col, uint32_t seed) {
+  std::default_random_engine engine(seed);
+  std::uniform_int_distribution<int> col_dist(0, col - 1);
+  csr_t X;
+  for (int i = 0; i < row; ++i) {
+    X.emplace((int_t)col_dist(engine), 1);
+    X.add_row();
+  }
+  return X;
+}
+
+// CSR repeating each of 'batch' random cols 'repeat' times in a row.
+csr_t MakeRepeatedCSR(int batch, int repeat, int col, uint32_t seed) {
+  std::default_random_engine engine(seed);
+  std::uniform_int_distribution<int> col_dist(0, col - 1);
+  csr_t X;
+  for (int i = 0; i < batch; ++i) {
+    int_t j = (int_t)col_dist(engine);
+    for (int k = 0; k < repeat; ++k) {
+      X.emplace(j, 1);
+      X.add_row();
+    }
+  }
+  return X;
+}
+
+VariableNode* NewVariable(const std::string& name, const Shape& shape,
+                          std::vector<std::unique_ptr<GraphNode>>* nodes) {
+  auto* node = new VariableNode(
+      name, shape, deepx_core::TENSOR_INITIALIZER_TYPE_RANDN, 0, 1);
+  nodes->emplace_back(node);
+  return node;
+}
+
+void BenchModelOp(const BenchEnv& env, BenchRunner* runner) {
+  int row = env.batch * 4;
+  int num_src = env.batch * 16;
+  csr_t X = MakeNeighborCSR(env, row, num_src);
+  int nnz = (int)X.col_size();
+  DXINFO("Model op input: row=%d, nnz=%d, intra op thread num=%d.", row, nnz,
+         GetIntraOpThreadNum());
+
+  auto inst_initializer = [&X](deepx_core::Instance* inst) {
+    inst->insert<csr_t>("X") = X;
+  };
+  InstanceNode Xnode("X", Shape(-1, 0), deepx_core::TENSOR_TYPE_CSR);
+
+  // nodes must outlive the graphs compiled from them
+  std::vector<std::unique_ptr<GraphNode>> nodes;
+  auto run = [&](const std::string& name, GraphNode* node,
+                 const inst_initializer_t& initializer) {
+    nodes.emplace_back(node);
+    OpBench bench(node, initializer, env.seed);
+    bench.Run(name, row, runner);
+  };
+
+  run("MeanAggregator",
+      new MeanAggregatorNode("Z", &Xnode,
+                             NewVariable("W", Shape(num_src, DIM), &nodes)),
+      inst_initializer);
+  run("SumAggregator",
+      new SumAggregatorNode("Z", &Xnode,
+                            NewVariable("W", Shape(num_src, DIM), &nodes)),
+      inst_initializer);
+  run("HiddenLookup",
+      new HiddenLookupNode("Z", &Xnode,
+                           NewVariable("W", Shape(num_src, DIM), &nodes)),
+      inst_initializer);
+  run("EdgeSoftmax",
+      new EdgeSoftmaxNode("Z", &Xnode,
+                          NewVariable("W", Shape(NUM_HEAD, nnz), &nodes)),
+      inst_initializer);
+
+  int head_dim = DIM / NUM_HEAD;
+  run("GATAttention",
+      new GATAttentionNode(
+          "Z", &Xnode, NewVariable("Hs", Shape(num_src, DIM), &nodes),
+          NewVariable("Hd", Shape(row, DIM), &nodes),
+          NewVariable("As", Shape(NUM_HEAD, head_dim), &nodes),
+          NewVariable("Ad", Shape(NUM_HEAD, head_dim), &nodes)),
+      inst_initializer);
+
+  run("WeightedAverage",
+      new WeightedAverageNode(
+          "Z",
+          NewVariable("X", Shape(row, WEIGHTED_AVERAGE_K * DIM), &nodes),
+          NewVariable("W", Shape(row, WEIGHTED_AVERAGE_K), &nodes)),
+      [](deepx_core::Instance* /*inst*/) {});
+
+  csr_t Xin = MakeOneHotCSR(row, num_src, env.seed);
+  csr_t Xout = MakeOneHotCSR(row, num_src, env.seed + 1);
+  InstanceNode Xin_node("Xin", Shape(-1, 0), deepx_core::TENSOR_TYPE_CSR);
+  InstanceNode Xout_node("Xout", Shape(-1, 0), deepx_core::TENSOR_TYPE_CSR);
+  run("BatchLookupDot",
+      new BatchLookupDotNode("Z", &Xin_node, &Xout_node,
+                             NewVariable("Win", Shape(num_src, DIM), &nodes),
+                             NewVariable("Wout", Shape(num_src, DIM), &nodes)),
+      [&Xin, &Xout](deepx_core::Instance* inst) {
+        inst->insert<csr_t>("Xin") = Xin;
+        inst->insert<csr_t>("Xout") = Xout;
+      });
+
+  int item_row = env.batch * (1 + NUM_NEGATIVE);
+  csr_t user = MakeRepeatedCSR(env.batch, 1 + NUM_NEGATIVE, num_src, env.seed);
+  csr_t item = MakeOneHotCSR(item_row, num_src, env.seed + 1);
+  auto* item_node = new BatchLookupDotNode(
+      "Z", &Xin_node, &Xout_node,
+      NewVariable("Win", Shape(num_src, ITEM_DIM), &nodes),
+      NewVariable("Wout", Shape(num_src, ITEM_DIM), &nodes));
+  nodes.emplace_back(item_node);
+  OpBench item_bench(
+      item_node,
+      [&user, &item](deepx_core::Instance* inst) {
+        inst->insert<csr_t>("Xin") = user;
+        inst->insert<csr_t>("Xout") = item;
+      },
+      env.seed);
+  item_bench.Run("BatchLookupDot/Negative", item_row, runner);
+  // Assemble only copies rows into a cache SRM, it is not benchmarked.
+}
+
+}  // namespace
+
+BENCH_SUITE_REGISTER(model_op, &BenchModelOp);
+
+}  // namespace embedx
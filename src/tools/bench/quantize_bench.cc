@@ -0,0 +1,114 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+#include <deepx_core/graph/tensor_map.h>
+#include <deepx_core/tensor/data_type.h>
+
+#include <algorithm>  // std::copy, std::sort
+#include <random>     // std::normal_distribution
+#include <string>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/common/quantized_rows.h"
+#include "src/common/random.h"
+#include "src/tools/bench/bench_util.h"
+#include "src/tools/quantized_model.h"
+
+namespace embedx {
+namespace {
+
+using srm_t = deepx_core::DataType::srm_t;
+
+constexpr int BATCH_NUM = 64;
+
+// Resident memory of an embedding table of the generated graph nodes in a
+// srm of deepx_core, as ModelServer loads it, against its QuantizedModel, and
+// the lookup of a batch of rows from both.
+void BenchQuantize(const BenchEnv& env, BenchRunner* runner) {
+  const vec_int_t& nodes = env.graph.nodes;
+  auto batches = MakeBatches(nodes, env.batch, BATCH_NUM, env.seed);
+  std::vector<size_t> next(env.thread_num, 0);
+  auto next_batch = [&batches, &next](int thread_id) -> const vec_int_t& {
+    return batches[next[thread_id]++ % batches.size()];
+  };
+
+  for (int dim : {8, 32, 128}) {
+    std::string prefix = "dim" + std::to_string(dim) + "/";
+    RandomEngine engine(env.seed, (uint64_t)dim);
+    std::normal_distribution<float> normal;
+    std::vector<float> row(dim);
+
+    // the table first and then the quantized copy, nothing is freed in
+    // between, so that the deltas are the bytes of each
+    int64_t resident = ResidentBytes();
+    deepx_core::TensorMap param;
+    auto& W = param.insert<srm_t>("W");
+    W.set_col(dim);
+    for (auto node : nodes) {
+      for (auto& value : row) {
+        value = normal(engine);
+      }
+      W.assign(node, row.data());
+    }
+    int64_t srm_bytes = ResidentBytes() - resident;
+
+    resident = ResidentBytes();
+    QuantizedModel model;
+    DXCHECK_THROW(model.Init(param));
+    int64_t quantized_bytes = ResidentBytes() - resident;
+    DXINFO("%ssrm of %zu rows takes %.2f MB, quantized %.2f MB (%zu bytes of "
+           "rows), %.2fx.",
+           prefix.c_str(), nodes.size(), srm_bytes / 1048576.0,
+           quantized_bytes / 1048576.0, model.srm_memory_bytes(),
+           quantized_bytes > 0 ? 1.0 * srm_bytes / quantized_bytes : 0.0);
+
+    runner->Run(prefix + "srm/Lookup", [&W, &next_batch, dim](int thread_id) {
+      const auto& batch = next_batch(thread_id);
+      std::vector<float> out(dim);
+      for (auto node : batch) {
+        const float* Wi = W.get_row_no_init(node);
+        if (Wi != nullptr) {
+          std::copy(Wi, Wi + dim, out.begin());
+        }
+      }
+      return (int64_t)batch.size();
+    });
+
+    QuantizedRows rows;
+    rows.Init(dim);
+    rows.Reserve(nodes.size(), true);
+    vec_int_t sorted_nodes(nodes);
+    std::sort(sorted_nodes.begin(), sorted_nodes.end());
+    for (auto node : sorted_nodes) {
+      DXCHECK_THROW(rows.AddRow(node, W.get_row_no_init(node)));
+    }
+    runner->Run(prefix + "quantized/Lookup",
+                [&rows, &next_batch, dim](int thread_id) {
+                  const auto& batch = next_batch(thread_id);
+                  std::vector<float> out(dim);
+                  for (auto node : batch) {
+                    size_t pos = rows.Find(node);
+                    if (pos != QuantizedRows::NPOS) {
+                      rows.GetRow(pos, out.data());
+                    }
+                  }
+                  return (int64_t)batch.size();
+                });
+  }
+}
+
+}  // namespace
+
+BENCH_SUITE_REGISTER(quantize, &BenchQuantize);
+
+}  // namespace embedx
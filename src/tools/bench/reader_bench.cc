@@ -0,0 +1,190 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+#include <deepx_core/graph/tensor_map.h>  // Instance
+
+#include <memory>  // std::unique_ptr
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/graph/client/graph_client.h"
+#include "src/io/indexing.h"
+#include "src/model/data_flow/neighbor_aggregation_flow.h"
+#include "src/model/instance_reader_util.h"
+#include "src/tools/bench/bench_util.h"
+
+namespace embedx {
+namespace {
+
+constexpr int BATCH_NUM = 64;
+const std::vector<int> NUM_NEIGHBORS = {10, 10};
+
+// bytes of the rows of a feature matrix
+double FeatureBytes(const csr_t& feats) {
+  return (double)feats.col_size() * (sizeof(int_t) + sizeof(float_t)) +
+         (double)feats.row() * sizeof(int);
+}
+
+// level nodes and indexings of sampled subgraphs, before the flat tables
+struct NodeContainers {
+  std::vector<std::unordered_set<int_t>> level_nodes;
+  std::vector<std::unordered_map<int_t, int>> indexings;
+};
+
+// The part of the readers of graphsage like models that doesn't depend on
+// the model, a subgraph is sampled, indexed and filled into an instance.
+void BenchReader(const BenchEnv& env, BenchRunner* runner) {
+  auto client =
+      NewGraphClient(NewBenchGraphConfig(env), GraphClientEnum::LOCAL);
+  DXCHECK_THROW(client);
+  auto flow = NewNeighborAggregationFlow(client.get());
+  auto shared_flow = NewNeighborAggregationFlow(client.get());
+  shared_flow->set_shared_feature(true);
+
+  auto batches = MakeBatches(env.graph.nodes, env.batch, BATCH_NUM, env.seed);
+  std::vector<size_t> next(env.thread_num, 0);
+  auto next_batch = [&batches, &next](int thread_id) -> const vec_int_t& {
+    return batches[next[thread_id]++ % batches.size()];
+  };
+
+  // presampled subgraphs, to time the containers alone
+  std::vector<vec_map_neigh_t> level_neighs_list(batches.size());
+  for (size_t i = 0; i < batches.size(); ++i) {
+    vec_set_t level_nodes;
+    flow->SampleSubGraph(batches[i], NUM_NEIGHBORS, &level_nodes,
+                         &level_neighs_list[i]);
+  }
+  int graph_depth = (int)NUM_NEIGHBORS.size();
+
+  std::vector<NodeContainers> std_containers(env.thread_num);
+  runner->Run("Indexing/std", env.thread_num, [&](int thread_id) {
+    size_t i = next[thread_id]++ % batches.size();
+    const auto& level_neighs = level_neighs_list[i];
+    auto& level_nodes = std_containers[thread_id].level_nodes;
+    auto& indexings = std_containers[thread_id].indexings;
+    level_nodes.resize(graph_depth + 1);
+    level_nodes[0].clear();
+    level_nodes[0].insert(batches[i].begin(), batches[i].end());
+    for (int j = 0; j < graph_depth; ++j) {
+      level_nodes[j + 1].clear();
+      for (auto node : level_nodes[j]) {
+        const auto& neighbors = level_neighs[j].at(node);
+        level_nodes[j + 1].insert(neighbors.begin(), neighbors.end());
+      }
+    }
+
+    indexings.clear();
+    indexings.resize(level_nodes.size());
+    int k = 0;
+    for (size_t j = 0; j < level_nodes.size(); ++j) {
+      for (auto node : level_nodes[j]) {
+        indexings[j].emplace(node, k++);
+      }
+    }
+    return (int64_t)k;
+  });
+
+  std::vector<vec_set_t> level_nodes_list(env.thread_num);
+  std::vector<std::vector<Indexing>> indexings_list(env.thread_num);
+  runner->Run("Indexing/flat", env.thread_num, [&](int thread_id) {
+    size_t i = next[thread_id]++ % batches.size();
+    const auto& level_neighs = level_neighs_list[i];
+    auto& level_nodes = level_nodes_list[thread_id];
+    level_nodes.resize(graph_depth + 1);
+    level_nodes[0].clear();
+    level_nodes[0].insert(batches[i].begin(), batches[i].end());
+    for (int j = 0; j < graph_depth; ++j) {
+      level_nodes[j + 1].clear();
+      for (auto node : level_nodes[j]) {
+        const auto& neighbors = level_neighs[j].at(node);
+        level_nodes[j + 1].insert(neighbors.begin(), neighbors.end());
+      }
+    }
+
+    inst_util::CreateIndexings(level_nodes, &indexings_list[thread_id]);
+    int64_t k = 0;
+    for (const auto& nodes : level_nodes) {
+      k += (int64_t)nodes.size();
+    }
+    return k;
+  });
+
+  std::vector<vec_map_neigh_t> level_neighs_buf(env.thread_num);
+  std::vector<Instance> insts(env.thread_num);
+  runner->Run("SubGraph", env.thread_num, [&](int thread_id) {
+    const auto& nodes = next_batch(thread_id);
+    auto& level_nodes = level_nodes_list[thread_id];
+    auto& level_neighs = level_neighs_buf[thread_id];
+    auto& indexings = indexings_list[thread_id];
+    flow->SampleSubGraph(nodes, NUM_NEIGHBORS, &level_nodes, &level_neighs);
+    inst_util::CreateIndexings(level_nodes, &indexings);
+    flow->FillSelfAndNeighGraphBlock(&insts[thread_id], "self_block",
+                                     "neigh_block", level_nodes, level_neighs,
+                                     indexings, true);
+    return (int64_t)nodes.size();
+  });
+
+  runner->Run("SubGraphFeature", env.thread_num, [&](int thread_id) {
+    const auto& nodes = next_batch(thread_id);
+    auto& level_nodes = level_nodes_list[thread_id];
+    auto& level_neighs = level_neighs_buf[thread_id];
+    auto& indexings = indexings_list[thread_id];
+    Instance* inst = &insts[thread_id];
+    flow->SampleSubGraph(nodes, NUM_NEIGHBORS, &level_nodes, &level_neighs);
+    flow->FillLevelNodeFeature(inst, "node_feature", level_nodes);
+    inst_util::CreateIndexings(level_nodes, &indexings);
+    flow->FillSelfAndNeighGraphBlock(inst, "self_block", "neigh_block",
+                                     level_nodes, level_neighs, indexings,
+                                     true);
+    return (int64_t)nodes.size();
+  });
+
+  runner->Run("SubGraphFeature/shared", env.thread_num, [&](int thread_id) {
+    const auto& nodes = next_batch(thread_id);
+    auto& level_nodes = level_nodes_list[thread_id];
+    auto& level_neighs = level_neighs_buf[thread_id];
+    auto& indexings = indexings_list[thread_id];
+    Instance* inst = &insts[thread_id];
+    shared_flow->SampleSubGraph(nodes, NUM_NEIGHBORS, &level_nodes,
+                                &level_neighs);
+    shared_flow->FillLevelNodeFeature(inst, "node_feature", level_nodes);
+    inst_util::CreateIndexings(level_nodes, &indexings);
+    shared_flow->FillSelfAndNeighGraphBlock(inst, "self_block", "neigh_block",
+                                            level_nodes, level_neighs,
+                                            indexings, true);
+    return (int64_t)nodes.size();
+  });
+
+  // feature bytes of the same subgraphs in both layouts
+  double level_bytes = 0, shared_bytes = 0;
+  Instance inst;
+  for (const auto& nodes : batches) {
+    vec_set_t level_nodes;
+    vec_map_neigh_t level_neighs;
+    flow->SampleSubGraph(nodes, NUM_NEIGHBORS, &level_nodes, &level_neighs);
+    flow->FillLevelNodeFeature(&inst, "level_feature", level_nodes);
+    shared_flow->FillLevelNodeFeature(&inst, "shared_feature", level_nodes);
+    level_bytes += FeatureBytes(inst.get_or_insert<csr_t>("level_feature"));
+    shared_bytes += FeatureBytes(inst.get_or_insert<csr_t>("shared_feature"));
+  }
+  DXINFO("Feature bytes per batch: level=%.1fKB, shared=%.1fKB.",
+         level_bytes / batches.size() / 1024,
+         shared_bytes / batches.size() / 1024);
+}
+
+}  // namespace
+
+BENCH_SUITE_REGISTER(reader, &BenchReader);
+
+}  // namespace embedx
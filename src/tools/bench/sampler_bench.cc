@@ -0,0 +1,114 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+
+#include <memory>  // std::unique_ptr
+#include <string>
+#include <utility>  // std::pair
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/graph/in_memory_graph.h"
+#include "src/sampler/negative_sampler.h"
+#include "src/sampler/neighbor_sampler.h"
+#include "src/sampler/random_walker.h"
+#include "src/sampler/random_walker_data_types.h"
+#include "src/sampler/sampler_builder.h"
+#include "src/sampler/sampler_source.h"
+#include "src/sampler/sampling.h"
+#include "src/tools/bench/bench_util.h"
+
+namespace embedx {
+namespace {
+
+constexpr int BATCH_NUM = 64;
+constexpr int NEIGHBOR_COUNT = 10;
+constexpr int NEGATIVE_COUNT = 5;
+constexpr int WALK_LEN = 10;
+
+void BenchSampler(const BenchEnv& env, BenchRunner* runner) {
+  auto graph = InMemoryGraph::Create(NewBenchGraphConfig(env));
+  DXCHECK_THROW(graph);
+  auto sampler_source = NewGraphSamplerSource(graph.get());
+  DXCHECK_THROW(sampler_source);
+
+  auto batches =
+      MakeBatches(graph->node_keys(), env.batch, BATCH_NUM, env.seed);
+  std::vector<size_t> next(env.thread_num, 0);
+  auto next_batch = [&batches, &next](int thread_id) -> const vec_int_t& {
+    return batches[next[thread_id]++ % batches.size()];
+  };
+
+  const std::vector<std::pair<std::string, SamplingEnum>> types = {
+      {"uniform", SamplingEnum::UNIFORM}, {"alias", SamplingEnum::ALIAS}};
+  for (const auto& type : types) {
+    auto neighbor_builder = NewSamplerBuilder(
+        sampler_source.get(), SamplerBuilderEnum::NEIGHBOR_SAMPLER,
+        (int)type.second, env.thread_num);
+    DXCHECK_THROW(neighbor_builder);
+    auto negative_builder = NewSamplerBuilder(
+        sampler_source.get(), SamplerBuilderEnum::NEGATIVE_SAMPLER,
+        (int)type.second, env.thread_num);
+    DXCHECK_THROW(negative_builder);
+
+    auto neighbor_sampler = NewNeighborSampler(neighbor_builder.get());
+    runner->Run(
+        "NeighborSampler/" + type.first, env.thread_num, [&](int thread_id) {
+          std::vector<vec_int_t> neighbor_nodes_list;
+          const auto& nodes = next_batch(thread_id);
+          DXCHECK_THROW(neighbor_sampler->Sample(NEIGHBOR_COUNT, nodes,
+                                                 &neighbor_nodes_list));
+          return (int64_t)nodes.size() * NEIGHBOR_COUNT;
+        });
+
+    const std::vector<std::pair<std::string, NegativeSamplerEnum>>
+        negative_types = {{"shared", NegativeSamplerEnum::SHARED},
+                          {"independent", NegativeSamplerEnum::INDEPENDENT}};
+    for (const auto& negative_type : negative_types) {
+      auto negative_sampler =
+          NewNegativeSampler(negative_builder.get(), negative_type.second);
+      DXCHECK_THROW(negative_sampler);
+      runner->Run("NegativeSampler/" + negative_type.first + "/" + type.first,
+                  env.thread_num, [&](int thread_id) {
+                    std::vector<vec_int_t> sampled_nodes_list;
+                    const auto& nodes = next_batch(thread_id);
+                    DXCHECK_THROW(negative_sampler->Sample(
+                        NEGATIVE_COUNT, nodes, nodes, &sampled_nodes_list));
+                    return (int64_t)nodes.size() * NEGATIVE_COUNT;
+                  });
+    }
+
+    auto random_walker =
+        NewRandomWalker(neighbor_builder.get(), RandomWalkerEnum::STATIC);
+    DXCHECK_THROW(random_walker);
+    std::vector<int> walk_lens(env.batch, WALK_LEN);
+    WalkerInfo walker_info;
+    runner->Run("StaticRandomWalker/" + type.first, env.thread_num,
+                [&](int thread_id) {
+                  std::vector<vec_int_t> seqs;
+                  const auto& nodes = next_batch(thread_id);
+                  random_walker->Traverse(nodes, walk_lens, walker_info, &seqs,
+                                          nullptr);
+                  int64_t items = 0;
+                  for (const auto& seq : seqs) {
+                    items += (int64_t)seq.size();
+                  }
+                  return items;
+                });
+  }
+}
+
+}  // namespace
+
+BENCH_SUITE_REGISTER(sampler, &BenchSampler);
+
+}  // namespace embedx
@@ -0,0 +1,101 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::min
+#include <memory>     // std::unique_ptr
+#include <string>
+#include <utility>  // std::pair
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/common/random.h"
+#include "src/sampler/sampling.h"
+#include "src/tools/bench/bench_util.h"
+
+namespace embedx {
+namespace {
+
+// Node degrees of a power law graph are the probabilities of both negative
+// sampling (over all nodes) and weighted neighbor sampling (over a context).
+void BenchSampling(const BenchEnv& env, BenchRunner* runner) {
+  const vec_float_t& probs = env.graph.degrees;
+  const std::vector<std::pair<std::string, SamplingEnum>> types = {
+      {"uniform", SamplingEnum::UNIFORM},
+      {"alias", SamplingEnum::ALIAS},
+      {"word2vec", SamplingEnum::WORD2VEC},
+      {"partial_sum", SamplingEnum::PARTIAL_SUM},
+      {"compact_alias", SamplingEnum::COMPACT_ALIAS}};
+
+  int batch = env.batch;
+  runner->Run("random/Next", [batch](int /*thread_id*/) {
+    auto& engine = ThreadLocalRandomEngine();
+    for (int i = 0; i < batch; ++i) {
+      (void)engine.NextDouble();
+    }
+    return (int64_t)batch;
+  });
+
+  std::vector<double> randoms(batch);
+  runner->Run("random/NextDoubles", [&randoms, batch](int /*thread_id*/) {
+    ThreadLocalRandomEngine().NextDoubles(batch, randoms.data());
+    return (int64_t)batch;
+  });
+
+  for (const auto& type : types) {
+    // memory of a table, before the builds below leave freed pages around
+    int64_t resident = ResidentBytes();
+    {
+      auto sampling = NewSampling(&probs, type.second);
+      DXCHECK_THROW(sampling);
+      DXINFO("%s table of %zu nodes takes %.2f MB.", type.first.c_str(),
+             probs.size(), (ResidentBytes() - resident) / 1048576.0);
+    }
+
+    runner->Run(type.first + "/Build", [&probs, &type](int /*thread_id*/) {
+      auto sampling = NewSampling(&probs, type.second);
+      DXCHECK_THROW(sampling);
+      return (int64_t)probs.size();
+    });
+
+    auto sampling = NewSampling(&probs, type.second);
+    DXCHECK_THROW(sampling);
+    runner->Run(type.first + "/Next", [&sampling, batch](int /*thread_id*/) {
+      for (int i = 0; i < batch; ++i) {
+        (void)sampling->Next();
+      }
+      return (int64_t)batch;
+    });
+
+    runner->Run(type.first + "/NextN", [&sampling, batch](int /*thread_id*/) {
+      vec_int_t next;
+      sampling->NextN(batch, &next);
+      return (int64_t)batch;
+    });
+
+    // short ranges, as in sampling the neighbors of one node
+    int range = std::min((int)probs.size(), 64);
+    runner->Run(type.first + "/NextRange",
+                [&sampling, batch, range](int /*thread_id*/) {
+                  for (int i = 0; i < batch; ++i) {
+                    (void)sampling->Next(0, range);
+                  }
+                  return (int64_t)batch;
+                });
+  }
+}
+
+}  // namespace
+
+BENCH_SUITE_REGISTER(sampling, &BenchSampling);
+
+}  // namespace embedx
@@ -0,0 +1,198 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>  // std::unique_ptr
+#include <random>
+#include <thread>
+#include <utility>  // std::move
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/common/epoch.h"
+#include "src/graph/graph_config.h"
+#include "src/graph/in_memory_graph.h"
+#include "src/graph/update_builder.h"
+#include "src/sampler/negative_sampler.h"
+#include "src/sampler/neighbor_sampler.h"
+#include "src/sampler/sampler_builder.h"
+#include "src/sampler/sampler_source.h"
+#include "src/sampler/sampling.h"
+#include "src/tools/bench/bench_util.h"
+
+namespace embedx {
+namespace {
+
+constexpr int BATCH_NUM = 64;
+constexpr int NEIGHBOR_COUNT = 10;
+constexpr int NEGATIVE_COUNT = 5;
+
+struct EdgeBatch {
+  vec_int_t src_nodes;
+  vec_int_t dst_nodes;
+  vec_float_t weights;
+  vecl_t ops;
+
+  void Add(int_t src_node, int_t dst_node, float_t weight, EdgeUpdateEnum op) {
+    src_nodes.emplace_back(src_node);
+    dst_nodes.emplace_back(dst_node);
+    weights.emplace_back(weight);
+    ops.emplace_back((int)op);
+  }
+};
+
+// Pairs of batches, the first inserts new edges and reweights loaded ones,
+// the second deletes them and reweights the loaded ones back, so that every
+// batch changes the graph when they are applied in a loop.
+std::vector<EdgeBatch> MakeEdgeBatches(const InMemoryGraph& graph,
+                                       const vec_int_t& nodes, int batch,
+                                       int batch_num, uint32_t seed) {
+  std::default_random_engine engine(seed);
+  std::uniform_int_distribution<size_t> node_dist(0, nodes.size() - 1);
+  std::uniform_real_distribution<float_t> weight_dist(0.1, 2.0);
+  // 1 of 8 updates reweights a loaded edge
+  std::uniform_int_distribution<int> op_dist(0, 7);
+
+  std::vector<EdgeBatch> batches;
+  for (int i = 0; i < batch_num / 2; ++i) {
+    EdgeBatch insert_batch, delete_batch;
+    for (int j = 0; j < batch; ++j) {
+      int_t src_node = nodes[node_dist(engine)];
+      const auto* context = graph.FindContext(src_node);
+      if (op_dist(engine) == 0 && context != nullptr && !context->empty()) {
+        const auto& pair = context->front();
+        insert_batch.Add(src_node, pair.first, weight_dist(engine),
+                         EdgeUpdateEnum::REWEIGHT);
+        delete_batch.Add(src_node, pair.first, pair.second,
+                         EdgeUpdateEnum::REWEIGHT);
+      } else {
+        int_t dst_node = nodes[node_dist(engine)];
+        insert_batch.Add(src_node, dst_node, weight_dist(engine),
+                         EdgeUpdateEnum::INSERT);
+        delete_batch.Add(src_node, dst_node, 0, EdgeUpdateEnum::DELETE);
+      }
+    }
+    batches.emplace_back(std::move(insert_batch));
+    batches.emplace_back(std::move(delete_batch));
+  }
+  return batches;
+}
+
+// Runs 'func(thread_id)' in 'thread_num' threads until destruction.
+class BackgroundLoop {
+ private:
+  std::atomic<bool> stop_{false};
+  std::vector<std::thread> threads_;
+
+ public:
+  BackgroundLoop(int thread_num, const std::function<void(int)>& func) {
+    for (int i = 0; i < thread_num; ++i) {
+      threads_.emplace_back([this, func, i]() {
+        while (!stop_.load()) {
+          func(i);
+        }
+      });
+    }
+  }
+
+  ~BackgroundLoop() {
+    stop_.store(true);
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+};
+
+// Update throughput and read latency of a graph server, without rpc. Reads
+// pin an epoch like the handlers of graph servers do.
+void BenchUpdate(const BenchEnv& env, BenchRunner* runner) {
+  GraphConfig config = NewBenchGraphConfig(env);
+  config.set_neighbor_sampler_type((int)SamplingEnum::ALIAS);
+  config.set_negative_sampler_type((int)SamplingEnum::ALIAS);
+
+  auto graph = InMemoryGraph::Create(config);
+  DXCHECK_THROW(graph);
+  auto sampler_source = NewGraphSamplerSource(graph.get());
+  DXCHECK_THROW(sampler_source);
+  auto neighbor_builder = NewSamplerBuilder(
+      sampler_source.get(), SamplerBuilderEnum::NEIGHBOR_SAMPLER,
+      config.neighbor_sampler_type(), config.thread_num());
+  DXCHECK_THROW(neighbor_builder);
+  auto negative_builder = NewSamplerBuilder(
+      sampler_source.get(), SamplerBuilderEnum::NEGATIVE_SAMPLER,
+      config.negative_sampler_type(), config.thread_num());
+  DXCHECK_THROW(negative_builder);
+  auto update_builder =
+      UpdateBuilder::Create(graph.get(), neighbor_builder.get(),
+                            negative_builder.get(), config);
+  DXCHECK_THROW(update_builder);
+
+  auto neighbor_sampler = NewNeighborSampler(neighbor_builder.get());
+  auto negative_sampler =
+      NewNegativeSampler(negative_builder.get(), NegativeSamplerEnum::SHARED);
+  DXCHECK_THROW(negative_sampler);
+
+  const auto& nodes = graph->node_keys();
+  auto node_batches = MakeBatches(nodes, env.batch, BATCH_NUM, env.seed);
+  auto edge_batches =
+      MakeEdgeBatches(*graph, nodes, env.batch, BATCH_NUM, env.seed);
+
+  std::atomic<size_t> next_edge_batch{0};
+  auto apply = [&](int) {
+    const auto& batch =
+        edge_batches[next_edge_batch.fetch_add(1) % edge_batches.size()];
+    uint64_t epoch;
+    DXCHECK_THROW(update_builder->Apply(batch.src_nodes, batch.dst_nodes,
+                                        batch.weights, batch.ops, &epoch));
+    return (int64_t)batch.src_nodes.size();
+  };
+
+  std::vector<size_t> next(env.thread_num, 0);
+  auto read = [&](int thread_id) {
+    const auto& batch = node_batches[next[thread_id]++ % node_batches.size()];
+    std::vector<vec_int_t> neighbor_nodes_list, sampled_nodes_list;
+    EpochGuard guard;
+    (void)neighbor_sampler->Sample(NEIGHBOR_COUNT, batch,
+                                   &neighbor_nodes_list);
+    DXCHECK_THROW(negative_sampler->Sample(NEGATIVE_COUNT, batch, batch,
+                                           &sampled_nodes_list));
+    return (int64_t)batch.size();
+  };
+
+  // idle
+  runner->Run("Apply", apply);
+  runner->Run("Read", env.thread_num, read);
+
+  // a writer under readers, and readers under a writer
+  {
+    BackgroundLoop readers(env.thread_num, [&](int thread_id) {
+      (void)read(thread_id);
+    });
+    runner->Run("ApplyUnderRead", apply);
+  }
+  {
+    BackgroundLoop writer(1, [&](int thread_id) { (void)apply(thread_id); });
+    runner->Run("ReadUnderUpdate", env.thread_num, read);
+  }
+
+  DXINFO("Applied %llu edge updates, %zu nodes updated.",
+         (unsigned long long)update_builder->update_num(),
+         graph->updated_node_size());
+}
+
+}  // namespace
+
+BENCH_SUITE_REGISTER(update, &BenchUpdate);
+
+}  // namespace embedx
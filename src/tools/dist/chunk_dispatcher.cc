@@ -0,0 +1,167 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/tools/dist/chunk_dispatcher.h"
+
+#include <deepx_core/dx_log.h>
+
+#include <algorithm>  // std::shuffle
+
+namespace embedx {
+
+bool ChunkDispatcher::Init(const std::vector<std::string>& files,
+                           const ChunkDispatcherConfig& config) {
+  if (files.empty() || config.chunk_size == 0 || config.epoch <= 0) {
+    DXERROR("Need files, chunk_size > 0 and epoch > 0.");
+    return false;
+  }
+
+  config_ = config;
+  // a chunk is leased in 8 pieces
+  lease_size_ = std::max<uint64_t>(config.chunk_size / 8, 1);
+  engine_.seed((std::default_random_engine::result_type)config.seed);
+
+  file_chunks_.clear();
+  std::vector<FileChunk> ranges;
+  for (const std::string& file : files) {
+    ranges.clear();
+    bool splittable = SplitFile(file, config.chunk_size, &ranges);
+    for (const FileChunk& range : ranges) {
+      Chunk chunk;
+      chunk.range = range;
+      chunk.splittable = splittable;
+      file_chunks_.emplace_back(chunk);
+    }
+  }
+
+  epoch_ = 0;
+  StartEpoch();
+  return true;
+}
+
+void ChunkDispatcher::StartEpoch() {
+  chunks_ = file_chunks_;
+  pending_.clear();
+  for (size_t i = 0; i < chunks_.size(); ++i) {
+    pending_.emplace_back(i);
+  }
+  if (config_.shuffle) {
+    std::shuffle(pending_.begin(), pending_.end(), engine_);
+  }
+  finished_num_ = 0;
+  loss_ = 0;
+  loss_weight_ = 0;
+}
+
+ChunkDispatcher::Chunk* ChunkDispatcher::Find(uint64_t id) noexcept {
+  size_t index = (size_t)(id & 0xffffffff);
+  if ((int)(id >> 32) != epoch_ || index >= chunks_.size()) {
+    return nullptr;
+  }
+  return &chunks_[index];
+}
+
+uint64_t ChunkDispatcher::Lease(Chunk* chunk, uint64_t pos) const noexcept {
+  if (chunk->splittable) {
+    // a long line may run past the leased bytes
+    uint64_t from = std::max(chunk->leased_end, pos);
+    chunk->leased_end = std::max(
+        chunk->leased_end, std::min(from + lease_size_, chunk->range.end));
+    return chunk->leased_end;
+  }
+  return FILE_CHUNK_END;
+}
+
+bool ChunkDispatcher::Split(size_t* index) {
+  // the running chunk with the most unleased bytes
+  size_t max_index = chunks_.size();
+  uint64_t max_unleased = 0;
+  for (size_t i = 0; i < chunks_.size(); ++i) {
+    const Chunk& chunk = chunks_[i];
+    if (chunk.state == StateEnum::RUNNING && chunk.splittable &&
+        chunk.range.end > chunk.leased_end &&
+        chunk.range.end - chunk.leased_end > max_unleased) {
+      max_index = i;
+      max_unleased = chunk.range.end - chunk.leased_end;
+    }
+  }
+  // too little to share
+  if (max_index == chunks_.size() || max_unleased < 2 * lease_size_) {
+    return false;
+  }
+
+  Chunk chunk = chunks_[max_index];
+  uint64_t mid = chunk.leased_end + max_unleased / 2;
+  chunks_[max_index].range.end = mid;
+  chunk.range.begin = mid;
+  chunk.leased_end = mid;
+  chunks_.emplace_back(chunk);
+  *index = chunks_.size() - 1;
+  return true;
+}
+
+ChunkStatusEnum ChunkDispatcher::Next(uint64_t* id, FileChunk* chunk,
+                                      int* epoch) {
+  if (done()) {
+    return ChunkStatusEnum::DONE;
+  }
+
+  size_t index;
+  if (!pending_.empty()) {
+    index = pending_.front();
+    pending_.pop_front();
+  } else if (!config_.speculative || !Split(&index)) {
+    return ChunkStatusEnum::WAIT;
+  }
+
+  Chunk* dispatched = &chunks_[index];
+  dispatched->state = StateEnum::RUNNING;
+  dispatched->leased_end = dispatched->range.begin;
+  *id = MakeId(index);
+  *chunk = dispatched->range;
+  chunk->end = Lease(dispatched, dispatched->range.begin);
+  *epoch = epoch_;
+  return ChunkStatusEnum::CHUNK;
+}
+
+bool ChunkDispatcher::Extend(uint64_t id, uint64_t pos, uint64_t* end) {
+  Chunk* chunk = Find(id);
+  if (chunk == nullptr || chunk->state != StateEnum::RUNNING) {
+    return false;
+  }
+  *end = Lease(chunk, pos);
+  return true;
+}
+
+bool ChunkDispatcher::Finish(uint64_t id, double loss, double loss_weight) {
+  Chunk* chunk = Find(id);
+  if (chunk == nullptr || chunk->state != StateEnum::RUNNING) {
+    return false;
+  }
+
+  chunk->state = StateEnum::FINISHED;
+  loss_ += loss;
+  loss_weight_ += loss_weight;
+  if (++finished_num_ < chunks_.size()) {
+    return true;
+  }
+
+  if (loss_weight_ > 0) {
+    DXINFO("Epoch %d: loss=%f.", epoch_ + 1, loss_ / loss_weight_);
+  }
+  DXINFO("Epoch %d completed with %zu chunks.", epoch_ + 1, chunks_.size());
+  if (++epoch_ < config_.epoch) {
+    StartEpoch();
+  }
+  return true;
+}
+
+}  // namespace embedx
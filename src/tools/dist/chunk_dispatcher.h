@@ -0,0 +1,110 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/io/file_chunk.h"
+
+namespace embedx {
+
+enum class ChunkStatusEnum : int {
+  CHUNK = 0,  // got a chunk
+  WAIT = 1,   // no chunk for now, chunks of the epoch are running
+  DONE = 2,   // all epochs are done
+};
+
+struct ChunkDispatcherConfig {
+  uint64_t chunk_size = 64 << 20;
+  int epoch = 1;
+  bool shuffle = false;
+  // Splits the tail of a running chunk for an idle worker.
+  bool speculative = false;
+  uint64_t seed = 0;
+};
+
+// ChunkDispatcher dispatches byte-range chunks of files to workers epoch by
+// epoch.
+//
+// Local uncompressed files are split into chunks of about 'chunk_size' bytes,
+// others are whole chunks. A worker leases a chunk piece by piece, see
+// Extend(). When nothing is pending, the unleased half of the running chunk
+// with the most unleased bytes is split off to an idle worker if
+// 'speculative' is true, so a straggler leaves less behind. The split moves
+// the end of the running chunk, its worker stops there, and every line is
+// read once per epoch.
+//
+// It is not thread safe.
+class ChunkDispatcher {
+ private:
+  enum class StateEnum : int {
+    PENDING = 0,
+    RUNNING = 1,
+    FINISHED = 2,
+  };
+
+  struct Chunk {
+    FileChunk range;
+    bool splittable = false;
+    StateEnum state = StateEnum::PENDING;
+    // the end of the leased bytes
+    uint64_t leased_end = 0;
+  };
+
+  ChunkDispatcherConfig config_;
+  uint64_t lease_size_ = 0;
+  std::default_random_engine engine_;
+  std::vector<Chunk> file_chunks_;
+
+  // of the current epoch, split chunks are appended
+  int epoch_ = 0;
+  std::vector<Chunk> chunks_;
+  std::deque<size_t> pending_;
+  size_t finished_num_ = 0;
+  double loss_ = 0;
+  double loss_weight_ = 0;
+
+ public:
+  bool Init(const std::vector<std::string>& files,
+            const ChunkDispatcherConfig& config);
+
+  int epoch() const noexcept { return epoch_; }
+  bool done() const noexcept { return epoch_ >= config_.epoch; }
+  size_t file_chunk_size() const noexcept { return file_chunks_.size(); }
+
+  // Gets the next chunk of 'epoch' with 'id', its end is the end of the first
+  // lease, or FILE_CHUNK_END for a whole chunk.
+  ChunkStatusEnum Next(uint64_t* id, FileChunk* chunk, int* epoch);
+
+  // Extends the lease of chunk 'id' read to 'pos', '*end' gets the new end.
+  // The end stays if the chunk is all leased. Returns false for an unknown
+  // chunk.
+  bool Extend(uint64_t id, uint64_t pos, uint64_t* end);
+
+  // Finishes chunk 'id' with its loss, the last chunk of an epoch starts the
+  // next one. Returns false and ignores a duplicate or unknown chunk.
+  bool Finish(uint64_t id, double loss, double loss_weight);
+
+ private:
+  void StartEpoch();
+  Chunk* Find(uint64_t id) noexcept;
+  uint64_t Lease(Chunk* chunk, uint64_t pos) const noexcept;
+  bool Split(size_t* index);
+  uint64_t MakeId(size_t index) const noexcept {
+    return ((uint64_t)epoch_ << 32) | (uint64_t)index;
+  }
+};
+
+}  // namespace embedx
@@ -0,0 +1,208 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/tools/dist/chunk_dispatcher.h"
+
+#include <deepx_core/common/stream.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/io/line_parser.h"
+#include "src/io/value.h"
+
+namespace embedx {
+namespace {
+
+// A worker reading a batch of its chunk per step.
+struct SimWorker {
+  LineParser parser;
+  bool running = false;
+  bool done = false;
+  uint64_t id = 0;
+  std::string file;
+};
+
+const std::string WORK_DIR = "chunk_dispatcher_test";
+constexpr int BATCH = 8;
+
+// Writes 'line_num' lines of nodes from 'first_node' to 'file'.
+void WriteFile(const std::string& file, int first_node, int line_num) {
+  std::ofstream os(file);
+  for (int i = 0; i < line_num; ++i) {
+    os << first_node + i << " " << 1 << "\n";
+  }
+}
+
+// Runs 'workers' in turn until all epochs are done, 'node_counts' gets the
+// times every node is read and 'file_workers' gets the workers of every file.
+void RunWorkers(ChunkDispatcher* dispatcher, std::vector<SimWorker>* workers,
+                std::map<int_t, int>* node_counts,
+                std::map<std::string, std::set<int>>* file_workers) {
+  std::vector<NodeValue> values;
+  for (size_t done_num = 0; done_num < workers->size();) {
+    for (int i = 0; i < (int)workers->size(); ++i) {
+      SimWorker& worker = (*workers)[i];
+      if (worker.done) {
+        continue;
+      }
+
+      if (!worker.running) {
+        FileChunk chunk;
+        int epoch;
+        ChunkStatusEnum status = dispatcher->Next(&worker.id, &chunk, &epoch);
+        if (status == ChunkStatusEnum::DONE) {
+          worker.done = true;
+          ++done_num;
+          continue;
+        }
+        if (status == ChunkStatusEnum::WAIT) {
+          continue;
+        }
+
+        uint64_t id = worker.id;
+        FileChunkExtender extender = [dispatcher, id](uint64_t pos,
+                                                      uint64_t* end) {
+          return dispatcher->Extend(id, pos, end);
+        };
+        ASSERT_TRUE(worker.parser.Open(chunk, extender));
+        worker.file = chunk.file;
+        worker.running = true;
+      }
+
+      if (worker.parser.NextBatch<NodeValue>(BATCH, &values)) {
+        for (const auto& value : values) {
+          (*node_counts)[value.node] += 1;
+        }
+        (*file_workers)[worker.file].insert(i);
+      } else {
+        worker.parser.Close();
+        EXPECT_TRUE(dispatcher->Finish(worker.id, 0, 0));
+        worker.running = false;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+class ChunkDispatcherTest : public ::testing::Test {
+ protected:
+  void SetUp() override { (void)deepx_core::AutoFileSystem::MakeDir(WORK_DIR); }
+};
+
+// 7 files of 100 lines and one of 1000 lines.
+TEST_F(ChunkDispatcherTest, LargeFile) {
+  const int EPOCH = 2;
+  const int WORKER_NUM = 8;
+  std::vector<std::string> files;
+  for (int i = 0; i < 8; ++i) {
+    files.emplace_back(WORK_DIR + "/large-" + std::to_string(i));
+    WriteFile(files.back(), i * 10000, i == 0 ? 1000 : 100);
+  }
+
+  ChunkDispatcherConfig config;
+  config.chunk_size = 1000;
+  config.epoch = EPOCH;
+  config.shuffle = true;
+  ChunkDispatcher dispatcher;
+  ASSERT_TRUE(dispatcher.Init(files, config));
+  EXPECT_GT(dispatcher.file_chunk_size(), files.size());
+
+  std::vector<SimWorker> workers(WORKER_NUM);
+  std::map<int_t, int> node_counts;
+  std::map<std::string, std::set<int>> file_workers;
+  RunWorkers(&dispatcher, &workers, &node_counts, &file_workers);
+
+  EXPECT_TRUE(dispatcher.done());
+  EXPECT_EQ(node_counts.size(), 1700u);
+  for (const auto& entry : node_counts) {
+    EXPECT_EQ(entry.second, EPOCH);
+  }
+  EXPECT_EQ(file_workers[files[0]].size(), (size_t)WORKER_NUM);
+}
+
+// One chunk, idle workers split its tail.
+TEST_F(ChunkDispatcherTest, Speculative) {
+  const int WORKER_NUM = 8;
+  std::vector<std::string> files{WORK_DIR + "/speculative-0"};
+  WriteFile(files[0], 0, 1000);
+
+  for (bool speculative : {false, true}) {
+    ChunkDispatcherConfig config;
+    config.chunk_size = 1 << 13;
+    config.speculative = speculative;
+    ChunkDispatcher dispatcher;
+    ASSERT_TRUE(dispatcher.Init(files, config));
+    EXPECT_EQ(dispatcher.file_chunk_size(), 1u);
+
+    std::vector<SimWorker> workers(WORKER_NUM);
+    std::map<int_t, int> node_counts;
+    std::map<std::string, std::set<int>> file_workers;
+    RunWorkers(&dispatcher, &workers, &node_counts, &file_workers);
+
+    EXPECT_EQ(node_counts.size(), 1000u);
+    for (const auto& entry : node_counts) {
+      EXPECT_EQ(entry.second, 1);
+    }
+    if (speculative) {
+      EXPECT_GT(file_workers[files[0]].size(), 1u);
+    } else {
+      EXPECT_EQ(file_workers[files[0]].size(), 1u);
+    }
+  }
+}
+
+TEST_F(ChunkDispatcherTest, Finish) {
+  std::vector<std::string> files{WORK_DIR + "/finish-0",
+                                 WORK_DIR + "/not_exist"};
+  WriteFile(files[0], 0, 10);
+
+  ChunkDispatcherConfig config;
+  config.epoch = 2;
+  ChunkDispatcher dispatcher;
+  ASSERT_TRUE(dispatcher.Init(files, config));
+
+  uint64_t id1, id2, end;
+  FileChunk chunk;
+  int epoch;
+  ASSERT_EQ(dispatcher.Next(&id1, &chunk, &epoch), ChunkStatusEnum::CHUNK);
+  EXPECT_FALSE(chunk.whole());
+  ASSERT_EQ(dispatcher.Next(&id2, &chunk, &epoch), ChunkStatusEnum::CHUNK);
+  // not a local file, read as a whole
+  EXPECT_TRUE(chunk.whole());
+  EXPECT_EQ(dispatcher.Next(&id2, &chunk, &epoch), ChunkStatusEnum::WAIT);
+
+  // duplicates are ignored
+  EXPECT_TRUE(dispatcher.Finish(id1, 1, 1));
+  EXPECT_FALSE(dispatcher.Finish(id1, 1, 1));
+  EXPECT_FALSE(dispatcher.Extend(id1, 0, &end));
+  EXPECT_FALSE(dispatcher.Finish(id1 + 100, 1, 1));
+
+  // the next epoch
+  EXPECT_TRUE(dispatcher.Finish(id2, 1, 1));
+  EXPECT_EQ(dispatcher.epoch(), 1);
+  EXPECT_FALSE(dispatcher.Finish(id2, 1, 1));
+  ASSERT_EQ(dispatcher.Next(&id1, &chunk, &epoch), ChunkStatusEnum::CHUNK);
+  EXPECT_EQ(epoch, 1);
+  ASSERT_EQ(dispatcher.Next(&id2, &chunk, &epoch), ChunkStatusEnum::CHUNK);
+  EXPECT_TRUE(dispatcher.Finish(id1, 1, 1));
+  EXPECT_TRUE(dispatcher.Finish(id2, 1, 1));
+  EXPECT_TRUE(dispatcher.done());
+  EXPECT_EQ(dispatcher.Next(&id1, &chunk, &epoch), ChunkStatusEnum::DONE);
+}
+
+}  // namespace embedx
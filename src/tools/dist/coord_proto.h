@@ -0,0 +1,149 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <deepx_core/common/stream.h>
+
+#include <cstdint>
+#include <string>
+
+namespace embedx {
+
+// rpc types of the coord server
+constexpr int RPC_TYPE_CHUNK_REQUEST = 0;
+constexpr int RPC_TYPE_CHUNK_EXTEND = 1;
+constexpr int RPC_TYPE_CHUNK_FINISH = 2;
+
+/************************************************************************/
+/* Chunk Request */
+/************************************************************************/
+struct ChunkRequest {
+  // how long the coord server may hold the request for a chunk
+  int wait_ms = 0;
+
+  static int rpc_type() noexcept { return RPC_TYPE_CHUNK_REQUEST; }
+};
+
+struct ChunkResponse {
+  int status = 0;  // ChunkStatusEnum
+  int epoch = 0;
+  uint64_t id = 0;
+  std::string file;
+  uint64_t begin = 0;
+  uint64_t end = 0;
+};
+
+inline deepx_core::OutputStream& operator<<(deepx_core::OutputStream& os,
+                                            const ChunkRequest& req) {
+  os << req.wait_ms;
+  return os;
+}
+
+inline deepx_core::InputStream& operator>>(deepx_core::InputStream& is,
+                                           ChunkRequest& req) {
+  is >> req.wait_ms;
+  return is;
+}
+
+inline deepx_core::OutputStream& operator<<(deepx_core::OutputStream& os,
+                                            const ChunkResponse& resp) {
+  os << resp.status << resp.epoch << resp.id << resp.file << resp.begin
+     << resp.end;
+  return os;
+}
+
+inline deepx_core::InputStream& operator>>(deepx_core::InputStream& is,
+                                           ChunkResponse& resp) {
+  is >> resp.status >> resp.epoch >> resp.id >> resp.file >> resp.begin >>
+      resp.end;
+  return is;
+}
+
+/************************************************************************/
+/* Chunk Extend */
+/************************************************************************/
+struct ChunkExtendRequest {
+  uint64_t id = 0;
+  uint64_t pos = 0;
+
+  static int rpc_type() noexcept { return RPC_TYPE_CHUNK_EXTEND; }
+};
+
+struct ChunkExtendResponse {
+  int found = 0;
+  uint64_t end = 0;
+};
+
+inline deepx_core::OutputStream& operator<<(deepx_core::OutputStream& os,
+                                            const ChunkExtendRequest& req) {
+  os << req.id << req.pos;
+  return os;
+}
+
+inline deepx_core::InputStream& operator>>(deepx_core::InputStream& is,
+                                           ChunkExtendRequest& req) {
+  is >> req.id >> req.pos;
+  return is;
+}
+
+inline deepx_core::OutputStream& operator<<(deepx_core::OutputStream& os,
+                                            const ChunkExtendResponse& resp) {
+  os << resp.found << resp.end;
+  return os;
+}
+
+inline deepx_core::InputStream& operator>>(deepx_core::InputStream& is,
+                                           ChunkExtendResponse& resp) {
+  is >> resp.found >> resp.end;
+  return is;
+}
+
+/************************************************************************/
+/* Chunk Finish */
+/************************************************************************/
+struct ChunkFinishRequest {
+  uint64_t id = 0;
+  double loss = 0;
+  double loss_weight = 0;
+
+  static int rpc_type() noexcept { return RPC_TYPE_CHUNK_FINISH; }
+};
+
+struct ChunkFinishResponse {
+  // 0 for a duplicate or unknown chunk
+  int accepted = 0;
+};
+
+inline deepx_core::OutputStream& operator<<(deepx_core::OutputStream& os,
+                                            const ChunkFinishRequest& req) {
+  os << req.id << req.loss << req.loss_weight;
+  return os;
+}
+
+inline deepx_core::InputStream& operator>>(deepx_core::InputStream& is,
+                                           ChunkFinishRequest& req) {
+  is >> req.id >> req.loss >> req.loss_weight;
+  return is;
+}
+
+inline deepx_core::OutputStream& operator<<(deepx_core::OutputStream& os,
+                                            const ChunkFinishResponse& resp) {
+  os << resp.accepted;
+  return os;
+}
+
+inline deepx_core::InputStream& operator>>(deepx_core::InputStream& is,
+                                           ChunkFinishResponse& resp) {
+  is >> resp.accepted;
+  return is;
+}
+
+}  // namespace embedx
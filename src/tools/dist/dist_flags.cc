@@ -15,6 +15,9 @@
 #include <deepx_core/dx_log.h>
 #include <deepx_core/graph/ts_store.h>
 
+#include <algorithm>  // std::max
+#include <thread>
+
 #include "src/tools/graph/graph_flags.h"
 #include "src/tools/shard_func_name.h"
 
@@ -25,6 +28,10 @@ DEFINE_string(cs_addr, "127.0.0.1:61000", "Coord server address.");
 DEFINE_string(ps_addrs, "127.0.0.1:60000", "Param server addresses.");
 DEFINE_int32(ps_id, 0, "Param server id(role is ps).");
 DEFINE_int32(ps_thread_num, 1, "Number of threads(role is ps).");
+DEFINE_int32(cs_thread_num, 8, "Number of coord server threads(role is ps).");
+DEFINE_int32(cs_wait_num, 64,
+             "Max number of chunk requests held by the coord server, no less "
+             "than the total number of worker threads(role is ps).");
 
 DEFINE_bool(gnn_model, true, "true for GNN models, false for NonGNN models.");
 DEFINE_bool(deep_model, false,
@@ -39,16 +46,24 @@ DEFINE_string(optimizer, "adam", "Optimizer name.");
 DEFINE_string(optimizer_config, "", "Optimizer config.");
 DEFINE_int32(epoch, 1, "Number of epochs.");
 DEFINE_int32(batch, 32, "Batch size(sub_command is train, role is wk).");
+DEFINE_int32(thread_num, 1, "Number of threads(role is wk).");
+DEFINE_int32(intra_op_thread_num, 1,
+             "Number of threads of one GNN op, 0 for number of cores divided "
+             "by thread_num(role is wk).");
 DEFINE_string(in_model, "", "Input dir of model.");
 DEFINE_string(warmup_model, "", "Warmup dir of model.");
 DEFINE_string(in, "", "Input dir/file of training/testing data(role is ps).");
 DEFINE_string(pretrain_path, "", "Input dir/file of pretrain param.");
-DEFINE_string(item_feature, "", "Input dir/file of item feature.");
 DEFINE_string(inst_file, "", "Input dir/file of instance file.");
 DEFINE_string(freq_file, "", "Input dir/file of item frequency.");
 DEFINE_bool(
     shuffle, true,
     "Shuffle input files for each epoch(sub_command is train, role is ps).");
+DEFINE_int32(chunk_size, 64,
+             "Size of a chunk of input files in MB(role is ps).");
+DEFINE_bool(speculative, false,
+            "Split the tail of a running chunk for an idle worker(role is "
+            "ps).");
 DEFINE_bool(ts_enable, false, "Enable timestamp.");
 DEFINE_uint64(ts_now, 0, "Timestamp of now.");
 DEFINE_uint64(ts_expire_threshold, 0, "Timestamp expiration threshold.");
@@ -69,6 +84,9 @@ DEFINE_int32(out_model_fkv_pb_version, 2,
 DEFINE_string(
     out_predict, "",
     "Output predict dir(optional)(sub_command is predict, role is wk).");
+DEFINE_int32(out_format, 0,
+             "Output predict format, 0 for text, 1 for binary float32 "
+             "embeddings, 2 for binary float16 embeddings.");
 
 namespace embedx {
 
@@ -93,13 +111,16 @@ void CheckGNNFlags() {
   } else {
     DXCHECK_THROW(!FLAGS_node_graph.empty());
   }
-  DXCHECK_THROW(
-      FLAGS_negative_sampler_type == 0 || FLAGS_negative_sampler_type == 1 ||
-      FLAGS_negative_sampler_type == 2 || FLAGS_negative_sampler_type == 3);
+  DXCHECK_THROW(FLAGS_negative_sampler_type >= 0 &&
+                FLAGS_negative_sampler_type <= 4);
+  DXCHECK_THROW(FLAGS_negative_sampler_power > 0);
   DXCHECK_THROW(
       FLAGS_neighbor_sampler_type == 0 || FLAGS_neighbor_sampler_type == 1 ||
       FLAGS_neighbor_sampler_type == 2 || FLAGS_neighbor_sampler_type == 3);
   DXCHECK_THROW(FLAGS_gs_thread_num > 0);
+  DXCHECK_THROW(0 <= FLAGS_gs_hedge_percentile &&
+                FLAGS_gs_hedge_percentile <= 100);
+  DXCHECK_THROW(FLAGS_gs_hedge_min_delay_us >= 0);
 }
 
 void CheckNonGNNFlags() {
@@ -128,6 +149,9 @@ void CheckFlags() {
   FLAGS_ps_size = (int)FLAGS_ps_endpoints.size();
   if (FLAGS_role == "ps") {
     DXCHECK_THROW(0 <= FLAGS_ps_id && FLAGS_ps_id < FLAGS_ps_size);
+    DXCHECK_THROW(FLAGS_cs_thread_num > 0);
+    DXCHECK_THROW(FLAGS_cs_wait_num >= 0);
+    DXCHECK_THROW(FLAGS_chunk_size > 0);
 
     deepx_core::CanonicalizePath(&FLAGS_in);
     DXCHECK_THROW(!FLAGS_in.empty());
@@ -143,6 +167,12 @@ void CheckFlags() {
 
     DXCHECK_THROW(!FLAGS_instance_reader.empty());
     DXCHECK_THROW(FLAGS_batch > 0);
+    DXCHECK_THROW(FLAGS_thread_num > 0);
+    DXCHECK_THROW(FLAGS_intra_op_thread_num >= 0);
+    if (FLAGS_intra_op_thread_num == 0) {
+      FLAGS_intra_op_thread_num = std::max(
+          (int)std::thread::hardware_concurrency() / FLAGS_thread_num, 1);
+    }
   }
 
   DXCHECK_THROW(FLAGS_epoch > 0);
@@ -193,6 +223,12 @@ void CheckFlags() {
              FLAGS_out_predict.c_str());
     }
     (void)deepx_core::AutoFileSystem::MakeDir(FLAGS_out_predict);
+
+    // binary files only hold embeddings
+    DXCHECK_THROW(FLAGS_out_format == 0 || FLAGS_out_format == 1 ||
+                  FLAGS_out_format == 2);
+    DXCHECK_THROW(FLAGS_out_format == 0 || FLAGS_target_type == 2 ||
+                  FLAGS_target_type == 3);
   }
 
   DXCHECK_THROW(FLAGS_verbose >= 0);
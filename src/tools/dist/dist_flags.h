@@ -23,6 +23,8 @@ DECLARE_string(cs_addr);
 DECLARE_string(ps_addrs);
 DECLARE_int32(ps_id);
 DECLARE_int32(ps_thread_num);
+DECLARE_int32(cs_thread_num);
+DECLARE_int32(cs_wait_num);
 
 DECLARE_bool(gnn_model);
 DECLARE_bool(deep_model);
@@ -34,14 +36,17 @@ DECLARE_string(optimizer);
 DECLARE_string(optimizer_config);
 DECLARE_int32(epoch);
 DECLARE_int32(batch);
+DECLARE_int32(thread_num);
+DECLARE_int32(intra_op_thread_num);
 DECLARE_string(in_model);
 DECLARE_string(warmup_model);
 DECLARE_string(in);
 DECLARE_string(pretrain_path);
-DECLARE_string(item_feature);
 DECLARE_string(inst_file);
 DECLARE_string(freq_file);
 DECLARE_bool(shuffle);
+DECLARE_int32(chunk_size);
+DECLARE_bool(speculative);
 DECLARE_bool(ts_enable);
 DECLARE_uint64(ts_now);
 DECLARE_uint64(ts_expire_threshold);
@@ -55,6 +60,7 @@ DECLARE_string(out_model_text);
 DECLARE_string(out_model_fkv);
 DECLARE_int32(out_model_fkv_pb_version);
 DECLARE_string(out_predict);
+DECLARE_int32(out_format);
 
 namespace embedx {
 
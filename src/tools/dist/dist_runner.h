@@ -0,0 +1,35 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <string>
+#include <vector>
+
+namespace embedx {
+
+// Runs the coord server, which dispatches chunks of the files of '--in' to
+// workers, see ChunkDispatcher.
+void RunCoordServer();
+
+// Runs the param server of '--ps_id'.
+void RunParamServer();
+
+// Runs a worker of '--thread_num' threads until all epochs are done. Every
+// thread requests chunks from the coord server on its own, and has its own
+// connections to param servers, which a batch holds from pull to push, see
+// TrainerContextDist. Threads share the graph client, so its cache is
+// downloaded once per worker.
+//
+// 'files' gets the files of the chunks done by the worker if it isn't
+// nullptr.
+void RunWorker(std::vector<std::string>* files = nullptr);
+
+}  // namespace embedx
@@ -16,23 +16,194 @@
 #include <deepx_core/graph/graph.h>
 #include <deepx_core/graph/model_shard.h>
 #include <deepx_core/graph/tensor_map.h>
-#include <deepx_core/ps/coord_server.h>
 #include <deepx_core/ps/param_server.h>
+#include <deepx_core/ps/rpc_server.h>
+#include <deepx_core/ps/tcp_connection.h>
 
+#include <chrono>
+#include <cinttypes>  // PRIu64
+#include <condition_variable>
 #include <memory>  // std::unque_ptr
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "src/model/model_zoo.h"
+#include "src/tools/dist/chunk_dispatcher.h"
+#include "src/tools/dist/coord_proto.h"
 #include "src/tools/dist/dist_flags.h"
+#include "src/tools/dist/dist_runner.h"
 #include "src/tools/model_util.h"
 
 namespace embedx {
 namespace {
 
 /************************************************************************/
-/* RankCoordServer */
+/* ChunkCoordServer */
 /************************************************************************/
-class RankCoordServer : public deepx_core::CoordServer {};
+// ChunkCoordServer dispatches chunks of the input files to workers, see
+// ChunkDispatcher.
+//
+// A request for a chunk is held until a chunk is available or it times out,
+// so idle workers get chunks at once. When all epochs are done, it saves the
+// model(sub_command is train), closes param servers and itself.
+//
+// A held request occupies a handler thread. 'cs_wait_num' threads are added
+// for them, so while no more requests are held, the 'cs_thread_num' threads
+// are left to extends and finishes.
+class ChunkCoordServer {
+ private:
+  deepx_core::RpcServer rpc_server_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  ChunkDispatcher dispatcher_;
+  int wait_num_ = 0;
+  bool wait_warned_ = false;
+
+ public:
+  bool Init();
+  void Run();
+
+ private:
+  int OnChunkRequest(const ChunkRequest& req, ChunkResponse* resp);
+  int OnChunkExtend(const ChunkExtendRequest& req, ChunkExtendResponse* resp);
+  int OnChunkFinish(const ChunkFinishRequest& req, ChunkFinishResponse* resp);
+  void Close();
+};
+
+bool ChunkCoordServer::Init() {
+  std::vector<std::string> files;
+  DXCHECK_THROW(deepx_core::AutoFileSystem::ListRecursive(FLAGS_in, true,
+                                                          &files));
+  DXCHECK_THROW(!files.empty());
+  DXINFO("Got %d files.", (int)files.size());
+  for (const std::string& file : files) {
+    DXINFO("  %s", file.c_str());
+  }
+
+  ChunkDispatcherConfig config;
+  config.chunk_size = (uint64_t)FLAGS_chunk_size << 20;
+  config.epoch = FLAGS_epoch;
+  config.shuffle = FLAGS_shuffle;
+  config.speculative = FLAGS_speculative;
+  config.seed = (uint64_t)FLAGS_seed;
+  if (!dispatcher_.Init(files, config)) {
+    return false;
+  }
+  DXINFO("Got %zu chunks.", dispatcher_.file_chunk_size());
+
+  deepx_core::TcpServerConfig tcp_config;
+  tcp_config.listen_endpoint = FLAGS_cs_endpoint;
+  tcp_config.thread = FLAGS_cs_thread_num + FLAGS_cs_wait_num;
+  rpc_server_.set_config(tcp_config);
+  rpc_server_.RegisterRequestHandler<ChunkRequest, ChunkResponse>(
+      ChunkRequest::rpc_type(),
+      [this](const ChunkRequest& req, ChunkResponse* resp) {
+        return OnChunkRequest(req, resp);
+      });
+  rpc_server_.RegisterRequestHandler<ChunkExtendRequest, ChunkExtendResponse>(
+      ChunkExtendRequest::rpc_type(),
+      [this](const ChunkExtendRequest& req, ChunkExtendResponse* resp) {
+        return OnChunkExtend(req, resp);
+      });
+  rpc_server_.RegisterRequestHandler<ChunkFinishRequest, ChunkFinishResponse>(
+      ChunkFinishRequest::rpc_type(),
+      [this](const ChunkFinishRequest& req, ChunkFinishResponse* resp) {
+        return OnChunkFinish(req, resp);
+      });
+  return true;
+}
+
+void ChunkCoordServer::Run() {
+  std::thread closer([this]() {
+    {
+      std::unique_lock<std::mutex> guard(mtx_);
+      cv_.wait(guard, [this]() { return dispatcher_.done(); });
+    }
+    Close();
+  });
+  rpc_server_.Run();
+  closer.join();
+}
+
+int ChunkCoordServer::OnChunkRequest(const ChunkRequest& req,
+                                     ChunkResponse* resp) {
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(req.wait_ms);
+  FileChunk chunk;
+  ChunkStatusEnum status;
+  std::unique_lock<std::mutex> guard(mtx_);
+  for (bool timeout = false;;) {
+    status = dispatcher_.Next(&resp->id, &chunk, &resp->epoch);
+    if (status != ChunkStatusEnum::WAIT || timeout) {
+      break;
+    }
+    if (wait_num_ >= FLAGS_cs_wait_num && !wait_warned_) {
+      // it takes a thread of extends and finishes
+      DXINFO("More than %d requests are held, cs_wait_num is too small.",
+             FLAGS_cs_wait_num);
+      wait_warned_ = true;
+    }
+    ++wait_num_;
+    timeout = cv_.wait_until(guard, deadline) == std::cv_status::timeout;
+    --wait_num_;
+  }
+
+  resp->status = (int)status;
+  resp->file = chunk.file;
+  resp->begin = chunk.begin;
+  resp->end = chunk.end;
+  return 0;
+}
+
+int ChunkCoordServer::OnChunkExtend(const ChunkExtendRequest& req,
+                                    ChunkExtendResponse* resp) {
+  std::lock_guard<std::mutex> guard(mtx_);
+  resp->found = dispatcher_.Extend(req.id, req.pos, &resp->end) ? 1 : 0;
+  return 0;
+}
+
+int ChunkCoordServer::OnChunkFinish(const ChunkFinishRequest& req,
+                                    ChunkFinishResponse* resp) {
+  {
+    std::lock_guard<std::mutex> guard(mtx_);
+    resp->accepted =
+        dispatcher_.Finish(req.id, req.loss, req.loss_weight) ? 1 : 0;
+  }
+  if (resp->accepted) {
+    // a new epoch or the end for waiting requests
+    cv_.notify_all();
+  } else {
+    DXINFO("Ignored the finish of chunk: %" PRIu64 ".", req.id);
+  }
+  return 0;
+}
+
+void ChunkCoordServer::Close() {
+  std::vector<std::unique_ptr<deepx_core::TcpConnection>> ps_conns;
+  deepx_core::IoContext io;
+  for (const auto& endpoint : FLAGS_ps_endpoints) {
+    ps_conns.emplace_back(new deepx_core::TcpConnection(&io));
+    DXCHECK_THROW(ps_conns.back()->ConnectRetry(endpoint) == 0);
+  }
+
+  if (FLAGS_is_train) {
+    DXINFO("Saving model...");
+    for (auto& conn : ps_conns) {
+      DXCHECK_THROW(conn->RpcModelSaveRequest() == 0);
+    }
+    DXINFO("Done.");
+  }
+
+  for (auto& conn : ps_conns) {
+    DXCHECK_THROW(conn->RpcTerminationNotify() == 0);
+  }
+
+  deepx_core::TcpConnection conn(&io);
+  DXCHECK_THROW(conn.ConnectRetry(FLAGS_cs_endpoint) == 0);
+  DXCHECK_THROW(conn.RpcTerminationNotify() == 0);
+}
 
 /************************************************************************/
 /* RankParamServer */
@@ -236,27 +407,8 @@ void RankParamServer::OnTerminationNotify(conn_t /*conn*/) {}
 }  // namespace
 
 void RunCoordServer() {
-  deepx_core::CoordServerConfig config;
-  config.listen_endpoint = FLAGS_cs_endpoint;
-  config.ps_endpoints = FLAGS_ps_endpoints;
-  config.epoch = FLAGS_epoch;
-  DXCHECK_THROW(deepx_core::AutoFileSystem::ListRecursive(
-      FLAGS_in, true, &config.file_dispatcher_files));
-  DXCHECK_THROW(!config.file_dispatcher_files.empty());
-  DXINFO("Got %d files.", (int)config.file_dispatcher_files.size());
-  for (const std::string& file : config.file_dispatcher_files) {
-    DXINFO("  %s", file.c_str());
-  }
-  config.file_dispatcher_shuffle = FLAGS_shuffle ? 1 : 0;
-  config.file_dispatcher_timeout = 0;
-  if (FLAGS_is_train) {
-    config.dump_model = 1;
-  } else {
-    config.dump_model = 0;
-  }
-
-  RankCoordServer server;
-  server.set_config(config);
+  ChunkCoordServer server;
+  DXCHECK(server.Init());
   server.Run();
 }
 
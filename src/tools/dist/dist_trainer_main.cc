@@ -14,14 +14,11 @@
 
 #include <thread>
 
+#include "src/common/parallel_util.h"
 #include "src/tools/dist/dist_flags.h"
+#include "src/tools/dist/dist_runner.h"
 
 namespace embedx {
-
-void RunCoordServer();
-void RunParamServer();
-void RunWorker();
-
 namespace {
 
 int main(int argc, char** argv) {
@@ -46,6 +43,7 @@ int main(int argc, char** argv) {
     }
     DXINFO("Param server: %d normally exits.", FLAGS_ps_id);
   } else {
+    SetIntraOpThreadNum(FLAGS_intra_op_thread_num);
     RunWorker();
     DXINFO("Worker normally exits.");
   }
@@ -21,10 +21,12 @@
 #include <deepx_core/graph/graph.h>
 #include <deepx_core/graph/model_shard.h>
 #include <deepx_core/graph/tensor_map.h>
+#include <deepx_core/ps/rpc_client.h>
 #include <deepx_core/ps/tcp_connection.h>
 
-#include <chrono>
+#include <cinttypes>  // PRIu64
 #include <memory>  // std::unique_ptr
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -33,18 +35,44 @@
 #include "src/deep/deep_config.h"
 #include "src/graph/client/graph_client.h"
 #include "src/graph/graph_config.h"
+#include "src/io/file_chunk.h"
 #include "src/model/embed_instance_reader.h"
 #include "src/model/model_zoo.h"
+#include "src/tools/dist/chunk_dispatcher.h"
+#include "src/tools/dist/coord_proto.h"
 #include "src/tools/dist/dist_flags.h"
+#include "src/tools/dist/dist_runner.h"
 #include "src/tools/graph/graph_flags.h"
 #include "src/tools/trainer_context.h"
 
 namespace embedx {
 namespace {
 
+// how long the coord server may hold a request for a chunk
+constexpr int CHUNK_WAIT_MS = 1000;
+
+template <class Request, class Response>
+bool Rpc(deepx_core::TcpConnections* conns, const Request& request,
+         Response* response) {
+  std::vector<Request> requests{request};
+  std::vector<Response> responses(1);
+  if (WriteRequestReadResponse(conns, Request::rpc_type(), requests,
+                               &responses) != 0) {
+    return false;
+  }
+  *response = responses[0];
+  return true;
+}
+
 /************************************************************************/
 /* TrainerContextDist */
 /************************************************************************/
+// Each context owns its param server connections and keeps them busy from
+// Pull to the end of the batch: the pulled params are zero-copy views into
+// the in messages of the connections, and a param server keeps the pulled
+// params of a batch in the session of its connection. A pool shared by
+// threads would have to lend a connection for a whole batch, so it would
+// need a connection per running thread anyway, or serialize the threads.
 class TrainerContextDist : public TrainerContext {
  private:
   deepx_core::IoContext io_;
@@ -209,24 +237,43 @@ void TrainerContextDist::Push() {
 /************************************************************************/
 class TrainerDist : public deepx_core::DataType {
  private:
-  deepx_core::IoContext io_;
-  deepx_core::TcpConnection cs_conn_;
+  // what a thread owns, the local model shard holds the params it pulls
+  struct WorkerThread {
+    std::unique_ptr<deepx_core::IoContext> io;
+    std::unique_ptr<deepx_core::TcpConnections> cs_conns;
+    deepx_core::ModelShard local_model_shard;
+    TrainerContextDist context;
+  };
+
   deepx_core::Graph graph_;
-  deepx_core::ModelShard local_model_shard_;
-  TrainerContextDist context_;
+  std::vector<std::unique_ptr<WorkerThread>> threads_;
+
+  std::mutex files_mtx_;
+  std::vector<std::string> files_;
 
  private:
+  // shared by threads
   std::unique_ptr<GraphClient> graph_client_;
   std::unique_ptr<DeepClient> deep_client_;
 
  public:
-  TrainerDist();
   bool Init();
   void Train();
   void Predict();
-};
+  const std::vector<std::string>& files() const noexcept { return files_; }
 
-TrainerDist::TrainerDist() : io_(), cs_conn_(&io_) {}
+ private:
+  using process_t = void (TrainerDist::*)(int, const FileChunk&,
+                                          const FileChunkExtender&);
+  void Run(process_t process);
+  // Processes the chunks from the coord server until all epochs are done.
+  void Entry(int thread_id, process_t process);
+  void TrainChunk(int thread_id, const FileChunk& chunk,
+                  const FileChunkExtender& extender);
+  void PredictChunk(int thread_id, const FileChunk& chunk,
+                    const FileChunkExtender& extender);
+  void FinishFile(const std::string& file);
+};
 
 bool TrainerDist::Init() {
   if (FLAGS_in_model.empty()) {
@@ -240,16 +287,18 @@ bool TrainerDist::Init() {
     DXCHECK_THROW(deepx_core::LoadGraph(FLAGS_in_model, &graph_));
   }
 
-  local_model_shard_.seed(0);
-  local_model_shard_.InitShard(&FLAGS_shard, 0);
-  local_model_shard_.InitGraph(&graph_);
-  DXCHECK_THROW(local_model_shard_.InitModelPlaceholder());
-
   std::string target_name = graph_.target(FLAGS_target_type).name();
 
-  if (FLAGS_gnn_model) {
+  // Deep models look up item features on the graph servers if given.
+  bool dist_item_feature =
+      FLAGS_deep_model && FLAGS_is_train && !FLAGS_gs_addrs.empty();
+  if (FLAGS_gnn_model || dist_item_feature) {
     GraphConfig graph_config;
     graph_config.set_ip_ports(FLAGS_gs_addrs);
+    graph_config.set_hedge_percentile(FLAGS_gs_hedge_percentile);
+    graph_config.set_hedge_min_delay_us(FLAGS_gs_hedge_min_delay_us);
+    // a lane of connections per thread at least
+    graph_config.set_thread_num(FLAGS_thread_num);
 
     graph_client_ = NewGraphClient(graph_config, GraphClientEnum::DIST);
     if (!graph_client_) {
@@ -259,8 +308,8 @@ bool TrainerDist::Init() {
 
   if (FLAGS_deep_model) {
     if (FLAGS_is_train &&
-        (!FLAGS_item_feature.empty() || !FLAGS_inst_file.empty() ||
-         !FLAGS_freq_file.empty())) {
+        (dist_item_feature || !FLAGS_item_feature.empty() ||
+         !FLAGS_inst_file.empty() || !FLAGS_freq_file.empty())) {
       DeepConfig deep_config;
 
       if (!FLAGS_item_feature.empty()) {
@@ -277,17 +326,21 @@ bool TrainerDist::Init() {
         deep_config.set_node_config(FLAGS_node_config);
       }
 
-      if (FLAGS_negative_sampler_type != 0 &&
-          FLAGS_negative_sampler_type != 1 &&
-          FLAGS_negative_sampler_type != 2 &&
-          FLAGS_negative_sampler_type != 3) {
+      if (FLAGS_negative_sampler_type < 0 || FLAGS_negative_sampler_type > 4) {
         DXERROR(
             "Negative sampler type only support : '0(UNIFORM) || 1(ALIAS) || "
-            "(2)WORD2VEC || 3(PARTIAL_SUM)'.");
+            "(2)WORD2VEC || 3(PARTIAL_SUM) || 4(COMPACT_ALIAS)'.");
         return false;
       }
       deep_config.set_negative_sampler_type(FLAGS_negative_sampler_type);
-      deep_client_ = NewDeepClient(deep_config, DeepClientEnum::LOCAL);
+      deep_config.set_negative_sampler_power(FLAGS_negative_sampler_power);
+      deep_config.set_thread_num(FLAGS_thread_num);
+      if (dist_item_feature) {
+        deep_client_ = NewDeepClient(deep_config, DeepClientEnum::DIST,
+                                     graph_client_.get());
+      } else {
+        deep_client_ = NewDeepClient(deep_config, DeepClientEnum::LOCAL);
+      }
       DXCHECK(deep_client_ != nullptr);
     }
   }
@@ -313,88 +366,148 @@ bool TrainerDist::Init() {
     return instance_reader;
   };
 
-  if (FLAGS_freq_filter_threshold > 0) {
-    context_.set_freq_filter_threshold(
-        (deepx_core::DataType::freq_t)FLAGS_freq_filter_threshold);
+  threads_.resize(FLAGS_thread_num);
+  for (auto& thread : threads_) {
+    thread.reset(new WorkerThread);
+    thread->io.reset(new deepx_core::IoContext);
+    thread->cs_conns.reset(new deepx_core::TcpConnections(thread->io.get()));
+
+    deepx_core::ModelShard* local_model_shard = &thread->local_model_shard;
+    local_model_shard->seed(0);
+    local_model_shard->InitShard(&FLAGS_shard, 0);
+    local_model_shard->InitGraph(&graph_);
+    DXCHECK_THROW(local_model_shard->InitModelPlaceholder());
+
+    TrainerContextDist* context = &thread->context;
+    if (FLAGS_freq_filter_threshold > 0) {
+      context->set_freq_filter_threshold(
+          (deepx_core::DataType::freq_t)FLAGS_freq_filter_threshold);
+    }
+    context->set_verbose(FLAGS_verbose);
+    context->set_target_name(target_name);
+    context->set_target_type(FLAGS_target_type);
+    context->set_out_format(FLAGS_out_format);
+    context->set_instance_reader_creator(instance_reader_creator);
+    if (!context->Init(local_model_shard)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TrainerDist::Train() { Run(&TrainerDist::TrainChunk); }
+
+void TrainerDist::Predict() { Run(&TrainerDist::PredictChunk); }
+
+void TrainerDist::Run(process_t process) {
+  if (threads_.size() == 1) {
+    Entry(0, process);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < (int)threads_.size(); ++i) {
+    threads.emplace_back(&TrainerDist::Entry, this, i, process);
+  }
+  for (auto& thread : threads) {
+    thread.join();
   }
-  context_.set_verbose(FLAGS_verbose);
-  context_.set_target_name(target_name);
-  context_.set_target_type(FLAGS_target_type);
-  context_.set_instance_reader_creator(instance_reader_creator);
-  return context_.Init(&local_model_shard_);
 }
 
-void TrainerDist::Train() {
-  int epoch = 0;
-  std::string file;
+void TrainerDist::Entry(int thread_id, process_t process) {
+  deepx_core::TcpConnections* cs_conns = threads_[thread_id]->cs_conns.get();
+  TrainerContextDist* context = &threads_[thread_id]->context;
+  DXCHECK_THROW(cs_conns->ConnectRetry({FLAGS_cs_endpoint}) == 0);
+
+  ChunkRequest chunk_request;
+  chunk_request.wait_ms = CHUNK_WAIT_MS;
+  ChunkResponse chunk_response;
+  int epoch = -1;
   for (;;) {
-    DXINFO("Epoch %d begins.", epoch + 1);
-    DXCHECK_THROW(cs_conn_.ConnectRetry(FLAGS_cs_endpoint) == 0);
-    for (;;) {
-      if (cs_conn_.RpcFileRequest() == 0) {
-        epoch = cs_conn_.in_message().file_response().epoch;
-        file = cs_conn_.in_message().file_response().file;
-        if (file.empty()) {
-          DXINFO("Worker got no new file.");
-          std::this_thread::sleep_for(std::chrono::seconds(5));  // magic number
-          continue;
-        } else {
-          DXINFO("Worker has got file: %s.", file.c_str());
-          context_.TrainFile(0, file);
-          auto* file_finished_notify =
-              cs_conn_.mutable_out_message()->mutable_file_finish_notify();
-          file_finished_notify->file = file;
-          file_finished_notify->loss = context_.file_loss();
-          file_finished_notify->loss_weight = context_.file_loss_weight();
-          DXCHECK_THROW(cs_conn_.RpcFileFinishNotify() == 0);
-        }
-      } else {
-        DXINFO("Failed to RpcFileRequest.");
-        break;
-      }
+    if (!Rpc(cs_conns, chunk_request, &chunk_response)) {
+      DXINFO("[%d] Failed to request a chunk.", thread_id);
+      break;
     }
 
-    cs_conn_.Close();
-    DXINFO("Epoch %d completed.", epoch + 1);
-    if (epoch == FLAGS_epoch - 1) {
+    auto status = (ChunkStatusEnum)chunk_response.status;
+    if (status == ChunkStatusEnum::DONE) {
       break;
     }
-  }
-}
+    if (status == ChunkStatusEnum::WAIT) {
+      // the coord server has held the request, ask again
+      continue;
+    }
 
-void TrainerDist::Predict() {
-  std::string file;
-  DXCHECK_THROW(cs_conn_.ConnectRetry(FLAGS_cs_endpoint) == 0);
-  for (;;) {
-    if (cs_conn_.RpcFileRequest() == 0) {
-      file = cs_conn_.in_message().file_response().file;
-      if (file.empty()) {
-        DXINFO("Worker got no new file.");
-        std::this_thread::sleep_for(std::chrono::seconds(5));  // magic number
-        continue;
-      } else {
-        DXINFO("Worker has got file: %s.", file.c_str());
-        context_.PredictFile(
-            0, file, deepx_core::GetOutputPredictFile(FLAGS_out_predict, file));
-        auto* file_finished_notify =
-            cs_conn_.mutable_out_message()->mutable_file_finish_notify();
-        file_finished_notify->file = file;
-        file_finished_notify->loss = 0;
-        file_finished_notify->loss_weight = 0;
-        DXCHECK_THROW(cs_conn_.RpcFileFinishNotify() == 0);
-      }
+    if (epoch != chunk_response.epoch) {
+      epoch = chunk_response.epoch;
+      DXINFO("[%d] Epoch %d begins.", thread_id, epoch + 1);
+    }
+
+    FileChunk chunk;
+    chunk.file = chunk_response.file;
+    chunk.begin = chunk_response.begin;
+    chunk.end = chunk_response.end;
+    FileChunkExtender extender;
+    if (chunk.whole()) {
+      DXINFO("[%d] Worker has got file: %s.", thread_id, chunk.file.c_str());
     } else {
-      DXINFO("Failed to RpcFileRequest.");
-      break;
+      DXINFO("[%d] Worker has got chunk: %s from %" PRIu64 ".", thread_id,
+             chunk.file.c_str(), chunk.begin);
+      uint64_t id = chunk_response.id;
+      extender = [cs_conns, id](uint64_t pos, uint64_t* end) {
+        ChunkExtendRequest request;
+        request.id = id;
+        request.pos = pos;
+        ChunkExtendResponse response;
+        if (!Rpc(cs_conns, request, &response) || !response.found) {
+          return false;
+        }
+        *end = response.end;
+        return true;
+      };
+    }
+    (this->*process)(thread_id, chunk, extender);
+
+    ChunkFinishRequest finish_request;
+    finish_request.id = chunk_response.id;
+    if (FLAGS_is_train) {
+      finish_request.loss = context->file_loss();
+      finish_request.loss_weight = context->file_loss_weight();
     }
+    ChunkFinishResponse finish_response;
+    DXCHECK_THROW(Rpc(cs_conns, finish_request, &finish_response));
+    FinishFile(chunk.file);
   }
 
-  cs_conn_.Close();
+  cs_conns->Close();
+  DXINFO("[%d] Worker completed.", thread_id);
+}
+
+void TrainerDist::TrainChunk(int thread_id, const FileChunk& chunk,
+                             const FileChunkExtender& extender) {
+  threads_[thread_id]->context.TrainChunk(thread_id, chunk, extender);
+}
+
+void TrainerDist::PredictChunk(int thread_id, const FileChunk& chunk,
+                               const FileChunkExtender& extender) {
+  // a chunk of a split file has its own output file
+  std::string out_file =
+      deepx_core::GetOutputPredictFile(FLAGS_out_predict, chunk.file);
+  if (!chunk.whole()) {
+    out_file += "." + std::to_string(chunk.begin);
+  }
+  threads_[thread_id]->context.PredictChunk(thread_id, chunk, extender,
+                                            out_file);
+}
+
+void TrainerDist::FinishFile(const std::string& file) {
+  std::lock_guard<std::mutex> guard(files_mtx_);
+  files_.emplace_back(file);
 }
 
 }  // namespace
 
-void RunWorker() {
+void RunWorker(std::vector<std::string>* files) {
   TrainerDist trainer;
   DXCHECK(trainer.Init());
   if (FLAGS_is_train) {
@@ -402,6 +515,12 @@ void RunWorker() {
   } else {
     trainer.Predict();
   }
+  DXINFO("Worker has done %zu files with %d threads.", trainer.files().size(),
+         FLAGS_thread_num);
+
+  if (files != nullptr) {
+    *files = trainer.files();
+  }
 }
 
 }  // namespace embedx
@@ -0,0 +1,181 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/common/stream.h>
+#include <deepx_core/dx_log.h>
+#include <deepx_core/ps/tcp_connection.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>  // std::sort, std::transform
+#include <chrono>
+#include <cstdio>  // std::remove
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/graph/graph_config.h"
+#include "src/graph/server/dist_graph_server.h"
+#include "src/tools/dist/dist_flags.h"
+#include "src/tools/dist/dist_runner.h"
+#include "src/tools/graph/graph_flags.h"
+
+namespace embedx {
+namespace {
+
+constexpr int SERVER_WAIT_SECONDS = 60;
+
+bool WaitServer(const std::string& success_file) {
+  for (int i = 0; i < SERVER_WAIT_SECONDS; ++i) {
+    if (deepx_core::AutoFileSystem::Exists(success_file)) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+  }
+  return false;
+}
+
+void CloseServer(const std::string& ip_port) {
+  deepx_core::IoContext io;
+  deepx_core::TcpConnection conn(&io);
+  DXCHECK_THROW(conn.ConnectRetry(deepx_core::MakeTcpEndpoint(ip_port), 10,
+                                  1) == 0);
+  DXCHECK_THROW(conn.RpcTerminationNotify() == 0);
+}
+
+std::string BaseName(const std::string& file) {
+  return file.substr(file.find_last_of('/') + 1);
+}
+
+// Starts a graph server of testdata/context at 'port', a coord server at
+// 'port' + 1, a param server at 'port' + 2 and a worker of 'thread_num'
+// threads in one process, and trains the files of '--in' with the model
+// flags set by the caller.
+void Train(const std::string& work_dir, int port, int thread_num,
+           std::vector<std::string>* files) {
+  std::string gs_addr = "127.0.0.1:" + std::to_string(port);
+
+  // graph server
+  std::string success_out = work_dir + "/server";
+  std::string success_file = success_out + "/_SUCCESS0";
+  (void)std::remove(success_file.c_str());
+  (void)deepx_core::AutoFileSystem::MakeDir(success_out);
+  GraphConfig graph_config;
+  graph_config.set_node_graph("testdata/context");
+  graph_config.set_node_feature("testdata/node_feature");
+  graph_config.set_ip_ports(gs_addr);
+  graph_config.set_thread_num(thread_num);
+  graph_config.set_success_out(success_out);
+  DistGraphServer graph_server;
+  std::thread gs_thread([&graph_server, &graph_config]() {
+    DXCHECK(graph_server.Start(graph_config));
+  });
+  DXCHECK_THROW(WaitServer(success_file));
+
+  FLAGS_sub_command = "train";
+  FLAGS_cs_addr = "127.0.0.1:" + std::to_string(port + 1);
+  FLAGS_ps_addrs = "127.0.0.1:" + std::to_string(port + 2);
+  FLAGS_ps_thread_num = thread_num;
+  FLAGS_out_model = work_dir + "/model";
+  FLAGS_target_type = 0;
+  FLAGS_dist = 1;
+  FLAGS_gs_addrs = gs_addr;
+  FLAGS_thread_num = thread_num;
+  FLAGS_role = "ps";
+  CheckFlags();
+  FLAGS_role = "wk";
+  CheckFlags();
+
+  std::thread cs_thread(RunCoordServer);
+  std::thread ps_thread(RunParamServer);
+  RunWorker(files);
+  ps_thread.join();
+  cs_thread.join();
+  CloseServer(gs_addr);
+  gs_thread.join();
+
+  std::transform(files->begin(), files->end(), files->begin(), &BaseName);
+  std::sort(files->begin(), files->end());
+}
+
+}  // namespace
+
+// A coord server, a param server, a graph server and a worker of 4 threads in
+// one process, every file is trained once.
+TEST(DistWorkerTest, TrainWithThreads) {
+  const std::string WORK_DIR = "dist_worker_test";
+  const std::string IN_DIR = WORK_DIR + "/in";
+  const int FILE_NUM = 8;
+
+  (void)deepx_core::AutoFileSystem::MakeDir(WORK_DIR);
+  (void)deepx_core::AutoFileSystem::MakeDir(IN_DIR);
+  std::vector<std::string> expected_files;
+  for (int i = 0; i < FILE_NUM; ++i) {
+    std::string file = "edge-" + std::to_string(i);
+    std::ofstream os(IN_DIR + "/" + file);
+    // edges between the nodes of testdata/context
+    for (int j = 0; j < 13; ++j) {
+      os << j << " " << (i + j + 1) % 13 << "\n";
+    }
+    expected_files.emplace_back(file);
+  }
+
+  FLAGS_in = IN_DIR;
+  FLAGS_model = "unsup_graphsage";
+  FLAGS_model_config = "config=0:1000:8;depth=1;dim=8";
+  FLAGS_instance_reader = "unsup_graphsage";
+  FLAGS_instance_reader_config = "num_neg=2;num_neighbors=2";
+  FLAGS_batch = 4;
+  std::vector<std::string> files;
+  Train(WORK_DIR, 61731, 4, &files);
+  EXPECT_EQ(files, expected_files);
+}
+
+// sup_graphsage of Cluster-GCN batches, the labels of a file are grouped by
+// the clusters of 'cluster_file'.
+TEST(DistWorkerTest, TrainWithClusters) {
+  const std::string WORK_DIR = "dist_worker_test_cluster";
+  const std::string IN_DIR = WORK_DIR + "/in";
+  const std::string CLUSTER_FILE = WORK_DIR + "/cluster";
+  const int FILE_NUM = 4;
+
+  (void)deepx_core::AutoFileSystem::MakeDir(WORK_DIR);
+  (void)deepx_core::AutoFileSystem::MakeDir(IN_DIR);
+  {
+    // 4 clusters of the nodes of testdata/context, node 12 is out of them
+    std::ofstream os(CLUSTER_FILE);
+    for (int j = 0; j < 12; ++j) {
+      os << j << " " << j / 3 << "\n";
+    }
+  }
+  std::vector<std::string> expected_files;
+  for (int i = 0; i < FILE_NUM; ++i) {
+    std::string file = "label-" + std::to_string(i);
+    std::ofstream os(IN_DIR + "/" + file);
+    for (int j = i; j < 13; j += 2) {
+      os << j << " " << j % 3 << "\n";
+    }
+    expected_files.emplace_back(file);
+  }
+
+  FLAGS_in = IN_DIR;
+  FLAGS_model = "sup_graphsage";
+  FLAGS_model_config = "config=0:1000:8;depth=2;dim=8;max_label=2";
+  FLAGS_instance_reader = "sup_graphsage";
+  FLAGS_instance_reader_config = "num_neighbors=2,2;max_label=2;cluster_file=" +
+                                 CLUSTER_FILE + ";cluster_per_batch=2";
+  FLAGS_batch = 4;
+  std::vector<std::string> files;
+  Train(WORK_DIR, 61751, 2, &files);
+  EXPECT_EQ(files, expected_files);
+}
+
+}  // namespace embedx
@@ -0,0 +1,149 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/common/misc.h>
+#include <deepx_core/dx_log.h>
+#include <gflags/gflags.h>
+
+#include <memory>  // std::unique_ptr
+#include <string>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/io/async_writer.h"
+#include "src/io/embedding_file.h"
+#include "src/io/text_buffer.h"
+#include "src/tools/graph/main_util.h"
+
+DEFINE_string(in, "", "Input dir/file of text or binary embeddings.");
+DEFINE_string(out, "", "Output dir.");
+DEFINE_int32(out_format, 1,
+             "Output format, 0 for text, 1 for binary float32, 2 for binary "
+             "float16.");
+DEFINE_int32(thread_num, 8, "Number of threads.");
+
+namespace embedx {
+namespace {
+
+// EmbeddingConvertMain converts embedding files between the text format of
+// predictor and the binary format, see ReadEmbeddingFile.
+class EmbeddingConvertMain : public MainUtil {
+ private:
+  int out_format_ = 1;
+
+ public:
+  ~EmbeddingConvertMain() override = default;
+
+  bool Init() override {
+    out_format_ = FLAGS_out_format;
+    return true;
+  }
+
+ private:
+  const char* task_name() const noexcept override {
+    return "EmbeddingConvert";
+  }
+
+  bool RunEntry(int entry_id, const vec_str_t& files,
+                const std::string& out) override {
+    DXINFO("Thread id: %d is processing ...", entry_id);
+
+    auto dtype = out_format_ == 2 ? EmbeddingDtypeEnum::FLOAT16
+                                  : EmbeddingDtypeEnum::FLOAT32;
+    AsyncWriter writer;
+    std::string buf;
+    for (const auto& file : files) {
+      DXINFO("Processed file: %s.", file.c_str());
+      auto out_file = deepx_core::GetOutputPredictFile(out, file);
+      if (!writer.Open(out_file)) {
+        return false;
+      }
+
+      int file_dim = 0;
+      auto func = [this, dtype, &writer, &buf, &file_dim](
+                      const vec_int_t& ids, const std::vector<float>& values,
+                      int dim) {
+        if (out_format_ == 0) {
+          DumpText(ids, values, dim, &buf);
+          return writer.Write(&buf);
+        }
+
+        if (file_dim == 0) {
+          file_dim = dim;
+          AppendEmbeddingHeader(dtype, dim, &buf);
+        } else if (file_dim != dim) {
+          DXERROR("Need the same dim of embeddings, got %d vs %d.", file_dim,
+                  dim);
+          return false;
+        }
+        AppendEmbeddingBlock(dtype, dim, ids.data(), values.data(),
+                             (int)ids.size(), &buf);
+        return writer.Write(&buf);
+      };
+      if (!ReadEmbeddingFile(file, func) || !writer.Close()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void DumpText(const vec_int_t& ids, const std::vector<float>& values,
+                       int dim, std::string* buf) {
+    TextBuffer text;
+    text.Swap(buf);
+    const float* value = values.data();
+    for (auto id : ids) {
+      text.Append((uint64_t)id);
+      for (int j = 0; j < dim; ++j) {
+        text.Append(' ');
+        text.Append(*value++);
+      }
+      text.Append('\n');
+    }
+    text.Swap(buf);
+  }
+};
+
+void CheckFlags() {
+  DXCHECK(!FLAGS_in.empty());
+  DXCHECK(!FLAGS_out.empty());
+  DXCHECK(FLAGS_out_format == 0 || FLAGS_out_format == 1 ||
+          FLAGS_out_format == 2);
+  DXCHECK(FLAGS_thread_num > 0);
+}
+
+int main(int argc, char** argv) {
+  google::SetUsageMessage("Usage: [Options]");
+#if HAVE_COMPILE_FLAGS_H == 1
+  google::SetVersionString("\n\n"
+#include "compile_flags.h"
+  );
+#endif
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  CheckFlags();
+
+  std::unique_ptr<MainUtil> main(new EmbeddingConvertMain);
+  if (!main->Init()) {
+    return -1;
+  }
+  if (!main->RunMultiThread(FLAGS_in, FLAGS_out, FLAGS_thread_num)) {
+    return -1;
+  }
+
+  google::ShutDownCommandLineFlags();
+  return 0;
+}
+
+}  // namespace
+}  // namespace embedx
+
+int main(int argc, char** argv) { return embedx::main(argc, argv); }
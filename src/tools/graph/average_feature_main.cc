@@ -78,6 +78,8 @@ class AverageFeatureMain : public MainUtil {
   bool Init() override {
     if (FLAGS_dist) {
       graph_config_.set_ip_ports(FLAGS_gs_addrs);
+      graph_config_.set_hedge_percentile(FLAGS_gs_hedge_percentile);
+      graph_config_.set_hedge_min_delay_us(FLAGS_gs_hedge_min_delay_us);
     } else {
       graph_config_.set_node_graph(FLAGS_node_graph);
       graph_config_.set_node_feature(FLAGS_node_feature);
@@ -106,8 +108,8 @@ class AverageFeatureMain : public MainUtil {
     DXINFO("%s id: %d is processing ...", entry_flag_.c_str(), entry_id);
 
     LineParser line_parser;
-    deepx_core::AutoOutputFileStream ofs;
-    std::ostringstream oss;
+    AsyncWriter writer;
+    std::string buf;
     for (const auto& file : files) {
       DXINFO("Processed file: %s", file.c_str());
       if (!line_parser.Open(file)) {
@@ -115,7 +117,7 @@ class AverageFeatureMain : public MainUtil {
       }
 
       auto out_file = deepx_core::GetOutputPredictFile(out, file);
-      if (!ofs.Open(out_file)) {
+      if (!writer.Open(out_file)) {
         return false;
       }
 
@@ -127,10 +129,14 @@ class AverageFeatureMain : public MainUtil {
         nodes = Collect<NodeValue, int_t>(values, &NodeValue::node);
         AverageBatchFeature(nodes, &node_feats);
 
-        if (!MainUtil::DumpText(ofs, oss, nodes, node_feats)) {
+        if (!MainUtil::DumpText(&writer, &buf, nodes, node_feats)) {
           return false;
         }
       }
+
+      if (!writer.Close()) {
+        return false;
+      }
     }
 
     DXINFO("Done.");
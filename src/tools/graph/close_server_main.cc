@@ -16,33 +16,36 @@
 #include <gflags/gflags.h>
 
 #include <string>
+#include <vector>
 
 #include "src/common/data_types.h"
+#include "src/graph/graph_config.h"
 #include "src/tools/graph/graph_flags.h"
 
 namespace embedx {
 namespace {
 
 bool CloseConnection(const std::string& ip_port_str) {
-  vec_str_t ip_ports;
-  deepx_core::Split(ip_port_str, ";", &ip_ports);
-  if (ip_ports.empty()) {
+  std::vector<vec_str_t> replica_ip_ports;
+  if (!SplitReplicaIpPorts(ip_port_str, &replica_ip_ports)) {
     DXERROR("Invalid graph server address: %s.", FLAGS_gs_addrs.c_str());
     return false;
   }
 
   int retries = 10;
   int second = 1;
-  for (const auto& ip_port : ip_ports) {
-    deepx_core::TcpEndpoint endpoint = deepx_core::MakeTcpEndpoint(ip_port);
-    deepx_core::IoContext io;
-    deepx_core::TcpConnection conn(&io);
-    if (conn.ConnectRetry(endpoint, retries, second) != 0) {
-      DXINFO("Failed to connect graph server: %s.", ip_port.c_str());
-      continue;
+  for (const auto& ip_ports : replica_ip_ports) {
+    for (const auto& ip_port : ip_ports) {
+      deepx_core::TcpEndpoint endpoint = deepx_core::MakeTcpEndpoint(ip_port);
+      deepx_core::IoContext io;
+      deepx_core::TcpConnection conn(&io);
+      if (conn.ConnectRetry(endpoint, retries, second) != 0) {
+        DXINFO("Failed to connect graph server: %s.", ip_port.c_str());
+        continue;
+      }
+      DXCHECK_THROW(conn.RpcTerminationNotify() == 0);
+      DXINFO("Closed graph server: %s.", ip_port.c_str());
     }
-    DXCHECK_THROW(conn.RpcTerminationNotify() == 0);
-    DXINFO("Closed graph server: %s.", ip_port.c_str());
   }
   return true;
 }
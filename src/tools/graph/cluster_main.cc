@@ -0,0 +1,138 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>  // std::min
+#include <string>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/io/graph_cluster.h"
+#include "src/io/io_util.h"
+#include "src/io/line_parser.h"
+#include "src/io/value.h"
+#include "src/tools/graph/graph_flags.h"
+
+DEFINE_int32(cluster_num, 100, "Number of clusters.");
+DEFINE_double(cluster_imbalance, 0.05,
+              "A cluster has at most (1 + cluster_imbalance) times the mean "
+              "cluster size nodes.");
+DEFINE_int32(cluster_iter_num, 20, "Max rounds of label propagation.");
+
+namespace embedx {
+namespace {
+
+constexpr int BATCH = 128;
+
+bool LoadGraph(const std::string& node_graph, int thread_num,
+               adj_list_t* graph) {
+  vec_str_t files;
+  if (!io_util::ListFile(node_graph, &files)) {
+    return false;
+  }
+
+  thread_num = std::min(thread_num, (int)files.size());
+  std::vector<adj_list_t> graphs(thread_num);
+  if (!io_util::ParallelProcess<std::string>(
+          files,
+          [&graphs](const vec_str_t& files, int thread_id) {
+            auto& graph = graphs[thread_id];
+            std::vector<AdjValue> values;
+            LineParser line_parser;
+            for (const auto& file : files) {
+              DXINFO("Thread: %d is processing file: %s.", thread_id,
+                     file.c_str());
+              if (!line_parser.Open(file)) {
+                return false;
+              }
+              while (line_parser.NextBatch<AdjValue>(BATCH, &values)) {
+                for (auto& value : values) {
+                  auto& pairs = graph[value.node];
+                  pairs.insert(pairs.end(), value.pairs.begin(),
+                               value.pairs.end());
+                }
+              }
+            }
+            return true;
+          },
+          thread_num)) {
+    DXERROR("Failed to load graph.");
+    return false;
+  }
+
+  for (int i = 1; i < thread_num; ++i) {
+    for (const auto& entry : graphs[i]) {
+      auto& pairs = graphs[0][entry.first];
+      pairs.insert(pairs.end(), entry.second.begin(), entry.second.end());
+    }
+    adj_list_t().swap(graphs[i]);
+  }
+  graph->swap(graphs[0]);
+  return true;
+}
+
+void PrintQuality(const char* name, const ClusterQuality& quality) {
+  DXINFO("%s edge cut ratio: %.4f, max cluster size / mean cluster size: "
+         "%.3f.",
+         name, quality.edge_cut_ratio, quality.balance);
+}
+
+void CheckFlags() {
+  DXCHECK(!FLAGS_node_graph.empty());
+  DXCHECK(!FLAGS_out.empty());
+  DXCHECK(FLAGS_gs_thread_num > 0);
+  DXCHECK(FLAGS_cluster_num > 0);
+  DXCHECK(FLAGS_cluster_imbalance >= 0);
+  DXCHECK(FLAGS_cluster_iter_num >= 0);
+}
+
+int main(int argc, char** argv) {
+  google::SetUsageMessage("Usage: [Options]");
+#if HAVE_COMPILE_FLAGS_H == 1
+  google::SetVersionString("\n\n"
+#include "compile_flags.h"
+  );
+#endif
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  CheckFlags();
+
+  adj_list_t graph;
+  DXCHECK(LoadGraph(FLAGS_node_graph, FLAGS_gs_thread_num, &graph));
+  DXINFO("Number of source nodes: %zu.", graph.size());
+
+  index_map_t clusters;
+  DXCHECK(ClusterGraph(graph, FLAGS_cluster_num, FLAGS_cluster_imbalance,
+                       FLAGS_cluster_iter_num, &clusters));
+  DXINFO("Number of clustered nodes: %zu.", clusters.size());
+
+  // hashing as node % gs_shard_num does
+  index_map_t hash_clusters;
+  for (const auto& entry : clusters) {
+    hash_clusters.emplace(entry.first,
+                          (int)(entry.first % FLAGS_cluster_num));
+  }
+  PrintQuality("Hash", EvalClusters(graph, FLAGS_cluster_num, hash_clusters));
+  PrintQuality("Cluster", EvalClusters(graph, FLAGS_cluster_num, clusters));
+
+  DXCHECK(SaveClusters(clusters, FLAGS_out));
+  DXINFO("Wrote cluster file to: %s.", FLAGS_out.c_str());
+
+  google::ShutDownCommandLineFlags();
+  return 0;
+}
+
+}  // namespace
+}  // namespace embedx
+
+int main(int argc, char** argv) { return embedx::main(argc, argv); }
@@ -18,6 +18,9 @@
 
 #include "src/common/data_types.h"
 #include "src/graph/client/graph_client.h"
+#include "src/graph/data_op/gs_op_factory.h"
+#include "src/graph/data_op/gs_op_stats.h"
+#include "src/graph/data_op/meta_lookuper_op/dist_meta_lookuper.h"
 #include "src/sampler/random_walker_data_types.h"
 #include "src/tools/graph/graph_flags.h"
 
@@ -172,6 +175,21 @@ void LookupContextTEST(const GraphClient* graph_client, int test_number) {
   }
 }
 
+void DumpStats() {
+  DXINFO("Graph client op stats:\n%s",
+         graph_op::GSOpStatsRegistry::GetClientInstance()->ToString().c_str());
+
+  auto* op = graph_op::DistGSOpFactory::GetInstance()->LookupOrCreate(
+      "DistMetaLookuper");
+  DXCHECK(op != nullptr);
+  vec_str_t shard_stats;
+  DXCHECK(dynamic_cast<graph_op::DistMetaLookuper*>(op)->LookupStats(
+      &shard_stats));
+  for (size_t i = 0; i < shard_stats.size(); ++i) {
+    DXINFO("Graph server %zu op stats:\n%s", i, shard_stats[i].c_str());
+  }
+}
+
 class GraphClientTest {
  private:
   std::unique_ptr<GraphClient> graph_client_;
@@ -184,6 +202,8 @@ class GraphClientTest {
  public:
   bool Init(const std::string& ip_ports) {
     graph_config_.set_ip_ports(ip_ports);
+    graph_config_.set_hedge_percentile(FLAGS_gs_hedge_percentile);
+    graph_config_.set_hedge_min_delay_us(FLAGS_gs_hedge_min_delay_us);
     graph_client_ = NewGraphClient(graph_config_, GraphClientEnum::DIST);
     return graph_client_ != nullptr;
   }
@@ -196,6 +216,7 @@ class GraphClientTest {
     LookupFeatureTEST(graph_client_.get(), NUMBER_TEST);
     LookupNodeFeatureTEST(graph_client_.get(), NUMBER_TEST);
     LookupContextTEST(graph_client_.get(), NUMBER_TEST);
+    DumpStats();
   }
 };
 
@@ -13,10 +13,15 @@
 #include <deepx_core/common/stream.h>
 #include <gflags/gflags.h>
 
+#include "src/common/random.h"
 #include "src/graph/graph_config.h"
 #include "src/graph/server/dist_graph_server.h"
 #include "src/tools/graph/graph_flags.h"
 
+DEFINE_int32(seed, 0,
+             "Seed of samplers, each request handling thread draws from a "
+             "stream of its own, 0 for seeds from the clock.");
+
 namespace embedx {
 namespace {
 
@@ -24,14 +29,20 @@ void SetGraphConfig(GraphConfig* graph_config) {
   graph_config->set_ip_ports(FLAGS_gs_addrs);
   graph_config->set_shard_num(FLAGS_gs_shard_num);
   graph_config->set_shard_id(FLAGS_gs_shard_id);
+  graph_config->set_replica_id(FLAGS_gs_replica_id);
+  graph_config->set_partition_file(FLAGS_partition_file);
   graph_config->set_thread_num(FLAGS_gs_thread_num);
 
   graph_config->set_node_graph(FLAGS_node_graph);
   graph_config->set_node_config(FLAGS_node_config);
   graph_config->set_node_feature(FLAGS_node_feature);
   graph_config->set_neighbor_feature(FLAGS_neighbor_feature);
+  graph_config->set_edge_feature(FLAGS_edge_feature);
+  graph_config->set_item_feature(FLAGS_item_feature);
 
   graph_config->set_negative_sampler_type(FLAGS_negative_sampler_type);
+  graph_config->set_negative_sampler_power(FLAGS_negative_sampler_power);
+  graph_config->set_negative_update_ratio(FLAGS_negative_update_ratio);
   graph_config->set_neighbor_sampler_type(FLAGS_neighbor_sampler_type);
   graph_config->set_random_walker_type(FLAGS_random_walker_type);
 
@@ -40,6 +51,8 @@ void SetGraphConfig(GraphConfig* graph_config) {
   graph_config->set_max_node_per_rpc(FLAGS_max_node_per_rpc);
 
   graph_config->set_success_out(FLAGS_success_out);
+
+  graph_config->set_stats_interval(FLAGS_stats_interval);
 }
 
 /************************************************************************/
@@ -49,13 +62,14 @@ void CheckFlags() {
   DXCHECK(!FLAGS_gs_addrs.empty());
   DXCHECK(FLAGS_gs_shard_num > 0);
   DXCHECK(FLAGS_gs_shard_id >= 0);
+  DXCHECK(FLAGS_gs_replica_id >= 0);
   DXCHECK(FLAGS_gs_thread_num > 0);
 
   DXCHECK(!FLAGS_node_graph.empty());
 
-  DXCHECK(FLAGS_negative_sampler_type == 0 ||
-          FLAGS_negative_sampler_type == 1 ||
-          FLAGS_negative_sampler_type == 2 || FLAGS_negative_sampler_type == 3);
+  DXCHECK(FLAGS_negative_sampler_type >= 0 && FLAGS_negative_sampler_type <= 4);
+  DXCHECK(FLAGS_negative_sampler_power > 0);
+  DXCHECK(FLAGS_negative_update_ratio >= 0);
   DXCHECK(FLAGS_neighbor_sampler_type == 0 ||
           FLAGS_neighbor_sampler_type == 1 ||
           FLAGS_neighbor_sampler_type == 2 || FLAGS_neighbor_sampler_type == 3);
@@ -65,6 +79,7 @@ void CheckFlags() {
   DXCHECK(FLAGS_cache_type == 0 || FLAGS_cache_type == 1 ||
           FLAGS_cache_type == 2);
   DXCHECK(FLAGS_max_node_per_rpc > 0);
+  DXCHECK(FLAGS_stats_interval >= 0);
 
   if (!FLAGS_success_out.empty()) {
     deepx_core::AutoFileSystem fs;
@@ -81,6 +96,7 @@ int main(int argc, char* argv[]) {
   google::ParseCommandLineFlags(&argc, &argv, true);
 
   CheckFlags();
+  SetRandomSeed(FLAGS_seed);
 
   GraphConfig graph_config;
   SetGraphConfig(&graph_config);
@@ -12,13 +12,23 @@
 
 // dist and parallel
 DEFINE_int32(dist, 0, "0 for local conditions, otherwise distributed.");
-DEFINE_string(
-    gs_addrs, "",
-    "Graph server ip/port, format like:127.0.0.1:8000;127.0.0.1:8001.");
+DEFINE_string(gs_addrs, "",
+              "Graph server ip/port, format like:127.0.0.1:8000;127.0.0.1:8001,"
+              " replicas of a shard are separated by ',', e.g. "
+              "127.0.0.1:8000,127.0.0.1:8002;127.0.0.1:8001.");
 DEFINE_int32(gs_shard_num, 1, "Graph data shard number.");
 DEFINE_int32(gs_shard_id, 0, "Current shard id.");
+DEFINE_int32(gs_replica_id, 0, "Current replica id in the shard.");
+DEFINE_double(gs_hedge_percentile, 0,
+              "Graph client resends a request to another replica when it is "
+              "slower than this percentile of latency, 0 to disable.");
+DEFINE_int32(gs_hedge_min_delay_us, 1000,
+             "Minimal delay in microseconds before a hedged request.");
 DEFINE_int32(gs_worker_num, -1, "How many worker used to process graph data.");
 DEFINE_int32(gs_worker_id, -1, "Worker id of distributed graph server.");
+DEFINE_string(partition_file, "",
+              "Partition file of graph servers generated by partition_main, "
+              "empty for 'node % gs_shard_num'.");
 
 // data
 DEFINE_string(node_graph, "", "Node graph folder.");
@@ -27,12 +37,23 @@ DEFINE_string(node_config, "",
 DEFINE_string(node_feature, "", "Node feature folder.");
 DEFINE_string(neighbor_feature, "",
               "Neighbor feature folder, this can be empty.");
+DEFINE_string(edge_feature, "", "Edge feature folder, this can be empty.");
+DEFINE_string(item_feature, "",
+              "Item feature folder of deep models, this can be empty.");
 
 // sampler type
 DEFINE_int32(
     negative_sampler_type, 0,
     "Negative sampler method, for now support: 0 uniform | 1 frequency(alias) "
-    "| 2 frequency(word2vec) | 3 frequency(partial_sum).");
+    "| 2 frequency(word2vec) | 3 frequency(partial_sum) | 4 "
+    "frequency(compact_alias).");
+DEFINE_double(negative_sampler_power, 0.75,
+              "Distortion exponent of node frequencies in negative sampling.");
+DEFINE_double(negative_update_ratio, 0.01,
+              "The negative sampling table of a namespace is rebuilt by graph "
+              "updates once the nodes whose frequencies changed since the last "
+              "rebuild exceed this ratio of its nodes, 0 to rebuild on every "
+              "update.");
 DEFINE_int32(
     neighbor_sampler_type, 0,
     "Neighbor sampler method, for now support: 0 uniform | 1 frequency(alias) "
@@ -54,6 +75,11 @@ DEFINE_int32(max_node_per_rpc, 2000,
 DEFINE_int32(batch_node, 128, "Batch nodes.");
 DEFINE_int32(gs_thread_num, 1, "How many thread used to parse graph data.");
 
+// stats
+DEFINE_int32(stats_interval, 0,
+             "Interval seconds of dumping op stats of graph server, 0 to "
+             "disable.");
+
 // out
 DEFINE_string(out, "", "Output folder or file.");
 DEFINE_string(success_out, "",
@@ -17,17 +17,25 @@ DECLARE_int32(dist);
 DECLARE_string(gs_addrs);
 DECLARE_int32(gs_shard_num);
 DECLARE_int32(gs_shard_id);
+DECLARE_int32(gs_replica_id);
+DECLARE_double(gs_hedge_percentile);
+DECLARE_int32(gs_hedge_min_delay_us);
 DECLARE_int32(gs_worker_num);
 DECLARE_int32(gs_worker_id);
+DECLARE_string(partition_file);
 
 // data
 DECLARE_string(node_graph);
 DECLARE_string(node_config);
 DECLARE_string(node_feature);
 DECLARE_string(neighbor_feature);
+DECLARE_string(edge_feature);
+DECLARE_string(item_feature);
 
 // sampler type
 DECLARE_int32(negative_sampler_type);
+DECLARE_double(negative_sampler_power);
+DECLARE_double(negative_update_ratio);
 DECLARE_int32(neighbor_sampler_type);
 DECLARE_int32(random_walker_type);
 
@@ -40,6 +48,9 @@ DECLARE_double(cache_thld);
 DECLARE_int32(cache_type);
 DECLARE_int32(max_node_per_rpc);
 
+// stats
+DECLARE_int32(stats_interval);
+
 // output
 DECLARE_string(out);
 DECLARE_string(success_out);
@@ -14,6 +14,7 @@
 #include <algorithm>  // std::min
 
 #include "src/io/io_util.h"
+#include "src/io/text_buffer.h"
 
 namespace embedx {
 namespace {
@@ -82,28 +83,27 @@ bool MainUtil::RunMultiThread(const std::string& in, const std::string& out,
   return true;
 }
 
-bool MainUtil::DumpText(deepx_core::AutoOutputFileStream& ofs /* NOLINT */,
-                        std::ostringstream& oss /* NOLINT*/,
+bool MainUtil::DumpText(AsyncWriter* writer, std::string* buf,
                         const vec_int_t& nodes,
                         const std::vector<vec_pair_t>& pairs_list) const {
+  TextBuffer text;
+  text.Swap(buf);
   for (size_t i = 0; i < nodes.size(); ++i) {
-    oss.clear();
-    oss.str("");
-    oss << nodes[i];
-
+    text.Append((uint64_t)nodes[i]);
     for (const auto& pair : pairs_list[i]) {
-      oss << " " << pair.first << ":" << pair.second;
-    }
-    oss << "\n";
-
-    std::string s = oss.str();
-    ofs.Write(s.data(), s.size());
-    if (!ofs) {
-      DXERROR("Failed to dump file.");
-      return false;
+      text.Append(' ');
+      text.Append((uint64_t)pair.first);
+      text.Append(':');
+      text.Append((float)pair.second);
     }
+    text.Append('\n');
   }
+  text.Swap(buf);
 
+  if (!writer->Write(buf)) {
+    DXERROR("Failed to dump file.");
+    return false;
+  }
   return true;
 }
 
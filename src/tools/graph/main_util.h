@@ -10,13 +10,11 @@
 //
 
 #pragma once
-#include <deepx_core/common/stream.h>
-
-#include <sstream>  // std::ostringstream
 #include <string>
 #include <vector>
 
 #include "src/common/data_types.h"
+#include "src/io/async_writer.h"
 
 namespace embedx {
 
@@ -35,8 +33,9 @@ class MainUtil {
   virtual const char* task_name() const noexcept = 0;
   virtual bool RunEntry(int entry_id, const vec_str_t& in_files,
                         const std::string& out) = 0;
-  bool DumpText(deepx_core::AutoOutputFileStream& ofs /* NOLINT */,
-                std::ostringstream& oss /* NOLINT*/, const vec_int_t& nodes,
+  // Formats lines of 'node pair.first:pair.second ...' into 'buf' and hands
+  // it to 'writer'.
+  bool DumpText(AsyncWriter* writer, std::string* buf, const vec_int_t& nodes,
                 const std::vector<vec_pair_t>& pairs_list) const;
 };
 
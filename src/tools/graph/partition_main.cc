@@ -0,0 +1,163 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>  // std::max_element, std::min
+#include <memory>     // std::unique_ptr
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "src/common/data_types.h"
+#include "src/io/graph_cluster.h"
+#include "src/io/io_util.h"
+#include "src/io/line_parser.h"
+#include "src/io/partitioner.h"
+#include "src/tools/graph/graph_flags.h"
+
+DEFINE_int32(partition_type, 2,
+             "Partitioner type, for now support: 0 hash | 1 range | 2 degree | "
+             "3 cluster.");
+DEFINE_int32(hub_num, 0, "Number of the heaviest nodes replicated on shards.");
+DEFINE_int32(partition_assign_num, 100000,
+             "Number of the heaviest nodes assigned explicitly by degree "
+             "partitioner, the others are hashed.");
+DEFINE_string(cluster_file, "",
+              "Node cluster file generated by cluster_main, required by "
+              "cluster partitioner.");
+
+namespace embedx {
+namespace {
+
+constexpr int BATCH = 128;
+
+using load_map_t = std::unordered_map<int_t, double>;
+
+// The load of a node is its out degree plus the times it is a neighbor,
+// which is about how often graph servers are asked for it.
+bool CountLoads(const std::string& node_graph, int thread_num,
+                std::vector<node_load_t>* node_loads) {
+  vec_str_t files;
+  if (!io_util::ListFile(node_graph, &files)) {
+    return false;
+  }
+
+  thread_num = std::min(thread_num, (int)files.size());
+  std::vector<load_map_t> load_maps(thread_num);
+  if (!io_util::ParallelProcess<std::string>(
+          files,
+          [&load_maps](const vec_str_t& files, int thread_id) {
+            auto& load_map = load_maps[thread_id];
+            std::vector<AdjValue> values;
+            LineParser line_parser;
+            for (const auto& file : files) {
+              DXINFO("Thread: %d is processing file: %s.", thread_id,
+                     file.c_str());
+              if (!line_parser.Open(file)) {
+                return false;
+              }
+              while (line_parser.NextBatch<AdjValue>(BATCH, &values)) {
+                for (const auto& value : values) {
+                  load_map[value.node] += 1.0 + value.pairs.size();
+                  for (const auto& pair : value.pairs) {
+                    load_map[pair.first] += 1.0;
+                  }
+                }
+              }
+            }
+            return true;
+          },
+          thread_num)) {
+    DXERROR("Failed to count node loads.");
+    return false;
+  }
+
+  for (int i = 1; i < thread_num; ++i) {
+    for (const auto& entry : load_maps[i]) {
+      load_maps[0][entry.first] += entry.second;
+    }
+    load_map_t().swap(load_maps[i]);
+  }
+  node_loads->assign(load_maps[0].begin(), load_maps[0].end());
+  return true;
+}
+
+void PrintShardLoads(const char* name, const Partitioner& partitioner,
+                     const std::vector<node_load_t>& node_loads) {
+  auto loads = ShardLoads(partitioner, node_loads);
+  double sum = 0;
+  for (size_t i = 0; i < loads.size(); ++i) {
+    DXINFO("%s shard %zu load: %.0f.", name, i, loads[i]);
+    sum += loads[i];
+  }
+  double max_load = *std::max_element(loads.begin(), loads.end());
+  DXINFO("%s max load / mean load: %.3f.", name,
+         max_load / (sum / loads.size()));
+}
+
+void CheckFlags() {
+  DXCHECK(!FLAGS_node_graph.empty());
+  DXCHECK(!FLAGS_out.empty());
+  DXCHECK(FLAGS_gs_shard_num > 0);
+  DXCHECK(FLAGS_gs_thread_num > 0);
+  DXCHECK(FLAGS_partition_type >= 0 && FLAGS_partition_type <= 3);
+  DXCHECK(FLAGS_partition_type != 3 || !FLAGS_cluster_file.empty());
+  DXCHECK(FLAGS_hub_num >= 0);
+  DXCHECK(FLAGS_partition_assign_num >= 0);
+}
+
+int main(int argc, char** argv) {
+  google::SetUsageMessage("Usage: [Options]");
+#if HAVE_COMPILE_FLAGS_H == 1
+  google::SetVersionString("\n\n"
+#include "compile_flags.h"
+  );
+#endif
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  CheckFlags();
+
+  std::vector<node_load_t> node_loads;
+  DXCHECK(CountLoads(FLAGS_node_graph, FLAGS_gs_thread_num, &node_loads));
+  DXINFO("Number of nodes: %zu.", node_loads.size());
+
+  auto hash = NewPartitioner(PartitionerEnum::HASH, FLAGS_gs_shard_num);
+  DXCHECK(hash);
+  PrintShardLoads("Hash", *hash, node_loads);
+
+  std::unique_ptr<Partitioner> partitioner;
+  if ((PartitionerEnum)FLAGS_partition_type == PartitionerEnum::CLUSTER) {
+    index_map_t clusters;
+    DXCHECK(LoadClusters(FLAGS_cluster_file, &clusters));
+    DXINFO("Number of clustered nodes: %zu.", clusters.size());
+    partitioner = BuildClusterPartitioner(FLAGS_gs_shard_num, FLAGS_hub_num,
+                                          node_loads, clusters);
+  } else {
+    partitioner = BuildPartitioner(
+        (PartitionerEnum)FLAGS_partition_type, FLAGS_gs_shard_num,
+        FLAGS_hub_num, FLAGS_partition_assign_num, node_loads);
+  }
+  DXCHECK(partitioner);
+  PrintShardLoads("Partition", *partitioner, node_loads);
+
+  DXCHECK(SavePartitioner(*partitioner, FLAGS_out));
+  DXINFO("Wrote partition file to: %s.", FLAGS_out.c_str());
+
+  google::ShutDownCommandLineFlags();
+  return 0;
+}
+
+}  // namespace
+}  // namespace embedx
+
+int main(int argc, char** argv) { return embedx::main(argc, argv); }
@@ -17,7 +17,6 @@
 
 #include <cinttypes>  // PRIu64
 #include <memory>     // std::unique_ptr
-#include <sstream>    // std::ostringstream
 #include <string>
 #include <vector>
 
@@ -26,6 +25,7 @@
 #include "src/graph/graph_config.h"
 #include "src/io/io_util.h"
 #include "src/io/line_parser.h"
+#include "src/io/text_buffer.h"
 #include "src/io/value.h"
 #include "src/sampler/random_walker_data_types.h"
 #include "src/tools/graph/graph_flags.h"
@@ -102,6 +102,8 @@ class RandomWalkerMain : public MainUtil {
   bool Init() override {
     if (FLAGS_dist) {
       graph_config_.set_ip_ports(FLAGS_gs_addrs);
+      graph_config_.set_hedge_percentile(FLAGS_gs_hedge_percentile);
+      graph_config_.set_hedge_min_delay_us(FLAGS_gs_hedge_min_delay_us);
     } else {
       graph_config_.set_node_graph(FLAGS_node_graph);
       graph_config_.set_node_config(FLAGS_node_config);
@@ -150,35 +152,36 @@ class RandomWalkerMain : public MainUtil {
 
  private:
   const char* task_name() const noexcept override { return "RandomWalk"; }
-  void DumpText(deepx_core::AutoOutputFileStream& ofs /* NOLINT */,
-                std::ostringstream& oss /* NOLINT */,
+  bool DumpText(AsyncWriter* writer, std::string* buf,
                 const vec_int_t& cur_nodes,
-                const std::vector<vec_int_t>& seqs) noexcept {
+                const std::vector<vec_int_t>& seqs) const {
+    TextBuffer text;
+    text.Swap(buf);
     for (size_t i = 0; i < cur_nodes.size(); ++i) {
-      auto cur_node = cur_nodes[i];
+      auto cur_node = (uint64_t)cur_nodes[i];
       const auto& seq = seqs[i];
       if (seq.empty()) {
         continue;
       }
 
-      oss.clear();
-      oss.str("");
-
       if (dump_type_ == 0) {
-        oss << cur_node;
+        text.Append(cur_node);
         for (auto node : seq) {
-          oss << " " << node;
+          text.Append(' ');
+          text.Append((uint64_t)node);
         }
-        oss << "\n";
+        text.Append('\n');
       } else {
         for (auto node : seq) {
-          oss << cur_node << " " << node << "\n";
+          text.Append(cur_node);
+          text.Append(' ');
+          text.Append((uint64_t)node);
+          text.Append('\n');
         }
       }
-
-      std::string s = oss.str();
-      ofs.Write(s.data(), s.size());
     }
+    text.Swap(buf);
+    return writer->Write(buf);
   }
 
   bool RunEntry(int entry_id, const vec_str_t& files,
@@ -186,8 +189,8 @@ class RandomWalkerMain : public MainUtil {
     DXINFO("%s id: %d is processing ...", entry_flag_.c_str(), entry_id);
 
     LineParser line_parser;
-    deepx_core::AutoOutputFileStream ofs;
-    std::ostringstream oss;
+    AsyncWriter writer;
+    std::string buf;
     for (int i = 0; i < epoch_; ++i) {
       DXINFO("Random walker epoch: %d.", i);
 
@@ -199,7 +202,7 @@ class RandomWalkerMain : public MainUtil {
 
         auto out_file = deepx_core::GetOutputPredictFile(
             out, file + "_" + std::to_string(i));
-        if (!ofs.Open(out_file)) {
+        if (!writer.Open(out_file)) {
           return false;
         }
 
@@ -215,7 +218,9 @@ class RandomWalkerMain : public MainUtil {
               FilterNode(values, walker_info.meta_path, &cur_nodes);
               graph_client_->StaticTraverse(cur_nodes, walk_lens, walker_info,
                                             &seqs);
-              DumpText(ofs, oss, cur_nodes, seqs);
+              if (!DumpText(&writer, &buf, cur_nodes, seqs)) {
+                return false;
+              }
             }
           }
         } else {
@@ -224,9 +229,15 @@ class RandomWalkerMain : public MainUtil {
             cur_nodes = Collect<NodeValue, int_t>(values, &NodeValue::node);
             graph_client_->StaticTraverse(cur_nodes, walk_lens, walker_info,
                                           &seqs);
-            DumpText(ofs, oss, cur_nodes, seqs);
+            if (!DumpText(&writer, &buf, cur_nodes, seqs)) {
+              return false;
+            }
           }
         }
+
+        if (!writer.Close()) {
+          return false;
+        }
       }
     }
     return true;
@@ -50,6 +50,8 @@ class SwingMain : public MainUtil {
   bool Init() override {
     if (FLAGS_dist) {
       graph_config_.set_ip_ports(FLAGS_gs_addrs);
+      graph_config_.set_hedge_percentile(FLAGS_gs_hedge_percentile);
+      graph_config_.set_hedge_min_delay_us(FLAGS_gs_hedge_min_delay_us);
     } else {
       graph_config_.set_node_graph(FLAGS_node_graph);
       graph_config_.set_thread_num(FLAGS_gs_thread_num);
@@ -80,8 +82,8 @@ class SwingMain : public MainUtil {
 
     Swing swing(graph_client_.get(), swing_config_);
     LineParser line_parser;
-    deepx_core::AutoOutputFileStream ofs;
-    std::ostringstream oss;
+    AsyncWriter writer;
+    std::string buf;
 
     for (auto& file : files) {
       DXINFO("Processed file: %s.", file.c_str());
@@ -90,7 +92,7 @@ class SwingMain : public MainUtil {
       }
 
       auto out_file = deepx_core::GetOutputPredictFile(out, file);
-      if (!ofs.Open(out_file)) {
+      if (!writer.Open(out_file)) {
         return false;
       }
 
@@ -107,10 +109,14 @@ class SwingMain : public MainUtil {
           return false;
         }
 
-        if (!MainUtil::DumpText(ofs, oss, item_nodes, item_scores)) {
+        if (!MainUtil::DumpText(&writer, &buf, item_nodes, item_scores)) {
           return false;
         }
       }
+
+      if (!writer.Close()) {
+        return false;
+      }
     }
 
     return true;
@@ -0,0 +1,78 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include <deepx_core/dx_log.h>
+#include <deepx_core/graph/graph.h>
+#include <deepx_core/graph/model.h>
+#include <gflags/gflags.h>
+
+#include <cstddef>
+#include <string>
+
+#include "src/tools/quantized_model.h"
+
+DEFINE_string(in_graph, "", "Input graph file.");
+DEFINE_string(in_model, "", "Input model param file.");
+DEFINE_string(out, "", "Output quantized model file.");
+
+namespace embedx {
+namespace {
+
+// bytes of the float rows of the embedding tables
+size_t SRMBytes(const deepx_core::TensorMap& param) {
+  size_t bytes = 0;
+  for (const auto& entry : param) {
+    if (entry.second.is<deepx_core::DataType::srm_t>()) {
+      const auto& W = entry.second.unsafe_to_ref<deepx_core::DataType::srm_t>();
+      bytes += W.size() * W.col() * sizeof(float);
+    }
+  }
+  return bytes;
+}
+
+void CheckFlags() {
+  DXCHECK(!FLAGS_in_graph.empty());
+  DXCHECK(!FLAGS_in_model.empty());
+  DXCHECK(!FLAGS_out.empty());
+}
+
+int main(int argc, char** argv) {
+  google::SetUsageMessage("Usage: [Options]");
+#if HAVE_COMPILE_FLAGS_H == 1
+  google::SetVersionString("\n\n"
+#include "compile_flags.h"
+  );
+#endif
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  CheckFlags();
+
+  deepx_core::Graph graph;
+  DXCHECK(graph.Load(FLAGS_in_graph));
+  deepx_core::Model model;
+  model.Init(&graph);
+  DXCHECK(model.Load(FLAGS_in_model));
+
+  QuantizedModel quantized_model;
+  DXCHECK(quantized_model.Init(model.param()));
+  DXCHECK(quantized_model.Save(FLAGS_out));
+  DXINFO("Embedding tables take %zu bytes of float rows, %zu bytes quantized.",
+         SRMBytes(model.param()), quantized_model.srm_memory_bytes());
+  DXINFO("Wrote quantized model to: %s.", FLAGS_out.c_str());
+
+  google::ShutDownCommandLineFlags();
+  return 0;
+}
+
+}  // namespace
+}  // namespace embedx
+
+int main(int argc, char** argv) { return embedx::main(argc, argv); }
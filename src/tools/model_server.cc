@@ -18,7 +18,11 @@
 #include <deepx_core/instance/base.h>
 #include <embedx/model_server.h>
 
+#include <algorithm>  // std::max
+
+#include "src/ann/hnsw_index.h"
 #include "src/model/instance_node_name.h"
+#include "src/tools/quantized_model.h"
 
 namespace embedx {
 
@@ -29,6 +33,15 @@ using int_t = InstanceReader::int_t;
 using tsr_t = InstanceReader::tsr_t;
 using csr_t = InstanceReader::csr_t;
 
+namespace {
+
+// OpContext of a quantized model, see QuantizedModel::InitBatchParam.
+struct QuantizedOpContext : public OpContext {
+  TensorMap batch_param;
+};
+
+}  // namespace
+
 static void EmplaceRow(const features_t& features, csr_t* X) {
   static constexpr float MAX_FEATURE_VALUE =
       InstanceReaderHelper<float, uint64_t>::MAX_FEATURE_VALUE;
@@ -45,6 +58,15 @@ ModelServer::ModelServer() {}
 
 ModelServer::~ModelServer() {}
 
+void ModelServer::Forward(OpContext* op_context) const {
+  if (quantized_model_) {
+    quantized_model_->LookupRows(
+        *op_context->mutable_inst(),
+        &static_cast<QuantizedOpContext*>(op_context)->batch_param);
+  }
+  op_context->Predict();
+}
+
 bool ModelServer::Load(const std::string& file) {
   AutoInputFileStream is;
   if (!is.Open(file)) {
@@ -62,6 +84,7 @@ bool ModelServer::Load(const std::string& file) {
   DXINFO("Done.");
 
   DXINFO("Loading model from: %s...", file.c_str());
+  quantized_model_.reset();
   model_.reset(new Model);
   model_->Init(graph_.get());
   if (!model_->Read(is)) {
@@ -85,262 +108,120 @@ bool ModelServer::LoadGraph(const std::string& file) {
 bool ModelServer::LoadModel(const std::string& file) {
   model_.reset(new Model);
   model_->Init(graph_.get());
-  return model_->Load(file);
-}
-
-bool ModelServer::Predict(const features_t& features, float* prob) const {
-  if (!graph_ || !model_) {
-    return false;
+  if (!IsQuantizedModelFile(file)) {
+    quantized_model_.reset();
+    return model_->Load(file);
   }
 
-  OpContext op_context;
-  op_context.Init(graph_.get(), model_->mutable_param());
-  if (!op_context.InitOp({target_name_}, -1)) {
+  quantized_model_.reset(new QuantizedModel);
+  if (!quantized_model_->Load(file)) {
+    quantized_model_.reset();
     return false;
   }
-
-  Instance* inst = op_context.mutable_inst();
-  auto& X = inst->insert<csr_t>(deepx_core::X_NAME);
-  EmplaceRow(features, &X);
-  inst->set_batch(X.row());
-
-  op_context.InitPredict();
-  op_context.Predict();
-  const auto& P = op_context.hidden().get<tsr_t>(target_name_);
-  DXASSERT(P.is_rank(2));
-  DXASSERT(P.same_shape(X.row(), 1));
-  *prob = (float)P.data(0);
+  quantized_model_->InitParam(model_->mutable_param());
+  DXINFO("Loaded quantized model, embedding tables take %zu bytes.",
+         quantized_model_->srm_memory_bytes());
   return true;
 }
 
-bool ModelServer::Predict(const features_t& features,
-                          std::vector<float>* probs) const {
-  if (!graph_ || !model_) {
-    return false;
-  }
+bool ModelServer::LoadAnnIndex(const std::string& file) {
+  ann_index_ = ann::HnswIndex::Load(file);
+  return ann_index_ != nullptr;
+}
 
-  OpContext op_context;
-  op_context.Init(graph_.get(), model_->mutable_param());
-  if (!op_context.InitOp({target_name_}, -1)) {
+bool ModelServer::Predict(const features_t& features, float* prob) const {
+  auto op_context = NewOpContext();
+  if (!op_context) {
     return false;
   }
+  return Predict(op_context.get(), features, prob);
+}
 
-  Instance* inst = op_context.mutable_inst();
-  auto& X = inst->insert<csr_t>(deepx_core::X_NAME);
-  EmplaceRow(features, &X);
-  inst->set_batch(X.row());
-
-  op_context.InitPredict();
-  op_context.Predict();
-  const auto& P = op_context.hidden().get<tsr_t>(target_name_);
-  DXASSERT(P.is_rank(2));
-  int col = P.dim(1);
-  DXASSERT(P.same_shape(X.row(), col));
-  const float_t* _P = P.data();
-  probs->resize(col);
-  for (int j = 0; j < col; ++j) {
-    (*probs)[j] = (float)*_P;
-    ++_P;
+bool ModelServer::Predict(const features_t& features,
+                          std::vector<float>* probs) const {
+  auto op_context = NewOpContext();
+  if (!op_context) {
+    return false;
   }
-  return true;
+  return Predict(op_context.get(), features, probs);
 }
 
 bool ModelServer::BatchPredict(const std::vector<features_t>& batch_features,
                                std::vector<float>* batch_prob) const {
-  if (batch_features.empty()) {
-    return false;
-  }
-
-  if (!graph_ || !model_) {
-    return false;
-  }
-
-  OpContext op_context;
-  op_context.Init(graph_.get(), model_->mutable_param());
-  if (!op_context.InitOp({target_name_}, -1)) {
+  auto op_context = NewOpContext();
+  if (!op_context) {
     return false;
   }
-
-  Instance* inst = op_context.mutable_inst();
-  auto& X = inst->insert<csr_t>(deepx_core::X_NAME);
-  for (const auto& features : batch_features) {
-    EmplaceRow(features, &X);
-  }
-  inst->set_batch(X.row());
-
-  op_context.InitPredict();
-  op_context.Predict();
-  const auto& P = op_context.hidden().get<tsr_t>(target_name_);
-  DXASSERT(P.is_rank(2));
-  DXASSERT(P.same_shape(X.row(), 1));
-  batch_prob->resize(X.row());
-  const float_t* _P = P.data();
-  for (int i = 0; i < X.row(); ++i) {
-    (*batch_prob)[i] = (float)*_P;
-    ++_P;
-  }
-  return true;
+  return BatchPredict(op_context.get(), batch_features, batch_prob);
 }
 
 bool ModelServer::BatchPredict(
     const std::vector<features_t>& batch_features,
     std::vector<std::vector<float>>* batch_probs) const {
-  if (batch_features.empty()) {
-    return false;
-  }
-
-  if (!graph_ || !model_) {
-    return false;
-  }
-
-  OpContext op_context;
-  op_context.Init(graph_.get(), model_->mutable_param());
-  if (!op_context.InitOp({target_name_}, -1)) {
+  auto op_context = NewOpContext();
+  if (!op_context) {
     return false;
   }
-
-  Instance* inst = op_context.mutable_inst();
-  auto& X = inst->insert<csr_t>(deepx_core::X_NAME);
-  for (const auto& features : batch_features) {
-    EmplaceRow(features, &X);
-  }
-  inst->set_batch(X.row());
-
-  op_context.InitPredict();
-  op_context.Predict();
-  const auto& P = op_context.hidden().get<tsr_t>(target_name_);
-  DXASSERT(P.is_rank(2));
-  int col = P.dim(1);
-  DXASSERT(P.same_shape(X.row(), col));
-  batch_probs->resize(X.row());
-  const float_t* _P = P.data();
-  batch_probs->resize(X.row());
-  for (int i = 0; i < X.row(); ++i) {
-    auto& batch_prob = (*batch_probs)[i];
-    batch_prob.resize(col);
-    for (int j = 0; j < col; ++j) {
-      batch_prob[j] = (float)*_P;
-      ++_P;
-    }
-  }
-  return true;
+  return BatchPredict(op_context.get(), batch_features, batch_probs);
 }
 
 bool ModelServer::PredictUserEmbedding(const features_t& user_features,
                                        embedding_t* embedding) const {
-  if (!graph_ || !model_) {
-    return false;
-  }
-
-  OpContext op_context;
-  op_context.Init(graph_.get(), model_->mutable_param());
-  if (!op_context.InitOp({target_name_}, -1)) {
+  auto op_context = NewOpContext();
+  if (!op_context) {
     return false;
   }
-
-  Instance* inst = op_context.mutable_inst();
-  auto& X = inst->insert<csr_t>(instance_name::X_USER_FEATURE_NAME);
-  EmplaceRow(user_features, &X);
-  inst->set_batch(X.row());
-
-  op_context.InitPredict();
-  op_context.Predict();
-  const auto& hidden = op_context.hidden().get<tsr_t>(target_name_);
-  DXASSERT(hidden.is_rank(2));
-  int col = hidden.dim(1);
-  DXASSERT(hidden.same_shape(X.row(), col));
-  const float_t* _P = hidden.data();
-  embedding->resize(col);
-  for (int j = 0; j < col; ++j) {
-    (*embedding)[j] = (float)*_P;
-    ++_P;
-  }
-  return true;
+  return PredictUserEmbedding(op_context.get(), user_features, embedding);
 }
 
 bool ModelServer::BatchPredictUserEmbedding(
     const std::vector<features_t>& batch_user_features,
     std::vector<embedding_t>* embeddings) const {
-  if (!graph_ || !model_) {
-    return false;
-  }
-
-  OpContext op_context;
-  op_context.Init(graph_.get(), model_->mutable_param());
-  if (!op_context.InitOp({target_name_}, -1)) {
+  auto op_context = NewOpContext();
+  if (!op_context) {
     return false;
   }
-
-  Instance* inst = op_context.mutable_inst();
-  auto& X = inst->insert<csr_t>(instance_name::X_USER_FEATURE_NAME);
-  for (const auto& features : batch_user_features) {
-    EmplaceRow(features, &X);
-  }
-  inst->set_batch(X.row());
-
-  op_context.InitPredict();
-  op_context.Predict();
-  const auto& hidden = op_context.hidden().get<tsr_t>(target_name_);
-  DXASSERT(hidden.is_rank(2));
-  int col = hidden.dim(1);
-  DXASSERT(hidden.same_shape(X.row(), col));
-  embeddings->resize(X.row());
-  const float_t* _P = hidden.data();
-  embeddings->resize(X.row());
-  for (int i = 0; i < X.row(); ++i) {
-    auto& embedding = (*embeddings)[i];
-    embedding.resize(col);
-    for (int j = 0; j < col; ++j) {
-      embedding[j] = (float)*_P;
-      ++_P;
-    }
-  }
-  return true;
+  return BatchPredictUserEmbedding(op_context.get(), batch_user_features,
+                                   embeddings);
 }
 
 bool ModelServer::BatchGraphDeepFMPredict(
     const std::vector<features_t>& batch_features,
     const std::vector<features_t>& batch_users,
     std::vector<float>* batch_prob) const {
-  DXCHECK(target_type_ == 1);
-  if (batch_features.empty()) {
-    return false;
-  }
-
-  if (!graph_ || !model_) {
+  auto op_context = NewOpContext();
+  if (!op_context) {
     return false;
   }
+  return BatchGraphDeepFMPredict(op_context.get(), batch_features, batch_users,
+                                 batch_prob);
+}
 
-  OpContext op_context;
-  op_context.Init(graph_.get(), model_->mutable_param());
-  if (!op_context.InitOp({target_name_}, -1)) {
+bool ModelServer::SearchItems(const embedding_t& embedding, int k,
+                              scored_items_t* items) const {
+  if (!ann_index_ || (int)embedding.size() != ann_index_->dim() || k <= 0) {
     return false;
   }
 
-  Instance* inst = op_context.mutable_inst();
-  auto& X = inst->insert<csr_t>(deepx_core::X_NAME);
-  for (const auto& features : batch_features) {
-    EmplaceRow(features, &X);
-  }
+  std::vector<ann::scored_node_t> nodes;
+  ann_index_->Search(embedding.data(), k, std::max(ann_ef_, k), &nodes);
+  items->assign(nodes.begin(), nodes.end());
+  return true;
+}
 
-  auto& User = inst->insert<csr_t>(instance_name::X_USER_NODE_NAME);
-  for (const auto& users : batch_users) {
-    EmplaceRow(users, &User);
+bool ModelServer::BatchRetrieve(
+    const std::vector<features_t>& batch_user_features, int k,
+    std::vector<scored_items_t>* batch_items) const {
+  std::vector<embedding_t> embeddings;
+  if (!BatchPredictUserEmbedding(batch_user_features, &embeddings)) {
+    return false;
   }
-  DXASSERT(X.row() == User.row());
 
-  inst->set_batch(X.row());
-
-  op_context.InitPredict();
-  op_context.Predict();
-  const auto& P = op_context.hidden().get<tsr_t>(target_name_);
-  DXASSERT(P.is_rank(2));
-  DXASSERT(P.same_shape(X.row(), 1));
-  batch_prob->resize(X.row());
-  const float_t* _P = P.data();
-  for (int i = 0; i < X.row(); ++i) {
-    (*batch_prob)[i] = (float)*_P;
-    ++_P;
+  batch_items->resize(embeddings.size());
+  for (size_t i = 0; i < embeddings.size(); ++i) {
+    if (!SearchItems(embeddings[i], k, &(*batch_items)[i])) {
+      return false;
+    }
   }
   return true;
 }
@@ -349,17 +230,30 @@ static void DeleteOpContext(OpContext* op_context) noexcept {
   delete op_context;
 }
 
+static void DeleteQuantizedOpContext(OpContext* op_context) noexcept {
+  delete static_cast<QuantizedOpContext*>(op_context);
+}
+
 std::unique_ptr<OpContext, void (*)(OpContext*)> ModelServer::NewOpContext()
     const {
-  std::unique_ptr<OpContext, void (*)(OpContext*)> op_context(new OpContext,
-                                                              DeleteOpContext);
+  std::unique_ptr<OpContext, void (*)(OpContext*)> op_context(
+      quantized_model_ ? new QuantizedOpContext : new OpContext,
+      quantized_model_ ? DeleteQuantizedOpContext : DeleteOpContext);
 
   if (!graph_ || !model_) {
     op_context.reset();
     return op_context;
   }
 
-  op_context->Init(graph_.get(), model_->mutable_param());
+  TensorMap* param = model_->mutable_param();
+  if (quantized_model_) {
+    TensorMap* batch_param =
+        &static_cast<QuantizedOpContext*>(op_context.get())->batch_param;
+    quantized_model_->InitBatchParam(param, batch_param);
+    param = batch_param;
+  }
+
+  op_context->Init(graph_.get(), param);
   if (!op_context->InitOp({target_name_}, -1)) {
     op_context.reset();
     return op_context;
@@ -382,7 +276,7 @@ bool ModelServer::Predict(OpContext* op_context, const features_t& features,
     op_context->InitPredict();
   }
 
-  op_context->Predict();
+  Forward(op_context);
   const auto& P = op_context->hidden().get<tsr_t>(target_name_);
   DXASSERT(P.is_rank(2));
   DXASSERT(P.same_shape(X.row(), 1));
@@ -404,7 +298,7 @@ bool ModelServer::Predict(OpContext* op_context, const features_t& features,
     op_context->InitPredict();
   }
 
-  op_context->Predict();
+  Forward(op_context);
   const auto& P = op_context->hidden().get<tsr_t>(target_name_);
   DXASSERT(P.is_rank(2));
   int col = P.dim(1);
@@ -439,7 +333,7 @@ bool ModelServer::BatchPredict(OpContext* op_context,
     op_context->InitPredict();
   }
 
-  op_context->Predict();
+  Forward(op_context);
   const auto& P = op_context->hidden().get<tsr_t>(target_name_);
   DXASSERT(P.is_rank(2));
   DXASSERT(P.same_shape(X.row(), 1));
@@ -473,7 +367,7 @@ bool ModelServer::BatchPredict(
     op_context->InitPredict();
   }
 
-  op_context->Predict();
+  Forward(op_context);
   const auto& P = op_context->hidden().get<tsr_t>(target_name_);
   DXASSERT(P.is_rank(2));
   int col = P.dim(1);
@@ -501,7 +395,7 @@ bool ModelServer::PredictUserEmbedding(OpContext* op_context,
   inst->set_batch(X.row());
 
   op_context->InitPredict();
-  op_context->Predict();
+  Forward(op_context);
   const auto& hidden = op_context->hidden().get<tsr_t>(target_name_);
   DXASSERT(hidden.is_rank(2));
   int col = hidden.dim(1);
@@ -526,7 +420,7 @@ bool ModelServer::BatchPredictUserEmbedding(
   inst->set_batch(X.row());
 
   op_context->InitPredict();
-  op_context->Predict();
+  Forward(op_context);
   const auto& hidden = op_context->hidden().get<tsr_t>(target_name_);
   DXASSERT(hidden.is_rank(2));
   int col = hidden.dim(1);
@@ -569,7 +463,7 @@ bool ModelServer::BatchGraphDeepFMPredict(
   inst->set_batch(X.row());
 
   op_context->InitPredict();
-  op_context->Predict();
+  Forward(op_context);
   const auto& P = op_context->hidden().get<tsr_t>(target_name_);
   DXASSERT(P.is_rank(2));
   DXASSERT(P.same_shape(X.row(), 1));
@@ -582,4 +476,22 @@ bool ModelServer::BatchGraphDeepFMPredict(
   return true;
 }
 
+bool ModelServer::BatchRetrieve(
+    OpContext* op_context, const std::vector<features_t>& batch_user_features,
+    int k, std::vector<scored_items_t>* batch_items) const {
+  std::vector<embedding_t> embeddings;
+  if (!BatchPredictUserEmbedding(op_context, batch_user_features,
+                                 &embeddings)) {
+    return false;
+  }
+
+  batch_items->resize(embeddings.size());
+  for (size_t i = 0; i < embeddings.size(); ++i) {
+    if (!SearchItems(embeddings[i], k, &(*batch_items)[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace embedx
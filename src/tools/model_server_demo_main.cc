@@ -23,6 +23,9 @@ DEFINE_int32(target_type, 2, "Target type for inference.");
 DEFINE_string(in, "", "Input file.");
 DEFINE_string(in_graph, "", "Input graph file.");
 DEFINE_string(in_model, "", "Input model param file.");
+DEFINE_string(in_ann_index, "", "Input ann index file of item embeddings.");
+DEFINE_int32(ann_k, 10, "Number of items retrieved for each user.");
+DEFINE_int32(ann_ef, 64, "Number of candidates of ann search.");
 
 namespace embedx {
 namespace {
@@ -44,6 +47,7 @@ int main(int argc, char** argv) {
   char colon;
   std::vector<features_t> batch_features;
   std::vector<std::vector<float>> batch_probs;
+  std::vector<scored_items_t> batch_items;
 
   // The target type must be set before loading the model.
   // 1 for classification prob
@@ -62,6 +66,13 @@ int main(int argc, char** argv) {
     DXCHECK_THROW(model_server.LoadModel(FLAGS_in_model));
   }
 
+  if (!FLAGS_in_ann_index.empty()) {
+    DXCHECK_THROW(FLAGS_target_type == 2);
+    DXCHECK_THROW(FLAGS_ann_k > 0);
+    DXCHECK_THROW(model_server.LoadAnnIndex(FLAGS_in_ann_index));
+    model_server.set_ann_ef(FLAGS_ann_ef);
+  }
+
   auto op_context = model_server.NewOpContext();
   DXCHECK_THROW(op_context);
 
@@ -74,6 +85,22 @@ int main(int argc, char** argv) {
     while (is >> feature_id >> colon >> feature_value) {
       features.emplace_back(feature_id, feature_value);
     }
+
+    // user embedding plus retrieval, output 'item:score' pairs
+    if (!FLAGS_in_ann_index.empty()) {
+      DXCHECK_THROW(model_server.BatchRetrieve(op_context.get(), batch_features,
+                                               FLAGS_ann_k, &batch_items));
+      auto& items = batch_items[0];
+      for (size_t i = 0; i < items.size(); ++i) {
+        std::cout << items[i].first << ":" << items[i].second;
+        if (i != items.size() - 1) {
+          std::cout << " ";
+        }
+      }
+      std::cout << "\n";
+      continue;
+    }
+
     DXCHECK_THROW(model_server.BatchPredictUserEmbedding(
         op_context.get(), batch_features, &batch_probs));
     auto& probs = batch_probs[0];
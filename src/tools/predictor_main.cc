@@ -20,7 +20,17 @@
 #include <deepx_core/tensor/data_type.h>
 #include <gflags/gflags.h>
 
+#include <algorithm>  // std::max
+#include <cstdint>
+#include <cstdio>  // std::remove
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/common/parallel_util.h"
+#include "src/common/random.h"
 #include "src/graph/client/graph_client.h"
+#include "src/io/file_chunk.h"
 #include "src/model/embed_instance_reader.h"
 #include "src/tools/graph/graph_flags.h"
 #include "src/tools/shard_func_name.h"
@@ -28,6 +38,10 @@
 
 // used in both `graph server` and `predict tasks`
 DEFINE_int32(thread_num, 1, "Number of threads.");
+DEFINE_int32(intra_op_thread_num, 1,
+             "Number of threads of one GNN op, 0 for number of cores divided "
+             "by thread_num.");
+DEFINE_int32(seed, 0, "Seed of samplers, 0 for seeds from the clock.");
 
 // predict
 DEFINE_bool(gnn_model, true, "true for GNN models, false for NonGNN models.");
@@ -39,22 +53,46 @@ DEFINE_string(in_model, "", "Input model dir.");
 DEFINE_int32(target_type, 2, "0 for loss, 1 for prob, 2 for emb.");
 DEFINE_int32(verbose, 1, "Verbose level: 0-10.");
 DEFINE_string(out_predict, "", "Output predict dir.");
+DEFINE_int32(out_format, 0,
+             "Output predict format, 0 for text, 1 for binary float32 "
+             "embeddings, 2 for binary float16 embeddings.");
+DEFINE_int32(range_size, 0,
+             "Size in KB of the line-aligned ranges local input files are "
+             "split into and predicted concurrently, 0 for auto, -1 for whole "
+             "files.");
+DEFINE_bool(out_stitch, true,
+            "Stitch the outputs of the ranges of a file in input order, or "
+            "write a part file per range.");
 
 namespace embedx {
 namespace {
 
 deepx_core::Shard FLAGS_shard;
 
+// ranges per thread of auto range size, so that threads finish together
+constexpr uint64_t RANGES_PER_THREAD = 4;
+constexpr uint64_t MIN_RANGE_SIZE = 64 << 10;
+
 /************************************************************************/
 /* Predictor */
 /************************************************************************/
 class Predictor : public deepx_core::DataType {
  protected:
+  // a range of the 'part'-th of 'part_num' ranges of the file
+  struct Range {
+    FileChunk chunk;
+    int file_id;
+    int part;
+  };
+
   std::unique_ptr<GraphClient> graph_client_;
   deepx_core::Graph graph_;
 
   std::vector<std::string> files_;
-  std::vector<std::string> remaining_files_;
+  std::vector<int> part_nums_;
+  std::vector<Range> ranges_;
+  size_t next_range_ = 0;
+  std::vector<int> remaining_parts_;
   std::mutex file_mutex_;
 
   std::vector<std::unique_ptr<TrainerContext>> contexts_tls_;
@@ -64,9 +102,13 @@ class Predictor : public deepx_core::DataType {
   virtual bool Init();
   virtual void Predict();
   virtual void PredictEntry(int thread_id);
-  virtual void PredictFile(int thread_id, const std::string& in_file,
-                           const std::string& out_file);
+  virtual void PredictRange(int thread_id, const Range& range);
   bool InitTrainerContext(TrainerContext* context) const;
+
+ private:
+  bool InitRanges();
+  std::string GetOutputFile(int file_id, int part) const;
+  void StitchFile(int file_id) const;
 };
 
 bool Predictor::Init() {
@@ -80,7 +122,11 @@ bool Predictor::Init() {
     if (!FLAGS_neighbor_feature.empty()) {
       graph_config.set_neighbor_feature(FLAGS_neighbor_feature);
     }
+    if (!FLAGS_edge_feature.empty()) {
+      graph_config.set_edge_feature(FLAGS_edge_feature);
+    }
     graph_config.set_negative_sampler_type(FLAGS_negative_sampler_type);
+    graph_config.set_negative_sampler_power(FLAGS_negative_sampler_power);
     graph_config.set_neighbor_sampler_type(FLAGS_neighbor_sampler_type);
     graph_config.set_thread_num(FLAGS_thread_num);
 
@@ -93,7 +139,8 @@ bool Predictor::Init() {
   DXCHECK(deepx_core::LoadGraph(FLAGS_in_model, &graph_));
 
   DXCHECK(deepx_core::AutoFileSystem::ListRecursive(FLAGS_in, true, &files_));
-  FLAGS_thread_num = std::min(FLAGS_thread_num, (int)files_.size());
+  DXCHECK(InitRanges());
+  FLAGS_thread_num = std::min(FLAGS_thread_num, (int)ranges_.size());
 
   if (!deepx_core::AutoFileSystem::Exists(FLAGS_out_predict)) {
     DXCHECK(deepx_core::AutoFileSystem::MakeDir(FLAGS_out_predict));
@@ -101,9 +148,50 @@ bool Predictor::Init() {
   return true;
 }
 
+bool Predictor::InitRanges() {
+  uint64_t range_size = 0;
+  if (FLAGS_range_size > 0) {
+    range_size = (uint64_t)FLAGS_range_size << 10;
+  } else if (FLAGS_range_size == 0 && FLAGS_thread_num > 1) {
+    uint64_t total_size = 0;
+    for (const std::string& file : files_) {
+      uint64_t size;
+      if (GetSplittableSize(file, &size)) {
+        total_size += size;
+      }
+    }
+    uint64_t range_num = (uint64_t)FLAGS_thread_num * RANGES_PER_THREAD;
+    range_size =
+        std::max((total_size + range_num - 1) / range_num, MIN_RANGE_SIZE);
+  }
+
+  std::vector<FileChunk> chunks;
+  for (int i = 0; i < (int)files_.size(); ++i) {
+    chunks.clear();
+    (void)SplitFile(files_[i], range_size, &chunks);
+    for (int j = 0; j < (int)chunks.size(); ++j) {
+      ranges_.emplace_back(Range{chunks[j], i, j});
+    }
+    part_nums_.emplace_back((int)chunks.size());
+  }
+  DXINFO("Got %zu files and %zu ranges.", files_.size(), ranges_.size());
+  return !ranges_.empty();
+}
+
+std::string Predictor::GetOutputFile(int file_id, int part) const {
+  std::string out_file =
+      deepx_core::GetOutputPredictFile(FLAGS_out_predict, files_[file_id]);
+  if (part_nums_[file_id] == 1) {
+    return out_file;
+  }
+  char suffix[32];
+  std::snprintf(suffix, sizeof(suffix), ".part-%05d", part);
+  return out_file + suffix;
+}
+
 void Predictor::Predict() {
-  DXCHECK(remaining_files_.empty());
-  remaining_files_ = files_;
+  next_range_ = 0;
+  remaining_parts_ = part_nums_;
   std::vector<std::thread> threads;
   for (int j = 0; j < FLAGS_thread_num; ++j) {
     threads.emplace_back(&Predictor::PredictEntry, this, j);
@@ -115,33 +203,62 @@ void Predictor::Predict() {
 
 void Predictor::PredictEntry(int thread_id) {
   for (;;) {
-    size_t file_size = 0;
-    std::string file;
+    size_t range_id = 0;
+    const Range* range = nullptr;
     {
       std::lock_guard<std::mutex> guard(file_mutex_);
-      if (!remaining_files_.empty()) {
-        file_size = remaining_files_.size();
-        file = remaining_files_.back();
-        remaining_files_.pop_back();
+      if (next_range_ < ranges_.size()) {
+        range_id = next_range_++;
+        range = &ranges_[range_id];
       }
     }
 
-    if (file.empty()) {
+    if (range == nullptr) {
       DXINFO("[%d] [%3.1f%%] Predicting completed. ", thread_id, 100.0);
       break;
     }
 
-    DXINFO("[%d] [%3.1f%%] Predicting %s...", thread_id,
-           (100.0 - 100.0 * file_size / files_.size()), file.c_str());
-    PredictFile(thread_id, file,
-                deepx_core::GetOutputPredictFile(FLAGS_out_predict, file));
+    DXINFO("[%d] [%3.1f%%] Predicting %s part %d/%d...", thread_id,
+           100.0 * range_id / ranges_.size(), range->chunk.file.c_str(),
+           range->part + 1, part_nums_[range->file_id]);
+    // Ranges go to threads in the order they finish, samplers of a range
+    // draw from a stream of its own whichever thread predicts it.
+    SeedThreadLocalRandom(range_id);
+    PredictRange(thread_id, *range);
+
+    bool last_part;
+    {
+      std::lock_guard<std::mutex> guard(file_mutex_);
+      last_part = --remaining_parts_[range->file_id] == 0;
+    }
+    if (last_part && FLAGS_out_stitch && part_nums_[range->file_id] > 1) {
+      StitchFile(range->file_id);
+    }
   }
 }
 
-void Predictor::PredictFile(int thread_id, const std::string& in_file,
-                            const std::string& out_file) {
+void Predictor::PredictRange(int thread_id, const Range& range) {
   TrainerContext* context = contexts_tls_[thread_id].get();
-  context->PredictFile(thread_id, in_file, out_file);
+  // stitched parts but the first one have no file header
+  bool header = !FLAGS_out_stitch || range.part == 0;
+  context->PredictChunk(thread_id, range.chunk, FileChunkExtender(),
+                        GetOutputFile(range.file_id, range.part), header);
+}
+
+void Predictor::StitchFile(int file_id) const {
+  std::vector<std::string> part_files;
+  for (int i = 0; i < part_nums_[file_id]; ++i) {
+    part_files.emplace_back(GetOutputFile(file_id, i));
+  }
+  std::string out_file =
+      deepx_core::GetOutputPredictFile(FLAGS_out_predict, files_[file_id]);
+  DXCHECK(ConcatFiles(part_files, out_file));
+  for (const std::string& part_file : part_files) {
+    if (std::remove(part_file.c_str()) != 0) {
+      DXERROR("Failed to remove file: %s.", part_file.c_str());
+    }
+  }
+  DXINFO("Stitched %zu parts to %s.", part_files.size(), out_file.c_str());
 }
 
 bool Predictor::InitTrainerContext(TrainerContext* context) const {
@@ -167,6 +284,7 @@ bool Predictor::InitTrainerContext(TrainerContext* context) const {
   context->set_verbose(FLAGS_verbose);
   context->set_target_name(target_name);
   context->set_target_type(FLAGS_target_type);
+  context->set_out_format(FLAGS_out_format);
   context->set_instance_reader_creator(instance_reader_creator);
   return true;
 }
@@ -269,9 +387,8 @@ void CheckGNNFlags() {
 
   deepx_core::CanonicalizePath(&FLAGS_node_graph);
   DXCHECK(!FLAGS_node_graph.empty());
-  DXCHECK(FLAGS_negative_sampler_type == 0 ||
-          FLAGS_negative_sampler_type == 1 ||
-          FLAGS_negative_sampler_type == 2 || FLAGS_negative_sampler_type == 3);
+  DXCHECK(FLAGS_negative_sampler_type >= 0 && FLAGS_negative_sampler_type <= 4);
+  DXCHECK(FLAGS_negative_sampler_power > 0);
   DXCHECK(FLAGS_neighbor_sampler_type == 0 ||
           FLAGS_neighbor_sampler_type == 1 ||
           FLAGS_neighbor_sampler_type == 2 || FLAGS_neighbor_sampler_type == 3);
@@ -296,6 +413,13 @@ void CheckFlags() {
   }
 
   DXCHECK(FLAGS_thread_num > 0);
+  DXCHECK(FLAGS_intra_op_thread_num >= 0);
+  if (FLAGS_intra_op_thread_num == 0) {
+    FLAGS_intra_op_thread_num =
+        std::max((int)std::thread::hardware_concurrency() / FLAGS_thread_num,
+                 1);
+  }
+  DXCHECK(FLAGS_range_size >= -1);
   DXCHECK(!FLAGS_instance_reader.empty());
   DXCHECK(FLAGS_batch > 0);
 
@@ -306,6 +430,11 @@ void CheckFlags() {
   DXCHECK(!deepx_core::IsStdinStdoutPath(FLAGS_in_model));
 
   DXCHECK(FLAGS_verbose >= 0);
+  // binary files only hold embeddings
+  DXCHECK(FLAGS_out_format == 0 || FLAGS_out_format == 1 ||
+          FLAGS_out_format == 2);
+  DXCHECK(FLAGS_out_format == 0 || FLAGS_target_type == 2 ||
+          FLAGS_target_type == 3);
 
   DXCHECK(LoadShard(FLAGS_in_model, &FLAGS_shard));
   if (FLAGS_shard.shard_mode() == 1 &&
@@ -324,6 +453,8 @@ int main(int argc, char** argv) {
   google::ParseCommandLineFlags(&argc, &argv, true);
 
   CheckFlags();
+  SetIntraOpThreadNum(FLAGS_intra_op_thread_num);
+  SetRandomSeed(FLAGS_seed);
 
   std::unique_ptr<Predictor> predictor;
   if (FLAGS_shard.shard_mode() == 0) {
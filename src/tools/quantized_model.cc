@@ -0,0 +1,271 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/tools/quantized_model.h"
+
+#include <deepx_core/common/stream.h>
+#include <deepx_core/dx_log.h>
+#include <deepx_core/tensor/csr_matrix.h>
+
+#include <algorithm>  // std::max, std::sort
+#include <cinttypes>  // PRIu64
+#include <cmath>      // std::isfinite
+#include <type_traits>
+#include <utility>  // std::move
+
+namespace embedx {
+namespace {
+
+static_assert(std::is_same<deepx_core::DataType::float_t, float>::value,
+              "float_t must be float.");
+
+bool IsFinite(int n, const float* x) noexcept {
+  for (int i = 0; i < n; ++i) {
+    if (!std::isfinite(x[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool IsQuantizedModelFile(const std::string& file) {
+  deepx_core::AutoInputFileStream is;
+  if (!is.Open(file)) {
+    return false;
+  }
+
+  uint32_t magic = 0;
+  return is.Read(&magic, sizeof(magic)) == sizeof(magic) &&
+         magic == QUANTIZED_MODEL_MAGIC;
+}
+
+bool QuantizedModel::Init(const deepx_core::TensorMap& param) {
+  srms_.clear();
+  denses_.clear();
+  tsrs_.clear();
+
+  // sorted for the same files of the same params
+  std::vector<std::string> names;
+  for (const auto& entry : param) {
+    names.emplace_back(entry.first);
+  }
+  std::sort(names.begin(), names.end());
+
+  for (const auto& name : names) {
+    const auto& any = param.at(name);
+    if (any.is<srm_t>()) {
+      const auto& W = any.unsafe_to_ref<srm_t>();
+      vec_int_t ids;
+      ids.reserve(W.size());
+      for (const auto& entry : W) {
+        ids.emplace_back(entry.first);
+      }
+      std::sort(ids.begin(), ids.end());
+
+      srms_.emplace_back(name, QuantizedRows());
+      QuantizedRows& rows = srms_.back().second;
+      rows.Init(W.col());
+      rows.Reserve(ids.size(), true);
+      for (auto id : ids) {
+        const float_t* row = W.get_row_no_init(id);
+        if (!IsFinite(W.col(), row)) {
+          DXERROR("Row: %" PRIu64 " of param: %s is not finite.", id,
+                  name.c_str());
+          return false;
+        }
+        rows.AddRow(id, row);
+      }
+    } else if (any.is<tsr_t>()) {
+      const auto& W = any.unsafe_to_ref<tsr_t>();
+      if (!IsFinite(W.total_dim(), W.data())) {
+        DXERROR("Param: %s is not finite.", name.c_str());
+        return false;
+      }
+
+      int col = W.rank() >= 2 ? W.dim(W.rank() - 1) : 0;
+      if (col == 0) {
+        tsrs_.emplace_back(name, W);
+        continue;
+      }
+
+      DenseParam dense;
+      dense.name = name;
+      dense.shape = W.shape();
+      int row_num = W.total_dim() / col;
+      dense.rows.Init(col);
+      dense.rows.Reserve(row_num, false);
+      for (int i = 0; i < row_num; ++i) {
+        dense.rows.AddRow(W.data() + (size_t)i * col);
+      }
+      denses_.emplace_back(std::move(dense));
+    } else {
+      DXERROR("Param: %s is neither srm nor tsr.", name.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool QuantizedModel::Save(const std::string& file) const {
+  deepx_core::AutoOutputFileStream os;
+  if (!os.Open(file)) {
+    DXERROR("Failed to open: %s.", file.c_str());
+    return false;
+  }
+
+  os << QUANTIZED_MODEL_MAGIC << QUANTIZED_MODEL_VERSION;
+  os << (int)srms_.size();
+  for (const auto& entry : srms_) {
+    os << entry.first << entry.second;
+  }
+  os << (int)denses_.size();
+  for (const auto& dense : denses_) {
+    os << dense.name << dense.shape << dense.rows;
+  }
+  os << (int)tsrs_.size();
+  for (const auto& entry : tsrs_) {
+    os << entry.first << entry.second;
+  }
+
+  if (!os) {
+    DXERROR("Failed to write: %s.", file.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool QuantizedModel::Load(const std::string& file) {
+  deepx_core::AutoInputFileStream is;
+  if (!is.Open(file)) {
+    DXERROR("Failed to open: %s.", file.c_str());
+    return false;
+  }
+
+  uint32_t magic = 0, version = 0;
+  is >> magic >> version;
+  if (!is || magic != QUANTIZED_MODEL_MAGIC ||
+      version != QUANTIZED_MODEL_VERSION) {
+    DXERROR("Not a quantized model file or unsupported version: %s.",
+            file.c_str());
+    return false;
+  }
+
+  int size = 0;
+  is >> size;
+  srms_.resize((size_t)std::max(size, 0));
+  for (auto& entry : srms_) {
+    is >> entry.first >> entry.second;
+    if (!is || !entry.second.valid()) {
+      DXERROR("Invalid embedding table: %s of: %s.", entry.first.c_str(),
+              file.c_str());
+      return false;
+    }
+  }
+
+  is >> size;
+  denses_.resize((size_t)std::max(size, 0));
+  for (auto& dense : denses_) {
+    is >> dense.name >> dense.shape >> dense.rows;
+    size_t total_dim = dense.rows.size() * dense.rows.col();
+    if (!is || !dense.rows.valid() ||
+        total_dim != (size_t)dense.shape.total_dim()) {
+      DXERROR("Invalid weight: %s of: %s.", dense.name.c_str(), file.c_str());
+      return false;
+    }
+  }
+
+  is >> size;
+  tsrs_.resize((size_t)std::max(size, 0));
+  for (auto& entry : tsrs_) {
+    is >> entry.first >> entry.second;
+  }
+
+  if (!is) {
+    DXERROR("Failed to read: %s.", file.c_str());
+    return false;
+  }
+  return true;
+}
+
+size_t QuantizedModel::srm_memory_bytes() const noexcept {
+  size_t bytes = 0;
+  for (const auto& entry : srms_) {
+    bytes += entry.second.memory_bytes();
+  }
+  return bytes;
+}
+
+void QuantizedModel::InitParam(deepx_core::TensorMap* param) const {
+  for (const auto& dense : denses_) {
+    auto& W = param->insert<tsr_t>(dense.name);
+    W.resize(dense.shape);
+    for (size_t i = 0; i < dense.rows.size(); ++i) {
+      dense.rows.GetRow(i, W.data() + i * dense.rows.col());
+    }
+  }
+  for (const auto& entry : tsrs_) {
+    param->insert<tsr_t>(entry.first) = entry.second;
+  }
+  for (const auto& entry : srms_) {
+    param->insert<srm_t>(entry.first).set_col(entry.second.col());
+  }
+}
+
+void QuantizedModel::InitBatchParam(
+    deepx_core::TensorMap* param, deepx_core::TensorMap* batch_param) const {
+  for (auto& entry : *param) {
+    if (entry.second.is<tsr_t>()) {
+      auto& W = entry.second.unsafe_to_ref<tsr_t>();
+      batch_param->insert<tsr_t>(entry.first).view(W.shape(), W.data());
+    }
+  }
+  for (const auto& entry : srms_) {
+    batch_param->insert<srm_t>(entry.first).set_col(entry.second.col());
+  }
+}
+
+void QuantizedModel::LookupRows(const deepx_core::TensorMap& inst,
+                                deepx_core::TensorMap* batch_param) const {
+  std::vector<float_t> row;
+  for (const auto& entry : srms_) {
+    const QuantizedRows& rows = entry.second;
+    auto& W = batch_param->get<srm_t>(entry.first);
+    W.clear();
+    row.resize(rows.col());
+
+    // Which table a feature goes to is up to the graph, a table gets the
+    // features of all the inputs.
+    for (const auto& input : inst) {
+      if (!input.second.is<csr_t>()) {
+        continue;
+      }
+
+      const auto& X = input.second.unsafe_to_ref<csr_t>();
+      CSR_FOR_EACH_ROW(X, i) {
+        CSR_FOR_EACH_COL(X, i) {
+          int_t id = CSR_COL(X);
+          if (W.get_row_no_init(id) != nullptr) {
+            continue;
+          }
+          size_t pos = rows.Find(id);
+          if (pos != QuantizedRows::NPOS) {
+            rows.GetRow(pos, row.data());
+            W.assign(id, row.data());
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace embedx
@@ -0,0 +1,73 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#pragma once
+#include <deepx_core/graph/tensor_map.h>
+#include <deepx_core/tensor/data_type.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>  // std::pair
+#include <vector>
+
+#include "src/common/quantized_rows.h"
+
+namespace embedx {
+
+constexpr uint32_t QUANTIZED_MODEL_MAGIC = 0x4d515845;  // "EXQM"
+constexpr uint32_t QUANTIZED_MODEL_VERSION = 1;
+
+// Returns true if 'file' starts with the magic of quantized model files.
+bool IsQuantizedModelFile(const std::string& file);
+
+// QuantizedModel keeps the params of a model in int8 for serving, see
+// QuantizedRows.
+//
+// Embedding tables (srm) stay quantized in memory, the rows looked up by a
+// batch are dequantized into the srm params of its op context right before
+// the forward pass. Weight matrices (tsr of rank >= 2) are quantized per row
+// in files and dequantized once when loaded, the ops of deepx_core only run
+// on float tensors, so they save file size but no memory. Other tsr are kept
+// as they are.
+class QuantizedModel : public deepx_core::DataType {
+ private:
+  struct DenseParam {
+    std::string name;
+    deepx_core::Shape shape;
+    QuantizedRows rows;
+  };
+
+  std::vector<std::pair<std::string, QuantizedRows>> srms_;
+  std::vector<DenseParam> denses_;
+  std::vector<std::pair<std::string, tsr_t>> tsrs_;
+
+ public:
+  // Quantizes 'param' of a trained model.
+  bool Init(const deepx_core::TensorMap& param);
+  bool Save(const std::string& file) const;
+  bool Load(const std::string& file);
+
+  // bytes of the quantized embedding tables
+  size_t srm_memory_bytes() const noexcept;
+
+  // Sets the dequantized weights and empty embedding tables to 'param'.
+  void InitParam(deepx_core::TensorMap* param) const;
+  // Sets 'batch_param' of an op context to views of the weights of 'param'
+  // and embedding tables of its own.
+  void InitBatchParam(deepx_core::TensorMap* param,
+                      deepx_core::TensorMap* batch_param) const;
+  // Dequantizes the rows of the features of 'inst' into the embedding tables
+  // of 'batch_param', see InitBatchParam.
+  void LookupRows(const deepx_core::TensorMap& inst,
+                  deepx_core::TensorMap* batch_param) const;
+};
+
+}  // namespace embedx
@@ -20,6 +20,9 @@
 #include <cstdlib>
 #include <sstream>
 
+#include "src/io/async_writer.h"
+#include "src/io/embedding_file.h"
+#include "src/io/text_buffer.h"
 #include "src/model/instance_node_name.h"
 
 namespace embedx {
@@ -44,13 +47,20 @@ void TrainerContext::DoInit(deepx_core::ModelShard* local_model_shard) {
 }
 
 void TrainerContext::TrainFile(int thread_id, const std::string& file) {
+  FileChunk chunk;
+  chunk.file = file;
+  TrainChunk(thread_id, chunk, FileChunkExtender());
+}
+
+void TrainerContext::TrainChunk(int thread_id, const FileChunk& chunk,
+                                const FileChunkExtender& extender) {
   DXCHECK_THROW(op_context_->InitOp({target_name_}, 0));
   op_context_->mutable_inst()->clear();
   op_context_batch_ = -1;
   file_loss_ = 0;
   file_loss_weight_ = 0;
 
-  DXCHECK_THROW(instance_reader_->Open(file));
+  DXCHECK_THROW(instance_reader_->OpenChunk(chunk, extender));
 
   size_t processed_batch = 0;
   size_t processed_inst = 0;
@@ -104,13 +114,14 @@ void TrainerContext::TrainFile(int thread_id, const std::string& file) {
   }
 }
 
-void TrainerContext::DumpBatch(deepx_core::OutputStream& os) const {
+void TrainerContext::DumpBatch(bool header, std::string* buf) const {
   // output format
   // FLAGS_target_type=1
   //     ctr: label prob
   //     classification: node prob0 prob1
   // FLAGS_target_type=2 or FLAGS_target_type=3
   //     embedding: node val0 val1 val2 val3
+  //     or blocks of binary embedding files if FLAGS_out_format is 1 or 2
 
   const vec_int_t* nodes = nullptr;
   const tsr_t* Y = nullptr;
@@ -141,39 +152,61 @@ void TrainerContext::DumpBatch(deepx_core::OutputStream& os) const {
     DXCHECK_THROW((int)nodes->size() == inst_batch);
   }
 
-  std::ostringstream oss;
+  if (out_format_ != 0) {
+    DXCHECK_THROW(nodes);
+    auto dtype = out_format_ == 1 ? EmbeddingDtypeEnum::FLOAT32
+                                  : EmbeddingDtypeEnum::FLOAT16;
+    if (header) {
+      AppendEmbeddingHeader(dtype, Z->dim(1), buf);
+    }
+    AppendEmbeddingBlock(dtype, Z->dim(1), nodes->data(), Z->data(),
+                         inst_batch, buf);
+    return;
+  }
+
+  TextBuffer text;
+  text.Swap(buf);
   for (int i = 0; i < inst_batch; ++i) {
-    oss.clear();
-    oss.str("");
     if (nodes) {
-      oss << (*nodes)[i];
+      text.Append((uint64_t)(*nodes)[i]);
     }
     if (Y) {
       for (int j = 0; j < Y->dim(1); ++j) {
-        oss << ' ' << Y->data(i * Y->dim(1) + j);
+        text.Append(' ');
+        text.Append((float)Y->data(i * Y->dim(1) + j));
       }
     }
     for (int j = 0; j < Z->dim(1); ++j) {
-      oss << ' ' << Z->data(i * Z->dim(1) + j);
+      text.Append(' ');
+      text.Append((float)Z->data(i * Z->dim(1) + j));
     }
-    oss << "\n";
-    std::string s = oss.str();
-    os.Write(s.data(), s.size());
+    text.Append('\n');
   }
+  text.Swap(buf);
 }
 
 void TrainerContext::PredictFile(int thread_id, const std::string& in_file,
                                  const std::string& out_file) {
+  FileChunk chunk;
+  chunk.file = in_file;
+  PredictChunk(thread_id, chunk, FileChunkExtender(), out_file);
+}
+
+void TrainerContext::PredictChunk(int thread_id, const FileChunk& chunk,
+                                  const FileChunkExtender& extender,
+                                  const std::string& out_file, bool header) {
   DXINFO("target_name: %s", target_name_.c_str());
   DXCHECK_THROW(op_context_->InitOp({target_name_}, -1));
   op_context_->mutable_inst()->clear();
   op_context_batch_ = -1;
 
-  DXCHECK_THROW(instance_reader_->Open(in_file));
+  DXCHECK_THROW(instance_reader_->OpenChunk(chunk, extender));
 
-  deepx_core::AutoOutputFileStream os;
+  // formatting the next batch overlaps writing this one
+  AsyncWriter writer;
+  std::string buf;
   DXINFO("out file: %s", out_file.c_str());
-  DXCHECK_THROW(os.Open(out_file));
+  DXCHECK_THROW(writer.Open(out_file));
 
   size_t processed_batch = 0;
   size_t processed_inst = 0;
@@ -191,7 +224,8 @@ void TrainerContext::PredictFile(int thread_id, const std::string& in_file,
   Instance* inst = op_context_->mutable_inst();
   while (instance_reader_->GetBatch(inst)) {
     PredictBatch();
-    DumpBatch(os);
+    DumpBatch(header && processed_batch == 0, &buf);
+    DXCHECK_THROW(writer.Write(&buf));
     processed_batch += 1;
     processed_inst += inst->batch();
     if (verbose_ && processed_batch % verbose_batch == 0) {
@@ -201,9 +235,11 @@ void TrainerContext::PredictFile(int thread_id, const std::string& in_file,
 
   if (inst->batch() > 0) {
     PredictBatch();
-    DumpBatch(os);
+    DumpBatch(header && processed_batch == 0, &buf);
+    DXCHECK_THROW(writer.Write(&buf));
     processed_inst += inst->batch();
   }
+  DXCHECK_THROW(writer.Close());
 
   if (verbose_) {
     dump_speed();
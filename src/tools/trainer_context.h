@@ -20,7 +20,9 @@
 
 #include <atomic>
 #include <memory>  // std::unique_ptr
+#include <string>
 
+#include "src/io/file_chunk.h"
 #include "src/model/embed_instance_reader.h"
 
 namespace embedx {
@@ -34,6 +36,8 @@ class TrainerContext : public deepx_core::DataType {
   int verbose_ = 0;
   std::string target_name_;
   int target_type_ = 0;
+  // 0 for text, 1 for binary float32, 2 for binary float16
+  int out_format_ = 0;
   std::function<std::unique_ptr<EmbedInstanceReader>()>
       instance_reader_creator_;
 
@@ -55,6 +59,7 @@ class TrainerContext : public deepx_core::DataType {
     target_name_ = target_name;
   }
   void set_target_type(int target_type) noexcept { target_type_ = target_type; }
+  void set_out_format(int out_format) noexcept { out_format_ = out_format; }
 
   void set_instance_reader_creator(
       const std::function<std::unique_ptr<EmbedInstanceReader>()>&
@@ -72,10 +77,20 @@ class TrainerContext : public deepx_core::DataType {
   virtual ~TrainerContext() = default;
   virtual void TrainBatch() = 0;
   virtual void TrainFile(int thread_id, const std::string& file);
+  // Trains the lines of 'chunk', see LineParser::Open.
+  void TrainChunk(int thread_id, const FileChunk& chunk,
+                  const FileChunkExtender& extender);
   virtual void PredictBatch() = 0;
-  virtual void DumpBatch(deepx_core::OutputStream& os) const;  // NOLINT
+  // Appends the outputs of the batch to 'buf', after the file header if
+  // 'header' is true.
+  virtual void DumpBatch(bool header, std::string* buf) const;
   virtual void PredictFile(int thread_id, const std::string& in_file,
                            const std::string& out_file);
+  // Predicts the lines of 'chunk' to 'out_file', without the file header if
+  // 'header' is false, e.g. 'out_file' will be appended to another one.
+  void PredictChunk(int thread_id, const FileChunk& chunk,
+                    const FileChunkExtender& extender,
+                    const std::string& out_file, bool header = true);
 
  protected:
   int enable_profile_ = 0;
@@ -0,0 +1,202 @@
+// Tencent is pleased to support the open source community by making embedx
+// available.
+//
+// Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+//
+// Licensed under the BSD 3-Clause License and other third-party components,
+// please refer to LICENSE for details.
+//
+// Author: agent (agent@local)
+//
+
+#include "src/tools/trainer_context.h"
+
+#include <deepx_core/common/any_map.h>
+#include <deepx_core/common/stream.h>
+#include <deepx_core/graph/graph.h>
+#include <deepx_core/graph/model_shard.h>
+#include <deepx_core/graph/shard.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <memory>  // std::unique_ptr
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "src/graph/client/graph_client.h"
+#include "src/graph/graph_config.h"
+#include "src/io/embedding_file.h"
+#include "src/io/file_chunk.h"
+#include "src/model/embed_instance_reader.h"
+#include "src/model/model_zoo.h"
+
+namespace embedx {
+
+// Predicts the ranges of a file like predictor_main and stitches them.
+//
+// The model is deepwalk, whose embeddings don't depend on sampling. Models
+// sampling neighbors or negatives seed the random engine of a thread by its
+// id, so a range draws differently from the whole file, and only
+// deterministic models stitch to the same bytes.
+class TrainerContextTest : public ::testing::Test {
+ protected:
+  const std::string WORK_DIR = "trainer_context_test";
+  const int BATCH = 3;
+
+  std::unique_ptr<GraphClient> graph_client_;
+  deepx_core::Graph graph_;
+  deepx_core::Shard shard_;
+  deepx_core::ModelShard model_shard_;
+
+ protected:
+  void SetUp() override {
+    (void)deepx_core::AutoFileSystem::MakeDir(WORK_DIR);
+
+    GraphConfig graph_config;
+    graph_config.set_node_graph("testdata/context");
+    graph_config.set_thread_num(1);
+    graph_client_ = NewGraphClient(graph_config, GraphClientEnum::LOCAL);
+    ASSERT_TRUE(graph_client_);
+
+    auto model_zoo = NewModelZoo("deepwalk");
+    ASSERT_TRUE(model_zoo);
+    deepx_core::StringMap config;
+    ASSERT_TRUE(deepx_core::ParseConfig("config=0:1000:8", &config));
+    ASSERT_TRUE(model_zoo->InitConfig(config));
+    ASSERT_TRUE(model_zoo->InitGraph(&graph_));
+
+    shard_.InitNonShard();
+    model_shard_.seed(0);
+    model_shard_.InitShard(&shard_, 0);
+    model_shard_.InitGraph(&graph_);
+    ASSERT_TRUE(model_shard_.InitModel());
+  }
+
+  std::unique_ptr<TrainerContextNonShard> NewContext(int out_format) {
+    const GraphClient* graph_client = graph_client_.get();
+    int batch = BATCH;
+    auto instance_reader_creator = [graph_client, batch]() {
+      std::unique_ptr<EmbedInstanceReader> instance_reader(
+          NewEmbedInstanceReader("deepwalk"));
+      DXCHECK(instance_reader);
+      deepx_core::StringMap config;
+      config["is_train"] = "0";
+      config["batch"] = std::to_string(batch);
+      DXCHECK(instance_reader->InitConfig(config));
+      DXCHECK(instance_reader->InitGraphClient(graph_client));
+      return instance_reader;
+    };
+
+    // 2: embeddings
+    std::unique_ptr<TrainerContextNonShard> context(new TrainerContextNonShard);
+    context->set_verbose(0);
+    context->set_target_name(graph_.target(2).name());
+    context->set_target_type(2);
+    context->set_out_format(out_format);
+    context->set_instance_reader_creator(instance_reader_creator);
+    DXCHECK(context->Init(&model_shard_));
+    return context;
+  }
+
+  std::string WriteFile(const std::string& name,
+                        const std::string& content) const {
+    std::string file = WORK_DIR + "/" + name;
+    std::ofstream os(file, std::ios::binary);
+    os << content;
+    return file;
+  }
+
+  static std::string ReadFile(const std::string& file) {
+    std::ifstream is(file, std::ios::binary);
+    std::ostringstream os;
+    os << is.rdbuf();
+    return os.str();
+  }
+
+  // Predicts the ranges of 'file' split by 'chunk_size' as the threads of
+  // predictor_main do, the first range with the file header, and stitches
+  // them. The output must be the same as that of the whole file.
+  void CheckStitch(const std::string& file, uint64_t chunk_size) {
+    auto context = NewContext(0);
+    FileChunk whole;
+    whole.file = file;
+    std::string whole_out = file + ".out";
+    context->PredictChunk(0, whole, FileChunkExtender(), whole_out);
+
+    std::vector<FileChunk> chunks;
+    EXPECT_TRUE(SplitFile(file, chunk_size, &chunks));
+    std::vector<std::string> part_files;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      part_files.emplace_back(file + ".part-" + std::to_string(i));
+      context->PredictChunk((int)i, chunks[i], FileChunkExtender(),
+                            part_files.back(), i == 0);
+    }
+    std::string stitched_out = file + ".stitched";
+    ASSERT_TRUE(ConcatFiles(part_files, stitched_out));
+    EXPECT_EQ(ReadFile(stitched_out), ReadFile(whole_out))
+        << "chunk_size: " << chunk_size;
+  }
+};
+
+// Ranges start in the middle of lines at every size.
+TEST_F(TrainerContextTest, PredictChunk_Stitch) {
+  std::string content;
+  for (int i = 0; i < 20; ++i) {
+    content += std::to_string(i % 13) + "\n";
+  }
+  std::string file = WriteFile("stitch", content);
+  for (uint64_t chunk_size = 1; chunk_size <= content.size() + 1;
+       ++chunk_size) {
+    CheckStitch(file, chunk_size);
+  }
+}
+
+TEST_F(TrainerContextTest, PredictChunk_StitchCRLF) {
+  std::string file = WriteFile("crlf", "1\r\n3\r\n5\r\n7");
+  for (uint64_t chunk_size = 1; chunk_size <= 10; ++chunk_size) {
+    CheckStitch(file, chunk_size);
+  }
+}
+
+// The stitched binary file has one header and its blocks split at the ranges,
+// so the rows are compared.
+TEST_F(TrainerContextTest, PredictChunk_StitchBinary) {
+  std::string file = WriteFile("binary", "0\n1\n2\n3\n4\n5\n6\n");
+  auto context = NewContext(1);
+  FileChunk whole;
+  whole.file = file;
+  context->PredictChunk(0, whole, FileChunkExtender(), file + ".out");
+
+  std::vector<FileChunk> chunks;
+  EXPECT_TRUE(SplitFile(file, 4, &chunks));
+  ASSERT_GT(chunks.size(), 1u);
+  std::vector<std::string> part_files;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    part_files.emplace_back(file + ".part-" + std::to_string(i));
+    context->PredictChunk((int)i, chunks[i], FileChunkExtender(),
+                          part_files.back(), i == 0);
+  }
+  ASSERT_TRUE(ConcatFiles(part_files, file + ".stitched"));
+
+  auto read_rows = [](const std::string& file, vec_int_t* ids,
+                      std::vector<float>* values) {
+    return ReadEmbeddingFile(
+        file, [ids, values](const vec_int_t& block_ids,
+                            const std::vector<float>& block_values, int) {
+          ids->insert(ids->end(), block_ids.begin(), block_ids.end());
+          values->insert(values->end(), block_values.begin(),
+                         block_values.end());
+          return true;
+        });
+  };
+  vec_int_t whole_ids, stitched_ids;
+  std::vector<float> whole_values, stitched_values;
+  ASSERT_TRUE(read_rows(file + ".out", &whole_ids, &whole_values));
+  ASSERT_TRUE(read_rows(file + ".stitched", &stitched_ids, &stitched_values));
+  EXPECT_EQ(whole_ids.size(), 7u);
+  EXPECT_EQ(stitched_ids, whole_ids);
+  EXPECT_EQ(stitched_values, whole_values);
+}
+
+}  // namespace embedx
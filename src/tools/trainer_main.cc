@@ -19,8 +19,12 @@
 #include <deepx_core/tensor/data_type.h>
 #include <gflags/gflags.h>
 
+#include <algorithm>  // std::max
 #include <cmath>
+#include <thread>
 
+#include "src/common/parallel_util.h"
+#include "src/common/random.h"
 #include "src/deep/client/deep_client.h"
 #include "src/deep/deep_config.h"
 #include "src/graph/client/graph_client.h"
@@ -34,6 +38,9 @@
 
 // used in both `graph server` and `training tasks`
 DEFINE_int32(thread_num, 1, "Number of threads.");
+DEFINE_int32(intra_op_thread_num, 1,
+             "Number of threads of one GNN op, 0 for number of cores divided "
+             "by thread_num.");
 
 // train
 DEFINE_bool(gnn_model, true, "true for GNN models, false for NonGNN models.");
@@ -51,7 +58,6 @@ DEFINE_string(in_model, "", "Input dir of model.");
 DEFINE_string(warmup_model, "", "Warmup dir of model.");
 DEFINE_string(in, "", "Input dir/file of training data.");
 DEFINE_string(pretrain_path, "", "Input dir/file of pretrain param.");
-DEFINE_string(item_feature, "", "Input dir/file of item feature.");
 DEFINE_string(inst_file, "", "Input dir/file of instance file.");
 DEFINE_string(freq_file, "", "Input dir/file of item frequency.");
 DEFINE_bool(shuffle, true, "Shuffle input files for each epoch.");
@@ -62,7 +68,8 @@ DEFINE_uint64(ts_now, 0, "Timestamp of now.");
 DEFINE_uint64(ts_expire_threshold, 0, "Timestamp expiration threshold.");
 DEFINE_uint64(freq_filter_threshold, 0, "Frequency filter threshold.");
 DEFINE_int32(verbose, 1, "Verbose level: 0-10.");
-DEFINE_int32(seed, 9527, "Seed of random engine.");
+DEFINE_int32(seed, 9527,
+             "Seed of random engines, 0 for seeds of samplers from the clock.");
 DEFINE_int32(target_type, 0, "0, for loss, 1 for prob, 2 for emb.");
 DEFINE_bool(out_model_remove_zeros, false, "Remove zeros from output model.");
 DEFINE_string(out_model, "", "Output dir of model (optional).");
@@ -122,7 +129,11 @@ bool Trainer::Init() {
     if (!FLAGS_neighbor_feature.empty()) {
       graph_config.set_neighbor_feature(FLAGS_neighbor_feature);
     }
+    if (!FLAGS_edge_feature.empty()) {
+      graph_config.set_edge_feature(FLAGS_edge_feature);
+    }
     graph_config.set_negative_sampler_type(FLAGS_negative_sampler_type);
+    graph_config.set_negative_sampler_power(FLAGS_negative_sampler_power);
     graph_config.set_neighbor_sampler_type(FLAGS_neighbor_sampler_type);
     graph_config.set_thread_num(FLAGS_thread_num);
     graph_client_ = NewGraphClient(graph_config, GraphClientEnum::LOCAL);
@@ -151,6 +162,7 @@ bool Trainer::Init() {
       }
 
       deep_config.set_negative_sampler_type(FLAGS_negative_sampler_type);
+      deep_config.set_negative_sampler_power(FLAGS_negative_sampler_power);
       deep_config.set_thread_num(FLAGS_thread_num);
 
       deep_client_ = NewDeepClient(deep_config, DeepClientEnum::LOCAL);
@@ -227,6 +239,8 @@ void Trainer::Train() {
 }
 
 void Trainer::TrainEntry(int thread_id) {
+  // samplers of the thread draw from a stream of its own in each epoch
+  SeedThreadLocalRandom((uint64_t)epoch_ * FLAGS_thread_num + thread_id);
   for (;;) {
     size_t file_size = 0;
     std::string file;
@@ -513,9 +527,8 @@ void CheckGNNFlags() {
       FLAGS_thread_num = 1;
     }
   }
-  DXCHECK(FLAGS_negative_sampler_type == 0 ||
-          FLAGS_negative_sampler_type == 1 ||
-          FLAGS_negative_sampler_type == 2 || FLAGS_negative_sampler_type == 3);
+  DXCHECK(FLAGS_negative_sampler_type >= 0 && FLAGS_negative_sampler_type <= 4);
+  DXCHECK(FLAGS_negative_sampler_power > 0);
   DXCHECK(FLAGS_neighbor_sampler_type == 0 ||
           FLAGS_neighbor_sampler_type == 1 ||
           FLAGS_neighbor_sampler_type == 2 || FLAGS_neighbor_sampler_type == 3);
@@ -529,6 +542,12 @@ void CheckFlags() {
   }
 
   DXCHECK(FLAGS_thread_num > 0);
+  DXCHECK(FLAGS_intra_op_thread_num >= 0);
+  if (FLAGS_intra_op_thread_num == 0) {
+    FLAGS_intra_op_thread_num =
+        std::max((int)std::thread::hardware_concurrency() / FLAGS_thread_num,
+                 1);
+  }
   DXCHECK(!FLAGS_instance_reader.empty());
   DXCHECK(FLAGS_epoch > 0);
   DXCHECK(FLAGS_batch > 0);
@@ -606,6 +625,8 @@ int main(int argc, char** argv) {
   google::ParseCommandLineFlags(&argc, &argv, true);
 
   CheckFlags();
+  SetIntraOpThreadNum(FLAGS_intra_op_thread_num);
+  SetRandomSeed(FLAGS_seed);
 
   std::unique_ptr<Trainer> trainer;
   if (FLAGS_shard.shard_mode() == 0) {